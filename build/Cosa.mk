@@ -37,3 +37,13 @@ BOARDS_TXT = $(COSA_DIR)/build/boards.txt
 MONITOR_CMD = $(COSA_DIR)/build/miniterm.py -q --lf
 
 include $(ARDMK_DIR)/Arduino.mk
+
+# Size report; sections and the largest symbols of the build.
+# Use SIZE_REPORT_MAX to set the number of symbols (default 30).
+SIZE_REPORT_MAX ?= 30
+
+size_report: $(TARGET_HEX)
+	$(call avr_size,$(TARGET_ELF),$(TARGET_HEX))
+	$(NM) --size-sort --reverse-sort --radix=d -C $(TARGET_ELF) | head -n $(SIZE_REPORT_MAX)
+
+.PHONY: size_report
@@ -0,0 +1,126 @@
+#!/usr/bin/env python
+#
+# @file benchmark.py
+# @version 1.0
+#
+# @section License
+# Copyright (C) 2015, Mikael Patel
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# @section Description
+# Build, upload and collect the results of a Cosa benchmark sketch
+# (Cosa/Benchmark.hh CSV output), and compare runs. The run command
+# builds and uploads the sketch with the cosa build script, reads the
+# results from the serial port and writes them with a board column
+# to the output file (or stdout). The Benchmark (cycles),
+# Benchmark::Throughput (io; KB/s and latency) and wireless link
+# (CosaWirelessBenchmark) formats are handled. The compare command
+# matches cases by board and name and reports the change of the mean
+# cycles (or median latency for io and wireless); the exit
+# status is non-zero if any case is slower than the threshold
+# (percent, default 5).
+#
+# Usage: benchmark.py run BOARD PORT [output.csv] [sketch-dir]
+#        benchmark.py compare baseline.csv result.csv [threshold]
+#
+# This file is part of the Arduino Che Cosa project.
+
+import csv, os, subprocess, sys
+
+BAUDRATE = 57600
+SKETCH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      '..', 'examples', 'Benchmarks', 'CosaBenchmarkSuite')
+
+def collect(port):
+    """read benchmark csv header and lines from serial port until end line"""
+    import serial
+    stream = serial.Serial(port, BAUDRATE, timeout=60)
+    header = None
+    rows = []
+    while True:
+        line = stream.readline()
+        if not line: raise IOError('timeout: %s' % port)
+        line = line.decode('latin-1').strip()
+        if line.split(',')[0] in ('benchmark', 'io', 'wireless'):
+            header = line.split(',')
+            rows = []
+        elif line == 'end' and header:
+            return header, rows
+        elif header and line:
+            rows.append(line.split(','))
+
+def run(argv):
+    if len(argv) < 2:
+        return usage()
+    board, port = argv[0], argv[1]
+    output = argv[2] if len(argv) > 2 else None
+    sketch = argv[3] if len(argv) > 3 else SKETCH
+    subprocess.check_call(['cosa', board, 'upload'], cwd=sketch)
+    header, rows = collect(port)
+    out = open(output, 'w') if output else sys.stdout
+    writer = csv.writer(out, lineterminator='\n')
+    writer.writerow(['board'] + header)
+    for row in rows:
+        writer.writerow([board] + row)
+    if output: out.close()
+    return 0
+
+def load(path):
+    """read result file; return dict (board, benchmark) -> row"""
+    res = {}
+    for row in csv.DictReader(open(path)):
+        if 'benchmark' in row: name = row['benchmark']
+        elif 'io' in row: name = row['io']
+        else: name = '%s(%s,%s)' % (row['wireless'], row['bytes'], row['dBm'])
+        res[(row['board'], name)] = row
+    return res
+
+def metric(row):
+    """return compare value of row; mean cycles or median latency"""
+    return int(row['mean'] if 'mean' in row else row['p50'])
+
+def compare(argv):
+    if len(argv) < 2:
+        return usage()
+    baseline, result = load(argv[0]), load(argv[1])
+    threshold = float(argv[2]) if len(argv) > 2 else 5.0
+    regressions = 0
+    for key in sorted(result):
+        new = metric(result[key])
+        if key not in baseline:
+            print('%-10s %-32s %8d (new)' % (key[0], key[1], new))
+            continue
+        old = metric(baseline[key])
+        change = 100.0 * (new - old) / old if old else 0.0
+        mark = ''
+        if change > threshold:
+            mark = ' REGRESSION'
+            regressions += 1
+        print('%-10s %-32s %8d %8d %+7.1f%%%s'
+              % (key[0], key[1], old, new, change, mark))
+    for key in sorted(set(baseline) - set(result)):
+        print('%-10s %-32s (missing)' % key)
+    return 1 if regressions else 0
+
+def usage():
+    sys.stderr.write('usage: benchmark.py run BOARD PORT [output.csv] [sketch-dir]\n'
+                     '       benchmark.py compare baseline.csv result.csv [threshold]\n')
+    return 2
+
+def main(argv):
+    if len(argv) < 2: return usage()
+    if argv[1] == 'run': return run(argv[2:])
+    if argv[1] == 'compare': return compare(argv[2:])
+    return usage()
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
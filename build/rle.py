@@ -0,0 +1,192 @@
+#!/usr/bin/env python
+#
+# @file rle.py
+# @version 1.0
+#
+# @section License
+# Copyright (C) 2015, Mikael Patel
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# @section Description
+# Run-length compression of Cosa Canvas fonts and icons (see
+# Canvas::RLE). Fonts are read from a font data file (compression
+# type 0 or 1, libraries/Font/Data) and written as compression type 2.
+# Icons are read from an icon file (width, height and bitmap) and
+# written with the given name as a compressed icon for
+# Canvas::draw_compressed_icon().
+#
+# Usage: rle.py font Data/12x24.h > Data/12x24.h
+#        rle.py icon Icon/arduino_icon_64x32.h name > name.h
+#
+# This file is part of the Arduino Che Cosa project.
+
+import re, sys
+
+def strip(text):
+    """remove comments from c source"""
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return re.sub(r'//.*', '', text)
+
+def array(text):
+    """return bytes of the first program memory array in c source"""
+    body = strip(text)
+    body = body[body.index('{', body.index('__PROGMEM')) + 1:]
+    body = body[:body.index('}')]
+    if '#' in body:
+        raise ValueError('conditional array data is not supported')
+    return [int(v, 0) for v in body.replace('\n', ' ').split(',') if v.strip()]
+
+def member(text, name):
+    return int(re.search(r'::' + name + r'\s*=\s*(\w+)', text).group(1), 0)
+
+def compress(data):
+    """run-length encode the given bytes"""
+    res = []
+    i = 0
+    literal = []
+    def flush():
+        while literal:
+            n = min(len(literal), 128)
+            res.append(n - 1)
+            res.extend(literal[:n])
+            del literal[:n]
+    while i < len(data):
+        v = data[i]
+        n = 1
+        while i + n < len(data) and data[i + n] == v and n < 64: n += 1
+        if v == 0 and n >= 2 or (v == 0 and not literal):
+            flush()
+            res.append(0xc0 | (n - 1))
+        elif n >= 3:
+            flush()
+            res.extend([0x80 | (n - 1), v])
+        else:
+            literal.extend(data[i:i + n])
+        i += n
+    flush()
+    return res
+
+def decompress(data, size):
+    """run-length decode given number of bytes; to verify"""
+    res = []
+    i = 0
+    while len(res) < size:
+        op = data[i]
+        i += 1
+        if op & 0x80:
+            n = (op & 0x3f) + 1
+            if op & 0x40: res.extend([0] * n)
+            else:
+                res.extend([data[i]] * n)
+                i += 1
+        else:
+            res.extend(data[i:i + op + 1])
+            i += op + 1
+    return res
+
+def glyphs(text):
+    """return list of uncompressed glyphs from font data file"""
+    width = member(text, 'width')
+    height = member(text, 'height')
+    first = member(text, 'first')
+    last = member(text, 'last')
+    kind = member(text, 'compression_type')
+    bitmap = array(text)
+    size = width * ((height + 7) // 8)
+    res = []
+    for c in range(last - first + 1):
+        if kind == 0:
+            res.append(bitmap[c * size:(c + 1) * size])
+            continue
+        offset = (bitmap[c * 2] << 8) | bitmap[c * 2 + 1]
+        escaped = offset & 0x8000
+        offset &= 0x7fff
+        setsize = (size + 7) // 8
+        if escaped: setsize *= 2
+        data = offset + setsize
+        glyph = []
+        for i in range(size):
+            ix = i >> 3
+            if escaped: ix = ix * 2 + 1
+            if bitmap[offset + ix] & (1 << (7 - (i % 8))):
+                glyph.append(bitmap[data])
+                data += 1
+            else:
+                glyph.append(0)
+        res.append(glyph)
+    return res, width, height, first, len(bitmap)
+
+def hexlist(data, indent=''):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ','.join('0x%02x' % v for v in data[i:i + 16]))
+    return ',\n'.join(lines)
+
+def font(path):
+    text = open(path).read()
+    table, width, height, first, before = glyphs(text)
+    cls = re.search(r'const uint8_t (\w+)::width', text).group(1)
+    size = width * ((height + 7) // 8)
+    index = []
+    data = []
+    cache = {}
+    base = len(table) * 2
+    for glyph in table:
+        key = tuple(glyph)
+        if key not in cache:
+            code = compress(glyph)
+            assert decompress(code, size) == glyph
+            cache[key] = base + len(data)
+            data.extend(code)
+        index.append(cache[key])
+    after = base + len(data)
+    out = text[:text.index('const uint8_t ' + cls + '::width')]
+    out = out.replace('/* encoding format', '/* run-length encoded (build/rle.py); format')
+    out += 'const uint8_t %s::width = %d;\n' % (cls, width)
+    out += 'const uint8_t %s::height = %d;\n' % (cls, height)
+    out += 'const uint8_t %s::first = 0x%x;\n' % (cls, first)
+    out += 'const uint8_t %s::last = 0x%x;\n' % (cls, first + len(table) - 1)
+    out += 'const uint8_t %s::compression_type = 2;\n\n' % cls
+    out += '/* glyph_size=%d */\n' % size
+    out += '/* uncompressed_size=%d */\n' % (size * len(table))
+    out += '/* bitmap_size=%d (was %d) */\n\n' % (after, before)
+    out += 'const uint8_t %s::bitmap[] __PROGMEM = {\n' % cls
+    out += hexlist(sum([[v >> 8, v & 0xff] for v in index], []), '  ') + ',\n'
+    out += hexlist(data, '  ') + '\n};\n'
+    return out
+
+def icon(path, name):
+    bitmap = array(open(path).read())
+    width, height = bitmap[0], bitmap[1]
+    data = bitmap[2:]
+    code = compress(data)
+    assert decompress(code, len(data)) == data
+    guard = 'COSA_CANVAS_ICON_%s_H' % name.upper()
+    out = '#ifndef %s\n#define %s\n\n' % (guard, guard)
+    out += '/* run-length encoded (build/rle.py) from %s; %d bytes (was %d) */\n' % \
+           (path.split('/')[-1], len(code) + 2, len(bitmap))
+    out += 'const uint8_t %s[] __PROGMEM = {\n%d,\n%d,\n' % (name, width, height)
+    out += hexlist(code) + '\n};\n\n#endif\n'
+    return out
+
+def main(argv):
+    if len(argv) == 3 and argv[1] == 'font':
+        sys.stdout.write(font(argv[2]))
+    elif len(argv) == 4 and argv[1] == 'icon':
+        sys.stdout.write(icon(argv[2], argv[3]))
+    else:
+        sys.stderr.write('usage: rle.py font file | rle.py icon file name\n')
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,133 @@
+#!/usr/bin/env python
+#
+# @file trace.py
+# @version 1.0
+#
+# @section License
+# Copyright (C) 2015, Mikael Patel
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# @section Description
+# Render Cosa binary trace records (COSA_TRACE_BINARY) as text. The
+# format strings are read from the program image of the sketch (elf
+# file). The records are read from a capture file or serial port.
+#
+# Usage: trace.py sketch.elf [capture|port] [baudrate]
+#
+# This file is part of the Arduino Che Cosa project.
+
+import os, struct, subprocess, sys, tempfile
+
+RECORD_START = 0xa5
+HEADER = struct.Struct('<BHLB')
+
+def load_image(elf):
+    """read program memory image (.text and .data) from elf file"""
+    fd, path = tempfile.mkstemp()
+    os.close(fd)
+    try:
+        subprocess.check_call(['avr-objcopy', '-O', 'binary',
+                               '-j', '.text', '-j', '.data', elf, path])
+        return open(path, 'rb').read()
+    finally:
+        os.remove(path)
+
+def string_P(image, addr):
+    """return null terminated string in program memory"""
+    end = image.find(b'\0', addr)
+    if end < 0: end = len(image)
+    return image[addr:end].decode('latin-1')
+
+def number(value, base):
+    if base == 'x': return '%x' % value
+    if base == 'o': return '%o' % value
+    if base == 'b': return bin(value)[2:]
+    if base == 'B': return '%x' % value
+    return '%d' % value
+
+def render(image, fmt, args):
+    """render format string with packed arguments as IOStream::vprintf()"""
+    res = ''
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        i += 1
+        if c != '%' or i == len(fmt):
+            res += c
+            continue
+        signed = True
+        base = 'd'
+        while i < len(fmt) and fmt[i] in 'bBohxu':
+            if fmt[i] == 'u': signed = False
+            else: base = 'x' if fmt[i] == 'h' else fmt[i]
+            i += 1
+        if i == len(fmt): break
+        if base != 'd': signed = False
+        c = fmt[i]
+        i += 1
+        if c == 'l': size, code = 4, 'l' if signed else 'L'
+        elif c in 'dcpsS': size, code = 2, 'h' if signed and c == 'd' else 'H'
+        else:
+            res += c
+            continue
+        if len(args) < size: break
+        value = struct.unpack('<' + code, args[:size])[0]
+        args = args[size:]
+        if c == 'c': res += chr(value & 0xff)
+        elif c == 'p' or c == 's': res += '0x%04x' % value
+        elif c == 'S': res += string_P(image, value)
+        else: res += number(value, base)
+    if args:
+        # Arguments without conversion (TRACE); integer or raw bytes
+        if len(args) in (1, 2, 4):
+            code = {1: 'b', 2: 'h', 4: 'l'}[len(args)]
+            res += '%d' % struct.unpack('<' + code, args)[0]
+        else:
+            res += ' '.join('%02x' % ord(args[i:i+1])
+                            for i in range(len(args)))
+        if not res.endswith('\n'): res += '\r\n'
+    return res
+
+def records(stream):
+    """generate (format, timestamp, args) from record stream"""
+    while True:
+        b = stream.read(1)
+        if not b: return
+        if ord(b) != RECORD_START: continue
+        header = b + stream.read(HEADER.size - 1)
+        if len(header) < HEADER.size: return
+        start, fmt, timestamp, size = HEADER.unpack(header)
+        args = stream.read(size)
+        if len(args) < size: return
+        yield fmt, timestamp, args
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write('usage: trace.py sketch.elf [capture|port] [baudrate]\n')
+        return 1
+    image = load_image(argv[1])
+    if len(argv) < 3:
+        stream = getattr(sys.stdin, 'buffer', sys.stdin)
+    elif argv[2].startswith('/dev/') or argv[2].startswith('COM'):
+        import serial
+        baudrate = int(argv[3]) if len(argv) > 3 else 57600
+        stream = serial.Serial(argv[2], baudrate)
+    else:
+        stream = open(argv[2], 'rb')
+    for fmt, timestamp, args in records(stream):
+        text = render(image, string_P(image, fmt), args)
+        sys.stdout.write('%10d:%s' % (timestamp, text))
+        sys.stdout.flush()
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
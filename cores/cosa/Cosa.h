@@ -42,6 +42,100 @@
  * #define COSA_EVENT_QUEUE_MAX 16
  */
 
+/**
+ * Multi-lane event queue with urgent, normal and background lanes
+ * and per-lane statistics. Default lane size is 8 entries (4 ATTINY).
+ * In file: Cosa/Event.hh
+ * #define COSA_EVENT_LANES
+ * #define COSA_EVENT_URGENT_QUEUE_MAX 8
+ * #define COSA_EVENT_BACKGROUND_QUEUE_MAX 8
+ */
+
+/**
+ * Event handler execution time profile; maximum on_event() time per
+ * handler measured with RTT::micros() in Event::service() and
+ * Event::service_for(). Default is 8 handler entries.
+ * In file: Cosa/Event.hh
+ * #define COSA_EVENT_PROFILE 8
+ */
+
+/**
+ * Interrupt service routine profile. Each Cosa interrupt service
+ * routine (except Timer1) and each outermost synchronized block and
+ * Lock is measured in processor cycles with Probe (Timer1). Use
+ * Probe::begin() and Probe::print(). Default is no profile.
+ * In file: Cosa/Probe.hh, Cosa/Types.h
+ * #define COSA_ISR_PROFILE
+ */
+
+/**
+ * Logic analyzer probe channels. Event dispatch, job dispatch,
+ * interrupt service routines and SPI/TWI bus transactions are marked
+ * on dedicated port pins with single instruction set/clear. See the
+ * file for the default pin mapping. Default is no probe channels.
+ * In file: Cosa/ProbeChannel.hh
+ * #define COSA_PROBE_CHANNEL
+ */
+
+/**
+ * Boot time profile; time stamp (RTT::micros()) of each boot stage
+ * from reset to setup() completed and deferred driver begin. The
+ * RTT is started by init(). Use Boot::print(). Default is 8 stages.
+ * In file: Cosa/Boot.hh
+ * #define COSA_BOOT_PROFILE 8
+ */
+
+/**
+ * Stack guard margin in bytes. Event::run() checks the free memory
+ * between heap and stack before each event dispatch and the first
+ * near-collision is reported by the Watermark monitor. Default
+ * margin is 64 bytes. Default is no check.
+ * In file: Cosa/Watermark.hh, Cosa/Event.cpp
+ * #define COSA_STACK_GUARD 64
+ */
+
+/**
+ * Nested interrupt handling. The pin change and external interrupt
+ * handlers are run with interrupts enabled (the vector is masked)
+ * to bound the latency of time-critical interrupt sources (e.g.
+ * Soft UART, RTT, radio). Default is interrupts disabled.
+ * In file: Cosa/Interrupt.hh, Cosa/PinChangeInterrupt.cpp,
+ * Cosa/ExternalInterrupt.cpp
+ * #define COSA_NESTED_PCINT
+ * #define COSA_NESTED_EXT_INT
+ */
+
+/**
+ * External memory (XMEM) on Arduino Mega boards. The memory interface
+ * is enabled by the start-up code, variables declared with __XMEM are
+ * placed in external memory and the heap is moved after them. Defined
+ * by the Mega XMEM board entries (boards.txt).
+ * In file: Cosa/Board/Arduino/Mega.hh
+ * #define COSA_XMEM
+ */
+
+/**
+ * Real-time timer tickless mode. The timer tick interrupt is only
+ * generated when jobs or delays are near. Default is periodic tick.
+ * In file: Cosa/RTT.hh
+ * #define COSA_RTT_TICKLESS
+ */
+
+/**
+ * Real-time timer asynchronous mode. Timer2 is clocked from a 32.768
+ * kHz crystal and keeps running in power save sleep mode. Coarser
+ * resolution; 15.625 ms tick. Default is synchronous timer.
+ * In file: Cosa/RTT.hh
+ * #define COSA_RTT_ASYNC
+ */
+
+/**
+ * Real-time timer scheduler jitter measurement. Minimum and maximum
+ * job dispatch latency is recorded. Default is no measurement.
+ * In file: Cosa/RTT.hh
+ * #define COSA_RTT_JITTER
+ */
+
 /**
  * UART buffer size. Default is 32 characters (16 ATTINY).
  * In file: Cosa/UART.hh
@@ -49,6 +143,14 @@
  * #define COSA_UART_TX_BUFFER_MAX 32
  */
 
+/**
+ * CDC receiver buffer size. Default is 64 characters (one bulk
+ * packet). Larger buffers allow the double bank OUT endpoint to be
+ * emptied on each frame.
+ * In file: Cosa/CDC.hh
+ * #define COSA_CDC_BUFFER_MAX 64
+ */
+
 /**
  * Soft::UART buffer size. Default is 32 characters (16 for ATTINY).
  * In file: Cosa/Soft/UART.hh
@@ -56,10 +158,138 @@
  * #define COSA_SOFT_UART_TX_BUFFER_MAX 32
  */
 
+/**
+ * FAT16 block cache size. Default is 4 blocks (1 for devices with
+ * 8 Kbyte SRAM or less).
+ * In file: FAT16.hh
+ * #define COSA_FAT16_CACHE_MAX 4
+ */
+
+/**
+ * FAT16 root directory name index size (number of entries). Default
+ * is zero; no index.
+ * In file: FAT16.hh
+ * #define COSA_FAT16_INDEX_MAX 512
+ */
+
+/**
+ * Wireless link manager number of destinations. Default is 8.
+ * In file: Cosa/Wireless.hh
+ * #define COSA_WIRELESS_MANAGER_MAX 8
+ */
+
+/**
+ * Wireless packet aggregation frame buffer size. Should be at most
+ * the max payload of the wireless device driver. Default is 30 bytes.
+ * In file: Cosa/Wireless.hh
+ * #define COSA_WIRELESS_AGGREGATOR_FRAME_MAX 30
+ */
+
+/**
+ * Ascon authenticated encryption wireless driver filter frame buffer
+ * size. Should be at least the device driver max payload. Default
+ * is 32 bytes.
+ * In file: Ascon.hh
+ * #define COSA_ASCON_FRAME_MAX 32
+ */
+
+/**
+ * Ascon authenticated encryption wireless driver filter replay
+ * window size (number of sources). Default is 8.
+ * In file: Ascon.hh
+ * #define COSA_ASCON_REPLAY_MAX 8
+ */
+
+/**
+ * NRF24L01P interrupt driven receive ring size (number of frames,
+ * power of 2). Default is zero; no receive ring.
+ * In file: NRF24L01P.hh
+ * #define COSA_NRF24L01P_RING_MAX 8
+ */
+
+/**
+ * DNS resolver cache size (number of hostnames). Default is 4
+ * entries. Zero will disable the cache.
+ * In file: DNS.hh
+ * #define COSA_DNS_CACHE_MAX 4
+ */
+
+/**
+ * Servo number of channels. Default is 8 channels.
+ * In file: Servo.hh
+ * #define COSA_SERVO_CHANNEL_MAX 8
+ */
+
+/**
+ * String inline buffer size; strings with max this number of
+ * characters are stored in the String instance and do not use the
+ * heap. Default is 7 characters.
+ * In file: Cosa/String.hh
+ * #define COSA_STRING_INLINE_MAX 7
+ */
+
 /**
  * IOStream long integer to string conversion. Default is use the
  * high performance implementation in Cosa.
  * In file: Cosa/IOStream.hh
  * #define COSA_IOSTREAM_STDLIB_DTOA
  */
+
+/**
+ * Trace binary record mode. The trace macros (TRACE, TRACE_P and
+ * the log macros) write compact binary records (format string
+ * address, timestamp and raw arguments) instead of formatted text.
+ * Requires RTT. Use build/trace.py to render the records. Default
+ * is text output.
+ * In file: Cosa/Trace.hh
+ * #define COSA_TRACE_BINARY
+ */
+
+/**
+ * CRC table size; 4 for nibble tables (16 entries) or 8 for byte
+ * tables (256 entries). Nibble tables trade speed for program
+ * memory. Default is byte tables except for ATtiny.
+ * In file: Cosa/CRC.hh
+ * #define COSA_CRC_TABLE 8
+ */
+
+/**
+ * Synthesizer number of voices. Default is 4 voices.
+ * In file: Cosa/Synth.hh
+ * #define COSA_SYNTH_VOICE_MAX 4
+ */
+
+/**
+ * HTTP server request query string and captured header value buffer
+ * sizes. Default is 32 and 48 bytes.
+ * In file: Cosa/HTTP.hh
+ * #define COSA_HTTP_QUERY_MAX 32
+ * #define COSA_HTTP_VALUE_MAX 48
+ */
+
+/**
+ * Remove trace output and assertions; the trace and log macros are
+ * defined empty (defines NDEBUG). Default is trace enabled.
+ * In file: Cosa/Types.h, Cosa/Trace.hh
+ * #define COSA_NO_TRACE
+ */
+
+/**
+ * Direct event dispatch. Event::dispatch() calls the on_event()
+ * function of a single application handler class without virtual
+ * function call. The class is given with EVENT_HANDLER_DISPATCH().
+ * All event targets must be instances of the class. Default is
+ * virtual dispatch.
+ * In file: Cosa/Event.hh
+ * #define COSA_EVENT_DIRECT_DISPATCH
+ */
+
+/**
+ * Size optimized build profile (ATtiny). Enables COSA_NO_TRACE and
+ * nibble CRC tables. Use together with the queue and buffer size
+ * settings above. Use the make target size_report to list the
+ * largest symbols of the build.
+ * In file: Cosa/Types.h
+ * #define COSA_SIZE_PROFILE
+ */
 #endif
@@ -0,0 +1,102 @@
+/**
+ * @file Cosa/Alarm.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Alarm.hh"
+
+bool
+Alarm::Scheduler::begin()
+{
+  if (UNLIKELY(!wakeup())) return (false);
+  ExternalInterrupt::enable();
+  return (true);
+}
+
+bool
+Alarm::Scheduler::end()
+{
+  ExternalInterrupt::disable();
+  return (m_rtc->clear_wakeup());
+}
+
+bool
+Alarm::Scheduler::sync()
+{
+  clock_t now;
+  if (UNLIKELY(!m_rtc->get_clock(now))) return (false);
+  time(now);
+  return (true);
+}
+
+bool
+Alarm::Scheduler::start(Job* job)
+{
+  // Alarm relative to the current time; synchronize before queuing
+  if (UNLIKELY(!sync())) return (false);
+  if (!::Clock::start(job)) return (false);
+
+  // Reprogram the wakeup if this is the earliest alarm
+  if (m_queue.succ() == job) return (wakeup());
+  return (true);
+}
+
+bool
+Alarm::Scheduler::stop(Job* job)
+{
+  bool first = (m_queue.succ() == job);
+  if (!::Clock::stop(job)) return (false);
+  if (first) return (wakeup());
+  return (true);
+}
+
+bool
+Alarm::Scheduler::wakeup()
+{
+  // Synchronize and dispatch the expired alarms (push timeout events)
+  if (UNLIKELY(!sync())) return (false);
+  dispatch();
+
+  // Disable the wakeup alarm if there are no pending alarms
+  if (m_queue.is_empty()) return (m_rtc->clear_wakeup());
+
+  // Program the wakeup alarm to the earliest pending alarm
+  clock_t now = time();
+  clock_t when = ((Job*) m_queue.succ())->expire_at();
+  if ((int32_t) (when - now) < LEAD_MIN) when = now + LEAD_MIN;
+  return (m_rtc->set_wakeup(when));
+}
+
+void
+Alarm::Scheduler::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+
+  // Low level interrupt is active until the alarm is cleared
+  ExternalInterrupt::disable();
+  Event::push(Event::TIMEOUT_TYPE, this);
+}
+
+void
+Alarm::Scheduler::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (UNLIKELY(type != Event::TIMEOUT_TYPE)) return;
+  wakeup();
+  ExternalInterrupt::enable();
+}
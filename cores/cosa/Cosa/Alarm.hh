@@ -22,15 +22,19 @@
 #define COSA_ALARM_HH
 
 #include "Cosa/Types.h"
+#include "Cosa/Time.hh"
 #include "Cosa/Clock.hh"
 #include "Cosa/Periodic.hh"
+#include "Cosa/Event.hh"
 #include "Cosa/ExternalInterrupt.hh"
 
 /**
  * The Alarm class is an extension of the Periodic job class. It allows
  * repeated jobs with seconds as time unit. The abstract Alarm Clock
  * is used as the alarm scheduler. It is triggered by an external
- * interrupt typically from an RTC device.
+ * interrupt typically from an RTC device. The Alarm Scheduler is a
+ * tickless alternative that programs the RTC alarm to the earliest
+ * pending alarm.
  */
 class Alarm : public Periodic {
 public:
@@ -69,14 +73,175 @@ public:
     }
   };
 
+  /**
+   * Abstract real-time clock wakeup device. Implemented by RTC device
+   * drivers with an alarm interrupt output (DS3231, MCP7940N and
+   * PCF8563). The alarm output should be active low and remain
+   * active until the next call of set_wakeup() or clear_wakeup().
+   * Time is in seconds from the time_t epoch.
+   */
+  class Device {
+  public:
+    /**
+     * @override{Alarm::Device}
+     * Read current time in seconds from the real-time clock. Return
+     * true(1) if successful otherwise false(0).
+     * @param[out] now seconds.
+     * @return bool.
+     */
+    virtual bool get_clock(clock_t& now) = 0;
+
+    /**
+     * @override{Alarm::Device}
+     * Program the wakeup alarm to given time in seconds and clear
+     * any pending alarm. Devices with less alarm resolution should
+     * round up. Return true(1) if successful otherwise false(0).
+     * @param[in] when seconds.
+     * @return bool.
+     */
+    virtual bool set_wakeup(clock_t when) = 0;
+
+    /**
+     * @override{Alarm::Device}
+     * Disable the wakeup alarm and clear any pending alarm. Return
+     * true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    virtual bool clear_wakeup() = 0;
+  };
+
+  /**
+   * Alarm Scheduler is a tickless RTC alarm driven job scheduler.
+   * The RTC wakeup alarm is always programmed to the earliest pending
+   * alarm so that the processor may sleep in power down mode,
+   * Power::sleep(SLEEP_MODE_PWR_DOWN), between the alarms; there are
+   * no periodic wakeups. The alarm interrupt pin is used in low level
+   * mode as this is the only external interrupt mode that will wake
+   * up from power down. The RTC device is accessed (TWI) from the
+   * event handler, i.e. from the main loop, and never from the
+   * interrupt handler.
+   * @code
+   * DS3231 rtc;
+   * Alarm::Scheduler alarms(&rtc, Board::EXT0);
+   * ...
+   * Power::set(SLEEP_MODE_PWR_DOWN);
+   * alarms.begin();
+   * ...
+   * Event::service();
+   * @endcode
+   * @section Limitations
+   * The scheduler time is updated when the RTC alarm is handled, when
+   * alarms are started and on sync(). Alarms should not be started
+   * from interrupt handlers. The wakeup alarm is programmed at least
+   * LEAD_MIN seconds ahead of the current time.
+   */
+  class Scheduler :
+    public ::Clock,
+    public ExternalInterrupt,
+    public Event::Handler
+  {
+  public:
+    /** Minimum wakeup lead time in seconds. */
+    static const uint8_t LEAD_MIN = 2;
+
+    /**
+     * Construct Alarm Scheduler with given RTC device, alarm
+     * interrupt pin, mode and pullup flag.
+     * @param[in] rtc real-time clock wakeup device.
+     * @param[in] pin external interrupt pin.
+     * @param[in] mode pin mode (Default ON_LOW_LEVEL_MODE).
+     * @param[in] pullup flag (Default true).
+     */
+    Scheduler(Device* rtc,
+	      Board::ExternalInterruptPin pin,
+	      InterruptMode mode = ON_LOW_LEVEL_MODE,
+	      bool pullup = true) :
+      ::Clock(),
+      ExternalInterrupt(pin, mode, pullup),
+      m_rtc(rtc)
+    {}
+
+    /**
+     * Synchronize with the real-time clock, program the wakeup alarm
+     * and enable the alarm interrupt. Return true(1) if successful
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool begin();
+
+    /**
+     * Disable the alarm interrupt and the wakeup alarm. Return
+     * true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    bool end();
+
+    /**
+     * Read the real-time clock and update the scheduler time. Return
+     * true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    bool sync();
+
+    /**
+     * @override{Job::Scheduler}
+     * Start given alarm and reprogram the wakeup alarm if it is the
+     * earliest pending. Returns true(1) if successful otherwise
+     * false(0).
+     * @param[in] job to start.
+     * @return bool.
+     */
+    virtual bool start(Job* job);
+
+    /**
+     * @override{Job::Scheduler}
+     * Stop given alarm and reprogram the wakeup alarm if it was the
+     * earliest pending. Returns true(1) if successful otherwise
+     * false(0).
+     * @param[in] job to stop.
+     * @return bool.
+     */
+    virtual bool stop(Job* job);
+
+  protected:
+    /** Real-time clock wakeup device. */
+    Device* m_rtc;
+
+    /**
+     * Synchronize with the real-time clock, dispatch expired alarms
+     * and program the wakeup alarm to the earliest pending alarm.
+     * Return true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    bool wakeup();
+
+    /**
+     * @override{Interrupt::Handler}
+     * Disable the (level) interrupt and push an event to handle
+     * the alarm in the main loop.
+     * @param[in] arg argument from interrupt service routine (not used).
+     */
+    virtual void on_interrupt(uint16_t arg = 0);
+
+    /**
+     * @override{Event::Handler}
+     * Handle alarm; dispatch expired alarms, program the next wakeup
+     * alarm and enable the interrupt.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+  };
+
   /**
    * Construct alarm with given clock and timeout period in seconds.
    * The clock should be a job scheduler with seconds as time unit.
    * @param[in] clock for alarms.
    * @param[in] period for alarm in seconds.
+   * @param[in] policy catch-up policy on overrun (default BURST).
    */
-  Alarm(::Clock* clock, uint32_t period) :
-    Periodic(clock, period)
+  Alarm(::Clock* clock, uint32_t period, Policy policy = BURST) :
+    Periodic(clock, period, policy)
   {}
 };
 #endif
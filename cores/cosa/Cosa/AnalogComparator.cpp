@@ -19,17 +19,78 @@
  */
 
 #include "Cosa/AnalogComparator.hh"
+#include "Cosa/Probe.hh"
 
 AnalogComparator* AnalogComparator::s_comparator = NULL;
 
 void
 AnalogComparator::on_interrupt(uint16_t arg)
 {
-  Event::push(Event::CHANGE_TYPE, this, arg);
+  Event::coalesce(Event::CHANGE_TYPE, this, arg);
 }
 
+void
+AnalogTrigger::enable()
+{
+  synchronized {
+    // Route the pin to the negative input through the ADC multiplexer
+    s_comparator = this;
+    bit_clear(ADCSRA, ADEN);
+    ADMUX = (m_reference | (m_channel & 0x1f));
+#if defined(MUX5)
+    bit_write(m_channel & 0x20, ADCSRB, MUX5);
+#endif
+    bit_set(ADCSRB, ACME);
+
+    // Clear pending interrupt and enable comparator interrupt
+    ACSR = (m_bandgap ? _BV(ACBG) : 0) | _BV(ACI) | _BV(ACIE) | m_mode;
+  }
+}
+
+void
+AnalogTrigger::disable()
+{
+  synchronized {
+    ACSR = _BV(ACD);
+    bit_clear(ADCSRB, ACME);
+    bit_set(ADCSRA, ADEN);
+    s_comparator = NULL;
+  }
+}
+
+void
+AnalogTrigger::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  bit_clear(ACSR, ACIE);
+  Event::push(Event::CHANGE_TYPE, this);
+}
+
+void
+AnalogTrigger::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (UNLIKELY((type != Event::CHANGE_TYPE) || (s_comparator != this)))
+    return;
+
+  // Take the confirm sample with the ADC
+  bit_set(ADCSRA, ADEN);
+  uint16_t sample = AnalogPin::sample(m_channel, m_reference);
+  if (sample != UINT16_MAX) {
+    m_value = sample;
+    if (m_rising ? (sample >= m_threshold) : (sample <= m_threshold))
+      on_trigger(sample);
+  }
+
+  // Re-arm unless disabled by the trigger callback
+  if (s_comparator == this) enable();
+}
+
+ISR_PROBE_DEFINE(analog_comp_isr_probe, "isr:ANALOG_COMP");
+
 ISR(ANALOG_COMP_vect)
 {
+  ISR_PROBE(analog_comp_isr_probe);
   if (UNLIKELY(AnalogComparator::s_comparator == NULL)) return;
   AnalogComparator::s_comparator->on_interrupt();
 }
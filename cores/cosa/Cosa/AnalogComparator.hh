@@ -23,6 +23,7 @@
 
 #include "Cosa/Event.hh"
 #include "Cosa/Interrupt.hh"
+#include "Cosa/AnalogPin.hh"
 
 /**
  * Analog Comparator; compare input values on the positive pin AIN0 (D6)
@@ -106,4 +107,104 @@ protected:
   friend void ANALOG_COMP_vect(void);
 };
 
+/**
+ * Analog threshold trigger. The analog comparator is used to detect
+ * when the voltage on an analog pin (ADCn, through the ADC
+ * multiplexer) crosses the reference voltage; bandgap (1V1) or AIN0
+ * (D6). On a crossing a single ADC sample of the pin is taken to
+ * confirm that the sample is above (or below) the threshold before
+ * on_trigger() is called. No polling of the analog pin is needed and
+ * the processor may sleep between crossings.
+ *
+ * @section Limitations
+ * The ADC is disabled (ADEN) while the trigger is armed as the ADC
+ * multiplexer is used by the comparator. Requires AnalogPin::powerup().
+ */
+class AnalogTrigger : public AnalogComparator {
+public:
+  /**
+   * Construct analog threshold trigger for given analog pin and
+   * confirm threshold (sample value). The trigger direction is
+   * the pin voltage rising above or falling below the reference
+   * voltage.
+   * @param[in] pin analog pin to monitor.
+   * @param[in] threshold sample value to confirm crossing.
+   * @param[in] rising trigger direction (default rising).
+   * @param[in] bandgap reference voltage bandgap (1V1) or AIN0
+   *   (default bandgap).
+   * @param[in] ref reference voltage for confirm sample (default VCC).
+   */
+  AnalogTrigger(Board::AnalogPin pin, uint16_t threshold,
+		bool rising = true, bool bandgap = true,
+		Board::Reference ref = Board::AVCC_REFERENCE) :
+    AnalogComparator(pin, rising ? ON_FALLING_MODE : ON_RISING_MODE),
+    m_channel(pin),
+    m_reference(ref),
+    m_threshold(threshold),
+    m_rising(rising),
+    m_bandgap(bandgap),
+    m_value(0)
+  {}
+
+  /**
+   * Get latest confirm sample.
+   * @return sample value.
+   */
+  uint16_t value() const
+  {
+    return (m_value);
+  }
+
+  /**
+   * @override{Interrupt::Handler}
+   * Arm the trigger; select the pin for the comparator and enable
+   * the comparator interrupt.
+   * @note atomic
+   */
+  virtual void enable();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Disarm the trigger and enable the ADC.
+   * @note atomic
+   */
+  virtual void disable();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Disable the comparator interrupt and push a change event to take
+   * the confirm sample.
+   * @param[in] arg argument from interrupt service routine.
+   */
+  virtual void on_interrupt(uint16_t arg = 0);
+
+  /**
+   * @override{AnalogTrigger}
+   * Application extension; Called when a crossing of the threshold
+   * has been confirmed.
+   * @param[in] value confirm sample.
+   */
+  virtual void on_trigger(uint16_t value)
+  {
+    UNUSED(value);
+  }
+
+protected:
+  Board::AnalogPin m_channel;	//!< Monitored analog pin.
+  Board::Reference m_reference;	//!< ADC reference for confirm sample.
+  uint16_t m_threshold;		//!< Confirm threshold.
+  bool m_rising;		//!< Trigger direction.
+  bool m_bandgap;		//!< Bandgap or AIN0 as reference.
+  uint16_t m_value;		//!< Latest confirm sample.
+
+  /**
+   * @override{Event::Handler}
+   * Take the confirm sample on change event, call on_trigger() if
+   * the threshold is crossed and re-arm the trigger.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+};
+
 #endif
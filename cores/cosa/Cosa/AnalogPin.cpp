@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/AnalogPin.hh"
+#include "Cosa/Probe.hh"
 
 bool
 AnalogPin::sample_request(Board::AnalogPin pin, uint8_t ref)
@@ -38,6 +39,10 @@ uint16_t
 AnalogPin::sample_await()
 {
   if (UNLIKELY(sampling_pin != this)) return (m_value);
+  if (s_noise_reduction && (m_event == Event::NULL_TYPE)) {
+    await_conversion();
+    return (value());
+  }
   synchronized {
     sampling_pin = NULL;
     bit_clear(ADCSRA, ADIE);
@@ -72,8 +77,11 @@ AnalogPin::on_interrupt(uint16_t value)
   sampling_pin = NULL;
 }
 
+ISR_PROBE_DEFINE(adc_isr_probe, "isr:ADC");
+
 ISR(ADC_vect)
 {
+  ISR_PROBE(adc_isr_probe);
   bit_clear(ADCSRA, ADIE);
   if (UNLIKELY(AnalogPin::sampling_pin == NULL)) return;
   AnalogPin::sampling_pin->on_interrupt(ADCW);
@@ -89,6 +89,31 @@ public:
    */
   static void prescale(uint8_t factor);
 
+  /**
+   * Set ADC noise reduction sampling mode. When enabled sample() and
+   * sample_await() put the processor in ADC Noise Reduction sleep
+   * mode (SLEEP_MODE_ADC) during the conversion and are woken by the
+   * conversion interrupt; less noise from the processor and I/O
+   * clocks and lower active current. Timers driven by the I/O clock
+   * (e.g. Timer0/Timer1) are halted during the conversion. Default
+   * is busy-wait.
+   * @param[in] flag enable noise reduction mode.
+   */
+  static void noise_reduction(bool flag)
+  {
+    s_noise_reduction = flag;
+  }
+
+  /**
+   * Return true(1) if the ADC noise reduction sampling mode is
+   * enabled otherwise false(0).
+   * @return bool.
+   */
+  static bool noise_reduction()
+  {
+    return (s_noise_reduction);
+  }
+
   /**
    * Sample analog pin. Wait for conversion to complete before
    * returning with sample value.
@@ -199,6 +224,7 @@ public:
 
 protected:
   static AnalogPin* sampling_pin; //!< Current sampling pin if any.
+  static bool s_noise_reduction;  //!< ADC noise reduction mode.
   const Board::AnalogPin m_pin;	  //!< Analog channel number.
   Board::Reference m_reference;	  //!< ADC reference voltage type.
   uint16_t m_value;		  //!< Latest sample value.
@@ -213,6 +239,12 @@ protected:
    */
   bool sample_request(Board::AnalogPin pin, uint8_t ref);
 
+  /**
+   * Sleep in ADC noise reduction mode until the conversion complete
+   * interrupt has been serviced (interrupt enable cleared).
+   */
+  static void await_conversion();
+
   /**
    * @override{Event::Handler}
    * Handle analog pin periodic sampling and sample completed event.
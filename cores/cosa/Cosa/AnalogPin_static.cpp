@@ -21,6 +21,7 @@
 #include "Cosa/AnalogPin.hh"
 
 AnalogPin* AnalogPin::sampling_pin = NULL;
+bool AnalogPin::s_noise_reduction = false;
 
 void
 AnalogPin::prescale(uint8_t factor)
@@ -55,7 +56,30 @@ AnalogPin::sample(Board::AnalogPin pin, Board::Reference ref)
 #if defined(MUX5)
   bit_write(pin & 0x20, ADCSRB, MUX5);
 #endif
-  bit_set(ADCSRA, ADSC);
-  loop_until_bit_is_clear(ADCSRA, ADSC);
+  if (s_noise_reduction) {
+    bit_mask_set(ADCSRA, _BV(ADSC) | _BV(ADIF) | _BV(ADIE));
+    await_conversion();
+  }
+  else {
+    bit_set(ADCSRA, ADSC);
+    loop_until_bit_is_clear(ADCSRA, ADSC);
+  }
   return (ADCW);
 }
+
+void
+AnalogPin::await_conversion()
+{
+  // Check and sleep with interrupts disabled; the instruction after
+  // sei() is always executed so the wakeup interrupt cannot be lost
+  uint8_t key = lock();
+  set_sleep_mode(SLEEP_MODE_ADC);
+  while (bit_is_set(ADCSRA, ADIE)) {
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+  unlock(key);
+}
@@ -36,6 +36,6 @@ AnalogPins::on_interrupt(uint16_t value)
     AnalogPin::sample_request(pin_at(m_next), m_reference);
   }
   else {
-    Event::push(Event::SAMPLE_COMPLETED_TYPE, this, value);
+    Event::coalesce(Event::SAMPLE_COMPLETED_TYPE, this, value);
   }
 }
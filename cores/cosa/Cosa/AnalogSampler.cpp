@@ -0,0 +1,147 @@
+/**
+ * @file Cosa/AnalogSampler.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/AnalogSampler.hh"
+#include "Cosa/Power.hh"
+
+#if !defined(BOARD_ATTINY)
+
+// Timer1 clock select and prescale (log2)
+static const uint8_t s_prescale[] __PROGMEM = {
+  0, 3, 6, 8, 10
+};
+
+bool
+AnalogSampler::begin(uint16_t rate)
+{
+  if (UNLIKELY(rate == 0)) return (false);
+
+  // Calculate timer prescale and top for the sample rate
+  uint32_t ticks = F_CPU / rate;
+  uint8_t cs = 0;
+  while ((ticks >> pgm_read_byte(&s_prescale[cs])) > 65536UL)
+    if (++cs == membersof(s_prescale)) return (false);
+  uint16_t top = (ticks >> pgm_read_byte(&s_prescale[cs])) - 1;
+
+  // Claim the converter
+  synchronized {
+    if (UNLIKELY(sampling_pin != NULL)) return (false);
+    sampling_pin = this;
+    m_next = 0;
+    m_pin = 0;
+    m_busy = 0;
+  }
+  loop_until_bit_is_clear(ADCSRA, ADSC);
+  select(0);
+
+  // Timer1 in CTC mode; compare match B triggers the conversion.
+  // The timer requires idle sleep mode
+  Power::acquire(Power::IDLE_LEVEL);
+  Power::timer1_enable();
+  TCCR1B = 0;
+  TCCR1A = 0;
+  TCNT1 = 0;
+  OCR1A = top;
+  OCR1B = top;
+  TIFR1 = _BV(OCF1B);
+
+  // Auto trigger on Timer1 compare match B
+  ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0)))
+    | _BV(ADTS2) | _BV(ADTS0);
+  bit_mask_set(ADCSRA, _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | _BV(ADIE));
+  TCCR1B = _BV(WGM12) | (cs + 1);
+  return (true);
+}
+
+void
+AnalogSampler::end()
+{
+  synchronized {
+    if (sampling_pin != this) return;
+    TCCR1B = 0;
+    bit_mask_clear(ADCSRA, _BV(ADATE) | _BV(ADIE));
+    sampling_pin = NULL;
+  }
+  loop_until_bit_is_clear(ADCSRA, ADSC);
+  Power::timer1_disable();
+  Power::release(Power::IDLE_LEVEL);
+}
+
+void
+AnalogSampler::select(uint8_t ix)
+{
+  Board::AnalogPin pin = (Board::AnalogPin) pgm_read_byte(&m_pin_at[ix]);
+  ADMUX = (m_reference | (pin & 0x1f));
+#if defined(MUX5)
+  bit_write(pin & 0x20, ADCSRB, MUX5);
+#endif
+}
+
+void
+AnalogSampler::on_interrupt(uint16_t value)
+{
+  // Re-arm the trigger (flag edge) and the conversion interrupt
+  TIFR1 = _BV(OCF1B);
+  bit_set(ADCSRA, ADIE);
+
+  // Select next pin; the conversion in progress is not affected by
+  // the channel change
+  uint8_t ix = m_pin;
+  uint8_t pin = ix + 1;
+  if (pin == m_count) pin = 0;
+  m_pin = pin;
+  if (m_count > 1) select(pin);
+
+  // Pass sample through the reducer pipeline and store result
+  if ((m_reducer != NULL) && !m_reducer->put(ix, value)) return;
+  uint16_t next = m_next;
+  m_buffer[next++] = value;
+
+  // Check for block completed; pass to event handler or drop if the
+  // other block is still being processed
+  uint16_t end = (next > m_block) ? 2 * m_block : m_block;
+  if (next == end) {
+    ix = (next > m_block);
+    uint8_t other = 1 << (ix ^ 1);
+    if (UNLIKELY(m_busy & other)) {
+      m_overruns += 1;
+      next -= m_block;
+    }
+    else {
+      m_busy |= (1 << ix);
+      if (UNLIKELY(!Event::push(Event::SAMPLE_COMPLETED_TYPE, this, ix))) {
+	m_busy &= ~(1 << ix);
+	m_overruns += 1;
+      }
+      if (next == 2 * m_block) next = 0;
+    }
+  }
+  m_next = next;
+}
+
+void
+AnalogSampler::on_event(uint8_t type, uint16_t value)
+{
+  if (UNLIKELY(type != Event::SAMPLE_COMPLETED_TYPE)) return;
+  on_block(&m_buffer[value * m_block], m_block);
+  synchronized m_busy &= ~(1 << value);
+}
+
+#endif
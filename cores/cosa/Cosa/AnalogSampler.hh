@@ -0,0 +1,394 @@
+/**
+ * @file Cosa/AnalogSampler.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_ANALOG_SAMPLER_HH
+#define COSA_ANALOG_SAMPLER_HH
+
+#include "Cosa/AnalogPin.hh"
+
+#if !defined(BOARD_ATTINY)
+
+/**
+ * Continuous analog acquisition. Conversions are auto-triggered by
+ * Timer1 compare match B at the given sample rate and the interrupt
+ * handler stores the samples of a sequence of pins (in program
+ * memory) into two alternating sample blocks (ping-pong buffer). A
+ * SAMPLE_COMPLETED_TYPE event is pushed for each full block and the
+ * virtual member function on_block() is called to process the block
+ * while the other block is filled. A block that is completed while
+ * the other block is still being processed is dropped and counted
+ * as an overrun. An optional reducer pipeline (oversampling,
+ * statistics, filter) may be attached to reduce the samples in the
+ * interrupt handler; only reduced values are then stored in the
+ * blocks.
+ * @code
+ * const Board::AnalogPin pins[] __PROGMEM = { Board::A0, Board::A1 };
+ * uint16_t buffer[2 * 64];
+ * class Monitor : public AnalogSampler {
+ * public:
+ *   Monitor() : AnalogSampler(pins, membersof(pins), buffer, 64) {}
+ *   virtual void on_block(const uint16_t* block, uint16_t count) { ... }
+ * };
+ * Monitor monitor;
+ * ...
+ * monitor.begin(1000);
+ * @endcode
+ * @section Limitations
+ * Uses Timer1 (compare match B flag; no interrupt handler). Cannot
+ * be used together with Tone or other Timer1 users. The maximum
+ * sample rate is given by the ADC clock (AnalogPin::prescale); 13
+ * ADC clock cycles per conversion, approx. 9.6 kHz with the default
+ * prescale (128) at 16 MHz.
+ */
+class AnalogSampler : private AnalogPin {
+public:
+  /**
+   * Construct analog sampler for given pin sequence (in program
+   * memory), buffer for two sample blocks of given size and
+   * reference voltage. The block size should be a multiple of the
+   * number of pins to keep the samples of each pin at fixed offsets
+   * in the blocks.
+   * @param[in] pins vector with analog pins (in program memory).
+   * @param[in] count number of pins in vector.
+   * @param[in] buffer sample storage (2 x block).
+   * @param[in] block number of samples per block.
+   * @param[in] ref reference voltage (default VCC).
+   */
+  AnalogSampler(const Board::AnalogPin* pins, uint8_t count,
+		uint16_t* buffer, uint16_t block,
+		Board::Reference ref = Board::AVCC_REFERENCE) :
+    AnalogPin((Board::AnalogPin) 255, ref),
+    m_pin_at(pins),
+    m_count(count),
+    m_buffer(buffer),
+    m_block(block),
+    m_next(0),
+    m_pin(0),
+    m_busy(0),
+    m_overruns(0),
+    m_reducer(NULL)
+  {}
+
+  /**
+   * Sample reducer; called from the interrupt handler with each
+   * sample and the pin sequence index. Reducers may be chained into
+   * a pipeline; the reduced value is passed to the next reducer.
+   */
+  class Reducer {
+  public:
+    /**
+     * Construct reducer with given next reducer in pipeline.
+     * @param[in] next reducer (default none).
+     */
+    Reducer(Reducer* next = NULL) : m_next(next) {}
+
+    /**
+     * Reduce given sample for given pin sequence index and pass to
+     * the next reducer. Return true(1) if a value was produced
+     * (updated in place) otherwise false(0).
+     * @param[in] ix pin sequence index.
+     * @param[in,out] value sample.
+     * @return bool.
+     */
+    bool put(uint8_t ix, uint16_t& value)
+    {
+      if (!reduce(ix, value)) return (false);
+      return ((m_next == NULL) || m_next->put(ix, value));
+    }
+
+    /**
+     * @override{AnalogSampler::Reducer}
+     * Reduce given sample. Return true(1) if a value is produced.
+     * Called from interrupt service routine.
+     * @param[in] ix pin sequence index.
+     * @param[in,out] value sample.
+     * @return bool.
+     */
+    virtual bool reduce(uint8_t ix, uint16_t& value) = 0;
+
+  protected:
+    Reducer* m_next;		//!< Next reducer in pipeline.
+  };
+
+  /**
+   * Oversampling and decimation. Accumulates 4^BITS samples per pin
+   * and produces a value with BITS extra bits of resolution.
+   * Requires noise (at least 1 LSB) on the input signal.
+   * @param[in] PINS number of pins in sequence.
+   * @param[in] BITS extra bits of resolution (1..6).
+   */
+  template<uint8_t PINS, uint8_t BITS>
+  class Oversample : public Reducer {
+  public:
+    /**
+     * Construct oversampling reducer with given next reducer.
+     * @param[in] next reducer (default none).
+     */
+    Oversample(Reducer* next = NULL) : Reducer(next)
+    {
+      static_assert(BITS > 0 && BITS <= 6, "BITS should be 1..6");
+      memset(m_sum, 0, sizeof(m_sum));
+      memset(m_count, 0, sizeof(m_count));
+    }
+
+    /**
+     * @override{AnalogSampler::Reducer}
+     * Accumulate sample and produce decimated value.
+     * @param[in] ix pin sequence index.
+     * @param[in,out] value sample.
+     * @return bool.
+     */
+    virtual bool reduce(uint8_t ix, uint16_t& value)
+    {
+      m_sum[ix] += value;
+      if (++m_count[ix] != (1 << (2 * BITS))) return (false);
+      value = m_sum[ix] >> BITS;
+      m_sum[ix] = 0;
+      m_count[ix] = 0;
+      return (true);
+    }
+
+  protected:
+    uint32_t m_sum[PINS];	//!< Accumulated samples.
+    uint16_t m_count[PINS];	//!< Number of accumulated samples.
+  };
+
+  /**
+   * Windowed statistics. Collect minimum, maximum and mean value per
+   * pin over a window of given number of samples. Produces the mean;
+   * the minimum and maximum of the latest window may be read with
+   * min() and max().
+   * @param[in] PINS number of pins in sequence.
+   * @param[in] WINDOW number of samples per window.
+   */
+  template<uint8_t PINS, uint16_t WINDOW>
+  class Statistics : public Reducer {
+  public:
+    /**
+     * Construct statistics reducer with given next reducer.
+     * @param[in] next reducer (default none).
+     */
+    Statistics(Reducer* next = NULL) : Reducer(next)
+    {
+      for (uint8_t ix = 0; ix < PINS; ix++) {
+	m_sum[ix] = 0;
+	m_count[ix] = 0;
+	m_low[ix] = 0xffff;
+	m_high[ix] = 0;
+	m_min[ix] = 0;
+	m_max[ix] = 0;
+      }
+    }
+
+    /**
+     * Return minimum value in latest window for given pin.
+     * @param[in] ix pin sequence index.
+     * @return minimum.
+     * @note atomic
+     */
+    uint16_t min(uint8_t ix) const
+    {
+      uint16_t res;
+      synchronized res = m_min[ix];
+      return (res);
+    }
+
+    /**
+     * Return maximum value in latest window for given pin.
+     * @param[in] ix pin sequence index.
+     * @return maximum.
+     * @note atomic
+     */
+    uint16_t max(uint8_t ix) const
+    {
+      uint16_t res;
+      synchronized res = m_max[ix];
+      return (res);
+    }
+
+    /**
+     * @override{AnalogSampler::Reducer}
+     * Update statistics and produce mean at end of window.
+     * @param[in] ix pin sequence index.
+     * @param[in,out] value sample.
+     * @return bool.
+     */
+    virtual bool reduce(uint8_t ix, uint16_t& value)
+    {
+      m_sum[ix] += value;
+      if (value < m_low[ix]) m_low[ix] = value;
+      if (value > m_high[ix]) m_high[ix] = value;
+      if (++m_count[ix] != WINDOW) return (false);
+      value = m_sum[ix] / WINDOW;
+      m_min[ix] = m_low[ix];
+      m_max[ix] = m_high[ix];
+      m_sum[ix] = 0;
+      m_count[ix] = 0;
+      m_low[ix] = 0xffff;
+      m_high[ix] = 0;
+      return (true);
+    }
+
+  protected:
+    uint32_t m_sum[PINS];	//!< Accumulated samples in window.
+    uint16_t m_count[PINS];	//!< Number of samples in window.
+    uint16_t m_low[PINS];	//!< Running minimum in window.
+    uint16_t m_high[PINS];	//!< Running maximum in window.
+    uint16_t m_min[PINS];	//!< Minimum of latest window.
+    uint16_t m_max[PINS];	//!< Maximum of latest window.
+  };
+
+  /**
+   * Fixed-point exponential moving average (first order IIR low pass
+   * filter); y += (x - y) / 2^SHIFT. The filter runs on every
+   * sample and the filtered value is produced every DECIMATE sample.
+   * @param[in] PINS number of pins in sequence.
+   * @param[in] SHIFT filter coefficient (alpha = 1 / 2^SHIFT).
+   * @param[in] DECIMATE output rate divider (default 1).
+   */
+  template<uint8_t PINS, uint8_t SHIFT, uint16_t DECIMATE = 1>
+  class Filter : public Reducer {
+  public:
+    /**
+     * Construct filter reducer with given next reducer.
+     * @param[in] next reducer (default none).
+     */
+    Filter(Reducer* next = NULL) : Reducer(next)
+    {
+      memset(m_acc, 0, sizeof(m_acc));
+      memset(m_count, 0, sizeof(m_count));
+    }
+
+    /**
+     * @override{AnalogSampler::Reducer}
+     * Filter sample and produce value every DECIMATE sample. The
+     * filter state is initiated with the first sample.
+     * @param[in] ix pin sequence index.
+     * @param[in,out] value sample.
+     * @return bool.
+     */
+    virtual bool reduce(uint8_t ix, uint16_t& value)
+    {
+      uint32_t acc = m_acc[ix];
+      if (UNLIKELY(acc == 0))
+	acc = ((uint32_t) value) << SHIFT;
+      else
+	acc = acc - (acc >> SHIFT) + value;
+      m_acc[ix] = acc;
+      if (++m_count[ix] != DECIMATE) return (false);
+      m_count[ix] = 0;
+      value = acc >> SHIFT;
+      return (true);
+    }
+
+  protected:
+    uint32_t m_acc[PINS];	//!< Filter state (scaled by 2^SHIFT).
+    uint16_t m_count[PINS];	//!< Decimation counter.
+  };
+
+  /**
+   * Set reducer pipeline. Samples are passed through the pipeline
+   * in the interrupt handler and only produced values are stored in
+   * the blocks. Should be set before begin().
+   * @param[in] reducer pipeline (NULL for raw samples).
+   */
+  void reducer(Reducer* reducer)
+  {
+    m_reducer = reducer;
+  }
+
+  /**
+   * Start continuous sampling with given sample rate (conversions
+   * per second). Return false(0) if the rate is out of range or the
+   * converter is already in use.
+   * @param[in] rate sample rate (Hz).
+   * @return bool.
+   */
+  bool begin(uint16_t rate);
+
+  /**
+   * Stop continuous sampling. Pending block events are still
+   * delivered.
+   */
+  void end();
+
+  /**
+   * Return number of dropped sample blocks.
+   * @return overruns.
+   * @note atomic
+   */
+  uint16_t overruns() const
+  {
+    uint16_t res;
+    synchronized res = m_overruns;
+    return (res);
+  }
+
+  /**
+   * @override{AnalogSampler}
+   * Process sample block. Called from the event handler when a
+   * block is completed. The samples are in pin sequence order.
+   * @param[in] block sample block.
+   * @param[in] count number of samples.
+   */
+  virtual void on_block(const uint16_t* block, uint16_t count)
+  {
+    UNUSED(block);
+    UNUSED(count);
+  }
+
+protected:
+  const Board::AnalogPin* m_pin_at; //!< Pin sequence (program memory).
+  const uint8_t m_count;	    //!< Number of pins in sequence.
+  uint16_t* m_buffer;		    //!< Sample blocks.
+  const uint16_t m_block;	    //!< Number of samples per block.
+  volatile uint16_t m_next;	    //!< Next sample index in buffer.
+  volatile uint8_t m_pin;	    //!< Pin sequence index.
+  volatile uint8_t m_busy;	    //!< Blocks being processed (bitset).
+  volatile uint16_t m_overruns;	    //!< Number of dropped blocks.
+  Reducer* m_reducer;		    //!< Sample reducer pipeline.
+
+  /**
+   * Select given pin in sequence as the next conversion channel.
+   * @param[in] ix pin sequence index.
+   */
+  void select(uint8_t ix);
+
+  /**
+   * @override{Interrupt::Handler}
+   * Interrupt service on conversion completion. Select next pin in
+   * sequence, reduce and store sample, and push event when a block
+   * is completed.
+   * @param[in] arg sample value.
+   */
+  virtual void on_interrupt(uint16_t arg);
+
+  /**
+   * @override{Event::Handler}
+   * Handle sample completed event; the event value is the block
+   * index. Calls on_block() and releases the block.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+};
+
+#endif
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file Cosa/Benchmark.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Benchmark.hh"
+
+#if !defined(BOARD_ATTINY)
+
+#include "Cosa/Power.hh"
+#include "Cosa/RTT.hh"
+
+Benchmark* Benchmark::s_first = NULL;
+Benchmark* Benchmark::s_last = NULL;
+
+// Empty benchmark case for measurement of the call overhead
+class Empty : public Benchmark {
+public:
+  Empty() : Benchmark(NULL) {}
+  virtual void run() {}
+};
+
+Benchmark::Benchmark(str_P name) :
+  m_next(NULL),
+  m_name(name)
+{
+  if (name == NULL) return;
+  if (s_last == NULL) s_first = this; else s_last->m_next = this;
+  s_last = this;
+}
+
+void
+Benchmark::evaluate(Probe::sample_t& sample,
+		    uint16_t iterations,
+		    uint8_t warmup)
+{
+  while (warmup--) run();
+  sample.count = 0;
+  sample.min = UINT16_MAX;
+  sample.max = 0;
+  sample.total = 0;
+  while (iterations--) {
+    uint16_t start = Probe::cycles();
+    run();
+    uint16_t cycles = Probe::cycles() - start;
+    sample.count += 1;
+    if (cycles < sample.min) sample.min = cycles;
+    if (cycles > sample.max) sample.max = cycles;
+    sample.total += cycles;
+  }
+}
+
+void
+Benchmark::run_all(IOStream& outs, uint16_t iterations, uint8_t warmup)
+{
+  // Start the cycle counter if needed and measure the call overhead
+  if ((TCCR1B & (_BV(CS12) | _BV(CS11) | _BV(CS10))) != _BV(CS10))
+    Probe::begin();
+  Empty empty;
+  Probe::sample_t sample;
+  empty.evaluate(sample, 16, 1);
+  uint16_t overhead = sample.min;
+
+  // Run cases in definition order and print results
+  outs << PSTR("benchmark,iterations,min,max,mean,ns") << endl;
+  for (Benchmark* bench = s_first; bench != NULL; bench = bench->m_next) {
+    bench->evaluate(sample, iterations, warmup);
+    uint32_t mean = (sample.count == 0) ? 0 : sample.total / sample.count;
+    uint16_t min = sample.min > overhead ? sample.min - overhead : 0;
+    uint16_t max = sample.max > overhead ? sample.max - overhead : 0;
+    mean = mean > overhead ? mean - overhead : 0;
+    outs << bench->m_name << ','
+	 << sample.count << ','
+	 << min << ','
+	 << max << ','
+	 << mean << ','
+	 << (mean * 1000L) / (F_CPU / 1000000L)
+	 << endl;
+  }
+  outs << PSTR("end") << endl;
+}
+
+void
+Benchmark::Throughput::start()
+{
+  m_start = RTT::micros();
+}
+
+void
+Benchmark::Throughput::stop()
+{
+  uint32_t us = RTT::micros() - m_start;
+  if (UNLIKELY(m_count == m_max)) return;
+  m_total += us;
+  m_buf[m_count++] = (us > UINT16_MAX) ? UINT16_MAX : us;
+}
+
+uint16_t
+Benchmark::Throughput::percentile(uint8_t percent)
+{
+  if (UNLIKELY(m_count == 0)) return (0);
+
+  // Insertion sort; small number of mostly equal samples
+  for (uint8_t i = 1; i < m_count; i++) {
+    uint16_t v = m_buf[i];
+    uint8_t j = i;
+    for (; j > 0 && m_buf[j - 1] > v; j--) m_buf[j] = m_buf[j - 1];
+    m_buf[j] = v;
+  }
+  uint8_t ix = ((uint16_t) percent * (m_count - 1) + 50) / 100;
+  return (m_buf[ix]);
+}
+
+void
+Benchmark::Throughput::header(IOStream& outs)
+{
+  outs << PSTR("io,bytes,ops,kbps,p50,p90,p99,max") << endl;
+}
+
+void
+Benchmark::Throughput::print(IOStream& outs, str_P name, size_t bytes)
+{
+  // Throughput in KB/s; 1000000/1024 is 15625/16
+  uint32_t kbps = 0;
+  if (m_total != 0)
+    kbps = ((uint32_t) bytes * m_count * 15625UL) / (m_total * 16);
+  outs << name << ','
+       << bytes << ','
+       << m_count << ','
+       << kbps << ','
+       << percentile(50) << ','
+       << percentile(90) << ','
+       << percentile(99) << ','
+       << percentile(100)
+       << endl;
+  reset();
+}
+
+#endif
@@ -0,0 +1,278 @@
+/**
+ * @file Cosa/Benchmark.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_BENCHMARK_HH
+#define COSA_BENCHMARK_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Probe.hh"
+#include "Cosa/IOStream.hh"
+
+#if !defined(BOARD_ATTINY)
+
+/**
+ * Benchmark case with cycle accurate timing. Cases are defined with
+ * the BENCHMARK() macro and run in definition order with run_all().
+ * Each case is run a number of warmup iterations and then measured
+ * per iteration with the Probe cycle counter (Timer1, prescale 1);
+ * the call overhead is subtracted. The results are written in a
+ * stable CSV format for the host script (build/benchmark.py):
+ * @code
+ * benchmark,iterations,min,max,mean,ns
+ * OutputPin::toggle,1000,12,12,12,750
+ * ...
+ * end
+ * @endcode
+ * The min, max and mean columns are processor cycles and ns is the
+ * mean in nano-seconds.
+ * @code
+ * OutputPin led(Board::LED);
+ * BENCHMARK(led_toggle, "OutputPin::toggle")
+ * {
+ *   led.toggle();
+ * }
+ * ...
+ * Benchmark::run_all(trace);
+ * @endcode
+ * @section Limitations
+ * Uses Timer1 (as Probe). Max measured iteration time is 65535
+ * cycles (4 ms at 16 MHz); longer iterations should be split. The
+ * iterations are run with interrupts enabled; measurements may
+ * include interrupt service time (see max column).
+ */
+class Benchmark {
+public:
+  /** Default number of measured iterations. */
+  static const uint16_t ITERATIONS = 1000;
+
+  /** Default number of warmup iterations. */
+  static const uint8_t WARMUP = 8;
+
+  /**
+   * Construct named benchmark case and append to the list of cases.
+   * Should be defined with the BENCHMARK() macro.
+   * @param[in] name of benchmark (program memory).
+   */
+  Benchmark(str_P name);
+
+  /**
+   * Return benchmark name (program memory).
+   * @return name.
+   */
+  str_P name() const
+  {
+    return (m_name);
+  }
+
+  /**
+   * Return next benchmark case in list, or NULL at end of list.
+   * @return benchmark.
+   */
+  Benchmark* next() const
+  {
+    return (m_next);
+  }
+
+  /**
+   * Return first benchmark case, or NULL if none.
+   * @return benchmark.
+   */
+  static Benchmark* first()
+  {
+    return (s_first);
+  }
+
+  /**
+   * @override{Benchmark}
+   * Measure the benchmark case with the given number of warmup and
+   * measured iterations. The result is returned in the given probe
+   * sample. Override for cases that require setup (e.g. filling a
+   * queue) or that measure other than the iteration time (e.g.
+   * jitter); the sample should be in processor cycles.
+   * @param[out] sample cycle statistics.
+   * @param[in] iterations number of measured iterations.
+   * @param[in] warmup number of warmup iterations.
+   */
+  virtual void evaluate(Probe::sample_t& sample,
+			uint16_t iterations = ITERATIONS,
+			uint8_t warmup = WARMUP);
+
+  /**
+   * Run all benchmark cases and write the results in CSV format to
+   * the given output stream; header line, one line per case and the
+   * end line. Starts the cycle counter (Probe::begin()) if needed.
+   * @param[in] outs output stream.
+   * @param[in] iterations number of measured iterations.
+   * @param[in] warmup number of warmup iterations.
+   */
+  static void run_all(IOStream& outs,
+		      uint16_t iterations = ITERATIONS,
+		      uint8_t warmup = WARMUP);
+
+  /**
+   * @override{Benchmark}
+   * The benchmark case body; one iteration. Defined by the
+   * BENCHMARK() macro.
+   */
+  virtual void run() = 0;
+
+  /**
+   * I/O operation latency and throughput recorder. The time of each
+   * operation is measured in micro-seconds with RTT::micros() and
+   * stored in the given sample buffer. The results are written in
+   * CSV format; bytes per operation, number of operations,
+   * throughput (KB/s) and latency percentiles 50, 90 and 99, and
+   * max (us):
+   * @code
+   * io,bytes,ops,kbps,p50,p90,p99,max
+   * SD::read,512,64,231,2210,2216,2240,2240
+   * @endcode
+   * @code
+   * uint16_t samples[64];
+   * Benchmark::Throughput io(samples, membersof(samples));
+   * ...
+   * Benchmark::Throughput::header(trace);
+   * for (uint8_t i = 0; i < membersof(samples); i++) {
+   *   io.start();
+   *   sd.read(i, buf);
+   *   io.stop();
+   * }
+   * io.print(trace, PSTR("SD::read"), 512);
+   * @endcode
+   * @section Limitations
+   * Requires RTT. Operations longer than 65535 us are saturated.
+   * The samples are sorted by print(). The total number of bytes
+   * (bytes per operation times operations) should be less than
+   * 256 Kbyte.
+   */
+  class Throughput {
+  public:
+    /**
+     * Construct recorder with given sample buffer.
+     * @param[in] buf sample buffer.
+     * @param[in] max number of samples in buffer.
+     */
+    Throughput(uint16_t* buf, uint8_t max) :
+      m_buf(buf),
+      m_max(max),
+      m_count(0),
+      m_total(0),
+      m_start(0)
+    {}
+
+    /**
+     * Reset recorded samples.
+     */
+    void reset()
+    {
+      m_count = 0;
+      m_total = 0;
+    }
+
+    /**
+     * Return number of recorded samples.
+     * @return count.
+     */
+    uint8_t count() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * Return true(1) if the sample buffer is full otherwise false(0).
+     * @return bool.
+     */
+    bool is_full() const
+    {
+      return (m_count == m_max);
+    }
+
+    /**
+     * Start operation measurement.
+     */
+    void start();
+
+    /**
+     * Stop operation measurement and record sample. Ignored when the
+     * sample buffer is full.
+     */
+    void stop();
+
+    /**
+     * Return latency percentile of recorded samples. The samples are
+     * sorted.
+     * @param[in] percent (0..100).
+     * @return micro-seconds.
+     */
+    uint16_t percentile(uint8_t percent);
+
+    /**
+     * Print CSV header line to given output stream.
+     * @param[in] outs output stream.
+     */
+    static void header(IOStream& outs);
+
+    /**
+     * Print results as CSV line to given output stream and reset
+     * recorder.
+     * @param[in] outs output stream.
+     * @param[in] name of operation (program memory).
+     * @param[in] bytes per operation.
+     */
+    void print(IOStream& outs, str_P name, size_t bytes);
+
+  protected:
+    uint16_t* m_buf;		//!< Sample buffer.
+    const uint8_t m_max;	//!< Max number of samples.
+    uint8_t m_count;		//!< Number of samples.
+    uint32_t m_total;		//!< Total time (us).
+    uint32_t m_start;		//!< Operation start time (us).
+  };
+
+protected:
+  /** First and last benchmark case. */
+  static Benchmark* s_first;
+  static Benchmark* s_last;
+
+  /** Next benchmark case in list. */
+  Benchmark* m_next;
+
+  /** Benchmark name (program memory). */
+  str_P m_name;
+};
+
+/**
+ * Support macro to define a benchmark case. Should be used at file
+ * scope and followed by the case body (one iteration).
+ * @param[in] var benchmark variable name.
+ * @param[in] name benchmark name string (CSV column; no commas).
+ */
+#define BENCHMARK(var,name)					\
+  const char var ## _name[] __PROGMEM = name;			\
+  class var ## _t : public Benchmark {				\
+  public:							\
+    var ## _t() : Benchmark((str_P) var ## _name) {}		\
+    virtual void run();						\
+  };								\
+  var ## _t var;						\
+  void var ## _t::run()
+
+#endif
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file Cosa/BitSet.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/BitSet.hh"
+
+const uint8_t BitSetBase::COUNT_TAB[] __PROGMEM = {
+  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+};
+
+uint16_t
+BitSetBase::count(const uint8_t* set, size_t size)
+{
+  uint16_t res = 0;
+  while (size--) {
+    uint8_t bits = *set++;
+    if (bits == 0) continue;
+    res += pgm_read_byte(&COUNT_TAB[bits & 0x0f]);
+    res += pgm_read_byte(&COUNT_TAB[bits >> 4]);
+  }
+  return (res);
+}
+
+int16_t
+BitSetBase::next(const uint8_t* set, size_t size, uint16_t ix)
+{
+  uint16_t i = ix / CHARBITS;
+  if (UNLIKELY(i >= size)) return (-1);
+
+  // Mask off the bits before the start index in the first byte
+  uint8_t bits = set[i] & (0xff << (ix & (CHARBITS - 1)));
+
+  // Skip zero bytes
+  while (bits == 0) {
+    if (++i == size) return (-1);
+    bits = set[i];
+  }
+
+  // Locate the lowest set bit in the byte
+  int16_t res = i * CHARBITS;
+  if ((bits & 0x0f) == 0) { bits >>= 4; res += 4; }
+  if ((bits & 0x03) == 0) { bits >>= 2; res += 2; }
+  if ((bits & 0x01) == 0) res += 1;
+  return (res);
+}
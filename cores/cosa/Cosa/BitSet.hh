@@ -24,13 +24,44 @@
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
 
+/**
+ * Common bit vector operations for BitSet. Kept out of the template
+ * so that all bitset sizes share a single copy of the code and the
+ * lookup table.
+ */
+class BitSetBase {
+protected:
+  /**
+   * Return number of set bits in the given bit vector. Counts a
+   * nibble at a time with a table in program memory.
+   * @param[in] set bit vector.
+   * @param[in] size number of bytes in bit vector.
+   * @return number of set bits.
+   */
+  static uint16_t count(const uint8_t* set, size_t size);
+
+  /**
+   * Return index of the first set bit at or after the given index, or
+   * negative error code(-1) if none. Zero bytes are skipped without
+   * testing the individual bits.
+   * @param[in] set bit vector.
+   * @param[in] size number of bytes in bit vector.
+   * @param[in] ix start index.
+   * @return bit index or negative error code.
+   */
+  static int16_t next(const uint8_t* set, size_t size, uint16_t ix);
+
+  /** Number of set bits per nibble. */
+  static const uint8_t COUNT_TAB[] PROGMEM;
+};
+
 /**
  * Bitset implemented as a template class with a byte vector for the
  * elements as bits.
  * @param[in] N max number of elements in bitset.
  */
 template<uint16_t N>
-class BitSet {
+class BitSet : private BitSetBase {
 public:
   /**
    * Construct bitset and empty.
@@ -77,6 +108,38 @@ public:
     return (true);
   }
 
+  /**
+   * Return number of elements in the bitset.
+   * @return number of members.
+   */
+  uint16_t count() const
+  {
+    return (BitSetBase::count(m_set, sizeof(m_set)));
+  }
+
+  /**
+   * Return first element in the bitset, or negative error code(-1) if
+   * empty.
+   * @return element index or negative error code.
+   */
+  int16_t first() const
+  {
+    return (BitSetBase::next(m_set, sizeof(m_set), 0));
+  }
+
+  /**
+   * Return next element in the bitset at or after the given index, or
+   * negative error code(-1) if there are no more elements. Iterate
+   * with: for (int16_t i = s.first(); i >= 0; i = s.next(i + 1)) ...
+   * @param[in] ix start index.
+   * @return element index or negative error code.
+   */
+  int16_t next(uint16_t ix) const
+  {
+    if (UNLIKELY(ix >= N)) return (-1);
+    return (BitSetBase::next(m_set, sizeof(m_set), ix));
+  }
+
   /**
    * Check if the given element index is a member of the bitset.
    * @return bool
@@ -137,6 +200,30 @@ public:
       m_set[i] &= ~rhs.m_set[i];
   }
 
+  /**
+   * Union with the given bitset in place.
+   * @param[in] rhs bitset to add.
+   */
+  void operator|=(const BitSet& rhs)
+  {
+    const uint8_t* sp = rhs.m_set;
+    uint8_t* dp = m_set;
+    for (size_t n = sizeof(m_set); n != 0; n--)
+      *dp++ |= *sp++;
+  }
+
+  /**
+   * Intersection with the given bitset in place.
+   * @param[in] rhs bitset to intersect with.
+   */
+  void operator&=(const BitSet& rhs)
+  {
+    const uint8_t* sp = rhs.m_set;
+    uint8_t* dp = m_set;
+    for (size_t n = sizeof(m_set); n != 0; n--)
+      *dp++ &= *sp++;
+  }
+
   /**
    * Check if the bitsets are equal. Return false if they are not of same
    * size.
@@ -166,7 +253,7 @@ private:
   static const uint8_t MASK = (CHARBITS - 1);
 
   /** Bitset size in bytes. */
-  static const size_t SET_MAX = (N + (CHARBITS/2)) / CHARBITS;
+  static const size_t SET_MAX = (N + (CHARBITS - 1)) / CHARBITS;
 
   /** Bitset storage. */
   uint8_t m_set[SET_MAX];
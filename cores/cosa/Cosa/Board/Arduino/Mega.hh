@@ -119,6 +119,24 @@ public:
    */
   static void init() {}
 
+#if defined(COSA_XMEM)
+  /** External memory (XMEM) address range. */
+  static const uint16_t XMEM_START = 0x2200;
+  static const uint16_t XMEM_END = 0xffff;
+
+  /**
+   * Enable the external memory interface; full address range (port
+   * C as high address), no wait states. Called from the start-up
+   * code before the data and bss sections are initiated.
+   */
+  static void xmem_init()
+    __attribute__((always_inline))
+  {
+    XMCRB = 0;
+    XMCRA = _BV(SRE);
+  }
+#endif
+
   /**
    * Digital pin symbols; mapping from name to port<5>:bit<3>.
    */
@@ -337,6 +355,7 @@ public:
 extern "C" {
   void ADC_vect(void) __attribute__ ((signal));
   void ANALOG_COMP_vect(void) __attribute__ ((signal));
+  void EE_READY_vect(void) __attribute__ ((signal));
   void INT0_vect(void) __attribute__ ((signal));
   void INT1_vect(void) __attribute__ ((signal));
   void INT2_vect(void) __attribute__ ((signal));
@@ -0,0 +1,63 @@
+/**
+ * @file Cosa/Boot.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Boot.hh"
+#include "Cosa/RTT.hh"
+
+void
+Boot::Deferred::run()
+{
+  m_ready = on_begin();
+#if defined(COSA_BOOT_PROFILE)
+  Boot::stage(m_name);
+#endif
+  if (m_target == NULL) return;
+  uint8_t type = m_ready ? Event::BEGIN_TYPE : Event::ERROR_TYPE;
+  Event::push(type, m_target, this);
+}
+
+#if defined(COSA_BOOT_PROFILE)
+Boot::stage_t Boot::s_stage[STAGE_MAX];
+uint8_t Boot::s_count = 0;
+
+void
+Boot::stage(str_P name)
+{
+  uint32_t now = RTT::micros();
+  if (UNLIKELY(s_count == STAGE_MAX)) return;
+  s_stage[s_count].name = name;
+  s_stage[s_count].us = now;
+  s_count += 1;
+}
+
+void
+Boot::print(IOStream& outs)
+{
+  uint32_t prev = 0UL;
+  for (uint8_t ix = 0; ix < s_count; ix++) {
+    stage_t& entry = s_stage[ix];
+    outs << entry.name
+	 << PSTR(":us=") << entry.us
+	 << PSTR(",delta=") << entry.us - prev
+	 << endl;
+    prev = entry.us;
+  }
+}
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @file Cosa/Boot.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_BOOT_HH
+#define COSA_BOOT_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Event.hh"
+#include "Cosa/Job.hh"
+#include "Cosa/IOStream.hh"
+
+#if defined(COSA_BOOT_PROFILE)
+# if (COSA_BOOT_PROFILE + 0) == 0
+#   undef COSA_BOOT_PROFILE
+#   define COSA_BOOT_PROFILE 8
+# endif
+#endif
+
+/**
+ * Boot time profile and deferred driver initialization.
+ *
+ * @section Profile
+ * When COSA_BOOT_PROFILE is defined the time (RTT::micros()) of each
+ * boot stage is recorded; reset, board (after Board::init()), init
+ * (before setup()), setup (after setup()) and the completion of each
+ * deferred begin. The real-time clock is started by init() so that
+ * all stages have a time stamp; RTT::begin() in setup() will return
+ * false(0). Additional stages are marked with BOOT_STAGE(). Use
+ * Boot::print() to print the profile.
+ *
+ * @section Deferred
+ * Slow driver initialization (e.g. SD card, DHCP, file system mount)
+ * may be run as jobs after setup() so that time-critical functions
+ * come up first. The deferred begin is run by the event service
+ * (one per event dispatch) and signals readiness with a BEGIN_TYPE
+ * event (ERROR_TYPE on failure) to the given target. The event value
+ * is the deferred begin instance.
+ * @code
+ * Watchdog::Scheduler scheduler;
+ * SD sd;
+ * const char sd_name[] __PROGMEM = "sd";
+ * Boot::Begin<SD> sd_begin(&scheduler, &sd, (str_P) sd_name, &app);
+ * ...
+ * void setup()
+ * {
+ *   Watchdog::begin();
+ *   ...
+ *   sd_begin.expire_at(scheduler.time() + 100);
+ *   sd_begin.start();
+ * }
+ * @endcode
+ */
+class Boot {
+public:
+  /**
+   * Deferred begin; run as a job and signal the result to the target
+   * event handler. Sub-class should define on_begin().
+   */
+  class Deferred : public Job {
+  public:
+    /**
+     * Construct deferred begin with given scheduler, name (program
+     * memory) and target for ready event.
+     * @param[in] scheduler for the job.
+     * @param[in] name of boot stage (program memory).
+     * @param[in] target for ready event (default none).
+     */
+    Deferred(Job::Scheduler* scheduler, str_P name,
+	     Event::Handler* target = NULL) :
+      Job(scheduler),
+      m_name(name),
+      m_target(target),
+      m_ready(false)
+    {}
+
+    /**
+     * Return true(1) if the begin has been run and was successful
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_ready() const
+    {
+      return (m_ready);
+    }
+
+    /**
+     * Return name of boot stage (program memory).
+     * @return name.
+     */
+    str_P name() const
+    {
+      return (m_name);
+    }
+
+    /**
+     * @override{Boot::Deferred}
+     * Run the slow initialization. Return true(1) if successful
+     * otherwise false(0).
+     * @return bool.
+     */
+    virtual bool on_begin() = 0;
+
+    /**
+     * @override{Job}
+     * Run the initialization, record the boot stage and push the
+     * ready event (BEGIN_TYPE or ERROR_TYPE) to the target.
+     */
+    virtual void run();
+
+  protected:
+    str_P m_name;		//!< Boot stage name.
+    Event::Handler* m_target;	//!< Target for ready event.
+    bool m_ready;		//!< Ready flag.
+  };
+
+  /**
+   * Deferred begin for drivers with a bool begin() member function.
+   * @param[in] T driver class.
+   */
+  template<class T>
+  class Begin : public Deferred {
+  public:
+    /**
+     * Construct deferred begin of given driver.
+     * @param[in] scheduler for the job.
+     * @param[in] driver to begin.
+     * @param[in] name of boot stage (program memory).
+     * @param[in] target for ready event (default none).
+     */
+    Begin(Job::Scheduler* scheduler, T* driver, str_P name,
+	  Event::Handler* target = NULL) :
+      Deferred(scheduler, name, target),
+      m_driver(driver)
+    {}
+
+    /**
+     * @override{Boot::Deferred}
+     * Call the driver begin().
+     * @return bool.
+     */
+    virtual bool on_begin()
+    {
+      return (m_driver->begin());
+    }
+
+  protected:
+    T* m_driver;		//!< Driver to begin.
+  };
+
+#if defined(COSA_BOOT_PROFILE)
+  /** Max number of boot stages in profile. */
+  static const uint8_t STAGE_MAX = COSA_BOOT_PROFILE;
+
+  /**
+   * Boot stage profile entry; name (program memory) and time in
+   * micro-seconds from reset.
+   */
+  struct stage_t {
+    str_P name;			//!< Stage name.
+    uint32_t us;		//!< Time stamp.
+  };
+
+  /**
+   * Record time stamp for given boot stage name (program memory).
+   * Stages after STAGE_MAX are ignored.
+   * @param[in] name of boot stage (program memory).
+   */
+  static void stage(str_P name);
+
+  /**
+   * Return number of recorded boot stages.
+   * @return count.
+   */
+  static uint8_t stages()
+  {
+    return (s_count);
+  }
+
+  /**
+   * Return boot stage profile entry with given index.
+   * @param[in] ix index (0..stages()-1).
+   * @return profile entry.
+   */
+  static const stage_t& entry(uint8_t ix)
+  {
+    return (s_stage[ix]);
+  }
+
+  /**
+   * Print boot profile to given output stream; name, time stamp and
+   * time since previous stage in micro-seconds.
+   * @param[in] outs output stream.
+   */
+  static void print(IOStream& outs);
+
+private:
+  /** Boot stage profile. */
+  static stage_t s_stage[STAGE_MAX];
+
+  /** Number of recorded stages. */
+  static uint8_t s_count;
+#endif
+};
+
+/**
+ * Support macro to record a boot stage with the given name when
+ * COSA_BOOT_PROFILE is defined otherwise expands to nothing.
+ * @param[in] name boot stage name string.
+ */
+#if defined(COSA_BOOT_PROFILE)
+#define BOOT_STAGE(name) Boot::stage((str_P) PSTR(name))
+#else
+#define BOOT_STAGE(name)
+#endif
+
+#endif
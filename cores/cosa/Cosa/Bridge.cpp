@@ -0,0 +1,41 @@
+/**
+ * @file Cosa/Bridge.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Bridge.hh"
+
+void
+Bridge::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (UNLIKELY((type != Event::RECEIVE_REQUEST_TYPE)
+	       && (type != Event::RECEIVE_COMPLETED_TYPE)))
+    return;
+
+  // Move the available data and signal the destination
+  size_t count;
+  bool pending = move(count);
+  if (count != 0) {
+    m_count += count;
+    on_transfer(count);
+  }
+
+  // Continue after other events when the destination is full
+  if (pending) Event::push(Event::RECEIVE_REQUEST_TYPE, this);
+}
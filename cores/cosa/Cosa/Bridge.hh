@@ -0,0 +1,207 @@
+/**
+ * @file Cosa/Bridge.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_BRIDGE_HH
+#define COSA_BRIDGE_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Event.hh"
+#include "Cosa/IOStream.hh"
+#include "Cosa/IOBuffer.hh"
+
+/**
+ * Event driven data bridge between a ring-buffer (IOBuffer) and an
+ * IOStream device (e.g. UART or Socket). Data is moved in contiguous
+ * spans directly between the ring-buffer storage and the device;
+ * without per character calls or intermediate buffers. The bridge
+ * is triggered by receive events (UART::notify() or socket event
+ * handler) and limits each span to the room in the destination (flow
+ * control). When the data could not be moved completely the bridge
+ * pushes a new event to itself and continues after other events
+ * have been dispatched.
+ * @code
+ * static IOBuffer<64> ibuf1;
+ * static IOBuffer<64> obuf1;
+ * UART uart1(1, &ibuf1, &obuf1);
+ * ...
+ * Bridge::Drain<64> bridge(&ibuf1, &uart2);
+ * uart1.notify(&bridge);
+ * @endcode
+ */
+class Bridge : public Event::Handler {
+public:
+  /**
+   * Ring-buffer to device bridge. Drains the ring-buffer (e.g. UART
+   * input buffer) into the destination device with block writes of
+   * the available spans.
+   * @param[in] SIZE number of bytes in ring-buffer.
+   */
+  template<uint16_t SIZE>
+  class Drain;
+
+  /**
+   * Device to ring-buffer bridge. Fills the ring-buffer (e.g. UART
+   * output buffer) from the source device with block reads into the
+   * reserved spans.
+   * @param[in] SIZE number of bytes in ring-buffer.
+   */
+  template<uint16_t SIZE>
+  class Fill;
+
+  /**
+   * Return total number of bytes moved by the bridge.
+   * @return bytes.
+   */
+  uint32_t count() const
+  {
+    return (m_count);
+  }
+
+  /**
+   * @override{Event::Handler}
+   * Move data on receive event (RECEIVE_REQUEST_TYPE or
+   * RECEIVE_COMPLETED_TYPE). Calls on_transfer() when data was moved
+   * and pushes a receive request event to itself while there is
+   * pending data.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+
+  /**
+   * @override{Bridge}
+   * Application extension; Called after data has been moved to the
+   * destination. May be used to send socket data (W5100::commit())
+   * or start UART transmission (UART::transmit()). Default void.
+   * @param[in] count number of bytes moved.
+   */
+  virtual void on_transfer(size_t count)
+  {
+    UNUSED(count);
+  }
+
+protected:
+  /** Total number of bytes moved. */
+  uint32_t m_count;
+
+  /**
+   * Construct bridge.
+   */
+  Bridge() :
+    Event::Handler(),
+    m_count(0UL)
+  {}
+
+  /**
+   * @override{Bridge}
+   * Move available data in spans. Return true(1) if data is pending
+   * (destination full) otherwise false(0). Number of bytes moved is
+   * returned in the given reference.
+   * @param[out] count number of bytes moved.
+   * @return bool.
+   */
+  virtual bool move(size_t& count) = 0;
+};
+
+template<uint16_t SIZE>
+class Bridge::Drain : public Bridge {
+public:
+  /**
+   * Construct bridge from given ring-buffer to given device.
+   * @param[in] src ring-buffer.
+   * @param[in] dest device.
+   */
+  Drain(IOBuffer<SIZE>* src, IOStream::Device* dest) :
+    Bridge(),
+    m_src(src),
+    m_dest(dest)
+  {}
+
+protected:
+  IOBuffer<SIZE>* m_src;	//!< Source ring-buffer.
+  IOStream::Device* m_dest;	//!< Destination device.
+
+  /**
+   * @override{Bridge}
+   * Write the available spans to the destination device; limited
+   * by the room in the device.
+   * @param[out] count number of bytes moved.
+   * @return bool.
+   */
+  virtual bool move(size_t& count)
+  {
+    const char* bp;
+    size_t n;
+    count = 0;
+    while ((n = m_src->span(bp)) != 0) {
+      int room = m_dest->room();
+      if (room <= 0) return (true);
+      if (n > (size_t) room) n = room;
+      int res = m_dest->write(bp, n);
+      if (res <= 0) return (true);
+      m_src->consume(res);
+      count += res;
+    }
+    return (false);
+  }
+};
+
+template<uint16_t SIZE>
+class Bridge::Fill : public Bridge {
+public:
+  /**
+   * Construct bridge from given device to given ring-buffer.
+   * @param[in] src device.
+   * @param[in] dest ring-buffer.
+   */
+  Fill(IOStream::Device* src, IOBuffer<SIZE>* dest) :
+    Bridge(),
+    m_src(src),
+    m_dest(dest)
+  {}
+
+protected:
+  IOStream::Device* m_src;	//!< Source device.
+  IOBuffer<SIZE>* m_dest;	//!< Destination ring-buffer.
+
+  /**
+   * @override{Bridge}
+   * Read from the source device into the reserved spans; limited
+   * by the available data in the device.
+   * @param[out] count number of bytes moved.
+   * @return bool.
+   */
+  virtual bool move(size_t& count)
+  {
+    char* bp;
+    size_t n;
+    count = 0;
+    while ((n = m_dest->reserve(bp)) != 0) {
+      int res = m_src->read(bp, n);
+      if (res <= 0) return (false);
+      m_dest->commit(res);
+      count += res;
+      if ((size_t) res < n) return (false);
+    }
+    return (true);
+  }
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file Cosa/ButtonBank.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_BUTTON_BANK_HH
+#define COSA_BUTTON_BANK_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Pin.hh"
+#include "Cosa/Button.hh"
+#include "Cosa/Periodic.hh"
+
+/**
+ * Debounced bank of buttons sampled by a single periodic job. Each
+ * AVR port with buttons is read once per sample and all buttons are
+ * debounced in parallel with 2-bit vertical counters (eight buttons
+ * per byte); a button changes state after four consecutive equal
+ * samples. The change handler, on_change(), is called once for each
+ * button change that matches the mode. Connect buttons from pin to
+ * ground; the internal pull-up resistors are activated.
+ * @code
+ * const Board::DigitalPin pins[] __PROGMEM = {
+ *   Board::D2, Board::D3, Board::D4, Board::D5
+ * };
+ * class Panel : public ButtonBank<4> {
+ * public:
+ *   Panel() : ButtonBank<4>(&scheduler, pins) {}
+ *   virtual void on_change(uint8_t type, uint8_t ix) { ... }
+ * };
+ * @endcode
+ * @param[in] N number of buttons.
+ * @param[in] PORTS max number of AVR ports (default 3).
+ *
+ * @section Limitations
+ * Button toggle faster than four sample periods (64 ms) is filtered.
+ */
+template<uint8_t N, uint8_t PORTS = 3>
+class ButtonBank : public Periodic {
+public:
+  /**
+   * Construct button bank with the given pins vector (in program
+   * memory) and change detection mode. The first pin is button
+   * index zero. The scheduler should allow periodic jobs with a time
+   * unit of milli-seconds (e.g. Watchdog::Scheduler).
+   * @param[in] scheduler for periodic job.
+   * @param[in] pins vector with N digital pins (program memory).
+   * @param[in] mode change detection mode (default ON_CHANGE_MODE).
+   */
+  ButtonBank(Job::Scheduler* scheduler,
+	     const Board::DigitalPin* pins,
+	     Button::Mode mode = Button::ON_CHANGE_MODE) :
+    Periodic(scheduler, SAMPLE_MS),
+    MODE(mode)
+  {
+    memset(m_port, 0, sizeof(m_port));
+    for (uint8_t ix = 0; ix < N; ix++) {
+      Board::DigitalPin pin = (Board::DigitalPin) pgm_read_byte(&pins[ix]);
+      volatile uint8_t* reg = Pin::PIN(pin);
+      uint8_t mask = Pin::MASK(pin);
+      uint8_t px = 0;
+      while (px < PORTS - 1 && m_port[px] != NULL && m_port[px] != reg)
+	px++;
+      m_port[px] = reg;
+      m_button[ix].port = px;
+      m_button[ix].mask = mask;
+      synchronized {
+	*Pin::DDR(pin) &= ~mask;
+	*Pin::PORT(pin) |= mask;
+      }
+    }
+    sample(m_state);
+    memset(m_ct0, 0xff, sizeof(m_ct0));
+    memset(m_ct1, 0xff, sizeof(m_ct1));
+  }
+
+  /**
+   * Return true(1) if the debounced state of the given button is set
+   * (released) otherwise false(0).
+   * @param[in] ix button index (0..N-1).
+   * @return bool.
+   */
+  bool is_set(uint8_t ix) const
+  {
+    if (UNLIKELY(ix >= N)) return (false);
+    return ((m_state[ix / CHARBITS] & _BV(ix & MASK)) != 0);
+  }
+
+  /**
+   * Return true(1) if the debounced state of the given button is
+   * clear (pressed) otherwise false(0).
+   * @param[in] ix button index (0..N-1).
+   * @return bool.
+   */
+  bool is_clear(uint8_t ix) const
+  {
+    return (ix < N && !is_set(ix));
+  }
+
+  /**
+   * @override{ButtonBank}
+   * The button change handler. Called for each button change
+   * corresponding to the mode. Event types are; Event::FALLING_TYPE
+   * and Event::RISING_TYPE.
+   * @param[in] type event type.
+   * @param[in] ix button index.
+   */
+  virtual void on_change(uint8_t type, uint8_t ix) = 0;
+
+protected:
+  /** Button sampling period in milli-seconds. */
+  static const uint16_t SAMPLE_MS = 16;
+
+  /** Mask bit address. */
+  static const uint8_t MASK = (CHARBITS - 1);
+
+  /** Size of button bit vectors in bytes. */
+  static const uint8_t BYTES = (N + CHARBITS - 1) / CHARBITS;
+
+  /** Button port index and pin mask. */
+  struct button_t {
+    uint8_t port;
+    uint8_t mask;
+  };
+
+  /** Change detection mode. */
+  const Button::Mode MODE;
+
+  /** Port input registers. */
+  volatile uint8_t* m_port[PORTS];
+
+  /** Button pins. */
+  button_t m_button[N];
+
+  /** Debounced state. */
+  uint8_t m_state[BYTES];
+
+  /** Vertical counters; low and high bit. */
+  uint8_t m_ct0[BYTES];
+  uint8_t m_ct1[BYTES];
+
+  /**
+   * Read all ports once and collect the button bit vector.
+   * @param[out] bits button bit vector.
+   */
+  void sample(uint8_t* bits)
+  {
+    uint8_t port[PORTS];
+    for (uint8_t px = 0; px < PORTS; px++)
+      port[px] = (m_port[px] != NULL) ? *m_port[px] : 0;
+    memset(bits, 0, BYTES);
+    for (uint8_t ix = 0; ix < N; ix++)
+      if (port[m_button[ix].port] & m_button[ix].mask)
+	bits[ix / CHARBITS] |= _BV(ix & MASK);
+  }
+
+  /**
+   * @override{Job}
+   * Button bank periodic function. Samples the buttons, steps the
+   * vertical counters and calls the change handler, on_change(), for
+   * each debounced change.
+   */
+  virtual void run()
+  {
+    uint8_t raw[BYTES];
+    sample(raw);
+    for (uint8_t i = 0; i < BYTES; i++) {
+      uint8_t delta = m_state[i] ^ raw[i];
+      m_ct0[i] = ~(m_ct0[i] & delta);
+      m_ct1[i] = m_ct0[i] ^ (m_ct1[i] & delta);
+      uint8_t changed = delta & m_ct0[i] & m_ct1[i];
+      if (changed == 0) continue;
+      m_state[i] ^= changed;
+      for (uint8_t bit = 0; changed != 0; bit++, changed >>= 1) {
+	if ((changed & 1) == 0) continue;
+	uint8_t state = (m_state[i] >> bit) & 1;
+	if ((MODE == Button::ON_CHANGE_MODE) || (state == MODE))
+	  on_change(Event::FALLING_TYPE + state, i * CHARBITS + bit);
+      }
+    }
+  }
+};
+
+#endif
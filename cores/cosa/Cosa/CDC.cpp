@@ -148,10 +148,14 @@ CDC::begin(uint32_t baudrate, uint8_t format)
 void
 CDC::accept()
 {
-  while (m_ibuf->room()) {
-    int c = USB_Recv(CDC_RX);
-    if (c == IOStream::EOF) break;
-    m_ibuf->putchar(c);
+  // Move received data to the input buffer in spans
+  uint8_t buf[16];
+  int n;
+  while ((n = m_ibuf->room()) > 0) {
+    if (n > (int) sizeof(buf)) n = sizeof(buf);
+    n = USB_Recv(CDC_RX, buf, n);
+    if (n <= 0) break;
+    m_ibuf->write(buf, n);
   }
 }
 
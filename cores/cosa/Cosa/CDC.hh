@@ -25,12 +25,17 @@
 #include "Cosa/Power.hh"
 #include "Cosa/IOStream.hh"
 
+// Default receiver buffer size
+#ifndef COSA_CDC_BUFFER_MAX
+# define COSA_CDC_BUFFER_MAX 64
+#endif
+
 #if defined(USBCON)
 
 class CDC : public IOStream::Device {
 public:
   /** Default buffer size. */
-  static const uint8_t BUFFER_MAX = 64;
+  static const uint16_t BUFFER_MAX = COSA_CDC_BUFFER_MAX;
 
   /**
    * Serial formats; DATA + PARITY + STOP. Note: this is to maintain
@@ -115,6 +120,22 @@ public:
     return (m_ibuf->getchar());
   }
 
+  /** Overloaded virtual member function read. */
+  using IOStream::Device::read;
+
+  /**
+   * @override{IOStream::Device}
+   * Read data to given buffer with given size from serial port input
+   * buffer. Returns number of bytes read (available).
+   * @param[in] buf buffer to read into.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes read.
+   */
+  virtual int read(void* buf, size_t size)
+  {
+    return (m_ibuf->read(buf, size));
+  }
+
   /**
    * @override{IOStream::Device}
    * Flush internal device buffers. Wait for device to become idle.
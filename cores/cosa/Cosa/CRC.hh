@@ -0,0 +1,289 @@
+/**
+ * @file Cosa/CRC.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_CRC_HH
+#define COSA_CRC_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * CRC table size; 4 for nibble tables (16 entries) or 8 for byte
+ * tables (256 entries). Nibble tables require less program memory
+ * but two table lookups per byte. Default is byte tables except for
+ * ATtiny.
+ */
+#ifndef COSA_CRC_TABLE
+# if defined(BOARD_ATTINY)
+#   define COSA_CRC_TABLE 4
+# else
+#   define COSA_CRC_TABLE 8
+# endif
+#endif
+
+/**
+ * Table driven CRC functions. The tables are stored in program
+ * memory and only the tables of the algorithms that are used are
+ * linked. Each algorithm has an incremental update function (one
+ * byte), a buffer function and an io vector function. The buffer and
+ * io vector functions continue from the given check sum so that they
+ * may be chained.
+ * @code
+ * uint16_t crc = CRC::crc16_xmodem(&header, sizeof(header));
+ * crc = CRC::crc16_xmodem(buf, size, crc);
+ * @endcode
+ * @section Limitations
+ * The check sums are not finalized (the final xor is left to the
+ * caller). Byte tables for all algorithms require 2.8 Kbyte of
+ * program memory.
+ */
+class CRC {
+public:
+  /**
+   * Update CRC7 (SD/MMC, x^7+x^3+1) with given data. The check sum
+   * is left aligned (bit 7..1).
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint8_t crc7_update(uint8_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return (pgm_read_byte(&CRC7_TAB[crc ^ data]));
+#else
+    crc ^= data;
+    crc = (crc << 4) ^ pgm_read_byte(&CRC7_TAB[crc >> 4]);
+    return ((crc << 4) ^ pgm_read_byte(&CRC7_TAB[crc >> 4]));
+#endif
+  }
+
+  /**
+   * Calculate CRC7 for given buffer and number of bytes. The check
+   * sum is left aligned (bit 7..1); or with one for the SD command
+   * end bit.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc7(const void* buf, size_t size, uint8_t crc = 0);
+
+  /**
+   * Calculate CRC7 for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc7(const iovec_t* vec, uint8_t crc = 0);
+
+  /**
+   * Update CRC8 (x^8+x^5+x^4+1, MSB first, Sensirion/Si70XX) with
+   * given data.
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint8_t crc8_update(uint8_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return (pgm_read_byte(&CRC8_TAB[crc ^ data]));
+#else
+    crc ^= data;
+    crc = (crc << 4) ^ pgm_read_byte(&CRC8_TAB[crc >> 4]);
+    return ((crc << 4) ^ pgm_read_byte(&CRC8_TAB[crc >> 4]));
+#endif
+  }
+
+  /**
+   * Calculate CRC8 for given buffer and number of bytes.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc8(const void* buf, size_t size, uint8_t crc = 0);
+
+  /**
+   * Calculate CRC8 for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc8(const iovec_t* vec, uint8_t crc = 0);
+
+  /**
+   * Update CRC8-Maxim (x^8+x^5+x^4+1, LSB first, Dallas/Maxim 1-Wire)
+   * with given data. Same as _crc_ibutton_update().
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint8_t crc8_maxim_update(uint8_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return (pgm_read_byte(&CRC8_MAXIM_TAB[crc ^ data]));
+#else
+    crc ^= data;
+    crc = (crc >> 4) ^ pgm_read_byte(&CRC8_MAXIM_TAB[crc & 0x0f]);
+    return ((crc >> 4) ^ pgm_read_byte(&CRC8_MAXIM_TAB[crc & 0x0f]));
+#endif
+  }
+
+  /**
+   * Calculate CRC8-Maxim for given buffer and number of bytes.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc8_maxim(const void* buf, size_t size, uint8_t crc = 0);
+
+  /**
+   * Calculate CRC8-Maxim for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint8_t crc8_maxim(const iovec_t* vec, uint8_t crc = 0);
+
+  /**
+   * Update CRC16-XMODEM (x^16+x^12+x^5+1, MSB first, SD data block)
+   * with given data. Same as _crc_xmodem_update().
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint16_t crc16_xmodem_update(uint16_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return ((crc << 8) ^ pgm_read_word(&CRC16_XMODEM_TAB[(crc >> 8) ^ data]));
+#else
+    crc = (crc << 4) ^
+      pgm_read_word(&CRC16_XMODEM_TAB[(crc >> 12) ^ (data >> 4)]);
+    return ((crc << 4) ^
+	    pgm_read_word(&CRC16_XMODEM_TAB[(crc >> 12) ^ (data & 0x0f)]));
+#endif
+  }
+
+  /**
+   * Calculate CRC16-XMODEM for given buffer and number of bytes.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint16_t crc16_xmodem(const void* buf, size_t size, uint16_t crc = 0);
+
+  /**
+   * Calculate CRC16-XMODEM for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default zero).
+   * @return check sum.
+   */
+  static uint16_t crc16_xmodem(const iovec_t* vec, uint16_t crc = 0);
+
+  /**
+   * Update CRC16-CCITT (x^16+x^12+x^5+1, LSB first, HDLC/VWI) with
+   * given data. Same as _crc_ccitt_update().
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint16_t crc16_ccitt_update(uint16_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return ((crc >> 8) ^ pgm_read_word(&CRC16_CCITT_TAB[(crc ^ data) & 0xff]));
+#else
+    crc = (crc >> 4) ^ pgm_read_word(&CRC16_CCITT_TAB[(crc ^ data) & 0x0f]);
+    return ((crc >> 4) ^
+	    pgm_read_word(&CRC16_CCITT_TAB[(crc ^ (data >> 4)) & 0x0f]));
+#endif
+  }
+
+  /**
+   * Calculate CRC16-CCITT for given buffer and number of bytes.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default 0xffff).
+   * @return check sum.
+   */
+  static uint16_t crc16_ccitt(const void* buf, size_t size,
+			      uint16_t crc = 0xffff);
+
+  /**
+   * Calculate CRC16-CCITT for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default 0xffff).
+   * @return check sum.
+   */
+  static uint16_t crc16_ccitt(const iovec_t* vec, uint16_t crc = 0xffff);
+
+  /**
+   * Update CRC32 (IEEE 802.3, LSB first) with given data.
+   * @param[in] crc check sum.
+   * @param[in] data to add.
+   * @return updated check sum.
+   */
+  static uint32_t crc32_update(uint32_t crc, uint8_t data)
+    __attribute__((always_inline))
+  {
+#if (COSA_CRC_TABLE == 8)
+    return ((crc >> 8) ^ pgm_read_dword(&CRC32_TAB[(crc ^ data) & 0xff]));
+#else
+    crc = (crc >> 4) ^ pgm_read_dword(&CRC32_TAB[(crc ^ data) & 0x0f]);
+    return ((crc >> 4) ^
+	    pgm_read_dword(&CRC32_TAB[(crc ^ (data >> 4)) & 0x0f]));
+#endif
+  }
+
+  /**
+   * Calculate CRC32 for given buffer and number of bytes. The IEEE
+   * 802.3 check sum is the complement of the returned value.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes.
+   * @param[in] crc initial check sum (default 0xffffffff).
+   * @return check sum.
+   */
+  static uint32_t crc32(const void* buf, size_t size,
+			uint32_t crc = 0xffffffffUL);
+
+  /**
+   * Calculate CRC32 for given null terminated io vector.
+   * @param[in] vec io vector.
+   * @param[in] crc initial check sum (default 0xffffffff).
+   * @return check sum.
+   */
+  static uint32_t crc32(const iovec_t* vec, uint32_t crc = 0xffffffffUL);
+
+protected:
+  /** Check sum tables in program memory (nibble or byte index). */
+  static const uint8_t CRC7_TAB[] PROGMEM;
+  static const uint8_t CRC8_TAB[] PROGMEM;
+  static const uint8_t CRC8_MAXIM_TAB[] PROGMEM;
+  static const uint16_t CRC16_XMODEM_TAB[] PROGMEM;
+  static const uint16_t CRC16_CCITT_TAB[] PROGMEM;
+  static const uint32_t CRC32_TAB[] PROGMEM;
+};
+
+#endif
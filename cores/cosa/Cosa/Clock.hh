@@ -69,6 +69,32 @@ public:
     }
   }
 
+  /**
+   * Set clock (seconds) and milli-seconds fraction.
+   * @param[in] sec seconds.
+   * @param[in] ms milli-seconds fraction (0..999).
+   * @note atomic
+   */
+  void time(uint32_t sec, uint16_t ms)
+  {
+    synchronized {
+      m_msec = ms;
+      m_sec = sec;
+    }
+  }
+
+  /**
+   * Return clock milli-seconds fraction.
+   * @return milli-seconds.
+   * @note atomic
+   */
+  uint16_t msec()
+  {
+    int16_t res;
+    synchronized res = m_msec;
+    return (res < 0 ? 0 : res);
+  }
+
   /**
    * Synchronize with clock by waiting for next clock update. Returns
    * clock time in seconds.
@@ -19,11 +19,23 @@
  */
 
 #include "Cosa/EEPROM.hh"
+#include "Cosa/Probe.hh"
+
+#if !defined(EEMPE)
+#define EEMPE EEMWE
+#define EEPE EEWE
+#endif
+
+uint16_t EEPROM::Device::s_dest = 0;
+const uint8_t* EEPROM::Device::s_src = NULL;
+volatile size_t EEPROM::Device::s_remaining = 0;
+size_t EEPROM::Device::s_size = 0;
+Event::Handler* EEPROM::Device::s_target = NULL;
 
 bool
 EEPROM::Device::is_ready()
 {
-  return (eeprom_is_ready());
+  return (bit_is_clear(EECR, EERIE) && eeprom_is_ready());
 }
 
 int
@@ -32,6 +44,7 @@ EEPROM::Device::read(void* dest, const void* src, size_t size)
   uint8_t* dp = (uint8_t*) dest;
   const uint8_t* sp = (const uint8_t*) src;
   size_t res = size;
+  while (bit_is_set(EECR, EERIE)) yield();
   while (size--) *dp++ = eeprom_read_byte(sp++);
   return (res);
 }
@@ -42,8 +55,55 @@ EEPROM::Device::write(void* dest, const void* src, size_t size)
   uint8_t* dp = (uint8_t*) dest;
   const uint8_t* sp = (const uint8_t*) src;
   size_t res = size;
-  while (size--) eeprom_write_byte(dp++, *sp++);
+  while (bit_is_set(EECR, EERIE)) yield();
+  while (size--) {
+    uint8_t data = *sp++;
+    if (eeprom_read_byte(dp) != data) eeprom_write_byte(dp, data);
+    dp++;
+  }
   return (res);
 }
 
+bool
+EEPROM::Device::write_request(void* dest, const void* src, size_t size,
+			      Event::Handler* target)
+{
+  if (UNLIKELY(size == 0)) return (false);
+  synchronized {
+    if (UNLIKELY(bit_is_set(EECR, EERIE))) return (false);
+    s_dest = (uint16_t) dest;
+    s_src = (const uint8_t*) src;
+    s_remaining = size;
+    s_size = size;
+    s_target = target;
+    EECR |= _BV(EERIE);
+  }
+  return (true);
+}
+
 EEPROM::Device EEPROM::Device::eeprom;
+
+ISR_PROBE_DEFINE(ee_ready_isr_probe, "isr:EE_READY");
+
+ISR(EE_READY_vect)
+{
+  ISR_PROBE(ee_ready_isr_probe);
+  // Skip unchanged bytes and start write of the next changed byte
+  while (EEPROM::Device::s_remaining != 0) {
+    uint8_t data = *EEPROM::Device::s_src++;
+    EEAR = EEPROM::Device::s_dest++;
+    EEPROM::Device::s_remaining -= 1;
+    EECR |= _BV(EERE);
+    if (EEDR == data) continue;
+    EEDR = data;
+    EECR |= _BV(EEMPE);
+    EECR |= _BV(EEPE);
+    return;
+  }
+
+  // All bytes written; disable interrupt and signal completion
+  EECR &= ~_BV(EERIE);
+  Event::push(Event::WRITE_COMPLETED_TYPE,
+	      EEPROM::Device::s_target,
+	      EEPROM::Device::s_size);
+}
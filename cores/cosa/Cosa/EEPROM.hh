@@ -23,12 +23,20 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Power.hh"
+#include "Cosa/Event.hh"
+#include <util/crc16.h>
+
+#if !defined(EE_READY_vect) && defined(EE_RDY_vect)
+#define EE_READY_vect EE_RDY_vect
+#endif
 
 /**
  * Driver for the ATmega/ATtiny internal EEPROM and abstraction of
  * EEPROM devices. See AT24CXX for an example of driver for external
  * EEPROM memory. The default device is the internal EEPROM. The class
- * EEPROM delegates to the EEPROM:Device class instance.
+ * EEPROM delegates to the EEPROM:Device class instance. Writes to
+ * the internal EEPROM skip unchanged bytes. See EEPROM::Ring for
+ * wear-leveled record storage.
  */
 class EEPROM {
 public:
@@ -69,12 +77,46 @@ public:
      */
     virtual int write(void* dest, const void* src, size_t size);
 
+    /**
+     * @override{EEPROM::Device}
+     * Start an asynchronous write of rom block at given address with
+     * the contents from the buffer. An Event::WRITE_COMPLETED_TYPE
+     * event with the number of bytes is pushed to the given target on
+     * completion. The buffer must be valid until completion; check
+     * with is_ready(). Default implementation is the internal EEPROM
+     * with the EEPROM ready interrupt; unchanged bytes are skipped.
+     * Return true(1) if the write was started otherwise false(0).
+     * @param[in] dest address in rom to write to.
+     * @param[in] src buffer to write to rom.
+     * @param[in] size number of bytes to write.
+     * @param[in] target event handler for completion (default NULL).
+     * @return bool.
+     */
+    virtual bool write_request(void* dest, const void* src, size_t size,
+			       Event::Handler* target = NULL);
+
     /**
      * Default EEPROM device; handling of internal EEPROM Data Memory.
      */
     static Device eeprom;
+
+  protected:
+    /** Internal EEPROM asynchronous write state. */
+    static uint16_t s_dest;
+    static const uint8_t* s_src;
+    static volatile size_t s_remaining;
+    static size_t s_size;
+    static Event::Handler* s_target;
+
+    /** Interrupt Service Routine. */
+    friend void EE_READY_vect(void);
   };
 
+  /**
+   * Wear-leveled ring record store.
+   */
+  template<class T> class Ring;
+
 public:
   /**
    * Construct access object for EEPROM given device. Default device
@@ -269,4 +311,182 @@ private:
   Device* m_dev;		//!< Delegated device.
 };
 
+/**
+ * Wear-leveled ring record store on an EEPROM device. The record is
+ * stored in a ring of sequence numbered slots with a check sum; each
+ * update is written to the next slot so that the writes are spread
+ * over the whole ring. The latest valid slot is found with begin()
+ * and a copy is kept in memory; writes of unchanged records are
+ * skipped and updates are written asynchronously with the device
+ * write_request(). A slot is written in one request; an interrupted
+ * update is detected by the check sum and the previous record is
+ * used.
+ * @code
+ * struct state_t { ... };
+ * uint8_t ring[32 * EEPROM::Ring<state_t>::SLOT_SIZE] EEMEM;
+ * EEPROM::Ring<state_t> store(&EEPROM::Device::eeprom, ring, 32);
+ * ...
+ * store.begin();
+ * store.read(state);
+ * ...
+ * store.write(state);
+ * @endcode
+ * @param[in] T record type.
+ */
+template<class T>
+class EEPROM::Ring {
+public:
+  /** Size of slot; sequence number, record and check sum. */
+  static const size_t SLOT_SIZE = sizeof(uint16_t) + sizeof(T) + 1;
+
+  /**
+   * Construct ring record store on given device, address and number
+   * of slots.
+   * @param[in] dev device.
+   * @param[in] base address of ring in rom.
+   * @param[in] slots number of slots in ring.
+   */
+  Ring(Device* dev, void* base, uint16_t slots) :
+    m_dev(dev),
+    m_base((uint8_t*) base),
+    m_slots(slots),
+    m_ix(slots - 1),
+    m_valid(false)
+  {
+    m_slot.seq = 0;
+  }
+
+  /**
+   * Scan the ring for the latest valid record. Return true(1) if
+   * found otherwise false(0); empty ring.
+   * @return bool.
+   */
+  bool begin()
+  {
+    slot_t slot;
+    m_valid = false;
+    m_ix = m_slots - 1;
+    m_slot.seq = 0;
+    for (uint16_t ix = 0; ix < m_slots; ix++) {
+      if (m_dev->read(&slot, address(ix), sizeof(slot)) != sizeof(slot))
+	continue;
+      if (!is_valid(slot)) continue;
+      if (m_valid && ((int16_t) (slot.seq - m_slot.seq) <= 0)) continue;
+      m_slot = slot;
+      m_ix = ix;
+      m_valid = true;
+    }
+    return (m_valid);
+  }
+
+  /**
+   * Read latest record. Return true(1) if available otherwise
+   * false(0).
+   * @param[out] data record.
+   * @return bool.
+   */
+  bool read(T& data) const
+  {
+    if (!m_valid) return (false);
+    data = m_slot.data;
+    return (true);
+  }
+
+  /**
+   * Write given record to the next slot. The write is skipped if the
+   * record is unchanged. The write is asynchronous and an
+   * Event::WRITE_COMPLETED_TYPE event is pushed to the given target
+   * on completion. Returns zero if unchanged, number of bytes if
+   * started, otherwise negative error code (EBUSY if the previous
+   * write has not completed).
+   * @param[in] data record.
+   * @param[in] target event handler for completion (default NULL).
+   * @return zero, number of bytes or negative error code.
+   */
+  int write(const T& data, Event::Handler* target = NULL)
+  {
+    if (UNLIKELY(!m_dev->is_ready())) return (EBUSY);
+    if (m_valid && !memcmp(&m_slot.data, &data, sizeof(T))) return (0);
+    if (++m_ix == m_slots) m_ix = 0;
+    if (++m_slot.seq == ERASED) m_slot.seq = 0;
+    m_slot.data = data;
+    m_slot.crc = crc(m_slot);
+    m_valid = true;
+    if (!m_dev->write_request(address(m_ix), &m_slot, sizeof(m_slot), target))
+      return (EIO);
+    return (sizeof(T));
+  }
+
+  /**
+   * Return true(1) if the latest write has completed otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool is_ready()
+  {
+    return (m_dev->is_ready());
+  }
+
+  /**
+   * Return sequence number of latest record.
+   * @return sequence number.
+   */
+  uint16_t sequence() const
+  {
+    return (m_slot.seq);
+  }
+
+protected:
+  /** Sequence number of erased slot. */
+  static const uint16_t ERASED = 0xffff;
+
+  /** Slot in ring. */
+  struct slot_t {
+    uint16_t seq;		//!< Sequence number.
+    T data;			//!< Record.
+    uint8_t crc;		//!< Check sum of sequence number and record.
+  };
+
+  Device* m_dev;		//!< Device.
+  uint8_t* m_base;		//!< Address of ring.
+  const uint16_t m_slots;	//!< Number of slots.
+  uint16_t m_ix;		//!< Index of latest slot.
+  bool m_valid;			//!< Latest record valid.
+  slot_t m_slot;		//!< Copy of latest slot; write buffer.
+
+  /**
+   * Return address of slot with given index.
+   * @param[in] ix slot index.
+   * @return address.
+   */
+  uint8_t* address(uint16_t ix) const
+  {
+    return (m_base + ix * SLOT_SIZE);
+  }
+
+  /**
+   * Return check sum of given slot.
+   * @param[in] slot.
+   * @return check sum.
+   */
+  static uint8_t crc(const slot_t& slot)
+  {
+    const uint8_t* bp = (const uint8_t*) &slot;
+    uint8_t res = 0;
+    for (size_t i = 0; i < sizeof(slot) - 1; i++)
+      res = _crc_ibutton_update(res, *bp++);
+    return (res);
+  }
+
+  /**
+   * Return true(1) if the slot is valid otherwise false(0).
+   * @param[in] slot.
+   * @return bool.
+   */
+  static bool is_valid(const slot_t& slot)
+  {
+    return ((slot.seq != ERASED) && (slot.crc == crc(slot)));
+  }
+};
+
 #endif
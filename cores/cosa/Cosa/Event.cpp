@@ -20,21 +20,181 @@
 
 #include "Cosa/Event.hh"
 #include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+#if defined(COSA_STACK_GUARD)
+#include "Cosa/Watermark.hh"
+#endif
 
 Queue<Event, Event::QUEUE_MAX> Event::queue;
+uint16_t Event::s_overruns = 0;
+Event::Handler* Event::s_idle = NULL;
+
+#if defined(COSA_EVENT_PROFILE)
+Event::Profile Event::s_profile[Event::PROFILE_MAX];
+
+void
+Event::profile(uint8_t ix, Profile& profile)
+{
+  if (UNLIKELY(ix >= PROFILE_MAX)) return;
+  synchronized profile = s_profile[ix];
+}
+
+void
+Event::reset_profile()
+{
+  synchronized {
+    memset(s_profile, 0, sizeof(s_profile));
+    s_overruns = 0;
+  }
+}
+
+void
+Event::run(Event* event)
+{
+#if defined(COSA_STACK_GUARD)
+  Watermark::guard(COSA_STACK_GUARD);
+#endif
+  uint32_t start = RTT::micros();
+  event->dispatch();
+  uint32_t us = RTT::micros() - start;
+  if (us > UINT16_MAX) us = UINT16_MAX;
+
+  // Update the handler entry or replace the entry with least time
+  Handler* target = event->m_target;
+  Profile* min = &s_profile[0];
+  for (uint8_t ix = 0; ix < PROFILE_MAX; ix++) {
+    Profile* entry = &s_profile[ix];
+    if (entry->target == target) {
+      if (us > entry->max) entry->max = us;
+      return;
+    }
+    if (entry->max < min->max || entry->target == NULL) min = entry;
+  }
+  if (min->target != NULL && us <= min->max) return;
+  min->target = target;
+  min->max = us;
+}
+#else
+void
+Event::run(Event* event)
+{
+#if defined(COSA_STACK_GUARD)
+  Watermark::guard(COSA_STACK_GUARD);
+#endif
+  event->dispatch();
+}
+#endif
+
+#if defined(COSA_EVENT_LANES)
+Queue<Event, Event::URGENT_QUEUE_MAX> Event::urgent;
+Queue<Event, Event::BACKGROUND_QUEUE_MAX> Event::background;
+Event::Stats Event::s_stats[Event::LANE_MAX];
+
+bool
+Event::enqueue(Lane lane, Event* event)
+{
+  Stats* stats = &s_stats[lane];
+  uint8_t count;
+  synchronized {
+    switch (lane) {
+    case URGENT_LANE:
+      if (UNLIKELY(!urgent.enqueue(event))) goto dropped;
+      count = urgent.available();
+      break;
+    case BACKGROUND_LANE:
+      if (UNLIKELY(!background.enqueue(event))) goto dropped;
+      count = background.available();
+      break;
+    default:
+      if (UNLIKELY(!queue.enqueue(event))) goto dropped;
+      count = queue.available();
+    }
+    if (count > stats->high_water) stats->high_water = count;
+    return (true);
+  dropped:
+    if (stats->dropped != UINT16_MAX) stats->dropped += 1;
+  }
+  return (false);
+}
+
+bool
+Event::dequeue(Event* event)
+{
+  if (urgent.get(event)) return (true);
+  if (queue.dequeue(event)) return (true);
+  return (background.get(event));
+}
+
+void
+Event::stats(Lane lane, Stats& stats)
+{
+  synchronized stats = s_stats[lane];
+}
+
+void
+Event::reset_stats()
+{
+  synchronized memset(s_stats, 0, sizeof(s_stats));
+}
+#endif
+
+bool
+Event::coalesce(uint8_t type, Handler* target, uint16_t value)
+{
+  Event event(type, target, value);
+  synchronized {
+    Event* pending = queue.find(is_same, &event);
+    if (pending != NULL) {
+      pending->m_value = value;
+      return (true);
+    }
+#if defined(COSA_EVENT_LANES)
+    return (enqueue(NORMAL_LANE, &event));
+#else
+    return (queue.enqueue(&event));
+#endif
+  }
+  return (false);
+}
 
 bool
 Event::service(uint32_t ms)
 {
   uint32_t start = Watchdog::millis();
   Event event;
+#if defined(COSA_EVENT_LANES)
+  while (!dequeue(&event)) {
+#else
   while (!queue.dequeue(&event)) {
+#endif
+    if (s_idle != NULL) s_idle->on_event(IDLE_TYPE, 0);
     if ((ms == 0L) || (Watchdog::since(start) < ms))
       yield();
     else
       return (false);
   }
-  event.dispatch();
+  run(&event);
   return (true);
 }
 
+uint8_t
+Event::service_for(uint32_t us)
+{
+  uint32_t start = RTT::micros();
+  Event event;
+  while ((RTT::micros() - start) < us) {
+#if defined(COSA_EVENT_LANES)
+    if (!dequeue(&event)) break;
+#else
+    if (!queue.dequeue(&event)) break;
+#endif
+    run(&event);
+  }
+  if ((RTT::micros() - start) > us) s_overruns += 1;
+  uint8_t res = queue.available();
+#if defined(COSA_EVENT_LANES)
+  res += urgent.available() + background.available();
+#endif
+  return (res);
+}
@@ -23,6 +23,7 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Queue.hh"
+#include "Cosa/ProbeChannel.hh"
 
 // Default event queue size
 #ifndef COSA_EVENT_QUEUE_MAX
@@ -33,6 +34,32 @@
 # endif
 #endif
 
+// Multi-lane event queue; urgent and background lane sizes
+#if defined(COSA_EVENT_LANES)
+# ifndef COSA_EVENT_URGENT_QUEUE_MAX
+#   if defined(BOARD_ATTINY)
+#     define COSA_EVENT_URGENT_QUEUE_MAX 4
+#   else
+#     define COSA_EVENT_URGENT_QUEUE_MAX 8
+#   endif
+# endif
+# ifndef COSA_EVENT_BACKGROUND_QUEUE_MAX
+#   if defined(BOARD_ATTINY)
+#     define COSA_EVENT_BACKGROUND_QUEUE_MAX 4
+#   else
+#     define COSA_EVENT_BACKGROUND_QUEUE_MAX 8
+#   endif
+# endif
+#endif
+
+// Event handler execution time profile; number of handler entries
+#if defined(COSA_EVENT_PROFILE)
+# if (COSA_EVENT_PROFILE + 0) == 0
+#   undef COSA_EVENT_PROFILE
+#   define COSA_EVENT_PROFILE 8
+# endif
+#endif
+
 /**
  * Event data structure with type, source and value.
  */
@@ -44,6 +71,35 @@ public:
    */
   static const uint8_t QUEUE_MAX = COSA_EVENT_QUEUE_MAX;
 
+#if defined(COSA_EVENT_LANES)
+  /**
+   * Size of urgent and background event queue lanes. Must be Power(2).
+   */
+  static const uint8_t URGENT_QUEUE_MAX = COSA_EVENT_URGENT_QUEUE_MAX;
+  static const uint8_t BACKGROUND_QUEUE_MAX = COSA_EVENT_BACKGROUND_QUEUE_MAX;
+
+  /**
+   * Event queue lanes in priority order. Event::service() will
+   * drain the urgent lane before the normal lane (Event::queue) and
+   * the background lane last.
+   */
+  enum Lane {
+    URGENT_LANE = 0,		//!< Time-critical events (ISR).
+    NORMAL_LANE = 1,		//!< Default lane; Event::queue.
+    BACKGROUND_LANE = 2,	//!< Low priority events.
+    LANE_MAX = 3
+  } __attribute__((packed));
+
+  /**
+   * Event queue lane statistics; high-water mark (maximum number of
+   * queued events) and number of dropped events (queue full).
+   */
+  struct Stats {
+    uint8_t high_water;		//!< Maximum number of queued events.
+    uint16_t dropped;		//!< Number of dropped events.
+  };
+#endif
+
   /**
    * Event types are added here. Typical mapping from interrupts to
    * events. Note that the event is not a global numbering
@@ -87,6 +143,8 @@ public:
     SERVICE_REQUEST_TYPE,	// Servers
     SERVICE_RESPONSE_TYPE,
 
+    IDLE_TYPE,			// Event service idle
+
     USER_TYPE = 64,		// User defined events/messages, 64-254
 
     ERROR_TYPE = 255		// Error event
@@ -109,8 +167,34 @@ public:
       UNUSED(type);
       UNUSED(value);
     }
+
+#if defined(COSA_EVENT_DIRECT_DISPATCH)
+    /**
+     * Direct event dispatch; call the event handler function of the
+     * single application handler class without virtual function
+     * call. Defined by the application with EVENT_HANDLER_DISPATCH().
+     * @param[in] target event target.
+     * @param[in] type the event type.
+     * @param[in] value the event value.
+     */
+    static void dispatch(Handler* target, uint8_t type, uint16_t value);
+#endif
   };
 
+#if defined(COSA_EVENT_PROFILE)
+  /** Number of event handlers in execution time profile. */
+  static const uint8_t PROFILE_MAX = COSA_EVENT_PROFILE;
+
+  /**
+   * Event handler execution time profile entry; target and maximum
+   * on_event() execution time in micro-seconds.
+   */
+  struct Profile {
+    Handler* target;		//!< Event handler.
+    uint16_t max;		//!< Maximum execution time (us).
+  };
+#endif
+
 public:
   /**
    * Construct event with given type, target and value.
@@ -166,7 +250,13 @@ public:
   void dispatch()
     __attribute__((always_inline))
   {
+    PROBE_SET(EVENT);
+#if defined(COSA_EVENT_DIRECT_DISPATCH)
+    if (m_target != NULL) Handler::dispatch(m_target, m_type, m_value);
+#else
     if (m_target != NULL) m_target->on_event(m_type, m_value);
+#endif
+    PROBE_CLEAR(EVENT);
   }
 
   /**
@@ -181,7 +271,11 @@ public:
     __attribute__((always_inline))
   {
     Event event(type, target, value);
+#if defined(COSA_EVENT_LANES)
+    return (enqueue(NORMAL_LANE, &event));
+#else
     return (queue.enqueue(&event));
+#endif
   }
 
   /**
@@ -199,7 +293,86 @@ public:
   }
 
   /**
-   * Event queue of size QUEUE_MAX.
+   * Push an event with given type, target and value into the event
+   * queue or, if an event with the same type and target is pending,
+   * replace the value of the pending event (coalescing). Bursty event
+   * sources will use a single queue slot and the handler receives
+   * the latest value. Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] type event identity.
+   * @param[in] target event target.
+   * @param[in] value event value.
+   * @return bool.
+   * @note atomic
+   */
+  static bool coalesce(uint8_t type, Handler* target, uint16_t value = 0);
+
+#if defined(COSA_EVENT_LANES)
+  /**
+   * Push an event with given type, source and value into the given
+   * event queue lane. Return true(1) if successful otherwise false(0).
+   * @param[in] lane event queue lane.
+   * @param[in] type event identity.
+   * @param[in] target event target.
+   * @param[in] value event value.
+   * @return bool.
+   */
+  static bool push(Lane lane, uint8_t type, Handler* target, uint16_t value = 0)
+    __attribute__((always_inline))
+  {
+    Event event(type, target, value);
+    return (enqueue(lane, &event));
+  }
+
+  /**
+   * Enqueue given event in the given lane and update lane
+   * statistics. Return true(1) if successful otherwise false(0).
+   * @param[in] lane event queue lane.
+   * @param[in] event to enqueue.
+   * @return bool.
+   * @note atomic
+   */
+  static bool enqueue(Lane lane, Event* event);
+
+  /**
+   * Dequeue event from the lanes in priority order. Return true(1)
+   * if an event was available otherwise false(0). The urgent and
+   * background lanes are dequeued without disabling interrupts; the
+   * event service is the single consumer. The normal lane is
+   * dequeued atomically as coalesce() may update pending events from
+   * an interrupt handler.
+   * @param[in,out] event buffer.
+   * @return bool.
+   */
+  static bool dequeue(Event* event);
+
+  /**
+   * Return statistics for given event queue lane.
+   * @param[in] lane event queue lane.
+   * @param[out] stats statistics buffer.
+   * @note atomic
+   */
+  static void stats(Lane lane, Stats& stats);
+
+  /**
+   * Reset statistics for all event queue lanes.
+   */
+  static void reset_stats();
+
+  /**
+   * Urgent event queue lane of size URGENT_QUEUE_MAX.
+   */
+  static Queue<Event, URGENT_QUEUE_MAX> urgent;
+
+  /**
+   * Background event queue lane of size BACKGROUND_QUEUE_MAX.
+   */
+  static Queue<Event, BACKGROUND_QUEUE_MAX> background;
+#endif
+
+  /**
+   * Event queue of size QUEUE_MAX. Normal lane when multi-lane event
+   * queue is enabled (COSA_EVENT_LANES).
    */
   static Queue<Event, QUEUE_MAX> queue;
 
@@ -211,11 +384,115 @@ public:
    */
   static bool service(uint32_t ms = 0L);
 
+  /**
+   * Dispatch queued events until the given time budget in
+   * micro-seconds is used (measured with RTT::micros()) or the queue
+   * is empty. Does not block. The budget is checked before each
+   * dispatch; an overrun is counted if the last handler exceeds the
+   * budget. Returns number of events remaining in the queue(s).
+   * @param[in] us time budget in micro-seconds.
+   * @return remaining events.
+   */
+  static uint8_t service_for(uint32_t us);
+
+  /**
+   * Set idle handler. The handler is called with IDLE_TYPE by
+   * service() when the event queue is empty; before waiting for the
+   * next event. Used for background work such as deferred output.
+   * Pass NULL to remove.
+   * @param[in] handler idle event handler.
+   */
+  static void idle(Handler* handler)
+  {
+    s_idle = handler;
+  }
+
+  /**
+   * Return number of service_for() calls that have exceeded the time
+   * budget.
+   * @return overruns.
+   */
+  static uint16_t overruns()
+  {
+    return (s_overruns);
+  }
+
+#if defined(COSA_EVENT_PROFILE)
+  /**
+   * Return execution time profile entry with given index. The
+   * entries with the longest execution time are kept when there are
+   * more than PROFILE_MAX handlers. Unused entries have NULL target.
+   * Only events dispatched by service() and service_for() are
+   * measured.
+   * @param[in] ix entry index (0..PROFILE_MAX-1).
+   * @param[out] profile entry buffer.
+   * @note atomic
+   */
+  static void profile(uint8_t ix, Profile& profile);
+
+  /**
+   * Reset execution time profile and overrun count.
+   */
+  static void reset_profile();
+#endif
+
 private:
+  /** Number of service_for() budget overruns. */
+  static uint16_t s_overruns;
+
+  /** Idle event handler. */
+  static Handler* s_idle;
+
+#if defined(COSA_EVENT_PROFILE)
+  /** Event handler execution time profile. */
+  static Profile s_profile[PROFILE_MAX];
+#endif
+
+  /**
+   * Dispatch given event and record handler execution time when
+   * profiling (COSA_EVENT_PROFILE).
+   * @param[in] event to dispatch.
+   */
+  static void run(Event* event);
+
+  /**
+   * Return true(1) if the given events have the same type and target
+   * otherwise false(0). Used by coalesce().
+   * @param[in] event pending event.
+   * @param[in] other event to push.
+   * @return bool.
+   */
+  static bool is_same(const Event* event, const Event* other)
+  {
+    return ((event->m_type == other->m_type)
+	    && (event->m_target == other->m_target));
+  }
+
+#if defined(COSA_EVENT_LANES)
+  /** Event queue lane statistics. */
+  static Stats s_stats[LANE_MAX];
+#endif
+
   uint8_t m_type;		//!< Event type.
   Handler* m_target;		//!< Event target object (receiver).
   uint16_t m_value;		//!< Event parameter and/or value.
 };
 
+#if defined(COSA_EVENT_DIRECT_DISPATCH)
+/**
+ * Define the direct event dispatch function for the given handler
+ * class. Should be used once in the application. All event targets
+ * must be instances of the class (or sub-classes that do not
+ * override on_event()).
+ * @param[in] handler class name.
+ */
+#define EVENT_HANDLER_DISPATCH(handler)					\
+  void Event::Handler::dispatch(Event::Handler* target,			\
+				uint8_t type, uint16_t value)		\
+  {									\
+    static_cast<handler*>(target)->handler::on_event(type, value);	\
+  }
+#endif
+
 #endif
 
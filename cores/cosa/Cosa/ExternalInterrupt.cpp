@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/Probe.hh"
 
 #if defined(BOARD_ATMEGA328P)
 
@@ -29,7 +30,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
   IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
   m_ix(pin - Board::EXT0)
 {
-  ext[m_ix] = this;
+  attach();
   uint8_t ix = (m_ix << 1);
   bit_field_set(EICRA, 0b11 << ix, mode << ix);
 }
@@ -43,7 +44,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
   IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
   m_ix(pin - Board::EXT0)
 {
-  ext[m_ix] = this;
+  attach();
   uint8_t ix = (m_ix << 1);
   bit_field_set(EICRA, 0b11 << ix, mode << ix);
 }
@@ -68,7 +69,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
     uint8_t ix = (m_ix << 1);
     bit_field_set(EICRA, 0b11 << ix, mode << ix);
   }
-  ext[m_ix] = this;
+  attach();
 }
 
 #elif defined(BOARD_ATMEGA1248P)
@@ -87,7 +88,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
   }
   uint8_t ix = (m_ix << 1);
   bit_field_set(EICRA, 0b11 << ix, mode << ix);
-  ext[m_ix] = this;
+  attach();
 }
 
 #elif defined(BOARD_ATMEGA256RFR2)
@@ -110,7 +111,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
     bit_field_set(EICRB, 0b11 << ix, mode << ix);
     m_ix += 4;
   }
-  ext[m_ix] = this;
+  attach();
 }
 
 #elif defined(BOARD_ATTINYX61)
@@ -122,7 +123,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
   IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
   m_ix(pin == Board::EXT1)
 {
-  ext[m_ix] = this;
+  attach();
   uint8_t ix = (m_ix << 1);
   bit_field_set(MCUCR, 0b11 << ix, mode << ix);
 }
@@ -157,7 +158,7 @@ ExternalInterrupt(Board::ExternalInterruptPin pin,
   IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
   m_ix(0)
 {
-  ext[m_ix] = this;
+  attach();
   bit_field_set(MCUCR, 0b11, mode);
 }
 
@@ -208,15 +209,76 @@ ExternalInterrupt::clear()
 }
 #endif
 
+void
+ExternalInterrupt::interrupt_mode(InterruptMode mode)
+{
+#if defined(BOARD_ATTINY)
+  uint8_t ix = (m_ix << 1);
+  synchronized bit_field_set(MCUCR, 0b11 << ix, mode << ix);
+#elif defined(BOARD_ATMEGA2560) || defined(BOARD_ATMEGA256RFR2)
+  uint8_t ix = ((m_ix & 0x03) << 1);
+  synchronized {
+    if (m_ix < 4)
+      bit_field_set(EICRA, 0b11 << ix, mode << ix);
+    else
+      bit_field_set(EICRB, 0b11 << ix, mode << ix);
+  }
+#else
+  uint8_t ix = (m_ix << 1);
+  synchronized bit_field_set(EICRA, 0b11 << ix, mode << ix);
+#endif
+}
+
+// Optional nested interrupt handling; the interrupt is masked while
+// the handler runs with interrupts enabled
+#if !defined(COSA_NESTED_EXT_INT)
+#define INT_NESTED(nr)
+#elif defined(BOARD_ATTINY)
+#define INT_NESTED(nr) ISR_NESTED(GIMSK, _BV(INT0 + nr))
+#else
+#define INT_NESTED(nr) ISR_NESTED(EIMSK, _BV(nr))
+#endif
+
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+
+void
+ExternalInterrupt::on_interrupt(uint8_t ix)
+{
+  ExternalInterrupt* const* entry = s_handler;
+  ExternalInterrupt* ext;
+  while ((ext = (ExternalInterrupt*) pgm_read_word(entry++)) != NULL) {
+    if (ext->m_ix == ix) {
+      ext->on_interrupt();
+      return;
+    }
+  }
+}
+
+#define INT_ISR(nr)							\
+ISR_PROBE_DEFINE(int ## nr ## _isr_probe, "isr:INT" #nr);		\
+ISR(INT ## nr ## _vect)							\
+{									\
+  ISR_PROBE(int ## nr ## _isr_probe);					\
+  INT_NESTED(nr);							\
+  ExternalInterrupt::on_interrupt((uint8_t) nr);			\
+}
+
+#else
+
 ExternalInterrupt* ExternalInterrupt::ext[Board::EXT_MAX] = { NULL };
 
 #define INT_ISR(nr)							\
+ISR_PROBE_DEFINE(int ## nr ## _isr_probe, "isr:INT" #nr);		\
 ISR(INT ## nr ## _vect)							\
 {									\
+  ISR_PROBE(int ## nr ## _isr_probe);					\
+  INT_NESTED(nr);							\
   if (ExternalInterrupt::ext[nr] != NULL)				\
     ExternalInterrupt::ext[nr]->on_interrupt();				\
 }
 
+#endif
+
 INT_ISR(0)
 #if defined(INT1_vect)
 INT_ISR(1)
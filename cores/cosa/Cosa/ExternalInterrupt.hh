@@ -29,6 +29,16 @@
 /**
  * Abstract external interrupt pin. Allows interrupt handling on
  * the pin value changes.
+ *
+ * @section Static
+ * With COSA_STATIC_INTERRUPT_HANDLERS the external interrupt pin map
+ * in data memory is replaced by a null terminated table of handlers
+ * in program memory. The table is defined by the application with
+ * EXT_HANDLERS() and resolved at link time.
+ * @code
+ * Counter counter(Board::EXT0);
+ * EXT_HANDLERS(&counter);
+ * @endcode
  */
 class ExternalInterrupt : public IOPin, public Interrupt::Handler {
 public:
@@ -50,6 +60,16 @@ public:
 		    InterruptMode mode = ON_CHANGE_MODE,
 		    bool pullup = false);
 
+  /**
+   * Set interrupt mode. Should be called with the interrupt handler
+   * disabled; enable() will clear any pending interrupt. Note that
+   * only low level interrupt will wake the processor from power down
+   * on most devices.
+   * @param[in] mode interrupt mode.
+   * @note atomic
+   */
+  void interrupt_mode(InterruptMode mode);
+
   /**
    * @override{Interrupt::Handler}
    * Interrupt service callback on external interrupt pin change.
@@ -82,12 +102,34 @@ public:
   virtual void clear();
 
 private:
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+  /** Null terminated interrupt handler table; see EXT_HANDLERS(). */
+  static ExternalInterrupt* const s_handler[] PROGMEM;
+
+  /**
+   * Dispatch the handler in the table for the given external
+   * interrupt.
+   * @param[in] ix external interrupt index.
+   */
+  static void on_interrupt(uint8_t ix);
+#else
   /** External interrupt pin map. */
   static ExternalInterrupt* ext[Board::EXT_MAX];
+#endif
 
   /** External interrupt mask. */
   uint8_t m_ix;
 
+  /**
+   * Register the instance in the external interrupt pin map.
+   */
+  void attach()
+  {
+#if !defined(COSA_STATIC_INTERRUPT_HANDLERS)
+    ext[m_ix] = this;
+#endif
+  }
+
   friend void INT0_vect(void);
 #if defined(INT1_vect)
   friend void INT1_vect(void);
@@ -112,4 +154,16 @@ private:
 #endif
 };
 
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+/**
+ * Define the external interrupt handler table in program memory.
+ * Should be used once in the application with the addresses of all
+ * external interrupt handlers.
+ * @param[in] ... handler addresses.
+ */
+#define EXT_HANDLERS(...)						\
+  ExternalInterrupt* const ExternalInterrupt::s_handler[] __PROGMEM = { \
+    __VA_ARGS__, NULL							\
+  }
+#endif
 #endif
@@ -0,0 +1,115 @@
+/**
+ * @file Cosa/Fader.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Fader.hh"
+
+// Gamma corrected brightness curve; round(255 * (i/255)^2.2)
+const uint8_t Fader::GAMMA[256] __PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+    6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+   12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+   20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+   30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+   42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+   56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+   73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+   91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+  113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+  137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+  163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+  192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+  223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+Fader::Channel::Channel(Fader* fader, Board::PWMPin pin,
+			const uint8_t* curve) :
+  PWMPin(pin),
+  m_next(fader->m_channel),
+  m_fader(fader),
+  m_curve(curve),
+  m_level(0),
+  m_delta(0),
+  m_steps(0),
+  m_target(0)
+{
+  fader->m_channel = this;
+}
+
+void
+Fader::Channel::level(uint8_t level)
+{
+  m_steps = 0;
+  m_target = level;
+  m_level = (level << 8);
+  update();
+}
+
+void
+Fader::Channel::fade(uint8_t level, uint32_t duration)
+{
+  // Set level directly if the duration is less than two steps
+  uint32_t steps = duration / m_fader->period();
+  if (steps < 2) {
+    this->level(level);
+    return;
+  }
+  if (steps > UINT16_MAX) steps = UINT16_MAX;
+
+  // Calculate level increment; the last step sets the target level
+  int32_t delta = ((int32_t) level << 8) - (m_level & 0xff00);
+  m_level &= 0xff00;
+  m_delta = delta / (int32_t) steps;
+  m_steps = steps;
+  m_target = level;
+  m_fader->resume();
+}
+
+void
+Fader::resume()
+{
+  if (is_started()) return;
+  expire_at(time() + m_period);
+  start();
+}
+
+void
+Fader::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (UNLIKELY(type != Event::TIMEOUT_TYPE)) return;
+
+  // Step all fading channels and update the duty cycles
+  bool fading = false;
+  for (Channel* ch = m_channel; ch != NULL; ch = ch->m_next) {
+    if (ch->m_steps == 0) continue;
+    if (--ch->m_steps == 0)
+      ch->m_level = (ch->m_target << 8);
+    else {
+      ch->m_level += ch->m_delta;
+      fading = true;
+    }
+    ch->update();
+  }
+
+  // Reschedule while fading
+  if (fading) reschedule();
+}
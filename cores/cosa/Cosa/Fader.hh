@@ -0,0 +1,158 @@
+/**
+ * @file Cosa/Fader.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_FADER_HH
+#define COSA_FADER_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/PWMPin.hh"
+#include "Cosa/Periodic.hh"
+
+/**
+ * Fade engine for pwm output pins. A single periodic job advances
+ * the brightness level of all fading channels each tick and maps the
+ * level to the pwm duty cycle with a curve in program memory (default
+ * GAMMA). Each channel has a target level and duration; the level is
+ * stepped with fixed-point (8.8) increments. The job is only
+ * scheduled while channels are fading.
+ *
+ * @section Usage
+ * @code
+ * RTT::Scheduler scheduler;
+ * Fader fader(&scheduler, 20000);
+ * Fader::Channel led(&fader, Board::PWM1);
+ * ...
+ * led.begin();
+ * led.fade(255, 1000000);
+ * @endcode
+ */
+class Fader : public Periodic {
+public:
+  /** Gamma (2.2) corrected brightness curve; 256 duty values. */
+  static const uint8_t GAMMA[256] PROGMEM;
+
+  /**
+   * Fader channel; pwm output pin with brightness level.
+   */
+  class Channel : public PWMPin {
+  public:
+    /**
+     * Construct fader channel for given pwm pin and attach to the
+     * given fade engine. The brightness level is mapped to duty cycle
+     * with the given curve (or linear if NULL).
+     * @param[in] fader fade engine.
+     * @param[in] pin pwm pin.
+     * @param[in] curve in program memory (default GAMMA).
+     */
+    Channel(Fader* fader, Board::PWMPin pin, const uint8_t* curve = GAMMA);
+
+    /**
+     * Return current brightness level.
+     * @return level.
+     */
+    uint8_t level() const
+    {
+      return (m_level >> 8);
+    }
+
+    /**
+     * Set brightness level directly. Any fade is stopped.
+     * @param[in] level brightness (0..255).
+     */
+    void level(uint8_t level);
+
+    /**
+     * Fade to given brightness level in given duration in the fade
+     * engine scheduler time base. The fade engine is started if
+     * needed.
+     * @param[in] level target brightness (0..255).
+     * @param[in] duration of fade.
+     */
+    void fade(uint8_t level, uint32_t duration);
+
+    /**
+     * Return true(1) if the channel is fading otherwise false(0).
+     * @return bool.
+     */
+    bool is_fading() const
+    {
+      return (m_steps != 0);
+    }
+
+  protected:
+    friend class Fader;
+    Channel* m_next;		//!< Next channel in fade engine.
+    Fader* m_fader;		//!< Fade engine.
+    const uint8_t* m_curve;	//!< Level to duty cycle curve.
+    uint16_t m_level;		//!< Current level (8.8).
+    int16_t m_delta;		//!< Level increment per step (8.8).
+    uint16_t m_steps;		//!< Remaining steps.
+    uint8_t m_target;		//!< Target level.
+
+    /**
+     * Update pwm duty cycle from current level.
+     */
+    void update()
+    {
+      uint8_t level = (m_level >> 8);
+      set(m_curve == NULL ? level : pgm_read_byte(&m_curve[level]));
+    }
+  };
+
+  /**
+   * Construct fade engine with given scheduler and step period in
+   * the scheduler time base.
+   * @param[in] scheduler for fade steps.
+   * @param[in] period of fade steps.
+   */
+  Fader(Job::Scheduler* scheduler, uint32_t period) :
+    Periodic(scheduler, period),
+    m_channel(NULL)
+  {}
+
+  /**
+   * Return true(1) if any channel is fading otherwise false(0).
+   * @return bool.
+   */
+  bool is_fading() const
+  {
+    return (is_started());
+  }
+
+protected:
+  /** List of channels. */
+  Channel* m_channel;
+
+  /**
+   * @override{Event::Handler}
+   * Step all fading channels on timeout event and reschedule while
+   * any channel is fading.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+
+  /**
+   * Start the periodic fade step job if not already started.
+   */
+  void resume();
+};
+
+#endif
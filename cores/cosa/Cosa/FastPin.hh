@@ -0,0 +1,196 @@
+/**
+ * @file Cosa/FastPin.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_FAST_PIN_HH
+#define COSA_FAST_PIN_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Pin.hh"
+
+/**
+ * Compile-time digital pin. The port registers and pin mask are
+ * template constants and all member functions are static and
+ * inlined; set, clear and read reduce to single sbi, cbi and
+ * sbic/sbis instructions for ports in the lower I/O space. Ports
+ * outside the bit addressable I/O space (e.g. PORTH..PORTL on Mega)
+ * fall back to a synchronized read-modify-write. Intended for hot
+ * paths such as bit-banged protocols where OutputPin/InputPin
+ * indirection through the register pointer is too costly.
+ * @code
+ * typedef FastPin<Board::D8> Clock;
+ * Clock::output();
+ * Clock::set();
+ * Clock::clear();
+ * @endcode
+ * @param[in] PIN digital pin.
+ */
+template<Board::DigitalPin PIN>
+class FastPin {
+public:
+  /**
+   * Set pin in output mode with given initial value.
+   * @param[in] initial value (default zero).
+   * @note atomic
+   */
+  static void output(bool initial = 0)
+    __attribute__((always_inline))
+  {
+    write(initial);
+    if (is_bit_addressable()) {
+      *Pin::DDR(PIN) |= Pin::MASK(PIN);
+    }
+    else synchronized {
+      *Pin::DDR(PIN) |= Pin::MASK(PIN);
+    }
+  }
+
+  /**
+   * Set pin in input mode with optional pullup resistor.
+   * @param[in] pullup enable flag (default false).
+   * @note atomic
+   */
+  static void input(bool pullup = false)
+    __attribute__((always_inline))
+  {
+    if (is_bit_addressable()) {
+      *Pin::DDR(PIN) &= ~Pin::MASK(PIN);
+    }
+    else synchronized {
+      *Pin::DDR(PIN) &= ~Pin::MASK(PIN);
+    }
+    write(pullup);
+  }
+
+  /**
+   * Return true(1) if the pin is set otherwise false(0).
+   * @return bool.
+   */
+  static bool read()
+    __attribute__((always_inline))
+  {
+    return ((*Pin::PIN(PIN) & Pin::MASK(PIN)) != 0);
+  }
+
+  /**
+   * Return true(1) if the pin is set otherwise false(0).
+   * @return bool.
+   */
+  static bool is_set()
+    __attribute__((always_inline))
+  {
+    return (read());
+  }
+
+  /**
+   * Return true(1) if the pin is clear otherwise false(0).
+   * @return bool.
+   */
+  static bool is_clear()
+    __attribute__((always_inline))
+  {
+    return (!read());
+  }
+
+  /**
+   * Set the output pin.
+   * @note atomic
+   */
+  static void set()
+    __attribute__((always_inline))
+  {
+    if (is_bit_addressable()) {
+      *Pin::PORT(PIN) |= Pin::MASK(PIN);
+    }
+    else synchronized {
+      *Pin::PORT(PIN) |= Pin::MASK(PIN);
+    }
+  }
+
+  /**
+   * Clear the output pin.
+   * @note atomic
+   */
+  static void clear()
+    __attribute__((always_inline))
+  {
+    if (is_bit_addressable()) {
+      *Pin::PORT(PIN) &= ~Pin::MASK(PIN);
+    }
+    else synchronized {
+      *Pin::PORT(PIN) &= ~Pin::MASK(PIN);
+    }
+  }
+
+  /**
+   * Set the output pin with the given value. Zero(0) to clear
+   * and non-zero to set.
+   * @param[in] value to write.
+   * @note atomic
+   */
+  static void write(bool value)
+    __attribute__((always_inline))
+  {
+    if (value) set(); else clear();
+  }
+
+  /**
+   * Set the output pin with the given value. Unprotected version
+   * for use in synchronized blocks.
+   * @param[in] value to write.
+   */
+  static void _write(bool value)
+    __attribute__((always_inline))
+  {
+    if (value)
+      *Pin::PORT(PIN) |= Pin::MASK(PIN);
+    else
+      *Pin::PORT(PIN) &= ~Pin::MASK(PIN);
+  }
+
+  /**
+   * Toggle the output pin. Writing the PIN register toggles the
+   * port bit and is always a single store.
+   */
+  static void toggle()
+    __attribute__((always_inline))
+  {
+    *Pin::PIN(PIN) = Pin::MASK(PIN);
+  }
+
+  /**
+   * Return true(1) if the port register is within the bit
+   * addressable I/O space (sbi/cbi) otherwise false(0). Reduced
+   * to a constant by the compiler.
+   * @return bool.
+   */
+  static bool is_bit_addressable()
+    __attribute__((always_inline))
+  {
+    return (((uintptr_t) Pin::PORT(PIN)) < (__SFR_OFFSET + 0x20));
+  }
+
+private:
+  /**
+   * Do not allow instances. This is a static name space.
+   */
+  FastPin() {}
+};
+
+#endif
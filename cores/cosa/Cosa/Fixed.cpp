@@ -0,0 +1,182 @@
+/**
+ * @file Cosa/Fixed.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Fixed.hh"
+
+// sin(i * PI / 128) * 32768, i = 0..64
+const int16_t Fixed::SIN_TAB[] __PROGMEM = {
+  0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+  6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+  12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+  18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+  23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+  27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+  30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+  32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+  32767
+};
+
+// atan(i / 32) * 32768 / PI, i = 0..32
+const uint16_t Fixed::ATAN_TAB[] __PROGMEM = {
+  0, 326, 651, 975, 1297, 1617, 1933, 2246,
+  2555, 2860, 3159, 3453, 3742, 4025, 4302, 4572,
+  4836, 5094, 5344, 5589, 5826, 6058, 6282, 6500,
+  6712, 6917, 7117, 7310, 7498, 7679, 7856, 8026,
+  8192
+};
+
+// 32768 / ((16 + i + 0.5) / 32), i = 0..15
+const uint16_t Fixed::RECIP_TAB[] __PROGMEM = {
+  0xf83e, 0xea0f, 0xdd68, 0xd20d, 0xc7ce, 0xbe83, 0xb60b, 0xae4c,
+  0xa72f, 0xa0a1, 0x9a91, 0x94f2, 0x8fb8, 0x8ad9, 0x864c, 0x8208
+};
+
+uint16_t
+Fixed::recip(uint16_t x)
+{
+  if (UNLIKELY(x <= 1)) return (0xffff);
+
+  // Normalize to 0.5..1 (Q0.16); powers of two are exact
+  uint16_t xn = x;
+  uint8_t s = 0;
+  while ((xn & 0x8000) == 0) {
+    xn <<= 1;
+    s += 1;
+  }
+  if (xn == 0x8000) return (1U << (s + 1));
+
+  // Seed and two Newton-Raphson iterations; y = y * (2 - xn * y)
+  uint32_t y = pgm_read_word(&RECIP_TAB[(xn >> 11) & 0x0f]);
+  for (uint8_t i = 0; i < 2; i++) {
+    uint16_t e = ((uint32_t) xn * y) >> 16;
+    y = (y * (uint16_t) (0U - e)) >> 15;
+  }
+
+  // Scale and correct to round down of 65536 / x
+  uint16_t res = y >> (15 - s);
+  int32_t rem = 65536L - (uint32_t) res * x;
+  while (rem < 0) {
+    res -= 1;
+    rem += x;
+  }
+  while (rem >= x) {
+    res += 1;
+    rem -= x;
+  }
+  return (res);
+}
+
+uint8_t
+Fixed::sqrt16(uint16_t x)
+{
+  uint16_t res = 0;
+  uint16_t bit = 0x4000;
+  while (bit > x) bit >>= 2;
+  while (bit != 0) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (res);
+}
+
+uint16_t
+Fixed::sqrt32(uint32_t x)
+{
+  uint32_t res = 0;
+  uint32_t bit = 0x40000000UL;
+  while (bit > x) bit >>= 2;
+  while (bit != 0) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (res);
+}
+
+q15_t
+Fixed::sin(uint16_t angle)
+{
+  // Mirror the angle to the first quadrant
+  uint16_t ix = angle & 0x3fff;
+  if (angle & 0x4000) ix = 0x4000 - ix;
+
+  // Interpolate between table entries
+  uint8_t i = ix >> 8;
+  uint8_t frac = ix;
+  int16_t res = pgm_read_word(&SIN_TAB[i]);
+  if (frac != 0) {
+    uint16_t delta = pgm_read_word(&SIN_TAB[i + 1]) - res;
+    res += ((uint32_t) delta * frac) >> 8;
+  }
+
+  // Negative half-wave
+  return ((angle & 0x8000) ? -res : res);
+}
+
+uint16_t
+Fixed::atan2(int16_t y, int16_t x)
+{
+  if (UNLIKELY(x == 0 && y == 0)) return (0);
+
+  // Reduce to the first octant; 0 <= ay <= ax
+  uint16_t ax = (x < 0) ? 0U - (uint16_t) x : x;
+  uint16_t ay = (y < 0) ? 0U - (uint16_t) y : y;
+  bool swap = ay > ax;
+  if (swap) {
+    uint16_t tmp = ax;
+    ax = ay;
+    ay = tmp;
+  }
+
+  // Normalize to 16-bit and calculate rounded ratio; 0..256
+  while ((ax & 0x8000) == 0) {
+    ax <<= 1;
+    ay <<= 1;
+  }
+  uint16_t div = (ax + 0x80) >> 8;
+  if (UNLIKELY(div == 0)) div = 256;
+  uint16_t ratio = ay / div;
+  if ((ay % div) >= (div >> 1)) ratio += 1;
+  if (UNLIKELY(ratio > 256)) ratio = 256;
+
+  // Interpolate between table entries
+  uint8_t i = ratio >> 3;
+  uint8_t frac = ratio & 7;
+  uint16_t res = pgm_read_word(&ATAN_TAB[i]);
+  if (frac != 0)
+    res += ((pgm_read_word(&ATAN_TAB[i + 1]) - res) * frac) >> 3;
+
+  // Map back to the octant of the vector
+  if (swap) res = 0x4000 - res;
+  if (x < 0) res = 0x8000 - res;
+  if (y < 0) res = -res;
+  return (res);
+}
@@ -0,0 +1,254 @@
+/**
+ * @file Cosa/Fixed.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_FIXED_HH
+#define COSA_FIXED_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * Fixed-point number types (Qm.n); signed integers with an implicit
+ * scale factor of 2^n.
+ */
+typedef int16_t q15_t;		//!< Q1.15; -1.0..0.99997.
+typedef int16_t q8_8_t;		//!< Q8.8; -128.0..127.996.
+typedef int32_t q16_16_t;	//!< Q16.16; -32768.0..32767.99998.
+
+/**
+ * Fixed-point arithmetic functions for sensor compensation and
+ * filtering without floating point or 32-bit division. Multiplication
+ * is performed with 16x16 to 32-bit products which the compiler
+ * maps to the AVR hardware multiplier. Division by a variable is
+ * replaced by multiplication with a reciprocal and division by a
+ * constant with multiplication by a compile-time scale factor.
+ * Angles are in binary units; 65536 is one turn (2 PI). The sine and
+ * arc tangent tables are stored in program memory and only linked
+ * when used.
+ * @code
+ * // Distance in mm from count with 100 mm per COUNT_PER_DM counts
+ * static const uint16_t SCALE = (100 * 65536UL) / COUNT_PER_DM;
+ * uint16_t mm = Fixed::umulhi(count, SCALE);
+ * @endcode
+ */
+class Fixed {
+public:
+  /**
+   * Return given real value as fixed-point with given number of
+   * fraction bits. Intended for compile-time constants.
+   * @param[in] x real value.
+   * @param[in] frac number of fraction bits.
+   * @return fixed-point value.
+   */
+  static constexpr int32_t from(float x, uint8_t frac)
+  {
+    return ((int32_t) (x * (1L << frac) + (x < 0 ? -0.5 : 0.5)));
+  }
+
+  /**
+   * Return given fixed-point value with given number of fraction
+   * bits as floating point. Intended for trace output.
+   * @param[in] x fixed-point value.
+   * @param[in] frac number of fraction bits.
+   * @return real value.
+   */
+  static float to_float(int32_t x, uint8_t frac)
+  {
+    return (((float) x) / (1L << frac));
+  }
+
+  /**
+   * Return given value saturated to 16-bit.
+   * @param[in] x value.
+   * @return saturated value.
+   */
+  static int16_t sat(int32_t x)
+    __attribute__((always_inline))
+  {
+    if (UNLIKELY(x > INT16_MAX)) return (INT16_MAX);
+    if (UNLIKELY(x < INT16_MIN)) return (INT16_MIN);
+    return (x);
+  }
+
+  /**
+   * Return saturated sum of given values.
+   * @param[in] x value.
+   * @param[in] y value.
+   * @return sum.
+   */
+  static int16_t add(int16_t x, int16_t y)
+    __attribute__((always_inline))
+  {
+    int16_t res = (uint16_t) x + (uint16_t) y;
+    if (UNLIKELY(((x ^ res) & (y ^ res)) < 0))
+      return (x < 0 ? INT16_MIN : INT16_MAX);
+    return (res);
+  }
+
+  /**
+   * Return saturated difference of given values.
+   * @param[in] x value.
+   * @param[in] y value.
+   * @return difference.
+   */
+  static int16_t sub(int16_t x, int16_t y)
+    __attribute__((always_inline))
+  {
+    int16_t res = (uint16_t) x - (uint16_t) y;
+    if (UNLIKELY(((x ^ y) & (x ^ res)) < 0))
+      return (x < 0 ? INT16_MIN : INT16_MAX);
+    return (res);
+  }
+
+  /**
+   * Return rounded and saturated product of given fixed-point values
+   * with the given number of fraction bits.
+   * @param[in] FRAC number of fraction bits (1..15).
+   * @param[in] x fixed-point value.
+   * @param[in] y fixed-point value.
+   * @return product.
+   */
+  template<uint8_t FRAC>
+  static int16_t mul(int16_t x, int16_t y)
+  {
+    static_assert(FRAC > 0 && FRAC < 16, "FRAC should be 1..15");
+    int32_t res = (int32_t) x * y;
+    return (sat((res + (1L << (FRAC - 1))) >> FRAC));
+  }
+
+  /**
+   * Return rounded and saturated product of given Q1.15 values.
+   * @param[in] x fixed-point value.
+   * @param[in] y fixed-point value.
+   * @return product.
+   */
+  static q15_t mul(q15_t x, q15_t y)
+  {
+    return (mul<15>(x, y));
+  }
+
+  /**
+   * Return high 16-bit of the 32-bit product of given signed values;
+   * (x * y) >> 16.
+   * @param[in] x value.
+   * @param[in] y value.
+   * @return product high word.
+   */
+  static int16_t mulhi(int16_t x, int16_t y)
+    __attribute__((always_inline))
+  {
+    return (((int32_t) x * y) >> 16);
+  }
+
+  /**
+   * Return high 16-bit of the 32-bit product of given unsigned
+   * values; (x * y) >> 16. Multiplication with a scale factor
+   * replaces division by a constant.
+   * @param[in] x value.
+   * @param[in] y value (scale factor).
+   * @return product high word.
+   */
+  static uint16_t umulhi(uint16_t x, uint16_t y)
+    __attribute__((always_inline))
+  {
+    return (((uint32_t) x * y) >> 16);
+  }
+
+  /**
+   * Return reciprocal of given value; round down of 65536 / x. The
+   * reciprocal is calculated with a seed table and two Newton-Raphson
+   * iterations followed by a correction step. The value one is
+   * saturated to 0xffff. Division, x / y, may be replaced with
+   * umulhi(x, recip(y)) (max error one).
+   * @param[in] x value (not zero).
+   * @return reciprocal.
+   */
+  static uint16_t recip(uint16_t x);
+
+  /**
+   * Return rounded down square root of given 16-bit value.
+   * @param[in] x value.
+   * @return square root.
+   */
+  static uint8_t sqrt16(uint16_t x);
+
+  /**
+   * Return rounded down square root of given 32-bit value.
+   * @param[in] x value.
+   * @return square root.
+   */
+  static uint16_t sqrt32(uint32_t x);
+
+  /**
+   * Return sine of given angle (binary units, 65536 is 2 PI) in
+   * Q1.15. Linear interpolation in a quarter wave table with 64
+   * steps (max error 0.0002).
+   * @param[in] angle binary units.
+   * @return sine value.
+   */
+  static q15_t sin(uint16_t angle);
+
+  /**
+   * Return cosine of given angle (binary units, 65536 is 2 PI) in
+   * Q1.15.
+   * @param[in] angle binary units.
+   * @return cosine value.
+   */
+  static q15_t cos(uint16_t angle)
+  {
+    return (sin(angle + 0x4000));
+  }
+
+  /**
+   * Calculate sine and cosine of given angle (binary units, 65536 is
+   * 2 PI) in Q1.15.
+   * @param[in] angle binary units.
+   * @param[out] s sine value.
+   * @param[out] c cosine value.
+   */
+  static void sincos(uint16_t angle, q15_t& s, q15_t& c)
+  {
+    s = sin(angle);
+    c = sin(angle + 0x4000);
+  }
+
+  /**
+   * Return angle of given vector (binary units, 65536 is 2 PI,
+   * counter clockwise from the positive x-axis). The vector is
+   * normalized and the angle is interpolated in an arc tangent table
+   * with 32 steps per octant (max error 0.2 degree).
+   * The angle of the zero vector is zero.
+   * @param[in] y coordinate.
+   * @param[in] x coordinate.
+   * @return angle.
+   */
+  static uint16_t atan2(int16_t y, int16_t x);
+
+protected:
+  /** Quarter wave sine table (65 entries, Q1.15). */
+  static const int16_t SIN_TAB[] PROGMEM;
+
+  /** Arc tangent table for 0..1 (33 entries, binary units). */
+  static const uint16_t ATAN_TAB[] PROGMEM;
+
+  /** Reciprocal seed table for 0.5..1 (16 entries, Q1.15). */
+  static const uint16_t RECIP_TAB[] PROGMEM;
+};
+
+#endif
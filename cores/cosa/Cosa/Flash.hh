@@ -22,6 +22,8 @@
 #define COSA_FLASH_HH
 
 #include "Cosa/Types.h"
+#include "Cosa/Job.hh"
+#include "Cosa/Event.hh"
 
 class Flash {
 public:
@@ -55,9 +57,33 @@ public:
       SECTOR_BYTES(bytes),
       SECTOR_MASK(bytes - 1),
       SECTOR_MAX(count),
-      DEVICE_BYTES(count * bytes)
+      DEVICE_BYTES(count * bytes),
+      m_async(false)
     {}
 
+    /**
+     * Set asynchronous mode. In asynchronous mode erase and write
+     * return when the operation has been issued and do not wait for
+     * the device to become ready. The next operation will wait for
+     * the device. Use Flash::Completion to receive an event when the
+     * operation has completed.
+     * @param[in] flag asynchronous mode.
+     */
+    void async(bool flag)
+    {
+      m_async = flag;
+    }
+
+    /**
+     * Return true(1) if the device is in asynchronous mode otherwise
+     * false(0).
+     * @return bool.
+     */
+    bool is_async() const
+    {
+      return (m_async);
+    }
+
     /**
      * @override{Flash::Device}
      * Initiate the flash memory device driver. Return true(1) if the
@@ -135,6 +161,267 @@ public:
      * @return number of bytes written or EOF(-1).
      */
     virtual int write_P(uint32_t dest, const void* scr, size_t size) = 0;
+
+    /**
+     * @override{Flash::Device}
+     * Write buffered data to the flash memory. Default implementation
+     * is unbuffered. Returns zero(0) if successful otherwise a
+     * negative error code.
+     * @return zero or negative error code.
+     */
+    virtual int flush()
+    {
+      return (0);
+    }
+
+  protected:
+    /** Asynchronous mode; erase and write do not wait for completion. */
+    bool m_async;
+
+    /**
+     * Wait for a pending operation to complete in asynchronous mode.
+     */
+    void await()
+    {
+      if (!m_async) return;
+      while (!is_ready()) yield();
+    }
+  };
+
+  /**
+   * Flash memory device completion monitor. Polls the device status
+   * with the given period and pushes a write completed event to the
+   * target event handler when the device is ready. Used with the
+   * device in asynchronous mode so that erase and write may overlap
+   * other work.
+   * @code
+   * Watchdog::Scheduler scheduler;
+   * S25FL127S flash;
+   * Flash::Completion completion(&scheduler, &flash, &handler, 16);
+   * ...
+   * flash.async(true);
+   * flash.erase(dest, 64);
+   * completion.begin();
+   * ...
+   * void Handler::on_event(uint8_t type, uint16_t value)
+   * {
+   *   if (type == Event::WRITE_COMPLETED_TYPE) ...
+   * }
+   * @endcode
+   */
+  class Completion : public Job {
+  public:
+    /**
+     * Construct completion monitor for the given flash memory device
+     * and event handler. The status poll period is in the time unit
+     * of the scheduler.
+     * @param[in] scheduler for status poll.
+     * @param[in] dev flash memory device.
+     * @param[in] target event handler.
+     * @param[in] period of status poll.
+     */
+    Completion(Job::Scheduler* scheduler, Device* dev,
+	       Event::Handler* target, uint16_t period) :
+      Job(scheduler),
+      m_dev(dev),
+      m_target(target),
+      m_period(period)
+    {}
+
+    /**
+     * Start polling the device status. The completion event is pushed
+     * directly if the device is ready. Returns true(1) if successful
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool begin()
+    {
+      if (is_started()) return (false);
+      if (m_dev->is_ready()) return (complete());
+      expire_at(time() + m_period);
+      return (start());
+    }
+
+  protected:
+    /** Flash memory device. */
+    Device* m_dev;
+
+    /** Event handler for completion event. */
+    Event::Handler* m_target;
+
+    /** Status poll period. */
+    uint16_t m_period;
+
+    /**
+     * @override{Job}
+     * Poll the device status. Push the completion event if the device
+     * is ready otherwise reschedule.
+     */
+    virtual void run()
+    {
+      if (m_dev->is_ready()) {
+	complete();
+	return;
+      }
+      expire_after(m_period);
+      start();
+    }
+
+    /**
+     * Push write completed event to the target. Returns true(1) if
+     * successful otherwise false(0).
+     * @return bool.
+     */
+    bool complete()
+    {
+      return (Event::push(Event::WRITE_COMPLETED_TYPE, m_target, m_dev));
+    }
+  };
+
+  /**
+   * Write combining flash memory device. Writes to the same page are
+   * collected in a page buffer and programmed with a single page
+   * program when the write reaches the end of the page, a write to
+   * another page or erase is issued, or on flush(). Read merges the
+   * buffered data. Requires a page buffer (PAGE_MAX bytes) in data
+   * memory.
+   * @code
+   * S25FL127S flash;
+   * Flash::Buffered device(&flash);
+   * ...
+   * CFFS::begin(&device);
+   * @endcode
+   */
+  class Buffered : public Device {
+  public:
+    /** Page size (program block) in bytes. */
+    static const size_t PAGE_MAX = 256;
+
+    /** Page address mask. */
+    static const uint32_t PAGE_MASK = (PAGE_MAX - 1);
+
+    /**
+     * Construct write combining device for the given flash memory
+     * device.
+     * @param[in] dev flash memory device.
+     */
+    Buffered(Device* dev) :
+      Device(dev->SECTOR_BYTES, dev->SECTOR_MAX),
+      m_dev(dev),
+      m_page(0L),
+      m_low(PAGE_MAX),
+      m_high(0)
+    {}
+
+    /**
+     * @override{Flash::Device}
+     * Initiate the flash memory device. Return true(1) if the
+     * successful otherwise false(0).
+     * @return bool.
+     */
+    virtual bool begin()
+    {
+      return (m_dev->begin());
+    }
+
+    /**
+     * @override{Flash::Device}
+     * Flush buffered data and terminate the flash memory device.
+     * Return true(1) if the successful otherwise false(0).
+     * @return bool.
+     */
+    virtual bool end()
+    {
+      if (flush() != 0) return (false);
+      return (m_dev->end());
+    }
+
+    /**
+     * @override{Flash::Device}
+     * Return true(1) if the device is ready, write cycle is completed,
+     * otherwise false(0).
+     * @return bool.
+     */
+    virtual bool is_ready()
+    {
+      return (m_dev->is_ready());
+    }
+
+    /**
+     * @override{Flash::Device}
+     * Read flash block with the given size into the buffer from the
+     * source address. Buffered data is merged. Return number of bytes
+     * read or negative error code.
+     * @param[in] dest buffer to read from flash into.
+     * @param[in] src address in flash to read from.
+     * @param[in] size number of bytes to read.
+     * @return number of bytes or negative error code.
+     */
+    virtual int read(void* dest, uint32_t src, size_t size);
+
+    /**
+     * @override{Flash::Device}
+     * Flush buffered data and erase given flash block. Returs zero(0)
+     * if successful otherwise an negative error code.
+     * @param[in] dest destination block byte address to erase.
+     * @param[in] size of sector to erase in Kbyte.
+     * @return zero or negative error code.
+     */
+    virtual int erase(uint32_t dest, uint8_t size);
+
+    /**
+     * @override{Flash::Device}
+     * Write given source buffer to the page buffer. Return number of
+     * bytes written or negative error code.
+     * @param[in] dest address in flash to write to.
+     * @param[in] src buffer to write to flash.
+     * @param[in] size number of bytes to write.
+     * @return number of bytes or negative error code.
+     */
+    virtual int write(uint32_t dest, const void* src, size_t size)
+    {
+      return (write(dest, src, size, false));
+    }
+
+    /**
+     * @override{Flash::Device}
+     * Write given source buffer in program memory to the page
+     * buffer. Return number of bytes written or negative error code.
+     * @param[in] dest address in flash to write to.
+     * @param[in] src buffer in program memory to write to flash.
+     * @param[in] size number of bytes to write.
+     * @return number of bytes written or negative error code.
+     */
+    virtual int write_P(uint32_t dest, const void* src, size_t size)
+    {
+      return (write(dest, src, size, true));
+    }
+
+    /**
+     * @override{Flash::Device}
+     * Program the buffered page data. Returns zero(0) if successful
+     * otherwise a negative error code.
+     * @return zero or negative error code.
+     */
+    virtual int flush();
+
+  protected:
+    Device* m_dev;		//!< Flash memory device.
+    uint32_t m_page;		//!< Address of buffered page.
+    uint16_t m_low;		//!< Start of buffered data in page.
+    uint16_t m_high;		//!< End of buffered data in page.
+    uint8_t m_buf[PAGE_MAX];	//!< Page buffer.
+
+    /**
+     * Write given source buffer in data or program memory to the page
+     * buffer. Return number of bytes written or negative error code.
+     * @param[in] dest address in flash to write to.
+     * @param[in] src buffer to write to flash.
+     * @param[in] size number of bytes to write.
+     * @param[in] progmem from data(false) or program memory(true).
+     * @return number of bytes written or negative error code.
+     */
+    int write(uint32_t dest, const void* src, size_t size, bool progmem);
   };
 };
 
@@ -0,0 +1,102 @@
+/**
+ * @file Cosa/Flash_Buffered.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Flash.hh"
+#include <avr/pgmspace.h>
+
+int
+Flash::Buffered::read(void* dest, uint32_t src, size_t size)
+{
+  // Read from the device
+  int res = m_dev->read(dest, src, size);
+  if (UNLIKELY(res <= 0) || (m_low >= m_high)) return (res);
+
+  // Merge buffered data in the read block
+  uint32_t low = m_page + m_low;
+  uint32_t high = m_page + m_high;
+  uint32_t begin = src;
+  uint32_t end = src + res;
+  if ((end <= low) || (begin >= high)) return (res);
+  if (begin < low) begin = low;
+  if (end > high) end = high;
+
+  // Programming may only clear bits
+  uint8_t* dp = (uint8_t*) dest + (begin - src);
+  uint8_t* bp = m_buf + (begin - m_page);
+  for (uint16_t n = end - begin; n != 0; n--) *dp++ &= *bp++;
+  return (res);
+}
+
+int
+Flash::Buffered::erase(uint32_t dest, uint8_t size)
+{
+  if (flush() != 0) return (EIO);
+  return (m_dev->erase(dest, size));
+}
+
+int
+Flash::Buffered::flush()
+{
+  // Check for buffered data
+  if (m_low >= m_high) return (0);
+
+  // Program the buffered data with a single page program
+  size_t count = m_high - m_low;
+  int res = m_dev->write(m_page + m_low, m_buf + m_low, count);
+  m_low = PAGE_MAX;
+  m_high = 0;
+  return (res == (int) count ? 0 : EIO);
+}
+
+int
+Flash::Buffered::write(uint32_t dest, const void* src, size_t size,
+		       bool progmem)
+{
+  const uint8_t* sp = (const uint8_t*) src;
+  int res = (int) size;
+
+  while (size != 0) {
+    // Flush the page buffer if the write is to another page
+    uint32_t page = dest & ~PAGE_MASK;
+    if (page != m_page) {
+      if (flush() != 0) return (EIO);
+      m_page = page;
+    }
+
+    // Clear page buffer when starting a new fill
+    if (m_low >= m_high) memset(m_buf, 0xff, sizeof(m_buf));
+
+    // Merge data into page buffer; programming may only clear bits
+    uint16_t offset = dest & PAGE_MASK;
+    size_t count = PAGE_MAX - offset;
+    if (count > size) count = size;
+    uint8_t* bp = m_buf + offset;
+    for (size_t n = count; n != 0; n--, sp++)
+      *bp++ &= (progmem ? pgm_read_byte(sp) : *sp);
+    if (offset < m_low) m_low = offset;
+    if (offset + count > m_high) m_high = offset + count;
+
+    // Program the page when the write reaches the end of the page
+    if ((offset + count == PAGE_MAX) && (flush() != 0)) return (EIO);
+    dest += count;
+    size -= count;
+  }
+  return (res);
+}
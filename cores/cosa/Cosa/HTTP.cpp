@@ -0,0 +1,309 @@
+/**
+ * @file Cosa/HTTP.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/HTTP.hh"
+#include <ctype.h>
+
+// Method names; index is HTTP::Method
+static const char GET_NAME[] __PROGMEM = "GET";
+static const char HEAD_NAME[] __PROGMEM = "HEAD";
+static const char POST_NAME[] __PROGMEM = "POST";
+static const char PUT_NAME[] __PROGMEM = "PUT";
+static const char DELETE_NAME[] __PROGMEM = "DELETE";
+static const str_P METHOD_NAME[] __PROGMEM = {
+  (str_P) GET_NAME,
+  (str_P) HEAD_NAME,
+  (str_P) POST_NAME,
+  (str_P) PUT_NAME,
+  (str_P) DELETE_NAME
+};
+
+// Header names handled by the parser (lower case)
+static const char CONTENT_LENGTH_NAME[] __PROGMEM = "content-length";
+
+// End of line and last chunk
+static const char CRLF[] __PROGMEM = "\r\n";
+static const char LAST_CHUNK[] __PROGMEM = "0\r\n\r\n";
+
+HTTP::Server::Server(IOStream& ios, const route_t* routes, const str_P* headers) :
+  INET::Server(ios),
+  m_routes(routes),
+  m_route_count(0),
+  m_headers(headers),
+  m_header_count(0)
+{
+  while ((m_route_count < ROUTE_MAX)
+	 && (pgm_read_word(&routes[m_route_count].path) != 0))
+    m_route_count += 1;
+  if (headers != NULL) {
+    while ((m_header_count < HEADER_MAX)
+	   && (pgm_read_word(&headers[m_header_count]) != 0))
+      m_header_count += 1;
+  }
+  reset();
+}
+
+void
+HTTP::Server::on_connect(IOStream& ios)
+{
+  UNUSED(ios);
+  reset();
+}
+
+void
+HTTP::Server::on_request(IOStream& ios)
+{
+  Socket* sock = socket();
+  uint8_t buf[BUFFER_MAX];
+  int count;
+
+  // Parse the received bytes; stream body and respond when complete
+  while ((count = sock->read(buf, sizeof(buf))) > 0) {
+    const uint8_t* bp = buf;
+    while (count > 0) {
+      if (m_state != BODY_STATE) {
+	parse(*bp++);
+	count -= 1;
+      }
+      else {
+	size_t size = count;
+	if (m_remaining < size) size = m_remaining;
+	on_body(m_route, bp, size);
+	bp += size;
+	count -= size;
+	m_remaining -= size;
+      }
+      if ((m_state == BODY_STATE) && (m_remaining == 0)) {
+	on_response(m_route, ios);
+	reset();
+      }
+    }
+  }
+}
+
+void
+HTTP::Server::response(uint16_t status, str_P reason, str_P type, int32_t length)
+{
+  m_ios << PSTR("HTTP/1.1 ") << dec << status << ' ' << reason << (str_P) CRLF;
+  if (type != NULL)
+    m_ios << PSTR("Content-Type: ") << type << (str_P) CRLF;
+  if (length < 0)
+    m_ios << PSTR("Transfer-Encoding: chunked") << (str_P) CRLF;
+  else
+    m_ios << PSTR("Content-Length: ") << length << (str_P) CRLF;
+  m_ios << (str_P) CRLF;
+}
+
+void
+HTTP::Server::chunk(const void* buf, size_t size, bool progmem)
+{
+  if (UNLIKELY(size == 0)) return;
+  Socket* sock = socket();
+
+  // Chunk size line in hexadecimal
+  char line[sizeof(size) * 2 + 2];
+  char* bp = &line[sizeof(line)];
+  *--bp = '\n';
+  *--bp = '\r';
+  size_t n = size;
+  do {
+    *--bp = tohex(n);
+    n >>= 4;
+  } while (n != 0);
+  sock->write(bp, &line[sizeof(line)] - bp);
+
+  // Chunk data and end of line
+  sock->write(buf, size, progmem);
+  sock->write(CRLF, sizeof(CRLF) - 1, true);
+}
+
+void
+HTTP::Server::chunk_end()
+{
+  socket()->write(LAST_CHUNK, sizeof(LAST_CHUNK) - 1, true);
+}
+
+void
+HTTP::Server::reset()
+{
+  m_state = METHOD_STATE;
+  m_method = UNKNOWN_METHOD;
+  m_route = NOT_FOUND;
+  m_pos = 0;
+  m_match = (1U << membersof(METHOD_NAME)) - 1;
+  m_prefix = 0;
+  m_header = NOT_FOUND;
+  m_length = 0;
+  m_remaining = 0;
+  m_query[0] = 0;
+  m_query_len = 0;
+  m_value_len = 0;
+  memset(m_offset, NO_VALUE, sizeof(m_offset));
+}
+
+void
+HTTP::Server::next_header()
+{
+  uint16_t headers = 0;
+  if (m_route != NOT_FOUND) {
+    headers = pgm_read_byte(&m_routes[m_route].headers);
+    headers &= (1U << m_header_count) - 1;
+  }
+  m_match = headers | (1U << CONTENT_LENGTH);
+  m_header = NOT_FOUND;
+  m_state = NAME_STATE;
+  m_pos = 0;
+}
+
+str_P
+HTTP::Server::name(uint8_t ix) const
+{
+  switch (m_state) {
+  case METHOD_STATE:
+    return ((str_P) pgm_read_word(&METHOD_NAME[ix]));
+  case PATH_STATE:
+    return ((str_P) pgm_read_word(&m_routes[ix].path));
+  default:
+    if (ix == CONTENT_LENGTH) return ((str_P) CONTENT_LENGTH_NAME);
+    return ((str_P) pgm_read_word(&m_headers[ix]));
+  }
+}
+
+void
+HTTP::Server::match(char c)
+{
+  bool nocase = (m_state == NAME_STATE);
+  if (nocase) c = tolower(c);
+  for (uint8_t ix = 0; (ix < 16) && ((m_match >> ix) != 0); ix++) {
+    uint16_t bit = (1U << ix);
+    if ((m_match & bit) == 0) continue;
+    char n = pgm_read_byte((const char*) name(ix) + m_pos);
+    if ((m_state == PATH_STATE) && (n == '*')) {
+      m_prefix |= bit;
+      m_match &= ~bit;
+      continue;
+    }
+    if (nocase) n = tolower(n);
+    if (n != c) m_match &= ~bit;
+  }
+  if (m_pos < UINT8_MAX) m_pos += 1;
+}
+
+uint8_t
+HTTP::Server::resolve()
+{
+  // Check for candidate with the whole token; or prefix for paths
+  for (uint8_t ix = 0; (ix < 16) && ((m_match >> ix) != 0); ix++) {
+    if ((m_match & (1U << ix)) == 0) continue;
+    char n = pgm_read_byte((const char*) name(ix) + m_pos);
+    if ((n == 0) || ((m_state == PATH_STATE) && (n == '*'))) return (ix);
+  }
+  if (m_state != PATH_STATE) return (NOT_FOUND);
+  for (uint8_t ix = 0; (ix < 16) && ((m_prefix >> ix) != 0); ix++)
+    if ((m_prefix & (1U << ix)) != 0) return (ix);
+  return (NOT_FOUND);
+}
+
+void
+HTTP::Server::parse(char c)
+{
+  switch (m_state) {
+
+  // Request line; method, path, query and version
+  case METHOD_STATE:
+    if ((m_pos == 0) && ((c == '\r') || (c == '\n'))) return;
+    if (c == ' ') {
+      uint8_t ix = resolve();
+      m_method = (ix == NOT_FOUND) ? UNKNOWN_METHOD : (Method) ix;
+      m_match = 0;
+      for (ix = 0; ix < m_route_count; ix++) {
+	uint8_t method = pgm_read_byte(&m_routes[ix].method);
+	if ((method == ANY_METHOD) || (method == m_method))
+	  m_match |= (1U << ix);
+      }
+      m_state = PATH_STATE;
+      m_pos = 0;
+    }
+    else match(c);
+    return;
+  case PATH_STATE:
+    if ((c == ' ') || (c == '?')) {
+      m_route = resolve();
+      m_state = (c == '?') ? QUERY_STATE : VERSION_STATE;
+    }
+    else match(c);
+    return;
+  case QUERY_STATE:
+    if (c == ' ') {
+      m_state = VERSION_STATE;
+    }
+    else if (m_query_len < sizeof(m_query) - 1) {
+      m_query[m_query_len++] = c;
+      m_query[m_query_len] = 0;
+    }
+    return;
+  case VERSION_STATE:
+    if (c == '\n') next_header();
+    return;
+
+  // Header section; empty line is end of section
+  case NAME_STATE:
+    if (c == '\r') return;
+    if (c == '\n') {
+      if (m_pos != 0) {
+	next_header();
+	return;
+      }
+      m_remaining = m_length;
+      m_state = BODY_STATE;
+      return;
+    }
+    if (c == ':') {
+      m_header = resolve();
+      if (m_header < HEADER_MAX) m_offset[m_header] = m_value_len;
+      m_state = VALUE_STATE;
+      m_pos = 0;
+      return;
+    }
+    match(c);
+    return;
+  case VALUE_STATE:
+    if (c == '\r') return;
+    if (c == '\n') {
+      if (m_header < HEADER_MAX) {
+	m_value[m_value_len] = 0;
+	if (m_value_len < sizeof(m_value) - 1) m_value_len += 1;
+      }
+      next_header();
+      return;
+    }
+    if ((m_pos == 0) && ((c == ' ') || (c == '\t'))) return;
+    m_pos = 1;
+    if (m_header == CONTENT_LENGTH) {
+      if ((c >= '0') && (c <= '9')) m_length = (m_length * 10) + (c - '0');
+    }
+    else if ((m_header < HEADER_MAX) && (m_value_len < sizeof(m_value) - 1)) {
+      m_value[m_value_len++] = c;
+    }
+    return;
+  default:
+    return;
+  }
+}
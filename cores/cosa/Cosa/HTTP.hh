@@ -0,0 +1,353 @@
+/**
+ * @file Cosa/HTTP.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_HTTP_HH
+#define COSA_HTTP_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/INET.hh"
+#include "Cosa/Socket.hh"
+
+// Default size of query string buffer
+#ifndef COSA_HTTP_QUERY_MAX
+# define COSA_HTTP_QUERY_MAX 32
+#endif
+
+// Default size of captured header value buffer
+#ifndef COSA_HTTP_VALUE_MAX
+# define COSA_HTTP_VALUE_MAX 48
+#endif
+
+/**
+ * Hypertext Transfer Protocol (HTTP/1.1) request handling.
+ */
+class HTTP {
+public:
+  /** Request methods. */
+  enum Method {
+    GET = 0,
+    HEAD,
+    POST,
+    PUT,
+    DELETE,
+    ANY_METHOD,			//!< Route; any method.
+    UNKNOWN_METHOD = ANY_METHOD	//!< Request; not supported.
+  } __attribute__((packed));
+
+  /**
+   * Route table entry (program memory). The table is terminated by
+   * an entry with NULL path. A path ending with an asterisk matches
+   * any remaining path. The headers bitset selects the headers (index
+   * in the server header name table) that should be captured for the
+   * route.
+   */
+  struct route_t {
+    str_P path;			//!< Path (program memory string).
+    uint8_t method;		//!< Method or ANY_METHOD.
+    uint8_t headers;		//!< Captured headers; bitset.
+  };
+
+  /**
+   * HTTP server. Incremental request parser; the request is parsed
+   * as the bytes are received from the socket. The request method
+   * and path are matched against the route table, and only the
+   * headers requested by the route are captured (no line buffers).
+   * The request body (Content-Length) is streamed to on_body(). The
+   * response is written directly to the socket; optionally with
+   * chunked transfer encoding.
+   *
+   * @section Usage
+   * @code
+   * static const char root_path[] __PROGMEM = "/";
+   * static const char led_path[] __PROGMEM = "/led/*";
+   * static const HTTP::route_t routes[] __PROGMEM = {
+   *   { (str_P) root_path, HTTP::GET, 0 },
+   *   { (str_P) led_path, HTTP::ANY_METHOD, _BV(0) },
+   *   { NULL, 0, 0 }
+   * };
+   * static const char host[] __PROGMEM = "Host";
+   * static const str_P headers[] __PROGMEM = { (str_P) host, NULL };
+   *
+   * class WebServer : public HTTP::Server {
+   * public:
+   *   WebServer(IOStream& ios) : HTTP::Server(ios, routes, headers) {}
+   *   virtual void on_response(uint8_t route, IOStream& ios);
+   * };
+   * @endcode
+   */
+  class Server : public INET::Server {
+  public:
+    /** Route index for no matching route. */
+    static const uint8_t NOT_FOUND = 0xff;
+
+    /** Max number of routes. */
+    static const uint8_t ROUTE_MAX = 16;
+
+    /** Max number of captured headers. */
+    static const uint8_t HEADER_MAX = 8;
+
+    /**
+     * Construct HTTP server with given io-stream, route table and
+     * header name table (program memory). The header name table is a
+     * vector of program memory strings terminated by NULL. The header
+     * names are matched case insensitive.
+     * @param[in] ios associated io-stream.
+     * @param[in] routes route table.
+     * @param[in] headers header name table (default none).
+     */
+    Server(IOStream& ios, const route_t* routes, const str_P* headers = NULL);
+
+    /**
+     * Return request method.
+     * @return method.
+     */
+    Method method() const
+    {
+      return (m_method);
+    }
+
+    /**
+     * Return request query string (after question mark), possibly
+     * truncated to COSA_HTTP_QUERY_MAX - 1 characters.
+     * @return query string.
+     */
+    const char* query() const
+    {
+      return (m_query);
+    }
+
+    /**
+     * Return value of captured header with given index in the header
+     * name table, possibly truncated, or NULL if not present or not
+     * captured by the route.
+     * @param[in] ix header index.
+     * @return header value or NULL.
+     */
+    const char* header(uint8_t ix) const
+    {
+      if (UNLIKELY((ix >= HEADER_MAX) || (m_offset[ix] == NO_VALUE)))
+	return (NULL);
+      return (&m_value[m_offset[ix]]);
+    }
+
+    /**
+     * Return request body length (Content-Length).
+     * @return length.
+     */
+    uint32_t content_length() const
+    {
+      return (m_length);
+    }
+
+    /**
+     * Write response status line with given status code and reason
+     * phrase, and the content type header. Use chunked transfer
+     * encoding if the content length is negative otherwise write the
+     * content length header. The header section is terminated.
+     * @param[in] status code.
+     * @param[in] reason phrase (program memory string).
+     * @param[in] type content type (program memory string or NULL).
+     * @param[in] length content length or negative for chunked.
+     */
+    void response(uint16_t status, str_P reason,
+		  str_P type = NULL, int32_t length = -1);
+
+    /**
+     * Write chunk with given buffer and size directly to the socket.
+     * Empty chunks are ignored.
+     * @param[in] buf buffer to write.
+     * @param[in] size number of bytes.
+     * @param[in] progmem flag; buffer in program memory.
+     */
+    void chunk(const void* buf, size_t size, bool progmem = false);
+
+    /**
+     * Write chunk with given string in program memory.
+     * @param[in] s string.
+     */
+    void chunk(str_P s)
+    {
+      chunk(s, strlen_P((const char*) s), true);
+    }
+
+    /**
+     * Write last chunk and terminate the chunked response.
+     */
+    void chunk_end();
+
+    /**
+     * @override{INET::Server}
+     * Reset the parser for a new connection.
+     * @param[in] ios iostream for response.
+     */
+    virtual void on_connect(IOStream& ios);
+
+    /**
+     * @override{INET::Server}
+     * Read available bytes from the socket and run the parser. Calls
+     * on_body() and on_response() as the request is received.
+     * @param[in] ios iostream for request and response.
+     */
+    virtual void on_request(IOStream& ios);
+
+    /**
+     * @override{HTTP::Server}
+     * Application extension; Called with body data as it is
+     * received for the matched route. Default is to ignore the data.
+     * @param[in] route index in route table or NOT_FOUND.
+     * @param[in] buf body data.
+     * @param[in] size number of bytes.
+     */
+    virtual void on_body(uint8_t route, const uint8_t* buf, size_t size)
+    {
+      UNUSED(route);
+      UNUSED(buf);
+      UNUSED(size);
+    }
+
+    /**
+     * @override{HTTP::Server}
+     * Application extension; Should implement the response when the
+     * request has been received. Method, query string, captured
+     * headers and content length are available.
+     * @param[in] route index in route table or NOT_FOUND.
+     * @param[in] ios iostream for response.
+     */
+    virtual void on_response(uint8_t route, IOStream& ios) = 0;
+
+  protected:
+    /** Parser state. */
+    enum State {
+      METHOD_STATE,		//!< Request method.
+      PATH_STATE,		//!< Request path.
+      QUERY_STATE,		//!< Query string.
+      VERSION_STATE,		//!< Protocol version.
+      NAME_STATE,		//!< Header name.
+      VALUE_STATE,		//!< Header value.
+      BODY_STATE		//!< Request body.
+    } __attribute__((packed));
+
+    /** Captured header index for no value. */
+    static const uint8_t NO_VALUE = 0xff;
+
+    /** Header name table index for Content-Length. */
+    static const uint8_t CONTENT_LENGTH = HEADER_MAX;
+
+    /** Size of socket read buffer. */
+    static const uint8_t BUFFER_MAX = 32;
+
+    /** Route table (program memory). */
+    const route_t* m_routes;
+
+    /** Number of routes. */
+    uint8_t m_route_count;
+
+    /** Header name table (program memory). */
+    const str_P* m_headers;
+
+    /** Number of header names. */
+    uint8_t m_header_count;
+
+    /** Parser state. */
+    State m_state;
+
+    /** Request method. */
+    Method m_method;
+
+    /** Matched route. */
+    uint8_t m_route;
+
+    /** Position in current token. */
+    uint8_t m_pos;
+
+    /** Candidates matching current token; bitset. */
+    uint16_t m_match;
+
+    /** Routes matched by path prefix (asterisk); bitset. */
+    uint16_t m_prefix;
+
+    /** Current header index. */
+    uint8_t m_header;
+
+    /** Request body length. */
+    uint32_t m_length;
+
+    /** Remaining request body length. */
+    uint32_t m_remaining;
+
+    /** Query string. */
+    char m_query[COSA_HTTP_QUERY_MAX];
+
+    /** Query string length. */
+    uint8_t m_query_len;
+
+    /** Captured header values. */
+    char m_value[COSA_HTTP_VALUE_MAX];
+
+    /** Captured header values length. */
+    uint8_t m_value_len;
+
+    /** Captured header value offset per header name index. */
+    uint8_t m_offset[HEADER_MAX];
+
+    /**
+     * Reset parser for next request.
+     */
+    void reset();
+
+    /**
+     * Parse given character in request line or header section.
+     * @param[in] c character.
+     */
+    void parse(char c);
+
+    /**
+     * Start matching of next header name. The candidates are the
+     * headers captured by the matched route and Content-Length.
+     */
+    void next_header();
+
+    /**
+     * Return name of candidate with given index for the current
+     * token; method name, route path or header name.
+     * @param[in] ix candidate index.
+     * @return name in program memory.
+     */
+    str_P name(uint8_t ix) const;
+
+    /**
+     * Eliminate candidates that do not match the given character at
+     * the current token position. Header names are matched case
+     * insensitive. Routes with an asterisk at the position are moved
+     * to the prefix matches.
+     * @param[in] c character.
+     */
+    void match(char c);
+
+    /**
+     * Return index of the first candidate that matches the whole
+     * current token or NOT_FOUND.
+     * @return index or NOT_FOUND.
+     */
+    uint8_t resolve();
+  };
+};
+
+#endif
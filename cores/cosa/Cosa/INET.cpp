@@ -124,28 +124,91 @@ INET::print_addr(IOStream& outs, const uint8_t* addr, uint16_t port)
   outs << ':' << port;
 }
 
-uint16_t
-INET::checksum(const void* buf, size_t count)
+/**
+ * Add given buffer as 16-bit numbers to the given one-complement
+ * sum. The numbers are added in processor order (little-endian).
+ * The byte order is swapped when the sum is completed (RFC 1071,
+ * byte order independence). Returns the new sum.
+ * @param[in] sum accumulated sum.
+ * @param[in] bp pointer to buffer.
+ * @param[in] count number of bytes (even).
+ * @return sum.
+ */
+static uint32_t
+checksum_sum(uint32_t sum, const uint8_t* bp, size_t count)
 {
-  // Based on the C-code given in RFC 1071 (Computing the Internet
-  // Checksum by R. Braden, D. Borman, and C. Partridge, 1988).
-  const uint16_t* bp = (const uint16_t*) buf;
-  uint32_t sum = 0L;
+  const uint16_t* wp = (const uint16_t*) bp;
 
-  // Sum up the buffer as 16-bit numbers
+  // Sum up the buffer as 16-bit numbers; unrolled loop
+  while (count >= 8) {
+    sum += *wp++;
+    sum += *wp++;
+    sum += *wp++;
+    sum += *wp++;
+    count -= 8;
+  }
   while (count > 1) {
-    sum += ntoh(*bp++);
+    sum += *wp++;
     count -= 2;
   }
+  return (sum);
+}
 
-  // Add last byte if odd number of bytes
-  if (count > 0)
-    sum += *(const uint8_t*) bp;
-
+/**
+ * Complete the one-complement sum; add carry bits, swap to network
+ * order and return the one-complement.
+ * @param[in] sum accumulated sum.
+ * @return checksum.
+ */
+static uint16_t
+checksum_end(uint32_t sum)
+{
   // Add carry bits
   while (sum >> 16)
     sum = (sum & 0xffff) + (sum >> 16);
 
-  // And return the one-complement of the sum
-  return (~sum);
+  // And return the one-complement of the sum (in host order)
+  uint16_t res = sum;
+  return (~swap(res));
+}
+
+uint16_t
+INET::checksum(const void* buf, size_t count)
+{
+  // Based on the C-code given in RFC 1071 (Computing the Internet
+  // Checksum by R. Braden, D. Borman, and C. Partridge, 1988).
+  const uint8_t* bp = (const uint8_t*) buf;
+  uint32_t sum = checksum_sum(0L, bp, count);
+
+  // Add last byte if odd number of bytes; pad with zero
+  if (count & 1) sum += bp[count - 1];
+
+  return (checksum_end(sum));
+}
+
+uint16_t
+INET::checksum(const iovec_t* vec)
+{
+  uint32_t sum = 0L;
+  bool odd = false;
+  for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+    const uint8_t* bp = (const uint8_t*) vp->buf;
+    size_t count = vp->size;
+    if (count == 0) continue;
+
+    // Complete word from previous buffer with odd number of bytes
+    if (odd) {
+      sum += ((uint16_t) *bp++) << 8;
+      count -= 1;
+      odd = false;
+    }
+
+    // Sum up words and keep track of odd byte
+    sum = checksum_sum(sum, bp, count);
+    if (count & 1) {
+      sum += bp[count - 1];
+      odd = true;
+    }
+  }
+  return (checksum_end(sum));
 }
@@ -23,6 +23,7 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
+#include "Cosa/Pool.hh"
 
 /**
  * Communication domain.
@@ -176,6 +177,35 @@ public:
    */
   static uint16_t checksum(const void* buf, size_t count);
 
+  /**
+   * Calculate Internet Checksum for given null terminated io vector
+   * buffers. Buffers may have odd number of bytes; the checksum is
+   * the same as for the concatenated buffers. Return check sum.
+   * @param[in] vec io vector with buffers in network order.
+   * @return checksum.
+   */
+  static uint16_t checksum(const iovec_t* vec);
+
+  /**
+   * Incremental update of Internet Checksum when a 16-bit field in the
+   * checksummed data is changed from the given old to the new value
+   * (RFC 1624, eqn. 3). Values in host order as the checksum. Return
+   * updated check sum.
+   * @param[in] sum checksum.
+   * @param[in] old field value.
+   * @param[in] value new field value.
+   * @return checksum.
+   */
+  static uint16_t checksum(uint16_t sum, uint16_t old, uint16_t value)
+  {
+    uint32_t res = (uint16_t) ~sum;
+    res += (uint16_t) ~old;
+    res += value;
+    res = (res & 0xffff) + (res >> 16);
+    res = (res & 0xffff) + (res >> 16);
+    return (~res);
+  }
+
   /**
    * Server request handler. Should be sub-classed and the virtual
    * member function on_request() should be implemented to receive
@@ -191,7 +221,10 @@ public:
      */
     Server(IOStream& ios) :
       m_ios(ios),
-      m_connected(false)
+      m_connected(false),
+      m_idle(0L),
+      m_active(0L),
+      m_next(NULL)
     {}
 
     /**
@@ -230,6 +263,29 @@ public:
      */
     virtual int run(uint32_t ms = 0L);
 
+    /**
+     * @override{INET::Server}
+     * Service incoming client connect request or data without
+     * waiting. Returns one(1) if a connect request or data was
+     * handled, zero(0) if there was nothing to handle, otherwise a
+     * negative error code (the connection was closed and the socket
+     * is listening again).
+     * @return one, zero or negative error code.
+     */
+    virtual int poll();
+
+    /**
+     * Set keep-alive idle period. A connection without requests for
+     * the given period is closed by poll() so that the socket can be
+     * reused. Zero period (default) keeps the connection until the
+     * client disconnects.
+     * @param[in] ms idle period (milli-seconds).
+     */
+    void keep_alive(uint32_t ms)
+    {
+      m_idle = ms;
+    }
+
     /**
      * @override{INET::Server}
      * Stop server and close socket. Returns true if successful
@@ -282,7 +338,156 @@ public:
 
     /** State variable; listening/disconnect(false), connected(true). */
     bool m_connected;
+
+    /** Keep-alive idle period (ms). Zero for no idle timeout. */
+    uint32_t m_idle;
+
+    /** Time of latest request (ms). */
+    uint32_t m_active;
+
+    /** Next server in pool. */
+    Server* m_next;
+
+    /**
+     * Close the connection and restart listen mode.
+     */
+    void disconnect();
+
+  public:
+    /**
+     * Pool of servers; serve several concurrent connections. Each
+     * server is bound to a socket listening on the same port. The
+     * servers are polled in turn and dispatch on_accept, on_request
+     * and on_disconnect when their connection requires it.
+     * @code
+     * WebServer server[W5100::SOCK_MAX - 1];
+     * INET::Server::Pool pool;
+     * ...
+     * for (uint8_t i = 0; i < membersof(server); i++) {
+     *   server[i].begin(ethernet.socket(Socket::TCP, 80));
+     *   pool.add(&server[i]);
+     * }
+     * ...
+     * pool.run();
+     * @endcode
+     */
+    class Pool {
+    public:
+      /**
+       * Construct empty server pool.
+       */
+      Pool() :
+	m_first(NULL)
+      {}
+
+      /**
+       * Add given server to the pool.
+       * @param[in] server to add.
+       */
+      void add(Server* server)
+      {
+	server->m_next = m_first;
+	m_first = server;
+      }
+
+      /**
+       * Poll the servers in the pool until at least one server has
+       * handled a connect request or data, or the given time period
+       * has expired. Zero time period will give blocking behavior.
+       * Returns number of servers that handled a connect request,
+       * data or disconnect.
+       * @param[in] ms timeout period (milli-seconds, default BLOCK(0L)).
+       * @return number of servers.
+       */
+      int run(uint32_t ms = 0L);
+
+    protected:
+      /** List of servers. */
+      Server* m_first;
+    };
+
+    /**
+     * Server with per-connection state allocated from a pool shared
+     * by all servers of the same type. The state is constructed when
+     * a connection is accepted and destructed on disconnect. A
+     * connection is refused when the pool is empty; several servers
+     * (sockets) may share fewer states. Sub-classes that override
+     * on_accept() and on_disconnect() should call the Session
+     * versions.
+     * @code
+     * struct request_t { char line[64]; uint8_t len; };
+     * class WebServer : public INET::Server::Session<request_t, 2> {
+     *   ...
+     *   virtual void on_request(IOStream& ios)
+     *   {
+     *     request_t* req = state();
+     *     ...
+     *   }
+     * };
+     * WebServer server[W5100::SOCK_MAX - 1];
+     * @endcode
+     * @param[in] STATE connection state type.
+     * @param[in] N max number of concurrent connections.
+     */
+    template<class STATE, uint8_t N>
+    class Session;
   };
 };
 
+template<class STATE, uint8_t N>
+class INET::Server::Session : public INET::Server {
+public:
+  /**
+   * Construct server with per-connection state.
+   * @param[in] ios associated io-stream.
+   */
+  Session(IOStream& ios) :
+    Server(ios),
+    m_state(NULL)
+  {}
+
+  /**
+   * Return connection state or NULL if not connected.
+   * @return state.
+   */
+  STATE* state()
+  {
+    return (m_state);
+  }
+
+  /**
+   * @override{INET::Server}
+   * Allocate connection state. Return false(0) to refuse the
+   * connection if the pool is empty otherwise true(1).
+   * @param[in] ios iostream for response.
+   * @return bool.
+   */
+  virtual bool on_accept(IOStream& ios)
+  {
+    UNUSED(ios);
+    m_state = s_pool.create();
+    return (m_state != NULL);
+  }
+
+  /**
+   * @override{INET::Server}
+   * Release connection state.
+   */
+  virtual void on_disconnect()
+  {
+    s_pool.destroy(m_state);
+    m_state = NULL;
+  }
+
+protected:
+  /** Connection state pool. */
+  static ::Pool<STATE, N> s_pool;
+
+  /** Connection state. */
+  STATE* m_state;
+};
+
+template<class STATE, uint8_t N>
+::Pool<STATE, N> INET::Server::Session<STATE, N>::s_pool;
+
 #endif
@@ -50,42 +50,86 @@ INET::Server::run(uint32_t ms)
   Socket* sock = socket();
   if (UNLIKELY(sock == NULL)) return (ENOTSOCK);
 
-  // When not connected; Check incoming connect requests
+  // Wait for incoming connect request or data
   uint32_t start = Watchdog::millis();
   int res;
+  while ((res = poll()) == 0) {
+    if ((ms != 0L) && (Watchdog::since(start) >= ms))
+      return (m_connected ? 0 : ETIME);
+    yield();
+  }
+  return (res > 0 ? 0 : res);
+}
+
+int
+INET::Server::poll()
+{
+  // Sanity check server state
+  Socket* sock = socket();
+  if (UNLIKELY(sock == NULL)) return (ENOTSOCK);
+
+  // When not connected; Check incoming connect requests
   if (!m_connected) {
-    while (((res = sock->accept()) != 0) &&
-	   ((ms == 0L) || (Watchdog::since(start) < ms)))
-      yield();
-    if (res != 0) return (ETIME);
+    if (sock->accept() != 0) return (0);
     // Check if application accepts the connection
-    if (!on_accept(m_ios)) goto error;
+    if (!on_accept(m_ios)) {
+      disconnect();
+      return (ECONNREFUSED);
+    }
     // Run application connect
     on_connect(m_ios);
     // Flush response message
     sock->flush();
     m_connected = true;
-    return (0);
+    m_active = Watchdog::millis();
+    return (1);
   }
 
   // Client has been accepted; check for incoming requests
-  while (((res = sock->available()) == 0) &&
-	 ((ms == 0L) || (Watchdog::since(start) < ms)))
-    yield();
+  int res = sock->available();
+  if (res == 0) {
+    if ((m_idle == 0L) || (Watchdog::since(m_active) < m_idle)) return (0);
+    res = ETIME;
+  }
+
   // If a message is available call application request handling
   if (res > 0) {
     on_request(m_ios);
     res = sock->flush();
+    if (res == 0) {
+      m_active = Watchdog::millis();
+      return (1);
+    }
   }
-  if (res == 0) return (0);
 
- error:
   // Error handling; close and restart listen mode
+  disconnect();
+  return (res);
+}
+
+void
+INET::Server::disconnect()
+{
+  Socket* sock = socket();
   on_disconnect();
   m_connected = false;
   sock->disconnect();
   sock->listen();
-  return (res);
+}
+
+int
+INET::Server::Pool::run(uint32_t ms)
+{
+  uint32_t start = Watchdog::millis();
+  while (1) {
+    // Poll all servers in the pool
+    int count = 0;
+    for (Server* server = m_first; server != NULL; server = server->m_next)
+      if (server->poll() != 0) count += 1;
+    if (count != 0) return (count);
+    if ((ms != 0L) && (Watchdog::since(start) >= ms)) return (0);
+    yield();
+  }
 }
 
 bool
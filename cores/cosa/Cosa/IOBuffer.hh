@@ -24,17 +24,23 @@
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
 #include "Cosa/Power.hh"
+#include "Cosa/Ring.hh"
 
 /**
  * Circular buffer template class for IOStreams. May be used as a
  * string buffer device, or to connect different IOStreams. See
  * UART.hh for an example. Buffer size should be power of 2 and
- * max 32Kbyte.
+ * max 32Kbyte. The buffer index is 8-bit for buffers of max 256
+ * bytes and otherwise 16-bit. A 16-bit index is accessed with
+ * interrupts disabled when it may be updated by the other side of
+ * the buffer (e.g. an interrupt handler).
  * @param[in] SIZE number of bytes in buffer.
+ * @param[in] INDEX index type (default Ring::Index<SIZE>::type).
  */
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX = typename Ring::Index<SIZE>::type>
 class IOBuffer : public IOStream::Device {
   static_assert(SIZE && !(SIZE & (SIZE - 1)), "SIZE should be power of 2");
+  static_assert(SIZE - 1 <= (INDEX) -1, "INDEX too small for SIZE");
 public:
   /**
    * Constuct buffer object for stream operations.
@@ -52,7 +58,7 @@ public:
   bool is_empty()
     __attribute__((always_inline))
   {
-    return (m_head == m_tail);
+    return (Ring::load(m_head) == Ring::load(m_tail));
   }
 
   /**
@@ -62,7 +68,7 @@ public:
   bool is_full()
     __attribute__((always_inline))
   {
-    return (((m_head + 1) & MASK) == m_tail);
+    return (((Ring::load(m_head) + 1) & MASK) == Ring::load(m_tail));
   }
 
   /**
@@ -73,7 +79,7 @@ public:
   virtual int available()
     __attribute__((always_inline))
   {
-    return ((SIZE + m_head - m_tail) & MASK);
+    return ((SIZE + Ring::load(m_head) - Ring::load(m_tail)) & MASK);
   }
 
   /**
@@ -84,7 +90,7 @@ public:
   virtual int room()
     __attribute__((always_inline))
   {
-    return ((SIZE - m_head + m_tail - 1) & MASK);
+    return ((SIZE - Ring::load(m_head) + Ring::load(m_tail) - 1) & MASK);
   }
 
   /**
@@ -95,6 +101,21 @@ public:
    */
   virtual int putchar(char c);
 
+  /** Overloaded virtual member function write. */
+  using IOStream::Device::write;
+
+  /**
+   * @override{IOStream::Device}
+   * Write data from buffer with given size to buffer. The data is
+   * copied in at most two segments (wrap-around) and the buffer head
+   * is updated once. Returns number of bytes written (limited by
+   * room in buffer).
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes written.
+   */
+  virtual int write(const void* buf, size_t size);
+
   /**
    * @override{IOStream::Device}
    * Peek at the next character from buffer.
@@ -117,6 +138,77 @@ public:
    */
   virtual int getchar();
 
+  /** Overloaded virtual member function read. */
+  using IOStream::Device::read;
+
+  /**
+   * @override{IOStream::Device}
+   * Read data to given buffer with given size from buffer. The data
+   * is copied in at most two segments (wrap-around) and the buffer
+   * tail is updated once. Returns number of bytes read (limited by
+   * available data).
+   * @param[in] buf buffer to read into.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes read.
+   */
+  virtual int read(void* buf, size_t size);
+
+  /**
+   * Get the contiguous span of available data; from the tail to the
+   * head or the end of the buffer storage (wrap-around). Returns
+   * number of bytes in the span. The data should be consumed with
+   * consume() after it has been moved. Used to move data to another
+   * device without intermediate copy.
+   * @param[out] bp span pointer.
+   * @return number of bytes.
+   */
+  size_t span(const char*& bp)
+  {
+    INDEX pos = (m_tail + 1) & MASK;
+    uint16_t n = IOBuffer<SIZE, INDEX>::available();
+    if (n > SIZE - pos) n = SIZE - pos;
+    bp = &m_buffer[pos];
+    return (n);
+  }
+
+  /**
+   * Consume given number of bytes of the available data.
+   * @param[in] n number of bytes.
+   * @pre n <= span().
+   */
+  void consume(size_t n)
+  {
+    Ring::store(m_tail, (INDEX) ((m_tail + n) & MASK));
+  }
+
+  /**
+   * Get the contiguous span of room; from the head to the tail or
+   * the end of the buffer storage (wrap-around). Returns number of
+   * bytes in the span. The data written to the span should be
+   * committed with commit(). Used to move data from another device
+   * without intermediate copy.
+   * @param[out] bp span pointer.
+   * @return number of bytes.
+   */
+  size_t reserve(char*& bp)
+  {
+    INDEX pos = (m_head + 1) & MASK;
+    uint16_t n = IOBuffer<SIZE, INDEX>::room();
+    if (n > SIZE - pos) n = SIZE - pos;
+    bp = &m_buffer[pos];
+    return (n);
+  }
+
+  /**
+   * Commit given number of bytes written to the reserved span.
+   * @param[in] n number of bytes.
+   * @pre n <= reserve().
+   */
+  void commit(size_t n)
+  {
+    Ring::store(m_head, (INDEX) ((m_head + n) & MASK));
+  }
+
   /**
    * @override{IOStream::Device}
    * Wait for the buffer to become empty.
@@ -130,7 +222,7 @@ public:
   virtual void empty()
     __attribute__((always_inline))
   {
-    m_head = m_tail = 0;
+    synchronized m_head = m_tail = 0;
   }
 
   /**
@@ -143,39 +235,58 @@ public:
   }
 
 private:
-  static const uint16_t MASK = (SIZE - 1);
-  volatile uint16_t m_head;
-  volatile uint16_t m_tail;
+  static const INDEX MASK = (SIZE - 1);
+  volatile INDEX m_head;
+  volatile INDEX m_tail;
   char m_buffer[SIZE];
 };
 
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX>
 int
-IOBuffer<SIZE>::putchar(char c)
+IOBuffer<SIZE, INDEX>::putchar(char c)
 {
-  uint16_t next = (m_head + 1) & MASK;
-  if (UNLIKELY(next == m_tail)) return (IOStream::EOF);
+  INDEX next = (m_head + 1) & MASK;
+  if (UNLIKELY(next == Ring::load(m_tail))) return (IOStream::EOF);
   m_buffer[next] = c;
-  m_head = next;
+  Ring::store(m_head, next);
   return (c & 0xff);
 }
 
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX>
+int
+IOBuffer<SIZE, INDEX>::write(const void* buf, size_t size)
+{
+  // Limit to room in buffer
+  uint16_t n = IOBuffer<SIZE, INDEX>::room();
+  if (size < n) n = size;
+  if (UNLIKELY(n == 0)) return (0);
+
+  // Copy to the end of the buffer and wrap-around to the start
+  INDEX head = m_head;
+  Ring::write(m_buffer, SIZE, (head + 1) & MASK, (const char*) buf, n);
+
+  // Update head after the data is in place
+  Ring::store(m_head, (INDEX) ((head + n) & MASK));
+  return (n);
+}
+
+template <uint16_t SIZE, class INDEX>
 int
-IOBuffer<SIZE>::peekchar()
+IOBuffer<SIZE, INDEX>::peekchar()
 {
-  if (UNLIKELY(m_head == m_tail)) return (IOStream::EOF);
-  uint16_t next = (m_tail + 1) & MASK;
+  if (UNLIKELY(Ring::load(m_head) == m_tail)) return (IOStream::EOF);
+  INDEX next = (m_tail + 1) & MASK;
   return (m_buffer[next] & 0xff);
 }
 
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX>
 int
-IOBuffer<SIZE>::peekchar(char c)
+IOBuffer<SIZE, INDEX>::peekchar(char c)
 {
-  uint16_t tail = m_tail;
+  INDEX head = Ring::load(m_head);
+  INDEX tail = m_tail;
   int res = 0;
-  while (tail != m_head) {
+  while (tail != head) {
     res += 1;
     tail = (tail + 1) & MASK;
     if (UNLIKELY(m_buffer[tail] == c)) return (res);
@@ -183,21 +294,40 @@ IOBuffer<SIZE>::peekchar(char c)
   return (IOStream::EOF);
 }
 
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX>
 int
-IOBuffer<SIZE>::getchar()
+IOBuffer<SIZE, INDEX>::getchar()
 {
-  if (UNLIKELY(m_head == m_tail)) return (IOStream::EOF);
-  uint16_t next = (m_tail + 1) & MASK;
-  m_tail = next;
-  return (m_buffer[next] & 0xff);
+  if (UNLIKELY(Ring::load(m_head) == m_tail)) return (IOStream::EOF);
+  INDEX next = (m_tail + 1) & MASK;
+  char c = m_buffer[next];
+  Ring::store(m_tail, next);
+  return (c & 0xff);
+}
+
+template <uint16_t SIZE, class INDEX>
+int
+IOBuffer<SIZE, INDEX>::read(void* buf, size_t size)
+{
+  // Limit to available data in buffer
+  uint16_t n = IOBuffer<SIZE, INDEX>::available();
+  if (size < n) n = size;
+  if (UNLIKELY(n == 0)) return (0);
+
+  // Copy from the end of the buffer and wrap-around to the start
+  INDEX tail = m_tail;
+  Ring::read(m_buffer, SIZE, (tail + 1) & MASK, (char*) buf, n);
+
+  // Update tail after the data has been copied
+  Ring::store(m_tail, (INDEX) ((tail + n) & MASK));
+  return (n);
 }
 
-template <uint16_t SIZE>
+template <uint16_t SIZE, class INDEX>
 int
-IOBuffer<SIZE>::flush()
+IOBuffer<SIZE, INDEX>::flush()
 {
-  while (m_head != m_tail) yield();
+  while (!is_empty()) yield();
   return (0);
 }
 
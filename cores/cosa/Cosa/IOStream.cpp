@@ -105,6 +105,38 @@ IOStream::print(unsigned long int n, uint8_t digits, Base base)
   print(buf);
 }
 
+void
+IOStream::print(int32_t value, uint8_t decimals)
+{
+  // Print sign and convert the absolute value
+  char buf[BUF_MAX];
+  uint32_t n = value;
+  if (value < 0) {
+    print('-');
+    n = -n;
+  }
+  ultoa(n, buf, 10);
+  if (decimals == 0) {
+    print(buf);
+    return;
+  }
+
+  // Print integer part, decimal point and zero padded fraction
+  uint8_t length = strlen(buf);
+  if (length <= decimals) {
+    print('0');
+    print('.');
+    for (; length < decimals; length++) print('0');
+    print(buf);
+  }
+  else {
+    char* fraction = buf + length - decimals;
+    memmove(fraction + 1, fraction, decimals + 1);
+    *fraction = '.';
+    print(buf);
+  }
+}
+
 void
 IOStream::print(double value, int8_t width, uint8_t prec)
 {
@@ -220,6 +252,46 @@ IOStream::vprintf(str_P format, va_list args)
   }
 }
 
+str_P
+IOStream::format_segment(str_P fmt)
+{
+  const char* s = (const char*) fmt;
+  const char* p = s;
+  char c;
+  while ((c = pgm_read_byte(p)) != 0) {
+    if (c == '%') {
+      if (p != s && m_dev != NULL) m_dev->write_P(s, p - s);
+      c = pgm_read_byte(++p);
+      if (c == '%') {
+	s = p++;
+	continue;
+      }
+      switch (c) {
+      case 'x':
+      case 'h':
+	m_base = hex;
+	break;
+      case 'b':
+	m_base = bin;
+	break;
+      case 'o':
+	m_base = oct;
+	break;
+      case 'B':
+	m_base = bcd;
+	break;
+      default:
+	m_base = dec;
+      }
+      if (c != 0) p++;
+      return ((str_P) p);
+    }
+    p++;
+  }
+  if (p != s && m_dev != NULL) m_dev->write_P(s, p - s);
+  return ((str_P) p);
+}
+
 char*
 IOStream::scan(char *s, size_t count)
 {
@@ -62,6 +62,13 @@ public:
    */
   class Device {
   public:
+    /** Size of program memory chunk for write_P(). */
+#if defined(BOARD_ATTINY)
+    static const size_t PROGMEM_CHUNK_MAX = 8;
+#else
+    static const size_t PROGMEM_CHUNK_MAX = 32;
+#endif
+
     /**
      * Default constructor for IOStream devices. Initiate non-blocking and
      * CRLF end of line mode.
@@ -165,7 +172,9 @@ public:
 
     /**
      * @override{IOStream::Device}
-     * Write data from buffer in program memory with given size to device.
+     * Write data from buffer in program memory with given size to
+     * device. Default implementation copies the data in chunks of
+     * PROGMEM_CHUNK_MAX bytes and writes each chunk with write().
      * @param[in] buf buffer to write.
      * @param[in] size number of bytes to write.
      * @return number of bytes written or EOF(-1).
@@ -375,6 +384,15 @@ public:
    */
   void print(unsigned long int value, uint8_t digits, Base base);
 
+  /**
+   * Print fixed-point 32-bit value with given number of decimals,
+   * i.e. value / 10**decimals, to stream without floating point
+   * arithmetic. Ex. print(-1234L, 2) prints "-12.34".
+   * @param[in] value to print (scaled by 10**decimals).
+   * @param[in] decimals number of digits after decimal point.
+   */
+  void print(int32_t value, uint8_t decimals);
+
   /**
    * Print double with the minimum field width of the output string
    * (including the '.' and the possible sign for negative values) is
@@ -492,6 +510,76 @@ public:
     va_end(args);
   }
 
+  /**
+   * Type-safe formatted print. The format string should be in program
+   * memory. Each conversion specification (%d, %u, %c, %s, %p, %x, %h,
+   * %b, %o or %B) is replaced by the next argument which is printed
+   * with the output operator for its static type in the base given by
+   * the conversion character. Use %% for a percent sign. There is no
+   * variable argument list; argument types are bound at compile
+   * time. Use the macro FORMAT() to also check the number of
+   * arguments against the format string at compile time.
+   * @param[in] fmt string in program memory.
+   * @param[in] value first argument.
+   * @param[in] args remaining arguments.
+   */
+  template<typename T, typename... Args>
+  void format(str_P fmt, const T& value, const Args&... args)
+  {
+    fmt = format_segment(fmt);
+    *this << value;
+    format(fmt, args...);
+  }
+
+  /**
+   * Print remaining format string in program memory (no arguments).
+   * @param[in] fmt string in program memory.
+   */
+  void format(str_P fmt)
+  {
+    format_segment(fmt);
+  }
+
+  /**
+   * Return number of conversion specifications in given format
+   * string, or a value larger than any argument count if the format
+   * string contains an unsupported conversion character. Evaluated at
+   * compile time by the macro FORMAT().
+   * @param[in] fmt format string.
+   * @return number of arguments required.
+   */
+  static constexpr uint8_t format_count(const char* fmt)
+  {
+    return (*fmt == 0 ? 0 :
+	    *fmt != '%' ? format_count(fmt + 1) :
+	    fmt[1] == '%' ? format_count(fmt + 2) :
+	    is_format_spec(fmt[1]) ? 1 + format_count(fmt + 2) :
+	    FORMAT_INVALID);
+  }
+
+  /**
+   * Return true(1) if the given character is a supported conversion
+   * character for format() otherwise false(0).
+   * @param[in] c conversion character.
+   * @return bool.
+   */
+  static constexpr bool is_format_spec(char c)
+  {
+    return (c == 'd' || c == 'u' || c == 'c' || c == 's' || c == 'p' ||
+	    c == 'x' || c == 'h' || c == 'b' || c == 'o' || c == 'B');
+  }
+
+  /**
+   * Argument counter for the macro FORMAT(). Only used in unevaluated
+   * context (sizeof); returns a reference to an array with one
+   * element more than the number of arguments.
+   */
+  template<typename... Args>
+  static char (&format_args(const Args&...))[sizeof...(Args) + 1];
+
+  /** Returned by format_count() for unsupported conversion character. */
+  static const uint8_t FORMAT_INVALID = 0x80;
+
   /**
    * Print contents of iostream to stream.
    * @param[in] buffer input/output buffer.
@@ -723,8 +811,39 @@ protected:
    * @param[in] base representation.
    */
   void print_prefix(Base base);
+
+  /**
+   * Print format string in program memory up to the next conversion
+   * specification, set the base for the next output operator given
+   * by the conversion character and return pointer to the remaining
+   * format string.
+   * @param[in] fmt string in program memory.
+   * @return remaining format string.
+   */
+  str_P format_segment(str_P fmt);
 };
 
+/**
+ * Type-safe formatted print to given output stream with compile time
+ * check of the format string. The format string must be a string
+ * literal; it is checked for supported conversion characters and the
+ * number of conversion specifications is checked against the number
+ * of arguments. The string is stored in program memory.
+ * @code
+ * FORMAT(cout, "x = %d, y = %x\n", x, y);
+ * @endcode
+ * @param[in] outs output stream.
+ * @param[in] fmt format string literal.
+ * @param[in] ... arguments.
+ */
+#define FORMAT(outs, fmt, ...)						\
+  do {									\
+    static_assert(IOStream::format_count(fmt) ==			\
+		  sizeof(IOStream::format_args(__VA_ARGS__)) - 1,	\
+		  "FORMAT: argument count does not match format string"); \
+    (outs).format(PSTR(fmt), ##__VA_ARGS__);				\
+  } while (0)
+
 /**
  * Set current base to bcd for next operator print.
  * @param[in] outs stream.
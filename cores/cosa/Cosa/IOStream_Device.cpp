@@ -53,12 +53,7 @@ IOStream::Device::puts(const char* s)
 int
 IOStream::Device::puts(str_P s)
 {
-  const char* bp = (const char*) s;
-  int n = 0;
-  for (char c; (c = pgm_read_byte(bp++)) != 0; n++)
-    if (UNLIKELY(putchar(c) < 0))
-      break;
-  return (n);
+  return (write_P(s, strlen_P((const char*) s)));
 }
 
 int
@@ -75,11 +70,21 @@ IOStream::Device::write(const void* buf, size_t size)
 int
 IOStream::Device::write_P(const void* buf, size_t size)
 {
-  char* bp = (char*) buf;
+  // Copy program memory in chunks (memcpy_P; LPM Z+ loop) and write
+  // each chunk with the device write, i.e. buffer spans or bursts
+  const char* bp = (const char*) buf;
+  char chunk[PROGMEM_CHUNK_MAX];
   size_t n = 0;
-  for(; n < size; n++)
-    if (UNLIKELY(putchar(pgm_read_byte(bp++)) < 0))
-      break;
+  while (n < size) {
+    size_t count = size - n;
+    if (count > sizeof(chunk)) count = sizeof(chunk);
+    memcpy_P(chunk, bp, count);
+    int res = write(chunk, count);
+    if (UNLIKELY(res <= 0)) break;
+    n += res;
+    bp += res;
+    if (UNLIKELY((size_t) res != count)) break;
+  }
   return (n);
 }
 
@@ -47,6 +47,97 @@ static const unsigned long digits10[] __PROGMEM = {
 
 static const char letters[] __PROGMEM = "0123456789abcdef";
 
+/** Decimal digit pairs "00".."99". */
+static const char pairs[] __PROGMEM =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/**
+ * Append the two decimal digits of the given value (0..99) from the
+ * digit pair table. Leading zero digits are skipped while first is
+ * set. Return pointer to end of string.
+ * @param[in] s string pointer.
+ * @param[in] n value to convert (0..99).
+ * @param[in,out] first leading zero suppression flag.
+ * @return string pointer.
+ */
+static char*
+digits2(char* s, uint8_t n, unsigned char& first)
+{
+  const char* p = pairs + (n << 1);
+  char c = pgm_read_byte(p);
+  if (!first || c != '0') {
+    *s++ = c;
+    first = 0;
+  }
+  c = pgm_read_byte(p + 1);
+  if (!first || c != '0') {
+    *s++ = c;
+    first = 0;
+  }
+  return (s);
+}
+
+/**
+ * Division free decimal conversion. Digits above 10000 are generated
+ * by subtraction of powers of ten (32-bit only above 0xffff). The four
+ * lowest digits are generated from the digit pair table with the
+ * quotient by 100 calculated by multiplication with the reciprocal
+ * (exact for values below 43699).
+ * @param[in] val value to convert.
+ * @param[in] s string buffer.
+ * @return string buffer.
+ */
+static char*
+ultoa10(unsigned long val, char* s)
+{
+  unsigned char first = 1;
+  char* p = s;
+
+  // Digits 10 to 5 with 32-bit subtraction
+  if (val > 0xffffUL) {
+    for (uint8_t i = 0; i < 6; i++) {
+      unsigned long check = pgm_read_dword(digits10 + i);
+      char k = '0';
+      while (val >= check) {
+	val -= check;
+	k++;
+      }
+      if (!first || k != '0') {
+	*p++ = k;
+	first = 0;
+      }
+    }
+  }
+
+  // Digit 5 with 16-bit subtraction
+  uint16_t n = val;
+  if (first) {
+    char k = '0';
+    while (n >= 10000) {
+      n -= 10000;
+      k++;
+    }
+    if (k != '0') {
+      *p++ = k;
+      first = 0;
+    }
+  }
+
+  // Digits 4 to 1 with reciprocal multiplication and digit pairs
+  uint8_t hi = (((uint32_t) n) * 5243UL) >> 19;
+  uint8_t lo = n - hi * 100;
+  p = digits2(p, hi, first);
+  p = digits2(p, lo, first);
+  if (first) *p++ = '0';
+  *p = 0;
+
+  return (s);
+}
+
 char*
 IOStream::ultoa(unsigned long __val, char *__s, int base)
 {
@@ -55,6 +146,7 @@ IOStream::ultoa(unsigned long __val, char *__s, int base)
   first = 1;
   j = 0;
 
+  if (base == 10) return (ultoa10(__val, __s));
   if (__val != 0UL) {
     if (base == 2) {
       // Optimize for base(2)
@@ -58,6 +58,62 @@ public:
      */
     virtual void clear() {}
   };
+
+  /**
+   * Nested interrupt scope. Allows an interrupt service routine to be
+   * interrupted by other sources. The source interrupt enable bit(s)
+   * are cleared to guard against self-reentry and global interrupts
+   * are enabled. On scope exit global interrupts are disabled and the
+   * source enable bit(s) are set again. Should be used after the
+   * source has been acknowledged (flag cleared) and only for sources
+   * that are not re-armed or disabled by the handler. Use with
+   * ISR_NESTED().
+   */
+  class Nested {
+  public:
+    /**
+     * Clear the given source enable bit(s) in given interrupt mask
+     * register and enable interrupts.
+     * @param[in] reg interrupt mask register.
+     * @param[in] mask source enable bit(s).
+     */
+    Nested(volatile uint8_t& reg, uint8_t mask) :
+      m_reg(reg),
+      m_mask(mask)
+    {
+      m_reg &= ~m_mask;
+      sei();
+    }
+
+    /**
+     * Disable interrupts and set the source enable bit(s).
+     */
+    ~Nested()
+    {
+      cli();
+      m_reg |= m_mask;
+    }
+
+  protected:
+    volatile uint8_t& m_reg;	//!< Interrupt mask register.
+    const uint8_t m_mask;	//!< Source enable bit(s).
+  };
 };
+
+/**
+ * Allow the remaining part of the interrupt service routine to be
+ * interrupted by other sources. Used in the form:
+ * @code
+ * ISR(PCINT0_vect)
+ * {
+ *   ISR_NESTED(PCICR, _BV(PCIE0));
+ *   ...
+ * }
+ * @endcode
+ * @param[in] reg interrupt mask register.
+ * @param[in] mask source enable bit(s).
+ */
+#define ISR_NESTED(reg,mask)					\
+  Interrupt::Nested __UNIQUE(__nested)(reg, mask)
 #endif
 
@@ -38,7 +38,12 @@ public:
    * stop() dequeues jobs, dispatch() which typically is called from
    * an interrupt service will by default push a timeout event to the
    * job. The default event handler will call the job run() virtual
-   * member function.
+   * member function. The job queue is sorted by expire time. Jobs
+   * with slack (allowed lateness) are coalesced; expired jobs are
+   * dispatched together at the deadline of the first group of jobs,
+   * see deadline(). See
+   * Cosa/Wheel.hh for a timer wheel backend with bounded time start
+   * and dispatch.
    */
   class Scheduler {
   public:
@@ -72,6 +77,15 @@ public:
      */
     virtual void dispatch();
 
+    /**
+     * @override{Job::Scheduler}
+     * Return time until the first job in the queue expires, or
+     * INT32_MAX if the queue is empty. Used by tickless time bases to
+     * program the next wake up.
+     * @return time.
+     */
+    virtual int32_t expire_after();
+
     /**
      * @override{Job::Scheduler}
      * Return current scheduler time.
@@ -82,6 +96,16 @@ public:
   protected:
     /** Job queue. */
     Head m_queue;
+
+    /**
+     * Return the deadline for the first group of jobs in the queue;
+     * the earliest expire time plus slack of the jobs that expire
+     * before the deadline. All jobs in the group can be dispatched
+     * in a single wake up at the deadline. The queue must not be
+     * empty. Called from ISR or synchronized block.
+     * @return time.
+     */
+    uint32_t deadline();
   };
 
   /**
@@ -92,6 +116,7 @@ public:
   Job(Scheduler* scheduler) :
     Link(),
     m_expires(0L),
+    m_slack(0),
     m_scheduler(scheduler)
   {}
 
@@ -132,6 +157,26 @@ public:
     return (m_expires);
   }
 
+  /**
+   * Set slack; allowed lateness in scheduler time unit. The job may
+   * be dispatched together with other jobs within the slack to
+   * reduce the number of wake ups. Default no slack.
+   * @param[in] time allowed lateness.
+   */
+  void slack(uint16_t time)
+  {
+    m_slack = time;
+  }
+
+  /**
+   * Get slack.
+   * @return time.
+   */
+  uint16_t slack() const
+  {
+    return (m_slack);
+  }
+
   /**
    * Get current scheduler time. May be used to set relative expire time.
    * @return time.
@@ -213,6 +258,9 @@ protected:
   /** Expire time. Scale (us, ms, s) depends on scheduler. */
   uint32_t m_expires;
 
+  /** Allowed lateness. Scale depends on scheduler. */
+  uint16_t m_slack;
+
   /** Job scheduler. */
   Scheduler* m_scheduler;
 };
@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/Job.hh"
+#include "Cosa/ProbeChannel.hh"
 
 bool
 Job::Scheduler::start(Job* job)
@@ -55,6 +56,9 @@ Job::Scheduler::dispatch()
   // Check if the queue is empty
   if (m_queue.is_empty()) return;
 
+  // Wait for the deadline of the first group of jobs
+  if ((int32_t) (deadline() - time()) > 0) return;
+
   // Run all jobs that have expired
   Job* job = (Job*) m_queue.succ();
   while ((Linkage*) job != &m_queue) {
@@ -63,7 +67,37 @@ Job::Scheduler::dispatch()
     if (diff < 0) return;
     Job* succ = (Job*) job->succ();
     ((Link*) job)->detach();
+    PROBE_SET(JOB);
     job->on_expired();
+    PROBE_CLEAR(JOB);
     job = succ;
   }
 }
+
+int32_t
+Job::Scheduler::expire_after()
+{
+  // Time until the deadline of the first group of jobs, if any
+  uint32_t at;
+  synchronized {
+    if (m_queue.is_empty()) return (INT32_MAX);
+    at = deadline();
+  }
+  return (at - time());
+}
+
+uint32_t
+Job::Scheduler::deadline()
+{
+  // Earliest expire time plus slack of the jobs that expire before
+  Linkage* link = m_queue.succ();
+  Job* job = (Job*) link;
+  uint32_t res = job->m_expires + job->m_slack;
+  while ((link = link->succ()) != &m_queue) {
+    job = (Job*) link;
+    if ((int32_t) (job->m_expires - res) > 0) break;
+    uint32_t at = job->m_expires + job->m_slack;
+    if ((int32_t) (at - res) < 0) res = at;
+  }
+  return (res);
+}
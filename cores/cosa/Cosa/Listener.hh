@@ -26,7 +26,8 @@
 /**
  * Template class for event listener. Allows dispatch of events onto a
  * keyed set of listeners. The key data type must have assignment and
- * at least operation== defined.
+ * at least operation== defined. The keyed listener table,
+ * Listener::Table, also requires operator<.
  * @param[in] T key type.
  */
 template <typename T>
@@ -79,6 +80,82 @@ public:
    */
   static void dispatch(Head* head, T key, uint8_t type, uint16_t value);
 
+  /**
+   * Keyed listener table. Listeners are kept sorted on key in a
+   * vector (provided by the application) and events are dispatched
+   * to the listeners with matching key with binary search; log2(n)
+   * key compares instead of one per listener in the queue. A listener
+   * key should not be changed while attached to a table.
+   */
+  class Table {
+  public:
+    /**
+     * Construct listener table with given vector and max number of
+     * listeners.
+     * @param[in] table listener vector.
+     * @param[in] max number of listeners.
+     */
+    Table(Listener** table, uint8_t max) :
+      m_table(table),
+      m_max(max),
+      m_count(0)
+    {}
+
+    /**
+     * Return number of attached listeners.
+     * @return count.
+     */
+    uint8_t available() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * Attach given listener to the table. Listeners with the same key
+     * are dispatched in attach order. Return true(1) if successful
+     * otherwise false(0); table full or already attached.
+     * @param[in] listener to attach.
+     * @return bool.
+     */
+    bool attach(Listener* listener);
+
+    /**
+     * Detach given listener from the table. Return true(1) if
+     * successful otherwise false(0); not attached.
+     * @param[in] listener to detach.
+     * @return bool.
+     */
+    bool detach(Listener* listener);
+
+    /**
+     * Dispatch given event type/value to the listeners in the table
+     * which match the given key. A listener may detach itself during
+     * the dispatch.
+     * @param[in] key to match.
+     * @param[in] type of event.
+     * @param[in] value for event.
+     */
+    void dispatch(T key, uint8_t type, uint16_t value);
+
+  protected:
+    /** Listener vector; sorted on key. */
+    Listener** m_table;
+
+    /** Max number of listeners. */
+    uint8_t m_max;
+
+    /** Number of attached listeners. */
+    uint8_t m_count;
+
+    /**
+     * Return index of first listener with key not less than the
+     * given key (binary search).
+     * @param[in] key to search.
+     * @return index.
+     */
+    uint8_t lower_bound(T key) const;
+  };
+
 private:
   /** Listener key. */
   T m_key;
@@ -95,4 +172,63 @@ Listener<T>::dispatch(Head* head, T key, uint8_t type, uint16_t value)
     link = link->succ();
   }
 }
+
+template <typename T>
+uint8_t
+Listener<T>::Table::lower_bound(T key) const
+{
+  uint8_t low = 0;
+  uint8_t high = m_count;
+  while (low < high) {
+    uint8_t mid = (low + high) >> 1;
+    if (m_table[mid]->m_key < key)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return (low);
+}
+
+template <typename T>
+bool
+Listener<T>::Table::attach(Listener<T>* listener)
+{
+  if (UNLIKELY(m_count == m_max)) return (false);
+
+  // Insert after the listeners with the same key
+  uint8_t ix = lower_bound(listener->m_key);
+  for (; ix < m_count && m_table[ix]->match(listener->m_key); ix++)
+    if (UNLIKELY(m_table[ix] == listener)) return (false);
+  for (uint8_t i = m_count; i > ix; i--) m_table[i] = m_table[i - 1];
+  m_table[ix] = listener;
+  m_count += 1;
+  return (true);
+}
+
+template <typename T>
+bool
+Listener<T>::Table::detach(Listener<T>* listener)
+{
+  uint8_t ix = lower_bound(listener->m_key);
+  for (; ix < m_count && m_table[ix] != listener; ix++)
+    if (!m_table[ix]->match(listener->m_key)) return (false);
+  if (UNLIKELY(ix == m_count)) return (false);
+  m_count -= 1;
+  for (; ix < m_count; ix++) m_table[ix] = m_table[ix + 1];
+  return (true);
+}
+
+template <typename T>
+void
+Listener<T>::Table::dispatch(T key, uint8_t type, uint16_t value)
+{
+  uint8_t ix = lower_bound(key);
+  while (ix < m_count) {
+    Listener<T>* listener = m_table[ix];
+    if (!listener->match(key)) return;
+    listener->on_event(type, value);
+    // Step to next unless the listener detached itself
+    if (ix < m_count && m_table[ix] == listener) ix++;
+  }
+}
 #endif
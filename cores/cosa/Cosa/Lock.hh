@@ -45,8 +45,7 @@ public:
    */
   Lock()
   {
-    m_key = SREG;
-    __asm__ __volatile__("cli" ::: "memory");
+    m_key = lock();
   }
 
   /**
@@ -54,8 +53,7 @@ public:
    */
   ~Lock()
   {
-    SREG = m_key;
-    __asm__ __volatile__("" ::: "memory");
+    unlock(m_key);
   }
 
 private:
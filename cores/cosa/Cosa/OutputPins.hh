@@ -0,0 +1,164 @@
+/**
+ * @file Cosa/OutputPins.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_OUTPUT_PINS_HH
+#define COSA_OUTPUT_PINS_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Pin.hh"
+
+/**
+ * Output pin group. Writes an N-bit value to a set of output pins
+ * with one masked write per AVR port. The pins are grouped by port
+ * when attached and a bit-spread table (per value nibble) is
+ * precomputed for each port. All pins on the same port are updated
+ * with a single store; the update is glitch-free within each port.
+ * Ports are updated in the order of attachment.
+ * @code
+ * const Board::DigitalPin pins[] __PROGMEM = {
+ *   Board::D4, Board::D5, Board::D6, Board::D7
+ * };
+ * OutputPins<4> data(pins);
+ * ...
+ * data = 0x0a;
+ * @endcode
+ * @param[in] WIDTH number of bits/pins (1..8).
+ * @param[in] PORTS max number of AVR ports (default 1).
+ * @section Limitations
+ * Requires PORTS * (3 + 16 * ((WIDTH + 3) / 4)) bytes of memory.
+ */
+template<uint8_t WIDTH, uint8_t PORTS = 1>
+class OutputPins {
+public:
+  /**
+   * Construct empty output pin group. Pins are added with attach().
+   */
+  OutputPins()
+  {
+    memset(m_port, 0, sizeof(m_port));
+  }
+
+  /**
+   * Construct output pin group with given pins vector (in program
+   * memory); the first pin is bit zero (LSB). The pins are set in
+   * output mode with the given initial value.
+   * @param[in] pins vector with WIDTH digital pins (program memory).
+   * @param[in] initial value (default zero).
+   */
+  OutputPins(const Board::DigitalPin* pins, uint8_t initial = 0)
+  {
+    memset(m_port, 0, sizeof(m_port));
+    for (uint8_t bit = 0; bit < WIDTH; bit++)
+      attach(bit, (Board::DigitalPin) pgm_read_byte(&pins[bit]));
+    write(initial);
+  }
+
+  /**
+   * Attach given pin as given value bit. The pin is set in output
+   * mode and cleared. Return false(0) if the bit is out of range or
+   * the pin requires more than PORTS ports otherwise true(1).
+   * @param[in] bit value bit (0..WIDTH-1).
+   * @param[in] pin digital pin.
+   * @return bool.
+   */
+  bool attach(uint8_t bit, Board::DigitalPin pin)
+  {
+    if (UNLIKELY(bit >= WIDTH)) return (false);
+    volatile uint8_t* port = Pin::PORT(pin);
+    const uint8_t mask = Pin::MASK(pin);
+    port_t* pp = m_port;
+    while (pp->port != NULL && pp->port != port)
+      if (UNLIKELY(++pp == &m_port[PORTS])) return (false);
+    pp->port = port;
+    pp->mask |= mask;
+    uint8_t* spread = pp->spread[bit >> 2];
+    for (uint8_t value = 0; value < 16; value++)
+      if (value & _BV(bit & 3)) spread[value] |= mask;
+    synchronized {
+      *port &= ~mask;
+      *Pin::DDR(pin) |= mask;
+    }
+    return (true);
+  }
+
+  /**
+   * Return number of ports used by the pin group.
+   * @return ports.
+   */
+  uint8_t ports() const
+  {
+    uint8_t res = 0;
+    while (res < PORTS && m_port[res].port != NULL) res++;
+    return (res);
+  }
+
+  /**
+   * Write given value to the pin group; bit zero to the first pin.
+   * @param[in] value to write.
+   * @note atomic
+   */
+  void write(uint8_t value)
+    __attribute__((always_inline))
+  {
+    synchronized _write(value);
+  }
+
+  /**
+   * Write given value to the pin group. Unprotected version for use
+   * in synchronized blocks.
+   * @param[in] value to write.
+   */
+  void _write(uint8_t value)
+    __attribute__((always_inline))
+  {
+    const port_t* pp = m_port;
+    for (uint8_t ix = 0; ix < PORTS && pp->port != NULL; ix++, pp++) {
+      uint8_t bits = pp->spread[0][value & 0x0f];
+      if (WIDTH > 4) bits |= pp->spread[WIDTH > 4][value >> 4];
+      *pp->port = (*pp->port & ~pp->mask) | bits;
+    }
+  }
+
+  /**
+   * Write given value to the pin group.
+   * @param[in] value to write.
+   * @return output pin group.
+   * @note atomic
+   */
+  OutputPins& operator=(uint8_t value)
+    __attribute__((always_inline))
+  {
+    write(value);
+    return (*this);
+  }
+
+protected:
+  /** Port with pins in the group. */
+  struct port_t {
+    volatile uint8_t* port;	//!< Port data register.
+    uint8_t mask;		//!< Mask of pins on port.
+    uint8_t spread[(WIDTH + 3) / 4][16]; //!< Nibble to port bits.
+  };
+
+  /** Ports in order of attachment. */
+  port_t m_port[PORTS];
+};
+
+#endif
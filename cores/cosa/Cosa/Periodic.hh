@@ -29,7 +29,10 @@
  * Subclass and implement the virtual method run() as the function to
  * be executed periodically. The scheduler defines the time base;
  * the alarm scheduler uses seconds, the watchdog job scheduler
- * milli-seconds and the real-time timer micro-seconds.
+ * milli-seconds and the real-time timer micro-seconds. The job is
+ * rescheduled relative to the previous deadline (not the time of the
+ * run) so there is no drift. The catch-up policy selects what to do
+ * when deadlines have been missed (overrun).
  *
  * @section See Also
  * For details on handling of time units see Job.hh. This execution
@@ -37,6 +40,16 @@
  */
 class Periodic : public Job {
 public:
+  /**
+   * Catch-up policy on overrun; the next deadline has already passed
+   * when rescheduling.
+   */
+  enum Policy {
+    BURST,			//!< Run once for each missed deadline.
+    SKIP,			//!< Drop missed deadlines; wait for next.
+    COALESCE			//!< Run once now for all missed deadlines.
+  } __attribute__((packed));
+
   /**
    * Construct a periodic function handled by the given scheduler and
    * with the given period in the schedulers time base. The maximum
@@ -44,10 +57,14 @@ public:
    * Watchdog::Scheduler and 136 years with Alarm::Clock.
    * @param[in] scheduler for the periodic job.
    * @param[in] period of timeout.
+   * @param[in] policy catch-up policy on overrun (default BURST).
    */
-  Periodic(Job::Scheduler* scheduler, uint32_t period) :
+  Periodic(Job::Scheduler* scheduler, uint32_t period,
+	   Policy policy = BURST) :
     Job(scheduler),
-    m_period(period)
+    m_period(period),
+    m_policy(policy),
+    m_overruns(0)
   {}
 
   /**
@@ -71,12 +88,55 @@ public:
   }
 
   /**
-   * Reschedule after a new period.
+   * Set catch-up policy on overrun.
+   * @param[in] policy catch-up policy.
+   */
+  void policy(Policy policy)
+    __attribute__((always_inline))
+  {
+    m_policy = policy;
+  }
+
+  /**
+   * Get catch-up policy on overrun.
+   * @return policy.
+   */
+  Policy policy() const
+    __attribute__((always_inline))
+  {
+    return (m_policy);
+  }
+
+  /**
+   * Return number of missed deadlines (saturated).
+   * @return overruns.
+   */
+  uint16_t overruns() const
+    __attribute__((always_inline))
+  {
+    return (m_overruns);
+  }
+
+  /**
+   * Reset number of missed deadlines.
+   */
+  void reset_overruns()
+    __attribute__((always_inline))
+  {
+    m_overruns = 0;
+  }
+
+  /**
+   * Reschedule after a new period; next deadline is the previous
+   * deadline plus the period. Missed deadlines are handled according
+   * to the catch-up policy and counted.
    */
   void reschedule()
   {
     if (m_period == 0) return;
     expire_after(m_period);
+    int32_t late = time() - expire_at();
+    if (UNLIKELY(late >= 0)) catch_up(late);
     start();
   }
 
@@ -98,6 +158,31 @@ protected:
 
   /** Time period. Time unit is defined by the scheduler. */
   uint32_t m_period;
+
+  /** Catch-up policy on overrun. */
+  Policy m_policy;
+
+  /** Number of missed deadlines. */
+  uint16_t m_overruns;
+
+  /**
+   * Apply catch-up policy when the next deadline has passed with the
+   * given time.
+   * @param[in] late time since deadline.
+   */
+  void catch_up(uint32_t late)
+  {
+    uint32_t missed = 1;
+    if (m_policy != BURST) {
+      missed = (late / m_period) + 1;
+      if (m_policy == SKIP)
+	expire_after(missed * m_period);
+      else
+	expire_after((--missed) * m_period);
+    }
+    missed += m_overruns;
+    m_overruns = (missed > UINT16_MAX) ? UINT16_MAX : missed;
+  }
 };
 
 /**
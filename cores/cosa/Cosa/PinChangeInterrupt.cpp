@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/PinChangeInterrupt.hh"
+#include "Cosa/Probe.hh"
 
 // Define symbols for enable/disable pin change interrupts
 #if defined(GIMSK)
@@ -37,28 +38,68 @@
 #define PCIEN (_BV(PCIE0))
 #endif
 
-PinChangeInterrupt* PinChangeInterrupt::s_pin[Board::PCMSK_MAX] = { NULL };
+#if !defined(COSA_STATIC_INTERRUPT_HANDLERS)
+PinChangeInterrupt* PinChangeInterrupt::s_pin[Board::PCMSK_MAX][CHARBITS];
+#endif
 uint8_t PinChangeInterrupt::s_state[Board::PCMSK_MAX] = { 0 };
+uint8_t PinChangeInterrupt::s_rising[Board::PCMSK_MAX] = { 0 };
+uint8_t PinChangeInterrupt::s_falling[Board::PCMSK_MAX] = { 0 };
+
+uint8_t
+PinChangeInterrupt::port_index() const
+{
+  uint8_t ix = PCIMR() - &PCMSK0;
+  if (ix >= Board::PCMSK_MAX) ix = Board::PCMSK_MAX - 1;
+  return (ix);
+}
+
+void
+PinChangeInterrupt::set_filter(uint8_t ix, bool enable)
+{
+  s_rising[ix] &= ~m_mask;
+  s_falling[ix] &= ~m_mask;
+  if (!enable) return;
+  if (m_mode != ON_FALLING_MODE) s_rising[ix] |= m_mask;
+  if (m_mode != ON_RISING_MODE) s_falling[ix] |= m_mask;
+}
+
+void
+PinChangeInterrupt::interrupt_mode(InterruptMode mode)
+{
+  uint8_t ix = port_index();
+  synchronized {
+    m_mode = mode;
+    set_filter(ix, (*PCIMR() & m_mask) != 0);
+  }
+}
 
 void
 PinChangeInterrupt::enable()
 {
-  // Enable in pin change mask register and add to list of handlers
+  // Register handler for the pin and enable edge filter and mask
+  uint8_t ix = port_index();
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
   synchronized {
+    m_ix = ix;
+#else
+  uint8_t bit = 0;
+  while ((m_mask >> bit) != 1) bit++;
+  synchronized {
+    s_pin[ix][bit] = this;
+#endif
+    set_filter(ix, true);
     *PCIMR() |= m_mask;
-    if (m_next == NULL) {
-      uint8_t ix = PCIMR() - &PCMSK0;
-      if (ix >= Board::PCMSK_MAX) ix = Board::PCMSK_MAX - 1;
-      m_next = s_pin[ix];
-      s_pin[ix] = this;
-    }
   }
 }
 
 void
 PinChangeInterrupt::disable()
 {
-  synchronized *PCIMR() &= ~m_mask;
+  uint8_t ix = port_index();
+  synchronized {
+    *PCIMR() &= ~m_mask;
+    set_filter(ix, false);
+  }
 }
 
 void
@@ -109,24 +150,55 @@ PinChangeInterrupt::end()
 void
 PinChangeInterrupt::on_interrupt(uint8_t vec, uint8_t mask, uint8_t port)
 {
-  uint8_t old_state = s_state[vec];
-  uint8_t new_state = port;
-  uint8_t changed = (new_state ^ old_state) & mask;
-
-  // Find the interrupt handler for the changed value and check mode
-  for (PinChangeInterrupt* pin = s_pin[vec]; pin != NULL; pin = pin->m_next)
-    if ((pin->m_mask & changed)
-	&& ((pin->m_mode == ON_CHANGE_MODE)
-	    || pin->m_mode == ((pin->m_mask & new_state) == 0)))
-      pin->on_interrupt();
+  // Filter changed pins with enabled edges; rising (now set) and
+  // falling (now clear)
+  uint8_t changed = (port ^ s_state[vec]) & mask;
+  uint8_t events = changed & ((port & s_rising[vec])
+			       | (~port & s_falling[vec]));
+  s_state[vec] = port;
 
-  // Save the new pin state
-  s_state[vec] = new_state;
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+  // Walk the handler table and dispatch the handlers on the port with
+  // remaining pins
+  if (events == 0) return;
+  PinChangeInterrupt* const* entry = s_handler;
+  PinChangeInterrupt* pin;
+  while ((pin = (PinChangeInterrupt*) pgm_read_word(entry++)) != NULL) {
+    if ((pin->m_ix == vec) && (pin->m_mask & events)) {
+      pin->on_interrupt();
+      events &= ~pin->m_mask;
+      if (events == 0) return;
+    }
+  }
+#else
+  // Dispatch only the remaining pins; scan nibble then bits
+  PinChangeInterrupt** pin = s_pin[vec];
+  if ((events & 0x0f) == 0) {
+    events >>= 4;
+    pin += 4;
+  }
+  while (events != 0) {
+    if (events & 1) (*pin)->on_interrupt();
+    events >>= 1;
+    pin += 1;
+  }
+#endif
 }
 
+// Optional nested interrupt handling; the vector is masked while
+// the handlers run with interrupts enabled
+#if defined(COSA_NESTED_PCINT)
+#define PCINT_NESTED(vec) ISR_NESTED(PCICR, _BV(PCIE ## vec))
+#else
+#define PCINT_NESTED(vec)
+#endif
+
 #define PCINT_ISR(vec,pin)					\
+ISR_PROBE_DEFINE(pcint ## vec ## _isr_probe, "isr:PCINT" #vec);	\
 ISR(PCINT ## vec ## _vect)					\
 {								\
+  ISR_PROBE(pcint ## vec ## _isr_probe);			\
+  PCINT_NESTED(vec);						\
   PinChangeInterrupt::on_interrupt(vec, PCMSK ## vec, pin);	\
 }
 
@@ -29,6 +29,20 @@
 /**
  * Abstract interrupt pin. Allows interrupt handling on
  * the pin value changes.
+ *
+ * @section Static
+ * With COSA_STATIC_INTERRUPT_HANDLERS the handler per port and pin
+ * table in data memory is replaced by a null terminated table of
+ * handlers in program memory. The table is defined by the application
+ * with PCINT_HANDLERS() and resolved at link time; dispatch walks the
+ * table and calls the handlers with pending pins on the port.
+ * All handlers that are enabled must be in the table; this includes
+ * the receiver pin of Soft::UART.
+ * @code
+ * Counter left(Board::PCI6);
+ * Counter right(Board::PCI7);
+ * PCINT_HANDLERS(&left, &right);
+ * @endcode
  */
 class PinChangeInterrupt : public IOPin, public Interrupt::Handler {
 public:
@@ -60,10 +74,30 @@ public:
 		     InterruptMode mode = ON_CHANGE_MODE,
 		     bool pullup = false) :
     IOPin((Board::DigitalPin) pin, INPUT_MODE, pullup),
-    m_mode(mode),
-    m_next(NULL)
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+    m_ix(Board::PCMSK_MAX),
+#endif
+    m_mode(mode)
   {}
 
+  /**
+   * Get interrupt mode; edge filter.
+   * @return interrupt mode.
+   */
+  InterruptMode interrupt_mode() const
+  {
+    return (m_mode);
+  }
+
+  /**
+   * Set interrupt mode; edge filter. The filter is evaluated in the
+   * interrupt service routine before dispatch. Takes effect
+   * immediately if the interrupt handler is enabled.
+   * @param[in] mode of operation.
+   * @note atomic
+   */
+  void interrupt_mode(InterruptMode mode);
+
   /**
    * @override{Interrupt::Handler}
    * Enable interrupt pin change detection and interrupt handler.
@@ -86,19 +120,46 @@ public:
   virtual void on_interrupt(uint16_t arg = 0) = 0;
 
 private:
-  static PinChangeInterrupt* s_pin[Board::PCMSK_MAX];
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+  /** Null terminated interrupt handler table; see PCINT_HANDLERS(). */
+  static PinChangeInterrupt* const s_handler[] PROGMEM;
+
+  /** Port index; assigned on enable. */
+  uint8_t m_ix;
+#else
+  /** Interrupt handler per port and pin (bit). */
+  static PinChangeInterrupt* s_pin[Board::PCMSK_MAX][CHARBITS];
+#endif
+
+  /** Latest pin state per port. */
   static uint8_t s_state[Board::PCMSK_MAX];
 
+  /** Enabled pins with rising edge filter per port. */
+  static uint8_t s_rising[Board::PCMSK_MAX];
+
+  /** Enabled pins with falling edge filter per port. */
+  static uint8_t s_falling[Board::PCMSK_MAX];
+
   /** Interrupt Mode. */
   InterruptMode m_mode;
 
-  /** Linked list of pin change interrupt handlers. */
-  PinChangeInterrupt* m_next;
+  /**
+   * Return port index of pin change mask register.
+   * @return index.
+   */
+  uint8_t port_index() const;
+
+  /**
+   * Update edge filters for the pin according to interrupt mode.
+   * Unprotected; should be called in synchronized block.
+   * @param[in] ix port index.
+   * @param[in] enable flag.
+   */
+  void set_filter(uint8_t ix, bool enable);
 
   /**
-   * Map interrupt source: Check which pin(s) are the source of the
-   * pin change interrupt and call the corresponding interrupt handler
-   * per pin.
+   * Map interrupt source: Filter the changed pins with the enabled
+   * edges and call the interrupt handler of each remaining pin.
    * @param[in] ix port index.
    * @param[in] mask pin mask.
    * @param[in] base pin number.
@@ -116,4 +177,17 @@ private:
 #endif
 #endif
 };
+
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+/**
+ * Define the pin change interrupt handler table in program memory.
+ * Should be used once in the application with the addresses of all
+ * pin change interrupt handlers.
+ * @param[in] ... handler addresses.
+ */
+#define PCINT_HANDLERS(...)						\
+  PinChangeInterrupt* const PinChangeInterrupt::s_handler[] __PROGMEM = { \
+    __VA_ARGS__, NULL							\
+  }
+#endif
 #endif
@@ -0,0 +1,197 @@
+/**
+ * @file Cosa/Pool.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_POOL_HH
+#define COSA_POOL_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * Placement new; construct object in given storage. The AVR
+ * toolchain does not provide the standard header.
+ * @param[in] size of object (not used).
+ * @param[in] ptr storage pointer.
+ * @return storage pointer.
+ */
+inline void* operator new(size_t size, void* ptr)
+{
+  UNUSED(size);
+  return (ptr);
+}
+
+/**
+ * Fixed size object pool allocator. Storage for N objects of type T
+ * is statically allocated and the free list is kept in the free
+ * objects (intrusive); no memory overhead per object and constant
+ * time allocate and free without fragmentation. The atomic
+ * member functions (alloc(), free(), create() and destroy()) may be
+ * used together with interrupt handlers; the unprotected versions
+ * (_alloc() and _free()) are for interrupt handlers and synchronized
+ * blocks.
+ * @code
+ * Pool<msg_t, 4> pool;
+ * ...
+ * msg_t* msg = pool.create();
+ * if (msg == NULL) return (ENOMEM);
+ * ...
+ * pool.destroy(msg);
+ * @endcode
+ * @param[in] T object type.
+ * @param[in] N number of objects (max 255).
+ */
+template<class T, uint8_t N>
+class Pool {
+  static_assert(N > 0, "N should be at least one");
+public:
+  /**
+   * Construct pool with all objects free.
+   */
+  Pool() :
+    m_free(&m_slot[0]),
+    m_available(N)
+  {
+    for (uint8_t i = 0; i < N - 1; i++)
+      m_slot[i].next = &m_slot[i + 1];
+    m_slot[N - 1].next = NULL;
+  }
+
+  /**
+   * Return number of free objects in pool.
+   * @return free objects.
+   */
+  uint8_t available() const
+  {
+    return (m_available);
+  }
+
+  /**
+   * Return true(1) if the given pointer is an object in the pool
+   * otherwise false(0).
+   * @param[in] obj pointer to object.
+   * @return bool.
+   */
+  bool is_member(const void* obj) const
+  {
+    return ((obj >= &m_slot[0]) && (obj < &m_slot[N]));
+  }
+
+  /**
+   * Allocate storage for an object. The object is not constructed.
+   * Return pointer to storage or NULL if the pool is empty.
+   * Unprotected version for interrupt handlers and synchronized
+   * blocks.
+   * @return pointer to storage or NULL.
+   */
+  void* _alloc()
+    __attribute__((always_inline))
+  {
+    slot_t* slot = m_free;
+    if (UNLIKELY(slot == NULL)) return (NULL);
+    m_free = slot->next;
+    m_available -= 1;
+    return (slot);
+  }
+
+  /**
+   * Allocate storage for an object. The object is not constructed.
+   * Return pointer to storage or NULL if the pool is empty.
+   * @return pointer to storage or NULL.
+   * @note atomic
+   */
+  void* alloc()
+  {
+    void* res;
+    synchronized res = _alloc();
+    return (res);
+  }
+
+  /**
+   * Return given object storage to the pool. The object is not
+   * destructed. Unprotected version for interrupt handlers and
+   * synchronized blocks.
+   * @param[in] obj pointer to storage (or NULL).
+   */
+  void _free(void* obj)
+    __attribute__((always_inline))
+  {
+    if (UNLIKELY(obj == NULL)) return;
+    slot_t* slot = (slot_t*) obj;
+    slot->next = m_free;
+    m_free = slot;
+    m_available += 1;
+  }
+
+  /**
+   * Return given object storage to the pool. The object is not
+   * destructed.
+   * @param[in] obj pointer to storage (or NULL).
+   * @note atomic
+   */
+  void free(void* obj)
+  {
+    synchronized _free(obj);
+  }
+
+  /**
+   * Allocate and construct an object with the given constructor
+   * arguments. Return pointer to object or NULL if the pool is
+   * empty.
+   * @param[in] args constructor arguments.
+   * @return pointer to object or NULL.
+   * @note atomic
+   */
+  template<typename... Args>
+  T* create(Args... args)
+  {
+    void* obj = alloc();
+    if (UNLIKELY(obj == NULL)) return (NULL);
+    return (new (obj) T(args...));
+  }
+
+  /**
+   * Destruct given object and return storage to the pool.
+   * @param[in] obj pointer to object (or NULL).
+   * @note atomic
+   */
+  void destroy(T* obj)
+  {
+    if (UNLIKELY(obj == NULL)) return;
+    obj->~T();
+    free(obj);
+  }
+
+protected:
+  /** Object storage; free list link when not allocated. */
+  union slot_t {
+    slot_t* next;
+    uint8_t data[sizeof(T)];
+  };
+
+  /** Object storage. */
+  slot_t m_slot[N];
+
+  /** Free list. */
+  slot_t* volatile m_free;
+
+  /** Number of free objects. */
+  volatile uint8_t m_available;
+};
+
+#endif
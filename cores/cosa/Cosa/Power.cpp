@@ -21,24 +21,72 @@
 #include "Cosa/Power.hh"
 
 uint8_t Power::s_mode = SLEEP_MODE_IDLE;
+volatile uint8_t Power::s_count[Power::LEVEL_MAX] = { 0 };
+
+// Sleep mode for each sleep level
+#if !defined(SLEEP_MODE_PWR_SAVE)
+#define SLEEP_MODE_PWR_SAVE SLEEP_MODE_ADC
+#endif
+static const uint8_t s_level_mode[] __PROGMEM = {
+  SLEEP_MODE_IDLE,
+  SLEEP_MODE_ADC,
+  SLEEP_MODE_PWR_SAVE
+};
+
+// Map sleep mode to sleep level; deeper modes are mapped to LEVEL_MAX
+static uint8_t level(uint8_t mode)
+{
+  if (mode == SLEEP_MODE_IDLE) return (Power::IDLE_LEVEL);
+  if (mode == SLEEP_MODE_ADC) return (Power::ADC_LEVEL);
+  if (mode == SLEEP_MODE_PWR_SAVE) return (Power::SAVE_LEVEL);
+#if defined(SLEEP_MODE_EXT_STANDBY)
+  if (mode == SLEEP_MODE_EXT_STANDBY) return (Power::SAVE_LEVEL);
+#endif
+  return (Power::LEVEL_MAX);
+}
 
 #if defined(COSA_BROWN_OUT_DETECT) || !defined(sleep_bod_disable)
 #define sleep_bod_disable()
 #endif
 
+uint8_t
+Power::mode()
+{
+  // Find the lowest sleep level with active drivers
+  uint8_t res = level(s_mode);
+  if ((ADCSRA & _BV(ADIE)) && (res > ADC_LEVEL)) res = ADC_LEVEL;
+  for (uint8_t ix = 0; ix < res; ix++) {
+    if (s_count[ix] != 0) {
+      res = ix;
+      break;
+    }
+  }
+  if (res == level(s_mode)) return (s_mode);
+  return (pgm_read_byte(&s_level_mode[res]));
+}
+
 void
 Power::sleep(uint8_t mode)
 {
+  // Keep the converter running if a conversion interrupt is pending
   uint8_t saved = ADCSRA;
-  ADCSRA = 0;
-  if (mode == POWER_SLEEP_MODE) mode = s_mode;
-  set_sleep_mode(mode);
+  bool converting = (saved & _BV(ADIE)) != 0;
   synchronized {
+    if (mode == POWER_SLEEP_MODE) mode = Power::mode();
+#if defined(ASSR) && defined(AS2)
+    // Wait for asynchronous timer register updates; the timer
+    // interrupt would otherwise be lost in power save mode
+    if (ASSR & _BV(AS2))
+      while (ASSR & (_BV(TCN2UB) | _BV(OCR2AUB) | _BV(OCR2BUB)
+		     | _BV(TCR2AUB) | _BV(TCR2BUB)));
+#endif
+    if (!converting) ADCSRA = 0;
+    set_sleep_mode(mode);
     sleep_enable();
     sleep_bod_disable();
   }
   sleep_cpu();
   sleep_disable();
-  ADCSRA = saved;
+  if (!converting) ADCSRA = saved;
 }
 
@@ -26,12 +26,61 @@
 #include <avr/power.h>
 
 /**
- * Power Management and Sleep modes.
+ * Power Management and Sleep modes. The sleep mode used by default,
+ * e.g. by yield() in Event::service() and the schedulers, is selected
+ * automatically; the deepest mode allowed by the active drivers but
+ * not deeper than the mode given with set(). Drivers declare the
+ * deepest sleep mode tolerated while active with acquire() and
+ * release(). An ADC conversion in progress with interrupt enabled
+ * limits the sleep mode to SLEEP_MODE_ADC.
  */
 class Power {
 public:
   /**
-   * Set the default sleep mode: SLEEP_MODE_IDLE, SLEEP_MODE_ADC,
+   * Sleep level; deepest sleep mode tolerated by an active driver.
+   */
+  enum Level {
+    IDLE_LEVEL = 0,		//!< SLEEP_MODE_IDLE (UART, SPI, timers).
+    ADC_LEVEL = 1,		//!< SLEEP_MODE_ADC (ADC, TWI).
+    SAVE_LEVEL = 2,		//!< SLEEP_MODE_PWR_SAVE (async Timer2).
+    LEVEL_MAX = 3		//!< Number of levels.
+  } __attribute__((packed));
+
+  /**
+   * Declare that a driver is active and tolerates at most the given
+   * sleep level. Reference counted; should be paired with release().
+   * @param[in] level deepest sleep level tolerated.
+   * @note atomic
+   */
+  static void acquire(Level level)
+    __attribute__((always_inline))
+  {
+    synchronized s_count[level] += 1;
+  }
+
+  /**
+   * Release a sleep level declared with acquire().
+   * @param[in] level sleep level.
+   * @note atomic
+   */
+  static void release(Level level)
+    __attribute__((always_inline))
+  {
+    synchronized {
+      if (s_count[level] != 0) s_count[level] -= 1;
+    }
+  }
+
+  /**
+   * Return the deepest sleep mode currently allowed by the active
+   * drivers and the mode given with set().
+   * @return sleep mode.
+   */
+  static uint8_t mode();
+
+  /**
+   * Set the deepest sleep mode for automatic selection (default
+   * SLEEP_MODE_IDLE): SLEEP_MODE_IDLE, SLEEP_MODE_ADC,
    * SLEEP_MODE_PWR_DOWN, SLEEP_MODE_PWR_SAVE, SLEEP_MODE_STANDBY,
    * and SLEEP_MODE_EXT_STANDBY.
    * @param[in] mode sleep mode, see <avr/sleep.h>
@@ -47,7 +96,8 @@ public:
 
   /**
    * Put the processor in the given sleep mode and wait for
-   * an interrupt to wake up.
+   * an interrupt to wake up. The default mode is selected
+   * automatically, see mode().
    * @param[in] mode sleep mode, see <avr/sleep.h>
    */
   static void sleep(uint8_t mode = POWER_SLEEP_MODE);
@@ -283,6 +333,9 @@ private:
 
   /** Current sleep mode. */
   static uint8_t s_mode;
+
+  /** Number of active drivers per sleep level. */
+  static volatile uint8_t s_count[LEVEL_MAX];
 };
 
 #endif
@@ -0,0 +1,138 @@
+/**
+ * @file Cosa/Probe.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Probe.hh"
+
+#if !defined(BOARD_ATTINY)
+
+#include "Cosa/Power.hh"
+
+Probe* Probe::s_list = NULL;
+uint16_t Probe::s_overhead = 0;
+
+#if defined(COSA_ISR_PROFILE)
+static const char irq_name[] __PROGMEM = "irq:off";
+Probe Probe::irq((str_P) irq_name);
+uint16_t Probe::s_irq_start = 0;
+
+void __irq_disabled()
+{
+  Probe::s_irq_start = TCNT1;
+}
+
+void __irq_enabled()
+{
+  Probe::irq.update(TCNT1 - Probe::s_irq_start);
+}
+#endif
+
+Probe::Probe(str_P name) :
+  m_next(s_list),
+  m_name(name),
+  m_start(0)
+{
+  s_list = this;
+  reset();
+}
+
+void
+Probe::begin()
+{
+  // Timer1 in normal mode, free-running with prescale 1
+  Power::timer1_enable();
+  synchronized {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TIMSK1 = 0;
+  }
+
+  // Measure the overhead of an empty probe
+  uint16_t start = cycles();
+  s_overhead = cycles() - start;
+}
+
+void
+Probe::end()
+{
+  TCCR1B = 0;
+  Power::timer1_disable();
+}
+
+void
+Probe::reset()
+{
+  synchronized {
+    m_sample.count = 0;
+    m_sample.min = UINT16_MAX;
+    m_sample.max = 0;
+    m_sample.total = 0;
+  }
+}
+
+void
+Probe::reset_all()
+{
+  for (Probe* probe = s_list; probe != NULL; probe = probe->m_next)
+    probe->reset();
+}
+
+void
+Probe::get(sample_t& sample) const
+{
+  synchronized sample = m_sample;
+}
+
+void
+Probe::update(uint16_t cycles)
+{
+  cycles = (cycles > s_overhead) ? cycles - s_overhead : 0;
+  synchronized {
+    if (UNLIKELY(m_sample.count == UINT16_MAX)) return;
+    m_sample.count += 1;
+    if (cycles < m_sample.min) m_sample.min = cycles;
+    if (cycles > m_sample.max) m_sample.max = cycles;
+    m_sample.total += cycles;
+  }
+}
+
+void
+Probe::print(IOStream& outs)
+{
+  for (Probe* probe = s_list; probe != NULL; probe = probe->m_next)
+    outs << *probe << endl;
+}
+
+IOStream& operator<<(IOStream& outs, Probe& probe)
+{
+  Probe::sample_t sample;
+  probe.get(sample);
+  uint32_t mean = (sample.count == 0) ? 0 : sample.total / sample.count;
+  outs << probe.name()
+       << PSTR(":count=") << sample.count;
+  if (sample.count != 0) {
+    outs << PSTR(",min=") << sample.min
+	 << PSTR(",max=") << sample.max
+	 << PSTR(",mean=") << mean
+	 << PSTR(" (") << (mean / (F_CPU / 1000000L)) << PSTR(" us)");
+  }
+  return (outs);
+}
+
+#endif
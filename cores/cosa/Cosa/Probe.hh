@@ -0,0 +1,316 @@
+/**
+ * @file Cosa/Probe.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_PROBE_HH
+#define COSA_PROBE_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/IOStream.hh"
+#include "Cosa/ProbeChannel.hh"
+
+#if !defined(BOARD_ATTINY)
+
+/**
+ * Named execution time probe. The time between start() and stop() is
+ * measured in processor cycles with a free-running timer (Timer1,
+ * prescale 1) and accumulated per probe; number of samples, min, max
+ * and total cycles. Nothing is printed while measuring; the probes
+ * are listed with print() or iterated with first()/next(). The probe
+ * overhead (timer read) is subtracted. May be used in interrupt
+ * service routines and event handlers.
+ * @code
+ * PROBE(rx_probe, "uart:rx");
+ * ...
+ * ISR(...)
+ * {
+ *   PROBE_BEGIN(rx_probe);
+ *   ...
+ *   PROBE_END(rx_probe);
+ * }
+ * ...
+ * Probe::begin();
+ * ...
+ * Probe::print(trace);
+ * @endcode
+ * @section Limitations
+ * Uses Timer1 and cannot be used together with other Timer1 users
+ * (Tone, InputCapture, AnalogSampler, PWM on Timer1 pins). Max
+ * measured time is 65535 cycles (4 ms at 16 MHz). A probe should not
+ * be started in both interrupt and normal context; use Probe::Scope.
+ *
+ * @section Configuration
+ * Define COSA_ISR_PROFILE to measure the Cosa interrupt service
+ * routines (ISR_PROBE) and the interrupts disabled windows
+ * (Probe::irq). The Timer1 interrupt service routines are not
+ * measured.
+ */
+class Probe {
+public:
+  /**
+   * Construct named probe and add to the probe list. Should be
+   * defined with the PROBE() macro.
+   * @param[in] name of probe (program memory).
+   */
+  Probe(str_P name);
+
+  /**
+   * Start the free-running cycle timer and calibrate the probe
+   * overhead.
+   */
+  static void begin();
+
+  /**
+   * Stop the cycle timer.
+   */
+  static void end();
+
+  /**
+   * Return current cycle timer value.
+   * @return cycles.
+   */
+  static uint16_t cycles()
+    __attribute__((always_inline))
+  {
+    uint16_t res;
+    synchronized res = TCNT1;
+    return (res);
+  }
+
+  /**
+   * Start measurement.
+   */
+  void start()
+    __attribute__((always_inline))
+  {
+    m_start = cycles();
+  }
+
+  /**
+   * Stop measurement and accumulate the number of cycles since
+   * start().
+   */
+  void stop()
+    __attribute__((always_inline))
+  {
+    update(cycles() - m_start);
+  }
+
+  /**
+   * Reset probe statistics.
+   * @note atomic
+   */
+  void reset();
+
+  /**
+   * Reset all probes.
+   */
+  static void reset_all();
+
+  /**
+   * Return first probe in list, or NULL if empty.
+   * @return probe.
+   */
+  static Probe* first()
+  {
+    return (s_list);
+  }
+
+  /**
+   * Return next probe in list, or NULL at end of list.
+   * @return probe.
+   */
+  Probe* next() const
+  {
+    return (m_next);
+  }
+
+  /**
+   * Return probe name (program memory).
+   * @return name.
+   */
+  str_P name() const
+  {
+    return (m_name);
+  }
+
+  /**
+   * Probe statistics in cycles.
+   */
+  struct sample_t {
+    uint16_t count;		//!< Number of samples (max UINT16_MAX).
+    uint16_t min;		//!< Min cycles.
+    uint16_t max;		//!< Max cycles.
+    uint32_t total;		//!< Total cycles.
+  };
+
+  /**
+   * Get a consistent copy of the probe statistics.
+   * @param[out] sample statistics.
+   * @note atomic
+   */
+  void get(sample_t& sample) const;
+
+  /**
+   * Print all probes to the given output stream; name, count, min,
+   * max and mean cycles, and mean micro-seconds.
+   * @param[in] outs output stream.
+   */
+  static void print(IOStream& outs);
+
+  /**
+   * Scoped measurement; the time from construction to end of block
+   * is accumulated to the given probe. Allows measurement of
+   * functions with several return points and nested use of the same
+   * probe.
+   */
+  class Scope {
+  public:
+    /**
+     * Start measurement with given probe.
+     * @param[in] probe for measurement.
+     */
+    Scope(Probe& probe) :
+      m_probe(probe),
+      m_start(cycles())
+    {}
+
+    /**
+     * Stop measurement and accumulate to probe.
+     */
+    ~Scope()
+    {
+      m_probe.update(cycles() - m_start);
+    }
+
+  private:
+    /** Probe to accumulate to. */
+    Probe& m_probe;
+
+    /** Cycle timer value at start. */
+    uint16_t m_start;
+  };
+
+#if defined(COSA_ISR_PROFILE)
+  /**
+   * Interrupts disabled window probe ("irq:off"). Accumulates the
+   * time from the outermost lock() to unlock(); synchronized blocks
+   * and Lock. Together with the interrupt service routine probes
+   * (ISR_PROBE) the max value is the worst case interrupt latency.
+   */
+  static Probe irq;
+#endif
+
+protected:
+  /** List of probes. */
+  static Probe* s_list;
+
+  /** Probe overhead in cycles. */
+  static uint16_t s_overhead;
+
+  /** Next probe in list. */
+  Probe* m_next;
+
+  /** Probe name (program memory). */
+  str_P m_name;
+
+  /** Cycle timer value at start(). */
+  uint16_t m_start;
+
+  /** Accumulated statistics. */
+  sample_t m_sample;
+
+  /**
+   * Accumulate given number of cycles. The probe stops accumulating
+   * when the max number of samples is reached.
+   * @param[in] cycles measured.
+   */
+  void update(uint16_t cycles);
+
+#if defined(COSA_ISR_PROFILE)
+  /** Cycle timer value at outermost lock(). */
+  static uint16_t s_irq_start;
+
+  friend void __irq_disabled();
+  friend void __irq_enabled();
+#endif
+};
+
+/**
+ * Print probe statistics to given output stream.
+ * @param[in] outs output stream.
+ * @param[in] probe to print.
+ * @return output stream.
+ */
+IOStream& operator<<(IOStream& outs, Probe& probe);
+
+/**
+ * Support macro to define a named probe. Should be used at file
+ * scope.
+ * @param[in] var probe variable name.
+ * @param[in] name probe name string.
+ */
+#define PROBE(var,name)						\
+  const char var ## _name[] __PROGMEM = name;			\
+  Probe var((str_P) var ## _name)
+
+/**
+ * Support macro to start measurement with given probe.
+ * @param[in] var probe.
+ */
+#define PROBE_BEGIN(var) var.start()
+
+/**
+ * Support macro to stop measurement with given probe.
+ * @param[in] var probe.
+ */
+#define PROBE_END(var) var.stop()
+
+/**
+ * Support macros for interrupt service routine profile. Defines a
+ * probe and measures the service routine execution time when
+ * COSA_ISR_PROFILE is defined otherwise expands to nothing. The
+ * logic analyzer ISR probe channel is high during the service routine
+ * when COSA_PROBE_CHANNEL is defined (see Cosa/ProbeChannel.hh). The
+ * probe should be defined at file scope and ISR_PROBE() should be
+ * the first statement in the service routine.
+ * @code
+ * ISR_PROBE_DEFINE(spi_isr_probe, "isr:SPI_STC");
+ * ISR(SPI_STC_vect)
+ * {
+ *   ISR_PROBE(spi_isr_probe);
+ *   ...
+ * }
+ * @endcode
+ * @param[in] var probe variable name.
+ * @param[in] name probe name string.
+ */
+#if defined(COSA_ISR_PROFILE)
+#define ISR_PROBE_DEFINE(var,name)				\
+  static const char var ## _name[] __PROGMEM = name;		\
+  static Probe var((str_P) var ## _name)
+#define ISR_PROBE(var) PROBE_SCOPE(ISR); Probe::Scope __UNIQUE(var)(var)
+#endif
+#endif
+
+#if !defined(ISR_PROBE_DEFINE)
+#define ISR_PROBE_DEFINE(var,name)
+#define ISR_PROBE(var) PROBE_SCOPE(ISR)
+#endif
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @file Cosa/ProbeChannel.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_PROBE_CHANNEL_HH
+#define COSA_PROBE_CHANNEL_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * Logic analyzer probe channels. Each channel is a port bit that is
+ * mapped at compile time; the set, clear and toggle macros compile
+ * to single sbi/cbi/out instructions. The core marks the following
+ * channels when COSA_PROBE_CHANNEL is defined; otherwise the macros
+ * expand to nothing.
+ *
+ * EVENT: event handler dispatch (Event::dispatch()).
+ * JOB: job dispatch (Job::Scheduler and RTT::Scheduler).
+ * ISR: Cosa interrupt service routines (ISR_PROBE).
+ * SPI: SPI bus transactions (SPI::acquire() to SPI::release()).
+ * TWI: TWI bus transactions (TWI::acquire() to TWI::release()).
+ * USER: application.
+ *
+ * @section Circuit
+ * Default channel pins; Uno/Nano/Pro-Mini (ATmega328P), Mega and
+ * Mighty (ATmega1284P).
+ * @code
+ * Channel   ATmega328P   Mega      ATmega1284P
+ * EVENT     A0 (PC0)     A0 (PF0)  A0 (PA0)
+ * JOB       A1 (PC1)     A1 (PF1)  A1 (PA1)
+ * ISR       A2 (PC2)     A2 (PF2)  A2 (PA2)
+ * SPI       A3 (PC3)     A3 (PF3)  A3 (PA3)
+ * TWI       D7 (PD7)     A4 (PF4)  A4 (PA4)
+ * USER      D6 (PD6)     A5 (PF5)  A5 (PA5)
+ * @endcode
+ * The mapping may be changed by defining the port letter and bit
+ * for all channels (e.g. PROBE_EVENT_PORT C and PROBE_EVENT_BIT 0).
+ * The port must be in the lower i/o space for single instruction
+ * access.
+ *
+ * @section Usage
+ * @code
+ * PROBE_SET(USER);
+ * ...
+ * PROBE_CLEAR(USER);
+ * ...
+ * void function()
+ * {
+ *   PROBE_SCOPE(USER);
+ *   ...
+ * }
+ * @endcode
+ */
+#if defined(COSA_PROBE_CHANNEL)
+
+#if !defined(PROBE_EVENT_PORT)
+#if defined(BOARD_ATMEGA328P)
+#define PROBE_EVENT_PORT C
+#define PROBE_EVENT_BIT 0
+#define PROBE_JOB_PORT C
+#define PROBE_JOB_BIT 1
+#define PROBE_ISR_PORT C
+#define PROBE_ISR_BIT 2
+#define PROBE_SPI_PORT C
+#define PROBE_SPI_BIT 3
+#define PROBE_TWI_PORT D
+#define PROBE_TWI_BIT 7
+#define PROBE_USER_PORT D
+#define PROBE_USER_BIT 6
+#elif defined(BOARD_ATMEGA2560) || defined(BOARD_ATMEGA1248P)
+#if defined(BOARD_ATMEGA2560)
+#define PROBE_EVENT_PORT F
+#else
+#define PROBE_EVENT_PORT A
+#endif
+#define PROBE_EVENT_BIT 0
+#define PROBE_JOB_PORT PROBE_EVENT_PORT
+#define PROBE_JOB_BIT 1
+#define PROBE_ISR_PORT PROBE_EVENT_PORT
+#define PROBE_ISR_BIT 2
+#define PROBE_SPI_PORT PROBE_EVENT_PORT
+#define PROBE_SPI_BIT 3
+#define PROBE_TWI_PORT PROBE_EVENT_PORT
+#define PROBE_TWI_BIT 4
+#define PROBE_USER_PORT PROBE_EVENT_PORT
+#define PROBE_USER_BIT 5
+#else
+#error "Cosa/ProbeChannel.hh: define probe channel ports for board"
+#endif
+#endif
+
+// Register names from port letter; the letter is expanded first
+#define __PROBE_PORT(port) __PROBE_PORT2(port)
+#define __PROBE_PORT2(port) PORT ## port
+#define __PROBE_PIN(port) __PROBE_PIN2(port)
+#define __PROBE_PIN2(port) PIN ## port
+#define __PROBE_DDR(port) __PROBE_DDR2(port)
+#define __PROBE_DDR2(port) DDR ## port
+
+/**
+ * Set given probe channel.
+ * @param[in] ch channel name (EVENT, JOB, ISR, SPI, TWI, USER).
+ */
+#define PROBE_SET(ch)							\
+  (__PROBE_PORT(PROBE_ ## ch ## _PORT) |= _BV(PROBE_ ## ch ## _BIT))
+
+/**
+ * Clear given probe channel.
+ * @param[in] ch channel name.
+ */
+#define PROBE_CLEAR(ch)							\
+  (__PROBE_PORT(PROBE_ ## ch ## _PORT) &= ~_BV(PROBE_ ## ch ## _BIT))
+
+/**
+ * Toggle given probe channel (write to pin input register).
+ * @param[in] ch channel name.
+ */
+#define PROBE_TOGGLE(ch)						\
+  (__PROBE_PIN(PROBE_ ## ch ## _PORT) = _BV(PROBE_ ## ch ## _BIT))
+
+/**
+ * Set given probe channel and clear at the end of the enclosing
+ * block (all return paths).
+ * @param[in] ch channel name.
+ */
+#define PROBE_SCOPE(ch)							\
+  uint8_t __UNIQUE(__probe) __attribute__((cleanup(__probe_ ## ch)))	\
+  = (PROBE_SET(ch), 0)
+
+// Scope exit functions
+#define __PROBE_CLEANUP(ch)						\
+  static inline void __probe_ ## ch(uint8_t*)				\
+    __attribute__((always_inline, unused));				\
+  static inline void __probe_ ## ch(uint8_t*) { PROBE_CLEAR(ch); }
+__PROBE_CLEANUP(EVENT)
+__PROBE_CLEANUP(JOB)
+__PROBE_CLEANUP(ISR)
+__PROBE_CLEANUP(SPI)
+__PROBE_CLEANUP(TWI)
+__PROBE_CLEANUP(USER)
+
+/**
+ * Set the probe channel pins to output mode and clear. Called by
+ * init() before setup().
+ */
+#define PROBE_CHANNEL_BEGIN()						\
+  do {									\
+    __PROBE_OUTPUT(EVENT);						\
+    __PROBE_OUTPUT(JOB);						\
+    __PROBE_OUTPUT(ISR);						\
+    __PROBE_OUTPUT(SPI);						\
+    __PROBE_OUTPUT(TWI);						\
+    __PROBE_OUTPUT(USER);						\
+  } while (0)
+#define __PROBE_OUTPUT(ch)						\
+  PROBE_CLEAR(ch);							\
+  __PROBE_DDR(PROBE_ ## ch ## _PORT) |= _BV(PROBE_ ## ch ## _BIT)
+
+#else
+#define PROBE_SET(ch)
+#define PROBE_CLEAR(ch)
+#define PROBE_TOGGLE(ch)
+#define PROBE_SCOPE(ch)
+#define PROBE_CHANNEL_BEGIN()
+#endif
+#endif
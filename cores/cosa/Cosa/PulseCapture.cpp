@@ -0,0 +1,254 @@
+/**
+ * @file Cosa/PulseCapture.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/PulseCapture.hh"
+
+#if !defined(BOARD_ATTINY)
+
+// Check if width (us) is within given range
+#define WITHIN(w,min,max) (((w) >= (min)) && ((w) <= (max)))
+
+volatile uint8_t PulseCapture::s_overflows = 0;
+
+PulseCapture::PulseCapture(uint16_t* buffer, uint8_t nmemb,
+			   Prescale prescale) :
+  InputCapture(ON_FALLING_MODE),
+  m_buffer(buffer),
+  m_mask(nmemb - 1),
+  m_put(0),
+  m_get(0),
+  m_prescale(prescale),
+  m_last(0),
+  m_overflows(0),
+  m_valid(false),
+  m_overruns(0)
+{
+  uint8_t cs = (prescale == PRESCALE_1 ? _BV(CS10) :
+		prescale == PRESCALE_8 ? _BV(CS11) :
+		_BV(CS11) | _BV(CS10));
+  TCCR1B = (TCCR1B & ~(_BV(CS12) | _BV(CS11) | _BV(CS10))) | cs;
+}
+
+uint8_t
+PulseCapture::dispatch(PulseDecoder* decoder)
+{
+  uint8_t res = 0;
+  while (m_get != m_put) {
+    uint8_t next = (m_get + 1) & m_mask;
+    uint16_t edge = m_buffer[next];
+    m_get = next;
+    uint16_t ticks = edge & ~1;
+    uint16_t width = 0xffff;
+    if (ticks != WIDTH_MAX) {
+      uint32_t us = (((uint32_t) ticks) * m_prescale) / I_CPU;
+      if (us < 0xffff) width = us;
+    }
+    decoder->on_pulse(!(edge & 1), width);
+    res += 1;
+  }
+  return (res);
+}
+
+void
+PulseCapture::reset()
+{
+  synchronized {
+    m_get = m_put;
+    m_valid = false;
+  }
+}
+
+void
+PulseCapture::enable()
+{
+  synchronized {
+    m_valid = false;
+    TIFR1 = _BV(ICF1) | _BV(TOV1);
+    TIMSK1 |= _BV(ICIE1) | _BV(TOIE1);
+  }
+}
+
+void
+PulseCapture::disable()
+{
+  synchronized TIMSK1 &= ~(_BV(ICIE1) | _BV(TOIE1));
+}
+
+void
+PulseCapture::on_interrupt(uint16_t arg)
+{
+  // Level after the edge; toggle edge to capture
+  uint8_t level = ((TCCR1B & _BV(ICES1)) != 0);
+  TCCR1B ^= _BV(ICES1);
+  TIFR1 = _BV(ICF1);
+
+  // Account for pending overflow before the capture
+  uint8_t overflows = s_overflows;
+  if ((TIFR1 & _BV(TOV1)) && (arg < 0x8000)) overflows += 1;
+
+  // Width since previous edge; saturate if more than timer period
+  uint8_t wraps = overflows - m_overflows;
+  uint16_t width = arg - m_last;
+  bool saturate = (wraps > 1) || ((wraps == 1) && (arg >= m_last));
+  bool valid = m_valid;
+  m_last = arg;
+  m_overflows = overflows;
+  m_valid = true;
+  if (UNLIKELY(!valid)) return;
+  if (saturate || (width > WIDTH_MAX)) width = WIDTH_MAX;
+  width &= ~1;
+
+  // Store width and level in ring buffer
+  uint8_t next = (m_put + 1) & m_mask;
+  if (UNLIKELY(next == m_get)) {
+    m_overruns += 1;
+    return;
+  }
+  m_buffer[next] = width | level;
+  m_put = next;
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  PulseCapture::s_overflows += 1;
+}
+
+void
+PulseDecoder::NEC::on_pulse(uint8_t level, uint16_t width)
+{
+  // Header mark restarts the decoder in any state
+  if ((level == 0) && WITHIN(width, 8000, 10000)) {
+    m_state = HEADER;
+    return;
+  }
+  switch (m_state) {
+  case HEADER:
+    m_state = IDLE;
+    if (level == 0) return;
+    if (WITHIN(width, 4000, 5000)) {
+      m_state = DATA;
+      m_bits = 0;
+      m_code = 0;
+    }
+    else if (WITHIN(width, 1800, 2700)) {
+      on_repeat();
+    }
+    return;
+  case DATA:
+    if (level == 0) {
+      if (!WITHIN(width, 300, 900)) m_state = IDLE;
+      return;
+    }
+    m_code >>= 1;
+    if (WITHIN(width, 1300, 2000))
+      m_code |= 0x80000000UL;
+    else if (!WITHIN(width, 300, 900)) {
+      m_state = IDLE;
+      return;
+    }
+    if (++m_bits < 32) return;
+    m_state = IDLE;
+    on_code(m_code);
+    return;
+  default:
+    return;
+  }
+}
+
+void
+PulseDecoder::RC5::half_bit(uint8_t level)
+{
+  // Bit value is given by the second half; high-to-low is one. The
+  // last bit is given by the first half as the trailing high level
+  // merges with idle
+  m_half += 1;
+  if ((m_half & 1) && (m_bits != BITS_MAX - 1)) return;
+  m_code = (m_code << 1) | ((m_half & 1) ? level : !level);
+  if (++m_bits < BITS_MAX) return;
+  m_half = 0;
+  on_code(m_code);
+}
+
+void
+PulseDecoder::RC5::on_pulse(uint8_t level, uint16_t width)
+{
+  // Idle (high) before the first mark; first half of start bit
+  if ((level == 1) && (width > 2500)) {
+    m_half = 1;
+    m_bits = 0;
+    m_code = 0;
+    return;
+  }
+  if (m_half == 0) return;
+  if (WITHIN(width, 600, 1200)) {
+    half_bit(level);
+  }
+  else if (WITHIN(width, 1300, 2100)) {
+    half_bit(level);
+    if (m_half != 0) half_bit(level);
+  }
+  else {
+    m_half = 0;
+  }
+}
+
+void
+PulseDecoder::DHT::on_pulse(uint8_t level, uint16_t width)
+{
+  // Low pulses separate the bits; only check for glitches
+  if (level == 0) {
+    if (width > 100) m_bits = 0xff;
+    return;
+  }
+
+  // Sensor response; start of frame
+  if (WITHIN(width, 60, 100) && (m_bits == 0xff)) {
+    m_bits = 0;
+    memset(m_data, 0, sizeof(m_data));
+    return;
+  }
+  if (m_bits == 0xff) return;
+
+  // Data bits; MSB first, one if longer than the low separator
+  if (width > 50) m_data[m_bits >> 3] |= (0x80 >> (m_bits & 7));
+  if (++m_bits < DATA_MAX * CHARBITS) return;
+  m_bits = 0xff;
+  uint8_t sum = m_data[0] + m_data[1] + m_data[2] + m_data[3];
+  if (sum == m_data[4]) on_frame(m_data);
+}
+
+void
+PulseDecoder::Frequency::on_pulse(uint8_t level, uint16_t width)
+{
+  UNUSED(level);
+  if (width == 0xffff) {
+    m_count = 0;
+    m_sum = 0;
+    return;
+  }
+  m_sum += width;
+  if (++m_count < (m_periods << 1)) return;
+  m_frequency = (m_sum == 0) ? 0 : (1000000UL * m_periods) / m_sum;
+  m_count = 0;
+  m_sum = 0;
+  on_frequency(m_frequency);
+}
+
+#endif
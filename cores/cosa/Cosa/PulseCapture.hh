@@ -0,0 +1,412 @@
+/**
+ * @file Cosa/PulseCapture.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_PULSE_CAPTURE_HH
+#define COSA_PULSE_CAPTURE_HH
+
+#include "Cosa/InputCapture.hh"
+
+#if !defined(BOARD_ATTINY)
+
+/**
+ * Abstract pulse train decoder. Receives the level and width (in
+ * micro-seconds) of each pulse from PulseCapture::dispatch(). Called
+ * from the main loop; never from an interrupt handler.
+ */
+class PulseDecoder {
+public:
+  /**
+   * @override{PulseDecoder}
+   * Decode pulse with given level and width. Width is saturated to
+   * 0xffff for long pulses.
+   * @param[in] level of pulse (0 low, 1 high).
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width) = 0;
+
+  /**
+   * NEC infrared remote protocol decoder for an active low receiver
+   * (e.g. TSOP4838). Receives 9 ms/4.5 ms header and 32 bits in
+   * pulse distance encoding (LSB first). Repeat frames (9 ms/2.25 ms)
+   * are reported with on_repeat().
+   */
+  class NEC;
+
+  /**
+   * RC5 infrared remote protocol decoder for an active low receiver.
+   * Manchester encoded 14 bits with 889 us half-bit period.
+   */
+  class RC5;
+
+  /**
+   * DHT11/22 humidity and temperature sensor frame decoder. The
+   * sensor response (80 us low, 80 us high) is followed by 40 bits;
+   * 50 us low and 26-28 us (zero) or 70 us (one) high.
+   */
+  class DHT;
+
+  /**
+   * Pulse width decoder; reports width of pulses with a given level,
+   * e.g. HCSR04 echo pulse.
+   */
+  class Width;
+
+  /**
+   * Frequency decoder; reports frequency averaged over a number of
+   * periods, e.g. TCS230 color sensor output.
+   */
+  class Frequency;
+};
+
+class PulseDecoder::NEC : public PulseDecoder {
+public:
+  /**
+   * Construct NEC decoder.
+   */
+  NEC() : m_state(IDLE), m_bits(0), m_code(0) {}
+
+  /**
+   * @override{PulseDecoder::NEC}
+   * Called when a complete code has been received; address,
+   * inverted address, command and inverted command (LSB first).
+   * @param[in] code received.
+   */
+  virtual void on_code(uint32_t code)
+  {
+    UNUSED(code);
+  }
+
+  /**
+   * @override{PulseDecoder::NEC}
+   * Called when a repeat frame has been received.
+   */
+  virtual void on_repeat() {}
+
+  /**
+   * @override{PulseDecoder}
+   * Decode NEC frame pulses.
+   * @param[in] level of pulse.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width);
+
+protected:
+  enum {
+    IDLE,			//!< Wait for header mark.
+    HEADER,			//!< Wait for header space.
+    DATA			//!< Receiving bits.
+  };
+  uint8_t m_state;		//!< Decoder state.
+  uint8_t m_bits;		//!< Number of bits received.
+  uint32_t m_code;		//!< Code being received.
+};
+
+class PulseDecoder::RC5 : public PulseDecoder {
+public:
+  /**
+   * Construct RC5 decoder.
+   */
+  RC5() : m_half(0), m_bits(0), m_code(0) {}
+
+  /**
+   * @override{PulseDecoder::RC5}
+   * Called when a complete code has been received; start bits,
+   * toggle, 5-bit address and 6-bit command (MSB first).
+   * @param[in] code received (14 bits).
+   */
+  virtual void on_code(uint16_t code)
+  {
+    UNUSED(code);
+  }
+
+  /**
+   * @override{PulseDecoder}
+   * Decode RC5 frame pulses.
+   * @param[in] level of pulse.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width);
+
+protected:
+  /** Number of bits in frame. */
+  static const uint8_t BITS_MAX = 14;
+
+  uint8_t m_half;		//!< Half-bit index in frame (0 idle).
+  uint8_t m_bits;		//!< Number of bits received.
+  uint16_t m_code;		//!< Code being received.
+
+  /**
+   * Add half-bit with given level.
+   * @param[in] level of half-bit.
+   */
+  void half_bit(uint8_t level);
+};
+
+class PulseDecoder::DHT : public PulseDecoder {
+public:
+  /**
+   * Construct DHT frame decoder.
+   */
+  DHT() : m_bits(0xff) {}
+
+  /**
+   * @override{PulseDecoder::DHT}
+   * Called when a frame with correct checksum has been received.
+   * @param[in] data frame; humidity, temperature and checksum.
+   */
+  virtual void on_frame(const uint8_t* data)
+  {
+    UNUSED(data);
+  }
+
+  /**
+   * @override{PulseDecoder}
+   * Decode DHT frame pulses.
+   * @param[in] level of pulse.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width);
+
+protected:
+  /** Number of bytes in frame. */
+  static const uint8_t DATA_MAX = 5;
+
+  uint8_t m_bits;		//!< Number of bits received (0xff idle).
+  uint8_t m_data[DATA_MAX];	//!< Frame being received.
+};
+
+class PulseDecoder::Width : public PulseDecoder {
+public:
+  /**
+   * Construct width decoder for pulses with given level.
+   * @param[in] level of pulses to report (default high).
+   */
+  Width(uint8_t level = 1) : m_level(level), m_width(0) {}
+
+  /**
+   * Return width of latest pulse.
+   * @return micro-seconds.
+   */
+  uint16_t width() const
+  {
+    return (m_width);
+  }
+
+  /**
+   * @override{PulseDecoder::Width}
+   * Called with width of each pulse with the given level.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_width(uint16_t width)
+  {
+    UNUSED(width);
+  }
+
+  /**
+   * @override{PulseDecoder}
+   * Report pulses with the given level.
+   * @param[in] level of pulse.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width)
+  {
+    if (level != m_level) return;
+    m_width = width;
+    on_width(width);
+  }
+
+protected:
+  uint8_t m_level;		//!< Level of pulses to report.
+  uint16_t m_width;		//!< Latest pulse width.
+};
+
+class PulseDecoder::Frequency : public PulseDecoder {
+public:
+  /**
+   * Construct frequency decoder averaging over given number of
+   * periods.
+   * @param[in] periods per measurement (default 16).
+   */
+  Frequency(uint8_t periods = 16) :
+    m_periods(periods),
+    m_count(0),
+    m_sum(0),
+    m_frequency(0)
+  {}
+
+  /**
+   * Return latest frequency.
+   * @return frequency (Hz).
+   */
+  uint32_t frequency() const
+  {
+    return (m_frequency);
+  }
+
+  /**
+   * @override{PulseDecoder::Frequency}
+   * Called with each new frequency measurement.
+   * @param[in] frequency (Hz).
+   */
+  virtual void on_frequency(uint32_t frequency)
+  {
+    UNUSED(frequency);
+  }
+
+  /**
+   * @override{PulseDecoder}
+   * Accumulate periods and calculate frequency.
+   * @param[in] level of pulse.
+   * @param[in] width of pulse in micro-seconds.
+   */
+  virtual void on_pulse(uint8_t level, uint16_t width);
+
+protected:
+  uint8_t m_periods;		//!< Number of periods per measurement.
+  uint8_t m_count;		//!< Number of pulses accumulated.
+  uint32_t m_sum;		//!< Accumulated width (us).
+  uint32_t m_frequency;		//!< Latest frequency.
+};
+
+/**
+ * Input Capture pulse train recorder. The interrupt handler records
+ * the width (timer ticks since the previous edge) and level of each
+ * edge on the input capture pin into a ring buffer and toggles the
+ * capture edge so that both edges are captured. Timer overflows are
+ * counted so that pulses longer than the timer period are reported
+ * as saturated instead of wrapping. The pulses are decoded
+ * asynchronously (e.g. from the main loop) with dispatch() and a
+ * pulse decoder.
+ * @code
+ * uint16_t edges[32];
+ * PulseCapture capture(edges, membersof(edges));
+ * PulseDecoder::NEC remote;
+ * ...
+ * capture.begin();
+ * capture.enable();
+ * ...
+ * capture.dispatch(&remote);
+ * @endcode
+ * @section Limitations
+ * Uses Timer1 (capture and overflow interrupt) and the hardwired
+ * input capture pin (ICP1, D8 on ATmega328P). The width resolution
+ * is two timer ticks (the least significant bit holds the level).
+ * The max width is 65534 ticks; 32 ms with PRESCALE_8 at 16 MHz.
+ */
+class PulseCapture : public InputCapture {
+public:
+  /** Timer prescale. */
+  enum Prescale {
+    PRESCALE_1 = 1,
+    PRESCALE_8 = 8,
+    PRESCALE_64 = 64
+  } __attribute__((packed));
+
+  /** Width of saturated pulse (timer ticks). */
+  static const uint16_t WIDTH_MAX = 0xfffe;
+
+  /**
+   * Construct pulse capture with given edge buffer and timer
+   * prescale.
+   * @param[in] buffer edge storage.
+   * @param[in] nmemb number of edges in buffer (power of 2, max 128).
+   * @param[in] prescale timer prescale (default PRESCALE_8).
+   */
+  PulseCapture(uint16_t* buffer, uint8_t nmemb,
+	       Prescale prescale = PRESCALE_8);
+
+  /**
+   * Return number of recorded edges in ring buffer.
+   * @return edges.
+   */
+  uint8_t available() const
+  {
+    return ((m_put - m_get) & m_mask);
+  }
+
+  /**
+   * Return number of edges dropped due to full ring buffer.
+   * @return overruns.
+   * @note atomic
+   */
+  uint16_t overruns() const
+  {
+    uint16_t res;
+    synchronized res = m_overruns;
+    return (res);
+  }
+
+  /**
+   * Decode the recorded edges with the given decoder. The level and
+   * width of each completed pulse is passed to the decoder. Returns
+   * number of pulses decoded.
+   * @param[in] decoder pulse train decoder.
+   * @return pulses.
+   */
+  uint8_t dispatch(PulseDecoder* decoder);
+
+  /**
+   * Flush recorded edges. The next edge starts a new pulse train.
+   * @note atomic
+   */
+  void reset();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Enable input capture and timer overflow interrupt. The next edge
+   * starts a new pulse train.
+   * @note atomic
+   */
+  virtual void enable();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Disable input capture and timer overflow interrupt.
+   * @note atomic
+   */
+  virtual void disable();
+
+  /**
+   * @override{Interrupt::Handler}
+   * Record width and level of the captured edge and toggle the edge
+   * to capture.
+   * @param[in] arg timer count on event.
+   */
+  virtual void on_interrupt(uint16_t arg);
+
+protected:
+  /** Number of timer overflows. */
+  static volatile uint8_t s_overflows;
+
+  uint16_t* m_buffer;		//!< Edge width and level.
+  const uint8_t m_mask;		//!< Buffer index mask.
+  volatile uint8_t m_put;	//!< Buffer put index.
+  volatile uint8_t m_get;	//!< Buffer get index.
+  const Prescale m_prescale;	//!< Timer prescale.
+  uint16_t m_last;		//!< Timer count of latest edge.
+  uint8_t m_overflows;		//!< Overflow count at latest edge.
+  bool m_valid;			//!< Latest edge valid.
+  volatile uint16_t m_overruns;	//!< Number of dropped edges.
+
+  friend void TIMER1_OVF_vect(void);
+};
+
+#endif
+#endif
@@ -23,17 +23,28 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Power.hh"
+#include "Cosa/Ring.hh"
 
 /**
  * Template class for ring-buffer for queueing data elements.
- * See Event::queue for an example of usage.
+ * See Event::queue for an example of usage. The atomic member
+ * functions (enqueue() and dequeue()) disable interrupts during the
+ * copy of the element and allow several producers and consumers.
+ * The lock-free member functions (put() and get()) are for a single
+ * producer and a single consumer (e.g. interrupt handler and main
+ * loop) and only rely on ordered updates of the indexes. The index
+ * type is 8-bit by default (max 256 elements). A 16-bit index allows
+ * larger queues and is read with interrupts disabled in the lock-free
+ * member functions.
  * @param[in] T element class.
- * @param[in] nmemb number of elements in queue.
- * @pre nmemb is powerof(2) and max 128.
+ * @param[in] NMEMB number of elements in queue.
+ * @param[in] INDEX index type (default uint8_t).
+ * @pre NMEMB is powerof(2) and max 256 for 8-bit index.
  */
-template <class T, uint8_t NMEMB>
+template <class T, uint16_t NMEMB, class INDEX = uint8_t>
 class Queue {
   static_assert(NMEMB && !(NMEMB & (NMEMB - 1)), "NMEMB should be power of 2");
+  static_assert(NMEMB - 1 <= (INDEX) -1, "INDEX too small for NMEMB");
 public:
   /**
    * Construct a ring-buffer queue with given number of members
@@ -48,20 +59,20 @@ public:
    * Return number of elements in queue.
    * @return available elements.
    */
-  uint8_t available() const
+  INDEX available() const
     __attribute__((always_inline))
   {
-    return ((NMEMB + m_put - m_get) & MASK);
+    return ((NMEMB + Ring::load(m_put) - Ring::load(m_get)) & MASK);
   }
 
   /**
    * Number of elements room in queue.
    * @return room for elements.
    */
-  uint8_t room() const
+  INDEX room() const
     __attribute__((always_inline))
   {
-    return ((NMEMB - m_put + m_get - 1) & MASK);
+    return ((NMEMB - Ring::load(m_put) + Ring::load(m_get) - 1) & MASK);
   }
 
   /**
@@ -98,6 +109,65 @@ public:
    */
   bool dequeue(T* data);
 
+  /**
+   * Enqueue given member data if storage is available without
+   * disabling interrupts. Return true(1) if successful otherwise
+   * false(0). The member is copied before the put index is updated.
+   * Single producer only; may be called from an interrupt handler.
+   * @param[in] data pointer to member data buffer.
+   * @return boolean.
+   * @pre data != NULL
+   */
+  bool put(const T* data);
+
+  /**
+   * Enqueue at most given number of members from given buffer
+   * without disabling interrupts. Returns number of members
+   * enqueued (limited by room in queue). The members are copied in
+   * at most two segments and the put index is updated once. Single
+   * producer only.
+   * @param[in] buf pointer to member data buffer.
+   * @param[in] count max number of members.
+   * @pre buf != NULL
+   * @return number of members.
+   */
+  INDEX put(const T* buf, INDEX count);
+
+  /**
+   * Dequeue member data from queue to given buffer without disabling
+   * interrupts. Returns true(1) if member was available otherwise
+   * false(0). The member is copied before the get index is updated.
+   * Single consumer only.
+   * @param[in,out] data pointer to member data buffer.
+   * @return boolean.
+   * @pre data != NULL
+   */
+  bool get(T* data);
+
+  /**
+   * Dequeue at most given number of members from queue to given
+   * buffer without disabling interrupts. Returns number of members
+   * dequeued. The members are copied in at most two segments and the
+   * get index is updated once, after the members have been
+   * copied. Single consumer only.
+   * @param[in,out] buf pointer to member data buffer.
+   * @param[in] count max number of members.
+   * @pre buf != NULL
+   * @return number of members.
+   */
+  INDEX get(T* buf, INDEX count);
+
+  /**
+   * Return pointer to the first queued member that matches the given
+   * data with the given function, otherwise NULL. The member may be
+   * updated in place. Should be called with interrupts disabled when
+   * the queue is used by an interrupt handler.
+   * @param[in] match member compare function.
+   * @param[in] data pointer to member data to match.
+   * @return member pointer or NULL.
+   */
+  T* find(bool (*match)(const T* member, const T* data), const T* data);
+
   /**
    * Await data to become available from queue. Will perform a system
    * sleep with the given sleep mode.
@@ -108,18 +178,18 @@ public:
   void await(T* data);
 
 private:
-  static const uint8_t MASK = (NMEMB - 1);
-  volatile uint8_t m_put;
-  volatile uint8_t m_get;
+  static const INDEX MASK = (NMEMB - 1);
+  volatile INDEX m_put;
+  volatile INDEX m_get;
   T m_buffer[NMEMB];
 };
 
-template <class T, uint8_t NMEMB>
+template <class T, uint16_t NMEMB, class INDEX>
 bool
-Queue<T,NMEMB>::enqueue(T* data)
+Queue<T,NMEMB,INDEX>::enqueue(T* data)
 {
   synchronized {
-    uint8_t next = (m_put + 1) & MASK;
+    INDEX next = (m_put + 1) & MASK;
     if (UNLIKELY(next == m_get)) return (false);
     m_buffer[next] = *data;
     m_put = next;
@@ -127,12 +197,12 @@ Queue<T,NMEMB>::enqueue(T* data)
   return (true);
 }
 
-template <class T, uint8_t NMEMB>
+template <class T, uint16_t NMEMB, class INDEX>
 bool
-Queue<T,NMEMB>::enqueue_P(const T* data)
+Queue<T,NMEMB,INDEX>::enqueue_P(const T* data)
 {
   synchronized {
-    uint8_t next = (m_put + 1) & MASK;
+    INDEX next = (m_put + 1) & MASK;
     if (UNLIKELY(next == m_get)) return (false);
     memcpy_P(&m_buffer[next], data, sizeof(T));
     m_put = next;
@@ -140,22 +210,86 @@ Queue<T,NMEMB>::enqueue_P(const T* data)
   return (true);
 }
 
-template <class T, uint8_t NMEMB>
+template <class T, uint16_t NMEMB, class INDEX>
 bool
-Queue<T,NMEMB>::dequeue(T* data)
+Queue<T,NMEMB,INDEX>::dequeue(T* data)
 {
   synchronized {
     if (UNLIKELY(m_get == m_put)) return (false);
-    uint8_t next = (m_get + 1) & MASK;
+    INDEX next = (m_get + 1) & MASK;
     m_get = next;
     *data = m_buffer[next];
   }
   return (true);
 }
 
-template <class T, uint8_t NMEMB>
+template <class T, uint16_t NMEMB, class INDEX>
+bool
+Queue<T,NMEMB,INDEX>::put(const T* data)
+{
+  INDEX next = (m_put + 1) & MASK;
+  if (UNLIKELY(next == Ring::load(m_get))) return (false);
+  m_buffer[next] = *data;
+  barrier();
+  Ring::store(m_put, next);
+  return (true);
+}
+
+template <class T, uint16_t NMEMB, class INDEX>
+INDEX
+Queue<T,NMEMB,INDEX>::put(const T* buf, INDEX count)
+{
+  INDEX put = m_put;
+  INDEX n = (NMEMB - put + Ring::load(m_get) - 1) & MASK;
+  if (count < n) n = count;
+  if (UNLIKELY(n == 0)) return (0);
+  Ring::write(m_buffer, NMEMB, (put + 1) & MASK, buf, n);
+  barrier();
+  Ring::store(m_put, (INDEX) ((put + n) & MASK));
+  return (n);
+}
+
+template <class T, uint16_t NMEMB, class INDEX>
+bool
+Queue<T,NMEMB,INDEX>::get(T* data)
+{
+  if (UNLIKELY(m_get == Ring::load(m_put))) return (false);
+  INDEX next = (m_get + 1) & MASK;
+  *data = m_buffer[next];
+  barrier();
+  Ring::store(m_get, next);
+  return (true);
+}
+
+template <class T, uint16_t NMEMB, class INDEX>
+INDEX
+Queue<T,NMEMB,INDEX>::get(T* buf, INDEX count)
+{
+  INDEX get = m_get;
+  INDEX n = (NMEMB + Ring::load(m_put) - get) & MASK;
+  if (count < n) n = count;
+  if (UNLIKELY(n == 0)) return (0);
+  Ring::read(m_buffer, NMEMB, (get + 1) & MASK, buf, n);
+  barrier();
+  Ring::store(m_get, (INDEX) ((get + n) & MASK));
+  return (n);
+}
+
+template <class T, uint16_t NMEMB, class INDEX>
+T*
+Queue<T,NMEMB,INDEX>::find(bool (*match)(const T* member, const T* data),
+			   const T* data)
+{
+  for (INDEX ix = m_get; ix != m_put;) {
+    ix = (ix + 1) & MASK;
+    if (match(&m_buffer[ix], data)) return (&m_buffer[ix]);
+  }
+  return (NULL);
+}
+
+template <class T, uint16_t NMEMB, class INDEX>
 void
-Queue<T,NMEMB>::await(T* data)
+Queue<T,NMEMB,INDEX>::await(T* data)
 {
   while (!dequeue(data)) yield();
 }
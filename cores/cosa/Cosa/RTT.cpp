@@ -20,12 +20,14 @@
 
 #include "Cosa/RTT.hh"
 #include "Cosa/RTT_Config.hh"
+#include "Cosa/Probe.hh"
 
 // Initiated state
 bool RTT::s_initiated = false;
 
-// Micro-seconds counter (fraction in timer register)
+// Micro-seconds counter (fraction in timer register) and wraps
 uint32_t RTT::s_micros = 0UL;
+uint16_t RTT::s_micros_hi = 0;
 
 // Milli-seconds counter
 uint32_t RTT::s_millis = 0UL;
@@ -39,6 +41,29 @@ RTT::Clock* RTT::s_clock = NULL;
 // Timer job
 Job* RTT::s_job = NULL;
 
+#if defined(COSA_RTT_JITTER)
+// Job dispatch latency
+int16_t RTT::s_jitter_min = INT16_MAX;
+int16_t RTT::s_jitter_max = INT16_MIN;
+#endif
+
+#if defined(COSA_RTT_ASYNC)
+// Micro-seconds fraction of milli-seconds counter
+uint16_t RTT::s_us = 0;
+#endif
+
+#if defined(COSA_RTT_TICKLESS)
+// Idle prescale flag
+bool RTT::s_idle = false;
+
+// Micro-seconds fraction of milli-seconds counter
+uint16_t RTT::s_us = 0;
+
+// Delay wake up time and flag
+uint32_t RTT::s_wake = 0UL;
+bool RTT::s_delay = false;
+#endif
+
 bool
 RTT::begin()
 {
@@ -49,6 +74,23 @@ RTT::begin()
     // Power up the timers
     Power::timern_enable();
 
+#if defined(COSA_RTT_ASYNC)
+    // Clock the timer from the crystal; prescaling 8
+    TIMSKn = 0;
+    ASSR = _BV(AS2);
+    TCCRnB = CSn;
+
+    // Clear Timer on Compare Match with given Count. Reset the counter
+    TCCRnA = _BV(WGM01);
+    OCRnA = TIMER_MAX;
+    TCNTn = 0;
+
+    // Wait for the register updates, clear and enable interrupt
+    while (ASSR & ASYNC_BUSY);
+    TIFRn = _BV(OCF2B) | _BV(OCF2A) | _BV(TOV2);
+    TIMSKn = _BV(OCIE0A);
+    s_us = 0;
+#else
     // Set prescaling to 64
     TCCRnB = CSn;
 
@@ -60,10 +102,17 @@ RTT::begin()
     // Reset the counter and clear interrupts
     TCNTn = 0;
     TIFRn = 0;
+#endif
+#if defined(COSA_RTT_TICKLESS)
+    s_idle = false;
+    s_us = 0;
+#endif
   }
 
-  // Install delay function and mark as initiated
+  // Install delay function and mark as initiated. The timer requires
+  // idle sleep mode (power save mode when asynchronous)
   ::delay = RTT::delay;
+  Power::acquire(POWER_LEVEL);
   s_initiated = true;
   return (true);
 }
@@ -77,12 +126,16 @@ RTT::end()
   synchronized {
     // Disable the timer interrupts
     TIMSKn = 0;
+#if defined(COSA_RTT_ASYNC)
+    ASSR = 0;
+#endif
 
     // Power up the timers
     Power::timern_disable();
   }
 
   // Mark as not initiated
+  Power::release(POWER_LEVEL);
   s_initiated = false;
   return (true);
 }
@@ -99,6 +152,7 @@ RTT::us_per_timer_cycle()
   return (US_PER_TIMER_CYCLE);
 }
 
+#if !defined(COSA_RTT_TICKLESS)
 uint32_t
 RTT::micros()
 {
@@ -113,10 +167,36 @@ RTT::micros()
   }
 
   // Convert ticks to micro-seconds
-  res += ((uint32_t) cnt) * US_PER_TIMER_CYCLE;
+  res += US_TIMER_CYCLES(cnt);
   return (res);
 }
 
+uint64_t
+RTT::micros64()
+{
+  uint32_t res;
+  uint16_t hi;
+  uint8_t cnt;
+
+  // Read micro-seconds, wraps and hardware counter. Adjust if pending
+  // interrupt
+  synchronized {
+    res = s_micros;
+    hi = s_micros_hi;
+    cnt = TCNTn;
+    if ((TIFRn & _BV(OCF0A)) && (cnt < TIMER_MAX)) {
+      res += US_PER_TICK;
+      if (res < US_PER_TICK) hi += 1;
+    }
+  }
+
+  // Convert ticks to micro-seconds and carry to the wrap counter
+  uint32_t us = US_TIMER_CYCLES(cnt);
+  res += us;
+  if (res < us) hi += 1;
+  return ((((uint64_t) hi) << 32) | res);
+}
+
 uint32_t
 RTT::millis()
 {
@@ -132,21 +212,222 @@ RTT::millis()
   return (res);
 }
 
+#else
+uint32_t
+RTT::micros()
+{
+  uint32_t res;
+  uint16_t us;
+  uint8_t cnt;
+
+  // Read micro-seconds, hardware counter and period. Adjust if
+  // pending interrupt
+  synchronized {
+    res = s_micros;
+    cnt = TCNTn;
+    uint8_t top = OCRnA;
+    us = s_idle ? US_PER_IDLE_CYCLE : US_PER_TIMER_CYCLE;
+    if ((TIFRn & _BV(OCF0A)) && (cnt < top)) res += (top + 1UL) * us;
+  }
+
+  // Convert ticks to micro-seconds
+  res += ((uint32_t) cnt) * us;
+  return (res);
+}
+
+uint64_t
+RTT::micros64()
+{
+  uint32_t res;
+  uint32_t us;
+  uint16_t hi;
+
+  // Read micro-seconds, wraps, hardware counter and period. Adjust
+  // if pending interrupt
+  synchronized {
+    res = s_micros;
+    hi = s_micros_hi;
+    uint8_t cnt = TCNTn;
+    uint8_t top = OCRnA;
+    uint16_t cycle = s_idle ? US_PER_IDLE_CYCLE : US_PER_TIMER_CYCLE;
+    us = ((uint32_t) cnt) * cycle;
+    if ((TIFRn & _BV(OCF0A)) && (cnt < top)) us += (top + 1UL) * cycle;
+  }
+
+  // Add elapsed micro-seconds and carry to the wrap counter
+  res += us;
+  if (res < us) hi += 1;
+  return ((((uint64_t) hi) << 32) | res);
+}
+
+uint32_t
+RTT::millis()
+{
+  uint32_t res;
+  uint32_t us;
+
+  // Read milli-seconds, fraction and counter. Adjust if pending interrupt
+  synchronized {
+    res = s_millis;
+    uint8_t cnt = TCNTn;
+    uint8_t top = OCRnA;
+    uint16_t cycle = s_idle ? US_PER_IDLE_CYCLE : US_PER_TIMER_CYCLE;
+    if ((TIFRn & _BV(OCF0A)) && (cnt < top)) cnt += top + 1;
+    us = s_us + ((uint32_t) cnt) * cycle;
+  }
+  return (res + (us / 1000));
+}
+
+void
+RTT::account(uint32_t us)
+{
+  // Increment micro-seconds counter (fraction in timer) and wraps
+  s_micros += us;
+  if (s_micros < us) s_micros_hi += 1;
+
+  // Increment milli-seconds counter and keep fraction
+  us += s_us;
+  uint16_t ms = us / 1000;
+  s_us = us - (ms * 1000UL);
+  s_millis += ms;
+
+  // Clock tick and dispatch expired jobs
+  if ((s_clock != NULL) && (ms != 0))
+    s_clock->tick(ms);
+}
+
+void
+RTT::program()
+{
+  // Time until next job or delay wake up; default maximum period
+  int32_t us = (IDLE_TIMER_MAX + 1UL) * US_PER_IDLE_CYCLE;
+  if (s_job == NULL) {
+    if (s_scheduler != NULL) {
+      int32_t diff = s_scheduler->expire_after();
+      if (diff < us) us = diff;
+    }
+    if (s_delay) {
+      int32_t diff = s_wake - micros();
+      if (diff <= 0) s_delay = false;
+      else if (diff < us) us = diff;
+    }
+  }
+  else us = 0;
+
+  // Check if the timer prescale should be changed. Account timer
+  // cycles since the match with the current prescale
+  bool idle = (us >= US_IDLE_MIN);
+  if (idle != s_idle) {
+    uint8_t cnt = TCNTn;
+    TCNTn = 0;
+    account(((uint32_t) cnt) * (s_idle ? US_PER_IDLE_CYCLE : US_PER_TIMER_CYCLE));
+    s_idle = idle;
+  }
+
+  // Use the normal tick period if the deadline is near
+  if (!idle) {
+    TCCRnB = CSn;
+    OCRnA = TIMER_MAX;
+  }
+
+  // Otherwise wake up one tick before the deadline
+  else {
+    uint16_t cycles = (us - US_PER_TICK) / US_PER_IDLE_CYCLE;
+    if (cycles > IDLE_TIMER_MAX + 1) cycles = IDLE_TIMER_MAX + 1;
+    TCCRnB = CSn_IDLE;
+    OCRnA = cycles - 1;
+  }
+
+  // Reset the prescaler (when not shared with other timers)
+  if (PSRn) GTCCR |= PSRn;
+}
+
+void
+RTT::wakeup(int32_t us)
+{
+  synchronized {
+    // Check if already awake or pending interrupt
+    if (!s_idle || (TIFRn & _BV(OCF0A))) return;
+
+    // Check if wake up is before end of idle period
+    uint8_t cnt = TCNTn;
+    int32_t left = (OCRnA - cnt) * (int32_t) US_PER_IDLE_CYCLE;
+    if (us >= left) return;
+
+    // Account elapsed timer cycles and program the next period
+    TCNTn = 0;
+    account(((uint32_t) cnt) * US_PER_IDLE_CYCLE);
+    program();
+  }
+}
+#endif
+
 void
 RTT::delay(uint32_t ms)
 {
   uint32_t start = RTT::millis();
   ms += 1;
+#if defined(COSA_RTT_TICKLESS)
+  // Request wake up at delay deadline (earliest pending delay)
+  uint32_t us = ms * 1000UL;
+  synchronized {
+    uint32_t at = micros() + us;
+    if (!s_delay || ((int32_t) (at - s_wake) < 0)) {
+      s_wake = at;
+      s_delay = true;
+    }
+  }
+  wakeup(us);
+#endif
   while (RTT::since(start) < ms) yield();
 }
 
+ISR_PROBE_DEFINE(compa_isr_probe, "isr:RTT_COMPA");
+ISR_PROBE_DEFINE(compb_isr_probe, "isr:RTT_COMPB");
+
+#if defined(COSA_RTT_TICKLESS)
 ISR(TIMERn_COMPA_vect)
 {
-  // Increment micro-seconds counter (fraction in timer)
-  RTT::s_micros += US_PER_TICK;
+  ISR_PROBE(compa_isr_probe);
+
+  // Account the elapsed period
+  uint16_t cycle = RTT::s_idle ? US_PER_IDLE_CYCLE : US_PER_TIMER_CYCLE;
+  RTT::account((OCRnA + 1UL) * cycle);
 
+  // Program the next timer period before dispatch of expired jobs
+  // so that the timer match is used in the normal tick period
+  RTT::program();
+
+  // Dispatch expired jobs
+  if ((RTT::s_scheduler != NULL) && (RTT::s_job == NULL))
+    RTT::s_scheduler->dispatch();
+}
+#else
+ISR(TIMERn_COMPA_vect)
+{
+  ISR_PROBE(compa_isr_probe);
+
+  // Increment micro-seconds counter (fraction in timer) and wraps
+  RTT::s_micros += US_PER_TICK;
+  if (RTT::s_micros < US_PER_TICK) RTT::s_micros_hi += 1;
+
+#if defined(COSA_RTT_ASYNC)
+  // Increment milli-seconds counter and keep fraction. Rewrite the
+  // compare match so that the next sleep waits for a crystal cycle
+  uint16_t ms = MS_PER_TICK;
+  uint16_t us = RTT::s_us + (US_PER_TICK % 1000);
+  if (us >= 1000) {
+    us -= 1000;
+    ms += 1;
+  }
+  RTT::s_us = us;
+  RTT::s_millis += ms;
+  OCRnA = TIMER_MAX;
+#else
   // Increment milli-seconds counter
-  RTT::s_millis += MS_PER_TICK;
+  const uint16_t ms = MS_PER_TICK;
+  RTT::s_millis += ms;
+#endif
 
   // Dispatch expired jobs
   if ((RTT::s_scheduler != NULL) && (RTT::s_job == NULL))
@@ -154,11 +435,14 @@ ISR(TIMERn_COMPA_vect)
 
   // Clock tick and dispatch expired jobs
   if (RTT::s_clock != NULL)
-    RTT::s_clock->tick(MS_PER_TICK);
+    RTT::s_clock->tick(ms);
 }
+#endif
 
 ISR(TIMERn_COMPB_vect)
 {
+  ISR_PROBE(compb_isr_probe);
+
   // Disable the timer match
   TIMSKn &= ~_BV(OCIE0B);
 
@@ -24,15 +24,55 @@
 #include "Cosa/Types.h"
 #include "Cosa/Job.hh"
 #include "Cosa/Clock.hh"
+#include "Cosa/ProbeChannel.hh"
 
 /**
  * Real-Time Timer (RTT) with micro/milli/seconds timing based on
  * hardware timer. Uses Timer2 when possible to allow low power mode
  * with timer. Alternatively Timer0 is used.
  *
+ * @section Tickless
+ * With COSA_RTT_TICKLESS the timer will only generate the periodic
+ * tick interrupt when there are jobs or delays within the next
+ * milli-seconds. Otherwise the timer prescale is increased and the
+ * compare match is programmed to the next job deadline (minus one
+ * tick) or the maximum timer period. Elapsed timer cycles are
+ * accumulated on wake up so that micros() and millis() stay exact.
+ * The timer is clocked synchronously and the deepest sleep mode
+ * that keeps the timer running is SLEEP_MODE_IDLE (the default
+ * Power sleep mode).
+ *
+ * @section Asynchronous
+ * With COSA_RTT_ASYNC Timer2 is clocked asynchronously from a
+ * 32.768 kHz crystal (TOSC1/TOSC2) and keeps counting in
+ * SLEEP_MODE_PWR_SAVE; the timer allows Power sleep mode down to
+ * power save (see Power::set()). The resolution is coarser; the tick
+ * is 15.625 ms and the timer cycle 244.14 us. micros() is exact to
+ * the timer cycle and millis() is incremented per tick (15 or 16 ms)
+ * with the fraction carried. Scheduled jobs are dispatched with timer
+ * cycle precision. Requires a board with the crystal on TOSC1/TOSC2;
+ * on ATmega328P these are the XTAL pins and the system clock must be
+ * the internal RC oscillator. Not supported together with
+ * COSA_RTT_TICKLESS.
+ *
+ * @section Scheduler
+ * The timer compare match B is programmed for the first job in the
+ * scheduler queue when it expires within the next tick. The match
+ * is re-programmed for the next job on dispatch so that several
+ * sub-millisecond jobs are run with timer cycle precision (4 us at
+ * 16 MHz) and without busy-wait. Jobs that expire within two timer
+ * cycles are run directly.
+ *
+ * @section Jitter
+ * With COSA_RTT_JITTER the scheduler records the minimum and maximum
+ * dispatch latency; the difference between the time a job is run
+ * and its expire time. Negative latency is early dispatch.
+ *
  * @section Limitations
  * Cannot be used together with other classes that use AVR/Timer2/
- * Timer0.
+ * Timer0. In tickless mode polling of millis() will only be
+ * updated at wake up; delay() and scheduled jobs will request the
+ * necessary wake up.
  */
 class RTT {
 public:
@@ -75,10 +115,19 @@ public:
   {
     synchronized {
       s_micros = usec;
+      s_micros_hi = 0;
       s_millis = usec / 1000L;
     }
   }
 
+  /**
+   * Return the current monotonic clock in micro-seconds. The clock is
+   * 48-bit (approx. 8.9 years) and does not wrap with micros(); the
+   * low 32-bit is the same as micros().
+   * @return micro-seconds.
+   */
+  static uint64_t micros64();
+
   /**
    * Return the current clock in milli-seconds.
    * @return milli-seconds.
@@ -94,6 +143,7 @@ public:
   {
     synchronized {
       s_micros = ms * 1000L;
+      s_micros_hi = 0;
       s_millis = ms;
     }
   }
@@ -127,8 +177,46 @@ public:
     delay(0);
   }
 
+#if defined(COSA_RTT_JITTER)
+  /**
+   * Return minimum job dispatch latency in micro-seconds since latest
+   * reset.
+   * @return micro-seconds.
+   */
+  static int16_t jitter_min()
+  {
+    int16_t res;
+    synchronized res = s_jitter_min;
+    return (res);
+  }
+
+  /**
+   * Return maximum job dispatch latency in micro-seconds since latest
+   * reset.
+   * @return micro-seconds.
+   */
+  static int16_t jitter_max()
+  {
+    int16_t res;
+    synchronized res = s_jitter_max;
+    return (res);
+  }
+
+  /**
+   * Reset job dispatch latency measurement.
+   */
+  static void jitter_reset()
+  {
+    synchronized {
+      s_jitter_min = INT16_MAX;
+      s_jitter_max = INT16_MIN;
+    }
+  }
+#endif
+
   /**
-   * RTT Scheduler for jobs with a delay of 50 us or longer.
+   * RTT Scheduler for jobs with micro-second resolution. Jobs that
+   * expire within the next tick use the timer compare match.
    */
   class Scheduler : public Job::Scheduler {
   public:
@@ -149,6 +237,14 @@ public:
      */
     virtual bool start(Job* job);
 
+    /**
+     * @override{Job::Scheduler}
+     * Stop given job. Disable the timer compare match if used by the
+     * job. Returns true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    virtual bool stop(Job* job);
+
     /**
      * @override{Job::Scheduler}
      * Dispatch expired jobs. Called from RTT ISR.
@@ -160,6 +256,107 @@ public:
      * Return current time in micro-seconds.
      */
     virtual uint32_t time();
+
+  protected:
+    /**
+     * Program the timer compare match for the given job. Return
+     * true(1) if programmed otherwise false(0) if the job expires
+     * within two timer cycles and should be run directly. Called
+     * from ISR or synchronized block.
+     * @param[in] job to program.
+     * @return bool.
+     */
+    static bool arm(Job* job);
+
+    /**
+     * Run the given expired job. Measure dispatch latency if enabled.
+     * @param[in] job to run.
+     */
+    static void run(Job* job)
+    {
+#if defined(COSA_RTT_JITTER)
+      int16_t late = RTT::micros() - job->expire_at();
+      if (late < s_jitter_min) s_jitter_min = late;
+      if (late > s_jitter_max) s_jitter_max = late;
+#endif
+      PROBE_SET(JOB);
+      job->on_expired();
+      PROBE_CLEAR(JOB);
+    }
+  };
+
+  /**
+   * RTT job with 48-bit micro-second deadline. Deadlines beyond the
+   * 32-bit scheduler range (approx. 35 minutes) are reached in steps
+   * of HOP_MAX micro-seconds. The intermediate expires are handled in
+   * the interrupt service routine; run() is only called at the
+   * deadline. Other jobs use the fast 32-bit path as before.
+   */
+  class LongJob : public Job {
+  public:
+    /** Maximum scheduler step (us); approx. 17.9 minutes. */
+    static const uint32_t HOP_MAX = 0x40000000UL;
+
+    /**
+     * Construct job with 48-bit deadline for given scheduler.
+     * @param[in] scheduler RTT job scheduler.
+     */
+    LongJob(RTT::Scheduler* scheduler) :
+      Job(scheduler),
+      m_deadline(0),
+      m_final(false)
+    {}
+
+    /**
+     * Set deadline. Absolute time in micro-seconds; see micros64().
+     * @param[in] time deadline.
+     */
+    void expire_at(uint64_t time)
+    {
+      m_deadline = time;
+    }
+
+    /**
+     * Set deadline relative to latest deadline.
+     * @param[in] time micro-seconds to add to latest deadline.
+     */
+    void expire_after(uint64_t time)
+    {
+      m_deadline += time;
+    }
+
+    /**
+     * Get deadline.
+     * @return micro-seconds.
+     */
+    uint64_t deadline() const
+    {
+      return (m_deadline);
+    }
+
+    /**
+     * Start the job. Returns true(1) if scheduled otherwise false(0).
+     * @return bool.
+     */
+    bool start();
+
+  protected:
+    /** Deadline (us). */
+    uint64_t m_deadline;
+
+    /** Final step flag. */
+    bool m_final;
+
+    /**
+     * Schedule the next step towards the deadline.
+     */
+    void step();
+
+    /**
+     * @override{Job}
+     * Take the next step or push a timeout event at the deadline.
+     */
+    virtual void on_expired();
   };
 
   /**
@@ -215,10 +412,47 @@ public:
 private:
   static bool s_initiated;	     	//!< Initiated flag.
   static uint32_t s_micros;		//!< Micro-seconds counter.
+  static uint16_t s_micros_hi;		//!< Micro-seconds counter wraps.
   static uint32_t s_millis;		//!< Milli-seconds counter.
   static Scheduler* s_scheduler;	//!< Job scheduler.
   static Job* s_job;			//!< Timer job.
   static Clock* s_clock;		//!< Clock.
+#if defined(COSA_RTT_JITTER)
+  static int16_t s_jitter_min;		//!< Minimum dispatch latency.
+  static int16_t s_jitter_max;		//!< Maximum dispatch latency.
+#endif
+#if defined(COSA_RTT_ASYNC)
+  static uint16_t s_us;			//!< Micro-seconds fraction of millis.
+#endif
+#if defined(COSA_RTT_TICKLESS)
+  static bool s_idle;			//!< Idle prescale flag.
+  static uint16_t s_us;			//!< Micro-seconds fraction of millis.
+  static uint32_t s_wake;		//!< Delay wake up time (micros).
+  static bool s_delay;			//!< Delay wake up flag.
+
+  /**
+   * Add the given number of micro-seconds to the counters and tick
+   * the clock. Called from ISR or synchronized block.
+   * @param[in] us micro-seconds elapsed.
+   */
+  static void account(uint32_t us);
+
+  /**
+   * Program the timer period (prescale and compare match) given the
+   * next job and delay deadline. Called from ISR or synchronized
+   * block; timer counter is zero.
+   */
+  static void program();
+
+  /**
+   * Leave idle period if given time (micro-seconds from now) is
+   * before next wake up. Elapsed timer cycles are accounted and the
+   * timer is programmed.
+   * @param[in] us micro-seconds from now.
+   * @note atomic
+   */
+  static void wakeup(int32_t us);
+#endif
 
   /**
    * Do not allow instances. This is a static singleton; name space.
@@ -22,22 +22,56 @@
 #define COSA_RTT_CONFIG_HH
 
 // Real-Time Timer Configuration
+#if defined(COSA_RTT_ASYNC)
+#if !defined(ASSR) || !defined(TIMER2_COMPA_vect)
+#error "Cosa/RTT_Config.hh: COSA_RTT_ASYNC requires asynchronous Timer2"
+#endif
+#if defined(COSA_RTT_TICKLESS)
+#error "Cosa/RTT_Config.hh: COSA_RTT_ASYNC and COSA_RTT_TICKLESS not supported"
+#endif
+// Timer2 clocked from 32.768 kHz crystal (TOSC1/TOSC2). Tick is
+// 15.625 ms (64 cycles, prescale 8). The timer cycle (244.140625 us)
+// is truncated for scheduling and exact for time conversion
+#define F_TOSC 32768UL
+#define COUNT 64
+#define PRESCALE 8
+#define TIMER_MAX (COUNT - 1)
+#define US_PER_TICK ((1000000UL * PRESCALE * COUNT) / F_TOSC)
+#define US_PER_TIMER_CYCLE (US_PER_TICK / COUNT)
+#define US_TIMER_CYCLES(cnt) ((((uint32_t) (cnt)) * US_PER_TICK) / COUNT)
+#define POWER_LEVEL Power::SAVE_LEVEL
+#else
 #define COUNT 250
 #define PRESCALE 64
 #define TIMER_MAX (COUNT - 1)
 #define US_PER_TIMER_CYCLE (PRESCALE / I_CPU)
 #define US_PER_TICK (COUNT * US_PER_TIMER_CYCLE)
+#define US_TIMER_CYCLES(cnt) (((uint32_t) (cnt)) * US_PER_TIMER_CYCLE)
+#define POWER_LEVEL Power::IDLE_LEVEL
+#endif
 #define MS_PER_TICK (US_PER_TICK / 1000)
-#define US_DIRECT_EXPIRE (800 / I_CPU)
+#define US_DIRECT_EXPIRE (2 * US_PER_TIMER_CYCLE)
 #define US_TIMER_EXPIRE (US_PER_TICK - 1)
 
+// Tickless mode; idle prescale and minimum time for idle period
+#define IDLE_PRESCALE 1024
+#define IDLE_TIMER_MAX 255
+#define US_PER_IDLE_CYCLE (IDLE_PRESCALE / I_CPU)
+#define US_IDLE_MIN (2 * US_PER_TICK + US_PER_IDLE_CYCLE)
+
 // Real-Time Timer Registers. Use Timer2 if available to keep
 // timer running in low power mode
 #if defined(TIMER2_COMPA_vect)
 #define timern_enable timer2_enable
 #define timern_disable timer2_disable
 #define TCCRnB TCCR2B
+#if defined(COSA_RTT_ASYNC)
+#define CSn _BV(CS21)
+#else
 #define CSn _BV(CS22)
+#endif
+#define CSn_IDLE (_BV(CS22) | _BV(CS21) | _BV(CS20))
+#define PSRn _BV(PSRASY)
 #define TCCRnA TCCR2A
 #define OCRnA OCR2A
 #define OCRnB OCR2B
@@ -51,6 +85,8 @@
 #define timern_disable timer0_disable
 #define TCCRnB TCCR0B
 #define CSn (_BV(CS01) | _BV(CS00))
+#define CSn_IDLE (_BV(CS02) | _BV(CS00))
+#define PSRn 0
 #define TCCRnA TCCR0A
 #define OCRnA OCR0A
 #define OCRnB OCR0B
@@ -60,4 +96,10 @@
 #define TIMERn_COMPA_vect TIMER0_COMPA_vect
 #define TIMERn_COMPB_vect TIMER0_COMPB_vect
 #endif
+
+// Asynchronous Timer2 register update busy flags
+#if defined(COSA_RTT_ASYNC)
+#define ASYNC_BUSY (_BV(TCN2UB) | _BV(OCR2AUB) | _BV(OCR2BUB)	\
+		    | _BV(TCR2AUB) | _BV(TCR2BUB))
+#endif
 #endif
@@ -21,6 +21,23 @@
 #include "Cosa/RTT.hh"
 #include "Cosa/RTT_Config.hh"
 
+bool
+RTT::Scheduler::arm(Job* job)
+{
+  // Check if the job expires within two timer cycles
+  int32_t diff = job->expire_at() - RTT::micros();
+  if (diff < US_DIRECT_EXPIRE) return (false);
+
+  // Program the timer match; round up to timer cycles
+  uint16_t cnt = TCNTn + ((diff + US_PER_TIMER_CYCLE - 1) / US_PER_TIMER_CYCLE);
+  if (cnt > TIMER_MAX) cnt -= COUNT;
+  OCRnB = cnt;
+  TIFRn = _BV(OCF0B);
+  TIMSKn |= _BV(OCIE0B);
+  s_job = job;
+  return (true);
+}
+
 bool
 RTT::Scheduler::start(Job* job)
 {
@@ -31,25 +48,35 @@ RTT::Scheduler::start(Job* job)
   uint32_t now = RTT::micros();
   int32_t diff = job->expire_at() - now;
   if (diff < US_DIRECT_EXPIRE) {
-    job->on_expired();
+    run(job);
     return (true);
   }
 
+#if defined(COSA_RTT_TICKLESS)
+  // Wake up from idle period if the job expires before next wake up
+  RTT::wakeup(diff);
+
+  // Check if the job should use the timer match register
+  if ((diff < US_TIMER_EXPIRE) && !RTT::s_idle) {
+#else
   // Check if the job should use the timer match register
   if (diff < US_TIMER_EXPIRE) {
+#endif
+    bool expired = false;
     synchronized {
       if ((s_job == NULL)
 	  || ((int32_t) (job->expire_at() - s_job->expire_at()) < 0)) {
-	uint16_t cnt = TCNTn + (diff / US_PER_TIMER_CYCLE);
-	if (cnt > TIMER_MAX) cnt -= TIMER_MAX;
-	OCRnB = cnt;
-	TIMSKn |= _BV(OCIE0B);
-	TIFRn |= _BV(OCF0B);
-	s_job = job;
-	m_queue.succ()->attach(job);
-	return (true);
+	if (arm(job)) {
+	  m_queue.succ()->attach(job);
+	  return (true);
+	}
+	expired = true;
       }
     }
+    if (expired) {
+      run(job);
+      return (true);
+    }
   }
 
   // Insert into the job scheduler queue
@@ -66,6 +93,22 @@ RTT::Scheduler::start(Job* job)
   return (true);
 }
 
+bool
+RTT::Scheduler::stop(Job* job)
+{
+  synchronized {
+    // Release the timer match if used by the job. The next job is
+    // programmed on the next tick
+    if (job == s_job) {
+      TIMSKn &= ~_BV(OCIE0B);
+      s_job = NULL;
+    }
+    if (!job->is_started()) return (false);
+    job->detach();
+  }
+  return (true);
+}
+
 void
 RTT::Scheduler::dispatch()
 {
@@ -78,30 +121,20 @@ RTT::Scheduler::dispatch()
     // Check if the job should be run
     uint32_t now = RTT::micros();
     int32_t diff = job->expire_at() - now;
-    if (diff < US_DIRECT_EXPIRE) {
-      Job* succ = (Job*) job->succ();
-      ((Link*) job)->detach();
-      job->on_expired();
-      job = succ;
-      continue;
+    if (diff >= US_DIRECT_EXPIRE) {
+      // Program the timer match for the next job within the tick
+      if (diff >= US_TIMER_EXPIRE) return;
+      if ((s_job != NULL)
+	  && ((int32_t) (job->expire_at() - s_job->expire_at()) >= 0))
+	return;
+      if (arm(job)) return;
     }
 
-    // Check if the job should use the timer
-    if (diff < US_TIMER_EXPIRE) {
-      // Check that the job will expire before current match
-      if ((s_job == NULL)
-	  || ((int32_t) (job->expire_at() - s_job->expire_at()) < 0)) {
-	uint16_t cnt = TCNTn + (diff / US_PER_TIMER_CYCLE);
-	if (cnt > TIMER_MAX) cnt -= TIMER_MAX;
-	OCRnB = cnt;
-	TIMSKn |= _BV(OCIE0B);
-	TIFRn |= _BV(OCF0B);
-	s_job = job;
-      }
-    }
-
-    // No more jobs to run
-    return;
+    // Run the expired job
+    Job* succ = (Job*) job->succ();
+    ((Link*) job)->detach();
+    run(job);
+    job = succ;
   }
 }
 
@@ -110,3 +143,31 @@ RTT::Scheduler::time()
 {
   return (RTT::micros());
 }
+
+bool
+RTT::LongJob::start()
+{
+  if (is_started()) return (false);
+  step();
+  return (true);
+}
+
+void
+RTT::LongJob::step()
+{
+  // Step towards the deadline; final step when within range
+  uint64_t now = RTT::micros64();
+  int64_t left = m_deadline - now;
+  m_final = (left <= (int64_t) HOP_MAX);
+  Job::expire_at(m_final ? (uint32_t) m_deadline : (uint32_t) now + HOP_MAX);
+  Job::start();
+}
+
+void
+RTT::LongJob::on_expired()
+{
+  if (m_final)
+    Job::on_expired();
+  else
+    step();
+}
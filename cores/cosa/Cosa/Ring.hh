@@ -0,0 +1,141 @@
+/**
+ * @file Cosa/Ring.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_RING_HH
+#define COSA_RING_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * Ring-buffer support functions shared by Queue and IOBuffer; index
+ * type selection, index access and copy of spans with wrap-around.
+ * The ring-buffer index is the position of the last written (head)
+ * or read (tail) member. An 8-bit index is read and written in a
+ * single instruction on AVR. A 16-bit index requires two and is
+ * accessed with interrupts disabled so that an interrupt handler
+ * cannot observe a partially updated index.
+ */
+class Ring {
+public:
+  /**
+   * Index type for a ring-buffer of the given number of members;
+   * uint8_t for max 256 members, otherwise uint16_t.
+   * @param[in] SIZE number of members.
+   */
+  template<uint16_t SIZE, bool WIDE = (SIZE > 256)>
+  struct Index {
+    typedef uint8_t type;
+  };
+
+  template<uint16_t SIZE>
+  struct Index<SIZE, true> {
+    typedef uint16_t type;
+  };
+
+  /**
+   * Return value of given ring-buffer index that may be updated by
+   * an interrupt handler.
+   * @param[in] ix index reference.
+   * @return index value.
+   */
+  template<class INDEX>
+  static INDEX load(const volatile INDEX& ix)
+  {
+    INDEX res;
+    synchronized res = ix;
+    return (res);
+  }
+
+  /**
+   * Assign given ring-buffer index that may be read by an interrupt
+   * handler.
+   * @param[in] ix index reference.
+   * @param[in] value new index value.
+   */
+  template<class INDEX>
+  static void store(volatile INDEX& ix, INDEX value)
+  {
+    synchronized ix = value;
+  }
+
+  /**
+   * Copy given number of members from buffer to ring-buffer starting
+   * at the given position. The members are copied in at most two
+   * segments (wrap-around).
+   * @param[in] ring ring-buffer storage.
+   * @param[in] size number of members in ring-buffer.
+   * @param[in] pos first position to write.
+   * @param[in] buf members to copy.
+   * @param[in] n number of members to copy.
+   * @pre n <= size
+   */
+  template<class T>
+  static void write(T* ring, uint16_t size, uint16_t pos,
+		    const T* buf, uint16_t n)
+  {
+    uint16_t len = size - pos;
+    if (len > n) len = n;
+    memcpy(&ring[pos], buf, len * sizeof(T));
+    if (len < n) memcpy(ring, buf + len, (n - len) * sizeof(T));
+  }
+
+  /**
+   * Copy given number of members from ring-buffer starting at the
+   * given position to buffer. The members are copied in at most two
+   * segments (wrap-around).
+   * @param[in] ring ring-buffer storage.
+   * @param[in] size number of members in ring-buffer.
+   * @param[in] pos first position to read.
+   * @param[in] buf buffer for members.
+   * @param[in] n number of members to copy.
+   * @pre n <= size
+   */
+  template<class T>
+  static void read(const T* ring, uint16_t size, uint16_t pos,
+		   T* buf, uint16_t n)
+  {
+    uint16_t len = size - pos;
+    if (len > n) len = n;
+    memcpy(buf, &ring[pos], len * sizeof(T));
+    if (len < n) memcpy(buf + len, ring, (n - len) * sizeof(T));
+  }
+};
+
+/**
+ * Specialization for 8-bit index; atomic read.
+ */
+template<>
+inline uint8_t
+Ring::load<uint8_t>(const volatile uint8_t& ix)
+{
+  return (ix);
+}
+
+/**
+ * Specialization for 8-bit index; atomic write.
+ */
+template<>
+inline void
+Ring::store<uint8_t>(volatile uint8_t& ix, uint8_t value)
+{
+  ix = value;
+}
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "Cosa/SPI.hh"
 #include "Cosa/Power.hh"
+#include "Cosa/Probe.hh"
 
 // Configuration: Allow SPI transfer interleaving
 #if !defined(BOARD_ATTINY)
@@ -156,13 +157,29 @@ SPI::transfer(void* dst, const void* src, size_t count)
   *dp = transfer_await();
 }
 
+/*
+ * The block read and write member functions are unrolled to handle
+ * eight bytes per iteration. This removes the loop counter update and
+ * branch from the byte transfer and allows the data prefetch and store
+ * to fit within the byte transfer time at the highest clock rates.
+ */
 void
 SPI::read(void* buf, size_t count)
 {
   if (UNLIKELY(count == 0)) return;
   uint8_t* dp = (uint8_t*) buf;
   transfer_start(0xff);
-  while (--count) *dp++ = transfer_next(0xff);
+  while (--count & 0x07) *dp++ = transfer_next(0xff);
+  for (count >>= 3; count != 0; count--) {
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+    *dp++ = transfer_next(0xff);
+  }
   *dp = transfer_await();
 }
 
@@ -171,11 +188,17 @@ SPI::write(const void* buf, size_t count)
 {
   if (UNLIKELY(count == 0)) return;
   const uint8_t* sp = (const uint8_t*) buf;
-  uint8_t data = *sp++;
-  transfer_start(data);
-  while (--count) {
-    data = *sp++;
-    transfer_next(data);
+  transfer_start(*sp++);
+  while (--count & 0x07) transfer_next(*sp++);
+  for (count >>= 3; count != 0; count--) {
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
+    transfer_next(*sp++);
   }
   transfer_await();
 }
@@ -185,11 +208,17 @@ SPI::write_P(const void* buf, size_t count)
 {
   if (UNLIKELY(count == 0)) return;
   const uint8_t* sp = (const uint8_t*) buf;
-  uint8_t data = pgm_read_byte(sp++);
-  transfer_start(data);
-  while (--count) {
-    data = pgm_read_byte(sp++);
-    transfer_next(data);
+  transfer_start(pgm_read_byte(sp++));
+  while (--count & 0x07) transfer_next(pgm_read_byte(sp++));
+  for (count >>= 3; count != 0; count--) {
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
+    transfer_next(pgm_read_byte(sp++));
   }
   transfer_await();
 }
@@ -256,6 +285,7 @@ SPI::acquire(Driver* dev)
 {
   // Acquire the device driver. Wait if busy. Synchronized update
   uint8_t key = lock(m_busy);
+  PROBE_SET(SPI);
 
   // Power up
   SPI::powerup();
@@ -281,11 +311,19 @@ void
 SPI::release()
 {
   synchronized {
+#if defined(SPDR)
+    // Start queued asynchronous transfers
+    if (UNLIKELY(!m_queue.is_empty())) {
+      resume();
+      return;
+    }
+#endif
     // Power down
     SPI::powerdown();
 
     // Release the device driver
     m_busy = false;
+    PROBE_CLEAR(SPI);
     m_dev = NULL;
     // Enable all interrupt sources on SPI bus
     for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
@@ -293,6 +331,109 @@ SPI::release()
   }
 }
 
+#if defined(SPDR)
+bool
+SPI::start(Transfer* transfer)
+{
+  // Check that the transfer is not already queued
+  if (UNLIKELY(transfer->is_pending())) return (false);
+  if (UNLIKELY(transfer->m_vec == NULL)) return (false);
+
+  // Queue the transfer and start if the bus is not in use. The
+  // transfer requires idle sleep mode until completed
+  synchronized {
+    Power::acquire(Power::IDLE_LEVEL);
+    m_queue.attach(transfer);
+    if (!m_busy) {
+      m_busy = true;
+      PROBE_SET(SPI);
+      SPI::powerup();
+      for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
+	if (dev->m_irq != NULL) dev->m_irq->disable();
+      resume();
+    }
+  }
+  return (true);
+}
+
+void
+SPI::resume()
+{
+  Linkage* link;
+  while ((link = m_queue.succ()) != &m_queue) {
+    // Find the first non-empty buffer in the io vector
+    Transfer* transfer = (Transfer*) link;
+    const iovec_t* vp = transfer->m_vec;
+    while ((vp->buf != NULL) && (vp->size == 0)) vp++;
+
+    // Complete directly if there is no data to transfer
+    if (UNLIKELY(vp->buf == NULL)) {
+      transfer->detach();
+      Power::release(Power::IDLE_LEVEL);
+      transfer->on_completed();
+      continue;
+    }
+
+    // Initiate SPI hardware with device settings and enable interrupt
+    Driver* dev = transfer->m_dev;
+    m_dev = dev;
+    SPCR = dev->m_spcr | _BV(SPIE);
+    SPSR = dev->m_spsr;
+
+    // Select device and start transfer of first byte
+    transfer->m_vp = vp;
+    transfer->m_dp = (uint8_t*) vp->buf;
+    transfer->m_count = vp->size;
+    begin();
+    SPDR = (transfer->m_mode == Transfer::READ_MODE) ? 0xff : *transfer->m_dp;
+    return;
+  }
+
+  // No more transfers; disable interrupt and release the bus
+  SPCR &= ~_BV(SPIE);
+  SPI::powerdown();
+  m_busy = false;
+  PROBE_CLEAR(SPI);
+  m_dev = NULL;
+  for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
+    if (dev->m_irq != NULL) dev->m_irq->enable();
+}
+
+ISR_PROBE_DEFINE(spi_stc_isr_probe, "isr:SPI_STC");
+
+ISR(SPI_STC_vect)
+{
+  ISR_PROBE(spi_stc_isr_probe);
+  SPI::Transfer* transfer = (SPI::Transfer*) spi.m_queue.succ();
+  uint8_t data = SPDR;
+  uint8_t* dp = transfer->m_dp;
+
+  // Store received data (read and exchange mode)
+  if (transfer->m_mode != SPI::Transfer::WRITE_MODE) *dp = data;
+  dp += 1;
+
+  // Check for more data in the current buffer or the next buffer
+  if (UNLIKELY(--transfer->m_count == 0)) {
+    const iovec_t* vp = transfer->m_vp + 1;
+    while ((vp->buf != NULL) && (vp->size == 0)) vp++;
+    if (vp->buf == NULL) {
+      // Transfer completed; deselect device and start next transfer
+      spi.end();
+      transfer->detach();
+      Power::release(Power::IDLE_LEVEL);
+      transfer->on_completed();
+      spi.resume();
+      return;
+    }
+    transfer->m_vp = vp;
+    transfer->m_count = vp->size;
+    dp = (uint8_t*) vp->buf;
+  }
+  transfer->m_dp = dp;
+  SPDR = (transfer->m_mode == SPI::Transfer::READ_MODE) ? 0xff : *dp;
+}
+#endif
+
 void
 SPI::Driver::set_clock(Clock rate)
 {
@@ -26,6 +26,7 @@
 #include "Cosa/OutputPin.hh"
 #include "Cosa/Interrupt.hh"
 #include "Cosa/Event.hh"
+#include "Cosa/Linkage.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -176,6 +177,111 @@ public:
     friend class SPI;
   };
 
+#if defined(SPDR)
+  /**
+   * Asynchronous SPI transfer descriptor. Holds the device driver,
+   * the null terminated io buffer vector and transfer mode. Transfers
+   * are queued with SPI::start() and performed by the SPI interrupt
+   * service routine with chip select according to the device driver
+   * pulse pattern. Transfers for different device drivers are chained
+   * and the bus is released when the queue is empty. The virtual
+   * member function on_completed() is called from the interrupt
+   * service routine when the transfer is completed.
+   * @code
+   * iovec_t vec[3];
+   * iovec_t* vp = vec;
+   * iovec_arg(vp, &cmd, sizeof(cmd));
+   * iovec_arg(vp, buf, sizeof(buf));
+   * iovec_end(vp);
+   * SPI::Transfer transfer(this, vec);
+   * spi.start(&transfer);
+   * ...
+   * transfer.await();
+   * @endcode
+   */
+  class Transfer : public Link {
+  public:
+    /** Transfer modes. */
+    enum Mode {
+      WRITE_MODE = 0,		//!< Write buffers, ignore received data.
+      READ_MODE = 1,		//!< Read into buffers, send 0xff.
+      EXCHANGE_MODE = 2		//!< Write buffers, store received data.
+    } __attribute__((packed));
+
+    /**
+     * Construct SPI transfer descriptor for given device driver, io
+     * buffer vector and mode.
+     * @param[in] dev device driver.
+     * @param[in] vec null terminated io buffer vector (default NULL).
+     * @param[in] mode transfer mode (default WRITE_MODE).
+     */
+    Transfer(Driver* dev, const iovec_t* vec = NULL, Mode mode = WRITE_MODE) :
+      Link(),
+      m_dev(dev),
+      m_vec(vec),
+      m_mode(mode),
+      m_vp(NULL),
+      m_dp(NULL),
+      m_count(0)
+    {}
+
+    /**
+     * Set io buffer vector and mode for transfer. Should not be used
+     * while the transfer is pending.
+     * @param[in] vec null terminated io buffer vector.
+     * @param[in] mode transfer mode (default WRITE_MODE).
+     */
+    void set(const iovec_t* vec, Mode mode = WRITE_MODE)
+    {
+      m_vec = vec;
+      m_mode = mode;
+    }
+
+    /**
+     * Return true(1) if the transfer is queued or in progress
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_pending() const
+      __attribute__((always_inline))
+    {
+      return (pred() != this);
+    }
+
+    /**
+     * Wait for the transfer to complete.
+     */
+    void await()
+    {
+      while (is_pending()) yield();
+    }
+
+    /**
+     * @override{SPI::Transfer}
+     * Called from the SPI interrupt service routine when the transfer
+     * is completed. Default implementation pushes a write or read
+     * completed event to the transfer descriptor.
+     */
+    virtual void on_completed()
+    {
+      uint8_t type = (m_mode == WRITE_MODE) ?
+	Event::WRITE_COMPLETED_TYPE :
+	Event::READ_COMPLETED_TYPE;
+      Event::push(type, this);
+    }
+
+  protected:
+    Driver* m_dev;		//!< Device driver.
+    const iovec_t* m_vec;	//!< Io buffer vector.
+    Mode m_mode;		//!< Transfer mode.
+    const iovec_t* m_vp;	//!< Current io buffer.
+    uint8_t* m_dp;		//!< Current data pointer.
+    size_t m_count;		//!< Bytes left in current io buffer.
+    friend class SPI;
+    friend void SPI_STC_vect(void);
+  };
+#endif
+
   /**
    * Construct serial peripheral interface for master.
    */
@@ -211,9 +317,22 @@ public:
 
   /**
    * Release the SPI device driver. Enable SPI interrupt sources.
+   * Queued asynchronous transfers are started.
    */
   void release();
 
+#if defined(SPDR)
+  /**
+   * Queue the given asynchronous transfer. The transfer is started
+   * directly if the bus is not in use otherwise when the current
+   * transfer is completed or the bus is released. Returns true(1) if
+   * successful otherwise false(0).
+   * @param[in] transfer descriptor.
+   * @return bool.
+   */
+  bool start(Transfer* transfer);
+#endif
+
   /**
    * Mark the beginning of a transfer block. Select the device by
    * asserting the chip select pin according to the pulse pattern.
@@ -441,10 +560,36 @@ public:
       write(vp->buf, vp->size);
   }
 
+  /**
+   * Read package from the device slave into null terminated io buffer
+   * vector (scatter read). Should only be used within a SPI transfer;
+   * begin()-end() block.
+   * @param[in] vec null terminated io buffer vector pointer.
+   */
+  void read(const iovec_t* vec)
+    __attribute__((always_inline))
+  {
+    for (const iovec_t* vp = vec; vp->buf != NULL; vp++)
+      read(vp->buf, vp->size);
+  }
+
 private:
   Driver* m_list;		//!< List of attached device drivers.
   Driver* m_dev;		//!< Current device driver.
   volatile bool m_busy;		//!< Current device state.
+#if defined(SPDR)
+  Head m_queue;			//!< Queue of asynchronous transfers.
+
+  /**
+   * Start the next queued asynchronous transfer or release the bus
+   * if the queue is empty. Called from ISR or synchronized block
+   * with the bus acquired.
+   */
+  void resume();
+
+  /** Interrupt Service Routine. */
+  friend void SPI_STC_vect(void);
+#endif
 };
 
 /**
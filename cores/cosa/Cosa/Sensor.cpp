@@ -0,0 +1,104 @@
+/**
+ * @file Cosa/Sensor.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Sensor.hh"
+
+#if !defined(BOARD_ATTINY)
+
+Sensor::Source::Source(TWI::Driver* dev, uint8_t reg,
+		       void* buf, uint8_t size) :
+  TWI::Transaction(dev),
+  m_reg(reg),
+  m_valid(false),
+  m_stream(NULL),
+  m_next(NULL)
+{
+  iovec_t* vp = m_wvec;
+  iovec_arg(vp, &m_reg, sizeof(m_reg));
+  iovec_end(vp);
+  vp = m_rvec;
+  iovec_arg(vp, buf, size);
+  iovec_end(vp);
+  set(m_wvec, m_rvec);
+}
+
+void
+Sensor::Source::on_completed(uint8_t type, int count)
+{
+  UNUSED(type);
+  m_valid = (count == (int) m_rvec[0].size);
+  m_stream->completed();
+}
+
+void
+Sensor::Stream::attach(Source* source)
+{
+  source->m_stream = this;
+  source->m_next = m_source;
+  m_source = source;
+}
+
+bool
+Sensor::Stream::sample_request()
+{
+  // Drop request if the previous is still pending
+  if (UNLIKELY(m_pending != 0)) {
+    if (m_dropped < UINT16_MAX) m_dropped += 1;
+    return (false);
+  }
+
+  // Count sources before queueing; completion may be immediate
+  uint8_t count = 0;
+  for (Source* source = m_source; source != NULL; source = source->m_next)
+    count += 1;
+  if (UNLIKELY(count == 0)) return (false);
+  m_pending = count;
+
+  // Queue all source transactions; chained with repeated start
+  for (Source* source = m_source; source != NULL; source = source->m_next) {
+    if (UNLIKELY(!twi.start(source))) {
+      source->m_valid = false;
+      completed();
+    }
+  }
+  return (true);
+}
+
+void
+Sensor::Stream::completed()
+{
+  synchronized {
+    if (--m_pending == 0)
+      Event::push(Event::SAMPLE_COMPLETED_TYPE, this);
+  }
+}
+
+void
+Sensor::Stream::on_event(uint8_t type, uint16_t value)
+{
+  if (type != Event::SAMPLE_COMPLETED_TYPE) {
+    Periodic::on_event(type, value);
+    return;
+  }
+  for (Source* source = m_source; source != NULL; source = source->m_next)
+    if (source->is_valid()) source->on_decode();
+  on_samples();
+}
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file Cosa/Sensor.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_SENSOR_HH
+#define COSA_SENSOR_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/TWI.hh"
+#include "Cosa/Periodic.hh"
+
+#if !defined(BOARD_ATTINY)
+
+/**
+ * Common high-rate sampling framework for TWI sensor drivers
+ * (accelerometer, gyroscope, magnetometer). Each device driver
+ * provides a sample source; an asynchronous TWI transaction with a
+ * burst read of the device output registers into a fixed-point
+ * sample struct. A sensor stream groups the sources and queues all
+ * transactions at the same time so that they are chained by the TWI
+ * interrupt service routine with repeated start; a 9-DOF board is
+ * sampled in one bus burst. The sources decode the raw register data
+ * and the stream calls on_samples() from the main loop when all
+ * sources are completed.
+ * @code
+ * class IMU : public Sensor::Stream {
+ * public:
+ *   IMU() : Sensor::Stream(&scheduler, 10) {}
+ *   virtual void on_samples() { ... }
+ * };
+ * ADXL345 acc;
+ * ADXL345::Source acc_source(&acc);
+ * IMU imu;
+ * ...
+ * imu.attach(&acc_source);
+ * imu.start();
+ * @endcode
+ */
+class Sensor {
+public:
+  /**
+   * Fixed-point three axis sample in device units.
+   */
+  struct sample_t {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+  };
+
+  class Stream;
+
+  /**
+   * Sample source; asynchronous TWI transaction with a burst read of
+   * the sample registers of a device. Sub-classes define the sample
+   * storage and decoding.
+   */
+  class Source : public TWI::Transaction {
+  public:
+    /**
+     * Construct sample source for given device driver, register
+     * address (with any auto increment flag) and sample buffer.
+     * @param[in] dev device driver.
+     * @param[in] reg sample register address.
+     * @param[in] buf sample buffer.
+     * @param[in] size of sample buffer.
+     */
+    Source(TWI::Driver* dev, uint8_t reg, void* buf, uint8_t size);
+
+    /**
+     * Return true(1) if the latest sample was read successfully
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_valid() const
+    {
+      return (m_valid);
+    }
+
+    /**
+     * @override{Sensor::Source}
+     * Decode the raw register data in the sample buffer; byte order
+     * and scaling. Called from the stream on_event() and not from the
+     * interrupt service routine.
+     */
+    virtual void on_decode() {}
+
+  protected:
+    /** Sample register address. */
+    uint8_t m_reg;
+
+    /** Latest sample read successfully. */
+    bool m_valid;
+
+    /** Write (register address) and read (sample) io vectors. */
+    iovec_t m_wvec[2];
+    iovec_t m_rvec[2];
+
+    /** Stream this source is attached to. */
+    Stream* m_stream;
+
+    /** Next source in stream. */
+    Source* m_next;
+
+    /**
+     * @override{TWI::Transaction}
+     * Notify the stream when the burst read is completed. Called from
+     * the TWI interrupt service routine.
+     * @param[in] type event code.
+     * @param[in] count number of bytes or negative error code.
+     */
+    virtual void on_completed(uint8_t type, int count);
+
+    friend class Stream;
+  };
+
+  /**
+   * Sensor stream; periodic sampling of a group of sources.
+   */
+  class Stream : public Periodic {
+  public:
+    /**
+     * Construct sensor stream with given scheduler and sample period
+     * in the schedulers time base.
+     * @param[in] scheduler for periodic job.
+     * @param[in] period of sampling.
+     */
+    Stream(Job::Scheduler* scheduler, uint32_t period) :
+      Periodic(scheduler, period, SKIP),
+      m_source(NULL),
+      m_pending(0),
+      m_dropped(0)
+    {}
+
+    /**
+     * Attach given sample source to the stream. Should not be called
+     * while sampling.
+     * @param[in] source to attach.
+     */
+    void attach(Source* source);
+
+    /**
+     * Issue a sample request; queue the transactions of all sources.
+     * May be called from an event handler on a device sample ready
+     * interrupt instead of starting the periodic job. Returns
+     * false(0) if the previous request is still pending (the request
+     * is dropped) otherwise true(1).
+     * @return bool.
+     */
+    bool sample_request();
+
+    /**
+     * Return number of requests dropped as the previous request was
+     * still pending.
+     * @return dropped requests.
+     */
+    uint16_t dropped() const
+    {
+      return (m_dropped);
+    }
+
+    /**
+     * @override{Sensor::Stream}
+     * Called from the main loop when all sources have been sampled
+     * and decoded. Check is_valid() of each source for errors.
+     */
+    virtual void on_samples() = 0;
+
+  protected:
+    /** List of sample sources. */
+    Source* m_source;
+
+    /** Number of pending source transactions. */
+    volatile uint8_t m_pending;
+
+    /** Number of dropped sample requests. */
+    uint16_t m_dropped;
+
+    /**
+     * @override{Job}
+     * Periodic sample request.
+     */
+    virtual void run()
+    {
+      sample_request();
+    }
+
+    /**
+     * @override{Event::Handler}
+     * Decode sources and call on_samples() on completion, otherwise
+     * periodic event handling.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+
+    /**
+     * Source completion. Called from the TWI interrupt service
+     * routine.
+     */
+    void completed();
+
+    friend class Source;
+  };
+};
+
+#endif
+#endif
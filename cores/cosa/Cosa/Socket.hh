@@ -24,6 +24,7 @@
 #include "Cosa/Types.h"
 #include "Cosa/INET.hh"
 #include "Cosa/IOStream.hh"
+#include "Cosa/Job.hh"
 
 /**
  * Abstract Interface for Internet Sockets.
@@ -351,5 +352,132 @@ protected:
   virtual int send(const void* buf, size_t len,
 		   uint8_t dest[4], uint16_t port,
 		   bool progmem) = 0;
+
+  /**
+   * Datagram batching helper. Coalesces small records into datagrams
+   * of at most the given maximum size (MTU) to reduce the per-packet
+   * overhead of the device (pointer update, send command and send
+   * completion wait). Each record is framed with a length byte. A
+   * datagram is sent when the next record would not fit or when the
+   * flush deadline, counted from the first record in the datagram,
+   * expires. The deadline is in the time unit of the scheduler.
+   * @code
+   * RTT::Scheduler scheduler;
+   * Socket::Batch batch(&scheduler, sock, dest, port, 50000UL);
+   * ...
+   * batch.send(&sample, sizeof(sample));
+   * @endcode
+   * @pre mtu should not exceed the device transmit message size
+   * (half the socket transmit buffer for W5X00) and records are max
+   * RECORD_MAX bytes.
+   */
+  class Batch : public Job {
+  public:
+    /** Default maximum datagram size. */
+    static const uint16_t MTU_DEFAULT = 512;
+
+    /** Maximum record size (length byte framing). */
+    static const size_t RECORD_MAX = 255;
+
+    /**
+     * Construct datagram batching helper for the given scheduler,
+     * connectionless socket, destination address and port, flush
+     * deadline and maximum datagram size.
+     * @param[in] scheduler for flush deadline.
+     * @param[in] sock socket (UDP).
+     * @param[in] dest destination address.
+     * @param[in] port destination port.
+     * @param[in] deadline flush deadline in scheduler time unit.
+     * @param[in] mtu maximum datagram size (default MTU_DEFAULT).
+     */
+    Batch(Job::Scheduler* scheduler, Socket* sock,
+	  uint8_t dest[4], uint16_t port,
+	  uint32_t deadline, uint16_t mtu = MTU_DEFAULT) :
+      Job(scheduler),
+      m_sock(sock),
+      m_port(port),
+      m_deadline(deadline),
+      m_mtu(mtu),
+      m_len(0)
+    {
+      memcpy(m_dest, dest, sizeof(m_dest));
+    }
+
+    /**
+     * Add record in given buffer with given size to the current
+     * datagram. The datagram is sent first if the record does not
+     * fit. Return number of bytes in record if successful otherwise
+     * negative error code.
+     * @param[in] buf record buffer.
+     * @param[in] size number of bytes in record.
+     * @return number of bytes or negative error code.
+     */
+    int send(const void* buf, size_t size);
+
+    /**
+     * Add record gathered from the given null terminated io vector
+     * to the current datagram. The datagram is sent first if the
+     * record does not fit. Return number of bytes in record if
+     * successful otherwise negative error code.
+     * @param[in] vec null terminated io vector.
+     * @return number of bytes or negative error code.
+     */
+    int send(const iovec_t* vec);
+
+    /**
+     * Send the current datagram, if any, and stop the flush deadline.
+     * Return zero if successful otherwise negative error code.
+     * @return zero or negative error code.
+     */
+    int flush();
+
+    /**
+     * Return number of bytes in the current datagram.
+     * @return length.
+     */
+    uint16_t length() const
+    {
+      return (m_len);
+    }
+
+  protected:
+    /** Connectionless socket. */
+    Socket* m_sock;
+
+    /** Destination address. */
+    uint8_t m_dest[4];
+
+    /** Destination port. */
+    uint16_t m_port;
+
+    /** Flush deadline in scheduler time unit. */
+    uint32_t m_deadline;
+
+    /** Maximum datagram size. */
+    uint16_t m_mtu;
+
+    /** Number of bytes in current datagram. */
+    uint16_t m_len;
+
+    /**
+     * Prepare the current datagram for a record with the given size;
+     * send the datagram if the record does not fit, begin a new
+     * datagram and start the flush deadline if empty, and write the
+     * record length byte. Return zero if successful otherwise
+     * negative error code.
+     * @param[in] size number of bytes in record.
+     * @return zero or negative error code.
+     */
+    int prepare(size_t size);
+
+    /**
+     * @override{Job}
+     * Flush deadline expired; send the current datagram.
+     */
+    virtual void run()
+    {
+      flush();
+    }
+  };
 };
 #endif
@@ -0,0 +1,84 @@
+/**
+ * @file Cosa/Socket_Batch.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Socket.hh"
+
+int
+Socket::Batch::prepare(size_t size)
+{
+  // Check that the record fits the framing and a datagram
+  if (UNLIKELY(size > RECORD_MAX || size + 1 > m_mtu)) return (EMSGSIZE);
+
+  // Send the current datagram if the record does not fit
+  int res;
+  if (m_len + size + 1 > m_mtu) {
+    res = flush();
+    if (UNLIKELY(res < 0)) return (res);
+  }
+
+  // Begin a new datagram and start the flush deadline
+  if (m_len == 0) {
+    res = m_sock->datagram(m_dest, m_port);
+    if (UNLIKELY(res < 0)) return (res);
+    expire_at(time() + m_deadline);
+    start();
+  }
+
+  // Write the record length byte
+  uint8_t len = size;
+  res = m_sock->write(&len, sizeof(len));
+  if (UNLIKELY(res < 0)) return (res);
+  m_len += sizeof(len);
+  return (0);
+}
+
+int
+Socket::Batch::send(const void* buf, size_t size)
+{
+  int res = prepare(size);
+  if (UNLIKELY(res < 0)) return (res);
+  res = m_sock->write(buf, size);
+  if (UNLIKELY(res < 0)) return (res);
+  m_len += size;
+  return (size);
+}
+
+int
+Socket::Batch::send(const iovec_t* vec)
+{
+  size_t size = iovec_size(vec);
+  int res = prepare(size);
+  if (UNLIKELY(res < 0)) return (res);
+  for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+    res = m_sock->write(vp->buf, vp->size);
+    if (UNLIKELY(res < 0)) return (res);
+    m_len += vp->size;
+  }
+  return (size);
+}
+
+int
+Socket::Batch::flush()
+{
+  stop();
+  if (m_len == 0) return (0);
+  m_len = 0;
+  return (m_sock->flush());
+}
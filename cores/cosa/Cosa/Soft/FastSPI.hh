@@ -0,0 +1,139 @@
+/**
+ * @file Cosa/Soft/FastSPI.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_SOFT_FAST_SPI_HH
+#define COSA_SOFT_FAST_SPI_HH
+
+#include "Cosa/FastPin.hh"
+#include "Cosa/Soft/SPI.hh"
+
+namespace Soft {
+
+  /**
+   * Soft Serial Peripheral Interface (SPI) master with compile-time
+   * pins. Same bit transfer as Soft::SPI but the pin access reduces
+   * to single instructions. There is no device driver list; chip
+   * select is handled by the caller (e.g. with FastPin).
+   * @code
+   * typedef Soft::FastSPI<Board::D6, Board::D7, Board::D8> Bus;
+   * typedef FastPin<Board::D9> CS;
+   * Bus::begin();
+   * CS::output(1);
+   * CS::clear();
+   * res = Bus::transfer(data);
+   * CS::set();
+   * @endcode
+   * @param[in] MISO master input slave output pin.
+   * @param[in] MOSI master output slave input pin.
+   * @param[in] SCK serial clock pin.
+   * @param[in] MODE SPI mode (0..3, default 0); clock polarity.
+   * @param[in] ORDER bit order (default MSB_ORDER).
+   */
+  template<Board::DigitalPin MISO,
+	   Board::DigitalPin MOSI,
+	   Board::DigitalPin SCK,
+	   uint8_t MODE = 0,
+	   SPI::Order ORDER = SPI::MSB_ORDER>
+  class FastSPI {
+  public:
+    /**
+     * Initiate the bus pins; data and clock output, clock polarity
+     * according to mode.
+     */
+    static void begin()
+    {
+      FastPin<MISO>::input();
+      FastPin<MOSI>::output();
+      FastPin<SCK>::output(MODE & 0x02);
+    }
+
+    /**
+     * Exchange data with slave. Slave select must be done before
+     * exchange of data.
+     * @param[in] value to send.
+     * @return value received.
+     */
+    static uint8_t transfer(uint8_t value)
+    {
+      uint8_t bits = CHARBITS;
+      if (ORDER == SPI::MSB_ORDER) {
+	synchronized do {
+	  FastPin<MOSI>::_write(value & 0x80);
+	  FastPin<SCK>::toggle();
+	  value <<= 1;
+	  if (FastPin<MISO>::is_set()) value |= 0x01;
+	  FastPin<SCK>::toggle();
+	} while (--bits);
+      }
+      else {
+	synchronized do {
+	  FastPin<MOSI>::_write(value & 0x01);
+	  FastPin<SCK>::toggle();
+	  value >>= 1;
+	  if (FastPin<MISO>::is_set()) value |= 0x80;
+	  FastPin<SCK>::toggle();
+	} while (--bits);
+      }
+      return (value);
+    }
+
+    /**
+     * Exchange package with slave. Received data from slave is
+     * stored in given buffer.
+     * @param[in] buf with data to transfer (send/receive).
+     * @param[in] count size of buffer.
+     */
+    static void transfer(void* buf, size_t count)
+    {
+      if (UNLIKELY(count == 0)) return;
+      uint8_t* bp = (uint8_t*) buf;
+      do {
+	*bp = transfer(*bp);
+	bp += 1;
+      } while (--count);
+    }
+
+    /**
+     * Read package from the device slave.
+     * @param[in] buf buffer for read data.
+     * @param[in] count number of bytes to read.
+     */
+    static void read(void* buf, size_t count)
+    {
+      if (UNLIKELY(count == 0)) return;
+      uint8_t* bp = (uint8_t*) buf;
+      do *bp++ = transfer(0x00); while (--count);
+    }
+
+    /**
+     * Write package to the device slave.
+     * @param[in] buf buffer with data to write.
+     * @param[in] count number of bytes to write.
+     */
+    static void write(const void* buf, size_t count)
+    {
+      if (UNLIKELY(count == 0)) return;
+      const uint8_t* bp = (const uint8_t*) buf;
+      do transfer(*bp++); while (--count);
+    }
+  };
+
+};
+#endif
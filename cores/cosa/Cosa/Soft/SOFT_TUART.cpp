@@ -0,0 +1,179 @@
+/**
+ * @file Cosa/Soft/SOFT_TUART.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Soft/UART.hh"
+
+#if !defined(BOARD_ATTINY)
+#include "Cosa/Power.hh"
+
+using namespace Soft;
+
+TUART* TUART::s_uart = NULL;
+
+TUART::TUART(Board::DigitalPin tx, Board::InterruptPin rx,
+	     IOStream::Device* ibuf, IOStream::Device* obuf) :
+  Serial(),
+  m_rx(rx, this),
+  m_tx(tx, 1),
+  m_ibuf(ibuf),
+  m_obuf(obuf),
+  m_period(F_CPU / 9600),
+  m_bits(8),
+  m_stops(2),
+  m_rx_bits(0),
+  m_rx_data(0),
+  m_tx_bits(0),
+  m_tx_data(0)
+{
+}
+
+bool
+TUART::begin(uint32_t baudrate, uint8_t format)
+{
+  // Check that the bit period fits the timer
+  uint32_t period = F_CPU / baudrate;
+  if (UNLIKELY(period > 0xffffUL)) return (false);
+  m_period = period;
+  m_stops = 1 + ((format & STOP2) != 0);
+  m_bits = 5 + ((format & DATA8) >> 1);
+  s_uart = this;
+
+  // Start timer; normal mode and no prescale
+  Power::timer1_enable();
+  synchronized {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+  }
+
+  // Enable start bit detection
+  PinChangeInterrupt::begin();
+  m_rx.enable();
+  return (true);
+}
+
+bool
+TUART::end()
+{
+  flush();
+  m_rx.disable();
+  synchronized TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+  Power::timer1_disable();
+  return (true);
+}
+
+int
+TUART::putchar(char c)
+{
+  // Wait for room in the output buffer
+  while (m_obuf->putchar(c) == IOStream::EOF)
+    yield();
+
+  // Start the transmitter if idle
+  synchronized {
+    if ((TIMSK1 & _BV(OCIE1B)) == 0) {
+      m_tx_bits = 0;
+      OCR1B = TCNT1 + I_CPU;
+      TIFR1 = _BV(OCF1B);
+      TIMSK1 |= _BV(OCIE1B);
+    }
+  }
+  return (c & 0xff);
+}
+
+int
+TUART::flush()
+{
+  while ((TIMSK1 & _BV(OCIE1B)) != 0)
+    yield();
+  return (0);
+}
+
+void
+TUART::on_tx_interrupt()
+{
+  // Load the next character; start, data and stop bits
+  if (m_tx_bits == 0) {
+    int c = m_obuf->getchar();
+    if (c == IOStream::EOF) {
+      TIMSK1 &= ~_BV(OCIE1B);
+      return;
+    }
+    uint16_t data = (c & ((1 << m_bits) - 1)) | (0xffff << m_bits);
+    m_tx_data = data << 1;
+    m_tx_bits = m_bits + m_stops + 1;
+  }
+
+  // Shift out the next bit and schedule the following
+  m_tx._write(m_tx_data & 0x01);
+  m_tx_data >>= 1;
+  m_tx_bits -= 1;
+  OCR1B += m_period;
+}
+
+void
+TUART::on_rx_interrupt()
+{
+  // Sample data bit (LSB first)
+  m_rx_data >>= 1;
+  if (m_rx.is_set()) m_rx_data |= 0x80;
+  OCR1A += m_period;
+  if (--m_rx_bits != 0) return;
+
+  // Last data bit; put character and wait for next start bit
+  TIMSK1 &= ~_BV(OCIE1A);
+  m_ibuf->putchar(m_rx_data >> (8 - m_bits));
+  m_rx.enable();
+}
+
+TUART::RXPinChangeInterrupt::RXPinChangeInterrupt(Board::InterruptPin pin,
+						  TUART* uart) :
+  PinChangeInterrupt(pin, ON_FALLING_MODE),
+  m_uart(uart)
+{
+}
+
+void
+TUART::RXPinChangeInterrupt::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+
+  // Start bit; sample the first data bit in the middle of the bit
+  uint16_t period = m_uart->m_period;
+  OCR1A = TCNT1 + period + (period >> 1) - LATENCY;
+  TIFR1 = _BV(OCF1A);
+  TIMSK1 |= _BV(OCIE1A);
+  m_uart->m_rx_bits = m_uart->m_bits;
+  m_uart->m_rx_data = 0;
+  disable();
+}
+
+ISR(TIMER1_COMPA_vect)
+{
+  if (UNLIKELY(TUART::s_uart == NULL)) return;
+  TUART::s_uart->on_rx_interrupt();
+}
+
+ISR(TIMER1_COMPB_vect)
+{
+  if (UNLIKELY(TUART::s_uart == NULL)) return;
+  TUART::s_uart->on_tx_interrupt();
+}
+#endif
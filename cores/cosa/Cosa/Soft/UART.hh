@@ -153,6 +153,22 @@ public:
     return (m_ibuf->getchar());
   }
 
+  /** Overloaded virtual member function read. */
+  using IOStream::Device::read;
+
+  /**
+   * @override{IOStream::Device}
+   * Read data to given buffer with given size from serial port input
+   * buffer. Returns number of bytes read (available).
+   * @param[in] buf buffer to read into.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes read.
+   */
+  virtual int read(void* buf, size_t size)
+  {
+    return (m_ibuf->read(buf, size));
+  }
+
   /**
    * @override{IOStream::Device}
    * Empty internal device buffers.
@@ -197,6 +213,191 @@ protected:
   friend class RXPinChangeInterrupt;
 };
 
+#if !defined(BOARD_ATTINY)
+/**
+ * Soft UART with timer based bit sampling and transmission. The
+ * start bit is detected with a pin change interrupt and the data
+ * bits are sampled and shifted by timer compare interrupts; one
+ * interrupt per bit. Interrupts are enabled between bits so that the
+ * RTT, radio drivers and other interrupt handlers are not blocked
+ * for the character time. Transmission is interrupt driven from the
+ * given output buffer. Both directions may be active at the same
+ * time (full duplex).
+ * @section Limitations
+ * Uses Timer1 (compare A and B) with no prescale. Cannot be used with
+ * libraries that use the same Timer; Tone, Servo, VWI and
+ * InputCapture. Only one instance. Min baudrate is F_CPU / 65536
+ * (245 bps at 16 MHz).
+ */
+class TUART : public Serial {
+public:
+  /**
+   * Construct timer based Soft UART with transmitter on given output
+   * pin and receiver on given pin change interrupt pin. Received data
+   * is put into the given input buffer and transmitted data is taken
+   * from the given output buffer.
+   * @param[in] tx transmitter pin.
+   * @param[in] rx receiver pin.
+   * @param[in] ibuf input buffer.
+   * @param[in] obuf output buffer.
+   */
+  TUART(Board::DigitalPin tx, Board::InterruptPin rx,
+	IOStream::Device* ibuf, IOStream::Device* obuf);
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes available in input buffer.
+   * @return bytes.
+   */
+  virtual int available()
+  {
+    return (m_ibuf->available());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes room in output buffer.
+   * @return bytes.
+   */
+  virtual int room()
+  {
+    return (m_obuf->room());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Write character to serial port output buffer and start the
+   * transmitter if idle. Returns character if successful otherwise
+   * a negative error code (EOF(-1)).
+   * @param[in] c character to write.
+   * @return character written or EOF(-1).
+   */
+  virtual int putchar(char c);
+
+  /**
+   * @override{IOStream::Device}
+   * Peek next character from serial port input buffer.
+   * @return character or EOF(-1).
+   */
+  virtual int peekchar()
+  {
+    return (m_ibuf->peekchar());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Peek for given character from serial port input buffer.
+   * @param[in] c character to peek for.
+   * @return available or EOF(-1).
+   */
+  virtual int peekchar(char c)
+  {
+    return (m_ibuf->peekchar(c));
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Read character from serial port input buffer.
+   * @return character or EOF(-1).
+   */
+  virtual int getchar()
+  {
+    return (m_ibuf->getchar());
+  }
+
+  /** Overloaded virtual member function read. */
+  using IOStream::Device::read;
+
+  /**
+   * @override{IOStream::Device}
+   * Read data to given buffer with given size from serial port input
+   * buffer. Returns number of bytes read (available).
+   * @param[in] buf buffer to read into.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes read.
+   */
+  virtual int read(void* buf, size_t size)
+  {
+    return (m_ibuf->read(buf, size));
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Wait for the output buffer to become empty and the last character
+   * to be transmitted.
+   * @return zero(0) or negative error code.
+   */
+  virtual int flush();
+
+  /**
+   * @override{IOStream::Device}
+   * Empty internal device buffers.
+   */
+  virtual void empty()
+  {
+    m_ibuf->empty();
+  }
+
+  /**
+   * @override{Serial}
+   * Start timer based Soft UART device driver.
+   * @param[in] baudrate serial bitrate (default 9600).
+   * @param[in] format serial frame format (default DATA8, NO PARITY, STOP2).
+   * @return true(1) if successful otherwise false(0)
+   */
+  virtual bool begin(uint32_t baudrate = DEFAULT_BAUDRATE,
+		     uint8_t format = DEFAULT_FORMAT);
+
+  /**
+   * @override{Serial}
+   * Stop timer based Soft UART device driver.
+   * @return true(1) if successful otherwise false(0)
+   */
+  virtual bool end();
+
+protected:
+  /** Start bit detection (falling edge). */
+  class RXPinChangeInterrupt : public PinChangeInterrupt {
+  public:
+    RXPinChangeInterrupt(Board::InterruptPin pin, TUART* uart);
+    virtual void on_interrupt(uint16_t arg = 0);
+  protected:
+    TUART* m_uart;
+  };
+
+  /** Interrupt latency compensation for start bit in timer ticks. */
+  static const uint16_t LATENCY = I_CPU * 4;
+
+  RXPinChangeInterrupt m_rx;		//!< Receiver pin.
+  OutputPin m_tx;			//!< Transmitter pin.
+  IOStream::Device* m_ibuf;		//!< Input buffer.
+  IOStream::Device* m_obuf;		//!< Output buffer.
+  uint16_t m_period;			//!< Bit period in timer ticks.
+  uint8_t m_bits;			//!< Number of data bits.
+  uint8_t m_stops;			//!< Number of stop bits.
+  uint8_t m_rx_bits;			//!< Receiver bits remaining.
+  uint8_t m_rx_data;			//!< Receiver shift register.
+  uint8_t m_tx_bits;			//!< Transmitter bits remaining.
+  uint16_t m_tx_data;			//!< Transmitter shift register.
+
+  friend class RXPinChangeInterrupt;
+
+public:
+  /** The active timer based Soft UART (interrupt handlers). */
+  static TUART* s_uart;
+
+  /**
+   * Receiver bit sample. Timer compare A interrupt handler.
+   */
+  void on_rx_interrupt();
+
+  /**
+   * Transmitter bit shift. Timer compare B interrupt handler.
+   */
+  void on_tx_interrupt();
+};
+#endif
+
 };
 
 #endif
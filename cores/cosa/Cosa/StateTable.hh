@@ -0,0 +1,170 @@
+/**
+ * @file Cosa/StateTable.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_STATE_TABLE_HH
+#define COSA_STATE_TABLE_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Event.hh"
+
+/**
+ * Table driven finite state machine. The transition table maps
+ * (state, event) to (action, next state) and is stored in program
+ * memory. Dispatch is a table lookup; constant time and without
+ * virtual calls. Events are numbered from zero and are sent as
+ * Event::USER_TYPE + event. Other event types are ignored.
+ * @code
+ * class Machine : public StateTable<Machine, STATES, EVENTS> {
+ * public:
+ *   Machine() : StateTable<Machine, STATES, EVENTS>(table) {}
+ *   static void on_open(Machine* fsm, uint16_t value);
+ *   ...
+ * };
+ * const Machine::table_t table __PROGMEM = {
+ *   // IDLE
+ *   { Machine::transition(Machine::on_open, OPEN), ... },
+ *   ...
+ * };
+ * @endcode
+ * @param[in] T state machine class (sub-class).
+ * @param[in] STATES number of states.
+ * @param[in] EVENTS number of events.
+ * @section Limitations
+ * The table size is STATES * EVENTS * 3 bytes of program memory.
+ */
+template<class T, uint8_t STATES, uint8_t EVENTS>
+class StateTable : public Event::Handler {
+public:
+  /**
+   * Transition action function prototype.
+   * @param[in] fsm state machine.
+   * @param[in] value event value.
+   */
+  typedef void (*Action)(T* fsm, uint16_t value);
+
+  /** Next state value for no state change. */
+  static const uint8_t SAME = 0xff;
+
+  /**
+   * Transition table entry; action and next state.
+   */
+  struct transition_t {
+    Action action;		//!< Action function or NULL.
+    uint8_t next;		//!< Next state or SAME.
+  };
+
+  /** Transition table type; indexed by state and event. */
+  typedef transition_t table_t[STATES][EVENTS];
+
+  /**
+   * Return transition table entry with given action and next state.
+   * @param[in] action function (default none).
+   * @param[in] next state (default no state change).
+   * @return transition.
+   */
+  static constexpr transition_t transition(Action action = NULL,
+					   uint8_t next = SAME)
+  {
+    return { action, next };
+  }
+
+  /**
+   * Construct state machine with given transition table in program
+   * memory and initial state.
+   * @param[in] table transition table.
+   * @param[in] init initial state (default 0).
+   */
+  StateTable(const table_t& table, uint8_t init = 0) :
+    Event::Handler(),
+    m_table(&table[0][0]),
+    m_state(init)
+  {}
+
+  /**
+   * Return current state.
+   * @return state.
+   */
+  uint8_t state() const
+  {
+    return (m_state);
+  }
+
+  /**
+   * Set current state. May be used by an action to override the
+   * table next state.
+   * @param[in] state next state.
+   */
+  void state(uint8_t state)
+  {
+    if (UNLIKELY(state >= STATES)) return;
+    m_state = state;
+  }
+
+  /**
+   * Dispatch the given event directly to the state machine. The next
+   * state is set before the action is called. Returns true(1) if
+   * there was a transition otherwise false(0).
+   * @param[in] event number (0..EVENTS-1).
+   * @param[in] value event value (default 0).
+   * @return bool.
+   */
+  bool dispatch(uint8_t event, uint16_t value = 0)
+  {
+    if (UNLIKELY(event >= EVENTS)) return (false);
+    const transition_t* tp = &m_table[(m_state * EVENTS) + event];
+    Action action = (Action) pgm_read_word(&tp->action);
+    uint8_t next = pgm_read_byte(&tp->next);
+    if (next != SAME) m_state = next;
+    if (action == NULL) return (next != SAME);
+    action(static_cast<T*>(this), value);
+    return (true);
+  }
+
+  /**
+   * Send the given event to the state machine through the event
+   * queue.
+   * @param[in] event number (0..EVENTS-1).
+   * @param[in] value event value (default 0).
+   */
+  void send(uint8_t event, uint16_t value = 0)
+  {
+    Event::push(Event::USER_TYPE + event, this, value);
+  }
+
+protected:
+  /** Transition table in program memory. */
+  const transition_t* m_table;
+
+  /** Current state. */
+  uint8_t m_state;
+
+  /**
+   * @override{Event::Handler}
+   * Map event type to event number and dispatch.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    dispatch(type - Event::USER_TYPE, value);
+  }
+};
+
+#endif
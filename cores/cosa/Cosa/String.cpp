@@ -23,6 +23,8 @@
 #include "Cosa/String.hh"
 #include <ctype.h>
 
+String::Allocator* String::s_allocator = NULL;
+
 String::String(const char* cstr)
 {
   init();
@@ -120,7 +122,7 @@ String::String(double value, unsigned char decimalPlaces)
 
 String::~String()
 {
-  if (m_buffer != NULL) free(m_buffer);
+  release();
 }
 
 inline void
@@ -131,10 +133,20 @@ String::init(void)
   m_length = 0;
 }
 
+void
+String::release(void)
+{
+  if ((m_buffer == NULL) || (m_buffer == m_inline)) return;
+  if (s_allocator != NULL)
+    s_allocator->deallocate(m_buffer);
+  else
+    free(m_buffer);
+}
+
 void
 String::invalidate(void)
 {
-  if (m_buffer != NULL) free(m_buffer);
+  release();
   m_buffer = NULL;
   m_capacity = 0;
   m_length = 0;
@@ -152,8 +164,23 @@ String::reserve(unsigned int size)
 unsigned char
 String::changeBuffer(unsigned int maxStrLen)
 {
-  char* newbuffer = (char*) realloc(m_buffer, maxStrLen + 1);
+  // Use the inline buffer for short strings
+  bool local = (m_buffer == NULL) || (m_buffer == m_inline);
+  if (local && (maxStrLen <= INLINE_MAX)) {
+    m_buffer = m_inline;
+    m_capacity = INLINE_MAX;
+    return (true);
+  }
+
+  // Allocate or resize buffer; copy from inline buffer
+  void* ptr = local ? NULL : m_buffer;
+  char* newbuffer;
+  if (s_allocator != NULL)
+    newbuffer = (char*) s_allocator->reallocate(ptr, maxStrLen + 1);
+  else
+    newbuffer = (char*) realloc(ptr, maxStrLen + 1);
   if (newbuffer == NULL) return (false);
+  if (m_buffer == m_inline) memcpy(newbuffer, m_inline, m_length + 1);
   m_buffer = newbuffer;
   m_capacity = maxStrLen;
   return (true);
@@ -187,16 +214,18 @@ String::copy(str_P pstr, unsigned int length)
 
 void String::move(String& rhs)
 {
-  if (m_buffer != NULL) {
-    if (m_capacity >= rhs.m_length) {
-      strcpy(m_buffer, rhs.m_buffer);
-      m_length = rhs.m_length;
-      rhs.m_length = 0;
-      return;
-    } else {
-      free(m_buffer);
-    }
+  // Copy inline string; the buffer cannot be stolen
+  if ((rhs.m_buffer == NULL) || (rhs.m_buffer == rhs.m_inline)) {
+    if (rhs.m_buffer == NULL)
+      invalidate();
+    else
+      copy(rhs.m_inline, rhs.m_length);
+    rhs.invalidate();
+    return;
   }
+
+  // Steal the allocated buffer
+  release();
   m_buffer = rhs.m_buffer;
   m_capacity = rhs.m_capacity;
   m_length = rhs.m_length;
@@ -260,7 +289,13 @@ String::concat(const char* cstr, unsigned int length)
   unsigned int newlen = m_length + length;
   if (cstr == NULL) return (false);
   if (length == 0) return (true);
-  if (!reserve(newlen)) return (false);
+
+  // Grow buffer by factor 1.5; fall back to the exact size
+  if ((m_buffer == NULL) || (newlen > m_capacity)) {
+    unsigned int size = m_capacity + (m_capacity >> 1);
+    if (size < newlen) size = newlen;
+    if (!reserve(size) && !reserve(newlen)) return (false);
+  }
   strcpy(m_buffer + m_length, cstr);
   m_length = newlen;
   return (true);
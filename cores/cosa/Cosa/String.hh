@@ -26,13 +26,23 @@
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
 
+// Default inline (small string) buffer size
+#ifndef COSA_STRING_INLINE_MAX
+# define COSA_STRING_INLINE_MAX 7
+#endif
+
 /**
  * String add operator handler.
  */
 class __StringSumHelper;
 
 /**
- * The String class; dynamic, resizable strings.
+ * The String class; dynamic, resizable strings. Short strings (max
+ * INLINE_MAX characters) are stored inline in the instance and do not
+ * use the heap. Longer strings are allocated with the String
+ * allocator; default malloc/realloc/free, or a fixed arena (see
+ * String::Arena). Concatenation grows the buffer by a factor 1.5 to
+ * reduce the number of reallocations.
  */
 class String {
 
@@ -77,6 +87,54 @@ public:
    */
   unsigned char reserve(unsigned int size);
 
+  /** Max length of string stored inline (no heap allocation). */
+  static const unsigned int INLINE_MAX = COSA_STRING_INLINE_MAX;
+
+  /**
+   * String buffer allocator interface. Used for strings longer than
+   * INLINE_MAX.
+   */
+  class Allocator {
+  public:
+    /**
+     * @override{String::Allocator}
+     * Resize the given buffer (or allocate if NULL) to the given
+     * size. Return pointer to buffer or NULL if the request could not
+     * be satisfied (the given buffer is unchanged).
+     * @param[in] ptr buffer pointer or NULL.
+     * @param[in] size number of bytes.
+     * @return buffer pointer or NULL.
+     */
+    virtual void* reallocate(void* ptr, size_t size) = 0;
+
+    /**
+     * @override{String::Allocator}
+     * Deallocate the given buffer.
+     * @param[in] ptr buffer pointer.
+     */
+    virtual void deallocate(void* ptr) = 0;
+  };
+
+  /**
+   * Fixed arena allocator; max COUNT buffers of SIZE bytes (strings
+   * of max SIZE - 1 characters) in a static block. Never uses the
+   * heap and does not fragment.
+   * @param[in] SIZE number of bytes per buffer.
+   * @param[in] COUNT number of buffers (max 255).
+   */
+  template<size_t SIZE, uint8_t COUNT> class Arena;
+
+  /**
+   * Set the String buffer allocator. NULL for the default heap
+   * allocator. Should be set before any strings longer than
+   * INLINE_MAX are created.
+   * @param[in] allocator String buffer allocator.
+   */
+  static void allocator(Allocator* allocator)
+  {
+    s_allocator = allocator;
+  }
+
   /**
    * Return string length.
    */
@@ -227,9 +285,18 @@ protected:
   char* m_buffer;	    //!< the actual char array
   unsigned int m_capacity;  //!< the array length minus one (for the '\0')
   unsigned int m_length;    //!< the String length (not counting the '\0')
+  char m_inline[INLINE_MAX + 1]; //!< inline buffer for short strings
+
+  /** String buffer allocator (NULL for heap). */
+  static Allocator* s_allocator;
 
   void init(void);
   void invalidate(void);
+
+  /**
+   * Release allocated buffer (if not inline).
+   */
+  void release(void);
   unsigned char changeBuffer(unsigned int maxStrLen);
   unsigned char concat(const char *cstr, unsigned int length);
 
@@ -266,6 +333,65 @@ public:
  * @param[in] s String to print.
  * @return iostream.
  */
+template<size_t SIZE, uint8_t COUNT>
+class String::Arena : public String::Allocator {
+public:
+  /**
+   * Construct fixed arena allocator with all buffers free.
+   */
+  Arena()
+  {
+    memset(m_used, 0, sizeof(m_used));
+  }
+
+  /**
+   * @override{String::Allocator}
+   * Allocate a free buffer if ptr is NULL. Resize within the buffer
+   * size. Return pointer to buffer or NULL.
+   * @param[in] ptr buffer pointer or NULL.
+   * @param[in] size number of bytes.
+   * @return buffer pointer or NULL.
+   */
+  virtual void* reallocate(void* ptr, size_t size)
+  {
+    if (size > SIZE) return (NULL);
+    if (ptr != NULL) return (ptr);
+    for (uint8_t i = 0; i < COUNT; i++) {
+      if (m_used[i >> 3] & _BV(i & 7)) continue;
+      m_used[i >> 3] |= _BV(i & 7);
+      return (m_buffer[i]);
+    }
+    return (NULL);
+  }
+
+  /**
+   * @override{String::Allocator}
+   * Return the given buffer to the arena.
+   * @param[in] ptr buffer pointer.
+   */
+  virtual void deallocate(void* ptr)
+  {
+    uint8_t i = ((char*) ptr - &m_buffer[0][0]) / SIZE;
+    m_used[i >> 3] &= ~_BV(i & 7);
+  }
+
+  /**
+   * Return number of free buffers.
+   * @return buffers.
+   */
+  uint8_t available() const
+  {
+    uint8_t res = 0;
+    for (uint8_t i = 0; i < COUNT; i++)
+      if ((m_used[i >> 3] & _BV(i & 7)) == 0) res += 1;
+    return (res);
+  }
+
+protected:
+  char m_buffer[COUNT][SIZE];		//!< Buffers.
+  uint8_t m_used[(COUNT + 7) / 8];	//!< Buffer in use map.
+};
+
 inline IOStream& operator<<(IOStream& outs, String& s)
 {
   outs.print((char*) s.c_str());
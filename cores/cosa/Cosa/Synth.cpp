@@ -0,0 +1,170 @@
+/**
+ * @file Cosa/Synth.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Synth.hh"
+#include "Cosa/Note.hh"
+#include "Cosa/Power.hh"
+
+#if !defined(BOARD_ATTINY)
+#if defined (__AVR_ATmega32U4__)		\
+  || defined(__AVR_ATmega640__)			\
+  || defined(__AVR_ATmega1280__)		\
+  || defined(__AVR_ATmega1281__)		\
+  || defined(__AVR_ATmega2560__)		\
+  || defined(__AVR_ATmega2561__)
+#define PWM DDB5
+#define DDR DDRB
+#define PORT PORTB
+#elif defined(__AVR_ATmega1284P__)		\
+  || defined(__AVR_ATmega644__)			\
+  || defined(__AVR_ATmega644P__)
+#define PWM DDD5
+#define DDR DDRD
+#define PORT PORTD
+#elif defined(__AVR_ATmega256RFR2__)
+#define PWM DDRB5
+#define DDR DDRB
+#define PORT PORTB
+#else
+#define PWM DDB1
+#define DDR DDRB
+#define PORT PORTB
+#endif
+
+// PWM period (timer counts per sample) and mixer output scaling
+static const uint16_t PERIOD = F_CPU / Synth::SAMPLE_RATE;
+static const uint16_t RANGE = Synth::VOICE_MAX * 256;
+
+volatile Synth::voice_t Synth::s_voice[VOICE_MAX];
+
+const int8_t Synth::SINE[256] __PROGMEM = {
+     0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,  40,  43,  46,
+    49,  51,  54,  57,  60,  63,  65,  68,  71,  73,  76,  78,  81,  83,  85,  88,
+    90,  92,  94,  96,  98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+   117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+   127, 127, 127, 127, 126, 126, 126, 125, 125, 124, 123, 122, 122, 121, 120, 118,
+   117, 116, 115, 113, 112, 111, 109, 107, 106, 104, 102, 100,  98,  96,  94,  92,
+    90,  88,  85,  83,  81,  78,  76,  73,  71,  68,  65,  63,  60,  57,  54,  51,
+    49,  46,  43,  40,  37,  34,  31,  28,  25,  22,  19,  16,  12,   9,   6,   3,
+     0,  -3,  -6,  -9, -12, -16, -19, -22, -25, -28, -31, -34, -37, -40, -43, -46,
+   -49, -51, -54, -57, -60, -63, -65, -68, -71, -73, -76, -78, -81, -83, -85, -88,
+   -90, -92, -94, -96, -98,-100,-102,-104,-106,-107,-109,-111,-112,-113,-115,-116,
+  -117,-118,-120,-121,-122,-122,-123,-124,-125,-125,-126,-126,-126,-127,-127,-127,
+  -127,-127,-127,-127,-126,-126,-126,-125,-125,-124,-123,-122,-122,-121,-120,-118,
+  -117,-116,-115,-113,-112,-111,-109,-107,-106,-104,-102,-100, -98, -96, -94, -92,
+   -90, -88, -85, -83, -81, -78, -76, -73, -71, -68, -65, -63, -60, -57, -54, -51,
+   -49, -46, -43, -40, -37, -34, -31, -28, -25, -22, -19, -16, -12,  -9,  -6,  -3,
+};
+
+void
+Synth::begin()
+{
+  // Initiate voices; silent with sine wavetable
+  for (uint8_t ix = 0; ix < VOICE_MAX; ix++) {
+    s_voice[ix].phase = 0;
+    s_voice[ix].step = 0;
+    s_voice[ix].amplitude = 0;
+    s_voice[ix].wavetable = SINE;
+  }
+
+  // Fast PWM (mode 14) with sample rate period on OC1A, no prescale,
+  // and overflow interrupt per sample
+  Power::timer1_enable();
+  DDR |= _BV(PWM);
+  synchronized {
+    TCCR1B = 0;
+    TCNT1 = 0;
+    ICR1 = PERIOD - 1;
+    OCR1A = PERIOD / 2;
+    TCCR1A = (_BV(COM1A1) | _BV(WGM11));
+    TCCR1B = (_BV(WGM13) | _BV(WGM12) | _BV(CS10));
+    TIMSK1 |= _BV(TOIE1);
+  }
+}
+
+void
+Synth::end()
+{
+  synchronized {
+    TIMSK1 &= ~_BV(TOIE1);
+    TCCR1A = 0;
+    TCCR1B = 0;
+  }
+  PORT &= ~_BV(PWM);
+  Power::timer1_disable();
+}
+
+void
+Synth::play(uint8_t ix, uint16_t freq, uint8_t amplitude)
+{
+  if (UNLIKELY(ix >= VOICE_MAX)) return;
+  uint16_t step = (((uint32_t) freq) << 16) / SAMPLE_RATE;
+  synchronized {
+    s_voice[ix].step = step;
+    s_voice[ix].amplitude = amplitude;
+  }
+}
+
+void
+Synth::silent(uint8_t ix)
+{
+  if (UNLIKELY(ix >= VOICE_MAX)) return;
+  s_voice[ix].amplitude = 0;
+}
+
+void
+Synth::wavetable(uint8_t ix, const int8_t* wavetable)
+{
+  if (UNLIKELY(ix >= VOICE_MAX)) return;
+  synchronized s_voice[ix].wavetable = wavetable;
+}
+
+void
+Synth::Player::on_note(uint16_t freq)
+{
+  if ((freq == 0) || (freq == Note::PAUSE))
+    Synth::silent(m_ix);
+  else
+    Synth::play(m_ix, freq, m_volume);
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  // Step the phase accumulators and mix the active voices
+  int16_t mix = 0;
+  volatile Synth::voice_t* vp = Synth::s_voice;
+  for (uint8_t ix = 0; ix < Synth::VOICE_MAX; ix++, vp++) {
+    uint8_t amplitude = vp->amplitude;
+    if (amplitude == 0) continue;
+    uint16_t phase = vp->phase + vp->step;
+    vp->phase = phase;
+    int8_t sample = pgm_read_byte(vp->wavetable + (phase >> 8));
+    mix += (sample * amplitude) >> 8;
+  }
+
+  // Scale the mix to the PWM period
+  uint16_t value = mix + (RANGE / 2);
+  if (PERIOD >= RANGE)
+    value *= (PERIOD / RANGE);
+  else
+    value /= ((RANGE + PERIOD - 1) / PERIOD);
+  OCR1A = value;
+}
+#endif
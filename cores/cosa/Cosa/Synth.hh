@@ -0,0 +1,156 @@
+/**
+ * @file Cosa/Synth.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_SYNTH_HH
+#define COSA_SYNTH_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Tone.hh"
+
+// Default number of synthesizer voices
+#ifndef COSA_SYNTH_VOICE_MAX
+# define COSA_SYNTH_VOICE_MAX 4
+#endif
+
+/**
+ * Polyphonic wavetable synthesizer. Timer1 is used in fast PWM mode
+ * with a sample rate period; the overflow interrupt handler steps a
+ * phase accumulator per voice, looks up the voice wavetable (256
+ * signed samples in program memory), scales with the voice amplitude
+ * and mixes the voices to the PWM output (OC1A). Notes may be played
+ * in the background with Synth::Player.
+ *
+ * @section Circuit
+ * The PWM output should be filtered with a low-pass filter and
+ * connected to an amplifier or a piezo/speaker.
+ * @code
+ * (OC1A/D9)---[1K]---+---[10uF]---(Amplifier)
+ *                    |
+ *                  [10nF]
+ *                    |
+ * (GND)--------------+
+ * @endcode
+ * OC1A is D9 on ATmega328, D11 on Mega, D13 on ATmega1284P and D9
+ * on ATmega32U4 boards.
+ *
+ * @section Limitations
+ * Uses Timer1 and cannot be used together with Tone or other classes
+ * that use the same timer (e.g. VWI, InputCapture).
+ */
+class Synth {
+public:
+  /** Number of voices. */
+  static const uint8_t VOICE_MAX = COSA_SYNTH_VOICE_MAX;
+
+  /** Sample rate (Hz). */
+  static const uint16_t SAMPLE_RATE = 15625;
+
+  /** Maximum amplitude. */
+  static const uint8_t AMPLITUDE_MAX = 255;
+
+  /** Sine wavetable; 256 signed samples (program memory). */
+  static const int8_t SINE[256] PROGMEM;
+
+  /**
+   * Start the synthesizer; PWM output and sample interrupt. All
+   * voices are silent.
+   */
+  static void begin();
+
+  /**
+   * Stop the synthesizer.
+   */
+  static void end();
+
+  /**
+   * Play given frequency and amplitude on given voice.
+   * @param[in] ix voice index (0..VOICE_MAX-1).
+   * @param[in] freq frequency in hz.
+   * @param[in] amplitude output amplitude (Default AMPLITUDE_MAX).
+   */
+  static void play(uint8_t ix, uint16_t freq,
+		   uint8_t amplitude = AMPLITUDE_MAX);
+
+  /**
+   * Silence given voice.
+   * @param[in] ix voice index (0..VOICE_MAX-1).
+   */
+  static void silent(uint8_t ix);
+
+  /**
+   * Set wavetable for given voice. The wavetable should be 256
+   * signed samples in program memory. Default is SINE.
+   * @param[in] ix voice index (0..VOICE_MAX-1).
+   * @param[in] wavetable in program memory.
+   */
+  static void wavetable(uint8_t ix, const int8_t* wavetable);
+
+  /**
+   * Background score player for a synthesizer voice. The score
+   * format is the same as Tone::Player. The volume is the voice
+   * amplitude (0..AMPLITUDE_MAX).
+   */
+  class Player : public Tone::Player {
+  public:
+    /**
+     * Construct score player for given voice with given scheduler.
+     * @param[in] scheduler for note timing (RTT::Scheduler).
+     * @param[in] ix voice index (0..VOICE_MAX-1).
+     */
+    Player(Job::Scheduler* scheduler, uint8_t ix) :
+      Tone::Player(scheduler),
+      m_ix(ix)
+    {}
+
+  protected:
+    /** Voice index. */
+    uint8_t m_ix;
+
+    /**
+     * @override{Tone::Player}
+     * Play the given note frequency on the voice.
+     * @param[in] freq frequency in hz.
+     */
+    virtual void on_note(uint16_t freq);
+  };
+
+private:
+  /**
+   * Synthesizer voice; phase accumulator, step per sample,
+   * amplitude and wavetable.
+   */
+  struct voice_t {
+    uint16_t phase;
+    uint16_t step;
+    uint8_t amplitude;
+    const int8_t* wavetable;
+  };
+
+  /** Voices; updated by the interrupt handler. */
+  static volatile voice_t s_voice[VOICE_MAX];
+
+  /**
+   * Do not allow instances; Static Class Single-ton.
+   */
+  Synth();
+
+  friend void TIMER1_OVF_vect(void);
+};
+#endif
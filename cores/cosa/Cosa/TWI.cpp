@@ -23,6 +23,7 @@
 #if !defined(BOARD_ATTINY)
 
 #include "Cosa/Bits.h"
+#include "Cosa/Probe.hh"
 
 TWI twi  __attribute__ ((weak));
 
@@ -37,9 +38,11 @@ TWI::acquire(TWI::Driver* dev)
 {
   // Acquire the device driver. Wait is busy. Synchronized update
   uint8_t key = lock(m_busy);
+  PROBE_SET(TWI);
 
-  // Set the current device driver
+  // Set the current device driver and internal io vector
   m_dev = dev;
+  m_vp = m_vec;
 
   // Power up the module
   powerup();
@@ -60,10 +63,16 @@ TWI::release()
   // Check if an asynchronious read/write was issued
   if (UNLIKELY((m_dev == NULL) || (m_dev->is_async()))) return;
 
-  // Put into idle state
+  // Put into idle state or start queued asynchronous transactions
   synchronized {
+    if (UNLIKELY(!m_queue.is_empty())) {
+      m_dev = NULL;
+      resume();
+      return;
+    }
     m_dev = NULL;
     m_busy = false;
+    PROBE_CLEAR(TWI);
     TWCR = 0;
   }
 
@@ -71,6 +80,62 @@ TWI::release()
   powerdown();
 }
 
+bool
+TWI::start(Transaction* transaction)
+{
+  // Check that the transaction is not already queued
+  if (UNLIKELY(transaction->is_pending())) return (false);
+  if (UNLIKELY((transaction->m_wvec == NULL) &&
+	       (transaction->m_rvec == NULL))) return (false);
+
+  // Queue the transaction and start if the bus is not in use
+  synchronized {
+    m_queue.attach(transaction);
+    if (!m_busy) resume();
+  }
+  return (true);
+}
+
+void
+TWI::resume()
+{
+  Linkage* link = m_queue.succ();
+
+  // No more transactions; release the bus
+  if (link == &m_queue) {
+    m_trans = NULL;
+    m_vp = m_vec;
+    m_dev = NULL;
+    m_busy = false;
+    PROBE_CLEAR(TWI);
+    TWCR = 0;
+    powerdown();
+    return;
+  }
+
+  // Setup the hardware if the bus was idle
+  if (!m_busy) {
+    m_busy = true;
+    PROBE_SET(TWI);
+    powerup();
+    bit_mask_set(PORT, _BV(Board::SDA) | _BV(Board::SCL));
+    bit_mask_clear(TWSR, _BV(TWPS0) | _BV(TWPS1));
+    TWBR = m_freq;
+  }
+
+  // Start the write or read phase of the next transaction
+  Transaction* transaction = (Transaction*) link;
+  uint8_t op = WRITE_OP;
+  m_trans = transaction;
+  m_dev = transaction->m_dev;
+  m_vp = transaction->m_wvec;
+  if (m_vp == NULL) {
+    m_vp = transaction->m_rvec;
+    op = READ_OP;
+  }
+  request(op);
+}
+
 bool
 TWI::request(uint8_t op)
 {
@@ -78,8 +143,8 @@ TWI::request(uint8_t op)
   m_state = ((op == READ_OP) ? MR_STATE : MT_STATE);
   m_addr = (m_dev->m_addr | op);
   m_status = NO_INFO;
-  m_next = (uint8_t*) m_vec[0].buf;
-  m_last = m_next + m_vec[0].size;
+  m_next = (uint8_t*) m_vp[0].buf;
+  m_last = m_next + m_vp[0].size;
   m_ix = 0;
   m_count = 0;
 
@@ -144,14 +209,58 @@ TWI::isr_start(State state, uint8_t ix)
     ix = m_ix;
   }
   else m_count = 0;
-  m_next = (uint8_t*) m_vec[ix].buf;
-  m_last = m_next + m_vec[ix].size;
+  m_next = (uint8_t*) m_vp[ix].buf;
+  m_last = m_next + m_vp[ix].size;
   m_state = state;
 }
 
+void
+TWI::isr_next(State state, uint8_t type)
+{
+  Transaction* transaction = m_trans;
+
+  // Issue repeated start for the read phase of the transaction
+  if ((state != ERROR_STATE)
+      && (m_state == MT_STATE)
+      && (transaction->m_rvec != NULL)) {
+    m_vp = transaction->m_rvec;
+    request(READ_OP);
+    return;
+  }
+
+  // Complete the transaction
+  if (UNLIKELY(state == ERROR_STATE)) {
+    TWCR = TWI::STOP_CMD;
+    loop_until_bit_is_clear(TWCR, TWSTO);
+    m_count = -1;
+    type = Event::ERROR_TYPE;
+  }
+  m_state = state;
+  bool stop = transaction->m_stop;
+  transaction->m_count = m_count;
+  transaction->detach();
+  transaction->on_completed(type, m_count);
+
+  // Chain the next transaction with repeated start or stop and release
+  if (stop || m_queue.is_empty()) {
+    if (state != ERROR_STATE) {
+      TWCR = TWI::STOP_CMD;
+      loop_until_bit_is_clear(TWCR, TWSTO);
+    }
+    m_state = IDLE_STATE;
+  }
+  resume();
+}
+
 void
 TWI::isr_stop(State state, uint8_t type)
 {
+  // Check for asynchronous transaction
+  if (m_trans != NULL) {
+    isr_next(state, type);
+    return;
+  }
+
   TWCR = TWI::STOP_CMD;
   loop_until_bit_is_clear(TWCR, TWSTO);
   if (UNLIKELY(state == TWI::ERROR_STATE)) m_count = -1;
@@ -162,7 +271,9 @@ TWI::isr_stop(State state, uint8_t type)
     m_dev->on_completion(type, m_count);
     m_dev = NULL;
     m_busy = false;
+    PROBE_CLEAR(TWI);
     TWCR = 0;
+    if (UNLIKELY(!m_queue.is_empty())) resume();
   }
 }
 
@@ -186,8 +297,11 @@ TWI::isr_read(Command cmd)
   return (true);
 }
 
+ISR_PROBE_DEFINE(twi_isr_probe, "isr:TWI");
+
 ISR(TWI_vect)
 {
+  ISR_PROBE(twi_isr_probe);
   twi.m_status = TWI_STATUS(TWSR);
   switch (twi.m_status) {
     /**
@@ -200,7 +314,11 @@ ISR(TWI_vect)
     TWCR = TWI::DATA_CMD;
     break;
   case TWI::ARB_LOST:
-    // Lost arbitration
+    // Lost arbitration; complete asynchronous transaction with error
+    if (twi.m_trans != NULL) {
+      twi.isr_next(TWI::ERROR_STATE, Event::ERROR_TYPE);
+      break;
+    }
     TWCR = TWI::IDLE_CMD;
     twi.m_state = TWI::ERROR_STATE;
     twi.m_count = -1;
@@ -225,8 +343,14 @@ ISR(TWI_vect)
      */
   case TWI::MR_DATA_ACK:
     twi.isr_read();
+    if (twi.m_next == twi.m_last) twi.isr_start(TWI::MR_STATE, TWI::NEXT_IX);
   case TWI::MR_SLA_ACK:
-    TWCR = (twi.m_next < (twi.m_last - 1)) ? TWI::ACK_CMD : TWI::NACK_CMD;
+    // Acknowledge if there are more bytes to receive after the next
+    if ((twi.m_next < (twi.m_last - 1))
+	|| (twi.m_vp[twi.m_ix + 1].buf != NULL))
+      TWCR = TWI::ACK_CMD;
+    else
+      TWCR = TWI::NACK_CMD;
     break;
   case TWI::MR_DATA_NACK:
     twi.isr_read();
@@ -26,6 +26,7 @@
 #include "Cosa/USI/TWI.hh"
 #else
 #include "Cosa/Event.hh"
+#include "Cosa/Linkage.hh"
 #include <avr/power.h>
 
 /**
@@ -199,6 +200,134 @@ public:
     friend void TWI_vect(void);
   };
 
+  /**
+   * Asynchronous TWI transaction descriptor. Holds the device driver,
+   * and the null terminated write and read io buffer vectors. The
+   * write vector is transmitted first and the read vector is received
+   * after a repeated start condition. Either vector may be NULL.
+   * Transactions are queued with TWI::start() and chained back-to-back
+   * by the TWI interrupt service routine (with repeated start) until
+   * the queue is empty. Transactions for several device drivers may
+   * be outstanding. The virtual member function on_completed() is
+   * called from the interrupt service routine when the transaction is
+   * completed.
+   * @code
+   * uint8_t reg = REG;
+   * iovec_t wvec[2], rvec[2];
+   * iovec_t* vp = wvec;
+   * iovec_arg(vp, &reg, sizeof(reg));
+   * iovec_end(vp);
+   * vp = rvec;
+   * iovec_arg(vp, buf, sizeof(buf));
+   * iovec_end(vp);
+   * TWI::Transaction transaction(this, wvec, rvec);
+   * twi.start(&transaction);
+   * ...
+   * transaction.await();
+   * @endcode
+   * @pre The io vectors should hold at least one buffer and buffers
+   * in the read vector should not be empty.
+   */
+  class Transaction : public Link {
+  public:
+    /**
+     * Construct TWI transaction descriptor for given device driver
+     * and io buffer vectors.
+     * @param[in] dev device driver.
+     * @param[in] wvec null terminated write io vector (default NULL).
+     * @param[in] rvec null terminated read io vector (default NULL).
+     */
+    Transaction(Driver* dev,
+		const iovec_t* wvec = NULL,
+		const iovec_t* rvec = NULL) :
+      Link(),
+      m_dev(dev),
+      m_wvec(wvec),
+      m_rvec(rvec),
+      m_count(0),
+      m_stop(false)
+    {}
+
+    /**
+     * Set write and read io buffer vectors for the transaction.
+     * Should not be used while the transaction is pending.
+     * @param[in] wvec null terminated write io vector.
+     * @param[in] rvec null terminated read io vector (default NULL).
+     */
+    void set(const iovec_t* wvec, const iovec_t* rvec = NULL)
+    {
+      m_wvec = wvec;
+      m_rvec = rvec;
+    }
+
+    /**
+     * Require a stop condition after the transaction instead of a
+     * repeated start for the next queued transaction, e.g. to start
+     * an EEPROM write cycle.
+     * @param[in] stop condition required.
+     */
+    void set_stop(bool stop)
+    {
+      m_stop = stop;
+    }
+
+    /**
+     * Return true(1) if the transaction is queued or in progress
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_pending() const
+      __attribute__((always_inline))
+    {
+      return (pred() != this);
+    }
+
+    /**
+     * Wait for the transaction to complete. Returns number of bytes
+     * read (or written if there is no read vector) or negative error
+     * code.
+     * @return number of bytes or negative error code.
+     */
+    int await()
+    {
+      while (is_pending()) yield();
+      return (m_count);
+    }
+
+    /**
+     * Return number of bytes read (or written if there is no read
+     * vector) or negative error code for the last completed
+     * transaction.
+     * @return number of bytes or negative error code.
+     */
+    int count() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * @override{TWI::Transaction}
+     * Called from the TWI interrupt service routine when the
+     * transaction is completed. Default implementation calls the
+     * device driver completion callback.
+     * @param[in] type event code.
+     * @param[in] count number of bytes or negative error code.
+     */
+    virtual void on_completed(uint8_t type, int count)
+    {
+      m_dev->on_completion(type, count);
+    }
+
+  protected:
+    Driver* m_dev;		//!< Device driver.
+    const iovec_t* m_wvec;	//!< Write io buffer vector.
+    const iovec_t* m_rvec;	//!< Read io buffer vector.
+    volatile int m_count;	//!< Result count or error code.
+    bool m_stop;		//!< Stop condition after transaction.
+    friend class TWI;
+    friend void TWI_vect(void);
+  };
+
   /**
    * Construct two-wire instance. This is actually a single-ton on
    * current supported hardware, i.e. there can only be one unit.
@@ -212,7 +341,9 @@ public:
     m_count(0),
     m_dev(NULL),
     m_freq(((F_CPU / DEFAULT_FREQ) - 16) / 2),
-    m_busy(false)
+    m_busy(false),
+    m_vp(m_vec),
+    m_trans(NULL)
   {
     for (uint8_t ix = 0; ix < VEC_MAX; ix++) {
       m_vec[ix].buf = 0;
@@ -229,10 +360,21 @@ public:
   void acquire(TWI::Driver* dev);
 
   /**
-   * Release TWI hardware and bus.
+   * Release TWI hardware and bus. Queued asynchronous transactions
+   * are started.
    */
   void release();
 
+  /**
+   * Queue the given asynchronous transaction. The transaction is
+   * started directly if the bus is not in use otherwise when the
+   * current transaction is completed or the bus is released. Returns
+   * true(1) if successful otherwise false(0).
+   * @param[in] transaction descriptor.
+   * @return bool.
+   */
+  bool start(Transaction* transaction);
+
   /**
    * Issue a write data request to the current driver. Return
    * true(1) if successful otherwise false(0).
@@ -470,6 +612,9 @@ private:
   Driver* m_dev;
   uint8_t m_freq;
   volatile bool m_busy;
+  const iovec_t* m_vp;
+  Head m_queue;
+  Transaction* m_trans;
 
   /**
    * Start block transfer. Setup internal buffer pointers.
@@ -504,6 +649,21 @@ private:
    */
   void isr_stop(State state, uint8_t type = Event::NULL_TYPE);
 
+  /**
+   * Step the current asynchronous transaction; issue repeated start
+   * for the read vector or complete the transaction and start the
+   * next queued. Part of the TWI ISR state machine.
+   * @param[in] state to step to.
+   * @param[in] type of event.
+   */
+  void isr_next(State state, uint8_t type);
+
+  /**
+   * Start the next queued asynchronous transaction or release the bus
+   * if the queue is empty. Called from ISR or synchronized block.
+   */
+  void resume();
+
   /**
    * Initiate a request to the device. Return true(1) if successful
    * otherwise false(0).
@@ -82,46 +82,70 @@ const uint8_t time_t::days_in[] __PROGMEM = {
   0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
 };
 
+uint32_t time_t::s_epoch_days = 146037L;
+
+uint32_t
+time_t::civil_days(uint16_t year, uint8_t month, uint8_t date)
+{
+  // Use March based years so that the leap day is the last day
+  if (month <= 2) {
+    year -= 1;
+    month += 12;
+  }
+  uint16_t y = year - 1600;
+  uint16_t doy = (153 * (month - 3) + 2) / 5 + date - 1;
+  return (y * 365UL + (y >> 2) - (y / 100) + (y / 400) + doy);
+}
+
 time_t::time_t(clock_t c, int8_t zone)
 {
   c += zone * (int32_t) SECONDS_PER_HOUR;
-  uint16_t dayno = c / SECONDS_PER_DAY;
-  c -= dayno * (uint32_t) SECONDS_PER_DAY;
+
+  // Split into days and seconds of the day; 86400 = 128 * 675
+  uint16_t dayno = (c >> 7) / 675;
+  uint32_t s = c - dayno * SECONDS_PER_DAY;
   day = weekday_for(dayno);
 
-  uint16_t y = epoch_year();
-  for (;;) {
-    uint16_t days = days_per(y);
-    if (dayno < days) break;
-    dayno -= days;
-    y++;
+  // Time of day with 16-bit arithmetic; 3600 = 16 * 225
+  uint16_t h = ((uint16_t) (s >> 4)) / 225;
+  uint16_t r = (uint16_t) s - h * SECONDS_PER_HOUR;
+  uint8_t m = r / SECONDS_PER_MINUTE;
+  hours = h;
+  minutes = m;
+  seconds = r - m * SECONDS_PER_MINUTE;
+
+  // Days from March 1, 1600. Step 400 year cycles and centuries
+  uint32_t z = dayno + s_epoch_days;
+  uint16_t y = 1600;
+  while (z >= 146097L) {
+    z -= 146097L;
+    y += 400;
   }
-  bool leap_year = is_leap(y);
-  y -= epoch_year();
-  y += epoch_offset;
-  while (y > 100)
-    y -= 100;
-  year = y;
-
-  month = 1;
-  for (;;) {
-    uint8_t days = pgm_read_byte(&days_in[month]);
-    if (leap_year && (month == 2)) days++;
-    if (dayno < days) break;
-    dayno -= days;
-    month++;
+  for (uint8_t i = 0; i < 3 && z >= 36524; i++) {
+    z -= 36524;
+    y += 100;
   }
-  date = dayno + 1;
 
-  hours = c / SECONDS_PER_HOUR;
-
-  uint16_t c_ms;
-  if (hours < 18) // save 16uS
-    c_ms = (uint16_t) c - (hours * (uint16_t) SECONDS_PER_HOUR);
-  else
-    c_ms = c - (hours * (uint32_t) SECONDS_PER_HOUR);
-  minutes = c_ms / SECONDS_PER_MINUTE;
-  seconds = c_ms - (minutes * SECONDS_PER_MINUTE);
+  // Four year periods and years within the century; 16-bit
+  uint16_t dc = z;
+  uint16_t q = dc / 1461;
+  uint16_t dq = dc - q * 1461;
+  uint8_t yq = dq / 365;
+  if (yq > 3) yq = 3;
+  uint16_t doy = dq - yq * 365;
+  y += q * 4 + yq;
+
+  // Month and date from March based day of year
+  uint8_t mp = (5 * doy + 2) / 153;
+  date = doy - (153 * mp + 2) / 5 + 1;
+  if (mp < 10) {
+    month = mp + 3;
+  }
+  else {
+    month = mp - 9;
+    y += 1;
+  }
+  year = y % 100;
 }
 
 time_t::operator clock_t() const
@@ -139,13 +163,7 @@ time_t::operator clock_t() const
 
 uint16_t time_t::days() const
 {
-  uint16_t day_count = day_of_year();
-
-  uint16_t y = full_year();
-  while (y-- > epoch_year())
-    day_count += days_per(y);
-
-  return (day_count);
+  return (civil_days(full_year(), month, date) - s_epoch_days);
 }
 
 uint16_t time_t::day_of_year() const
@@ -161,6 +179,51 @@ uint16_t time_t::day_of_year() const
   return (dayno);
 }
 
+void time_t::tick(uint16_t secs)
+{
+  // Add seconds and carry to minutes, hours and days
+  uint16_t s = seconds + secs;
+  if (s < SECONDS_PER_MINUTE) {
+    seconds = s;
+    return;
+  }
+  uint16_t m = s / SECONDS_PER_MINUTE;
+  seconds = s - m * SECONDS_PER_MINUTE;
+  m += minutes;
+  if (m < 60) {
+    minutes = m;
+    return;
+  }
+  uint16_t h = m / 60;
+  minutes = m - h * 60;
+  h += hours;
+  if (h < 24) {
+    hours = h;
+    return;
+  }
+  uint8_t d = h / 24;
+  hours = h - d * 24;
+  while (d--) next_day();
+}
+
+void time_t::next_day()
+{
+  day = (day == SATURDAY) ? SUNDAY : day + 1;
+  uint8_t days = pgm_read_byte(&days_in[month]);
+  if ((month == 2) && is_leap()) days++;
+  if (date < days) {
+    date++;
+    return;
+  }
+  date = 1;
+  if (month < 12) {
+    month++;
+    return;
+  }
+  month = 1;
+  year = (year == 99) ? 0 : year + 1;
+}
+
 void time_t::use_fastest_epoch()
 {
   // Figure out when we were compiled and use the year for a really
@@ -146,6 +146,13 @@ struct time_t {
    */
   operator clock_t() const;
 
+  /**
+   * Advance the time by the given number of seconds. The calendar
+   * members are stepped with carry; no conversion to and from clock.
+   * @param[in] secs seconds to advance (default 1).
+   */
+  void tick(uint16_t secs = 1);
+
   /**
    * Set day member from time record.
    */
@@ -262,6 +269,7 @@ struct time_t {
   static void epoch_year(uint16_t y)
   {
     s_epoch_year = y;
+    s_epoch_days = civil_days(y, 1, 1);
     epoch_offset = s_epoch_year % 100;
     pivot_year = epoch_offset;
   }
@@ -303,7 +311,27 @@ struct time_t {
    */
   static const uint8_t days_in[] PROGMEM;
 
+  /**
+   * Calculate number of days from March 1, 1600 (start of a 400 year
+   * cycle) to the given date. Uses 16-bit division only. Year must be
+   * 1600 or later.
+   * @param[in] year (4-digit).
+   * @param[in] month 1..12.
+   * @param[in] date 1..31.
+   * @return days.
+   */
+  static uint32_t civil_days(uint16_t year, uint8_t month, uint8_t date);
+
 protected:
+  /** Days from March 1, 1600 to January 1 of the epoch year. */
+  static uint32_t s_epoch_days;
+
+  /**
+   * Step calendar members to the next day; weekday, date, month and
+   * year.
+   */
+  void next_day();
+
   static uint16_t s_epoch_year;
   static uint8_t epoch_offset;
 } __attribute__((packed));
@@ -19,6 +19,7 @@
  */
 
 #include "Cosa/Tone.hh"
+#include "Cosa/Note.hh"
 #include "Cosa/Watchdog.hh"
 
 #if !defined(BOARD_ATTINY)
@@ -118,6 +119,61 @@ Tone::silent()
   Power::timer1_disable();
 }
 
+void
+Tone::Player::play(const uint16_t* score, uint8_t volume, bool repeat)
+{
+  Job::stop();
+  m_score = score;
+  m_next = score;
+  m_volume = volume;
+  m_repeat = repeat;
+  expire_at(time());
+  run();
+}
+
+void
+Tone::Player::end()
+{
+  Job::stop();
+  if (m_next == NULL) return;
+  m_next = NULL;
+  on_note(0);
+}
+
+void
+Tone::Player::on_note(uint16_t freq)
+{
+  if ((freq == 0) || (freq == Note::PAUSE))
+    Tone::silent();
+  else
+    Tone::play(freq, m_volume);
+}
+
+void
+Tone::Player::run()
+{
+  if (UNLIKELY(m_next == NULL)) return;
+
+  // Check for end of score; repeat or stop
+  uint16_t freq = pgm_read_word(m_next++);
+  if (freq == Note::END) {
+    m_next = m_score;
+    freq = pgm_read_word(m_next++);
+    if (!m_repeat || (freq == Note::END)) {
+      m_next = NULL;
+      on_note(0);
+      on_end();
+      return;
+    }
+  }
+
+  // Play note and schedule next relative to this; no drift
+  uint16_t ms = pgm_read_word(m_next++);
+  on_note(freq);
+  expire_after(ms * 1000UL);
+  start();
+}
+
 ISR(TIMER1_COMPA_vect)
 {
   // Check if the tone should be turned off
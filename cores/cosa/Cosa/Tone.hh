@@ -22,6 +22,7 @@
 #define COSA_TONE_HH
 
 #include "Cosa/Types.h"
+#include "Cosa/Job.hh"
 
 /**
  * Cosa tone/toneAC library with the advantage of nearly twice the volume,
@@ -94,6 +95,89 @@ public:
    */
   static void silent();
 
+  /**
+   * Background score player. Plays a score in program memory; pairs
+   * of frequency (Note) and duration (milli-seconds), terminated by
+   * Note::END. Note::PAUSE is a rest. The notes are scheduled with
+   * the given RTT::Scheduler (micro-seconds) and the application is
+   * not blocked.
+   * @code
+   * static const uint16_t alarm[] __PROGMEM = {
+   *   Note::A5, 200, Note::PAUSE, 100, Note::A5, 200, Note::END
+   * };
+   * RTT::Scheduler scheduler;
+   * Tone::Player player(&scheduler);
+   * ...
+   * player.play(alarm);
+   * @endcode
+   */
+  class Player : public Job {
+  public:
+    /**
+     * Construct score player with given scheduler.
+     * @param[in] scheduler for note timing (RTT::Scheduler).
+     */
+    Player(Job::Scheduler* scheduler) :
+      Job(scheduler),
+      m_score(NULL),
+      m_next(NULL),
+      m_volume(VOLUME_MAX / 2),
+      m_repeat(false)
+    {}
+
+    /**
+     * Start playing given score in program memory with given volume.
+     * The score is repeated until end() if repeat is true.
+     * @param[in] score pairs of frequency and duration (program memory).
+     * @param[in] volume output volume (Default VOLUME_MAX/2).
+     * @param[in] repeat score (Default false).
+     */
+    void play(const uint16_t* score,
+	      uint8_t volume = VOLUME_MAX / 2,
+	      bool repeat = false);
+
+    /**
+     * Stop playing the score.
+     */
+    void end();
+
+    /**
+     * Return true(1) if a score is playing otherwise false(0).
+     * @return bool.
+     */
+    bool is_playing() const
+    {
+      return (m_next != NULL);
+    }
+
+  protected:
+    const uint16_t* m_score;	//!< Score (program memory).
+    const uint16_t* m_next;	//!< Next note in score.
+    uint8_t m_volume;		//!< Output volume.
+    bool m_repeat;		//!< Repeat score.
+
+    /**
+     * @override{Tone::Player}
+     * Play the given note frequency; zero or Note::PAUSE is silent.
+     * Default is Tone::play() in background.
+     * @param[in] freq frequency in hz.
+     */
+    virtual void on_note(uint16_t freq);
+
+    /**
+     * @override{Tone::Player}
+     * Callback when the score has been played. Default is null
+     * function.
+     */
+    virtual void on_end() {}
+
+    /**
+     * @override{Job}
+     * Play the next note in the score and schedule the following.
+     */
+    virtual void run();
+  };
+
 private:
   /**
    * Do not allow instances; Static Class Single-ton.
@@ -29,8 +29,12 @@ Trace::begin(IOStream::Device* dev, str_P banner)
 {
   device(dev);
   if (banner != NULL) {
+#if defined(COSA_TRACE_BINARY)
+    record(banner);
+#else
     print(banner);
     println();
+#endif
   }
   return (true);
 }
@@ -23,6 +23,11 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/IOStream.hh"
+#include "Cosa/IOBuffer.hh"
+#include "Cosa/Event.hh"
+#if defined(COSA_TRACE_BINARY)
+#include "Cosa/RTT.hh"
+#endif
 
 /**
  * Basic trace support class. Combind IOStream with UART for trace
@@ -79,9 +84,226 @@ public:
   /** Result of latest MEASURE (in micro-seconds). */
   uint32_t measure;
 
+#if defined(COSA_TRACE_BINARY)
+  /**
+   * Binary trace record header. The format string address in program
+   * memory is used as record identity; the host tool (build/trace.py)
+   * reads the string from the program image and renders the text.
+   * The header is followed by the arguments in the native (little
+   * endian) representation after default argument promotion, i.e.
+   * as they would be passed to printf().
+   */
+  struct record_t {
+    uint8_t start;		//!< Record start marker (RECORD_START).
+    str_P format;		//!< Format string in program memory.
+    uint32_t timestamp;		//!< RTT::micros() when recorded.
+    uint8_t size;		//!< Number of argument bytes.
+  };
+
+  /** Record start marker. */
+  static const uint8_t RECORD_START = 0xa5;
+
+  /**
+   * Write binary trace record with given format string in program
+   * memory and arguments. The record is packed on the stack and
+   * written to the trace device with a single write; no formatting
+   * is performed on the device.
+   * @param[in] fmt format string in program memory.
+   * @param[in] args arguments.
+   */
+  template<typename... Args>
+  void record(str_P fmt, const Args&... args)
+  {
+    if (UNLIKELY(m_dev == NULL)) return;
+    const size_t SIZE = Size<Args...>::value;
+    static_assert(SIZE <= UINT8_MAX, "record: too many arguments");
+    uint8_t buf[sizeof(record_t) + SIZE];
+    record_t* header = (record_t*) buf;
+    header->start = RECORD_START;
+    header->format = fmt;
+    header->timestamp = RTT::micros();
+    header->size = SIZE;
+    pack(buf + sizeof(record_t), args...);
+    m_dev->write(buf, sizeof(buf));
+  }
+#endif
+
+  /**
+   * Deferred trace device. The trace output is appended to a RAM
+   * ring-buffer and moved to the output device when the event
+   * service is idle (Event::idle()); tracing does not block on the
+   * output device. A write that does not fit in the buffer is
+   * dropped as a whole and counted as an overflow; binary trace
+   * records are written with a single write. The buffer is drained
+   * completely by flush(), e.g. on ASSERT failure.
+   * @code
+   * Trace::Deferred<256> deferred(&uart);
+   * ...
+   * uart.begin(9600);
+   * trace.begin(&deferred, PSTR("CosaSketch: started"));
+   * ...
+   * Event::service();
+   * @endcode
+   * @param[in] SIZE number of bytes in buffer.
+   */
+  template<uint16_t SIZE>
+  class Deferred : public IOStream::Device, public Event::Handler {
+  public:
+    /**
+     * Construct deferred trace device with given output device and
+     * install as event service idle handler.
+     * @param[in] dev output device.
+     */
+    Deferred(IOStream::Device* dev) :
+      IOStream::Device(),
+      Event::Handler(),
+      m_dev(dev),
+      m_overflows(0)
+    {
+      Event::idle(this);
+    }
+
+    /**
+     * Return number of dropped writes.
+     * @return overflows.
+     */
+    uint16_t overflows() const
+    {
+      return (m_overflows);
+    }
+
+    /**
+     * @override{IOStream::Device}
+     * Number of bytes room in buffer.
+     * @return bytes.
+     */
+    virtual int room()
+    {
+      return (m_buffer.room());
+    }
+
+    /**
+     * @override{IOStream::Device}
+     * Append character to buffer. Never blocks.
+     * @param[in] c character to write.
+     * @return character written or EOF(-1).
+     */
+    virtual int putchar(char c)
+    {
+      int res = m_buffer.putchar(c);
+      if (UNLIKELY(res == IOStream::EOF)) m_overflows += 1;
+      return (res);
+    }
+
+    /** Overloaded virtual member function write. */
+    using IOStream::Device::write;
+
+    /**
+     * @override{IOStream::Device}
+     * Append data to buffer. Never blocks. The data is dropped if
+     * it does not fit.
+     * @param[in] buf buffer to write.
+     * @param[in] size number of bytes to write.
+     * @return number of bytes written or EOF(-1).
+     */
+    virtual int write(const void* buf, size_t size)
+    {
+      if (UNLIKELY((int) size > m_buffer.room())) {
+	m_overflows += 1;
+	return (IOStream::EOF);
+      }
+      return (m_buffer.write(buf, size));
+    }
+
+    /**
+     * @override{IOStream::Device}
+     * Move the buffer to the output device and wait for the output
+     * device to complete. Used on fatal errors.
+     * @return zero(0) or negative error code.
+     */
+    virtual int flush()
+    {
+      while (!m_buffer.is_empty()) {
+	const char* bp;
+	size_t n = m_buffer.span(bp);
+	int res = m_dev->write(bp, n);
+	if (res < 0) return (res);
+	m_buffer.consume(res);
+      }
+      return (m_dev->flush());
+    }
+
+    /**
+     * @override{Event::Handler}
+     * Move buffered output to the output device on idle event; the
+     * moved spans are limited by the room in the output device.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value)
+    {
+      UNUSED(value);
+      if (UNLIKELY(type != Event::IDLE_TYPE)) return;
+      const char* bp;
+      size_t n;
+      while ((n = m_buffer.span(bp)) != 0) {
+	int room = m_dev->room();
+	if (room <= 0) return;
+	if (n > (size_t) room) n = room;
+	int res = m_dev->write(bp, n);
+	if (res <= 0) return;
+	m_buffer.consume(res);
+      }
+    }
+
+  protected:
+    IOStream::Device* m_dev;	//!< Output device.
+    IOBuffer<SIZE> m_buffer;	//!< Trace buffer.
+    uint16_t m_overflows;	//!< Number of dropped writes.
+  };
+
 protected:
   /** Exit from serial monitor, miniterm. Default CTRL-ALT GR-] (0x1d) */
   char EXITCHARACTER;
+
+#if defined(COSA_TRACE_BINARY)
+  /**
+   * Number of bytes for the given argument types after default
+   * argument promotion.
+   */
+  template<typename... Args>
+  struct Size {
+    static const size_t value = 0;
+  };
+  template<typename T, typename... Args>
+  struct Size<T, Args...> {
+    static const size_t value =
+      sizeof(decltype(+*(T*) 0)) + Size<Args...>::value;
+  };
+
+  /**
+   * Pack given arguments after default argument promotion to the
+   * given buffer.
+   * @param[in] dp destination pointer.
+   * @param[in] value argument.
+   * @param[in] args remaining arguments.
+   */
+  template<typename T, typename... Args>
+  static void pack(uint8_t* dp, const T& value, const Args&... args)
+  {
+    decltype(+value) v = +value;
+    memcpy(dp, &v, sizeof(v));
+    pack(dp + sizeof(v), args...);
+  }
+
+  /**
+   * End of argument list.
+   */
+  static void pack(uint8_t* dp)
+  {
+    UNUSED(dp);
+  }
+#endif
 };
 
 /**
@@ -118,6 +340,13 @@ extern uint8_t trace_log_mask;
 	      __PSTR(msg))
 #ifndef NDEBUG
 
+/**
+ * Support macro for the binary trace record identity; source file
+ * and line number as a string literal.
+ */
+#define TRACE_STRINGIFY(x) #x
+#define TRACE_SITE(line) __FILE__ ":" TRACE_STRINGIFY(line) ":"
+
 /**
  * Support macro to check that an expression is valid. The expression
  * is used as a string and evaluated. If false a message is printed
@@ -133,14 +362,21 @@ extern uint8_t trace_log_mask;
  * Support macro for trace of a string in program memory.
  * @param[in] str string literal
  */
-# define TRACE_P(str) trace.print(PSTR(str))
+# if defined(COSA_TRACE_BINARY)
+#   define TRACE_P(str) trace.record(__PSTR(TRACE_SITE(__LINE__) str))
+# else
+#   define TRACE_P(str) trace.print(PSTR(str))
+# endif
 
 /**
  * Support macro for trace of an expression. The expression
  * is used as a string and evaluated.
  * @param[in] expr expression.
  */
-# if defined(TRACE_NO_VERBOSE) || defined(BOARD_ATTINY)
+# if defined(COSA_TRACE_BINARY)
+#   define TRACE(expr)							\
+    trace.record(__PSTR(TRACE_SITE(__LINE__) "trace:" #expr " = "), expr)
+# elif defined(TRACE_NO_VERBOSE) || defined(BOARD_ATTINY)
 #   define TRACE(expr)							\
     do {								\
       trace.print(__PSTR(#expr " = "));					\
@@ -163,11 +399,16 @@ extern uint8_t trace_log_mask;
  * function name prefix.
  * @param[in] msg log message.
  */
+# if defined(COSA_TRACE_BINARY)
+# define TRACE_LOG(msg, ...)						\
+  trace.record(__PSTR(TRACE_SITE(__LINE__) msg "\r\n"), __VA_ARGS__)
+# else
 # define TRACE_LOG(msg, ...)						\
   trace.printf(__PSTR("%d:%s:" msg "\r\n"),				\
 	       __LINE__,						\
 	       __PRETTY_FUNCTION__,					\
 	       __VA_ARGS__)
+# endif
 # define IS_LOG_PRIO(prio) (trace_log_mask & LOG_MASK(prio))
 # define EMERG(msg, ...)						\
   if (IS_LOG_PRIO(LOG_EMERG)) TRACE_LOG("emerg:" msg, __VA_ARGS__)
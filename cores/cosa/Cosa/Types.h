@@ -41,6 +41,26 @@
 #include "Cosa/Board.hh"
 #include "Cosa.h"
 
+/**
+ * Size optimized build profile; enable the feature pruning switches
+ * (see Cosa.h).
+ */
+#if defined(COSA_SIZE_PROFILE)
+# ifndef COSA_NO_TRACE
+#   define COSA_NO_TRACE
+# endif
+# ifndef COSA_CRC_TABLE
+#   define COSA_CRC_TABLE 4
+# endif
+#endif
+
+/**
+ * Remove trace and assert; the trace macros are defined empty.
+ */
+#if defined(COSA_NO_TRACE) && !defined(NDEBUG)
+# define NDEBUG
+#endif
+
 /**
  * Create an unique symbol for macro from given name and line.
  */
@@ -183,6 +203,17 @@ union univ32_t {
 # define __PROGMEM PROGMEM
 #endif
 
+/**
+ * Place variable in external memory (XMEM) when enabled (COSA_XMEM).
+ * Used for large buffers; frequently used data should stay in the
+ * internal memory. The section is zeroed by the start-up code.
+ */
+#if defined(COSA_XMEM)
+# define __XMEM __attribute__((section("xmem")))
+#else
+# define __XMEM
+#endif
+
 /** Unique data type for strings in program memory. */
 typedef const PROGMEM class prog_str* str_P;
 
@@ -315,11 +346,25 @@ extern void (*yield)();
  * Disable interrupts and return flags.
  * @return processor flags.
  */
+#if defined(COSA_ISR_PROFILE) && !defined(BOARD_ATTINY)
+/**
+ * Interrupts disabled window profile hooks (Cosa/Probe.cpp). Called
+ * with interrupts disabled when the outermost lock is taken and
+ * released. Nested locks and locks in interrupt service routines are
+ * not measured.
+ */
+extern void __irq_disabled();
+extern void __irq_enabled();
+#endif
+
 inline uint8_t lock() __attribute__((always_inline));
 inline uint8_t lock()
 {
   uint8_t key = SREG;
   __asm__ __volatile__("cli" ::: "memory");
+#if defined(COSA_ISR_PROFILE) && !defined(BOARD_ATTINY)
+  if (key & _BV(SREG_I)) __irq_disabled();
+#endif
   return (key);
 }
 
@@ -330,6 +375,9 @@ inline uint8_t lock()
 inline void unlock(uint8_t key) __attribute__((always_inline));
 inline void unlock(uint8_t key)
 {
+#if defined(COSA_ISR_PROFILE) && !defined(BOARD_ATTINY)
+  if (key & _BV(SREG_I)) __irq_enabled();
+#endif
   SREG = key;
   __asm__ __volatile__("" ::: "memory");
 }
@@ -342,6 +390,9 @@ inline void unlock(uint8_t key)
 inline void __unlock(uint8_t* key) __attribute__((always_inline));
 inline void __unlock(uint8_t* key)
 {
+#if defined(COSA_ISR_PROFILE) && !defined(BOARD_ATTINY)
+  if (*key & _BV(SREG_I)) __irq_enabled();
+#endif
   SREG = *key;
   __asm__ __volatile__("" ::: "memory");
 }
@@ -20,6 +20,7 @@
 
 #include "Cosa/Board.hh"
 #include "Cosa/UART.hh"
+#include "Cosa/Probe.hh"
 
 #if defined(BOARD_ATTINY)
 // Default is serial output only (UAT)
@@ -28,6 +29,7 @@
 Soft::UAT  __attribute__ ((weak)) uart(Board::D2);
 #else
 
+#include "Cosa/Power.hh"
 #include <avr/power.h>
 
 #if defined(USBCON)
@@ -44,8 +46,9 @@ UART* UART::uart[Board::UART_MAX] = { NULL };
 bool
 UART::begin(uint32_t baudrate, uint8_t format)
 {
-  // Power up the device
+  // Power up the device; receiver requires idle sleep mode
   powerup();
+  if ((*UCSRnB() & _BV(TXEN0)) == 0) Power::acquire(Power::IDLE_LEVEL);
 
   // Check if double rate is not possible
   uint16_t setting = ((F_CPU / 4 / baudrate) - 1) / 2;
@@ -70,6 +73,7 @@ UART::end()
 {
   // Flush an output
   flush();
+  if (*UCSRnB() & _BV(TXEN0)) Power::release(Power::IDLE_LEVEL);
 
   // Disable receiver and transmitter interrupt
   *UCSRnB() &= ~(_BV(RXCIE0) | _BV(RXEN0) | _BV(TXEN0));
@@ -126,6 +130,30 @@ UART::putchar(char c)
   return (c & 0xff);
 }
 
+int
+UART::write(const void* buf, size_t size)
+{
+  if (UNLIKELY(size == 0)) return (0);
+
+  // Put the first character through the fast track
+  const char* bp = (const char*) buf;
+  putchar(*bp++);
+
+  // Move remaining data to the output buffer in spans
+  size_t n = size - 1;
+  while (n != 0) {
+    int res = m_obuf->write(bp, n);
+    if (res <= 0) {
+      yield();
+      continue;
+    }
+    *UCSRnB() |= _BV(UDRIE0);
+    bp += res;
+    n -= res;
+  }
+  return (size);
+}
+
 int
 UART::flush()
 {
@@ -220,18 +248,42 @@ UART::on_udre_interrupt()
 void
 UART::on_rx_interrupt()
 {
+  bool empty = (m_target != NULL) && (m_ibuf->available() == 0);
   m_ibuf->putchar(*UDRn());
+  if (empty) Event::push(Event::RECEIVE_REQUEST_TYPE, m_target, this);
+  if (m_frame != NULL) m_frame->on_receive();
+}
+
+void
+UART::Frame::on_expired()
+{
+  // Restart the timeout if characters were received within the period
+  uint32_t expires = m_last + m_period;
+  if ((int32_t) (expires - time()) > 0) {
+    expire_at(expires);
+    start();
+    return;
+  }
+
+  // Line idle; signal end of frame
+  Event::push(Event::RECEIVE_COMPLETED_TYPE, m_target, this);
 }
 
 #define UART_ISR(vec,nr)			\
+ISR_PROBE_DEFINE(vec ## _udre_isr_probe,	\
+		 "isr:" #vec "_UDRE");		\
 ISR(vec ## _UDRE_vect)				\
 {						\
+  ISR_PROBE(vec ## _udre_isr_probe);		\
   if (UNLIKELY(UART::uart[nr] == NULL)) return;	\
   UART::uart[nr]->on_udre_interrupt();		\
 }						\
 						\
+ISR_PROBE_DEFINE(vec ## _rx_isr_probe,		\
+		 "isr:" #vec "_RX");		\
 ISR(vec ## _RX_vect)				\
 {						\
+  ISR_PROBE(vec ## _rx_isr_probe);		\
   if (UNLIKELY(UART::uart[nr] == NULL)) return;	\
   UART::uart[nr]->on_rx_interrupt();		\
 }						\
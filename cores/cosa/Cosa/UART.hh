@@ -49,6 +49,9 @@ extern Soft::UAT uart;
 #include "Cosa/Types.h"
 #include "Cosa/Serial.hh"
 #include "Cosa/IOStream.hh"
+#include "Cosa/IOBuffer.hh"
+#include "Cosa/Job.hh"
+#include "Cosa/Event.hh"
 #include "Cosa/Board.hh"
 
 /**
@@ -74,11 +77,148 @@ public:
     m_sfr(Board::UART(port)),
     m_ibuf(ibuf),
     m_obuf(obuf),
-    m_idle(true)
+    m_idle(true),
+    m_frame(NULL),
+    m_target(NULL)
   {
     uart[port] = this;
   }
 
+  /**
+   * Receive frame idle detector. Records the scheduler time of the
+   * first character in a received burst and pushes an event,
+   * RECEIVE_COMPLETED_TYPE with the detector as value, to the target
+   * when the line has been idle for the given period (end of
+   * frame). The period is in the time unit of the scheduler. The
+   * idle detector is installed with UART::frame().
+   * @code
+   * RTT::Scheduler scheduler;
+   * UART::Frame frame(&scheduler, &parser);
+   * ...
+   * frame.period(19200, 4);
+   * uart.frame(&frame);
+   * @endcode
+   */
+  class Frame : public Job {
+  public:
+    /**
+     * Construct receive frame idle detector with given scheduler,
+     * event target and idle period (scheduler time unit).
+     * @param[in] scheduler for idle timeout.
+     * @param[in] target event handler.
+     * @param[in] period idle time (default 0).
+     */
+    Frame(Job::Scheduler* scheduler, Event::Handler* target,
+	  uint32_t period = 0UL) :
+      Job(scheduler),
+      m_target(target),
+      m_period(period),
+      m_timestamp(0UL),
+      m_last(0UL),
+      m_count(0)
+    {}
+
+    /**
+     * Set idle period to the given number of character times at the
+     * given baudrate. Assumes a micro-second time base (RTT) and
+     * 11 bits per character (start, 8 data, parity/stop, stop).
+     * @param[in] baudrate serial bitrate.
+     * @param[in] chars number of character times (default 4).
+     */
+    void period(uint32_t baudrate, uint8_t chars = 4)
+    {
+      m_period = (chars * 11 * 1000000UL) / baudrate;
+    }
+
+    /**
+     * Return time of the first received character in the latest
+     * burst (scheduler time unit).
+     * @return time stamp.
+     */
+    uint32_t timestamp() const
+    {
+      uint32_t res;
+      synchronized res = m_timestamp;
+      return (res);
+    }
+
+    /**
+     * Return number of characters received in the latest burst.
+     * @return characters.
+     */
+    uint16_t count() const
+    {
+      uint16_t res;
+      synchronized res = m_count;
+      return (res);
+    }
+
+    /**
+     * Record reception of a character. Starts the idle timeout on
+     * the first character of a burst. Called from the UART receive
+     * interrupt handler.
+     */
+    void on_receive()
+      __attribute__((always_inline))
+    {
+      uint32_t now = time();
+      if (!is_started()) {
+	m_timestamp = now;
+	m_count = 0;
+	expire_at(now + m_period);
+	start();
+      }
+      m_last = now;
+      m_count += 1;
+    }
+
+    /**
+     * @override{Job}
+     * Check for idle line; restart the timeout if characters were
+     * received within the period, otherwise push end of frame event.
+     * Called from the scheduler interrupt service routine.
+     */
+    virtual void on_expired();
+
+  protected:
+    Event::Handler* m_target;		//!< End of frame event target.
+    uint32_t m_period;			//!< Idle period.
+    volatile uint32_t m_timestamp;	//!< Time of first character.
+    volatile uint32_t m_last;		//!< Time of latest character.
+    volatile uint16_t m_count;		//!< Characters in burst.
+  };
+
+  /**
+   * Set receive frame idle detector. Pass NULL to disable.
+   * @param[in] frame idle detector.
+   */
+  void frame(Frame* frame)
+  {
+    synchronized m_frame = frame;
+  }
+
+  /**
+   * Set receive event target. An event, RECEIVE_REQUEST_TYPE with the
+   * UART as value, is pushed to the target when a character is
+   * received into an empty input buffer. The target should read all
+   * available data. Pass NULL to disable.
+   * @param[in] target event handler.
+   */
+  void notify(Event::Handler* target)
+  {
+    synchronized m_target = target;
+  }
+
+  /**
+   * Start transmission of the output buffer. Used when the output
+   * buffer is written directly (e.g. Bridge::Fill).
+   */
+  void transmit()
+  {
+    m_idle = false;
+    *UCSRnB() |= _BV(UDRIE0);
+  }
+
   /**
    * @override{IOStream::Device}
    * Number of bytes available in input buffer.
@@ -108,6 +248,21 @@ public:
    */
   virtual int putchar(char c);
 
+  /** Overloaded virtual member function write. */
+  using IOStream::Device::write;
+
+  /**
+   * @override{IOStream::Device}
+   * Write data from buffer with given size to serial port output
+   * buffer. The data is moved to the output buffer in spans and the
+   * transmitter is enabled once per span. Waits for room in the
+   * output buffer. Returns number of bytes written.
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes written.
+   */
+  virtual int write(const void* buf, size_t size);
+
   /**
    * @override{IOStream::Device}
    * Peek at next character from serial port input buffer. Returns
@@ -141,6 +296,22 @@ public:
     return (m_ibuf->getchar());
   }
 
+  /** Overloaded virtual member function read. */
+  using IOStream::Device::read;
+
+  /**
+   * @override{IOStream::Device}
+   * Read data to given buffer with given size from serial port input
+   * buffer. Returns number of bytes read (available).
+   * @param[in] buf buffer to read into.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes read.
+   */
+  virtual int read(void* buf, size_t size)
+  {
+    return (m_ibuf->read(buf, size));
+  }
+
   /**
    * @override{IOStream::Device}
    * Flush device output buffer and wait for device to become idle and
@@ -195,6 +366,8 @@ protected:
   IOStream::Device* m_ibuf;		//!< Input Buffer/Device.
   IOStream::Device* m_obuf;		//!< Output Buffer/Device.
   bool m_idle;				//!< Flag idle mode.
+  Frame* m_frame;			//!< Receive frame idle detector.
+  Event::Handler* m_target;		//!< Receive event target.
 
   /**
    * Serial port references. Only uart0 is predefined (reference to global
@@ -288,6 +461,109 @@ protected:
 #endif
 };
 
+/**
+ * UART device handler with internal buffers of the given sizes. The
+ * interrupt handlers access the receive and transmit ring buffers
+ * directly (statically bound and inlined IOBuffer member functions)
+ * instead of through the IOStream::Device interface. This removes a
+ * virtual call per character in the interrupt service routines and
+ * is recommended for high baud-rates (500 Kbps and above).
+ * @code
+ * UART_T<64, 64> uart1(1);
+ * @endcode
+ * @param[in] RX_SIZE number of bytes in receive buffer.
+ * @param[in] TX_SIZE number of bytes in transmit buffer.
+ * @pre RX_SIZE and TX_SIZE are powerof(2) and max 32Kbyte.
+ */
+template<uint16_t RX_SIZE, uint16_t TX_SIZE>
+class UART_T : public UART {
+public:
+  /**
+   * Construct serial port handler for given UART with internal
+   * buffers.
+   * @param[in] port number.
+   */
+  UART_T(uint8_t port) :
+    UART(port, &m_rx, &m_tx)
+  {}
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes available in input buffer.
+   * @return bytes.
+   */
+  virtual int available()
+  {
+    return (m_rx.IOBuffer<RX_SIZE>::available());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes room in output buffer.
+   * @return bytes.
+   */
+  virtual int room()
+  {
+    return (m_tx.IOBuffer<TX_SIZE>::room());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Peek at next character from serial port input buffer. Returns
+   * character if successful otherwise a negative error code (EOF(-1)).
+   * @return character or EOF(-1).
+   */
+  virtual int peekchar()
+  {
+    return (m_rx.IOBuffer<RX_SIZE>::peekchar());
+  }
+
+  /**
+   * @override{IOStream::Device}
+   * Read character from serial port input buffer. Returns character
+   * if successful otherwise a negative error code (EOF(-1)).
+   * @return character or EOF(-1).
+   */
+  virtual int getchar()
+  {
+    return (m_rx.IOBuffer<RX_SIZE>::getchar());
+  }
+
+protected:
+  IOBuffer<RX_SIZE> m_rx;		//!< Receive buffer.
+  IOBuffer<TX_SIZE> m_tx;		//!< Transmit buffer.
+
+  /**
+   * @override{UART}
+   * UART data register empty (transmit) interrupt handler. Direct
+   * access of the transmit buffer.
+   */
+  virtual void on_udre_interrupt()
+  {
+    int c = m_tx.IOBuffer<TX_SIZE>::getchar();
+    if (c != IOStream::EOF) {
+      *UDRn() = c;
+      *UCSRnA() |= _BV(TXC0);
+    }
+    else {
+      *UCSRnB() &= ~_BV(UDRIE0);
+    }
+  }
+
+  /**
+   * @override{UART}
+   * UART receive interrupt handler. Direct access of the receive
+   * buffer.
+   */
+  virtual void on_rx_interrupt()
+  {
+    bool empty = (m_target != NULL) && m_rx.IOBuffer<RX_SIZE>::is_empty();
+    m_rx.IOBuffer<RX_SIZE>::putchar(*UDRn());
+    if (empty) Event::push(Event::RECEIVE_REQUEST_TYPE, m_target, this);
+    if (m_frame != NULL) m_frame->on_receive();
+  }
+};
+
 /**
  * Default serial port(0). Weakly defined (See UART.cpp). On Leonardo
  * and other ATmega32u4 based boards the standard serial is CDC.
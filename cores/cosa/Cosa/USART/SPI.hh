@@ -0,0 +1,435 @@
+/**
+ * @file Cosa/USART/SPI.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_USART_SPI_HH
+#define COSA_USART_SPI_HH
+
+#include "Cosa/Types.h"
+#if !defined(BOARD_ATTINY)
+#include "Cosa/OutputPin.hh"
+#include "Cosa/Interrupt.hh"
+
+/**
+ * USART hardware in Master SPI Mode (MSPIM).
+ */
+namespace USART {
+
+  /**
+   * Serial Peripheral Interface (SPI) bus master using an USART in
+   * Master SPI Mode. The transmitter is double buffered so that block
+   * transfers run at full clock rate. The USART data pins are used
+   * as MOSI (TXD) and MISO (RXD) and the clock pin (XCK) as SCK. The
+   * device driver interface is the same as Cosa/Soft/SPI.hh. This
+   * gives a second hardware SPI bus; e.g. for displays while a radio
+   * uses the primary SPI bus.
+   *
+   * @section Circuit
+   * @code
+   *                  ATmega328P    ATmega1284P      Mega2560
+   * USART            0             0       1        1      2      3
+   * (SCK)----------- D4/PD4        D0/PB0  D12/PD4  PD5    PH2    PJ2
+   * (MOSI)---------- D1/PD1        D9/PD1  D11/PD3  D18    D16    D14
+   * (MISO)---------- D0/PD0        D8/PD0  D10/PD2  D19    D17    D15
+   * @endcode
+   * The Mega2560 clock pins are not Arduino pins; use the port/bit
+   * pin number, e.g., (Board::DigitalPin) 45 for PD5. USART0 is
+   * normally used by the serial port (uart) on ATmega328P.
+   */
+  class SPI {
+  public:
+    /**
+     * Clock selectors. Value is the baud rate register setting;
+     * SCK = F_CPU / (2 * (UBRRn + 1)).
+     */
+    enum Clock {
+      DIV2_CLOCK = 0,		//!< Divide system clock by 2.
+      DIV4_CLOCK = 1,		//!< Divide system clock by 4.
+      DIV8_CLOCK = 3,		//!< Divide system clock by 8.
+      DIV16_CLOCK = 7,		//!< Divide system clock by 16.
+      DIV32_CLOCK = 15,		//!< Divide system clock by 32.
+      DIV64_CLOCK = 31,		//!< Divide system clock by 64.
+      DIV128_CLOCK = 63,	//!< Divide system clock by 128.
+      DEFAULT_CLOCK = DIV4_CLOCK //!< Default clock rate.
+    } __attribute__((packed));
+
+    /** Bit order selectors. */
+    enum Order {
+      MSB_ORDER = 0, 		//!< Most significant bit first.
+      LSB_ORDER = 1,		//!< Least significant bit first.
+      DEFAULT_ORDER = MSB_ORDER	//!< Default is MSB.
+    } __attribute__((packed));
+
+    /** Chip select mode. */
+    enum Pulse {
+      ACTIVE_LOW = 0,	   	//!< Active low logic during transaction.
+      ACTIVE_HIGH = 1,	   	//!< Active high logic during transaction.
+      PULSE_LOW = 2, 	   	//!< Pulse low on end of transaction.
+      PULSE_HIGH = 3,	   	//!< Pulse high on end of transaction.
+      DEFAULT_PULSE = ACTIVE_LOW //!< Default is low logic.
+    } __attribute__((packed));
+
+    /**
+     * SPI device driver abstract class. Holds SPI state to allow
+     * handling of several SPI devices with different clock, mode and/or
+     * bit order.
+     */
+    class Driver {
+      friend class SPI;
+    public:
+      /**
+       * Construct SPI Device driver with given chip select pin, pulse,
+       * clock, mode, and bit order. Drivers with interrupt handler
+       * should be attached to the bus (see SPI::attach()).
+       * @param[in] cs chip select pin.
+       * @param[in] pulse chip select pulse mode (default ACTIVE_LOW).
+       * @param[in] clock SPI hardware setting (default DIV4_CLOCK).
+       * @param[in] mode SPI mode for phase and transition (0..3, default 0).
+       * @param[in] order bit order (default MSB_ORDER).
+       * @param[in] irq interrupt handler (default null).
+       */
+      Driver(Board::DigitalPin cs,
+	     Pulse pulse = DEFAULT_PULSE,
+	     Clock clock = DEFAULT_CLOCK,
+	     uint8_t mode = 0,
+	     Order order = MSB_ORDER,
+	     Interrupt::Handler* irq = NULL);
+
+      /**
+       * Calculate SPI clock rate (scale factor) for given frequency.
+       * @param[in] freq device max frequency (in Hz).
+       * @return clock rate.
+       */
+      static Clock clock(uint32_t freq)
+	__attribute__((always_inline))
+      {
+	if (freq >= (F_CPU / 2)) return (SPI::DIV2_CLOCK);
+	if (freq >= (F_CPU / 4)) return (SPI::DIV4_CLOCK);
+	if (freq >= (F_CPU / 8)) return (SPI::DIV8_CLOCK);
+	if (freq >= (F_CPU / 16)) return (SPI::DIV16_CLOCK);
+	if (freq >= (F_CPU / 32)) return (SPI::DIV32_CLOCK);
+	if (freq >= (F_CPU / 64)) return (SPI::DIV64_CLOCK);
+	return (SPI::DIV128_CLOCK);
+      }
+
+      /**
+       * Calculate SPI clock rate (scale factor) for given clock
+       * cycle time in nano seconds.
+       * @param[in] ns min device clock cycle time.
+       * @return clock rate.
+       */
+      static Clock cycle(uint16_t ns)
+	__attribute__((always_inline))
+      {
+	if (ns <= (1000000L / (F_CPU/2000L))) return (SPI::DIV2_CLOCK);
+	if (ns <= (1000000L / (F_CPU/4000L))) return (SPI::DIV4_CLOCK);
+	if (ns <= (1000000L / (F_CPU/8000L))) return (SPI::DIV8_CLOCK);
+	if (ns <= (1000000L / (F_CPU/16000L))) return (SPI::DIV16_CLOCK);
+	if (ns <= (1000000L / (F_CPU/32000L))) return (SPI::DIV32_CLOCK);
+	if (ns <= (1000000L / (F_CPU/64000L))) return (SPI::DIV64_CLOCK);
+	return (SPI::DIV128_CLOCK);
+      }
+
+      /**
+       * Set SPI master clock rate.
+       * @param[in] clock rate.
+       */
+      void set_clock(Clock rate)
+      {
+	m_ubrr = rate;
+      }
+
+      /**
+       * Set SPI master clock frequency. The baud rate register allows
+       * any even divisor of the system clock.
+       * @param[in] freq device max frequency (in Hz).
+       */
+      void set_clock(uint32_t freq)
+      {
+	uint32_t div = (F_CPU / 2 + freq - 1) / freq;
+	m_ubrr = (div > 4096) ? 4095 : (div == 0) ? 0 : div - 1;
+      }
+
+    protected:
+      Driver* m_next;		//!< List of drivers.
+      Interrupt::Handler* m_irq;//!< Interrupt handler.
+      OutputPin m_cs;		//!< Device chip select pin.
+      Pulse m_pulse;		//!< Chip select pulse mode.
+      uint8_t m_ucsrc;		//!< Control register (mode and order).
+      uint16_t m_ubrr;		//!< Baud rate register (clock).
+    };
+
+  public:
+    /**
+     * Construct USART Master SPI Mode bus on given serial port and
+     * clock pin.
+     * @param[in] port serial port number (0..3).
+     * @param[in] sck clock pin (XCK of the port).
+     */
+    SPI(uint8_t port, Board::DigitalPin sck) :
+      m_list(NULL),
+      m_busy(false),
+      m_dev(NULL),
+      m_sfr(SFR(port)),
+      m_sck(sck, 0)
+    {}
+
+    /**
+     * Attach given SPI device driver context. Interrupt sources of
+     * attached drivers are disabled during transactions.
+     * @param[in] dev device driver context.
+     * @return true(1) if successful otherwise false(0)
+     */
+    bool attach(Driver* dev);
+
+    /**
+     * Acquire the SPI device driver. Set the USART in Master SPI Mode
+     * with the clock, mode and bit order of the device driver, and
+     * disable SPI interrupt sources. The function will yield until
+     * the device driver has been acquired. Used in the same format
+     * as Cosa/SPI.hh:
+     * @code
+     * spi.acquire(this)
+     *   spi.begin();
+     *     res = spi.transfer(data);
+     *   spi.end();
+     * spi.release();
+     * @endcode
+     * @param[in] dev device driver context.
+     */
+    void acquire(Driver* dev);
+
+    /**
+     * Release the SPI device driver. Enable SPI interrupt sources.
+     */
+    void release();
+
+    /**
+     * Mark the beginning of a transfer block. Select the device by
+     * asserting the chip select pin according to the pulse pattern.
+     */
+    void begin()
+      __attribute__((always_inline))
+    {
+      if (m_dev->m_pulse < PULSE_LOW) m_dev->m_cs.toggle();
+    }
+
+    /**
+     * Mark the end of a transfer block. Deselect the device chip
+     * according to the pulse pattern.
+     */
+    void end()
+      __attribute__((always_inline))
+    {
+      m_dev->m_cs.toggle();
+      if (m_dev->m_pulse > ACTIVE_HIGH) m_dev->m_cs.toggle();
+    }
+
+    /**
+     * Start exchange data with slave. Should only be used within a SPI
+     * transaction; begin()-end() block.
+     * @param[in] data to send.
+     */
+    void transfer_start(uint8_t data)
+      __attribute__((always_inline))
+    {
+      while ((*UCSRnA() & _BV(UDRE0)) == 0)
+	;
+      *UDRn() = data;
+    }
+
+    /**
+     * Wait for exchange with slave. Should only be used within a SPI
+     * transaction; begin()-end() block. Return received value.
+     * @return value received.
+     */
+    uint8_t transfer_await()
+      __attribute__((always_inline))
+    {
+      while ((*UCSRnA() & _BV(RXC0)) == 0)
+	;
+      return (*UDRn());
+    }
+
+    /**
+     * Next data to exchange with slave. Should only be used within a SPI
+     * transaction; begin()-end() block. The next data is written to
+     * the transmit buffer before the previous data has been received.
+     * @param[in] data to send.
+     * @return value received.
+     */
+    uint8_t transfer_next(uint8_t data)
+      __attribute__((always_inline))
+    {
+      transfer_start(data);
+      return (transfer_await());
+    }
+
+    /**
+     * Exchange data with slave. Slave select must be done before exchange
+     * of data.
+     * @param[in] data to send.
+     * @return value received.
+     */
+    uint8_t transfer(uint8_t data)
+      __attribute__((always_inline))
+    {
+      transfer_start(data);
+      return (transfer_await());
+    }
+
+    /**
+     * Exchange package with slave. Received data from slave is stored
+     * in given buffer. Should only be used within a SPI transfer;
+     * begin()-end() block.
+     * @param[in] buf with data to transfer (send/receive).
+     * @param[in] count size of buffer.
+     */
+    void transfer(void* buf, size_t count)
+    {
+      transfer(buf, buf, count);
+    }
+
+    /**
+     * Exchange package with slave. Received data from slave is stored
+     * in given destination buffer. Should only be used within a SPI
+     * transfer; begin()-end() block.
+     * @param[in] dst destination buffer for received data.
+     * @param[in] src source buffer with data to send.
+     * @param[in] count size of buffers.
+     */
+    void transfer(void* dst, const void* src, size_t count);
+
+    /**
+     * Read package from the device slave. Should only be used within a
+     * SPI transfer; begin()-end() block.
+     * @param[in] buf buffer for read data.
+     * @param[in] count number of bytes to read.
+     */
+    void read(void* buf, size_t count);
+
+    /**
+     * Write package to the device slave. Should only be used within a
+     * SPI transaction; begin()-end() block.
+     * @param[in] buf buffer with data to write.
+     * @param[in] count number of bytes to write.
+     */
+    void write(const void* buf, size_t count);
+
+    /**
+     * Write package to the device slave. Should only be used within a
+     * SPI transaction; begin()-end() block.
+     * @param[in] buf buffer with data to write.
+     * @param[in] count number of bytes to write.
+     */
+    void write_P(const uint8_t* buf, size_t count);
+
+    /**
+     * Write null terminated io buffer vector to the device slave.
+     * Should only be used  within a SPI transfer; begin()-end() block.
+     * @param[in] vec null terminated io buffer vector pointer.
+     */
+    void write(const iovec_t* vec)
+      __attribute__((always_inline))
+    {
+      for (const iovec_t* vp = vec; vp->buf != NULL; vp++)
+	write(vp->buf, vp->size);
+    }
+
+  private:
+    Driver* m_list;		//!< Attached devices interrupt disable/enable.
+    volatile bool m_busy;	//!< SPI resource is busy.
+    Driver* m_dev;		//!< Current device using the bus.
+    volatile uint8_t* const m_sfr; //!< USART Special Function Registers.
+    OutputPin m_sck;		//!< Serial Clock pin (XCK).
+
+    /**
+     * Return USART Register for given serial port.
+     * @param[in] port number.
+     * @return USART register pointer.
+     */
+    static volatile uint8_t* SFR(uint8_t port)
+      __attribute__((always_inline))
+    {
+#if defined(UCSR3A)
+      if (port == 3) return (&UCSR3A);
+#endif
+#if defined(UCSR2A)
+      if (port == 2) return (&UCSR2A);
+#endif
+#if defined(UCSR1A)
+      if (port == 1) return (&UCSR1A);
+#endif
+#if defined(UCSR0A)
+      UNUSED(port);
+      return (&UCSR0A);
+#else
+      UNUSED(port);
+      return (&UCSR1A);
+#endif
+    }
+
+    /**
+     * Return pointer to USART Control and Status Register A (UCSRnA).
+     * @return UCSRnA register pointer.
+     */
+    volatile uint8_t* UCSRnA() const
+    {
+      return (m_sfr);
+    }
+
+    /**
+     * Return pointer to USART Control and Status Register B (UCSRnB).
+     * @return UCSRnB register pointer.
+     */
+    volatile uint8_t* UCSRnB() const
+    {
+      return (m_sfr + 1);
+    }
+
+    /**
+     * Return pointer to USART Control and Status Register C (UCSRnC).
+     * @return UCSRnC register pointer.
+     */
+    volatile uint8_t* UCSRnC() const
+    {
+      return (m_sfr + 2);
+    }
+
+    /**
+     * Return pointer to USART Baud Rate Register (UBRRn).
+     * @return UBRRn register pointer.
+     */
+    volatile uint16_t* UBRRn() const
+    {
+      return ((volatile uint16_t*) (m_sfr + 4));
+    }
+
+    /**
+     * Return pointer to USART I/O Data Register (UDRn).
+     * @return UDRn register pointer.
+     */
+    volatile uint8_t* UDRn() const
+    {
+      return (m_sfr + 6);
+    }
+  };
+};
+#endif
+#endif
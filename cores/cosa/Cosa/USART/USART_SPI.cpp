@@ -0,0 +1,153 @@
+/**
+ * @file Cosa/USART/USART_SPI.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/USART/SPI.hh"
+#if !defined(BOARD_ATTINY)
+
+using namespace USART;
+
+// Master SPI Mode control register (UCSRnC) bits
+#define UMSEL (_BV(7) | _BV(6))
+#define UDORD _BV(2)
+#define UCPHA _BV(1)
+#define UCPOL _BV(0)
+
+SPI::Driver::Driver(Board::DigitalPin cs,
+		    Pulse pulse,
+		    Clock clock,
+		    uint8_t mode,
+		    Order order,
+		    Interrupt::Handler* irq) :
+  m_next(NULL),
+  m_irq(irq),
+  m_cs(cs, (pulse == 0)),
+  m_pulse(pulse),
+  m_ucsrc(UMSEL),
+  m_ubrr(clock)
+{
+  if (order == LSB_ORDER) m_ucsrc |= UDORD;
+  if (mode & 0x01) m_ucsrc |= UCPHA;
+  if (mode & 0x02) m_ucsrc |= UCPOL;
+}
+
+bool
+SPI::attach(Driver* dev)
+{
+  if (dev->m_next != NULL) return (false);
+  dev->m_next = m_list;
+  m_list = dev;
+  return (true);
+}
+
+void
+SPI::acquire(Driver* dev)
+{
+  // Acquire the device driver. Wait if busy. Synchronized update
+  uint8_t key = lock();
+  while (UNLIKELY(m_busy)) {
+    unlock(key);
+    yield();
+    key = lock();
+  }
+  // Set current device and mark as busy
+  m_busy = true;
+  m_dev = dev;
+  // Disable all interrupt sources on SPI bus
+  for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
+    if (dev->m_irq != NULL) dev->m_irq->disable();
+  unlock(key);
+
+  // Set clock polarity before enabling Master SPI Mode. The baud rate
+  // must be zero when the transmitter is enabled
+  m_sck.write(dev->m_ucsrc & UCPOL);
+  *UBRRn() = 0;
+  *UCSRnC() = dev->m_ucsrc;
+  *UCSRnB() = _BV(RXEN0) | _BV(TXEN0);
+  *UBRRn() = dev->m_ubrr;
+}
+
+void
+SPI::release()
+{
+  // Lock the device driver update
+  uint8_t key = lock();
+  // Release the device driver
+  m_busy = false;
+  m_dev = NULL;
+  // Enable all interrupt sources on SPI bus
+  for (SPI::Driver* dev = m_list; dev != NULL; dev = dev->m_next)
+    if (dev->m_irq != NULL) dev->m_irq->enable();
+  unlock(key);
+}
+
+void
+SPI::transfer(void* dst, const void* src, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  uint8_t* dp = (uint8_t*) dst;
+  const uint8_t* sp = (const uint8_t*) src;
+
+  // Keep the transmit buffer filled; receive the previous data
+  *UDRn() = *sp++;
+  while (--count) {
+    transfer_start(*sp++);
+    *dp++ = transfer_await();
+  }
+  *dp = transfer_await();
+}
+
+void
+SPI::read(void* buf, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  uint8_t* bp = (uint8_t*) buf;
+  *UDRn() = 0x00;
+  while (--count) {
+    transfer_start(0x00);
+    *bp++ = transfer_await();
+  }
+  *bp = transfer_await();
+}
+
+void
+SPI::write(const void* buf, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  const uint8_t* bp = (const uint8_t*) buf;
+  *UDRn() = *bp++;
+  while (--count) {
+    transfer_start(*bp++);
+    transfer_await();
+  }
+  transfer_await();
+}
+
+void
+SPI::write_P(const uint8_t* buf, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  *UDRn() = pgm_read_byte(buf++);
+  while (--count) {
+    transfer_start(pgm_read_byte(buf++));
+    transfer_await();
+  }
+  transfer_await();
+}
+#endif
@@ -300,6 +300,10 @@ USB_SendSpace(uint8_t ep)
   return (64 - FifoByteCount());
 }
 
+// Endpoints where the last released bank was a full packet. A zero
+// length packet is sent on flush to terminate the bulk transfer
+static uint8_t s_zlp = 0;
+
 int
 USB_Send(uint8_t ep, const void* d, int len)
 {
@@ -307,12 +311,15 @@ USB_Send(uint8_t ep, const void* d, int len)
 
   int res = len;
   const uint8_t* data = (const uint8_t*)d;
-  uint8_t timeout = 250;
+  const uint8_t mask = _BV(ep & 7);
+  uint16_t timeout = 25000;
   while (len) {
+    // Poll for a free bank; the double bank is released by the host
+    // within a frame (approx. 250 ms timeout)
     uint8_t n = USB_SendSpace(ep);
     if (n == 0) {
       if (!(--timeout)) return (-1);
-      delay(1);
+      DELAY(10);
       continue;
     }
     if (n > len) n = len;
@@ -329,8 +336,14 @@ USB_Send(uint8_t ep, const void* d, int len)
       else {
 	while (n--) Send8(*data++);
       }
-      if (!ReadWriteAllowed() || ((len == 0) && (ep & TRANSFER_RELEASE)))
+      if (!ReadWriteAllowed()) {
+	s_zlp |= mask;
 	ReleaseTX();
+      }
+      else {
+	s_zlp &= ~mask;
+	if ((len == 0) && (ep & TRANSFER_RELEASE)) ReleaseTX();
+      }
     }
   }
   TX_LED_ON;
@@ -589,9 +602,14 @@ USB_Keepalive(void)
 void
 USB_Flush(uint8_t ep)
 {
-  SetEP(ep);
-  if (FifoByteCount())
+  // Release partial bank (short packet), or send a zero length packet
+  // if the last packet was full to terminate the transfer
+  LockEP lock(ep);
+  const uint8_t mask = _BV(ep & 7);
+  if (FifoByteCount() || ((s_zlp & mask) && ReadWriteAllowed())) {
+    s_zlp &= ~mask;
     ReleaseTX();
+  }
 }
 
 ISR(USB_GEN_vect)
@@ -33,6 +33,12 @@
  * Note: The internal pullup resistors on the USI pins are active.
  * External pullup resistors (4K7 ohm) are required for longer
  * wires and/or higher loads.
+ *
+ * Master requests from drivers in asynchronous mode (see
+ * Driver::async_request()) return directly after the address
+ * phase. The data bytes are transfered one per event and the driver
+ * completion callback is called when done, i.e., the event loop
+ * continues to run between bytes.
  */
 class TWI {
 public:
@@ -258,7 +264,7 @@ public:
 
 private:
   /**
-   * USI TWI slave states.
+   * USI TWI slave and asynchronous master states.
    */
   enum State {
     // Idle, waiting for start condition
@@ -273,7 +279,10 @@ private:
     WRITE_REQUEST,
     WRITE_COMPLETED,
     // Slave service state (Response to write)
-    SERVICE_REQUEST
+    SERVICE_REQUEST,
+    // Master asynchronous request states (read or write operation)
+    MASTER_READ,
+    MASTER_WRITE
   } __attribute__((packed));
 
   /**
@@ -327,6 +336,26 @@ private:
   volatile int m_count;
   Driver* m_dev;
   volatile bool m_busy;
+  uint8_t m_ix;
+
+  /**
+   * Asynchronous master request handler. Transfers one byte per
+   * event so that other events (timers, pins, etc) are dispatched
+   * between bytes. The bus clock is stretched (SCL held low) while
+   * waiting for the next byte.
+   */
+  class Master : public Event::Handler {
+  public:
+    /**
+     * @override{Event::Handler}
+     * Transfer the next byte of the current request. Issue stop
+     * condition and completion callback when done.
+     * @param[in] type the event type.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+  };
+  Master m_master;
 
   /**
    * Get current driver state.
@@ -435,6 +464,23 @@ private:
    */
   int request(uint8_t op);
 
+  /**
+   * Transfer the next byte of the current master request, with
+   * acknowledge. Return true(1) if there are more bytes to transfer
+   * otherwise false(0); end of buffers or nack.
+   * @return bool
+   */
+  bool step();
+
+  /**
+   * Complete the current master request; generate stop condition.
+   * In asynchronous mode the driver completion callback is called
+   * and the bus is released. Return number of bytes transfered or
+   * negative error code.
+   * @return number of bytes or negative error code.
+   */
+  int complete();
+
   /** Allow access. */
   friend void ::USI_START_vect(void);
   friend void ::USI_OVF_vect(void);
@@ -173,7 +173,9 @@ TWI::TWI() :
   m_last(0),
   m_count(0),
   m_dev(0),
-  m_busy(false)
+  m_busy(false),
+  m_ix(0),
+  m_master()
 {
   for (uint8_t ix = 0; ix < VEC_MAX; ix++) {
     m_vec[ix].buf = 0;
@@ -247,40 +249,96 @@ int
 TWI::request(uint8_t op)
 {
   bool is_read = (op & READ_OP);
-  uint8_t* next = (uint8_t*) m_vec[0].buf;
-  uint8_t* last = next + m_vec[0].size;
-  int count = 0;
+
+  // Setup the first buffer and state
+  m_ix = 0;
+  m_next = (uint8_t*) m_vec[0].buf;
+  m_last = m_next + m_vec[0].size;
+  m_count = 0;
+  state(is_read ? MASTER_READ : MASTER_WRITE);
 
   // Send start condition and write address
-  if (!start()) return (EFAULT);
+  if (!start()) {
+    m_count = EFAULT;
+    return (complete());
+  }
   m_scl.clear();
   transfer(m_dev->m_addr | is_read);
   mode(IOPin::INPUT_MODE);
-  if (transfer(0, 1)) goto nack;
-
-  // Read or write data
-  for (uint8_t ix = 1; next != 0; ix++) {
-    while (next != last) {
-      count += 1;
-      if (is_read) {
-	mode(IOPin::INPUT_MODE);
-	*next++ = transfer(0);
-	transfer((next != last) ? 0x00 : 0xff, 1);
-      }
-      else {
-	m_scl.clear();
-	transfer(*next++);
-	mode(IOPin::INPUT_MODE);
-	if (transfer(0, 1)) goto nack;
-      }
+  if (transfer(0, 1)) return (complete());
+
+  // Asynchronous mode; transfer bytes from the event handler
+  if (m_dev->is_async()) {
+    Event::push(Event::SERVICE_REQUEST_TYPE, &m_master);
+    return (0);
+  }
+
+  // Synchronous mode; read or write data
+  while (step())
+    ;
+  return (complete());
+}
+
+bool
+TWI::step()
+{
+  // Advance to the next buffer in the io vector
+  while (m_next == m_last) {
+    if (++m_ix == VEC_MAX) return (false);
+    m_next = (uint8_t*) m_vec[m_ix].buf;
+    if (m_next == NULL) return (false);
+    m_last = m_next + m_vec[m_ix].size;
+  }
+
+  // Read or write data with acknowledge
+  m_count += 1;
+  if (state() == MASTER_READ) {
+    mode(IOPin::INPUT_MODE);
+    *m_next++ = transfer(0);
+    transfer((m_next != m_last) ? 0x00 : 0xff, 1);
+  }
+  else {
+    m_scl.clear();
+    transfer(*m_next++);
+    mode(IOPin::INPUT_MODE);
+    if (transfer(0, 1)) return (false);
+  }
+  return (true);
+}
+
+int
+TWI::complete()
+{
+  // Generate stop condition. Check for error
+  if (!stop()) m_count = EFAULT;
+  uint8_t type = (state() == MASTER_READ) ?
+    Event::READ_COMPLETED_TYPE :
+    Event::WRITE_COMPLETED_TYPE;
+  state(IDLE);
+  int res = m_count;
+
+  // Check for asynchronous mode; call completion callback and release
+  if (m_dev->is_async()) {
+    m_dev->on_completion(res < 0 ? Event::ERROR_TYPE : type, res);
+    synchronized {
+      m_dev = NULL;
+      m_busy = false;
+      USICR = 0;
     }
-    next = (uint8_t*) m_vec[ix].buf;
-    last = next + m_vec[ix].size;
+    powerdown();
   }
+  return (res);
+}
 
- nack:
-  if (!stop()) return (EFAULT);
-  return (count);
+void
+TWI::Master::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(type);
+  UNUSED(value);
+  if (twi.step())
+    Event::push(Event::SERVICE_REQUEST_TYPE, this);
+  else
+    twi.complete();
 }
 
 void
@@ -19,17 +19,28 @@
  */
 
 #include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
 #include "Cosa/Math.hh"
 #include "Cosa/Power.hh"
 #include "Cosa/Bits.h"
+#include "Cosa/Probe.hh"
 
 // Initated flag
 bool Watchdog::s_initiated = false;
 
+// Tickless mode flag and delay deadline
+bool Watchdog::s_tickless = false;
+bool Watchdog::s_delay = false;
+uint32_t Watchdog::s_deadline = 0L;
+
 // Milli-seconds counter and number of ms per tick
 uint32_t Watchdog::s_millis = 0L;
 uint16_t Watchdog::s_ms_per_tick = 16;
 
+// Calibration scale and milli-seconds fraction
+uint16_t Watchdog::s_scale = Watchdog::SCALE_ONE;
+uint16_t Watchdog::s_fraction = 0;
+
 // Watchdog Job Scheduler (milli-seconds level delayed functions)
 Watchdog::Scheduler* Watchdog::s_scheduler = NULL;
 
@@ -46,41 +57,154 @@ Watchdog::as_prescale(uint16_t ms)
 }
 
 void
-Watchdog::begin(uint16_t ms)
+Watchdog::set_prescale(uint8_t prescale)
 {
-  // Map milli-seconds to watchdog prescale values
-  uint8_t prescale = as_prescale(ms);
-
   // Create new watchdog configuration
   uint8_t config = _BV(WDIE) | (prescale & 0x07);
   if (prescale > 0x07) config |= _BV(WDP3);
 
   // Update the watchdog registers
-  synchronized {
-    wdt_reset();
-    bit_clear(MCUSR, WDRF);
-    WDTCSR = _BV(WDCE) | _BV(WDE);
-    WDTCSR = config;
-  }
+  wdt_reset();
+  bit_clear(MCUSR, WDRF);
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = config;
+  s_ms_per_tick = (1 << (prescale + 4));
+}
+
+void
+Watchdog::begin(uint16_t ms)
+{
+  // Map milli-seconds to watchdog prescale values
+  uint8_t prescale = as_prescale(ms);
+  synchronized set_prescale(prescale);
 
   // Mark as initiated and set watchdog delay as global delay
-  s_ms_per_tick = (1 << (prescale + 4));
   ::delay = Watchdog::delay;
   s_initiated = true;
 }
 
+void
+Watchdog::tickless(bool flag)
+{
+  synchronized {
+    s_tickless = flag;
+    if (s_initiated) {
+      if (flag)
+	reschedule();
+      else
+	set_prescale(0);
+    }
+  }
+}
+
+void
+Watchdog::reschedule()
+{
+  // Time until the next job, alarm or delay deadline (max 8 s)
+  int32_t ms = 8192;
+  if (s_scheduler != NULL) {
+    int32_t res = s_scheduler->expire_after();
+    if (res < ms) ms = res;
+  }
+  if (s_clock != NULL) {
+    int32_t res = s_clock->expire_after_ms();
+    if (res < ms) ms = res;
+  }
+  if (s_delay) {
+    int32_t res = s_deadline - s_millis;
+    if (res < ms) ms = res;
+  }
+
+  // Map to nominal (uncalibrated) watchdog period
+  if ((s_scale != SCALE_ONE) && (ms > 0))
+    ms = ((uint32_t) ms * SCALE_ONE) / s_scale;
+
+  // Select the largest period that does not overshoot
+  uint8_t prescale = 0;
+  if (ms >= 32) prescale = log2<uint16_t>(ms >> 4) - 1;
+  if (UNLIKELY(prescale > 9)) prescale = 9;
+  if (prescale != as_prescale(s_ms_per_tick)) set_prescale(prescale);
+}
+
+void
+Watchdog::adjust(int32_t ms)
+{
+  synchronized {
+    if (ms < (int32_t) s_ms_per_tick) reschedule();
+  }
+}
+
+uint16_t
+Watchdog::calibrate(uint16_t ms)
+{
+  if (UNLIKELY(!s_initiated)) return (s_scale);
+  if (ms < 16) ms = 16;
+  if (ms > 2048) ms = 2048;
+
+  // Start the real-time timer as reference if needed
+  void (*saved)(uint32_t ms) = ::delay;
+  bool started = RTT::begin();
+
+  // Use the shortest watchdog period during the measurement
+  bool tickless = s_tickless;
+  uint8_t prescale = as_prescale(s_ms_per_tick);
+  synchronized {
+    s_tickless = false;
+    set_prescale(0);
+  }
+
+  // Measure the given number of watchdog timeouts
+  uint16_t ticks = ms / 16;
+  uint32_t last = millis();
+  while (millis() == last) yield();
+  uint32_t start = RTT::micros();
+  for (uint16_t n = ticks; n != 0; n--) {
+    last = millis();
+    while (millis() == last) yield();
+  }
+  uint32_t us = RTT::micros() - start;
+  uint16_t scale = (us << 10) / (ticks * 16000UL);
+
+  // Restore watchdog period, timer and delay function
+  synchronized {
+    s_scale = scale;
+    set_prescale(prescale);
+    s_tickless = tickless;
+  }
+  if (started) RTT::end();
+  ::delay = saved;
+  return (scale);
+}
+
 void
 Watchdog::delay(uint32_t ms)
 {
   uint32_t start = Watchdog::millis();
+  if (s_tickless) {
+    synchronized {
+      s_deadline = start + ms;
+      s_delay = true;
+    }
+    adjust(ms);
+    while (since(start) < ms) yield();
+    s_delay = false;
+    return;
+  }
   ms += s_ms_per_tick / 2;
   while (since(start) < ms) yield();
 }
 
+ISR_PROBE_DEFINE(wdt_isr_probe, "isr:WDT");
+
 ISR(WDT_vect)
 {
-  // Increment milli-seconds counter
-  Watchdog::s_millis += Watchdog::s_ms_per_tick;
+  ISR_PROBE(wdt_isr_probe);
+  // Increment milli-seconds counter with the calibrated period
+  uint32_t ms = (uint32_t) Watchdog::s_ms_per_tick * Watchdog::s_scale
+    + Watchdog::s_fraction;
+  Watchdog::s_fraction = ms & (Watchdog::SCALE_ONE - 1);
+  ms >>= 10;
+  Watchdog::s_millis += ms;
 
   // Run all expired jobs
   if (Watchdog::s_scheduler != NULL)
@@ -88,5 +212,8 @@ ISR(WDT_vect)
 
   // Increment the clock and run expired alarms
   if (Watchdog::s_clock != NULL)
-    Watchdog::s_clock->tick(Watchdog::s_ms_per_tick);
+    Watchdog::s_clock->tick(ms);
+
+  // Select the next watchdog period in tickless mode
+  if (Watchdog::s_tickless) Watchdog::reschedule();
 }
@@ -30,7 +30,15 @@
 /**
  * The Watchdog is used as a low power timer for periodical events
  * and delay. Please note that the accuracy is only 1-10% if not
- * calibrated (typical drift is 16-32 ms per second).
+ * calibrated (typical drift is 16-32 ms per second). In tickless
+ * mode the watchdog period is selected after each timeout; the
+ * largest period (16 ms to 8 s) that does not overshoot the next
+ * job, alarm or delay. The milli-seconds counter is incremented with
+ * the period of each timeout. The watchdog oscillator may be
+ * calibrated at run-time against the real-time timer (RTT) with
+ * calibrate(); the correction is applied to the milli-seconds counter
+ * (time base for the Watchdog Scheduler and Clock) and to the period
+ * selection in tickless mode.
  */
 class Watchdog {
 public:
@@ -83,6 +91,61 @@ public:
    */
   static void begin(uint16_t ms = 16);
 
+  /**
+   * Enable/disable tickless mode; variable watchdog period. When
+   * disabled the period given to begin() is used.
+   * @param[in] flag enable/disable.
+   * @note atomic.
+   */
+  static void tickless(bool flag);
+
+  /**
+   * Returns true(1) if in tickless mode otherwise false(0).
+   * @return bool.
+   */
+  static bool is_tickless()
+  {
+    return (s_tickless);
+  }
+
+  /** Calibration scale for no correction (fixed point 1.0). */
+  static const uint16_t SCALE_ONE = 1024;
+
+  /**
+   * Measure the watchdog period against the real-time timer (RTT)
+   * for the given number of milli-seconds and set the calibration
+   * scale. The RTT is started during the measurement if not already
+   * running. Should be called from the main loop; may be called
+   * periodically to track temperature and supply voltage drift.
+   * Returns the new calibration scale.
+   * @param[in] ms measurement time in milli-seconds (16..2048,
+   * default 512).
+   * @return calibration scale.
+   */
+  static uint16_t calibrate(uint16_t ms = 512);
+
+  /**
+   * Set the calibration scale; actual period per nominal period in
+   * fixed point (SCALE_ONE for 1.0). May be used to restore a stored
+   * calibration or with an external reference, e.g. RTC 1 Hz output;
+   * scale = SCALE_ONE * reference-ms / watchdog-ms.
+   * @param[in] scale calibration.
+   * @note atomic.
+   */
+  static void calibration(uint16_t scale)
+  {
+    synchronized s_scale = scale;
+  }
+
+  /**
+   * Get the calibration scale.
+   * @return calibration.
+   */
+  static uint16_t calibration()
+  {
+    return (s_scale);
+  }
+
   /**
    * Delay using watchdog timeouts and sleep mode. Timeouts will be
    * the nearest watchdog tick.
@@ -137,6 +200,22 @@ public:
       Watchdog::s_scheduler = this;
     }
 
+    /**
+     * @override{Job::Scheduler}
+     * Start given job. In tickless mode the watchdog period is
+     * shortened if the job group deadline is before the current
+     * period.
+     * Returns true(1) if successful otherwise false(0).
+     * @param[in] job to start.
+     * @return bool.
+     */
+    virtual bool start(Job* job)
+    {
+      if (!Job::Scheduler::start(job)) return (false);
+      if (Watchdog::s_tickless) Watchdog::adjust(expire_after());
+      return (true);
+    }
+
     /**
      * @override{Job::Scheduler}
      * Return current watchdog time in milli-seconds.
@@ -182,6 +261,18 @@ public:
     {
       Watchdog::s_clock = this;
     }
+
+    /**
+     * Return number of milli-seconds until the first alarm expires
+     * (max 10 seconds).
+     * @return milli-seconds.
+     */
+    int32_t expire_after_ms()
+    {
+      int32_t res = expire_after();
+      if (res > 10) return (10000L);
+      return (res * 1000L - m_msec);
+    }
   };
 
   /**
@@ -205,8 +296,13 @@ public:
 
 private:
   static bool s_initiated;		//!< Initiated flag.
+  static bool s_tickless;		//!< Tickless mode flag.
+  static bool s_delay;			//!< Delay in progress.
+  static uint32_t s_deadline;		//!< Delay deadline.
   static uint32_t s_millis;		//!< Milli-seconds counter.
   static uint16_t s_ms_per_tick;	//!< Number of milli-seconds per tick.
+  static uint16_t s_scale;		//!< Calibration scale.
+  static uint16_t s_fraction;		//!< Calibrated milli-seconds fraction.
   static Event::Handler* s_handler;	//!< Watchdog timeout event handler.
   static Scheduler* s_scheduler;	//!< Watchdog Job Scheduler.
   static Clock* s_clock;		//!< Watchdog Clock.
@@ -223,6 +319,29 @@ private:
    */
   static uint8_t as_prescale(uint16_t ms);
 
+  /**
+   * Set watchdog prescale and restart the watchdog period. Should be
+   * called with interrupts disabled.
+   * @param[in] prescale factor.
+   */
+  static void set_prescale(uint8_t prescale);
+
+  /**
+   * Tickless mode; select the largest watchdog period that does not
+   * overshoot the next job, alarm or delay. Called from the interrupt
+   * service routine after each timeout.
+   */
+  static void reschedule();
+
+  /**
+   * Tickless mode; shorten the current watchdog period if the given
+   * time (milli-seconds from the latest timeout) is before the end of
+   * the period. The elapsed part of the current period is lost.
+   * @param[in] ms milli-seconds from the latest timeout.
+   * @note atomic.
+   */
+  static void adjust(int32_t ms);
+
   /** Interrupt Service Routine. */
   friend void WDT_vect(void);
 };
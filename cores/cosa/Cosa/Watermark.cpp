@@ -0,0 +1,81 @@
+/**
+ * @file Cosa/Watermark.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Watermark.hh"
+
+// Paint free memory from end of static data to the stack pointer.
+// Executed in the startup code after the stack pointer setup and
+// before data initialization and constructors; register variables
+// only
+static void paint() __attribute__((naked, used, section(".init3")));
+static void paint()
+{
+  extern uint8_t _end;
+  uint8_t* dp = &_end;
+  while (dp <= (uint8_t*) SP) *dp++ = Watermark::PAINT;
+}
+
+int Watermark::s_collision = 0;
+
+Watermark::Watermark(Job::Scheduler* scheduler,
+		     uint32_t period,
+		     uint8_t chunk) :
+  Periodic(scheduler, period),
+  m_chunk(chunk),
+  m_reported(false),
+  m_stack_low((uint8_t*) RAMEND),
+  m_pos(NULL),
+  m_low_water(UINT16_MAX)
+{
+}
+
+void
+Watermark::run()
+{
+  // Report first stack near-collision
+  if (UNLIKELY(s_collision != 0 && !m_reported)) {
+    m_reported = true;
+    on_collision(s_collision);
+  }
+
+  // Scan next chunk; the heap may have grown into the painted area
+  uint8_t* top = heap_top();
+  if (m_pos < top) m_pos = top;
+  uint8_t* end = m_pos + m_chunk;
+  if (end > m_stack_low) end = m_stack_low;
+  while (m_pos < end && *m_pos == PAINT) m_pos++;
+  if (m_pos < m_stack_low && *m_pos == PAINT) return;
+
+  // Scan completed; lowest written stack address or unchanged
+  if (m_pos < m_stack_low) m_stack_low = m_pos;
+  uint16_t free = (m_stack_low > top) ? m_stack_low - top : 0;
+  if (free < m_low_water) m_low_water = free;
+  m_pos = top;
+  on_report(m_low_water);
+}
+
+IOStream& operator<<(IOStream& outs, Watermark& monitor)
+{
+  outs << PSTR("low_water=") << monitor.low_water()
+       << PSTR(",stack_max=") << monitor.stack_max()
+       << PSTR(",heap_top=") << (void*) Watermark::heap_top();
+  if (Watermark::is_collision()) outs << PSTR(",collision");
+  return (outs);
+}
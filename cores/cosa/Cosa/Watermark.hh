@@ -0,0 +1,195 @@
+/**
+ * @file Cosa/Watermark.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_WATERMARK_HH
+#define COSA_WATERMARK_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Memory.h"
+#include "Cosa/Periodic.hh"
+#include "Cosa/IOStream.hh"
+
+/**
+ * Default stack guard margin in bytes when COSA_STACK_GUARD is
+ * defined without value.
+ */
+#if defined(COSA_STACK_GUARD)
+# if (COSA_STACK_GUARD + 0) == 0
+#   undef COSA_STACK_GUARD
+#   define COSA_STACK_GUARD 64
+# endif
+#endif
+
+/**
+ * Stack and heap low-water mark monitor. The free memory between
+ * the heap and the stack is painted at startup (before constructors)
+ * and a periodic job scans the painted area incrementally; a number
+ * of bytes per run. The lowest address written by the stack and the
+ * top of the heap give the minimum free memory over time. The result
+ * of each completed scan is reported with on_report(). With
+ * COSA_STACK_GUARD defined, Event::run() checks the free memory
+ * before each event dispatch and the first near-collision (free
+ * memory less than the guard margin) is reported with on_collision().
+ * @code
+ * class Monitor : public Watermark {
+ * public:
+ *   Monitor() : Watermark(&scheduler) {}
+ *   virtual void on_report(uint16_t low_water) { trace << *this << endl; }
+ * };
+ * Monitor monitor;
+ * ...
+ * monitor.start();
+ * @endcode
+ * @section Limitations
+ * The startup painting is only linked when the monitor is used.
+ * Stack bytes that are written with the paint value are not
+ * detected. The low-water mark may be registered as a Registry blob
+ * with a copy updated in on_report().
+ */
+class Watermark : public Periodic {
+public:
+  /** Paint value for free memory. */
+  static const uint8_t PAINT = 0xa5;
+
+  /**
+   * Construct memory monitor with given scheduler, scan period and
+   * number of bytes to scan per period.
+   * @param[in] scheduler for periodic job.
+   * @param[in] period between scans in scheduler time unit
+   *   (default 1000 ms with Watchdog::Scheduler).
+   * @param[in] chunk number of bytes to scan per period (default 64).
+   */
+  Watermark(Job::Scheduler* scheduler,
+	    uint32_t period = 1000,
+	    uint8_t chunk = 64);
+
+  /**
+   * Return minimum free memory between heap and stack over time. The
+   * value is updated after each completed scan.
+   * @return bytes.
+   */
+  uint16_t low_water() const
+  {
+    return (m_low_water);
+  }
+
+  /**
+   * Return maximum stack depth; from end of memory to the lowest
+   * address written by the stack.
+   * @return bytes.
+   */
+  uint16_t stack_max() const
+  {
+    return (RAMEND - (uint16_t) m_stack_low);
+  }
+
+  /**
+   * Return current top of heap.
+   * @return address.
+   */
+  static uint8_t* heap_top()
+  {
+    extern int __heap_start, *__brkval;
+    return ((uint8_t*) (__brkval == 0 ? &__heap_start : __brkval));
+  }
+
+  /**
+   * Return true(1) if a stack near-collision has been detected
+   * otherwise false(0).
+   * @return bool.
+   */
+  static bool is_collision()
+  {
+    return (s_collision != 0);
+  }
+
+  /**
+   * Check free memory against the stack guard margin and record the
+   * first near-collision. Called by Event::run() when
+   * COSA_STACK_GUARD is defined.
+   * @param[in] margin guard margin in bytes.
+   */
+  static void guard(int margin)
+    __attribute__((always_inline))
+  {
+    if (LIKELY(s_collision != 0)) return;
+    int free = free_memory();
+    if (UNLIKELY(free < margin)) s_collision = (free < 1) ? 1 : free;
+  }
+
+  /**
+   * @override{Watermark}
+   * Called when a scan has been completed with the minimum free
+   * memory. Default is no action.
+   * @param[in] low_water minimum free memory in bytes.
+   */
+  virtual void on_report(uint16_t low_water)
+  {
+    UNUSED(low_water);
+  }
+
+  /**
+   * @override{Watermark}
+   * Called once on the first stack near-collision detected by
+   * guard(). Default is no action.
+   * @param[in] free memory in bytes at detection.
+   */
+  virtual void on_collision(int free)
+  {
+    UNUSED(free);
+  }
+
+  /**
+   * @override{Job}
+   * Scan the next chunk of the painted area and report on completed
+   * scan.
+   */
+  virtual void run();
+
+protected:
+  /** Free memory at first near-collision (zero if none). */
+  static int s_collision;
+
+  /** Number of bytes to scan per run. */
+  const uint8_t m_chunk;
+
+  /** Collision has been reported. */
+  bool m_reported;
+
+  /** Lowest address written by the stack. */
+  uint8_t* m_stack_low;
+
+  /** Next address to scan. */
+  uint8_t* m_pos;
+
+  /** Minimum free memory between heap and stack. */
+  uint16_t m_low_water;
+};
+
+/**
+ * Print memory monitor state to given output stream; low-water mark,
+ * max stack depth, heap top and collision.
+ * @param[in] outs output stream.
+ * @param[in] monitor memory monitor.
+ * @return output stream.
+ */
+IOStream& operator<<(IOStream& outs, Watermark& monitor);
+
+#endif
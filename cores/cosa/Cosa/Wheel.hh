@@ -0,0 +1,168 @@
+/**
+ * @file Cosa/Wheel.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_WHEEL_HH
+#define COSA_WHEEL_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Job.hh"
+
+/**
+ * Timer wheel backend for job schedulers. Jobs with an expire time
+ * beyond the current horizon are attached to a slot (bucket) given
+ * by the expire time in constant time. Jobs are moved to the
+ * schedulers sorted queue when their slot comes within the horizon
+ * (the current and next slot). The sorted queue will only hold jobs
+ * that expire within two slot periods and both start() and
+ * dispatch() become bounded by the slot occupancy instead of the
+ * total number of jobs. The timer wheel is added as a layer on top
+ * of a given scheduler class, which also defines the time base.
+ * @code
+ * Wheel<Watchdog::Scheduler, 16, 6> scheduler;
+ * Wheel<RTT::Scheduler, 32, 10> scheduler;
+ * @endcode
+ * @param[in] SCHEDULER job scheduler class (time base).
+ * @param[in] SLOTS number of wheel slots.
+ * @param[in] SHIFT slot period as power of 2 in schedulers time unit.
+ * @pre SLOTS is powerof(2) and max 128.
+ * @pre Slot period should be equal or larger than the scheduler tick
+ * (and the maximum idle period with COSA_RTT_TICKLESS, SHIFT >= 15).
+ */
+template<class SCHEDULER, uint8_t SLOTS, uint8_t SHIFT>
+class Wheel : public SCHEDULER {
+  static_assert(SLOTS && !(SLOTS & (SLOTS - 1)), "SLOTS should be power of 2");
+public:
+  /**
+   * Construct timer wheel on top of given scheduler class.
+   */
+  Wheel() :
+    SCHEDULER(),
+    m_horizon(0UL)
+  {}
+
+  /**
+   * @override{Job::Scheduler}
+   * Start given job. Jobs within the horizon are passed to the
+   * scheduler, other jobs are attached to the wheel slot. Returns
+   * true(1) if successful otherwise false(0).
+   * @param[in] job to start.
+   * @return bool.
+   */
+  virtual bool start(Job* job)
+  {
+    // Check that the job is not already started
+    if (job->is_started()) return (false);
+    uint32_t expires = job->expire_at();
+
+    // Attach to the wheel slot if beyond the horizon
+    synchronized {
+      if ((int32_t) (expires - m_horizon) >= 0) {
+	m_slot[(expires >> SHIFT) & MASK].attach(job);
+	return (true);
+      }
+    }
+    return (SCHEDULER::start(job));
+  }
+
+  /**
+   * @override{Job::Scheduler}
+   * Move jobs in the slots that have come within the horizon to the
+   * scheduler and dispatch expired jobs. Typically called from an
+   * interrupt service routine.
+   */
+  virtual void dispatch()
+  {
+    // Calculate the new horizon; start of slot after next
+    uint32_t horizon = ((this->time() >> SHIFT) + 2) << SHIFT;
+    int32_t diff = horizon - m_horizon;
+    if (diff > 0) {
+      uint32_t slots = ((uint32_t) diff) >> SHIFT;
+      uint8_t slot = (m_horizon >> SHIFT) & MASK;
+      uint8_t count = (slots < SLOTS) ? slots : SLOTS;
+      m_horizon = horizon;
+      while (count--) {
+	promote(&m_slot[slot], horizon);
+	slot = (slot + 1) & MASK;
+      }
+    }
+    SCHEDULER::dispatch();
+  }
+
+  /**
+   * @override{Job::Scheduler}
+   * Return time until the first job in the scheduler queue expires
+   * or the next slot should be promoted, or INT32_MAX if there are no
+   * jobs.
+   * @return time.
+   */
+  virtual int32_t expire_after()
+  {
+    int32_t res = SCHEDULER::expire_after();
+    for (uint8_t i = 0; i < SLOTS; i++) {
+      if (m_slot[i].is_empty()) continue;
+      int32_t diff = (m_horizon - (1UL << SHIFT)) - this->time();
+      return ((diff < res) ? diff : res);
+    }
+    return (res);
+  }
+
+  /**
+   * Return number of jobs in the wheel slots (beyond the horizon).
+   * @return number of jobs.
+   */
+  int available()
+  {
+    int res = 0;
+    for (uint8_t i = 0; i < SLOTS; i++) res += m_slot[i].available();
+    return (res);
+  }
+
+protected:
+  /** Slot index mask. */
+  static const uint8_t MASK = (SLOTS - 1);
+
+  /** Wheel slots; unsorted job queues. */
+  Head m_slot[SLOTS];
+
+  /** Jobs that expire before horizon are in the scheduler queue. */
+  uint32_t m_horizon;
+
+  /**
+   * Move jobs in given slot that expire before the given horizon to
+   * the scheduler. Jobs that belong to a later rotation of the wheel
+   * remain in the slot.
+   * @param[in] slot job queue.
+   * @param[in] horizon time.
+   */
+  void promote(Head* slot, uint32_t horizon)
+  {
+    Linkage* link = slot->succ();
+    while (link != slot) {
+      Job* job = (Job*) link;
+      link = link->succ();
+      if ((int32_t) (job->expire_at() - horizon) < 0) {
+	job->detach();
+	SCHEDULER::start(job);
+      }
+    }
+  }
+};
+
+#endif
@@ -23,6 +23,55 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Power.hh"
+#include "Cosa/Clock.hh"
+
+/**
+ * Number of destination entries in the Wireless link manager.
+ * Default is 8.
+ */
+#ifndef COSA_WIRELESS_MANAGER_MAX
+#define COSA_WIRELESS_MANAGER_MAX 8
+#endif
+
+/**
+ * Number of route cache entries in the Wireless mesh routing.
+ * Default is 8.
+ */
+#ifndef COSA_WIRELESS_MESH_ROUTE_MAX
+#define COSA_WIRELESS_MESH_ROUTE_MAX 8
+#endif
+
+/**
+ * Number of duplicate suppression entries (source and sequence
+ * number) in the Wireless mesh routing. Default is 8.
+ */
+#ifndef COSA_WIRELESS_MESH_DUP_MAX
+#define COSA_WIRELESS_MESH_DUP_MAX 8
+#endif
+
+/**
+ * Wireless mesh routing frame buffer size. Should be at most the max
+ * payload of the wireless device driver. Default is 30 bytes.
+ */
+#ifndef COSA_WIRELESS_MESH_FRAME_MAX
+#define COSA_WIRELESS_MESH_FRAME_MAX 30
+#endif
+
+/**
+ * Wireless packet aggregation frame buffer size. Should be at most
+ * the max payload of the wireless device driver. Default is 30 bytes.
+ */
+#ifndef COSA_WIRELESS_AGGREGATOR_FRAME_MAX
+#define COSA_WIRELESS_AGGREGATOR_FRAME_MAX 30
+#endif
+
+/**
+ * Number of node slots per frame in the Wireless time-slotted medium
+ * access. Default is 8.
+ */
+#ifndef COSA_WIRELESS_TDMA_SLOT_MAX
+#define COSA_WIRELESS_TDMA_SLOT_MAX 8
+#endif
 
 /**
  * Common Wireless device interface.
@@ -54,6 +103,18 @@ public:
       }
     };
 
+    /**
+     * Received message view. The payload references the driver
+     * receive buffer and is valid until release().
+     */
+    struct message_t {
+      uint8_t src;		//!< Source device address.
+      uint8_t dest;		//!< Destination device address.
+      uint8_t port;		//!< Port or message type.
+      const void* payload;	//!< Payload in driver buffer.
+      size_t len;		//!< Payload length.
+    };
+
     /** Broadcast device address. */
     static const uint8_t BROADCAST = 0x00;
 
@@ -67,7 +128,8 @@ public:
       m_channel(0),
       m_addr(network, device),
       m_avail(false),
-      m_dest(0)
+      m_dest(0),
+      m_stamp(0L)
     {}
 
     /**
@@ -254,6 +316,53 @@ public:
 		     void* buf, size_t len,
 		     uint32_t ms = 0L) = 0;
 
+    /**
+     * @override{Wireless::Driver}
+     * Receive message and lend the driver receive buffer. The message
+     * header and payload reference is returned in the given message
+     * view. The driver will not receive further messages until the
+     * message is released. Returns the number of payload bytes or a
+     * negative error code. Default implementation returns error
+     * code(ENOSYS); drivers that receive directly from the device
+     * fifo should use recv().
+     * @param[out] msg message view.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes received or negative error code.
+     */
+    virtual int borrow(message_t& msg, uint32_t ms = 0L)
+    {
+      UNUSED(msg);
+      UNUSED(ms);
+      return (ENOSYS);
+    }
+
+    /**
+     * @override{Wireless::Driver}
+     * Send the given borrowed message to the given destination
+     * address. The payload is transmitted directly from the receive
+     * buffer. Returns number of bytes sent if successful otherwise a
+     * negative error code.
+     * @param[in] msg message view.
+     * @param[in] dest destination network address.
+     * @return number of bytes send or negative error code.
+     */
+    virtual int forward(const message_t& msg, uint8_t dest)
+    {
+      return (send(dest, msg.port, msg.payload, msg.len));
+    }
+
+    /**
+     * @override{Wireless::Driver}
+     * Release the given borrowed message and return the receive
+     * buffer to the driver.
+     * @param[in] msg message view.
+     */
+    virtual void release(message_t& msg)
+    {
+      msg.payload = NULL;
+      msg.len = 0;
+    }
+
     /**
      * @override{Wireless::Driver}
      * Return true(1) if the latest received message was a broadcast
@@ -294,11 +403,972 @@ public:
       return (0);
     }
 
+    /**
+     * @override{Wireless::Driver}
+     * Return receive time stamp (RTT::micros) of the latest received
+     * message. Drivers stamp the message in the interrupt handler.
+     * Default zero(0) if not supported.
+     * @return micro-seconds.
+     */
+    virtual uint32_t timestamp()
+    {
+      return (m_stamp);
+    }
+
   protected:
     uint8_t m_channel;		//!< Current channel (device dependent.
     addr_t m_addr;		//!< Current network and device address.
     volatile bool m_avail;	//!< Message available. May be set by ISR.
     uint8_t m_dest;		//!< Latest message destination device address.
+    volatile uint32_t m_stamp;	//!< Receive time stamp. May be set by ISR.
+  };
+
+  /**
+   * Wireless link manager; adaptive transmit power per destination.
+   * Tracks delivery status (send() result or application feedback)
+   * and input power level (RSSI) of messages from each destination.
+   * The output power level is lowered a step after a number of
+   * successful deliveries when the latest input power level is above
+   * the target, and raised two steps (and the message retransmitted)
+   * on delivery failure. Broadcast is always sent with maximum power.
+   * @code
+   * CC1101 rf(NETWORK, DEVICE);
+   * Wireless::Manager link(&rf, -30, 10);
+   * ...
+   * link.send(dest, port, &msg, sizeof(msg));
+   * @endcode
+   */
+  class Manager {
+  public:
+    /** Output power level step (dBm). */
+    static const int8_t POWER_STEP = 3;
+
+    /** Successful deliveries before lowering the power level. */
+    static const uint8_t CREDIT_MAX = 8;
+
+    /** Default input power level target (dBm). */
+    static const int8_t DEFAULT_RSSI_TARGET = -80;
+
+    /**
+     * Construct link manager for the given device driver and output
+     * power level range (dBm).
+     * @param[in] dev wireless device driver.
+     * @param[in] min_dBm minimum output power level.
+     * @param[in] max_dBm maximum output power level.
+     * @param[in] rssi input power level target (dBm).
+     */
+    Manager(Driver* dev, int8_t min_dBm, int8_t max_dBm,
+	    int8_t rssi = DEFAULT_RSSI_TARGET) :
+      m_dev(dev),
+      m_min(min_dBm),
+      m_max(max_dBm),
+      m_rssi(rssi),
+      m_next(0)
+    {
+      memset(m_entry, 0, sizeof(m_entry));
+    }
+
+    /**
+     * Send message in given null terminated io vector with the output
+     * power level for the destination. The message is retransmitted
+     * once with raised power level on failure. Returns number of bytes
+     * sent if successful otherwise a negative error code.
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] vec null termianted io vector.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+    /**
+     * Send message in given buffer, with given number of bytes. See
+     * send(dest, port, vec).
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] buf buffer to transmit.
+     * @param[in] len number of bytes in buffer.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const void* buf, size_t len)
+    {
+      iovec_t vec[2];
+      iovec_t* vp = vec;
+      iovec_arg(vp, buf, len);
+      iovec_end(vp);
+      return (send(dest, port, vec));
+    }
+
+    /**
+     * Receive message and record the input power level of the
+     * source. See Driver::recv().
+     * @param[out] src source network address.
+     * @param[out] port device port (or message type).
+     * @param[in] buf buffer to store incoming message.
+     * @param[in] len maximum number of bytes to receive.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes received or negative error code.
+     */
+    int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+	     uint32_t ms = 0L);
+
+    /**
+     * Application level delivery feedback for the given destination.
+     * Used with drivers that do not acknowledge messages.
+     * @param[in] dest destination network address.
+     * @param[in] delivered true(1) if the message was acknowledged.
+     */
+    void feedback(uint8_t dest, bool delivered);
+
+    /**
+     * Return current output power level (dBm) for the given
+     * destination.
+     * @param[in] dest destination network address.
+     * @return power level in dBm.
+     */
+    int8_t power(uint8_t dest);
+
+  protected:
+    /** Number of destination entries. */
+    static const uint8_t ENTRY_MAX = COSA_WIRELESS_MANAGER_MAX;
+
+    /** Destination link state. */
+    struct entry_t {
+      uint8_t dest;		//!< Destination device address (zero if free).
+      int8_t power;		//!< Output power level (dBm).
+      int8_t rssi;		//!< Latest input power level (dBm).
+      uint8_t credit;		//!< Successful deliveries.
+    };
+
+    /** Device driver. */
+    Driver* m_dev;
+
+    /** Output power level range (dBm). */
+    int8_t m_min;
+    int8_t m_max;
+
+    /** Input power level target (dBm). */
+    int8_t m_rssi;
+
+    /** Next entry to replace. */
+    uint8_t m_next;
+
+    /** Destination link states. */
+    entry_t m_entry[ENTRY_MAX];
+
+    /**
+     * Lookup link state for the given destination. Allocate entry
+     * (round-robin replacement) if not found.
+     * @param[in] dest destination network address.
+     * @return entry.
+     */
+    entry_t* lookup(uint8_t dest);
+  };
+
+  /**
+   * Wireless multi-hop mesh routing. Messages are routed to the
+   * destination device address through neighbouring nodes. Routes
+   * are found on demand with a broadcast route request (RREQ) that
+   * is rebroadcast by each node at most once (duplicate suppression
+   * with source address and sequence number), and answered by the
+   * destination with a route reply (RREP) along the reverse path.
+   * Routes are kept in a compact cache (destination, next hop and
+   * number of hops), learned from all passing traffic, and the
+   * shortest route is retained. Each hop is acknowledged and
+   * retransmitted on failure. Broadcast messages are single hop.
+   * All nodes must call recv() to forward messages.
+   * @code
+   * NRF24L01P rf(NETWORK, DEVICE);
+   * Wireless::Mesh mesh(&rf);
+   * ...
+   * mesh.send(dest, port, &msg, sizeof(msg));
+   * ...
+   * int count = mesh.recv(src, port, &msg, sizeof(msg), TIMEOUT);
+   * @endcode
+   * @section Limitations
+   * There are no route error messages; broken routes are removed
+   * by the node that fails to deliver to the next hop, and all
+   * routes expire after ROUTE_TTL. Messages received while waiting
+   * for an acknowledgement or route reply are dropped (the sender
+   * will retransmit).
+   */
+  class Mesh {
+  public:
+    /** Device port (message type) used for mesh frames. */
+    static const uint8_t PORT = 0xf0;
+
+    /** Max size of mesh frame header. */
+    static const uint8_t HEADER_MAX = 6;
+
+    /** Max size of payload. */
+    static const uint8_t PAYLOAD_MAX = COSA_WIRELESS_MESH_FRAME_MAX - HEADER_MAX;
+
+    /** Max number of hops. */
+    static const uint8_t HOPS_MAX = 8;
+
+    /** Max number of transmissions per hop. */
+    static const uint8_t RETRY_MAX = 3;
+
+    /** Acknowledgement timeout (ms). */
+    static const uint16_t ACK_TIMEOUT = 100;
+
+    /** Route reply timeout (ms). */
+    static const uint16_t RREP_TIMEOUT = 500;
+
+    /** Route time to live (ms). */
+    static const uint32_t ROUTE_TTL = 120000UL;
+
+    /**
+     * Construct mesh routing for the given device driver. The
+     * device address of the driver is the node address.
+     * @param[in] dev wireless device driver.
+     */
+    Mesh(Driver* dev) :
+      m_dev(dev),
+      m_seq(0),
+      m_next(0)
+    {
+      memset(m_route, 0, sizeof(m_route));
+      memset(m_dup, 0, sizeof(m_dup));
+    }
+
+    /**
+     * Send message in given null terminated io vector to the given
+     * destination. A route is discovered if not available in the
+     * route cache. Returns number of bytes sent if successful
+     * otherwise a negative error code; EHOSTUNREACH if there is no
+     * route or the next hop did not acknowledge.
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] vec null termianted io vector.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+    /**
+     * Send message in given buffer, with given number of bytes. See
+     * send(dest, port, vec).
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] buf buffer to transmit.
+     * @param[in] len number of bytes in buffer.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const void* buf, size_t len)
+    {
+      iovec_t vec[2];
+      iovec_t* vp = vec;
+      iovec_arg(vp, buf, len);
+      iovec_end(vp);
+      return (send(dest, port, vec));
+    }
+
+    /**
+     * Receive message addressed to this node (or broadcast). Mesh
+     * frames for other nodes are acknowledged and forwarded, and
+     * route requests answered, while waiting. Returns number of
+     * bytes received or negative error code; ETIME on timeout.
+     * @param[out] src source network address.
+     * @param[out] port device port (or message type).
+     * @param[in] buf buffer to store incoming message.
+     * @param[in] len maximum number of bytes to receive.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes received or negative error code.
+     */
+    int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+	     uint32_t ms = 0L);
+
+    /**
+     * Discover route to the given destination. Returns number of
+     * hops if successful otherwise negative error code
+     * (EHOSTUNREACH).
+     * @param[in] dest destination network address.
+     * @return number of hops or negative error code.
+     */
+    int discover(uint8_t dest);
+
+    /**
+     * Return next hop for the given destination or zero if there is
+     * no valid route in the cache.
+     * @param[in] dest destination network address.
+     * @return next hop device address or zero.
+     */
+    uint8_t next_hop(uint8_t dest)
+    {
+      route_t* route = lookup(dest);
+      return (route == NULL ? 0 : route->next);
+    }
+
+  protected:
+    /** Number of route cache entries. */
+    static const uint8_t ROUTE_MAX = COSA_WIRELESS_MESH_ROUTE_MAX;
+
+    /** Number of duplicate suppression entries. */
+    static const uint8_t DUP_MAX = COSA_WIRELESS_MESH_DUP_MAX;
+
+    /** Rebroadcast delay per device address step (ms). */
+    static const uint8_t JITTER = 4;
+
+    /** Frame types. */
+    enum {
+      DATA = 0,			//!< Application message.
+      ACK = 1,			//!< Hop acknowledgement.
+      RREQ = 2,			//!< Route request (broadcast).
+      RREP = 3			//!< Route reply.
+    };
+
+    /** Frame header. */
+    struct header_t {
+      uint8_t type;		//!< Frame type.
+      uint8_t src;		//!< Originator device address.
+      uint8_t dest;		//!< Final destination device address.
+      uint8_t seq;		//!< Originator sequence number.
+      uint8_t hops;		//!< Number of hops so far.
+      uint8_t port;		//!< Application port.
+    };
+
+    /** Route cache entry. */
+    struct route_t {
+      uint8_t dest;		//!< Destination device address (zero if free).
+      uint8_t next;		//!< Next hop device address.
+      uint8_t hops;		//!< Number of hops to destination.
+      uint32_t stamp;		//!< Time of latest update (ms).
+    };
+
+    /** Duplicate suppression entry. */
+    struct dup_t {
+      uint8_t src;		//!< Originator device address.
+      uint8_t seq;		//!< Originator sequence number.
+    };
+
+    /** Device driver. */
+    Driver* m_dev;
+
+    /** Sequence number of latest originated frame. */
+    uint8_t m_seq;
+
+    /** Next duplicate suppression entry to replace. */
+    uint8_t m_next;
+
+    /** Route cache. */
+    route_t m_route[ROUTE_MAX];
+
+    /** Duplicate suppression ring. */
+    dup_t m_dup[DUP_MAX];
+
+    /** Frame buffer; header and payload. */
+    uint8_t m_frame[COSA_WIRELESS_MESH_FRAME_MAX];
+
+    /**
+     * Lookup valid route for the given destination. Return route
+     * or NULL if not found or expired.
+     * @param[in] dest destination network address.
+     * @return route or NULL.
+     */
+    route_t* lookup(uint8_t dest);
+
+    /**
+     * Learn route to the given destination through the given next
+     * hop. Replaces the cached route if not shorter or expired.
+     * Allocates the free or oldest entry if not found.
+     * @param[in] dest destination network address.
+     * @param[in] next next hop device address.
+     * @param[in] hops number of hops.
+     */
+    void learn(uint8_t dest, uint8_t next, uint8_t hops);
+
+    /**
+     * Remove all routes through the given next hop.
+     * @param[in] next next hop device address.
+     */
+    void forget(uint8_t next);
+
+    /**
+     * Check and record originator sequence number. Return true(1)
+     * if the frame has already been seen otherwise false(0).
+     * @param[in] header frame header.
+     * @return bool.
+     */
+    bool is_duplicate(const header_t* header);
+
+    /**
+     * Transmit frame buffer with given size to the next hop and wait
+     * for acknowledgement. Retransmit on timeout. Routes through the
+     * next hop are removed on failure. Returns size if successful
+     * otherwise EHOSTUNREACH.
+     * @param[in] next next hop device address.
+     * @param[in] size number of bytes in frame.
+     * @return size or negative error code.
+     */
+    int transmit(uint8_t next, size_t size);
+
+    /**
+     * Forward frame buffer with given size towards the header
+     * destination. Increments the hop count. Returns size if
+     * successful otherwise negative error code.
+     * @param[in] size number of bytes in frame.
+     * @return size or negative error code.
+     */
+    int forward(size_t size);
+
+    /**
+     * Acknowledge frame header to the given previous hop.
+     * @param[in] hop previous hop device address.
+     * @param[in] header frame header.
+     */
+    void acknowledge(uint8_t hop, const header_t* header);
+  };
+
+  /**
+   * Reliable IOStream device over Wireless connection. See
+   * Cosa/Wireless_Stream.hh.
+   */
+  class Stream;
+
+  /**
+   * Wireless time-slotted medium access (TDMA). A coordinator
+   * broadcasts a beacon at the start of each frame. The frame is
+   * divided into slots; slot zero belongs to the coordinator (beacon
+   * and coordinator messages), slots 1..SLOT_MAX are assigned to
+   * nodes, and the last slot is a contention slot where nodes
+   * request a slot assignment. The beacon holds the slot table.
+   * Nodes synchronize on the beacon, transmit only in the assigned
+   * slot, and power down the device while waiting for the slot.
+   * @code
+   * NRF24L01P rf(NETWORK, DEVICE);
+   * Wireless::TDMA mac(&rf, COORDINATOR);
+   * ...
+   * while (mac.sync() < 0);
+   * mac.send(dest, port, &msg, sizeof(msg));
+   * @endcode
+   * The coordinator must call recv() continuously to transmit the
+   * beacons.
+   * @section Limitations
+   * Slot assignments are kept until the coordinator is restarted.
+   * Messages to the coordinator that arrive while the coordinator
+   * waits for slot zero in send() are dropped. The slot length must
+   * allow the device to transmit a max size message.
+   */
+  class TDMA {
+  public:
+    /** Device port (message type) used for beacons and requests. */
+    static const uint8_t PORT = 0xf1;
+
+    /** Number of node slots per frame. */
+    static const uint8_t SLOT_MAX = COSA_WIRELESS_TDMA_SLOT_MAX;
+
+    /** Default slot length (ms). */
+    static const uint8_t DEFAULT_SLOT_MS = 20;
+
+    /** Guard time at start and end of slot (ms). */
+    static const uint8_t GUARD_MS = 2;
+
+    /** Device wakeup time from power down (ms). */
+    static const uint8_t WAKEUP_MS = 5;
+
+    /**
+     * Construct time-slotted medium access for the given device
+     * driver and coordinator device address. The node is the
+     * coordinator if the device address of the driver is the
+     * coordinator address. The slot length is only used by the
+     * coordinator; nodes use the slot length in the beacon.
+     * @param[in] dev wireless device driver.
+     * @param[in] coordinator device address.
+     * @param[in] slot_ms slot length (ms).
+     */
+    TDMA(Driver* dev, uint8_t coordinator,
+	 uint8_t slot_ms = DEFAULT_SLOT_MS) :
+      m_dev(dev),
+      m_coordinator(coordinator),
+      m_slot_ms(slot_ms),
+      m_seq(0),
+      m_slot(-1),
+      m_sync(false),
+      m_start(0L)
+    {
+      memset(m_table, 0, sizeof(m_table));
+    }
+
+    /**
+     * Return true(1) if this node is the coordinator otherwise
+     * false(0).
+     * @return bool.
+     */
+    bool is_coordinator() const
+    {
+      return (m_dev->device_address() == m_coordinator);
+    }
+
+    /**
+     * Return true(1) if the node is synchronized with the beacon
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_synchronized() const
+    {
+      return (m_sync);
+    }
+
+    /**
+     * Return assigned slot or negative value if not assigned.
+     * @return slot.
+     */
+    int8_t slot() const
+    {
+      return (m_slot);
+    }
+
+    /**
+     * Return frame period (ms).
+     * @return milli-seconds.
+     */
+    uint16_t frame_period() const
+    {
+      return ((SLOT_MAX + 2) * m_slot_ms);
+    }
+
+    /**
+     * Synchronize with the coordinator beacon and request a slot
+     * assignment in the contention slot if not assigned. Returns the
+     * assigned slot, or negative error code; ETIME if no beacon was
+     * received within the given time out period, ENOTCONN if a slot
+     * is not yet assigned (retry after the next beacon).
+     * @param[in] ms maximum time out period.
+     * @return slot or negative error code.
+     */
+    int sync(uint32_t ms = 0L);
+
+    /**
+     * Send message in given null terminated io vector in the next
+     * assigned slot. The device is powered down while waiting for the
+     * slot. Returns number of bytes sent if successful otherwise a
+     * negative error code; ENOTCONN if not synchronized or no slot
+     * is assigned.
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] vec null termianted io vector.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+    /**
+     * Send message in given buffer, with given number of bytes. See
+     * send(dest, port, vec).
+     * @param[in] dest destination network address.
+     * @param[in] port device port (or message type).
+     * @param[in] buf buffer to transmit.
+     * @param[in] len number of bytes in buffer.
+     * @return number of bytes send or negative error code.
+     */
+    int send(uint8_t dest, uint8_t port, const void* buf, size_t len)
+    {
+      iovec_t vec[2];
+      iovec_t* vp = vec;
+      iovec_arg(vp, buf, len);
+      iovec_end(vp);
+      return (send(dest, port, vec));
+    }
+
+    /**
+     * Receive message. Beacons update the synchronization and slot
+     * assignment. The coordinator transmits the beacon at the start
+     * of each frame and handles slot requests. See Driver::recv().
+     * @param[out] src source network address.
+     * @param[out] port device port (or message type).
+     * @param[in] buf buffer to store incoming message.
+     * @param[in] len maximum number of bytes to receive.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes received or negative error code.
+     */
+    int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+	     uint32_t ms = 0L);
+
+  protected:
+    /** Frame types. */
+    enum {
+      BEACON = 0,		//!< Frame start and slot table.
+      REQUEST = 1		//!< Slot assignment request.
+    };
+
+    /** Beacon message. */
+    struct beacon_t {
+      uint8_t type;		//!< Frame type (BEACON).
+      uint8_t seq;		//!< Frame sequence number.
+      uint8_t slot_ms;		//!< Slot length (ms).
+      uint8_t table[SLOT_MAX];	//!< Slot table; device addresses.
+    };
+
+    /** Device driver. */
+    Driver* m_dev;
+
+    /** Coordinator device address. */
+    uint8_t m_coordinator;
+
+    /** Slot length (ms). */
+    uint8_t m_slot_ms;
+
+    /** Frame sequence number. */
+    uint8_t m_seq;
+
+    /** Assigned slot (1..SLOT_MAX) or negative if not assigned. */
+    int8_t m_slot;
+
+    /** Synchronized with beacon. */
+    bool m_sync;
+
+    /** Start of current frame (ms). */
+    uint32_t m_start;
+
+    /** Slot table; device address per slot (zero if free). */
+    uint8_t m_table[SLOT_MAX];
+
+    /**
+     * Wait until given offset (ms) from the start of the current
+     * frame. The device is powered down if the wait is longer than
+     * the wakeup time.
+     * @param[in] ms offset from frame start.
+     */
+    void wait(uint32_t ms);
+
+    /**
+     * Coordinator; broadcast beacon and start a new frame.
+     */
+    void beacon();
+
+    /**
+     * Node; handle the given beacon and update synchronization and
+     * slot assignment.
+     * @param[in] beacon message.
+     */
+    void update(const beacon_t* beacon);
+  };
+
+  /**
+   * Wireless network time synchronization. A master node broadcasts
+   * beacons with its 48-bit micro-second clock (RTT::micros64) and
+   * wall-clock. Nodes stamp the beacon at receive (driver interrupt
+   * handler; Driver::timestamp()) and estimate the offset and skew
+   * (drift) of the local clock relative to the master. The network
+   * time is the local clock corrected with the offset and skew, and
+   * the wall-clock (RTT::Clock) is set from the beacon. Jobs may be
+   * scheduled on network time with local().
+   * @code
+   * NRF24L01P rf(NETWORK, DEVICE);
+   * RTT::Clock clock;
+   * Wireless::Sync sync(&rf, MASTER, &clock);
+   * ...
+   * sync.recv(src, port, &msg, sizeof(msg));
+   * ...
+   * job.expire_at(sync.local(sync.micros64() + 1000000UL));
+   * @endcode
+   * The master should call beacon() periodically (e.g. every 10 s).
+   * Nodes must receive through recv(), or call update() with beacons
+   * (PORT) received by the application.
+   */
+  class Sync {
+  public:
+    /** Device port (message type) used for beacons. */
+    static const uint8_t PORT = 0xf2;
+
+    /** Skew fixed-point fraction bits. */
+    static const uint8_t SKEW_BITS = 24;
+
+    /** Maximum skew estimate (approx. 1000 ppm). */
+    static const int32_t SKEW_MAX = 1L << (SKEW_BITS - 10);
+
+    /**
+     * Construct network time synchronization for the given device
+     * driver and master device address. The node is the master if the
+     * device address of the driver is the master address. The
+     * optional wall-clock is set from the beacons on nodes and read
+     * on the master. The latency is the time from the master time
+     * stamp to the receive time stamp (us); transmission and
+     * interrupt handling.
+     * @param[in] dev wireless device driver.
+     * @param[in] master device address.
+     * @param[in] clock wall-clock (default NULL).
+     * @param[in] latency beacon latency (default 0 us).
+     */
+    Sync(Driver* dev, uint8_t master,
+	 ::Clock* clock = NULL,
+	 uint16_t latency = 0) :
+      m_dev(dev),
+      m_master(master),
+      m_clock(clock),
+      m_latency(latency),
+      m_seq(0),
+      m_sync(false),
+      m_ref(0),
+      m_offset(0),
+      m_skew(0)
+    {}
+
+    /**
+     * Return true(1) if this node is the master otherwise false(0).
+     * @return bool.
+     */
+    bool is_master() const
+    {
+      return (m_dev->device_address() == m_master);
+    }
+
+    /**
+     * Return true(1) if the node is synchronized with the master
+     * otherwise false(0). The master is always synchronized.
+     * @return bool.
+     */
+    bool is_synchronized() const
+    {
+      return (m_sync || is_master());
+    }
+
+    /**
+     * Return latest offset estimate (us); network time minus local
+     * time at the latest beacon.
+     * @return micro-seconds.
+     */
+    int64_t offset() const
+    {
+      return (m_offset);
+    }
+
+    /**
+     * Return skew estimate; local clock drift relative to the master
+     * as a fixed-point (SKEW_BITS) fraction.
+     * @return skew.
+     */
+    int32_t skew() const
+    {
+      return (m_skew);
+    }
+
+    /**
+     * Master; broadcast a beacon with the current time. Returns
+     * number of bytes sent if successful otherwise a negative error
+     * code.
+     * @return number of bytes sent or negative error code.
+     */
+    int beacon();
+
+    /**
+     * Node; update offset and skew estimate with the given beacon
+     * message and receive time stamp (RTT::micros). Return true(1)
+     * if successful otherwise false(0).
+     * @param[in] buf beacon message.
+     * @param[in] len length of message.
+     * @param[in] stamp receive time stamp.
+     * @return bool.
+     */
+    bool update(const void* buf, size_t len, uint32_t stamp);
+
+    /**
+     * Return network time in micro-seconds (48-bit).
+     * @return micro-seconds.
+     */
+    uint64_t micros64();
+
+    /**
+     * Return network time in micro-seconds (32-bit).
+     * @return micro-seconds.
+     */
+    uint32_t micros()
+    {
+      return ((uint32_t) micros64());
+    }
+
+    /**
+     * Return local time (RTT::micros) for the given network time.
+     * May be used as expire time for jobs on RTT::Scheduler.
+     * @param[in] us network time.
+     * @return local micro-seconds.
+     */
+    uint32_t local(uint64_t us);
+
+    /**
+     * Receive message. Beacons from the master update the time
+     * synchronization and are not returned. See Driver::recv().
+     * @param[out] src source network address.
+     * @param[out] port device port (or message type).
+     * @param[in] buf buffer to store incoming message.
+     * @param[in] len maximum number of bytes to receive.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes received or negative error code.
+     */
+    int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+	     uint32_t ms = 0L);
+
+  protected:
+    /** Beacon message. */
+    struct beacon_t {
+      uint8_t seq;		//!< Beacon sequence number.
+      uint16_t ms;		//!< Wall-clock milli-seconds fraction.
+      uint32_t sec;		//!< Wall-clock seconds.
+      uint64_t us;		//!< Master clock (RTT::micros64).
+    };
+
+    Driver* m_dev;		//!< Device driver.
+    uint8_t m_master;		//!< Master device address.
+    ::Clock* m_clock;		//!< Wall-clock or NULL.
+    uint16_t m_latency;		//!< Beacon latency (us).
+    uint8_t m_seq;		//!< Beacon sequence number.
+    bool m_sync;		//!< Synchronized with master.
+    uint64_t m_ref;		//!< Local time of latest beacon (us).
+    int64_t m_offset;		//!< Offset at latest beacon (us).
+    int32_t m_skew;		//!< Skew estimate (fixed-point).
+  };
+
+  /**
+   * Wireless packet aggregation for low-power senders. Readings are
+   * accumulated as records (port, length and payload) in a frame and
+   * sent together when the frame is full or when the latency deadline
+   * from the first record has passed. The device is powered up only
+   * for the combined frame so that the radio startup time (and
+   * energy) is amortized over several readings. The receiver splits
+   * frames back into records and calls on_record() per record with
+   * the source address.
+   * @code
+   * NRF24L01P rf(NETWORK, DEVICE);
+   * Wireless::Aggregator agg(&rf, GATEWAY, 10000);
+   * ...
+   * agg.add(PORT, &reading, sizeof(reading));
+   * if (agg.is_expired()) agg.flush();
+   * @endcode
+   * @section Limitations
+   * Records are at most FRAME_MAX - RECORD_HEADER bytes. Pending
+   * records are lost on reset; call flush() before long sleep if the
+   * deadline is not checked on wake up.
+   */
+  class Aggregator {
+  public:
+    /** Device port (message type) used for aggregated frames. */
+    static const uint8_t PORT = 0xf3;
+
+    /** Max size of aggregated frame. */
+    static const uint8_t FRAME_MAX = COSA_WIRELESS_AGGREGATOR_FRAME_MAX;
+
+    /** Size of record header (port and length). */
+    static const uint8_t RECORD_HEADER = 2;
+
+    /** Default latency deadline (ms). */
+    static const uint16_t DEFAULT_LATENCY_MS = 10000;
+
+    /**
+     * Construct aggregation for the given device driver, destination
+     * and latency deadline (ms). The device should be powered down
+     * by the application after begin().
+     * @param[in] dev wireless device driver.
+     * @param[in] dest destination device address.
+     * @param[in] latency_ms max time from first record to send (ms).
+     */
+    Aggregator(Driver* dev, uint8_t dest,
+	       uint16_t latency_ms = DEFAULT_LATENCY_MS) :
+      m_dev(dev),
+      m_dest(dest),
+      m_latency(latency_ms),
+      m_length(0),
+      m_start(0L),
+      m_frames(0)
+    {}
+
+    /**
+     * Return number of pending bytes in frame.
+     * @return bytes.
+     */
+    uint8_t available() const
+    {
+      return (m_length);
+    }
+
+    /**
+     * Return true(1) if there are pending records and the latency
+     * deadline has passed otherwise false(0).
+     * @return bool.
+     */
+    bool is_expired() const;
+
+    /**
+     * Return number of frames sent.
+     * @return frames.
+     */
+    uint16_t frames() const
+    {
+      return (m_frames);
+    }
+
+    /**
+     * Add record with given port, buffer and length to the frame. The
+     * pending frame is sent first if the record does not fit, and the
+     * frame is sent directly if full. Returns length if successful
+     * otherwise a negative error code; EMSGSIZE if the record is too
+     * large, or the send error code.
+     * @param[in] port device port (or message type).
+     * @param[in] buf record payload.
+     * @param[in] len number of bytes in payload.
+     * @return length or negative error code.
+     */
+    int add(uint8_t port, const void* buf, size_t len);
+
+    /**
+     * Power up the device and send the pending records in a single
+     * frame, then power down the device. Returns number of bytes sent,
+     * zero if no pending records, otherwise a negative error code.
+     * The records are dropped on error.
+     * @return number of bytes sent or negative error code.
+     */
+    int flush();
+
+    /**
+     * Split the given aggregated frame from the given source and call
+     * on_record() per record. Returns number of records or EINVAL if
+     * the frame is malformed (records before the error are
+     * delivered).
+     * @param[in] src source device address.
+     * @param[in] frame aggregated frame.
+     * @param[in] len number of bytes in frame.
+     * @return number of records or negative error code.
+     */
+    int split(uint8_t src, const void* frame, size_t len);
+
+    /**
+     * Receive message. Aggregated frames (PORT) are split and
+     * delivered to on_record(); the number of records is returned
+     * and port is PORT. Other messages are returned as with
+     * Driver::recv().
+     * @param[out] src source network address.
+     * @param[out] port device port (or message type).
+     * @param[in] buf buffer to store incoming message.
+     * @param[in] len maximum number of bytes to receive.
+     * @param[in] ms maximum time out period.
+     * @return number of bytes or records received or negative error code.
+     */
+    int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+	     uint32_t ms = 0L);
+
+    /**
+     * @override{Wireless::Aggregator}
+     * Called by split() for each record in an aggregated frame. The
+     * payload is only valid during the call. Default is void.
+     * @param[in] src source device address.
+     * @param[in] port record port (or message type).
+     * @param[in] buf record payload.
+     * @param[in] len number of bytes in payload.
+     */
+    virtual void on_record(uint8_t src, uint8_t port,
+			   const void* buf, size_t len)
+    {
+      UNUSED(src);
+      UNUSED(port);
+      UNUSED(buf);
+      UNUSED(len);
+    }
+
+  protected:
+    Driver* m_dev;		//!< Device driver.
+    uint8_t m_dest;		//!< Destination device address.
+    uint16_t m_latency;		//!< Latency deadline (ms).
+    uint8_t m_length;		//!< Pending bytes in frame.
+    uint32_t m_start;		//!< Time of first pending record (ms).
+    uint16_t m_frames;		//!< Number of frames sent.
+    uint8_t m_frame[FRAME_MAX];	//!< Frame buffer.
   };
 };
 #endif
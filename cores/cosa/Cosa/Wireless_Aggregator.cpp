@@ -0,0 +1,101 @@
+/**
+ * @file Cosa/Wireless_Aggregator.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless.hh"
+#include "Cosa/RTT.hh"
+
+bool
+Wireless::Aggregator::is_expired() const
+{
+  if (m_length == 0) return (false);
+  return (RTT::since(m_start) >= m_latency);
+}
+
+int
+Wireless::Aggregator::add(uint8_t port, const void* buf, size_t len)
+{
+  if (UNLIKELY(len > FRAME_MAX - RECORD_HEADER)) return (EMSGSIZE);
+
+  // Send the pending records if the record does not fit
+  size_t size = len + RECORD_HEADER;
+  if (m_length + size > FRAME_MAX) {
+    int res = flush();
+    if (UNLIKELY(res < 0)) return (res);
+  }
+
+  // Append the record; the deadline is from the first record
+  if (m_length == 0) m_start = RTT::millis();
+  uint8_t* rp = m_frame + m_length;
+  *rp++ = port;
+  *rp++ = len;
+  memcpy(rp, buf, len);
+  m_length += size;
+
+  // Send directly if there is no room for another record
+  if (m_length + RECORD_HEADER >= FRAME_MAX) {
+    int res = flush();
+    if (UNLIKELY(res < 0)) return (res);
+  }
+  return (len);
+}
+
+int
+Wireless::Aggregator::flush()
+{
+  if (m_length == 0) return (0);
+
+  // Power up the device once for all pending records
+  m_dev->powerup();
+  int res = m_dev->send(m_dest, PORT, m_frame, m_length);
+  m_dev->powerdown();
+  m_length = 0;
+  if (UNLIKELY(res < 0)) return (res);
+  m_frames += 1;
+  return (res);
+}
+
+int
+Wireless::Aggregator::split(uint8_t src, const void* frame, size_t len)
+{
+  const uint8_t* fp = (const uint8_t*) frame;
+  int count = 0;
+  while (len >= RECORD_HEADER) {
+    uint8_t port = *fp++;
+    uint8_t size = *fp++;
+    len -= RECORD_HEADER;
+    if (UNLIKELY(size > len)) return (EINVAL);
+    on_record(src, port, fp, size);
+    fp += size;
+    len -= size;
+    count += 1;
+  }
+  if (UNLIKELY(len != 0)) return (EINVAL);
+  return (count);
+}
+
+int
+Wireless::Aggregator::recv(uint8_t& src, uint8_t& port,
+			   void* buf, size_t len,
+			   uint32_t ms)
+{
+  int res = m_dev->recv(src, port, buf, len, ms);
+  if (res < 0 || port != PORT) return (res);
+  return (split(src, buf, res));
+}
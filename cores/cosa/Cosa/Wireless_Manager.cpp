@@ -0,0 +1,100 @@
+/**
+ * @file Cosa/Wireless_Manager.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless.hh"
+
+Wireless::Manager::entry_t*
+Wireless::Manager::lookup(uint8_t dest)
+{
+  // Search for the destination
+  for (uint8_t i = 0; i < ENTRY_MAX; i++)
+    if (m_entry[i].dest == dest) return (&m_entry[i]);
+
+  // Replace an entry; start with maximum power level
+  entry_t* entry = &m_entry[m_next];
+  if (++m_next == ENTRY_MAX) m_next = 0;
+  entry->dest = dest;
+  entry->power = m_max;
+  entry->rssi = m_rssi;
+  entry->credit = 0;
+  return (entry);
+}
+
+void
+Wireless::Manager::feedback(uint8_t dest, bool delivered)
+{
+  if (dest == Driver::BROADCAST) return;
+  entry_t* entry = lookup(dest);
+
+  // Raise power level on failure
+  if (!delivered) {
+    entry->power += 2 * POWER_STEP;
+    if (entry->power > m_max) entry->power = m_max;
+    entry->credit = 0;
+    return;
+  }
+
+  // Lower power level after a number of deliveries and if the latest
+  // input power level from the destination is above the target
+  if (++entry->credit < CREDIT_MAX) return;
+  entry->credit = 0;
+  if (entry->rssi < m_rssi) return;
+  entry->power -= POWER_STEP;
+  if (entry->power < m_min) entry->power = m_min;
+}
+
+int8_t
+Wireless::Manager::power(uint8_t dest)
+{
+  if (dest == Driver::BROADCAST) return (m_max);
+  return (lookup(dest)->power);
+}
+
+int
+Wireless::Manager::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Broadcast with maximum power level
+  if (dest == Driver::BROADCAST) {
+    m_dev->output_power_level(m_max);
+    return (m_dev->send(dest, port, vec));
+  }
+
+  // Send with destination power level. Retransmit on failure
+  int8_t dBm = power(dest);
+  m_dev->output_power_level(dBm);
+  int res = m_dev->send(dest, port, vec);
+  feedback(dest, res >= 0);
+  if ((res >= 0) || (dBm == m_max)) return (res);
+  m_dev->output_power_level(power(dest));
+  res = m_dev->send(dest, port, vec);
+  feedback(dest, res >= 0);
+  return (res);
+}
+
+int
+Wireless::Manager::recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+			uint32_t ms)
+{
+  // Receive message and record input power level of source
+  int res = m_dev->recv(src, port, buf, len, ms);
+  if (res < 0 || src == Driver::BROADCAST) return (res);
+  lookup(src)->rssi = m_dev->input_power_level();
+  return (res);
+}
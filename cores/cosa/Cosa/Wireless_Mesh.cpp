@@ -0,0 +1,310 @@
+/**
+ * @file Cosa/Wireless_Mesh.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless.hh"
+#include "Cosa/RTT.hh"
+
+Wireless::Mesh::route_t*
+Wireless::Mesh::lookup(uint8_t dest)
+{
+  for (uint8_t i = 0; i < ROUTE_MAX; i++) {
+    route_t* route = &m_route[i];
+    if (route->dest != dest) continue;
+    if (RTT::since(route->stamp) < ROUTE_TTL) return (route);
+    route->dest = 0;
+    return (NULL);
+  }
+  return (NULL);
+}
+
+void
+Wireless::Mesh::learn(uint8_t dest, uint8_t next, uint8_t hops)
+{
+  if (dest == Driver::BROADCAST || dest == m_dev->device_address()) return;
+
+  // Update the cached route if the new route is not longer, or is the
+  // same next hop, or the cached route has expired
+  route_t* route = lookup(dest);
+  if (route != NULL) {
+    if (hops > route->hops && next != route->next) return;
+  }
+
+  // Otherwise allocate a free or the oldest entry
+  else {
+    uint32_t age = 0;
+    route = &m_route[0];
+    for (uint8_t i = 0; i < ROUTE_MAX; i++) {
+      route_t* entry = &m_route[i];
+      if (entry->dest == 0) {
+	route = entry;
+	break;
+      }
+      uint32_t since = RTT::since(entry->stamp);
+      if (since > age) {
+	age = since;
+	route = entry;
+      }
+    }
+  }
+  route->dest = dest;
+  route->next = next;
+  route->hops = hops;
+  route->stamp = RTT::millis();
+}
+
+void
+Wireless::Mesh::forget(uint8_t next)
+{
+  for (uint8_t i = 0; i < ROUTE_MAX; i++)
+    if (m_route[i].next == next) m_route[i].dest = 0;
+}
+
+bool
+Wireless::Mesh::is_duplicate(const header_t* header)
+{
+  for (uint8_t i = 0; i < DUP_MAX; i++)
+    if (m_dup[i].src == header->src && m_dup[i].seq == header->seq)
+      return (true);
+  dup_t* dup = &m_dup[m_next];
+  if (++m_next == DUP_MAX) m_next = 0;
+  dup->src = header->src;
+  dup->seq = header->seq;
+  return (false);
+}
+
+void
+Wireless::Mesh::acknowledge(uint8_t hop, const header_t* header)
+{
+  header_t ack;
+  ack.type = ACK;
+  ack.src = header->src;
+  ack.dest = hop;
+  ack.seq = header->seq;
+  ack.hops = 0;
+  ack.port = 0;
+  m_dev->send(hop, PORT, &ack, sizeof(ack));
+}
+
+int
+Wireless::Mesh::transmit(uint8_t next, size_t size)
+{
+  header_t* header = (header_t*) m_frame;
+  for (uint8_t retry = 0; retry < RETRY_MAX; retry++) {
+    if (m_dev->send(next, PORT, m_frame, size) < 0) continue;
+
+    // Wait for the hop acknowledgement; drop all other frames
+    uint32_t start = RTT::millis();
+    uint32_t ms;
+    while ((ms = RTT::since(start)) < ACK_TIMEOUT) {
+      header_t ack;
+      uint8_t hop;
+      uint8_t port;
+      int res = m_dev->recv(hop, port, &ack, sizeof(ack), ACK_TIMEOUT - ms);
+      if (res != sizeof(ack)) continue;
+      if ((port == PORT)
+	  && (hop == next)
+	  && (ack.type == ACK)
+	  && (ack.src == header->src)
+	  && (ack.seq == header->seq)) {
+	route_t* route = lookup(header->dest);
+	if (route != NULL && route->next == next)
+	  route->stamp = RTT::millis();
+	return (size);
+      }
+    }
+  }
+
+  // The next hop is not reachable; remove routes through it
+  forget(next);
+  return (EHOSTUNREACH);
+}
+
+int
+Wireless::Mesh::forward(size_t size)
+{
+  header_t* header = (header_t*) m_frame;
+  if (header->hops >= HOPS_MAX) return (EHOSTUNREACH);
+  route_t* route = lookup(header->dest);
+  if (route == NULL) return (EHOSTUNREACH);
+  header->hops += 1;
+  return (transmit(route->next, size));
+}
+
+int
+Wireless::Mesh::discover(uint8_t dest)
+{
+  route_t* route = lookup(dest);
+  if (route != NULL) return (route->hops);
+
+  // Broadcast route request and wait for the route reply
+  uint8_t addr = m_dev->device_address();
+  for (uint8_t retry = 0; retry < RETRY_MAX; retry++) {
+    header_t rreq;
+    rreq.type = RREQ;
+    rreq.src = addr;
+    rreq.dest = dest;
+    rreq.seq = ++m_seq;
+    rreq.hops = 0;
+    rreq.port = 0;
+    if (m_dev->send(Driver::BROADCAST, PORT, &rreq, sizeof(rreq)) < 0)
+      continue;
+    uint32_t start = RTT::millis();
+    uint32_t ms;
+    while ((ms = RTT::since(start)) < RREP_TIMEOUT) {
+      header_t rrep;
+      uint8_t hop;
+      uint8_t port;
+      int res = m_dev->recv(hop, port, &rrep, sizeof(rrep), RREP_TIMEOUT - ms);
+      if (res != sizeof(rrep)) continue;
+      if ((port != PORT)
+	  || (rrep.type != RREP)
+	  || (rrep.dest != addr)
+	  || (rrep.src != dest))
+	continue;
+      acknowledge(hop, &rrep);
+      if (is_duplicate(&rrep)) continue;
+      learn(dest, hop, rrep.hops + 1);
+      return (rrep.hops + 1);
+    }
+  }
+  return (EHOSTUNREACH);
+}
+
+int
+Wireless::Mesh::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  if (UNLIKELY(vec == NULL)) return (EINVAL);
+  if (UNLIKELY(dest == m_dev->device_address())) return (EINVAL);
+
+  // Discover route if not in the cache (before using the frame buffer)
+  if (dest != Driver::BROADCAST) {
+    int res = discover(dest);
+    if (res < 0) return (res);
+  }
+
+  // Gather the payload into the frame buffer
+  header_t* header = (header_t*) m_frame;
+  uint8_t* dp = m_frame + sizeof(header_t);
+  size_t len = 0;
+  for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+    if (UNLIKELY(len + vp->size > PAYLOAD_MAX)) return (EMSGSIZE);
+    memcpy(dp, vp->buf, vp->size);
+    dp += vp->size;
+    len += vp->size;
+  }
+  header->type = DATA;
+  header->src = m_dev->device_address();
+  header->dest = dest;
+  header->seq = ++m_seq;
+  header->hops = 0;
+  header->port = port;
+  size_t size = sizeof(header_t) + len;
+
+  // Broadcast is single hop and not acknowledged
+  if (dest == Driver::BROADCAST) {
+    int res = m_dev->send(dest, PORT, m_frame, size);
+    return (res < 0 ? res : (int) len);
+  }
+
+  // Transmit to the next hop
+  route_t* route = lookup(dest);
+  if (UNLIKELY(route == NULL)) return (EHOSTUNREACH);
+  int res = transmit(route->next, size);
+  return (res < 0 ? res : (int) len);
+}
+
+int
+Wireless::Mesh::recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+		     uint32_t ms)
+{
+  header_t* header = (header_t*) m_frame;
+  uint8_t addr = m_dev->device_address();
+  uint32_t start = RTT::millis();
+
+  while (1) {
+    // Receive next mesh frame within the time out period
+    uint32_t left = 0L;
+    if (ms != 0) {
+      uint32_t elapsed = RTT::since(start);
+      if (elapsed >= ms) return (ETIME);
+      left = ms - elapsed;
+    }
+    uint8_t hop;
+    uint8_t type;
+    int res = m_dev->recv(hop, type, m_frame, sizeof(m_frame), left);
+    if (res == ETIME) return (res);
+    if ((res < (int) sizeof(header_t)) || (type != PORT)) continue;
+    if (header->src == addr) continue;
+    size_t size = res;
+
+    switch (header->type) {
+    case DATA:
+      // Broadcast is delivered directly; unicast is acknowledged
+      if (header->dest != Driver::BROADCAST) {
+	if (m_dev->is_broadcast()) continue;
+	acknowledge(hop, header);
+      }
+      if (is_duplicate(header)) continue;
+      learn(header->src, hop, header->hops + 1);
+      if (header->dest == addr || header->dest == Driver::BROADCAST) {
+	size_t count = size - sizeof(header_t);
+	if (UNLIKELY(count > len)) return (EMSGSIZE);
+	memcpy(buf, m_frame + sizeof(header_t), count);
+	src = header->src;
+	port = header->port;
+	return (count);
+      }
+      forward(size);
+      continue;
+
+    case RREQ:
+      // Learn reverse route. Reply if this is the destination
+      // otherwise rebroadcast (once) after an address based delay
+      if (is_duplicate(header)) continue;
+      learn(header->src, hop, header->hops + 1);
+      if (header->dest == addr) {
+	header->type = RREP;
+	header->dest = header->src;
+	header->src = addr;
+	header->seq = ++m_seq;
+	header->hops = 0;
+	transmit(hop, sizeof(header_t));
+	continue;
+      }
+      if (header->hops + 1 >= HOPS_MAX) continue;
+      header->hops += 1;
+      delay(JITTER * (1 + (addr & 0x0f)));
+      m_dev->send(Driver::BROADCAST, PORT, m_frame, sizeof(header_t));
+      continue;
+
+    case RREP:
+      // Learn forward route and pass the reply towards the originator
+      if (m_dev->is_broadcast()) continue;
+      acknowledge(hop, header);
+      if (is_duplicate(header)) continue;
+      learn(header->src, hop, header->hops + 1);
+      if (header->dest != addr) forward(sizeof(header_t));
+      continue;
+
+    default:
+      continue;
+    }
+  }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file Cosa/Wireless_Stream.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless_Stream.hh"
+#include "Cosa/RTT.hh"
+
+void
+Wireless::Stream::Timer::restart()
+{
+  cancel();
+  m_scheduler = RTT::scheduler();
+  m_stream->m_expired = false;
+  expire_at(time());
+  expire_after(RETRANSMIT_TIMEOUT);
+  start();
+}
+
+int
+Wireless::Stream::transmit(uint8_t seq)
+{
+  uint8_t ix = seq % WINDOW_MAX;
+  header_t header;
+  header.type = DATA;
+  header.seq = seq;
+  iovec_t vec[3];
+  iovec_t* vp = vec;
+  iovec_arg(vp, &header, sizeof(header));
+  iovec_arg(vp, m_tx[ix], m_tx_len[ix]);
+  iovec_end(vp);
+  return (m_dev->send(m_dest, m_port, vec));
+}
+
+void
+Wireless::Stream::acknowledge()
+{
+  header_t header;
+  header.type = ACK;
+  header.seq = m_expect;
+  m_dev->send(m_dest, m_port, &header, sizeof(header));
+}
+
+int
+Wireless::Stream::commit()
+{
+  // Wait for room in the transmit window
+  while (outstanding() == WINDOW_MAX) {
+    int res = service();
+    if (res < 0) return (res);
+  }
+
+  // Transmit the frame and start the timer if first outstanding
+  m_tx_len[m_next % WINDOW_MAX] = m_fill;
+  transmit(m_next);
+  if (outstanding() == 0) m_timer.restart();
+  m_next += 1;
+  m_fill = 0;
+  return (0);
+}
+
+int
+Wireless::Stream::service(uint32_t ms)
+{
+  // Receive and handle frame from the destination
+  uint8_t src;
+  uint8_t port;
+  int res = m_dev->recv(src, port, m_frame, sizeof(m_frame), ms);
+  if ((res >= (int) sizeof(header_t)) && (src == m_dest) && (port == m_port)) {
+    header_t* header = (header_t*) m_frame;
+
+    // Cumulative acknowledgement; advance the window
+    if (header->type == ACK) {
+      uint8_t count = header->seq - m_base;
+      if ((count != 0) && (count <= outstanding())) {
+	m_base = header->seq;
+	m_retry = 0;
+	if (outstanding() == 0)
+	  m_timer.cancel();
+	else
+	  m_timer.restart();
+      }
+    }
+
+    // Data; deliver in order if there is room. Always acknowledge
+    else if (header->type == DATA) {
+      size_t len = res - sizeof(header_t);
+      if ((header->seq == m_expect) && ((size_t) m_rx.room() >= len)) {
+	m_rx.write(m_frame + sizeof(header_t), len);
+	m_expect += 1;
+      }
+      acknowledge();
+    }
+  }
+
+  // Retransmit outstanding frames on timeout (go-back-N)
+  if (!m_expired) return (0);
+  m_expired = false;
+  if (outstanding() == 0) return (0);
+  if (++m_retry > RETRY_MAX) {
+    m_retry = 0;
+    m_timer.restart();
+    return (ETIME);
+  }
+  for (uint8_t seq = m_base; seq != m_next; seq++) transmit(seq);
+  m_timer.restart();
+  return (0);
+}
+
+int
+Wireless::Stream::available()
+{
+  if (m_rx.available() == 0) service();
+  return (m_rx.available());
+}
+
+int
+Wireless::Stream::room()
+{
+  return ((WINDOW_MAX - outstanding()) * PAYLOAD_MAX - m_fill);
+}
+
+int
+Wireless::Stream::putchar(char c)
+{
+  // Commit a full frame that could not be transmitted earlier
+  if ((m_fill == PAYLOAD_MAX) && (commit() < 0)) return (IOStream::EOF);
+  m_tx[m_next % WINDOW_MAX][m_fill++] = c;
+  if (m_fill == PAYLOAD_MAX) commit();
+  return (c & 0xff);
+}
+
+int
+Wireless::Stream::write(const void* buf, size_t size)
+{
+  const uint8_t* bp = (const uint8_t*) buf;
+  size_t n = 0;
+  while (n < size) {
+    if ((m_fill == PAYLOAD_MAX) && (commit() < 0)) break;
+    size_t count = PAYLOAD_MAX - m_fill;
+    if (count > size - n) count = size - n;
+    memcpy(&m_tx[m_next % WINDOW_MAX][m_fill], bp, count);
+    m_fill += count;
+    bp += count;
+    n += count;
+  }
+  if (m_fill == PAYLOAD_MAX) commit();
+  return (n);
+}
+
+int
+Wireless::Stream::getchar()
+{
+  if (m_rx.is_empty()) service();
+  return (m_rx.getchar());
+}
+
+int
+Wireless::Stream::flush()
+{
+  if (m_fill != 0) {
+    int res = commit();
+    if (res < 0) return (res);
+  }
+  while (outstanding() != 0) {
+    int res = service();
+    if (res < 0) return (res);
+  }
+  return (0);
+}
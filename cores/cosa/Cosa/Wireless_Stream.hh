@@ -0,0 +1,300 @@
+/**
+ * @file Cosa/Wireless_Stream.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_WIRELESS_STREAM_HH
+#define COSA_WIRELESS_STREAM_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Wireless.hh"
+#include "Cosa/IOStream.hh"
+#include "Cosa/IOBuffer.hh"
+#include "Cosa/Job.hh"
+
+/**
+ * Wireless stream frame size. Should be at most the max payload of
+ * the wireless device driver. Default is 30 bytes.
+ */
+#ifndef COSA_WIRELESS_STREAM_FRAME_MAX
+#define COSA_WIRELESS_STREAM_FRAME_MAX 30
+#endif
+
+/**
+ * Wireless stream transmit window size (frames). Default is 4.
+ */
+#ifndef COSA_WIRELESS_STREAM_WINDOW_MAX
+#define COSA_WIRELESS_STREAM_WINDOW_MAX 4
+#endif
+
+/**
+ * Wireless stream receive buffer size (bytes, power of 2). Default
+ * is 64.
+ */
+#ifndef COSA_WIRELESS_STREAM_RX_MAX
+#define COSA_WIRELESS_STREAM_RX_MAX 64
+#endif
+
+/**
+ * Reliable IOStream device over Wireless connection. Output is
+ * fragmented into frames of max PAYLOAD_MAX bytes and transmitted
+ * with a sliding window of WINDOW_MAX frames. The receiver delivers
+ * frames in order and acknowledges with the next expected sequence
+ * number (cumulative acknowledgement). Unacknowledged frames are
+ * retransmitted (go-back-N) when the retransmit timer, a job on the
+ * RTT::Scheduler, expires. Frames that do not fit in the receive
+ * buffer are not acknowledged; the sender will retransmit (flow
+ * control). Both ends must use the same port and address each other.
+ * @code
+ * RTT::Scheduler scheduler;
+ * NRF24L01P rf(NETWORK, DEVICE);
+ * Wireless::Stream ios(&rf, DEST);
+ * ...
+ * trace.begin(&ios);
+ * trace << PSTR("Hello World") << endl << flush;
+ * @endcode
+ * @section Limitations
+ * Requires an RTT::Scheduler for the retransmit timer. Messages from
+ * other sources or ports are dropped while the device is serviced.
+ */
+class Wireless::Stream : public IOStream::Device {
+public:
+  /** Max size of frame header. */
+  static const uint8_t HEADER_MAX = 2;
+
+  /** Max size of frame payload. */
+  static const uint8_t PAYLOAD_MAX =
+    COSA_WIRELESS_STREAM_FRAME_MAX - HEADER_MAX;
+
+  /** Transmit window size (frames). */
+  static const uint8_t WINDOW_MAX = COSA_WIRELESS_STREAM_WINDOW_MAX;
+
+  /** Retransmit timeout (us). */
+  static const uint32_t RETRANSMIT_TIMEOUT = 100000UL;
+
+  /** Max number of retransmits without progress. */
+  static const uint8_t RETRY_MAX = 8;
+
+  /** Receive poll period (ms). */
+  static const uint8_t POLL_MS = 1;
+
+  /**
+   * Construct reliable Wireless stream to the given destination.
+   * @param[in] dev wireless device driver.
+   * @param[in] dest destination device address.
+   * @param[in] port message type (Default 0x00).
+   */
+  Stream(Driver* dev, uint8_t dest, uint8_t port = 0x00) :
+    IOStream::Device(),
+    m_dev(dev),
+    m_dest(dest),
+    m_port(port),
+    m_base(0),
+    m_next(0),
+    m_fill(0),
+    m_retry(0),
+    m_expect(0),
+    m_expired(false),
+    m_timer(this)
+  {}
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes available in receive buffer. Services the device
+   * if the buffer is empty.
+   * @return bytes.
+   */
+  virtual int available();
+
+  /**
+   * @override{IOStream::Device}
+   * Number of bytes room in transmit window.
+   * @return bytes.
+   */
+  virtual int room();
+
+  /**
+   * @override{IOStream::Device}
+   * Write character to transmit window. The frame is transmitted
+   * when full. Waits for acknowledgement if the window is full.
+   * Returns character if successful otherwise EOF(-1).
+   * @param[in] c character to write.
+   * @return character written or EOF(-1).
+   */
+  virtual int putchar(char c);
+
+  /**
+   * @override{IOStream::Device}
+   * Write data from buffer with given size to transmit window.
+   * @param[in] buf buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes written or EOF(-1).
+   */
+  virtual int write(const void* buf, size_t size);
+
+  /**
+   * @override{IOStream::Device}
+   * Read character from receive buffer. Services the device if the
+   * buffer is empty. Returns character or EOF(-1).
+   * @return character or EOF(-1).
+   */
+  virtual int getchar();
+
+  /**
+   * @override{IOStream::Device}
+   * Transmit the current frame and wait for all frames to be
+   * acknowledged. Returns zero(0) or negative error code (ETIME).
+   * @return zero(0) or negative error code.
+   */
+  virtual int flush();
+
+  /**
+   * Receive and handle a frame (data or acknowledgement), and
+   * retransmit the window on timeout. Should be called when the
+   * device is idle to acknowledge incoming data. Returns zero(0) or
+   * negative error code; ETIME if the number of retransmits without
+   * progress exceeds RETRY_MAX.
+   * @param[in] ms receive time out period (default POLL_MS).
+   * @return zero(0) or negative error code.
+   */
+  int service(uint32_t ms = POLL_MS);
+
+protected:
+  /** Frame types. */
+  enum {
+    DATA = 0,			//!< Data frame with sequence number.
+    ACK = 1			//!< Next expected sequence number.
+  };
+
+  /** Frame header. */
+  struct header_t {
+    uint8_t type;		//!< Frame type.
+    uint8_t seq;		//!< Sequence number.
+  };
+
+  /**
+   * Retransmit timer; signals the stream on expire.
+   */
+  class Timer : public Job {
+  public:
+    /**
+     * Construct retransmit timer for given stream.
+     * @param[in] stream to signal.
+     */
+    Timer(Stream* stream) :
+      Job(NULL),
+      m_stream(stream)
+    {}
+
+    /**
+     * Restart timer with RETRANSMIT_TIMEOUT on the RTT scheduler.
+     */
+    void restart();
+
+    /**
+     * Stop timer if started.
+     */
+    void cancel()
+    {
+      if (is_started()) stop();
+    }
+
+    /**
+     * @override{Job}
+     * Signal the stream that the timer has expired. Called from
+     * the RTT interrupt handler.
+     */
+    virtual void on_expired()
+    {
+      m_stream->m_expired = true;
+    }
+
+  protected:
+    /** Stream to signal. */
+    Stream* m_stream;
+  };
+
+  /** Device driver. */
+  Driver* m_dev;
+
+  /** Destination device address. */
+  uint8_t m_dest;
+
+  /** Message type (port). */
+  uint8_t m_port;
+
+  /** Sequence number of oldest unacknowledged frame. */
+  uint8_t m_base;
+
+  /** Sequence number of the frame being filled. */
+  uint8_t m_next;
+
+  /** Number of bytes in the frame being filled. */
+  uint8_t m_fill;
+
+  /** Number of retransmits without progress. */
+  uint8_t m_retry;
+
+  /** Next expected receive sequence number. */
+  uint8_t m_expect;
+
+  /** Retransmit timer expired. Set by timer. */
+  volatile bool m_expired;
+
+  /** Retransmit timer. */
+  Timer m_timer;
+
+  /** Transmit window; frame payload and length. */
+  uint8_t m_tx[WINDOW_MAX][PAYLOAD_MAX];
+  uint8_t m_tx_len[WINDOW_MAX];
+
+  /** Receive frame buffer. */
+  uint8_t m_frame[COSA_WIRELESS_STREAM_FRAME_MAX];
+
+  /** Receive buffer; in order data. */
+  IOBuffer<COSA_WIRELESS_STREAM_RX_MAX> m_rx;
+
+  /**
+   * Return number of outstanding (unacknowledged) frames.
+   * @return frames.
+   */
+  uint8_t outstanding() const
+  {
+    return (m_next - m_base);
+  }
+
+  /**
+   * Transmit the frame with given sequence number.
+   * @param[in] seq sequence number.
+   * @return number of bytes sent or negative error code.
+   */
+  int transmit(uint8_t seq);
+
+  /**
+   * Transmit the frame being filled and advance. Waits for room in
+   * the transmit window. Returns zero(0) or negative error code.
+   * @return zero(0) or negative error code.
+   */
+  int commit();
+
+  /**
+   * Send acknowledgement with the next expected sequence number.
+   */
+  void acknowledge();
+};
+#endif
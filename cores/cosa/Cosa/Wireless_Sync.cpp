@@ -0,0 +1,118 @@
+/**
+ * @file Cosa/Wireless_Sync.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless.hh"
+#include "Cosa/RTT.hh"
+
+int
+Wireless::Sync::beacon()
+{
+  beacon_t beacon;
+  synchronized {
+    beacon.us = RTT::micros64();
+    if (m_clock != NULL) {
+      beacon.sec = m_clock->time();
+      beacon.ms = m_clock->msec();
+    }
+    else {
+      beacon.sec = 0L;
+      beacon.ms = 0;
+    }
+  }
+  beacon.seq = ++m_seq;
+  return (m_dev->broadcast(PORT, &beacon, sizeof(beacon)));
+}
+
+bool
+Wireless::Sync::update(const void* buf, size_t len, uint32_t stamp)
+{
+  if (UNLIKELY(len != sizeof(beacon_t))) return (false);
+  const beacon_t* beacon = (const beacon_t*) buf;
+
+  // Local receive time (48-bit) from the receive time stamp (32-bit)
+  uint64_t now = RTT::micros64();
+  uint32_t elapsed = (uint32_t) now - stamp;
+  uint64_t rx = now - elapsed;
+  int64_t offset = (int64_t) (beacon->us + m_latency - rx);
+
+  // Estimate skew from the change of offset since the latest beacon.
+  // Skip if the beacons are too far apart or the master was restarted
+  if (m_sync) {
+    uint64_t dt = rx - m_ref;
+    int64_t doff = offset - m_offset;
+    if ((dt != 0) && (dt < 0x80000000ULL)
+	&& (doff > -(int64_t) (dt >> 8)) && (doff < (int64_t) (dt >> 8))) {
+      int32_t skew = (doff << SKEW_BITS) / (int32_t) dt;
+      if (skew > SKEW_MAX) skew = SKEW_MAX;
+      else if (skew < -SKEW_MAX) skew = -SKEW_MAX;
+      m_skew += (skew - m_skew) / 4;
+    }
+  }
+  m_ref = rx;
+  m_offset = offset;
+  m_seq = beacon->seq;
+  m_sync = true;
+
+  // Set the wall-clock; beacon time with latency and time since receive
+  if (m_clock != NULL) {
+    uint32_t ms = beacon->ms + (m_latency + elapsed) / 1000;
+    m_clock->time(beacon->sec + (ms / 1000), ms % 1000);
+  }
+  return (true);
+}
+
+uint64_t
+Wireless::Sync::micros64()
+{
+  uint64_t now = RTT::micros64();
+  if (!m_sync || is_master()) return (now);
+  int64_t dt = now - m_ref;
+  return (now + m_offset + ((dt * m_skew) >> SKEW_BITS));
+}
+
+uint32_t
+Wireless::Sync::local(uint64_t us)
+{
+  if (!m_sync || is_master()) return ((uint32_t) us);
+  int64_t dt = us - m_offset - m_ref;
+  return ((uint32_t) (m_ref + dt - ((dt * m_skew) >> SKEW_BITS)));
+}
+
+int
+Wireless::Sync::recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+		     uint32_t ms)
+{
+  uint32_t start = RTT::millis();
+  while (1) {
+    uint32_t left = 0L;
+    if (ms != 0) {
+      uint32_t elapsed = RTT::since(start);
+      if (elapsed >= ms) return (ETIME);
+      left = ms - elapsed;
+    }
+
+    // Receive message; handle beacons from the master
+    int res = m_dev->recv(src, port, buf, len, left);
+    if ((res < 0) || (port != PORT) || is_master()) return (res);
+    uint32_t stamp = m_dev->timestamp();
+    if (stamp == 0L) stamp = RTT::micros();
+    if (src == m_master) update(buf, res, stamp);
+  }
+}
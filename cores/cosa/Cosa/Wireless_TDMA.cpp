@@ -0,0 +1,194 @@
+/**
+ * @file Cosa/Wireless_TDMA.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Wireless.hh"
+#include "Cosa/RTT.hh"
+
+void
+Wireless::TDMA::wait(uint32_t ms)
+{
+  uint32_t elapsed = RTT::since(m_start);
+  if (elapsed >= ms) return;
+
+  // Power down the device if the wait is longer than the wakeup time
+  uint32_t left = ms - elapsed;
+  if (left > WAKEUP_MS) {
+    m_dev->powerdown();
+    delay(left - WAKEUP_MS);
+    m_dev->powerup();
+  }
+  while (RTT::since(m_start) < ms) yield();
+}
+
+void
+Wireless::TDMA::beacon()
+{
+  beacon_t beacon;
+  m_start = RTT::millis();
+  m_sync = true;
+  m_slot = 0;
+  beacon.type = BEACON;
+  beacon.seq = ++m_seq;
+  beacon.slot_ms = m_slot_ms;
+  memcpy(beacon.table, m_table, sizeof(beacon.table));
+  m_dev->send(Driver::BROADCAST, PORT, &beacon, sizeof(beacon));
+}
+
+void
+Wireless::TDMA::update(const beacon_t* beacon)
+{
+  uint8_t addr = m_dev->device_address();
+  m_start = RTT::millis();
+  m_sync = true;
+  m_seq = beacon->seq;
+  m_slot_ms = beacon->slot_ms;
+  m_slot = -1;
+  for (uint8_t i = 0; i < SLOT_MAX; i++) {
+    if (beacon->table[i] != addr) continue;
+    m_slot = i + 1;
+    break;
+  }
+}
+
+int
+Wireless::TDMA::sync(uint32_t ms)
+{
+  // The coordinator is synchronized with the first beacon
+  if (is_coordinator()) {
+    if (!m_sync) beacon();
+    return (0);
+  }
+
+  // Wake up just before the next beacon is expected
+  if (m_sync && (RTT::since(m_start) < frame_period()))
+    wait(frame_period() - GUARD_MS);
+
+  // Receive the beacon within the time out period
+  uint32_t start = RTT::millis();
+  beacon_t beacon;
+  while (1) {
+    uint32_t left = 0L;
+    if (ms != 0) {
+      uint32_t elapsed = RTT::since(start);
+      if (elapsed >= ms) {
+	m_sync = false;
+	return (ETIME);
+      }
+      left = ms - elapsed;
+    }
+    uint8_t src;
+    uint8_t port;
+    int res = m_dev->recv(src, port, &beacon, sizeof(beacon), left);
+    if ((res == sizeof(beacon))
+	&& (port == PORT)
+	&& (src == m_coordinator)
+	&& (beacon.type == BEACON))
+      break;
+  }
+  update(&beacon);
+  if (m_slot > 0) return (m_slot);
+
+  // Request a slot in the contention slot. Offset by device address
+  // to reduce the risk of collision between requests
+  uint8_t addr = m_dev->device_address();
+  uint8_t offset = 0;
+  if (m_slot_ms > 2 * GUARD_MS) offset = addr % (m_slot_ms - 2 * GUARD_MS);
+  wait((SLOT_MAX + 1) * m_slot_ms + GUARD_MS + offset);
+  uint8_t type = REQUEST;
+  m_dev->send(m_coordinator, PORT, &type, sizeof(type));
+  return (ENOTCONN);
+}
+
+int
+Wireless::TDMA::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Coordinator; send in slot zero. Start a new frame if passed
+  if (is_coordinator()) {
+    if (!m_sync || (RTT::since(m_start) + GUARD_MS >= m_slot_ms)) {
+      if (m_sync) wait(frame_period());
+      beacon();
+    }
+    return (m_dev->send(dest, port, vec));
+  }
+
+  // Node; resynchronize if the slot in the current frame has passed
+  if (!m_sync || m_slot < 0) return (ENOTCONN);
+  uint16_t slot_start = m_slot * m_slot_ms + GUARD_MS;
+  uint16_t slot_end = (m_slot + 1) * m_slot_ms - GUARD_MS;
+  if (RTT::since(m_start) >= slot_end) {
+    int res = sync(frame_period() + m_slot_ms);
+    if (res < 0) return (res);
+  }
+
+  // Sleep until the start of the slot and transmit
+  wait(slot_start);
+  return (m_dev->send(dest, port, vec));
+}
+
+int
+Wireless::TDMA::recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
+		     uint32_t ms)
+{
+  uint32_t start = RTT::millis();
+  while (1) {
+    uint32_t left = 0L;
+    if (ms != 0) {
+      uint32_t elapsed = RTT::since(start);
+      if (elapsed >= ms) return (ETIME);
+      left = ms - elapsed;
+    }
+
+    // Coordinator; transmit beacon at start of frame and limit the
+    // receive time out to the end of the frame
+    if (is_coordinator()) {
+      uint32_t elapsed = RTT::since(m_start);
+      if (!m_sync || elapsed >= frame_period()) {
+	beacon();
+	elapsed = 0;
+      }
+      uint32_t remains = frame_period() - elapsed;
+      if ((left == 0) || (remains < left)) left = remains;
+    }
+
+    // Receive message; handle beacons and slot requests
+    int res = m_dev->recv(src, port, buf, len, left);
+    if (res == ETIME) continue;
+    if ((res < 0) || (port != PORT)) return (res);
+    if (res == 0) continue;
+    uint8_t type = *((uint8_t*) buf);
+    if (is_coordinator()) {
+      if (type != REQUEST) continue;
+      uint8_t* entry = NULL;
+      for (uint8_t i = 0; i < SLOT_MAX; i++) {
+	if (m_table[i] == src) {
+	  entry = NULL;
+	  break;
+	}
+	if ((entry == NULL) && (m_table[i] == 0)) entry = &m_table[i];
+      }
+      if (entry != NULL) *entry = src;
+    }
+    else if ((type == BEACON)
+	     && (src == m_coordinator)
+	     && (res == sizeof(beacon_t))) {
+      update((const beacon_t*) buf);
+    }
+  }
+}
@@ -26,6 +26,44 @@
 #include <avr/interrupt.h>
 #include "Cosa/CPU.hh"
 #include "Cosa/Power.hh"
+#include "Cosa/ProbeChannel.hh"
+#include "Cosa/Boot.hh"
+#include "Cosa/RTT.hh"
+
+#if defined(COSA_XMEM)
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * External memory section (xmem) boundaries; defined by the linker
+ * when the section is used otherwise NULL.
+ */
+extern char __start_xmem[] __attribute__((weak));
+extern char __stop_xmem[] __attribute__((weak));
+
+/**
+ * Enable the external memory interface before the data and bss
+ * sections are initiated.
+ */
+void __xmem_init() __attribute__((naked, used, section(".init3")));
+void __xmem_init()
+{
+  Board::xmem_init();
+}
+
+/**
+ * Zero the external memory section and place the heap after it; the
+ * heap uses the remaining external memory.
+ */
+void __xmem_heap() __attribute__((naked, used, section(".init5")));
+void __xmem_heap()
+{
+  memset(__start_xmem, 0, __stop_xmem - __start_xmem);
+  __malloc_heap_start = (__stop_xmem != __start_xmem) ?
+    __stop_xmem : (char*) Board::XMEM_START;
+  __malloc_heap_end = (char*) Board::XMEM_END;
+}
+#endif
 
 /**
  * The init function; minimum setup of hardware after the bootloader.
@@ -34,6 +72,12 @@
 void init() __attribute__((weak));
 void init()
 {
+  // Start the boot profile time base
+#if defined(COSA_BOOT_PROFILE)
+  RTT::begin();
+  BOOT_STAGE("reset");
+#endif
+
   // Adjust frequency scaling on Teensy; default is no scaling on Cosa
 #if defined(PJRC_TEENSY_2_0) || defined(PJRC_TEENSYPP_2_0)
   CPU::clock_prescale(0);
@@ -73,9 +117,14 @@ void init()
   // Allow the board to set ports in a safe state. Typically chip
   // select pins to board devices
   Board::init();
+  BOOT_STAGE("board");
+
+  // Logic analyzer probe channels to output mode (when enabled)
+  PROBE_CHANNEL_BEGIN();
 
   // Allow interrupts from here on
   sei();
+  BOOT_STAGE("init");
 }
 
 /**
@@ -103,6 +152,7 @@ int main(void)
 {
   init();
   setup();
+  BOOT_STAGE("setup");
   while (1) loop();
   return (0);
 }
@@ -0,0 +1,105 @@
+/**
+ * @file CosaAnalyzerProbe.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Logic Analyzer based analysis of the core with the probe channels.
+ * The library must be built with COSA_PROBE_CHANNEL defined (see
+ * Cosa.h). A periodic job sends an event; the job dispatch, event
+ * dispatch, RTT interrupt and the user work are shown on the probe
+ * channels.
+ *
+ * @section Circuit
+ * Trigger on CHAN0/JOB rising. Default channel pins on Uno.
+ *
+ * +-------+
+ * | CHAN0 |-------------------------------> A1 (JOB)
+ * | CHAN1 |-------------------------------> A0 (EVENT)
+ * | CHAN2 |-------------------------------> A2 (ISR)
+ * | CHAN3 |-------------------------------> D6 (USER)
+ * |       |
+ * | GND   |-------------------------------> GND
+ * +-------+
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Periodic.hh"
+#include "Cosa/ProbeChannel.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+class Worker : public Event::Handler {
+public:
+  // Some work in the event handler; marked on the user channel
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(type);
+    PROBE_SCOPE(USER);
+    DELAY(value);
+  }
+};
+
+class Sender : public Periodic {
+public:
+  Sender(Job::Scheduler* scheduler, Worker* worker) :
+    Periodic(scheduler, 10000UL),
+    m_worker(worker),
+    m_work(10)
+  {}
+
+  // Send an event every 10 ms with increasing work to the worker
+  virtual void run()
+  {
+    Event::push(Event::USER_TYPE, m_worker, m_work);
+    m_work += 10;
+    if (m_work > 1000) m_work = 10;
+  }
+
+private:
+  Worker* m_worker;
+  uint16_t m_work;
+};
+
+RTT::Scheduler scheduler;
+Worker worker;
+Sender sender(&scheduler, &worker);
+
+void setup()
+{
+  // Print Info about the logic analyser probe channels
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaAnalyzerProbe: started"));
+#if defined(COSA_PROBE_CHANNEL)
+  trace << PSTR("CHAN0 - JOB [^]") << endl;
+  trace << PSTR("CHAN1 - EVENT") << endl;
+  trace << PSTR("CHAN2 - ISR") << endl;
+  trace << PSTR("CHAN3 - USER") << endl;
+#else
+  trace << PSTR("COSA_PROBE_CHANNEL is not defined") << endl;
+#endif
+  trace.flush();
+
+  // Start the periodic sender
+  RTT::begin();
+  sender.start();
+}
+
+void loop()
+{
+  Event::service();
+}
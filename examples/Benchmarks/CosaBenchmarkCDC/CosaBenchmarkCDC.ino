@@ -0,0 +1,81 @@
+/**
+ * @file CosaBenchmarkCDC.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa USB CDC bulk transfer benchmark. Measures the transmit
+ * throughput (Kbyte per second) for blocks of different sizes written
+ * with CDC::write and flushed with CDC::flush (short or zero length
+ * packet). Run with a terminal program on the host that discards or
+ * counts the received data, e.g. "cat /dev/ttyACM0 > /dev/null".
+ *
+ * @section Circuit
+ * Requires an ATmega32U4 based board (Leonardo, Micro, Pro Micro).
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/CDC.hh"
+
+#if !defined(USBCON)
+#error "CosaBenchmarkCDC: board does not support USB CDC"
+#endif
+
+// Total number of bytes per measurement
+static const uint32_t TOTAL = 65536UL;
+
+// Block of data to write
+static char block[256];
+
+void measure(size_t size)
+{
+  uint16_t count = TOTAL / size;
+  uint32_t start = RTT::millis();
+  for (uint16_t i = 0; i < count; i++)
+    cdc.write(block, size);
+  cdc.flush();
+  uint32_t ms = RTT::millis() - start;
+  trace << endl << PSTR("block:") << size
+	<< PSTR(", bytes:") << TOTAL
+	<< PSTR(", ms:") << ms
+	<< PSTR(", Kbyte/s:") << (ms ? (TOTAL / ms) : 0)
+	<< endl;
+}
+
+void setup()
+{
+  cdc.begin(9600);
+  trace.begin(&cdc, PSTR("CosaBenchmarkCDC: started"));
+  Watchdog::begin();
+  RTT::begin();
+  memset(block, '.', sizeof(block));
+  block[sizeof(block) - 1] = '\n';
+}
+
+void loop()
+{
+  // Measure with single character, partial and full packets
+  measure(1);
+  measure(16);
+  measure(63);
+  measure(64);
+  measure(128);
+  measure(256);
+  sleep(5);
+}
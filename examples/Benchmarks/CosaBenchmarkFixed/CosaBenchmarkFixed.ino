@@ -0,0 +1,97 @@
+/**
+ * @file CosaBenchmarkFixed.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Fixed-point Benchmark; compare fixed-point functions with
+ * floating point and integer division; 1) product, 2) division and
+ * reciprocal, 3) square root, 4) sine, and 5) arc tangent.
+ *
+ * @section Circuit
+ * This example requires no special circuit. Uses serial output,
+ * internal timer for RTC and watchdog.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Fixed.hh"
+#include "Cosa/Math.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Benchmark operands; volatile to avoid constant folding
+volatile int16_t x = 12345;
+volatile int16_t y = -5432;
+volatile uint16_t d = 555;
+volatile uint32_t v = 123456789UL;
+volatile float fx = 0.37675;
+volatile float fy = -0.16577;
+volatile int32_t res;
+volatile float fres;
+
+void setup()
+{
+  // Start the UART and trace output stream
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaBenchmarkFixed: started"));
+
+  // Give some startup info
+  TRACE(F_CPU);
+  TRACE(I_CPU);
+
+  // Start the watchdog and real-time clock
+  Watchdog::begin();
+  RTT::begin();
+
+  // Verify some results
+  TRACE(Fixed::mul((q15_t) x, (q15_t) y));
+  TRACE(Fixed::recip(d));
+  TRACE(Fixed::sqrt32(v));
+  TRACE(Fixed::sin(0x2000));
+  TRACE(Fixed::atan2(y, x));
+  trace << endl;
+
+  // Product
+  MEASURE("float mul: ", 1000) fres = fx * fy;
+  MEASURE("Q15 mul: ", 1000) res = Fixed::mul((q15_t) x, (q15_t) y);
+  MEASURE("Q8.8 mul: ", 1000) res = Fixed::mul<8>(x, y);
+  MEASURE("saturated add: ", 1000) res = Fixed::add(x, y);
+
+  // Division by variable and constant
+  MEASURE("uint32_t div: ", 1000) res = (x * 100UL) / d;
+  MEASURE("uint16_t div: ", 1000) res = ((uint16_t) x) / d;
+  MEASURE("reciprocal: ", 1000) res = Fixed::recip(d);
+  MEASURE("reciprocal mul: ", 1000) res = Fixed::umulhi(x, Fixed::recip(d));
+  MEASURE("scale mul: ", 1000) res = Fixed::umulhi(x, 11808);
+
+  // Square root
+  MEASURE("float sqrt: ", 1000) fres = sqrt(fx);
+  MEASURE("sqrt16: ", 1000) res = Fixed::sqrt16(x);
+  MEASURE("sqrt32: ", 1000) res = Fixed::sqrt32(v);
+
+  // Trigonometric functions
+  MEASURE("float sin: ", 1000) fres = sin(fx);
+  MEASURE("Q15 sin: ", 1000) res = Fixed::sin(x);
+  MEASURE("float atan2: ", 1000) fres = atan2(fy, fx);
+  MEASURE("atan2: ", 1000) res = Fixed::atan2(y, x);
+}
+
+void loop()
+{
+  ASSERT(true == false);
+}
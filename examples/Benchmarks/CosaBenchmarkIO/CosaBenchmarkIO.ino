@@ -0,0 +1,366 @@
+/**
+ * @file CosaBenchmarkIO.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa I/O throughput benchmarks with machine-readable (CSV) output;
+ * throughput (KB/s) and latency percentiles per operation (see
+ * Cosa/Benchmark.hh, Benchmark::Throughput):
+ * 1) Raw SPI::transfer with all clock dividers.
+ * 2) SD single-block and multi-block read and write.
+ * 3) FAT16 file sequential and random read and write.
+ * 4) CFFS file write and read (S25FL127S or W25X40CL).
+ * 5) S25FL127S/W25X40CL page program and read.
+ * 6) TWI register burst read at 100 and 400 KHz.
+ * 7) W5100 (frame per byte) and W5200 (burst) socket buffer memory
+ *    write and read; RAM and program memory source.
+ * Select the benchmarks with the USE_ defines below. The SD and flash
+ * data is overwritten.
+ *
+ * @section Circuit
+ * SD card on SPI with chip select D10, flash on SPI with default chip
+ * select, TWI device with register address 0 at TWI_ADDR, W5100 or
+ * W5200 Ethernet controller with chip select D10 (not together with
+ * the SD card).
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#define USE_SPI
+// #define USE_SD
+// #define USE_FAT16
+// #define USE_CFFS
+// #define USE_FLASH
+// #define USE_TWI
+// #define USE_W5100
+// #define USE_W5200
+
+// #define USE_S25FL127S
+#define USE_W25X40CL
+
+#include "Cosa/Benchmark.hh"
+#include "Cosa/SPI.hh"
+#include "Cosa/TWI.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+#if defined(USE_SD) || defined(USE_FAT16)
+#include <SD.h>
+#include <FAT16.h>
+SD sd(Board::D10);
+#endif
+
+#if defined(USE_CFFS) || defined(USE_FLASH)
+#include <CFFS.h>
+#if defined(USE_S25FL127S)
+#include <S25FL127S.h>
+S25FL127S flash;
+#else
+#include <W25X40CL.h>
+W25X40CL flash;
+#endif
+#endif
+
+#if defined(USE_W5100)
+#include <W5100.h>
+#define W5X00 W5100
+#define W5X00_OP(op) "W5100::" op
+#elif defined(USE_W5200)
+#include <W5200.h>
+#define W5X00 W5200
+#define W5X00_OP(op) "W5200::" op
+#endif
+
+// TWI device address for register burst read (e.g. DS1307/DS3231)
+#define TWI_ADDR 0x68
+
+// Operation buffer and latency samples
+static uint8_t buf[512];
+static uint16_t samples[32];
+Benchmark::Throughput io(samples, membersof(samples));
+
+// Measure block for all samples (ix) and print result
+#define MEASURE_IO(name,bytes)						\
+  for (uint8_t __i = 1;							\
+       __i != 0;							\
+       __i--, io.print(trace, PSTR(name), bytes))			\
+    for (uint8_t ix = 0; ix < membersof(samples); ix++)
+
+#if defined(USE_SPI)
+// SPI device without chip select effect; any unused pin
+class Raw : public SPI::Driver {
+public:
+  Raw() : SPI::Driver(Board::D9) {}
+
+  void benchmark(SPI::Clock rate, str_P name)
+  {
+    set_clock(rate);
+    for (uint8_t ix = 0; ix < membersof(samples); ix++) {
+      spi.acquire(this);
+      spi.begin();
+      io.start();
+      spi.transfer(buf, 256);
+      io.stop();
+      spi.end();
+      spi.release();
+    }
+    io.print(trace, name, 256);
+  }
+};
+
+Raw raw;
+
+void benchmark_spi()
+{
+  raw.benchmark(SPI::DIV2_CLOCK, PSTR("SPI::transfer(DIV2)"));
+  raw.benchmark(SPI::DIV4_CLOCK, PSTR("SPI::transfer(DIV4)"));
+  raw.benchmark(SPI::DIV8_CLOCK, PSTR("SPI::transfer(DIV8)"));
+  raw.benchmark(SPI::DIV16_CLOCK, PSTR("SPI::transfer(DIV16)"));
+  raw.benchmark(SPI::DIV32_CLOCK, PSTR("SPI::transfer(DIV32)"));
+  raw.benchmark(SPI::DIV64_CLOCK, PSTR("SPI::transfer(DIV64)"));
+  raw.benchmark(SPI::DIV128_CLOCK, PSTR("SPI::transfer(DIV128)"));
+}
+#endif
+
+#if defined(USE_SD)
+void benchmark_sd()
+{
+  const uint32_t BLOCK = 1000;
+  if (!sd.begin(SPI::DIV2_CLOCK)) return;
+  MEASURE_IO("SD::write", SD::BLOCK_MAX) {
+    io.start();
+    sd.write(BLOCK + ix, buf);
+    io.stop();
+  }
+  MEASURE_IO("SD::read", SD::BLOCK_MAX) {
+    io.start();
+    sd.read(BLOCK + ix, buf);
+    io.stop();
+  }
+  if (sd.begin_write(BLOCK, membersof(samples))) {
+    MEASURE_IO("SD::write_next", SD::BLOCK_MAX) {
+      io.start();
+      sd.write_next(buf);
+      io.stop();
+    }
+    sd.end_write();
+  }
+  if (sd.begin_read(BLOCK)) {
+    MEASURE_IO("SD::read_next", SD::BLOCK_MAX) {
+      io.start();
+      sd.read_next(buf);
+      io.stop();
+    }
+    sd.end_read();
+  }
+  sd.end();
+}
+#endif
+
+#if defined(USE_FAT16)
+void benchmark_fat16()
+{
+  const size_t SIZE = 128;
+  if (!sd.begin(SPI::DIV2_CLOCK) || !FAT16::begin(&sd)) return;
+  FAT16::File file;
+  if (!file.open("BENCH.DAT", O_WRITE | O_CREAT | O_TRUNC)) return;
+  MEASURE_IO("FAT16::File::write(seq)", SIZE) {
+    io.start();
+    file.write(buf, SIZE);
+    io.stop();
+  }
+  MEASURE_IO("FAT16::File::write(random)", SIZE) {
+    file.seek((uint32_t) (rand() % membersof(samples)) * SIZE);
+    io.start();
+    file.write(buf, SIZE);
+    io.stop();
+  }
+  file.close();
+  if (!file.open("BENCH.DAT", O_READ)) return;
+  MEASURE_IO("FAT16::File::read(seq)", SIZE) {
+    io.start();
+    file.read(buf, SIZE);
+    io.stop();
+  }
+  MEASURE_IO("FAT16::File::read(random)", SIZE) {
+    file.seek((uint32_t) (rand() % membersof(samples)) * SIZE);
+    io.start();
+    file.read(buf, SIZE);
+    io.stop();
+  }
+  file.close();
+  FAT16::rm("BENCH.DAT");
+  sd.end();
+}
+#endif
+
+#if defined(USE_CFFS)
+void benchmark_cffs()
+{
+  const size_t SIZE = 64;
+  if (!flash.begin() || !CFFS::begin(&flash)) return;
+  CFFS::File file;
+  if (file.open("bench", O_WRITE | O_CREAT | O_TRUNC) < 0) return;
+  MEASURE_IO("CFFS::File::write", SIZE) {
+    io.start();
+    file.write(buf, SIZE);
+    io.stop();
+  }
+  file.close();
+  if (file.open("bench", O_READ) < 0) return;
+  MEASURE_IO("CFFS::File::read", SIZE) {
+    io.start();
+    file.read(buf, SIZE);
+    io.stop();
+  }
+  file.close();
+  CFFS::rm("bench");
+}
+#endif
+
+#if defined(USE_FLASH)
+void benchmark_flash()
+{
+  const size_t PAGE = 256;
+  const uint32_t SECTOR = flash.SECTOR_BYTES * 8;
+  if (!flash.begin()) return;
+  flash.erase(SECTOR);
+  flash.erase(SECTOR + flash.SECTOR_BYTES);
+  MEASURE_IO("Flash::write(page)", PAGE) {
+    io.start();
+    flash.write(SECTOR + ix * PAGE, buf, PAGE);
+    io.stop();
+  }
+  MEASURE_IO("Flash::read(page)", PAGE) {
+    io.start();
+    flash.read(buf, SECTOR + ix * PAGE, PAGE);
+    io.stop();
+  }
+  for (uint8_t ix = 0; ix < 4; ix++) {
+    io.start();
+    flash.erase(SECTOR + ix * flash.SECTOR_BYTES);
+    io.stop();
+  }
+  io.print(trace, PSTR("Flash::erase(sector)"), 0);
+}
+#endif
+
+#if defined(USE_TWI)
+// TWI device with register address pointer
+class Device : public TWI::Driver {
+public:
+  Device() : TWI::Driver(TWI_ADDR) {}
+
+  void benchmark(uint32_t hz, str_P name, size_t size)
+  {
+    for (uint8_t ix = 0; ix < membersof(samples); ix++) {
+      twi.acquire(this);
+      twi.set_freq(hz);
+      io.start();
+      twi.write((uint8_t) 0);
+      twi.read(buf, size);
+      io.stop();
+      twi.release();
+    }
+    io.print(trace, name, size);
+  }
+};
+
+Device device;
+
+void benchmark_twi()
+{
+  device.benchmark(100000L, PSTR("TWI::read(100KHz)"), 16);
+  device.benchmark(400000L, PSTR("TWI::read(400KHz)"), 16);
+}
+#endif
+
+#if defined(W5X00)
+// Ethernet controller with access to the device memory functions
+class Ethernet : public W5X00 {
+public:
+  void benchmark()
+  {
+    const size_t SIZE = 256;
+    const uint16_t TX = TX_MEMORY_BASE;
+    MEASURE_IO(W5X00_OP("write"), SIZE) {
+      io.start();
+      write(TX, buf, SIZE);
+      io.stop();
+    }
+    // Program memory source; from start of program memory
+    MEASURE_IO(W5X00_OP("write_P"), SIZE) {
+      io.start();
+      write_P(TX, (const void*) 0, SIZE);
+      io.stop();
+    }
+    MEASURE_IO(W5X00_OP("read"), SIZE) {
+      io.start();
+      read(TX, buf, SIZE);
+      io.stop();
+    }
+  }
+};
+
+Ethernet ethernet;
+
+void benchmark_w5x00()
+{
+  if (!ethernet.begin()) return;
+  ethernet.benchmark();
+  ethernet.end();
+}
+#endif
+
+void setup()
+{
+  Watchdog::begin();
+  RTT::begin();
+  uart.begin(57600);
+  trace.begin(&uart);
+  for (size_t i = 0; i < sizeof(buf); i++) buf[i] = i;
+
+  Benchmark::Throughput::header(trace);
+#if defined(USE_SPI)
+  benchmark_spi();
+#endif
+#if defined(USE_SD)
+  benchmark_sd();
+#endif
+#if defined(USE_FAT16)
+  benchmark_fat16();
+#endif
+#if defined(USE_CFFS)
+  benchmark_cffs();
+#endif
+#if defined(USE_FLASH)
+  benchmark_flash();
+#endif
+#if defined(USE_TWI)
+  benchmark_twi();
+#endif
+#if defined(W5X00)
+  benchmark_w5x00();
+#endif
+  trace << PSTR("end") << endl;
+}
+
+void loop()
+{
+  sleep(60);
+}
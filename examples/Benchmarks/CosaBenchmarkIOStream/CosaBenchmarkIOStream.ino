@@ -0,0 +1,141 @@
+/**
+ * @file CosaBenchmarkIOStream.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa IOStream number formatting benchmark. Measures decimal
+ * conversion with the standard library (division per digit), the
+ * previous subtraction per digit implementation and the digit pair
+ * implementation in IOStream. Also compares fixed-point and floating
+ * point print to a null device.
+ *
+ * @section Circuit
+ * This example requires no special circuit. Uses serial output.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/IOStream.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Memory.h"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include <stdlib.h>
+
+/**
+ * Null device; discard all output.
+ */
+class Null : public IOStream::Device {
+public:
+  virtual int putchar(char c)
+  {
+    return (c & 0xff);
+  }
+  virtual int write(const void* buf, size_t size)
+  {
+    UNUSED(buf);
+    return (size);
+  }
+};
+
+Null null;
+IOStream nout(&null);
+
+static const unsigned long digits10[] __PROGMEM = {
+  1000000000, 100000000, 10000000, 1000000, 100000,
+  10000, 1000, 100, 10, 1
+};
+
+/**
+ * Previous decimal conversion; subtraction of powers of ten with
+ * 32-bit arithmetic for each digit.
+ * @param[in] val value to convert.
+ * @param[in] s string buffer.
+ * @return string buffer.
+ */
+char* subtract_ultoa(unsigned long val, char* s)
+{
+  bool first = true;
+  char* p = s;
+  for (uint8_t i = 0; i < membersof(digits10); i++) {
+    unsigned long check = pgm_read_dword(digits10 + i);
+    if (check > val) {
+      if (!first) *p++ = '0';
+      continue;
+    }
+    char k = '0';
+    first = false;
+    while (check <= val) {
+      val -= check;
+      k++;
+    }
+    *p++ = k;
+  }
+  if (first) *p++ = '0';
+  *p = 0;
+  return (s);
+}
+
+// Values; 16-bit and 32-bit
+const uint16_t U16 = 54321U;
+const uint32_t U32 = 3141592653UL;
+
+void setup()
+{
+  char buf[16];
+
+  // Start the trace output stream on the serial port
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaBenchmarkIOStream: started"));
+
+  // Check amount of free memory
+  TRACE(free_memory());
+
+  // Print CPU clock and instructions per 1MHZ
+  TRACE(F_CPU);
+  TRACE(I_CPU);
+
+  // Start the timer
+  RTT::begin();
+
+  // Validate conversions
+  TRACE(IOStream::utoa(U16, buf, 10));
+  TRACE(IOStream::ultoa(U32, buf, 10));
+  TRACE(subtract_ultoa(U32, buf));
+  trace << PSTR("fixed:") << -314159L << ',' << 4 << PSTR(" = ");
+  trace.print(-314159L, 4);
+  trace << endl;
+
+  // Measure 16-bit decimal conversion
+  MEASURE("::utoa(U16): ", 1000) ::utoa(U16, buf, 10);
+  MEASURE("subtract_ultoa(U16): ", 1000) subtract_ultoa(U16, buf);
+  MEASURE("IOStream::utoa(U16): ", 1000) IOStream::utoa(U16, buf, 10);
+
+  // Measure 32-bit decimal conversion
+  MEASURE("::ultoa(U32): ", 1000) ::ultoa(U32, buf, 10);
+  MEASURE("subtract_ultoa(U32): ", 1000) subtract_ultoa(U32, buf);
+  MEASURE("IOStream::ultoa(U32): ", 1000) IOStream::ultoa(U32, buf, 10);
+
+  // Measure print of fixed-point and floating point values
+  MEASURE("nout.print(-314159L, 4): ", 1000) nout.print(-314159L, 4);
+  MEASURE("nout.print(-31.4159, 8, 4): ", 1000) nout.print(-31.4159, 8, 4);
+  MEASURE("nout << U32: ", 1000) nout << U32;
+}
+
+void loop()
+{
+  ASSERT(true == false);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file CosaBenchmarkNRF24L01P.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Benchmarking NRF24L01P transmit throughput; measure packets per
+ * second and retransmissions with blocking send() and pipelined
+ * post(). Load one node as receiver (define RECEIVER) and one node
+ * as transmitter. The receiver prints the number of received packets
+ * per second.
+ *
+ * @section Circuit
+ * See NRF24L01P.hh for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <NRF24L01P.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+
+// Configuration; network and device addresses.
+// #define RECEIVER
+#define NETWORK 0xC05A
+#define RECEIVER_ID 0x01
+#define TRANSMITTER_ID 0x02
+#if defined(RECEIVER)
+#define DEVICE RECEIVER_ID
+#else
+#define DEVICE TRANSMITTER_ID
+#endif
+
+NRF24L01P rf(NETWORK, DEVICE);
+
+// Number of packets per measurement and payload
+static const uint16_t PACKETS_MAX = 1000;
+static const uint8_t BENCHMARK_TYPE = 0x42;
+static uint8_t payload[NRF24L01P::PAYLOAD_MAX];
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaBenchmarkNRF24L01P: started"));
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(rf.begin());
+}
+
+#if defined(RECEIVER)
+void loop()
+{
+  // Count received packets per second
+  static const uint32_t PERIOD = 1000L;
+  uint32_t start = RTT::millis();
+  uint16_t count = 0;
+  uint8_t src;
+  uint8_t port;
+  while (RTT::since(start) < PERIOD) {
+    int res = rf.recv(src, port, payload, sizeof(payload), PERIOD);
+    if (res >= 0 && port == BENCHMARK_TYPE) count += 1;
+  }
+  if (count == 0) return;
+  trace << count << PSTR(" packets/s") << endl;
+}
+
+#else
+
+/**
+ * Print the packet rate and retransmissions for the given operation
+ * name and time.
+ * @param[in] name of operation.
+ * @param[in] us transmission time in micro-seconds.
+ * @param[in] retrans number of retransmissions.
+ * @param[in] drops number of dropped packets.
+ */
+static void
+print(str_P name, uint32_t us, uint16_t retrans, uint16_t drops)
+{
+  uint32_t rate = (PACKETS_MAX * 1000000UL) / us;
+  trace << name << rate << PSTR(" packets/s (")
+	<< us << PSTR(" us, retrans=")
+	<< retrans << PSTR(", drops=")
+	<< drops << PSTR(")") << endl;
+}
+
+void loop()
+{
+  uint32_t start, stop;
+  uint16_t retrans, drops;
+
+  // Blocking send; one round trip per packet
+  retrans = rf.retrans();
+  drops = rf.drops();
+  start = RTT::micros();
+  for (uint16_t i = 0; i < PACKETS_MAX; i++) {
+    payload[0] = i;
+    rf.send(RECEIVER_ID, BENCHMARK_TYPE, payload, sizeof(payload));
+  }
+  stop = RTT::micros();
+  print(PSTR("send:"), stop - start, rf.retrans() - retrans, rf.drops() - drops);
+  sleep(2);
+
+  // Pipelined post; up to three packets in the transmit fifo
+  retrans = rf.retrans();
+  drops = rf.drops();
+  start = RTT::micros();
+  for (uint16_t i = 0; i < PACKETS_MAX; i++) {
+    payload[0] = i;
+    rf.post(RECEIVER_ID, BENCHMARK_TYPE, payload, sizeof(payload));
+  }
+  rf.flush();
+  stop = RTT::micros();
+  print(PSTR("post:"), stop - start, rf.retrans() - retrans, rf.drops() - drops);
+  trace << endl;
+  sleep(5);
+}
+#endif
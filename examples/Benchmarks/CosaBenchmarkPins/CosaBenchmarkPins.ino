@@ -32,6 +32,10 @@
  * operator syntax Cosa is between 2-10X faster allowing high speed
  * protocols.
  *
+ * The compile-time pins (FastPin and Soft::FastSPI) have the port
+ * register and mask as template constants and reduce to single
+ * instructions; used for comparison with the pin objects.
+ *
  * The digital pin object holds reference to special function register
  * (port), pin mask and pin number (total of 4 bytes). The analog pin
  * object holds the ADC channel number, latest sample, reference
@@ -48,6 +52,8 @@
 #include "Cosa/InputPin.hh"
 #include "Cosa/OutputPin.hh"
 #include "Cosa/AnalogPin.hh"
+#include "Cosa/FastPin.hh"
+#include "Cosa/Soft/FastSPI.hh"
 #include "Cosa/RTT.hh"
 #include "Cosa/Memory.h"
 #include "Cosa/Watchdog.hh"
@@ -62,6 +68,13 @@ OutputPin dataPin(Board::D9);
 OutputPin clockPin(Board::D10);
 AnalogPin analogPin(Board::A0);
 
+// Compile-time pins; same pins as above
+typedef FastPin<Board::D7> FastInPin;
+typedef FastPin<Board::D8> FastOutPin;
+typedef FastPin<Board::D9> FastDataPin;
+typedef FastPin<Board::D10> FastClockPin;
+typedef Soft::FastSPI<Board::D7, Board::D9, Board::D10> FastBus;
+
 // Simple adaptation of the Arduino/Wiring API but with strong
 // data typed pins
 inline void pinMode(Board::DigitalPin pin, uint8_t mode)
@@ -125,6 +138,9 @@ void setup()
   TRACE(F_CPU);
   TRACE(I_CPU);
 
+  // Initiate compile-time pins (same pins as the pin objects)
+  FastBus::begin();
+
   // Powerup ADC
   AnalogPin::powerup();
 }
@@ -295,6 +311,24 @@ void loop()
     __asm__ __volatile__("nop");
   }
 
+  MEASURE_NS("FastPin<D8>::set/clear()") {
+    FastOutPin::set();
+    FastOutPin::clear();
+    __asm__ __volatile__("nop");
+  }
+
+  MEASURE_NS("FastPin<D8>::write(1/0)") {
+    FastOutPin::write(1);
+    FastOutPin::write(0);
+    __asm__ __volatile__("nop");
+  }
+
+  MEASURE_NS("FastPin<D8>::toggle()") {
+    FastOutPin::toggle();
+    FastOutPin::toggle();
+    __asm__ __volatile__("nop");
+  }
+
   MEASURE_SUITE("Measure the time to perform input pin read/output pin write");
 
   MEASURE_NS("outPin.write(!inPin.read())") {
@@ -345,6 +379,19 @@ void loop()
     __asm__ __volatile__("nop");
   }
 
+  MEASURE_NS("FastPin<D8>::write(!FastPin<D7>::read())") {
+    FastOutPin::write(!FastInPin::read());
+    __asm__ __volatile__("nop");
+  }
+
+  MEASURE_NS("FastPin<D7>::is_set();FastPin<D8>::clear/set()") {
+    if (FastInPin::is_set())
+      FastOutPin::clear();
+    else
+      FastOutPin::set();
+    __asm__ __volatile__("nop");
+  }
+
   MEASURE_NS("digitalRead(D7)/digitalWrite(D8,0/1)") {
     if (digitalRead(Board::D8))
       digitalWrite(Board::D8, 0);
@@ -479,6 +526,30 @@ void loop()
     }
   }
 
+  MEASURE_US("FastPin<D9>::write/FastPin<D10>::toggle()") {
+    uint8_t data = 0x55;
+    for(uint8_t bit = 0x80; bit; bit >>= 1) {
+      FastDataPin::write(data & bit);
+      FastClockPin::toggle();
+      FastClockPin::toggle();
+    }
+  }
+
+  MEASURE_US("synchronized FastPin<D9>::_write/FastPin<D10>::toggle()") {
+    uint8_t data = 0x55;
+    synchronized {
+      for(uint8_t bit = 0x80; bit; bit >>= 1) {
+	FastDataPin::_write(data & bit);
+	FastClockPin::toggle();
+	FastClockPin::toggle();
+      }
+    }
+  }
+
+  MEASURE_US("Soft::FastSPI<D7,D9,D10>::transfer()") {
+    cnt += FastBus::transfer(0x55);
+  }
+
   MEASURE_SUITE("Measure the time to read analog pin");
 
   MEASURE_US("analogPin.sample()") {
@@ -0,0 +1,103 @@
+/**
+ * @file CosaBenchmarkProbe.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate Cosa execution time probes. The periodic job handler
+ * and a few basic operations are measured in processor cycles and
+ * the probe statistics are printed every five seconds.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Probe.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/OutputPin.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Execution time probes
+PROBE(empty_probe, "empty");
+PROBE(toggle_probe, "toggle");
+PROBE(divide_probe, "divide");
+PROBE(run_probe, "run");
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// Periodic job to measure
+class Sampler : public Periodic {
+public:
+  Sampler() :
+    Periodic(&scheduler, 64),
+    m_led(Board::LED),
+    m_value(1000)
+  {}
+
+  virtual void run()
+  {
+    PROBE_BEGIN(run_probe);
+
+    PROBE_BEGIN(empty_probe);
+    PROBE_END(empty_probe);
+
+    PROBE_BEGIN(toggle_probe);
+    m_led.toggle();
+    PROBE_END(toggle_probe);
+
+    PROBE_BEGIN(divide_probe);
+    m_value = (m_value * 7) / 3;
+    PROBE_END(divide_probe);
+
+    PROBE_END(run_probe);
+  }
+
+private:
+  OutputPin m_led;
+  volatile uint32_t m_value;
+};
+
+// Periodic job to print and reset the probe statistics
+class Reporter : public Periodic {
+public:
+  Reporter() : Periodic(&scheduler, 5000) {}
+
+  virtual void run()
+  {
+    Probe::print(trace);
+    Probe::reset_all();
+  }
+};
+
+Sampler sampler;
+Reporter reporter;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaBenchmarkProbe: started"));
+  Watchdog::begin();
+  Probe::begin();
+  sampler.start();
+  reporter.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file CosaBenchmarkRuntime.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa runtime benchmarks with machine-readable (CSV) output (see
+ * Cosa/Benchmark.hh and build/benchmark.py):
+ * 1) Event push and service (dispatch) throughput.
+ * 2) Job scheduler start/stop and dispatch cost vs queue length.
+ * 3) Periodic job jitter (lateness) with event load.
+ * 4) Nucleo thread and ProtoThread context switch.
+ * The benchmarks run in a Nucleo thread. The queue length and event
+ * load are parameters; JOB_MAX and LOAD_US below.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Nucleo.h>
+#include <ProtoThread.h>
+
+#include "Cosa/Benchmark.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Max number of queued jobs in scheduler benchmarks
+#define JOB_MAX 32
+
+// Event handler execution time (us) in periodic jitter load
+#define LOAD_US 200
+
+// Real-time timer job scheduler (micro-seconds)
+RTT::Scheduler scheduler;
+
+// Watchdog job scheduler (milli-seconds) for the proto thread
+Watchdog::Scheduler watchdog;
+
+// 1) Event push and service with empty handler
+class Sink : public Event::Handler {
+public:
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(type);
+    UNUSED(value);
+  }
+};
+
+Sink sink;
+
+BENCHMARK(event_push_service, "Event::push+service")
+{
+  Event::push(Event::USER_TYPE, &sink);
+  Event::service();
+}
+
+// 2) Job that is never run; expires far in the future
+class Idle : public Job {
+public:
+  Idle() : Job(&scheduler) {}
+  virtual void on_expired() {}
+};
+
+Idle idle[JOB_MAX];
+
+// Start and stop a job last in a scheduler queue of given length
+class JobStartStop : public Benchmark {
+public:
+  JobStartStop(str_P name, uint8_t jobs) :
+    Benchmark(name),
+    m_jobs(jobs)
+  {}
+
+  virtual void evaluate(Probe::sample_t& sample,
+			uint16_t iterations, uint8_t warmup)
+  {
+    for (uint8_t i = 0; i < m_jobs; i++) {
+      idle[i].expire_after(10000000UL + i);
+      idle[i].start();
+    }
+    Benchmark::evaluate(sample, iterations, warmup);
+    for (uint8_t i = 0; i < m_jobs; i++) idle[i].stop();
+  }
+
+  virtual void run()
+  {
+    m_job.expire_after(20000000UL);
+    m_job.start();
+    m_job.stop();
+  }
+
+protected:
+  const uint8_t m_jobs;
+  Idle m_job;
+};
+
+const char job_start_stop_0_name[] __PROGMEM = "Job::start+stop(0)";
+JobStartStop job_start_stop_0((str_P) job_start_stop_0_name, 0);
+const char job_start_stop_8_name[] __PROGMEM = "Job::start+stop(8)";
+JobStartStop job_start_stop_8((str_P) job_start_stop_8_name, 8);
+const char job_start_stop_max_name[] __PROGMEM = "Job::start+stop(JOB_MAX)";
+JobStartStop job_start_stop_max((str_P) job_start_stop_max_name, JOB_MAX);
+
+// Start an expired job first in a scheduler queue of given length
+// and dispatch
+class JobDispatch : public JobStartStop {
+public:
+  JobDispatch(str_P name, uint8_t jobs) : JobStartStop(name, jobs) {}
+
+  virtual void run()
+  {
+    m_job.expire_at(scheduler.time() - 1);
+    m_job.start();
+    scheduler.dispatch();
+  }
+};
+
+const char job_dispatch_0_name[] __PROGMEM = "Job::Scheduler::dispatch(0)";
+JobDispatch job_dispatch_0((str_P) job_dispatch_0_name, 0);
+const char job_dispatch_max_name[] __PROGMEM =
+  "Job::Scheduler::dispatch(JOB_MAX)";
+JobDispatch job_dispatch_max((str_P) job_dispatch_max_name, JOB_MAX);
+
+// 3) Periodic job recording lateness (cycles) of each run
+class Ticker : public Periodic {
+public:
+  Ticker() : Periodic(&scheduler, 1000), m_sample(NULL) {}
+
+  void begin(Probe::sample_t* sample)
+  {
+    m_sample = sample;
+    expire_after(period());
+    start();
+  }
+
+  virtual void run()
+  {
+    uint32_t late = (scheduler.time() - expire_at()) * (F_CPU / 1000000L);
+    if (late > UINT16_MAX) late = UINT16_MAX;
+    m_sample->count += 1;
+    if (late < m_sample->min) m_sample->min = late;
+    if (late > m_sample->max) m_sample->max = late;
+    m_sample->total += late;
+  }
+
+protected:
+  Probe::sample_t* m_sample;
+};
+
+// Event load; busy handler that pushes itself
+class Load : public Event::Handler {
+public:
+  Load() : m_active(false) {}
+
+  void begin()
+  {
+    m_active = true;
+    Event::push(Event::USER_TYPE, this);
+  }
+
+  void end()
+  {
+    m_active = false;
+  }
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(type);
+    UNUSED(value);
+    if (!m_active) return;
+    DELAY(LOAD_US);
+    Event::push(Event::USER_TYPE, this);
+  }
+
+protected:
+  bool m_active;
+};
+
+Ticker ticker;
+Load load;
+
+class PeriodicJitter : public Benchmark {
+public:
+  PeriodicJitter(str_P name, bool loaded) :
+    Benchmark(name),
+    m_loaded(loaded)
+  {}
+
+  virtual void evaluate(Probe::sample_t& sample,
+			uint16_t iterations, uint8_t warmup)
+  {
+    UNUSED(warmup);
+    sample.count = 0;
+    sample.min = UINT16_MAX;
+    sample.max = 0;
+    sample.total = 0;
+    if (iterations > 500) iterations = 500;
+    if (m_loaded) load.begin();
+    ticker.begin(&sample);
+    while (sample.count < iterations) Event::service();
+    ticker.stop();
+    load.end();
+    while (Event::queue.available()) Event::service();
+  }
+
+  virtual void run() {}
+
+protected:
+  bool m_loaded;
+};
+
+const char periodic_jitter_name[] __PROGMEM = "Periodic::jitter";
+PeriodicJitter periodic_jitter((str_P) periodic_jitter_name, false);
+const char periodic_jitter_load_name[] __PROGMEM = "Periodic::jitter(LOAD_US)";
+PeriodicJitter periodic_jitter_load((str_P) periodic_jitter_load_name, true);
+
+// 4) Nucleo thread context switch; yield to main thread and back
+BENCHMARK(nucleo_yield, "Nucleo::Thread::yield(2 switches)")
+{
+  Nucleo::Thread::running()->yield();
+}
+
+// ProtoThread that yields on each run
+class Yielder : public ProtoThread {
+public:
+  Yielder() : ProtoThread(&watchdog) {}
+
+  virtual void on_run(uint8_t type, uint16_t value)
+  {
+    UNUSED(type);
+    UNUSED(value);
+    PROTO_THREAD_BEGIN();
+    while (1) PROTO_THREAD_YIELD();
+    PROTO_THREAD_END();
+  }
+};
+
+Yielder yielder;
+
+BENCHMARK(proto_thread_dispatch, "ProtoThread::dispatch(1 thread)")
+{
+  ProtoThread::dispatch(false);
+}
+
+// Benchmark thread; runs all benchmarks once
+class Bench : public Nucleo::Thread {
+public:
+  virtual void run()
+  {
+    Benchmark::run_all(trace);
+    while (1) delay(1000);
+  }
+};
+
+Bench bench;
+
+void setup()
+{
+  Watchdog::begin();
+  RTT::begin();
+  uart.begin(57600);
+  trace.begin(&uart);
+  yielder.begin();
+  Nucleo::Thread::begin(&bench, 256);
+  Nucleo::Thread::begin();
+}
+
+void loop()
+{
+  Nucleo::Thread::service();
+}
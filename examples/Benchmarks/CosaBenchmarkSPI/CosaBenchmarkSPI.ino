@@ -0,0 +1,116 @@
+/**
+ * @file CosaBenchmarkSPI.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Benchmarking SPI block transfer functions; measure the effective
+ * transfer rate (bytes per second) of read, write, write_P and
+ * transfer for each SPI clock setting. No device is required; the
+ * chip select pin is D10.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/RTT.hh"
+#include "Cosa/SPI.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Dummy device driver
+SPI::Driver dev(Board::D10);
+
+// Block buffer size
+static const size_t BUF_MAX = 512;
+static uint8_t buf[BUF_MAX];
+static const uint8_t buf_P[BUF_MAX] __PROGMEM = { 0 };
+
+static const uint8_t CLOCK[] __PROGMEM = {
+  SPI::DIV2_CLOCK,
+  SPI::DIV4_CLOCK,
+  SPI::DIV8_CLOCK,
+  SPI::DIV16_CLOCK,
+  SPI::DIV32_CLOCK,
+  SPI::DIV64_CLOCK,
+  SPI::DIV128_CLOCK
+};
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaBenchmarkSPI: started"));
+  RTT::begin();
+}
+
+/**
+ * Print the transfer rate for the given operation name and time.
+ * @param[in] name of operation.
+ * @param[in] us transfer time in micro-seconds.
+ */
+static void
+print(str_P name, uint32_t us)
+{
+  uint32_t rate = (BUF_MAX * 1000000UL) / us;
+  trace << name << rate << PSTR(" bytes/s (") << us << PSTR(" us)") << endl;
+}
+
+void loop()
+{
+  uint32_t start, stop;
+  uint8_t div = 2;
+
+  for (uint8_t i = 0; i < membersof(CLOCK); i++, div <<= 1) {
+    dev.set_clock((SPI::Clock) pgm_read_byte(&CLOCK[i]));
+    trace << PSTR("F_CPU/") << div << endl;
+
+    spi.acquire(&dev);
+    spi.begin();
+    start = RTT::micros();
+    spi.read(buf, BUF_MAX);
+    stop = RTT::micros();
+    spi.end();
+    spi.release();
+    print(PSTR("read:"), stop - start);
+
+    spi.acquire(&dev);
+    spi.begin();
+    start = RTT::micros();
+    spi.write(buf, BUF_MAX);
+    stop = RTT::micros();
+    spi.end();
+    spi.release();
+    print(PSTR("write:"), stop - start);
+
+    spi.acquire(&dev);
+    spi.begin();
+    start = RTT::micros();
+    spi.write_P(buf_P, BUF_MAX);
+    stop = RTT::micros();
+    spi.end();
+    spi.release();
+    print(PSTR("write_P:"), stop - start);
+
+    spi.acquire(&dev);
+    spi.begin();
+    start = RTT::micros();
+    spi.transfer(buf, BUF_MAX);
+    stop = RTT::micros();
+    spi.end();
+    spi.release();
+    print(PSTR("transfer:"), stop - start);
+    trace << endl;
+  }
+  sleep(5);
+}
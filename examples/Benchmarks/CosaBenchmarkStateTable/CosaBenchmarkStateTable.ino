@@ -0,0 +1,163 @@
+/**
+ * @file CosaBenchmarkStateTable.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa StateTable Benchmark; table driven state machines. Measures
+ * 1) direct dispatch of events (table lookup and action call), and
+ * 2) send/dispatch cycle through the event queue between two
+ * connected echo machines (as CosaBenchmarkFSM).
+ *
+ * @section Circuit
+ * This example requires no special circuit. Uses serial output,
+ * internal timer for RTC and watchdog.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/StateTable.hh"
+#include "Cosa/Memory.h"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+/**
+ * Toggle state machine with two states (OFF, ON) and two events
+ * (TOGGLE, RESET). Counts the number of ON transitions.
+ */
+enum { OFF, ON, TOGGLE_STATES };
+enum { TOGGLE, RESET, TOGGLE_EVENTS };
+
+class Toggle : public StateTable<Toggle, TOGGLE_STATES, TOGGLE_EVENTS> {
+public:
+  Toggle(const table_t& table) : StateTable(table), m_count(0) {}
+
+  static void on_count(Toggle* fsm, uint16_t value)
+  {
+    UNUSED(value);
+    fsm->m_count += 1;
+  }
+
+  static void on_reset(Toggle* fsm, uint16_t value)
+  {
+    UNUSED(value);
+    fsm->m_count = 0;
+  }
+
+  uint16_t count() const { return (m_count); }
+
+private:
+  uint16_t m_count;
+};
+
+const Toggle::table_t toggle_table __PROGMEM = {
+  // OFF
+  {
+    Toggle::transition(Toggle::on_count, ON),
+    Toggle::transition(Toggle::on_reset)
+  },
+  // ON
+  {
+    Toggle::transition(NULL, OFF),
+    Toggle::transition(Toggle::on_reset, OFF)
+  }
+};
+
+/**
+ * Echo state machine with a single state and event; for each
+ * received event sends an event to a connected machine.
+ */
+enum { ECHO, ECHO_STATES };
+enum { PING, ECHO_EVENTS };
+
+class Echo : public StateTable<Echo, ECHO_STATES, ECHO_EVENTS> {
+public:
+  Echo(const table_t& table) : StateTable(table), m_port(NULL) {}
+
+  void bind(Echo* fsm) { m_port = fsm; }
+
+  static void on_ping(Echo* fsm, uint16_t value)
+  {
+    UNUSED(value);
+    fsm->m_port->send(PING);
+  }
+
+private:
+  Echo* m_port;
+};
+
+const Echo::table_t echo_table __PROGMEM = {
+  // ECHO
+  { Echo::transition(Echo::on_ping) }
+};
+
+// The state machines
+Toggle toggle(toggle_table);
+Echo ping(echo_table);
+Echo pong(echo_table);
+
+void setup()
+{
+  // Start the UART and trace output stream
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaBenchmarkStateTable: started"));
+
+  // Check amount of free memory
+  TRACE(free_memory());
+
+  // Check size of instances and tables
+  TRACE(sizeof(Event::Handler));
+  TRACE(sizeof(Toggle));
+  TRACE(sizeof(toggle_table));
+  TRACE(sizeof(Echo));
+
+  // Give some more startup info
+  TRACE(F_CPU);
+  TRACE(I_CPU);
+
+  // Start the watchdog with default 16 ms ticks
+  Watchdog::begin();
+  RTT::begin();
+
+  // Measure direct dispatch
+  MEASURE("direct dispatch: ", 1000) {
+    toggle.dispatch(TOGGLE);
+  }
+  TRACE(toggle.count());
+
+  // Bind the state machines to each other
+  ping.bind(&pong);
+  pong.bind(&ping);
+
+  // Send a first event to start the benchmark
+  ping.send(PING);
+}
+
+void loop()
+{
+  // Dispatch events and measure time per dispatch
+  MEASURE("event dispatch: ", 1000) {
+    Event event;
+    Event::queue.await(&event);
+    event.dispatch();
+  }
+
+  // Run the loop a limited number of times
+  static uint8_t count = 0;
+  count += 1;
+  ASSERT(count < 10);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file CosaBenchmarkSuite.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa benchmark suite with machine-readable (CSV) output. Measures
+ * the hot paths of pin access, real-time timer, event queue and
+ * output stream in processor cycles. Collect and compare runs with
+ * the host script:
+ * @code
+ * build/benchmark.py run nano /dev/ttyUSB0 nano.csv
+ * build/benchmark.py compare baseline.csv nano.csv
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Benchmark.hh"
+#include "Cosa/OutputPin.hh"
+#include "Cosa/InputPin.hh"
+#include "Cosa/GPIO.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/IOBuffer.hh"
+#include "Cosa/IOStream.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+OutputPin outPin(Board::D8);
+InputPin inPin(Board::D7);
+GPIO gpioPin(Board::D9, GPIO::OUTPUT_MODE);
+volatile uint8_t value;
+
+BENCHMARK(output_pin_toggle, "OutputPin::toggle")
+{
+  outPin.toggle();
+}
+
+BENCHMARK(output_pin_write, "OutputPin::write")
+{
+  outPin.write(value);
+}
+
+BENCHMARK(output_pin_toggle_static, "OutputPin::toggle(pin)")
+{
+  OutputPin::toggle(Board::D8);
+}
+
+BENCHMARK(input_pin_read, "InputPin::read")
+{
+  value = inPin.read();
+}
+
+BENCHMARK(gpio_operator_not, "GPIO::operator~")
+{
+  ~gpioPin;
+}
+
+BENCHMARK(rtt_micros, "RTT::micros")
+{
+  value = RTT::micros();
+}
+
+BENCHMARK(rtt_millis, "RTT::millis")
+{
+  value = RTT::millis();
+}
+
+BENCHMARK(event_push_dequeue, "Event::push+dequeue")
+{
+  Event event;
+  Event::push(Event::NULL_TYPE, NULL);
+  Event::queue.dequeue(&event);
+}
+
+IOBuffer<64> buffer;
+IOStream bout(&buffer);
+
+BENCHMARK(iostream_uint16, "IOStream<<uint16_t")
+{
+  bout << (uint16_t) 12345;
+  buffer.empty();
+}
+
+BENCHMARK(iostream_int32, "IOStream<<int32_t")
+{
+  bout << (int32_t) -1234567890L;
+  buffer.empty();
+}
+
+void setup()
+{
+  Watchdog::begin();
+  RTT::begin();
+  uart.begin(57600);
+  trace.begin(&uart);
+  Benchmark::run_all(trace);
+}
+
+void loop()
+{
+  sleep(60);
+}
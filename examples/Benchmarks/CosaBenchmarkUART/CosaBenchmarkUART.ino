@@ -18,7 +18,9 @@
  * @section Description
  * Benchmarking IOStream and UART functions; measure time to print
  * characters, strings and numbers through the IOStream interface and
- * IOBuffer to the UART.
+ * IOBuffer to the UART. Also measures the ring buffer access per
+ * character in the interrupt handlers (cycles per byte); through the
+ * IOStream::Device interface (UART) and statically bound (UART_T).
  *
  * This file is part of the Arduino Che Cosa project.
  */
@@ -113,6 +115,24 @@ void setup()
   // Start timers
   Watchdog::begin();
   RTT::begin();
+
+  // Measure ring buffer access per character in interrupt handlers
+  static IOBuffer<64> buf;
+  IOStream::Device* volatile dev = &buf;
+  MEASURE("UART ISR (virtual) 1000 bytes:", 1) {
+    for (uint16_t i = 0; i < 1000; i++) {
+      dev->putchar(i);
+      dev->getchar();
+    }
+  }
+  trace << PSTR("cycles per byte:") << (trace.measure * I_CPU) / 1000 << endl;
+  MEASURE("UART_T ISR (direct) 1000 bytes:", 1) {
+    for (uint16_t i = 0; i < 1000; i++) {
+      buf.IOBuffer<64>::putchar(i);
+      buf.IOBuffer<64>::getchar();
+    }
+  }
+  trace << PSTR("cycles per byte:") << (trace.measure * I_CPU) / 1000 << endl;
 }
 
 void loop()
@@ -0,0 +1,103 @@
+/**
+ * @file CosaAnalogSampler.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of continuous timer triggered analog sampling.
+ * Two channels (e.g. ACS712T current sensor and a vibration sensor)
+ * are sampled at 2 kHz into double buffered sample blocks. The raw
+ * samples are oversampled (12-bit) and reduced to windowed
+ * statistics in the interrupt handler; the mean and peak-to-peak
+ * value of each channel is reported approx. once per second.
+ *
+ * @section Circuit
+ * @code
+ *
+ * (A0)-----------------< ACS712T/OUT
+ * (A1)-----------------< Vibration sensor
+ *
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/AnalogSampler.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Analog pin sequence. Note: use program memory
+const Board::AnalogPin pins[] __PROGMEM = {
+  Board::A0,
+  Board::A1
+};
+
+// Sample rate (conversions per second) and block size (reduced values)
+static const uint16_t RATE = 2000;
+static const uint16_t BLOCK = 16;
+
+// Reducer pipeline; 4X oversampling to 12-bit and 31 ms windows
+AnalogSampler::Statistics<membersof(pins), 8> statistics;
+AnalogSampler::Oversample<membersof(pins), 1> oversample(&statistics);
+
+// Double buffered sample blocks
+uint16_t buffer[2 * BLOCK];
+
+class Monitor : public AnalogSampler {
+public:
+  Monitor() :
+    AnalogSampler(pins, membersof(pins), buffer, BLOCK),
+    m_blocks(0)
+  {}
+
+  virtual void on_block(const uint16_t* block, uint16_t count)
+  {
+    // Report every 4th block (approx. one per second)
+    if ((++m_blocks & 0x3) != 0) return;
+    for (uint8_t pin = 0; pin < membersof(pins); pin++) {
+      uint32_t sum = 0;
+      for (uint16_t i = pin; i < count; i += membersof(pins))
+	sum += block[i];
+      uint16_t mean = sum / (count / membersof(pins));
+      uint16_t pp = statistics.max(pin) - statistics.min(pin);
+      trace << 'A' << pin << PSTR(": mean=") << mean
+	    << PSTR(", pp=") << pp << ' ';
+    }
+    trace << PSTR("overruns=") << overruns() << endl;
+  }
+
+private:
+  uint16_t m_blocks;
+};
+
+Monitor monitor;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaAnalogSampler: started"));
+  Watchdog::begin();
+  monitor.reducer(&oversample);
+  ASSERT(monitor.begin(RATE));
+}
+
+void loop()
+{
+  Event event;
+  Event::queue.await(&event);
+  event.dispatch();
+}
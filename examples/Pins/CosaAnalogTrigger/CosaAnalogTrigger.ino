@@ -0,0 +1,58 @@
+/**
+ * @file CosaAnalogTrigger.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the Analog Trigger; detect when the voltage on
+ * A0 rises above the bandgap voltage (1V1) with the comparator and
+ * confirm with a single sample (1V1 is approx. 225 with VCC 5V
+ * reference). The processor sleeps between crossings.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/AnalogComparator.hh"
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+class Alarm : public AnalogTrigger {
+public:
+  Alarm() : AnalogTrigger(Board::A0, 225) {}
+
+  virtual void on_trigger(uint16_t value)
+  {
+    trace << Watchdog::millis() << PSTR(":alarm:") << value << endl;
+  }
+};
+
+Alarm detector;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaAnalogTrigger: started"));
+  Watchdog::begin();
+  AnalogPin::powerup();
+  detector.enable();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,87 @@
+/**
+ * @file CosaButtonBank.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of Cosa debouncing of a bank of buttons with a single
+ * periodic job. All buttons are sampled with one port read per AVR
+ * port and debounced in parallel.
+ *
+ * @section Circuit
+ * Buttons/switches should be connected to Arduino pins D2..D7 and
+ * ground. No additional components are needed as the input pins are
+ * configured with input pullup resistor.
+ * @code
+ *
+ * (D2..D7)-------------+
+ *                      |
+ *                     (\)
+ *                      |
+ * (GND)----------------+
+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/ButtonBank.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// Button pins
+const Board::DigitalPin pins[] __PROGMEM = {
+  Board::D2, Board::D3, Board::D4, Board::D5, Board::D6, Board::D7
+};
+
+// Button panel
+class Panel : public ButtonBank<membersof(pins)> {
+public:
+  Panel() : ButtonBank<membersof(pins)>(&scheduler, pins) {}
+
+  virtual void on_change(uint8_t type, uint8_t ix)
+  {
+    if (type == Event::FALLING_TYPE) {
+      INFO("button %d: pressed", ix);
+    }
+    else {
+      INFO("button %d: released", ix);
+    }
+  }
+};
+
+Panel panel;
+
+void setup()
+{
+  // Start trace output stream on the serial port
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaButtonBank: started"));
+  TRACE(sizeof(Panel));
+
+  // Start the watchdog and the button bank
+  Watchdog::begin();
+  panel.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -55,6 +55,10 @@ private:
 
 Counter pin(Board::PCI7, PinChangeInterrupt::ON_RISING_MODE);
 
+#if defined(COSA_STATIC_INTERRUPT_HANDLERS)
+PCINT_HANDLERS(&pin);
+#endif
+
 void setup()
 {
   uart.begin(9600);
@@ -0,0 +1,73 @@
+/**
+ * @file CosaPulseCapture.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of input capture pulse train recording and
+ * asynchronous decoding; NEC infrared remote codes. The edges are
+ * recorded by the interrupt handler and decoded in the loop.
+ *
+ * @section Circuit
+ * @code
+ *                         TSOP4838
+ *                       +------------+
+ * (D8/ICP1)-----------1-|OUT         |
+ * (GND)---------------2-|GND     (o) |
+ * (VCC)---------------3-|VCC         |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/PulseCapture.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+class Remote : public PulseDecoder::NEC {
+public:
+  virtual void on_code(uint32_t code)
+  {
+    trace << PSTR("code=") << hex << code << endl;
+  }
+
+  virtual void on_repeat()
+  {
+    trace << PSTR("repeat") << endl;
+  }
+};
+
+// Edge ring buffer and 4 us timer resolution (262 ms period)
+uint16_t edges[64];
+PulseCapture capture(edges, membersof(edges), PulseCapture::PRESCALE_64);
+Remote remote;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaPulseCapture: started"));
+  Watchdog::begin();
+  capture.begin();
+  capture.enable();
+}
+
+void loop()
+{
+  capture.dispatch(&remote);
+  if (capture.overruns()) TRACE(capture.overruns());
+  delay(16);
+}
@@ -87,6 +87,23 @@ void setup()
   for (uint16_t i = 4; i < b.members(); i += 5)
     b += i;
   trace << PSTR("B3:") << b << endl;
+  TRACE(b.count());
+
+  // Iterate over the members
+  for (int16_t i = b.first(); i >= 0; i = b.next(i + 1))
+    trace << i << ' ';
+  trace << endl;
+
+  // Union and intersection in place
+  a.empty();
+  for (uint16_t i = 0; i < a.members(); i += 2)
+    a += i;
+  a &= b;
+  trace << PSTR("A2:") << a << endl;
+  ASSERT(a.count() == 7);
+  ASSERT(a.first() == 4);
+  a |= b;
+  ASSERT(a == b);
 }
 
 void loop()
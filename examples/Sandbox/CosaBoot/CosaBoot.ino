@@ -0,0 +1,96 @@
+/**
+ * @file CosaBoot.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of deferred driver begin and the boot time profile.
+ * The built-in LED is blinking directly after setup() while the SD
+ * card is initiated as a background job. The boot profile is printed
+ * when the SD card is ready. The library should be built with
+ * COSA_BOOT_PROFILE defined (see Cosa.h).
+ *
+ * @section Circuit
+ * SD card module with chip select on D8 (default SD::CS).
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <SD.h>
+
+#include "Cosa/Boot.hh"
+#include "Cosa/OutputPin.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+
+// Time-critical function; blink the built-in LED
+class Blinker : public Periodic {
+public:
+  Blinker(Job::Scheduler* scheduler) :
+    Periodic(scheduler, 128),
+    m_led(Board::LED)
+  {}
+
+  virtual void run()
+  {
+    m_led.toggle();
+  }
+
+private:
+  OutputPin m_led;
+};
+
+// Handle the deferred begin ready event
+class Application : public Event::Handler {
+public:
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    Boot::Deferred* driver = (Boot::Deferred*) value;
+    trace << driver->name()
+	  << ((type == Event::BEGIN_TYPE) ? PSTR(":ready") : PSTR(":failed"))
+	  << endl;
+#if defined(COSA_BOOT_PROFILE)
+    Boot::print(trace);
+#endif
+  }
+};
+
+Watchdog::Scheduler scheduler;
+Blinker blinker(&scheduler);
+Application app;
+SD sd;
+const char sd_name[] __PROGMEM = "sd";
+Boot::Begin<SD> sd_begin(&scheduler, &sd, (str_P) sd_name, &app);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaBoot: started"));
+  Watchdog::begin();
+
+  // Start the time-critical function first
+  blinker.start();
+
+  // Initiate the SD card after the first blinks
+  sd_begin.expire_at(scheduler.time() + 512);
+  sd_begin.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file CosaEEPROMring.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demo of the wear-leveled ring record store on the internal EEPROM.
+ * A boot counter and the latest sample is kept in a record that is
+ * updated asynchronously; unchanged records are not written.
+ *
+ * @section Circuit
+ * Uses the MCU internal EEPROM and Analog Pin A0 for samples.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/EEPROM.hh"
+#include "Cosa/AnalogPin.hh"
+
+// Persistent state record
+struct state_t {
+  uint16_t boots;
+  uint16_t sample;
+};
+
+// Ring of slots in internal EEPROM
+static const uint16_t SLOT_MAX = 64;
+uint8_t ring[SLOT_MAX * EEPROM::Ring<state_t>::SLOT_SIZE] EEMEM;
+EEPROM::Ring<state_t> store(&EEPROM::Device::eeprom, ring, SLOT_MAX);
+
+// Current state
+state_t state;
+
+// Analog input pin
+AnalogPin sensor(Board::A0);
+
+void setup()
+{
+  // Use serial as output stream
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaEEPROMring: started"));
+  Watchdog::begin();
+
+  // Find the latest record and update the boot counter
+  if (!store.begin()) {
+    state.boots = 0;
+    state.sample = 0;
+  }
+  else store.read(state);
+  state.boots += 1;
+  TRACE(store.write(state));
+  TRACE(store.sequence());
+  TRACE(state.boots);
+
+  AnalogPin::powerup();
+}
+
+void loop()
+{
+  // Sample with low resolution; store only when changed
+  state.sample = sensor.sample() >> 4;
+  int res = store.write(state);
+  trace << PSTR("sample = ") << state.sample
+	<< PSTR(", write = ") << res
+	<< PSTR(", sequence = ") << store.sequence()
+	<< endl;
+  sleep(2);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file CosaFader.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the Cosa fade engine; three LEDs fading in the
+ * background with different durations. The application is not
+ * blocked by the fades.
+ *
+ * @section Circuit
+ * LEDs with current limiting resistors on PWM1, PWM2 and PWM3.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Fader.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Event.hh"
+
+// Fade steps every 32 ms (watchdog scheduler time base)
+Watchdog::Scheduler scheduler;
+Fader fader(&scheduler, 32);
+Fader::Channel red(&fader, Board::PWM1);
+Fader::Channel green(&fader, Board::PWM2);
+Fader::Channel blue(&fader, Board::PWM3);
+
+void setup()
+{
+  Watchdog::begin();
+  red.begin();
+  green.begin();
+  blue.begin();
+}
+
+void loop()
+{
+  // Start new fades when the previous have completed
+  if (!red.is_fading()) red.fade(red.level() ? 0 : 255, 1024);
+  if (!green.is_fading()) green.fade(green.level() ? 0 : 255, 2048);
+  if (!blue.is_fading()) blue.fade(blue.level() ? 0 : 255, 4096);
+  Event::service();
+}
@@ -0,0 +1,65 @@
+/**
+ * @file CosaSynth.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the Cosa wavetable synthesizer with two voices
+ * playing scores in the background while the built-in LED blinks.
+ *
+ * @section Circuit
+ * Low-pass filtered PWM output on OC1A (D9) to amplifier.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Synth.hh"
+#include "Cosa/Note.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/OutputPin.hh"
+
+#if defined(BOARD_ATTINY)
+#error "CosaSynth: board not supported"
+#endif
+
+// Melody and bass line; frequency and duration (ms) pairs
+static const uint16_t melody[] __PROGMEM = {
+  Note::G4, 250, Note::A4, 250, Note::F4, 250, Note::F3, 250,
+  Note::C4, 500, Note::PAUSE, 500, Note::END
+};
+static const uint16_t bass[] __PROGMEM = {
+  Note::C3, 500, Note::F2, 500, Note::C3, 1000, Note::END
+};
+
+RTT::Scheduler scheduler;
+Synth::Player voice0(&scheduler, 0);
+Synth::Player voice1(&scheduler, 1);
+OutputPin led(Board::LED);
+
+void setup()
+{
+  RTT::begin();
+  Synth::begin();
+  voice0.play(melody, 128, true);
+  voice1.play(bass, 96, true);
+}
+
+void loop()
+{
+  // The application is not blocked by the players
+  Event::service(500);
+  led.toggle();
+}
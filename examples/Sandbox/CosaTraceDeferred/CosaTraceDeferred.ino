@@ -0,0 +1,81 @@
+/**
+ * @file CosaTraceDeferred.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of deferred trace output. The event handler traces
+ * a burst of lines and the time used; the trace output is buffered
+ * and written to the UART when the event service is idle. Compare
+ * with USE_DIRECT_TRACE where the handler blocks on the UART.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Event.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+
+// #define USE_DIRECT_TRACE
+
+#if !defined(USE_DIRECT_TRACE)
+Trace::Deferred<512> deferred(&uart);
+#endif
+
+class Burst : public Periodic {
+public:
+  Burst(Job::Scheduler* scheduler) : Periodic(scheduler, 1024), m_cycle(0) {}
+
+  virtual void run()
+  {
+    uint32_t start = RTT::micros();
+    for (uint8_t i = 0; i < 8; i++)
+      trace << PSTR("cycle=") << m_cycle << PSTR(",line=") << i << endl;
+    uint32_t us = RTT::micros() - start;
+    trace << PSTR("us=") << us;
+#if !defined(USE_DIRECT_TRACE)
+    trace << PSTR(",overflows=") << deferred.overflows();
+#endif
+    trace << endl;
+    m_cycle += 1;
+  }
+
+private:
+  uint16_t m_cycle;
+};
+
+Watchdog::Scheduler scheduler;
+Burst burst(&scheduler);
+
+void setup()
+{
+  uart.begin(9600);
+#if defined(USE_DIRECT_TRACE)
+  trace.begin(&uart, PSTR("CosaTraceDeferred: started"));
+#else
+  trace.begin(&deferred, PSTR("CosaTraceDeferred: started"));
+#endif
+  Watchdog::begin();
+  RTT::begin();
+  burst.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,74 @@
+/**
+ * @file CosaWatchdogTickless.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate Watchdog tickless mode. A periodic job blinks the
+ * built-in LED every 7 seconds. The watchdog period is selected
+ * after each timeout so that the processor wakes up only a few times
+ * per period (4096, 2048, 512, 256, 128 ms etc) instead of every
+ * 16 ms.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Event.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/OutputPin.hh"
+#include "Cosa/Power.hh"
+#include "Cosa/Watchdog.hh"
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// Blink the built-in LED with given period
+class Blinker : public Periodic {
+public:
+  Blinker(uint32_t ms) :
+    Periodic(&scheduler, ms),
+    m_led(Board::LED)
+  {}
+
+  virtual void run()
+  {
+    m_led.on();
+    delay(16);
+    m_led.off();
+  }
+
+private:
+  OutputPin m_led;
+};
+
+Blinker blinker(7000);
+
+void setup()
+{
+  // Sleep in power down mode; watchdog in tickless mode
+  Power::set(SLEEP_MODE_PWR_DOWN);
+  Watchdog::begin();
+  Watchdog::tickless(true);
+
+  // Start the periodic job
+  blinker.expire_at(Watchdog::millis() + blinker.period());
+  blinker.start();
+}
+
+void loop()
+{
+  // The standard event dispatcher
+  Event::service();
+}
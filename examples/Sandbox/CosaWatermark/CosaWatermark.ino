@@ -0,0 +1,94 @@
+/**
+ * @file CosaWatermark.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate the Cosa stack and heap low-water mark monitor. A
+ * periodic job recurses with increasing depth and the monitor
+ * reports the minimum free memory after each completed scan.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Watermark.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// Memory monitor with trace of low-water mark
+class Monitor : public Watermark {
+public:
+  Monitor() : Watermark(&scheduler, 100) {}
+
+  virtual void on_report(uint16_t low_water)
+  {
+    UNUSED(low_water);
+    trace << Watchdog::millis() << PSTR(":") << *this << endl;
+  }
+
+  virtual void on_collision(int free)
+  {
+    trace << PSTR("stack collision:free=") << free << endl;
+  }
+};
+
+Monitor monitor;
+
+// Periodic job with increasing stack depth
+class Recurse : public Periodic {
+public:
+  Recurse() : Periodic(&scheduler, 2000), m_depth(1) {}
+
+  virtual void run()
+  {
+    trace << PSTR("depth=") << m_depth
+	  << PSTR(",sum=") << sum(m_depth)
+	  << endl;
+    if (m_depth < 32) m_depth += 1;
+  }
+
+protected:
+  uint8_t m_depth;
+
+  uint16_t sum(uint8_t n)
+  {
+    volatile uint8_t buf[8];
+    buf[0] = n;
+    if (n == 0) return (0);
+    return (buf[0] + sum(n - 1));
+  }
+};
+
+Recurse recurse;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaWatermark: started"));
+  Watchdog::begin();
+  monitor.start();
+  recurse.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file Cosa9DOFstream.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of the sensor stream framework with the 10 DOF
+ * module (GY-80); ADXL345, HMC5883L and L3G4200D are sampled in one
+ * TWI bus burst per period (50 Hz).
+ *
+ * @section Circuit
+ * The GY-80 10DOF module with pull-up resistors (4K7) for TWI signals and
+ * 3V3 internal voltage converter.
+ * @code
+ *                           GY-80
+ *                       +------------+
+ * (VCC)---------------1-|VCC         |
+ *                     2-|3V3         |
+ * (GND)---------------3-|GND         |
+ * (A5/SCL)------------4-|SCL         |
+ * (A4/SDA)------------5-|SDA         |
+ *                     6-|M-DRDY      |
+ *                     7-|A-INT1      |
+ *                     8-|T-INT1      |
+ *                     9-|P-XCLR      |
+ *                    10-|P-EOC       |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <ADXL345.h>
+#include <HMC5883L.h>
+#include <L3G4200D.h>
+
+#include "Cosa/Sensor.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// The sensors and sample sources
+ADXL345 acceleratometer(1);
+ADXL345::Source acc(&acceleratometer);
+HMC5883L compass;
+HMC5883L::Source mag(&compass);
+L3G4200D gyroscope(1);
+L3G4200D::Source gyro(&gyroscope);
+
+// Sensor stream; print every 50th sample
+class IMU : public Sensor::Stream {
+public:
+  IMU() : Sensor::Stream(&scheduler, 20), m_count(0) {}
+
+  virtual void on_samples()
+  {
+    if (++m_count < 50) return;
+    m_count = 0;
+    print(PSTR("acc"), acc);
+    print(PSTR("mag"), mag);
+    print(PSTR("gyro"), gyro);
+    trace << PSTR("dropped=") << dropped() << endl;
+  }
+
+  template<class T>
+  void print(str_P name, T& source)
+  {
+    const Sensor::sample_t& s = source.sample();
+    trace << name << ':';
+    if (source.is_valid())
+      trace << s.x << ',' << s.y << ',' << s.z << endl;
+    else
+      trace << PSTR("error") << endl;
+  }
+
+private:
+  uint8_t m_count;
+};
+
+IMU imu;
+
+void setup()
+{
+  // Start trace output stream on the serial port
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("Cosa9DOFstream: started"));
+
+  // Start the watchdog ticks and the sensors
+  Watchdog::begin();
+  TRACE(acceleratometer.begin());
+  TRACE(gyroscope.begin());
+  compass.output_rate(HMC5883L::OUTPUT_RATE_75_HZ);
+  compass.mode(HMC5883L::CONTINOUS_MEASUREMENT_MODE);
+  TRACE(compass.begin());
+
+  // Attach the sources and start the stream
+  imu.attach(&acc);
+  imu.attach(&mag);
+  imu.attach(&gyro);
+  imu.start();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file CosaAlarmScheduler.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate Cosa tickless RTC alarm scheduler. The DS3231 alarm 1
+ * is programmed to the earliest pending alarm and the processor
+ * sleeps in power down mode between the alarms. There are no
+ * watchdog or timer wakeups.
+ *
+ * @section Circuit
+ * @code
+ *                        Mini RTC pro
+ *                       +------------+
+ *                     1-|32KHz       |
+ * (EXT0/D2)-----------2-|SQW         |
+ * (A5/SCL)------------3-|SCL         |
+ * (A4/SDA)------------4-|SDA         |
+ * (GND)---------------5-|GND         |
+ * (VCC)---------------6-|VCC         |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Time.hh"
+#include "Cosa/Alarm.hh"
+#include "Cosa/Power.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include <DS3231.h>
+
+// The real-time clock and the tickless alarm scheduler
+DS3231 rtc;
+Alarm::Scheduler alarms(&rtc, Board::EXT0);
+
+// Trace the expired alarms
+class TraceAlarm : public Alarm {
+public:
+  TraceAlarm(::Clock* clock, uint8_t id, uint16_t period) :
+    Alarm(clock, period),
+    m_id(id)
+  {}
+
+  void begin()
+  {
+    expire_at(time() + period());
+    start();
+  }
+
+  virtual void run()
+  {
+    trace << time_t(time()) << PSTR(":alarm:id=") << m_id << endl;
+    trace.flush();
+  }
+
+private:
+  uint8_t m_id;
+};
+
+// The alarms with the given period in seconds
+TraceAlarm alarm1(&alarms, 1, 10);
+TraceAlarm alarm2(&alarms, 2, 25);
+TraceAlarm alarm3(&alarms, 3, 60);
+
+void setup()
+{
+  // Start serial device and use as trace iostream
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaAlarmScheduler: started"));
+  trace.flush();
+
+  // Sleep in power down mode between events
+  Power::set(SLEEP_MODE_PWR_DOWN);
+
+  // Start the alarm scheduler and the alarms
+  ASSERT(alarms.begin());
+  alarm1.begin();
+  alarm2.begin();
+  alarm3.begin();
+}
+
+void loop()
+{
+  // The standard event dispatcher
+  Event::service();
+}
@@ -0,0 +1,71 @@
+/**
+ * @file CosaUARTBridge.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate Cosa event driven UART bridge on Arduino Mega. The
+ * data received on UART1 is moved to UART2 and vice versa, and the
+ * data received on UART3 is moved to the host UART. The receive
+ * buffers are drained in spans on receive events; no per character
+ * calls.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Board.hh"
+#if !defined(USART3_UDRE_vect)
+#error CosaUARTBridge: board not supported.
+#endif
+#include "Cosa/Bridge.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/IOBuffer.hh"
+#include "Cosa/UART.hh"
+
+// Buffers for the bridged UARTs
+static const uint16_t BUFFER_MAX = 64;
+static IOBuffer<BUFFER_MAX> ibuf1;
+static IOBuffer<BUFFER_MAX> obuf1;
+static IOBuffer<BUFFER_MAX> ibuf2;
+static IOBuffer<BUFFER_MAX> obuf2;
+static IOBuffer<BUFFER_MAX> ibuf3;
+static IOBuffer<BUFFER_MAX> obuf3;
+
+UART uart1(1, &ibuf1, &obuf1);
+UART uart2(2, &ibuf2, &obuf2);
+UART uart3(3, &ibuf3, &obuf3);
+
+// Bridges; receive buffer to destination UART
+Bridge::Drain<BUFFER_MAX> bridge12(&ibuf1, &uart2);
+Bridge::Drain<BUFFER_MAX> bridge21(&ibuf2, &uart1);
+Bridge::Drain<BUFFER_MAX> bridge30(&ibuf3, &uart);
+
+void setup()
+{
+  uart.begin(115200);
+  uart1.begin(115200);
+  uart2.begin(115200);
+  uart3.begin(115200);
+
+  // Start the bridges on receive events
+  uart1.notify(&bridge12);
+  uart2.notify(&bridge21);
+  uart3.notify(&bridge30);
+}
+
+void loop()
+{
+  Event::service();
+}
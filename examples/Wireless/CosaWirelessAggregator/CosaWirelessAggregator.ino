@@ -0,0 +1,139 @@
+/**
+ * @file CosaWirelessAggregator.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Wireless packet aggregation demo. The sender takes a reading
+ * every 2 seconds and the readings are sent in a combined frame when
+ * the frame is full or after the latency deadline (10 seconds). The
+ * radio is powered down between frames. The gateway splits the frames
+ * and prints the records. Build with USE_GATEWAY for the receiver.
+ *
+ * @section Circuit
+ * See Wireless drivers for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+// Configuration; network and device addresses
+// #define USE_GATEWAY
+#define NETWORK 0xC05A
+#define GATEWAY 0x01
+#if defined(USE_GATEWAY)
+#define DEVICE GATEWAY
+#else
+#define DEVICE 0x12
+#endif
+
+// Select Wireless device driver
+// #include <CC1101.h>
+// CC1101 rf(NETWORK, DEVICE);
+
+#include <NRF24L01P.h>
+NRF24L01P rf(NETWORK, DEVICE);
+
+// #include <RFM69.h>
+// RFM69 rf(NETWORK, DEVICE);
+
+// Reading record; sequence number and battery voltage (mV)
+struct reading_t {
+  uint8_t nr;
+  uint16_t battery;
+};
+static const uint8_t READING_TYPE = 0x01;
+
+#if defined(USE_GATEWAY)
+class Gateway : public Wireless::Aggregator {
+public:
+  Gateway(Wireless::Driver* dev) : Wireless::Aggregator(dev, 0) {}
+
+  // Print records per source
+  virtual void on_record(uint8_t src, uint8_t port,
+			 const void* buf, size_t len)
+  {
+    if (port != READING_TYPE || len != sizeof(reading_t)) return;
+    const reading_t* reading = (const reading_t*) buf;
+    trace << PSTR("src=") << hex << src
+	  << PSTR(",nr=") << dec << reading->nr
+	  << PSTR(",battery=") << reading->battery
+	  << endl;
+  }
+};
+
+Gateway agg(&rf);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaWirelessAggregator: gateway"));
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(rf.begin());
+}
+
+void loop()
+{
+  uint8_t src;
+  uint8_t port;
+  uint8_t frame[Wireless::Aggregator::FRAME_MAX];
+  int res = agg.recv(src, port, frame, sizeof(frame));
+  if (res < 0 || port != Wireless::Aggregator::PORT) return;
+  trace << PSTR("src=") << hex << src
+	<< PSTR(",records=") << dec << res
+	<< endl;
+}
+
+#else
+Wireless::Aggregator agg(&rf, GATEWAY, 10000);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaWirelessAggregator: sender"));
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(rf.begin());
+  rf.powerdown();
+}
+
+void loop()
+{
+  static reading_t reading = { 0, 0 };
+
+  // Add reading; sent directly when the frame is full
+  reading.battery = AnalogPin::bandgap();
+  int res = agg.add(READING_TYPE, &reading, sizeof(reading));
+  if (res < 0) trace << PSTR("add:res=") << res << endl;
+  reading.nr += 1;
+
+  // Send pending readings at the latency deadline
+  if (agg.is_expired()) {
+    res = agg.flush();
+    trace << PSTR("flush:res=") << res
+	  << PSTR(",frames=") << agg.frames()
+	  << endl;
+  }
+
+  // Sleep in power down mode
+  sleep(2);
+}
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file CosaWirelessBenchmark.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Wireless link benchmark for any Wireless::Driver. The source
+ * station sends sequence numbered messages to the echo station (same
+ * sketch with ECHO defined) for each payload size and output power
+ * level, and waits for the echo. A message without an echo within
+ * the reply wait is retransmitted (max RETRANS_MAX times) and counted
+ * as lost when all retransmissions fail. Results are written in CSV
+ * format; radio, payload size, output power (dBm), messages, lost,
+ * retransmissions, end-to-end throughput (echoed payload bytes in
+ * B/s) and round trip latency percentiles (us):
+ * @code
+ * wireless,bytes,dBm,sent,lost,retrans,bps,p50,p90,p99,max
+ * VWI,16,0,64,0,2,41,7412,7420,15104,15104
+ * @endcode
+ * Collect and compare with build/benchmark.py.
+ *
+ * @section Circuit
+ * See Wireless drivers for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Benchmark.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+// Station role; source (default) or echo
+// #define ECHO
+
+// Configuration; network and device addresses.
+#define SOURCE_ID 0x90
+#define ECHO_ID 0x91
+#define NETWORK 0xC05A
+#if defined(ECHO)
+#define DEVICE ECHO_ID
+#else
+#define DEVICE SOURCE_ID
+#endif
+
+// Select Wireless device driver and name in the results (RADIO)
+// #define RADIO "CC1101"
+// #include <CC1101.h>
+// CC1101 rf(NETWORK, DEVICE);
+
+// #define RADIO "NRF24L01P"
+// #include <NRF24L01P.h>
+// NRF24L01P rf(NETWORK, DEVICE);
+
+// #define RADIO "RFM69"
+// #include <RFM69.h>
+// RFM69 rf(NETWORK, DEVICE);
+
+#define RADIO "VWI"
+#include <VWI.h>
+#include <VirtualWireCodec.h>
+VirtualWireCodec codec;
+#define SPEED 4000
+VWI::Transmitter tx(Board::D6, &codec);
+VWI::Receiver rx(Board::D7, &codec);
+VWI rf(NETWORK, DEVICE, SPEED, &rx, &tx);
+
+// Benchmark message type and max payload
+static const uint8_t BENCH_TYPE = 0x90;
+static const uint8_t PAYLOAD_MAX = 28;
+
+// Benchmark parameters; payload sizes, output power levels (dBm),
+// messages per setting, reply wait (ms) and max retransmissions
+static const uint8_t PAYLOAD[] __PROGMEM = { 4, 16, PAYLOAD_MAX };
+static const int8_t POWER[] __PROGMEM = { 0, -6, -12, -18 };
+static const uint8_t MESSAGES = 64;
+static const uint16_t REPLY_WAIT = 200;
+static const uint8_t RETRANS_MAX = 3;
+
+// Message with sequence number and payload
+struct msg_t {
+  uint16_t nr;
+  uint8_t payload[PAYLOAD_MAX - sizeof(uint16_t)];
+};
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart);
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(rf.begin());
+}
+
+#if defined(ECHO)
+void loop()
+{
+  // Echo benchmark messages to source
+  msg_t msg;
+  uint8_t src;
+  uint8_t port;
+  int res = rf.recv(src, port, &msg, sizeof(msg));
+  if (res <= 0 || port != BENCH_TYPE) return;
+  rf.send(src, BENCH_TYPE, &msg, res);
+}
+
+#else
+
+// Round trip latency samples
+static uint16_t samples[MESSAGES];
+Benchmark::Throughput latency(samples, membersof(samples));
+
+void benchmark(uint8_t size, int8_t dBm)
+{
+  uint16_t lost = 0;
+  uint16_t retrans = 0;
+  uint32_t bytes = 0;
+  msg_t msg;
+  rf.output_power_level(dBm);
+  uint32_t start = RTT::millis();
+  for (uint16_t nr = 0; nr < MESSAGES; nr++) {
+    msg.nr = nr;
+    memset(msg.payload, nr, sizeof(msg.payload));
+    bool delivered = false;
+    for (uint8_t rc = 0; rc <= RETRANS_MAX && !delivered; rc++) {
+      if (rc != 0) retrans += 1;
+      latency.start();
+      rf.send(ECHO_ID, BENCH_TYPE, &msg, size);
+      uint32_t wait = RTT::millis();
+      while (!delivered && RTT::since(wait) < REPLY_WAIT) {
+	msg_t reply;
+	uint8_t src;
+	uint8_t port;
+	int res = rf.recv(src, port, &reply, sizeof(reply),
+			  REPLY_WAIT - RTT::since(wait));
+	if (res != size || port != BENCH_TYPE || reply.nr != nr) continue;
+	latency.stop();
+	bytes += size;
+	delivered = true;
+      }
+    }
+    if (!delivered) lost += 1;
+  }
+  uint32_t ms = RTT::since(start);
+  trace << PSTR(RADIO) << ','
+	<< size << ','
+	<< dBm << ','
+	<< MESSAGES << ','
+	<< lost << ','
+	<< retrans << ','
+	<< (ms == 0 ? 0 : (bytes * 1000L) / ms) << ','
+	<< latency.percentile(50) << ','
+	<< latency.percentile(90) << ','
+	<< latency.percentile(99) << ','
+	<< latency.percentile(100)
+	<< endl;
+  latency.reset();
+}
+
+void loop()
+{
+  trace << PSTR("wireless,bytes,dBm,sent,lost,retrans,bps,p50,p90,p99,max")
+	<< endl;
+  for (uint8_t i = 0; i < membersof(PAYLOAD); i++)
+    for (uint8_t j = 0; j < membersof(POWER); j++)
+      benchmark(pgm_read_byte(&PAYLOAD[i]), (int8_t) pgm_read_byte(&POWER[j]));
+  trace << PSTR("end") << endl;
+  rf.powerdown();
+  sleep(60);
+}
+#endif
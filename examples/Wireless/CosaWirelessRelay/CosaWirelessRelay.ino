@@ -17,7 +17,10 @@
  *
  * @section Description
  * Cosa Wireless interface demo; relay messages from CosaWirelessSender
- * and forward to CosaWirelessReceiver.
+ * and forward to CosaWirelessReceiver. Received messages are stored
+ * in buffers allocated from a fixed size pool and queued for
+ * forwarding. Messages are forwarded when the receiver is idle or
+ * the pool is empty.
  *
  * @section Circuit
  * See Wireless drivers for circuit connections.
@@ -29,6 +32,8 @@
 #include "Cosa/UART.hh"
 #include "Cosa/Watchdog.hh"
 #include "Cosa/RTT.hh"
+#include "Cosa/Pool.hh"
+#include "Cosa/Queue.hh"
 
 #include <OWI.h>
 #include <DS18B20.h>
@@ -71,37 +76,72 @@ VWI::Receiver rx(Board::D7, &codec);
 #endif
 VWI rf(NETWORK, DEVICE, SPEED, &rx, &tx);
 
+// Relay message buffers; pool and forward queue (pointers)
+struct msg_t {
+  uint8_t src;
+  uint8_t port;
+  uint8_t len;
+  uint8_t data[rf.PAYLOAD_MAX];
+};
+const uint8_t BUF_MAX = 4;
+Pool<msg_t, BUF_MAX> pool;
+Queue<msg_t*, BUF_MAX * 2> queue;
+
 void setup()
 {
   uart.begin(9600);
   trace.begin(&uart, PSTR("CosaWirelessRelay: started"));
+  TRACE(sizeof(pool));
   Watchdog::begin();
   RTT::begin();
   rf.begin();
 }
 
+void forward()
+{
+  // Forward the oldest message and return the buffer to the pool
+  msg_t* msg;
+  if (!queue.dequeue(&msg)) return;
+  rf.send(DEST, msg->port, msg->data, msg->len);
+  pool.free(msg);
+}
+
 void loop()
 {
-  // Receive a message
-  const uint32_t TIMEOUT = 5000;
-  const uint8_t MSG_MAX = rf.PAYLOAD_MAX;
-  uint8_t msg[MSG_MAX];
-  uint8_t src;
-  uint8_t port;
-  int count = rf.recv(src, port, msg, sizeof(msg), TIMEOUT);
+  // Forward a message if there are no free buffers
+  msg_t* msg = (msg_t*) pool.alloc();
+  if (msg == NULL) {
+    forward();
+    return;
+  }
 
-  // Print the message header
+  // Receive a message; short timeout when there are queued messages
+  const uint32_t TIMEOUT = queue.available() ? 100 : 5000;
+  int count = rf.recv(msg->src, msg->port,
+		      msg->data, sizeof(msg->data),
+		      TIMEOUT);
+
+  // Print the message header and queue for forwarding
   if (count >= 0 && !rf.is_broadcast()) {
-    trace << PSTR("src=") << hex << src
-	  << PSTR(",port=") << hex << port
+    trace << PSTR("src=") << hex << msg->src
+	  << PSTR(",port=") << hex << msg->port
 	  << PSTR(",dest=") << hex << rf.device_address()
 	  << PSTR(",len=") << count
 #if defined(COSA_WIRELESS_DRIVER_CC1101_HH)
 	  << PSTR(",rssi=") << rf.input_power_level()
 	  << PSTR(",lqi=") << rf.link_quality_indicator()
 #endif
+	  << PSTR(",free=") << pool.available()
 	  << endl;
-    rf.send(DEST, port, msg, count);
+    msg->len = count;
+    queue.enqueue(&msg);
+    return;
+  }
+  pool.free(msg);
+
+  // Forward queued messages when idle
+  if (count == -2 && queue.available()) {
+    forward();
   }
 
   // Check error codes
@@ -22,6 +22,7 @@
 #define COSA_ADXL345_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/Sensor.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -123,6 +124,36 @@ public:
     read(DATA, &s, sizeof(s));
   }
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Accelerometer sample source for Sensor::Stream; burst read of
+   * the data registers (little endian, no decoding).
+   */
+  class Source : public Sensor::Source {
+  public:
+    /**
+     * Construct sample source for given accelerometer.
+     * @param[in] dev accelerometer driver.
+     */
+    Source(ADXL345* dev) :
+      Sensor::Source(dev, DATA, &m_sample, sizeof(m_sample))
+    {}
+
+    /**
+     * Return latest sample.
+     * @return sample.
+     */
+    const Sensor::sample_t& sample() const
+    {
+      return (m_sample);
+    }
+
+  protected:
+    /** Latest sample. */
+    Sensor::sample_t m_sample;
+  };
+#endif
+
   /**
    * Register INT_ENABLE/INT_MAP/INT_SOURCE bitfields.
    */
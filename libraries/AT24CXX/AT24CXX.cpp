@@ -24,6 +24,7 @@
 bool
 AT24CXX::poll(const void* addr, const void* buf, size_t size)
 {
+  // Acknowledge polling; the device does not respond during write cycle
   uint8_t i = POLL_MAX;
   int m;
   do {
@@ -38,7 +39,7 @@ AT24CXX::poll(const void* addr, const void* buf, size_t size)
       twi.release();
       if (m > 0) return (true);
     }
-    delay(16);
+    DELAY(POLL_US);
   } while (--i);
   return (false);
 }
@@ -46,16 +47,22 @@ AT24CXX::poll(const void* addr, const void* buf, size_t size)
 bool
 AT24CXX::is_ready()
 {
+#if !defined(BOARD_ATTINY)
+  if (m_request.is_active()) return (false);
+#endif
   twi.acquire(this);
   uint16_t addr = 0;
   int m = twi.write(addr);
   twi.release();
-  return (m != 0);
+  return (m > 0);
 }
 
 int
 AT24CXX::read(void* dest, const void* src, size_t size)
 {
+#if !defined(BOARD_ATTINY)
+  if (UNLIKELY(m_request.is_active())) return (EBUSY);
+#endif
   if (!poll(src)) return (EIO);
   int n = twi.read(dest, size);
   twi.release();
@@ -65,6 +72,9 @@ AT24CXX::read(void* dest, const void* src, size_t size)
 int
 AT24CXX::write(void* dest, const void* src, size_t size)
 {
+#if !defined(BOARD_ATTINY)
+  if (UNLIKELY(m_request.is_active())) return (EBUSY);
+#endif
   size_t s = size;
   uint8_t* q = (uint8_t*) dest;
   uint8_t* p = (uint8_t*) src;
@@ -82,3 +92,83 @@ AT24CXX::write(void* dest, const void* src, size_t size)
   return (size);
 }
 
+bool
+AT24CXX::write_request(void* dest, const void* src, size_t size,
+		       Event::Handler* target)
+{
+#if !defined(BOARD_ATTINY)
+  return (m_request.start((uint16_t) dest, (const uint8_t*) src,
+			  size, target));
+#else
+  int res = write(dest, src, size);
+  if (UNLIKELY(res < 0)) return (false);
+  Event::push(Event::WRITE_COMPLETED_TYPE, target, res);
+  return (true);
+#endif
+}
+
+#if !defined(BOARD_ATTINY)
+
+bool
+AT24CXX::Request::start(uint16_t dest, const uint8_t* src, size_t size,
+			Event::Handler* target)
+{
+  if (UNLIKELY(size == 0)) return (false);
+  synchronized {
+    if (UNLIKELY(m_remaining != 0)) return (false);
+    m_remaining = size;
+  }
+  m_dest = dest;
+  m_src = src;
+  m_size = size;
+  m_count = 0;
+  m_target = target;
+  next();
+  return (true);
+}
+
+void
+AT24CXX::Request::next()
+{
+  // Write up to page boundary
+  AT24CXX* dev = (AT24CXX*) m_dev;
+  size_t n = dev->WRITE_MAX - (m_dest & dev->WRITE_MASK);
+  if (n > m_remaining) n = m_remaining;
+  m_count = n;
+  m_retry = RETRY_MAX;
+
+  // Build io vector with address header and page data
+  iovec_t* vp = m_vec;
+  m_header[0] = (m_dest >> 8);
+  m_header[1] = m_dest;
+  iovec_arg(vp, m_header, sizeof(m_header));
+  iovec_arg(vp, m_src, n);
+  iovec_end(vp);
+  set(m_vec);
+  if (UNLIKELY(!twi.start(this))) on_completed(Event::ERROR_TYPE, EIO);
+}
+
+void
+AT24CXX::Request::on_completed(uint8_t type, int count)
+{
+  UNUSED(type);
+
+  // Device in write cycle; acknowledge polling with retry
+  if (count < 0) {
+    if ((count == -1) && (--m_retry != 0) && twi.start(this)) return;
+    m_remaining = 0;
+    Event::push(Event::ERROR_TYPE, m_target, m_size);
+    return;
+  }
+
+  // Continue with next page; pipelined with the write cycle
+  m_dest += m_count;
+  m_src += m_count;
+  m_remaining -= m_count;
+  if (m_remaining != 0) {
+    next();
+    return;
+  }
+  Event::push(Event::WRITE_COMPLETED_TYPE, m_target, m_size);
+}
+#endif
@@ -73,6 +73,9 @@ public:
     PAGE_MAX(page_max),
     WRITE_MAX(page_max),
     WRITE_MASK(page_max - 1)
+#if !defined(BOARD_ATTINY)
+    , m_request(this)
+#endif
   {}
 
   /**
@@ -105,11 +108,127 @@ public:
    */
   virtual int write(void* dest, const void* src, size_t size);
 
+  /**
+   * @override{EEPROM::Device}
+   * Start an asynchronous write of rom block at given address with
+   * the contents from the buffer. The page writes are issued from
+   * the TWI interrupt service routine; each page is written as soon
+   * as the previous write cycle is completed (acknowledge polling).
+   * An Event::WRITE_COMPLETED_TYPE event with the number of bytes
+   * written, or Event::ERROR_TYPE, is pushed to the given target on
+   * completion. The buffer must be valid until completion. Return
+   * true(1) if the write was started otherwise false(0).
+   * @param[in] dest address in rom to write to.
+   * @param[in] src buffer to write to rom.
+   * @param[in] size number of bytes to write.
+   * @param[in] target event handler for completion (default NULL).
+   * @return bool
+   * @note On ATtiny (USI) the write is synchronous and the completion
+   * event is pushed directly.
+   */
+  virtual bool write_request(void* dest, const void* src, size_t size,
+			     Event::Handler* target = NULL);
+
+#if !defined(BOARD_ATTINY)
+  /**
+   * Return true(1) if an asynchronous write is in progress otherwise
+   * false(0).
+   * @return bool
+   */
+  bool is_write_pending() const
+  {
+    return (m_request.is_active());
+  }
+#endif
+
 private:
-  static const uint8_t POLL_MAX = 3;
+  /** Max number of acknowledge polls; more than the write cycle. */
+  static const uint8_t POLL_MAX = 200;
+
+  /** Delay between acknowledge polls (us). */
+  static const uint8_t POLL_US = 50;
+
+  /** Max number of asynchronous acknowledge polls (no delay). */
+  static const uint16_t RETRY_MAX = 1000;
+
   const uint16_t WRITE_MAX;
   const uint16_t WRITE_MASK;
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Asynchronous page write transaction. Reissued from the interrupt
+   * service routine for each page and while the device does not
+   * acknowledge (write cycle in progress).
+   */
+  class Request : public TWI::Transaction {
+  public:
+    /**
+     * Construct page write transaction for given device.
+     * @param[in] dev device.
+     */
+    Request(AT24CXX* dev) :
+      TWI::Transaction(dev),
+      m_dest(0),
+      m_src(NULL),
+      m_remaining(0),
+      m_size(0),
+      m_count(0),
+      m_retry(0),
+      m_target(NULL)
+    {
+      set_stop(true);
+    }
+
+    /**
+     * Start write of given block.
+     * @param[in] dest address in rom.
+     * @param[in] src buffer to write.
+     * @param[in] size number of bytes.
+     * @param[in] target event handler for completion.
+     * @return bool
+     */
+    bool start(uint16_t dest, const uint8_t* src, size_t size,
+	       Event::Handler* target);
+
+    /**
+     * Return true(1) if the write is in progress otherwise false(0).
+     * @return bool
+     */
+    bool is_active() const
+    {
+      return (m_remaining != 0);
+    }
+
+  protected:
+    uint16_t m_dest;		//!< Address of current page write.
+    const uint8_t* m_src;	//!< Buffer of current page write.
+    volatile size_t m_remaining; //!< Number of bytes left to write.
+    size_t m_size;		//!< Total number of bytes.
+    uint16_t m_count;		//!< Bytes in current page write.
+    uint16_t m_retry;		//!< Acknowledge polls left.
+    Event::Handler* m_target;	//!< Completion event target.
+    uint8_t m_header[2];	//!< Page write address (big-endian).
+    iovec_t m_vec[3];		//!< Page write io vector.
+
+    /**
+     * Issue write of the next page.
+     */
+    void next();
+
+    /**
+     * @override{TWI::Transaction}
+     * Reissue on no acknowledge, continue with the next page or push
+     * completion event. Called from the TWI interrupt service routine.
+     * @param[in] type event code.
+     * @param[in] count number of bytes or negative error code.
+     */
+    virtual void on_completed(uint8_t type, int count);
+  };
+
+  /** Asynchronous write transaction. */
+  Request m_request;
+#endif
+
   /**
    * Initiate TWI communication with memory device for access of
    * given memory address. If buffer is not null perform a write
@@ -0,0 +1,223 @@
+/**
+ * @file Ascon.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2013-2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+
+#include "Ascon.hh"
+
+// Initialization vector for Ascon-128 (k=128, r=64, a=12, b=6)
+static const uint32_t IV = 0x80400c06UL;
+
+// Round constants; the last rounds are used for fewer rounds
+static const uint8_t ROUND_CONSTANT[] __PROGMEM = {
+  0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87, 0x78, 0x69, 0x5a, 0x4b
+};
+
+// Load big-endian 32-bit word
+static inline uint32_t
+load(const uint8_t* bp)
+{
+  return (((uint32_t) bp[0] << 24) | ((uint32_t) bp[1] << 16) |
+	  ((uint16_t) bp[2] << 8) | bp[3]);
+}
+
+// Store big-endian 32-bit word
+static inline void
+store(uint8_t* bp, uint32_t value)
+{
+  bp[0] = value >> 24;
+  bp[1] = value >> 16;
+  bp[2] = value >> 8;
+  bp[3] = value;
+}
+
+// Linear diffusion of 64-bit word (high and low part) with given
+// rotations; x ^= (x >>> a) ^ (x >>> b)
+static inline void
+diffuse(uint32_t &hi, uint32_t &lo, uint8_t a, uint8_t b)
+  __attribute__((always_inline));
+
+static inline void
+diffuse(uint32_t &hi, uint32_t &lo, uint8_t a, uint8_t b)
+{
+  uint32_t ah, al, bh, bl;
+  if (a < 32) {
+    ah = (hi >> a) | (lo << (32 - a));
+    al = (lo >> a) | (hi << (32 - a));
+  }
+  else {
+    a -= 32;
+    ah = (lo >> a) | (hi << (32 - a));
+    al = (hi >> a) | (lo << (32 - a));
+  }
+  if (b < 32) {
+    bh = (hi >> b) | (lo << (32 - b));
+    bl = (lo >> b) | (hi << (32 - b));
+  }
+  else {
+    b -= 32;
+    bh = (lo >> b) | (hi << (32 - b));
+    bl = (hi >> b) | (lo << (32 - b));
+  }
+  hi ^= ah ^ bh;
+  lo ^= al ^ bl;
+}
+
+void
+Ascon::restart(const void* key)
+{
+  const uint8_t* kp = (const uint8_t*) key;
+  for (uint8_t i = 0; i < membersof(m_key); i++, kp += 4)
+    m_key[i] = load(kp);
+}
+
+void
+Ascon::permute(uint8_t rounds)
+{
+  uint32_t* x = m_x;
+  const uint8_t* cp = &ROUND_CONSTANT[12 - rounds];
+  while (rounds--) {
+    // Add round constant to x2 (low part)
+    x[5] ^= pgm_read_byte(cp++);
+
+    // Substitution layer; 5-bit s-box bit sliced on high and low part
+    for (uint8_t i = 0; i < 2; i++) {
+      uint32_t x0 = x[i], x1 = x[2 + i], x2 = x[4 + i];
+      uint32_t x3 = x[6 + i], x4 = x[8 + i];
+      x0 ^= x4; x4 ^= x3; x2 ^= x1;
+      uint32_t t0 = ~x0 & x1;
+      uint32_t t1 = ~x1 & x2;
+      uint32_t t2 = ~x2 & x3;
+      uint32_t t3 = ~x3 & x4;
+      uint32_t t4 = ~x4 & x0;
+      x0 ^= t1; x1 ^= t2; x2 ^= t3; x3 ^= t4; x4 ^= t0;
+      x1 ^= x0; x0 ^= x4; x3 ^= x2; x2 = ~x2;
+      x[i] = x0; x[2 + i] = x1; x[4 + i] = x2;
+      x[6 + i] = x3; x[8 + i] = x4;
+    }
+
+    // Linear diffusion layer
+    diffuse(x[0], x[1], 19, 28);
+    diffuse(x[2], x[3], 61, 39);
+    diffuse(x[4], x[5], 1, 6);
+    diffuse(x[6], x[7], 10, 17);
+    diffuse(x[8], x[9], 7, 41);
+  }
+}
+
+void
+Ascon::begin(const void* nonce, const void* ad, size_t adlen)
+{
+  // Initialize state with initialization vector, key and nonce
+  const uint8_t* np = (const uint8_t*) nonce;
+  m_x[0] = IV;
+  m_x[1] = 0;
+  memcpy(&m_x[2], m_key, sizeof(m_key));
+  for (uint8_t i = 6; i < membersof(m_x); i++, np += 4)
+    m_x[i] = load(np);
+  permute(12);
+  for (uint8_t i = 0; i < membersof(m_key); i++)
+    m_x[6 + i] ^= m_key[i];
+
+  // Absorb associated data; padded blocks
+  if (adlen != 0) {
+    const uint8_t* ap = (const uint8_t*) ad;
+    uint8_t ix = 0;
+    while (adlen--) {
+      add(ix, *ap++);
+      if (++ix < RATE) continue;
+      permute(6);
+      ix = 0;
+    }
+    add(ix, 0x80);
+    permute(6);
+  }
+
+  // Domain separation
+  m_x[9] ^= 1;
+}
+
+void
+Ascon::end(uint8_t* tag)
+{
+  for (uint8_t i = 0; i < membersof(m_key); i++)
+    m_x[2 + i] ^= m_key[i];
+  permute(12);
+  for (uint8_t i = 0; i < membersof(m_key); i++, tag += 4)
+    store(tag, m_x[6 + i] ^ m_key[i]);
+}
+
+void
+Ascon::encrypt(void* dest, const void* src, size_t len,
+	       const void* nonce,
+	       const void* ad, size_t adlen,
+	       void* tag)
+{
+  uint8_t* dp = (uint8_t*) dest;
+  const uint8_t* sp = (const uint8_t*) src;
+  uint8_t ix = 0;
+
+  // Ciphertext is the rate after adding the plaintext
+  begin(nonce, ad, adlen);
+  while (len--) {
+    add(ix, *sp++);
+    *dp++ = get(ix);
+    if (++ix < RATE) continue;
+    permute(6);
+    ix = 0;
+  }
+  add(ix, 0x80);
+  end((uint8_t*) tag);
+}
+
+bool
+Ascon::decrypt(void* dest, const void* src, size_t len,
+	       const void* nonce,
+	       const void* ad, size_t adlen,
+	       const void* tag, uint8_t size)
+{
+  uint8_t* dp = (uint8_t*) dest;
+  const uint8_t* sp = (const uint8_t*) src;
+  uint8_t ix = 0;
+  size_t count = len;
+
+  // Plaintext is the rate xor the ciphertext; rate is set to the
+  // ciphertext by adding the plaintext
+  begin(nonce, ad, adlen);
+  while (count--) {
+    uint8_t data = get(ix) ^ *sp++;
+    add(ix, data);
+    *dp++ = data;
+    if (++ix < RATE) continue;
+    permute(6);
+    ix = 0;
+  }
+  add(ix, 0x80);
+
+  // Verify the tag in constant time; clear plaintext on failure
+  uint8_t res[TAG_MAX];
+  const uint8_t* tp = (const uint8_t*) tag;
+  uint8_t diff = 0;
+  end(res);
+  if (size > TAG_MAX) size = TAG_MAX;
+  for (uint8_t i = 0; i < size; i++) diff |= res[i] ^ tp[i];
+  if (diff == 0) return (true);
+  memset(dest, 0, len);
+  return (false);
+}
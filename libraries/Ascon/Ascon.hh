@@ -0,0 +1,437 @@
+/**
+ * @file Ascon.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_ASCON_HH
+#define COSA_ASCON_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Wireless.hh"
+
+/**
+ * Ascon authenticated encryption frame buffer size. Should be at
+ * least the max payload of the wireless device driver. Default is
+ * 32 bytes.
+ */
+#ifndef COSA_ASCON_FRAME_MAX
+#define COSA_ASCON_FRAME_MAX 32
+#endif
+
+/**
+ * Ascon authenticated encryption replay window size (number of
+ * sources). Default is 8.
+ */
+#ifndef COSA_ASCON_REPLAY_MAX
+#define COSA_ASCON_REPLAY_MAX 8
+#endif
+
+/**
+ * Ascon-128 authenticated encryption with associated data (AEAD).
+ * Lightweight cipher with 128-bit key, nonce and tag, and a state
+ * of 40 bytes. The permutation is implemented with 32-bit words
+ * (64-bit words as high and low part) to suit 8-bit processors.
+ * @code
+ * Ascon cipher(key);
+ * uint8_t tag[Ascon::TAG_MAX];
+ * cipher.encrypt(buf, msg, sizeof(msg), nonce, NULL, 0, tag);
+ * ...
+ * if (!cipher.decrypt(msg, buf, sizeof(msg), nonce, NULL, 0, tag)) ...
+ * @endcode
+ * @section Limitations
+ * The nonce must never be reused with the same key.
+ * @section References
+ * 1. Ascon v1.2, Submission to NIST Lightweight Cryptography, 2021.
+ * 2. NIST SP 800-232, Ascon-Based Lightweight Cryptography Standards.
+ */
+class Ascon {
+public:
+  /** Key size in bytes. */
+  static const uint8_t KEY_MAX = 16;
+
+  /** Nonce size in bytes. */
+  static const uint8_t NONCE_MAX = 16;
+
+  /** Tag size in bytes. */
+  static const uint8_t TAG_MAX = 16;
+
+  /** Rate; number of bytes per permutation. */
+  static const uint8_t RATE = 8;
+
+  /**
+   * Construct cipher with given key.
+   * @param[in] key pointer to key (KEY_MAX bytes).
+   */
+  Ascon(const void* key)
+  {
+    restart(key);
+  }
+
+  /**
+   * Set the given key.
+   * @param[in] key pointer to key (KEY_MAX bytes).
+   */
+  void restart(const void* key);
+
+  /**
+   * Encrypt the given src buffer to the dest buffer and generate the
+   * tag for the ciphertext and the associated data. The buffers may
+   * be the same (in place).
+   * @param[in] dest ciphertext buffer pointer.
+   * @param[in] src plaintext buffer pointer.
+   * @param[in] len number of bytes.
+   * @param[in] nonce pointer to nonce (NONCE_MAX bytes).
+   * @param[in] ad associated data pointer (may be NULL).
+   * @param[in] adlen number of bytes of associated data.
+   * @param[out] tag pointer to tag (TAG_MAX bytes).
+   */
+  void encrypt(void* dest, const void* src, size_t len,
+	       const void* nonce,
+	       const void* ad, size_t adlen,
+	       void* tag);
+
+  /**
+   * Decrypt the given src buffer to the dest buffer and verify the
+   * given tag (possibly truncated). Return true(1) if the tag is
+   * valid otherwise false(0) and the dest buffer is cleared. The
+   * buffers may be the same (in place).
+   * @param[in] dest plaintext buffer pointer.
+   * @param[in] src ciphertext buffer pointer.
+   * @param[in] len number of bytes.
+   * @param[in] nonce pointer to nonce (NONCE_MAX bytes).
+   * @param[in] ad associated data pointer (may be NULL).
+   * @param[in] adlen number of bytes of associated data.
+   * @param[in] tag pointer to tag.
+   * @param[in] size number of bytes in tag (default TAG_MAX).
+   * @return bool.
+   */
+  bool decrypt(void* dest, const void* src, size_t len,
+	       const void* nonce,
+	       const void* ad, size_t adlen,
+	       const void* tag, uint8_t size = TAG_MAX);
+
+  /**
+   * Apply the permutation with the given number of rounds (max 12)
+   * to the state.
+   * @param[in] rounds number of rounds.
+   */
+  void permute(uint8_t rounds);
+
+  /**
+   * Wireless device driver filter; encrypted and authenticated
+   * frames with replay protection for any wireless device driver.
+   * The frame payload is the sender message counter (4 bytes), the
+   * ciphertext and a truncated tag (TAG_SIZE bytes). The nonce is
+   * the sender network and device address, and the counter. The
+   * destination address and port are associated data. Messages with
+   * a counter less than or equal to the latest from the source are
+   * rejected.
+   * @code
+   * VWI rf(NETWORK, DEVICE, SPEED, RX, TX, &codec);
+   * Ascon::Driver secure(&rf, key);
+   * ...
+   * secure.begin();
+   * secure.send(dest, port, &msg, sizeof(msg));
+   * @endcode
+   * @section Limitations
+   * The payload is reduced by 12 bytes. The counter starts from
+   * zero and should be set with counter() after reset (e.g. saved
+   * in EEPROM) as receivers reject lower counters. Replay state is
+   * kept for COSA_ASCON_REPLAY_MAX sources; a replaced source entry
+   * accepts any counter.
+   */
+  class Driver;
+
+protected:
+  /** State words; 64-bit words as high and low part (x0..x4). */
+  uint32_t m_x[10];
+
+  /** Key words. */
+  uint32_t m_key[4];
+
+  /**
+   * Initialize state with key and given nonce and absorb the given
+   * associated data.
+   * @param[in] nonce pointer to nonce (NONCE_MAX bytes).
+   * @param[in] ad associated data pointer.
+   * @param[in] adlen number of bytes of associated data.
+   */
+  void begin(const void* nonce, const void* ad, size_t adlen);
+
+  /**
+   * Finalize and generate the tag.
+   * @param[out] tag pointer to tag (TAG_MAX bytes).
+   */
+  void end(uint8_t* tag);
+
+  /**
+   * Return rate byte with given index (0..RATE-1).
+   * @param[in] ix byte index.
+   * @return byte.
+   */
+  uint8_t get(uint8_t ix) const
+  {
+    return (m_x[ix >> 2] >> ((3 - (ix & 3)) << 3));
+  }
+
+  /**
+   * Add (xor) given data to rate byte with given index (0..RATE-1).
+   * @param[in] ix byte index.
+   * @param[in] data to add.
+   */
+  void add(uint8_t ix, uint8_t data)
+  {
+    m_x[ix >> 2] ^= ((uint32_t) data) << ((3 - (ix & 3)) << 3);
+  }
+};
+
+class Ascon::Driver : public Wireless::Driver {
+public:
+  /** Transmitted tag size in bytes. */
+  static const uint8_t TAG_SIZE = 8;
+
+  /** Frame overhead; counter and tag. */
+  static const uint8_t HEADER_MAX = sizeof(uint32_t) + TAG_SIZE;
+
+  /** Max payload size. */
+  static const uint8_t PAYLOAD_MAX = COSA_ASCON_FRAME_MAX - HEADER_MAX;
+
+  /**
+   * Construct filter for given wireless device driver and key. The
+   * network and device address, and channel are taken from the
+   * device driver.
+   * @param[in] dev wireless device driver.
+   * @param[in] key pointer to key (Ascon::KEY_MAX bytes).
+   */
+  Driver(Wireless::Driver* dev, const void* key) :
+    Wireless::Driver(dev->network_address(), dev->device_address()),
+    m_dev(dev),
+    m_cipher(key),
+    m_counter(0),
+    m_next(0)
+  {
+    m_channel = dev->channel();
+    memset(m_entry, 0, sizeof(m_entry));
+  }
+
+  /**
+   * Return message counter; number of messages sent.
+   * @return counter.
+   */
+  uint32_t counter() const
+  {
+    return (m_counter);
+  }
+
+  /**
+   * Set message counter. Should be restored after reset.
+   * @param[in] value counter.
+   */
+  void counter(uint32_t value)
+  {
+    m_counter = value;
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set address and channel of the device driver and start it.
+   * @param[in] config configuration vector (default NULL)
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool begin(const void* config = NULL)
+  {
+    m_dev->address(m_addr.network, m_addr.device);
+    m_dev->channel(m_channel);
+    return (m_dev->begin(config));
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Shut down the device driver.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool end()
+  {
+    return (m_dev->end());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set device driver in power up mode.
+   */
+  virtual void powerup()
+  {
+    m_dev->powerup();
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set device driver in power down mode.
+   */
+  virtual void powerdown()
+  {
+    m_dev->powerdown();
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set device driver in wakeup on radio mode.
+   */
+  virtual void wakeup_on_radio()
+  {
+    m_dev->wakeup_on_radio();
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if a message is available from the device
+   * driver otherwise false(0).
+   * @return bool.
+   */
+  virtual bool available()
+  {
+    return (m_dev->available());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if there is room to send on the device driver
+   * otherwise false(0).
+   * @return bool.
+   */
+  virtual bool room()
+  {
+    return (m_dev->room());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Encrypt and authenticate message in given null terminated io
+   * vector and send to the given destination. Returns number of
+   * payload bytes sent if successful otherwise a negative error
+   * code.
+   * @param[in] dest destination network address.
+   * @param[in] port device port (or message type).
+   * @param[in] vec null termianted io vector.
+   * @return number of bytes send or negative error code.
+   */
+  virtual int send(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+  /**
+   * @override{Wireless::Driver}
+   * Receive message, verify the tag and counter, and decrypt into
+   * the given buffer. Returns the number of payload bytes, or a
+   * negative error code; EBADMSG if the tag is not valid and
+   * EACCES if the message is a replay.
+   * @param[out] src source network address.
+   * @param[out] port device port (or message type).
+   * @param[in] buf buffer to store incoming message.
+   * @param[in] len maximum number of bytes to receive.
+   * @param[in] ms maximum time out period.
+   * @return number of bytes received or negative error code.
+   */
+  virtual int recv(uint8_t& src, uint8_t& port,
+		   void* buf, size_t len,
+		   uint32_t ms = 0L);
+
+  /**
+   * @override{Wireless::Driver}
+   * Return true(1) if the latest received message was a broadcast
+   * otherwise false(0).
+   */
+  virtual bool is_broadcast()
+  {
+    return (m_dev->is_broadcast());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Set output power level of device driver in dBm.
+   * @param[in] dBm.
+   */
+  virtual void output_power_level(int8_t dBm)
+  {
+    m_dev->output_power_level(dBm);
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return input power level of device driver (dBm).
+   * @return power level in dBm.
+   */
+  virtual int input_power_level()
+  {
+    return (m_dev->input_power_level());
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return link quality indicator of device driver.
+   * @return quality indicator.
+   */
+  virtual int link_quality_indicator()
+  {
+    return (m_dev->link_quality_indicator());
+  }
+
+protected:
+  /** Number of replay entries. */
+  static const uint8_t ENTRY_MAX = COSA_ASCON_REPLAY_MAX;
+
+  /** Source replay state. */
+  struct entry_t {
+    uint8_t src;		//!< Source device address (zero if free).
+    uint32_t counter;		//!< Latest accepted counter.
+  };
+
+  /** Device driver. */
+  Wireless::Driver* m_dev;
+
+  /** Cipher with key. */
+  Ascon m_cipher;
+
+  /** Message counter. */
+  uint32_t m_counter;
+
+  /** Next entry to replace. */
+  uint8_t m_next;
+
+  /** Source replay states. */
+  entry_t m_entry[ENTRY_MAX];
+
+  /** Frame buffer; counter, ciphertext and tag. */
+  uint8_t m_frame[COSA_ASCON_FRAME_MAX];
+
+  /**
+   * Generate nonce for the given source device address and counter.
+   * @param[out] nonce buffer (Ascon::NONCE_MAX bytes).
+   * @param[in] src source device address.
+   * @param[in] counter message counter.
+   */
+  void nonce(uint8_t* nonce, uint8_t src, uint32_t counter);
+
+  /**
+   * Lookup replay state for the given source. Allocate entry
+   * (round-robin replacement) if not found.
+   * @param[in] src source device address.
+   * @return entry.
+   */
+  entry_t* lookup(uint8_t src);
+};
+
+#endif
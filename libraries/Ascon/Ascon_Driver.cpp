@@ -0,0 +1,113 @@
+/**
+ * @file Ascon_Driver.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2013-2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+
+#include "Ascon.hh"
+
+void
+Ascon::Driver::nonce(uint8_t* nonce, uint8_t src, uint32_t counter)
+{
+  memset(nonce, 0, NONCE_MAX);
+  nonce[0] = m_addr.network >> 8;
+  nonce[1] = m_addr.network;
+  nonce[2] = src;
+  memcpy(&nonce[NONCE_MAX - sizeof(counter)], &counter, sizeof(counter));
+}
+
+Ascon::Driver::entry_t*
+Ascon::Driver::lookup(uint8_t src)
+{
+  // Search for the source
+  for (uint8_t i = 0; i < ENTRY_MAX; i++)
+    if (m_entry[i].src == src) return (&m_entry[i]);
+
+  // Replace an entry; accept any counter
+  entry_t* entry = &m_entry[m_next];
+  if (++m_next == ENTRY_MAX) m_next = 0;
+  entry->src = src;
+  entry->counter = 0;
+  return (entry);
+}
+
+int
+Ascon::Driver::send(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Sanity check the io vector and message size
+  if (UNLIKELY(vec == NULL)) return (EINVAL);
+  size_t len = iovec_size(vec);
+  if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
+
+  // Gather the message after the counter
+  uint32_t counter = ++m_counter;
+  uint8_t* fp = m_frame;
+  memcpy(fp, &counter, sizeof(counter));
+  fp += sizeof(counter);
+  for (const iovec_t* vp = vec; vp->buf != NULL; vp++) {
+    memcpy(fp, vp->buf, vp->size);
+    fp += vp->size;
+  }
+
+  // Encrypt in place; destination and port are associated data
+  uint8_t iv[NONCE_MAX];
+  uint8_t ad[2] = { dest, port };
+  uint8_t tag[TAG_MAX];
+  uint8_t* payload = m_frame + sizeof(counter);
+  nonce(iv, m_addr.device, counter);
+  m_cipher.encrypt(payload, payload, len, iv, ad, sizeof(ad), tag);
+  memcpy(payload + len, tag, TAG_SIZE);
+
+  // Send the frame
+  int res = m_dev->send(dest, port, m_frame, len + HEADER_MAX);
+  if (res < 0) return (res);
+  return (len);
+}
+
+int
+Ascon::Driver::recv(uint8_t& src, uint8_t& port,
+		    void* buf, size_t len,
+		    uint32_t ms)
+{
+  // Receive the frame and check size
+  int res = m_dev->recv(src, port, m_frame, sizeof(m_frame), ms);
+  if (res < 0) return (res);
+  if (UNLIKELY(res < (int) HEADER_MAX)) return (EBADMSG);
+  size_t size = res - HEADER_MAX;
+  if (UNLIKELY(size > len)) return (EMSGSIZE);
+
+  // Verify the tag and decrypt to the given buffer
+  uint32_t counter;
+  memcpy(&counter, m_frame, sizeof(counter));
+  uint8_t iv[NONCE_MAX];
+  uint8_t ad[2] = { m_dev->is_broadcast() ? BROADCAST : m_addr.device, port };
+  const uint8_t* payload = m_frame + sizeof(counter);
+  nonce(iv, src, counter);
+  if (!m_cipher.decrypt(buf, payload, size, iv, ad, sizeof(ad),
+			payload + size, TAG_SIZE))
+    return (EBADMSG);
+
+  // Check the counter for replay; only after verification
+  entry_t* entry = lookup(src);
+  if (counter <= entry->counter) {
+    memset(buf, 0, size);
+    return (EACCES);
+  }
+  entry->counter = counter;
+  return (size);
+}
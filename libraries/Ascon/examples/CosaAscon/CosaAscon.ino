@@ -0,0 +1,113 @@
+/**
+ * @file CosaAscon.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of Ascon-128 authenticated encryption; test
+ * vectors, tamper detection and processing time. The benchmark
+ * results are written in CSV format with cycles per byte for
+ * encryption (with tag generation) of messages of different size.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Ascon.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Memory.h"
+
+// NIST LWC known answer tests (key and nonce 00..0f); count 1 and 34
+static const uint8_t TAG1[] __PROGMEM = {
+  0xe3, 0x55, 0x15, 0x9f, 0x29, 0x29, 0x11, 0xf7,
+  0x94, 0xcb, 0x14, 0x32, 0xa0, 0x10, 0x3a, 0x8a
+};
+static const uint8_t CT34[] __PROGMEM = {
+  0xbc, 0x18, 0xc3, 0xf4, 0xe3, 0x9e, 0xca, 0x72, 0x22,
+  0x49, 0x0d, 0x96, 0x7c, 0x79, 0xbf, 0xfc, 0x92
+};
+
+// Message sizes to benchmark
+static const uint8_t SIZE[] __PROGMEM = { 8, 16, 32, 64 };
+
+uint8_t key[Ascon::KEY_MAX];
+uint8_t nonce[Ascon::NONCE_MAX];
+
+void setup()
+{
+  RTT::begin();
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaAscon: started"));
+  TRACE(free_memory());
+
+  for (uint8_t i = 0; i < sizeof(key); i++) key[i] = i;
+  for (uint8_t i = 0; i < sizeof(nonce); i++) nonce[i] = i;
+  Ascon cipher(key);
+  TRACE(sizeof(Ascon));
+  TRACE(sizeof(Ascon::Driver));
+
+  // Test#1: Known answer tests
+  trace << endl << PSTR("KNOWN ANSWER TESTS") << endl;
+  uint8_t buf[64 + Ascon::TAG_MAX];
+  bool failed = false;
+  cipher.encrypt(buf, buf, 0, nonce, NULL, 0, buf);
+  if (memcmp_P(buf, TAG1, sizeof(TAG1))) {
+    trace << PSTR("1: TEST FAILED") << endl;
+    failed = true;
+  }
+  buf[0] = 0;
+  cipher.encrypt(buf, buf, 1, nonce, NULL, 0, &buf[1]);
+  if (memcmp_P(buf, CT34, sizeof(CT34))) {
+    trace << PSTR("34: TEST FAILED") << endl;
+    failed = true;
+  }
+
+  // Test#2: Decrypt and detect tampered ciphertext
+  uint8_t tag[Ascon::TAG_MAX];
+  const char ad[] = "header";
+  for (uint8_t i = 0; i < 64; i++) buf[i] = i;
+  cipher.encrypt(buf, buf, 64, nonce, ad, sizeof(ad), tag);
+  if (!cipher.decrypt(buf, buf, 64, nonce, ad, sizeof(ad), tag)) {
+    trace << PSTR("DECRYPT: TEST FAILED") << endl;
+    failed = true;
+  }
+  cipher.encrypt(buf, buf, 64, nonce, ad, sizeof(ad), tag);
+  buf[7] ^= 1;
+  if (cipher.decrypt(buf, buf, 64, nonce, ad, sizeof(ad), tag)) {
+    trace << PSTR("TAMPER: TEST FAILED") << endl;
+    failed = true;
+  }
+  if (!failed) trace << PSTR("OK") << endl;
+
+  // Test#3: Benchmark encryption; cycles per byte
+  trace << endl << PSTR("aead,bytes,us,cpb") << endl;
+  for (uint8_t i = 0; i < membersof(SIZE); i++) {
+    uint8_t size = pgm_read_byte(&SIZE[i]);
+    uint32_t start = RTT::micros();
+    cipher.encrypt(buf, buf, size, nonce, NULL, 0, tag);
+    uint32_t us = RTT::micros() - start;
+    uint32_t cpb = (us * (F_CPU / 1000000L)) / size;
+    trace << PSTR("Ascon-128,") << size << ','
+	  << us << ',' << cpb << endl;
+  }
+  trace << PSTR("end") << endl;
+}
+
+void loop()
+{
+  ASSERT(true == false);
+}
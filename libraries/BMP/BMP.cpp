@@ -0,0 +1,116 @@
+/**
+ * @file BMP.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "BMP.hh"
+
+bool
+BMP::Image::begin()
+{
+  // Read and verify the headers; uncompressed 24-bit only
+  file_header_t file_header;
+  image_header_t image_header;
+  if (!m_file->seek(0)) return (false);
+  if ((m_file->read(&file_header, sizeof(file_header))
+       != sizeof(file_header))
+      || (file_header.signature != SIGNATURE))
+    return (false);
+  if ((m_file->read(&image_header, sizeof(image_header))
+       != sizeof(image_header))
+      || (image_header.header_size < sizeof(image_header))
+      || (image_header.color_planes != 1)
+      || (image_header.bits_per_pixel != 24)
+      || (image_header.compression_method != 0)
+      || (image_header.image_width <= 0)
+      || (image_header.image_height == 0))
+    return (false);
+
+  // Image geometry; rows are padded to 4 bytes
+  m_offset = file_header.image_offset;
+  m_width = image_header.image_width;
+  m_top_down = (image_header.image_height < 0);
+  m_height = m_top_down ?
+    -image_header.image_height :
+    image_header.image_height;
+  m_row_size = ((uint16_t) m_width * 3 + 3) & ~3;
+  clip(0, 0, m_width, m_height);
+  return (true);
+}
+
+void
+BMP::Image::clip(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  if (x > m_width) x = m_width;
+  if (y > m_height) y = m_height;
+  if (width > m_width - x) width = m_width - x;
+  if (height > m_height - y) height = m_height - y;
+  m_x = x;
+  m_y = y;
+  WIDTH = width;
+  HEIGHT = height;
+  rewind();
+}
+
+bool
+BMP::Image::fill()
+{
+  if (UNLIKELY(m_row == HEIGHT)) return (false);
+
+  // Seek to the rectangle in the row; bottom-up unless top-down
+  if (m_col == 0) {
+    uint16_t row = m_y + m_row;
+    if (!m_top_down) row = m_height - 1 - row;
+    uint32_t pos = m_offset + (uint32_t) row * m_row_size + m_x * 3;
+    if ((m_file->tell() != pos) && !m_file->seek(pos)) return (false);
+  }
+
+  // Read a chunk of the row
+  uint16_t n = WIDTH - m_col;
+  if (n > PIXEL_MAX) n = PIXEL_MAX;
+  int size = n * 3;
+  if (m_file->read(m_buf, size) != size) return (false);
+  m_bp = m_buf;
+  m_avail = n;
+  m_col += n;
+  if (m_col == WIDTH) {
+    m_col = 0;
+    m_row += 1;
+  }
+  return (true);
+}
+
+bool
+BMP::Image::read(Canvas::color16_t* buf, size_t count)
+{
+  while (count != 0) {
+    if ((m_avail == 0) && !fill()) return (false);
+    uint8_t n = (count < m_avail) ? count : m_avail;
+    const uint8_t* bp = m_bp;
+    m_avail -= n;
+    count -= n;
+    for (; n != 0; n--, buf++) {
+      uint8_t blue = *bp++;
+      uint8_t green = *bp++;
+      uint8_t red = *bp++;
+      buf->rgb = ((red & 0xf8) << 8) | ((green & 0xfc) << 3) | (blue >> 3);
+    }
+    m_bp = bp;
+  }
+  return (true);
+}
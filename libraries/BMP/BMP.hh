@@ -0,0 +1,166 @@
+/**
+ * @file BMP.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_BMP_HH
+#define COSA_BMP_HH
+
+#include "Cosa/Types.h"
+#include <Canvas.h>
+#include <FAT16.h>
+
+/**
+ * Windows Bitmap (BMP) file format; uncompressed 24-bit images.
+ */
+class BMP {
+public:
+  /** File header. */
+  struct file_header_t {
+    uint16_t signature;		//!< Signature ("BM").
+    uint32_t file_size;		//!< File size in bytes.
+    uint16_t reserved[2];	//!< Reserved.
+    uint32_t image_offset;	//!< Offset to pixel data.
+  };
+
+  /** Image header (BITMAPINFOHEADER). */
+  struct image_header_t {
+    uint32_t header_size;	//!< Header size; 40 or larger.
+    int32_t image_width;	//!< Image width in pixels.
+    int32_t image_height;	//!< Image height; negative top-down.
+    uint16_t color_planes;	//!< Number of color planes; 1.
+    uint16_t bits_per_pixel;	//!< Bits per pixel; 24.
+    uint32_t compression_method; //!< Compression; 0 none.
+    uint32_t image_size;	//!< Pixel data size in bytes.
+    uint32_t horizontal_resolution; //!< Pixels per meter.
+    uint32_t vertical_resolution; //!< Pixels per meter.
+    uint32_t colors_in_palette;	//!< Number of palette colors.
+    uint32_t important_colors;	//!< Number of important colors.
+  };
+
+  /** File signature ("BM"). */
+  static const uint16_t SIGNATURE = 0x4d42;
+
+  /**
+   * Canvas image of a BMP file on FAT16. The pixel rows are read in
+   * chunks of several draw_image() buffers and converted from 24-bit
+   * BGR to color16_t. The image may be clipped to a rectangle of the
+   * bitmap; only the rows and columns in the rectangle are read.
+   * Bottom-up (positive height) and top-down (negative height) images
+   * are supported.
+   *
+   * @section Usage
+   * @code
+   * FAT16::File file;
+   * file.open("PARROT.BMP", O_READ);
+   * BMP::Image image(&file);
+   * if (image.begin()) tft.draw_image(0, 0, &image);
+   * @endcode
+   */
+  class Image : public Canvas::Image {
+  public:
+    /** Number of pixels per file read. */
+    static const uint8_t PIXEL_MAX = 2 * BUFFER_MAX;
+
+    /**
+     * Construct BMP image for given open file.
+     * @param[in] file bitmap file.
+     */
+    Image(FAT16::File* file) :
+      Canvas::Image(),
+      m_file(file),
+      m_offset(0),
+      m_row_size(0),
+      m_width(0),
+      m_height(0),
+      m_top_down(false),
+      m_x(0),
+      m_y(0),
+      m_row(0),
+      m_col(0),
+      m_avail(0),
+      m_bp(m_buf)
+    {}
+
+    /**
+     * Read and verify the file and image header. The image width
+     * and height are set to the bitmap size. Return true(1) if
+     * successful otherwise false(0); not an uncompressed 24-bit
+     * bitmap.
+     * @return bool.
+     */
+    bool begin();
+
+    /**
+     * Set the rectangle of the bitmap to read. The rectangle is
+     * clipped to the bitmap and becomes the image width and height.
+     * The image is rewound.
+     * @param[in] x left column.
+     * @param[in] y top row.
+     * @param[in] width of rectangle.
+     * @param[in] height of rectangle.
+     */
+    void clip(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+    /**
+     * Rewind the image to the first pixel of the rectangle.
+     */
+    void rewind()
+    {
+      m_row = 0;
+      m_col = 0;
+      m_avail = 0;
+    }
+
+    /**
+     * @override{Canvas::Image}
+     * Read the given number of pixels into the given buffer. Pixels
+     * are read row by row from the top. Return true(1) if successful
+     * otherwise false(0).
+     * @param[in] buf pixel buffer pointer.
+     * @param[in] count number of pixels to read.
+     * @return bool.
+     */
+    virtual bool read(Canvas::color16_t* buf, size_t count);
+
+  protected:
+    FAT16::File* m_file;	//!< Bitmap file.
+    uint32_t m_offset;		//!< Offset to pixel data.
+    uint16_t m_row_size;	//!< Bytes per row; padded to 4.
+    uint16_t m_width;		//!< Bitmap width.
+    uint16_t m_height;		//!< Bitmap height.
+    bool m_top_down;		//!< Row order.
+    uint16_t m_x;		//!< Rectangle left column.
+    uint16_t m_y;		//!< Rectangle top row.
+    uint16_t m_row;		//!< Next row in rectangle.
+    uint16_t m_col;		//!< Next column in rectangle.
+    uint8_t m_avail;		//!< Pixels available in buffer.
+    const uint8_t* m_bp;	//!< Next pixel in buffer.
+    uint8_t m_buf[PIXEL_MAX * 3]; //!< Pixel buffer; 24-bit BGR.
+
+    /**
+     * Read next chunk of pixels in the current row into the buffer.
+     * Seek to the row in the file when starting a new row. Return
+     * true(1) if successful otherwise false(0).
+     * @return bool.
+     */
+    bool fill();
+  };
+};
+
+#endif
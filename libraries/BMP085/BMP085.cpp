@@ -64,23 +64,38 @@ BMP085::sample_temperature_request()
   return (true);
 }
 
+void
+BMP085::await(uint8_t ms)
+{
+  uint16_t elapsed = Watchdog::millis() - m_start;
+  if (elapsed < ms) delay(ms - elapsed);
+}
+
 bool
 BMP085::read_temperature()
 {
   // Check that a temperature conversion request was issued
   if (UNLIKELY(m_cmd != TEMP_CONV_CMD)) return (false);
-  m_cmd = 0;
 
-  // Check if we need to wait for the conversion to complete
-  int16_t ms = Watchdog::millis() - m_start + TEMP_CONV_MS;
-  if (ms > 0) delay(ms);
+  // Wait for the conversion to complete and read result
+  await(TEMP_CONV_MS);
+  return (read_temperature_result());
+}
+
+bool
+BMP085::read_temperature_result()
+{
+  // Check that a temperature conversion request was issued
+  if (UNLIKELY(m_cmd != TEMP_CONV_CMD)) return (false);
+  m_cmd = 0;
 
   // Read the raw temperature sensor data
   int16_t UT;
   twi.acquire(this);
   twi.write(RES_REG);
-  twi.read(&UT, sizeof(UT));
+  int count = twi.read(&UT, sizeof(UT));
   twi.release();
+  if (UNLIKELY(count != sizeof(UT))) return (false);
 
   // Adjust for little endien
   UT = swap(UT);
@@ -89,6 +104,18 @@ BMP085::read_temperature()
   int32_t X1 = ((((int32_t) UT) - m_param.ac6) * m_param.ac5) >> 15;
   int32_t X2 = (((int32_t) m_param.mc) << 11) / (X1 + m_param.md);
   B5 = X1 + X2;
+
+  // Temperature dependent pressure compensation terms
+  int32_t B6 = B5 - 4000;
+  int32_t B62 = (B6 * B6) >> 12;
+  X1 = (m_param.b2 * B62) >> 11;
+  X2 = (m_param.ac2 * B6) >> 11;
+  int32_t X3 = X1 + X2;
+  B3 = ((((((int32_t) m_param.ac1) << 2) + X3) << m_mode) + 2) >> 2;
+  X1 = (m_param.ac3 * B6) >> 13;
+  X2 = (m_param.b1 * B62) >> 16;
+  X3 = ((X1 + X2) + 2) >> 2;
+  B4 = (m_param.ac4 * (uint32_t) (X3 + 32768)) >> 15;
   return (true);
 }
 
@@ -114,36 +141,34 @@ BMP085::read_pressure()
 {
   // Check that a conversion request was issued
   if (UNLIKELY(m_cmd != (PRESSURE_CONV_CMD + (m_mode << 6)))) return (false);
-  m_cmd = 0;
 
-  // Check if we need to wait for the conversion to complete
-  int16_t ms = Watchdog::millis() - m_start;
-  ms += pgm_read_byte(&PRESSURE_CONV_MS[m_mode]);
-  if (ms > 0) delay(ms);
+  // Wait for the conversion to complete and read result
+  await(pgm_read_byte(&PRESSURE_CONV_MS[m_mode]));
+  return (read_pressure_result());
+}
+
+bool
+BMP085::read_pressure_result()
+{
+  // Check that a conversion request was issued
+  if (UNLIKELY(m_cmd != (PRESSURE_CONV_CMD + (m_mode << 6)))) return (false);
+  m_cmd = 0;
 
   // Read the raw pressure sensor data
   univ32_t res;
   res.as_uint8[0] = 0;
   twi.acquire(this);
   twi.write(RES_REG);
-  twi.read(&res.as_uint8[1], 3);
+  int count = twi.read(&res.as_uint8[1], 3);
   twi.release();
+  if (UNLIKELY(count != 3)) return (false);
 
   // Adjust for little endian and resolution (oversampling mode)
   int32_t UP = swap(res.as_int32) >> (8 - m_mode);
-  int32_t B3, B6, X1, X2, X3;
-  uint32_t B4, B7;
+  int32_t X1, X2;
+  uint32_t B7;
 
-  // Pressure calculation
-  B6 = B5 - 4000;
-  X1 = (m_param.b2 * ((B6 * B6) >> 12)) >> 11;
-  X2 = (m_param.ac2 * B6) >> 11;
-  X3 = X1 + X2;
-  B3 = ((((((int32_t) m_param.ac1) << 2) + X3) << m_mode) + 2) >> 2;
-  X1 = (m_param.ac3 * B6) >> 13;
-  X2 = (m_param.b1 * ((B6 * B6) >> 12)) >> 16;
-  X3 = ((X1 + X2) + 2) >> 2;
-  B4 = (m_param.ac4 * (uint32_t) (X3 + 32768)) >> 15;
+  // Pressure calculation; temperature terms from read_temperature()
   B7 = ((uint32_t) UP - B3) * (50000 >> m_mode);
   m_pressure = (B7 < 0x80000000) ? (B7 << 1) / B4 : (B7 / B4) << 1;
   X1 = (m_pressure >> 8) * (m_pressure >> 8);
@@ -154,6 +179,52 @@ BMP085::read_pressure()
   return (true);
 }
 
+bool
+BMP085::sample_request()
+{
+  // Check that a conversion request is not in process
+  if (UNLIKELY(m_cmd != 0)) return (false);
+
+  // Blocking sample without scheduler
+  if (!m_conversion.is_scheduled()) {
+    bool res = true;
+    if (m_count == 0) res = sample_temperature();
+    if (++m_count == m_rate) m_count = 0;
+    res = res && sample_pressure();
+    on_sample_completed(res);
+    return (res);
+  }
+
+  // Start temperature or pressure conversion and time the conversion
+  if (m_count == 0) {
+    if (!sample_temperature_request()) return (false);
+    m_conversion.start(TEMP_CONV_MS);
+  }
+  else {
+    if (!sample_pressure_request()) return (false);
+    m_conversion.start(pgm_read_byte(&PRESSURE_CONV_MS[m_mode]));
+  }
+  if (++m_count == m_rate) m_count = 0;
+  return (true);
+}
+
+void
+BMP085::step()
+{
+  // Temperature conversion completed; continue with pressure
+  if (m_cmd == TEMP_CONV_CMD) {
+    if (read_temperature_result() && sample_pressure_request()) {
+      m_conversion.start(pgm_read_byte(&PRESSURE_CONV_MS[m_mode]));
+      return;
+    }
+    on_sample_completed(false);
+    return;
+  }
+
+  // Pressure conversion completed
+  on_sample_completed(read_pressure_result());
+}
+
 IOStream&
 operator<<(IOStream& outs, BMP085& bmp)
 {
@@ -23,10 +23,18 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/TWI.hh"
+#include "Cosa/Job.hh"
 #include "Cosa/IOStream.hh"
 
 /**
- * Cosa TWI driver for Bosch BMP085 Digital pressure sensor
+ * Cosa TWI driver for Bosch BMP085 Digital pressure sensor. With a
+ * job scheduler (milli-second time base, e.g. Watchdog::Scheduler)
+ * the temperature and pressure conversions are timed with a job and
+ * sample_request() returns directly; the result is delivered with
+ * on_sample_completed() from the event handler. The temperature
+ * dependent compensation terms are calculated once per temperature
+ * sample and the temperature may be sampled less often than the
+ * pressure, see temperature_rate().
  *
  * @section Circuit
  * The GY-80 10DOF module with pull-up resistors (4K7) for TWI signals and
@@ -65,14 +73,22 @@ public:
 
   /**
    * Construct BMP085 driver with I2C address(0x77) and default
-   * ULTRA_LOW_POWER mode.
+   * ULTRA_LOW_POWER mode. The conversions of sample_request() are
+   * timed with the given job scheduler (milli-seconds) if given
+   * otherwise with a blocking delay.
+   * @param[in] scheduler for conversion time (Default NULL).
    */
-  BMP085() :
+  BMP085(Job::Scheduler* scheduler = NULL) :
     TWI::Driver(0x77),
     m_mode(ULTRA_LOW_POWER),
     m_cmd(0),
     m_start(0),
+    m_conversion(scheduler, this),
+    m_rate(1),
+    m_count(0),
     B5(0),
+    B3(0),
+    B4(0),
     m_pressure(0)
   {}
 
@@ -144,6 +160,36 @@ public:
     return (sample_temperature() && sample_pressure());
   }
 
+  /**
+   * Set number of pressure samples per temperature sample for
+   * sample_request() (Default 1).
+   * @param[in] rate pressure samples per temperature sample.
+   */
+  void temperature_rate(uint8_t rate)
+  {
+    m_rate = (rate == 0) ? 1 : rate;
+    m_count = 0;
+  }
+
+  /**
+   * Initiate an asynchronous sample request; temperature (according
+   * to temperature_rate()) and pressure. Returns immediately when a
+   * job scheduler is used. The result is delivered with
+   * on_sample_completed(). Return true(1) if successful otherwise
+   * false(0), e.g. a request is already in progress.
+   * @return bool.
+   */
+  bool sample_request();
+
+  /**
+   * Return true(1) if a conversion is in progress otherwise false(0).
+   * @return bool.
+   */
+  bool is_busy() const
+  {
+    return (m_cmd != 0);
+  }
+
   /**
    * Calculate temperature from the latest raw sensor reading.
    * @return calculated temperature in steps of 0.1 C
@@ -165,6 +211,92 @@ public:
   }
 
 protected:
+  /**
+   * Conversion timer; steps the sample request when the conversion
+   * time has expired. Run from the event handler.
+   */
+  class Conversion : public Job {
+  public:
+    /**
+     * Construct conversion timer for given device.
+     * @param[in] scheduler for conversion time.
+     * @param[in] bmp device.
+     */
+    Conversion(Job::Scheduler* scheduler, BMP085* bmp) :
+      Job(scheduler),
+      m_bmp(bmp)
+    {}
+
+    /**
+     * Start timer with given conversion time.
+     * @param[in] ms conversion time (milli-seconds).
+     */
+    void start(uint8_t ms)
+    {
+      expire_at(time() + ms);
+      Job::start();
+    }
+
+    /**
+     * Return true(1) if there is a scheduler otherwise false(0).
+     * @return bool.
+     */
+    bool is_scheduled() const
+    {
+      return (m_scheduler != NULL);
+    }
+
+    /**
+     * @override{Job}
+     * Step the sample request of the device.
+     */
+    virtual void run()
+    {
+      m_bmp->step();
+    }
+
+  protected:
+    BMP085* m_bmp;		//!< Device.
+  };
+
+  /**
+   * @override{BMP085}
+   * Called when a sample request has completed; from the event
+   * handler when a job scheduler is used. Default handler is empty.
+   * @param[in] valid sample read and calculated.
+   */
+  virtual void on_sample_completed(bool valid)
+  {
+    UNUSED(valid);
+  }
+
+  /**
+   * Step the sample request; read temperature and issue pressure
+   * conversion, or read pressure and complete.
+   */
+  void step();
+
+  /**
+   * Wait for the given conversion time since the request.
+   * @param[in] ms conversion time.
+   */
+  void await(uint8_t ms);
+
+  /**
+   * Read the raw temperature sensor after conversion and calculate
+   * the temperature dependent compensation. Return true(1) if
+   * successful otherwise false.
+   * @return bool
+   */
+  bool read_temperature_result();
+
+  /**
+   * Read the raw pressure sensor after conversion and calculate the
+   * pressure. Return true(1) if successful otherwise false.
+   * @return bool
+   */
+  bool read_pressure_result();
+
   /** Temperature conversion time max (ms). */
   static const uint8_t TEMP_CONV_MS = 5;
 
@@ -216,9 +348,22 @@ protected:
   /** Sample request start time (ms). */
   uint16_t m_start;
 
+  /** Conversion timer. */
+  Conversion m_conversion;
+
+  /** Pressure samples per temperature sample. */
+  uint8_t m_rate;
+
+  /** Pressure samples since temperature sample. */
+  uint8_t m_count;
+
   /** Common intermediate temperature factor. */
   int32_t B5;
 
+  /** Temperature dependent pressure compensation terms. */
+  int32_t B3;
+  uint32_t B4;
+
   /** Latest calculated pressure. */
   int32_t m_pressure;
 };
@@ -106,75 +106,19 @@ Base64::encode_P(char* dest, const void* src, size_t size)
 int
 Base64::encode(IOStream::Device* dest, const void* src, size_t size)
 {
-  const uint8_t* sp = (const uint8_t*) src;
-  base64_t temp;
-  int res = 0;
-
-  // Encode three byte blocks with line break every 64 characters
-  while (size > 2) {
-    temp.d[2] = *sp++;
-    temp.d[1] = *sp++;
-    temp.d[0] = *sp++;
-    size = size - 3;
-    dest->putchar(encode(temp.c3));
-    dest->putchar(encode(temp.c2));
-    dest->putchar(encode(temp.c1));
-    dest->putchar(encode(temp.c0));
-    res = res + 4;
-    if ((res & 0x3f) == 0) dest->puts((str_P) IOStream::CRLF);
-  }
-
-  // Pad and encode any remaining bytes with possible line break
-  if (size != 0) {
-    temp.d[2] = *sp++;
-    temp.d[1] = size > 1 ? *sp : 0;
-    temp.d[0] = 0;
-    dest->putchar(encode(temp.c3));
-    dest->putchar(encode(temp.c2));
-    dest->putchar(size > 1 ? encode(temp.c1) : PAD);
-    dest->putchar(PAD);
-    res = res + 4;
-    if ((res & 0x3f) == 0) dest->puts((str_P) IOStream::CRLF);
-  }
-
-  return (res);
+  Encoder encoder(dest);
+  int res = encoder.feed(src, size);
+  if (res < 0) return (res);
+  return (encoder.finish());
 }
 
 int
 Base64::encode_P(IOStream::Device* dest, const void* src, size_t size)
 {
-  const uint8_t* sp = (const uint8_t*) src;
-  base64_t temp;
-  int res = 0;
-
-  // Encode three byte blocks with line break every 64 characters
-  while (size > 2) {
-    temp.d[2] = pgm_read_byte(sp++);
-    temp.d[1] = pgm_read_byte(sp++);
-    temp.d[0] = pgm_read_byte(sp++);
-    size = size - 3;
-    dest->putchar(encode(temp.c3));
-    dest->putchar(encode(temp.c2));
-    dest->putchar(encode(temp.c1));
-    dest->putchar(encode(temp.c0));
-    res = res + 4;
-    if ((res & 0x3f) == 0) dest->puts((str_P) IOStream::CRLF);
-  }
-
-  // Pad and encode any remaining bytes with possible line break
-  if (size != 0) {
-    temp.d[2] = pgm_read_byte(sp++);
-    temp.d[1] = size > 1 ? pgm_read_byte(sp) : 0;
-    temp.d[0] = 0;
-    dest->putchar(encode(temp.c3));
-    dest->putchar(encode(temp.c2));
-    dest->putchar(size > 1 ? encode(temp.c1) : PAD);
-    dest->putchar(PAD);
-    res = res + 4;
-    if ((res & 0x3f) == 0) dest->puts((str_P) IOStream::CRLF);
-  }
-
-  return (res);
+  Encoder encoder(dest);
+  int res = encoder.feed_P(src, size);
+  if (res < 0) return (res);
+  return (encoder.finish());
 }
 
 int
@@ -204,3 +148,129 @@ Base64::decode(void* dest, const char* src, size_t size)
   // Return number of bytes
   return (res);
 }
+
+void
+Base64::Encoder::encode(uint8_t d0, uint8_t d1, uint8_t d2, uint8_t n)
+{
+  base64_t temp;
+  temp.d[2] = d0;
+  temp.d[1] = d1;
+  temp.d[0] = d2;
+  m_buf[m_len++] = Base64::encode(temp.c3);
+  m_buf[m_len++] = Base64::encode(temp.c2);
+  m_buf[m_len++] = n > 1 ? Base64::encode(temp.c1) : PAD;
+  m_buf[m_len++] = n > 2 ? Base64::encode(temp.c0) : PAD;
+  m_count += 4;
+  if (m_len == LINE_MAX) flush();
+}
+
+void
+Base64::Encoder::flush()
+{
+  if (m_len == LINE_MAX && m_lines) {
+    m_buf[m_len++] = '\r';
+    m_buf[m_len++] = '\n';
+  }
+  if (m_len == 0) return;
+  int res = m_dest->write(m_buf, m_len);
+  if (res < 0) m_error = res;
+  m_len = 0;
+}
+
+// Read byte from given buffer in data or program memory
+static inline uint8_t
+read(const uint8_t* bp, bool progmem)
+{
+  return (progmem ? pgm_read_byte(bp) : *bp);
+}
+
+int
+Base64::Encoder::append(const uint8_t* sp, size_t size, bool progmem)
+{
+  // Complete any carried block
+  while (m_carried != 0 && size != 0) {
+    m_carry[m_carried++] = read(sp++, progmem);
+    size -= 1;
+    if (m_carried < 3) continue;
+    encode(m_carry[0], m_carry[1], m_carry[2]);
+    m_carried = 0;
+  }
+
+  // Encode three byte blocks
+  for (; size > 2; size -= 3, sp += 3)
+    encode(read(sp, progmem), read(sp + 1, progmem), read(sp + 2, progmem));
+
+  // Carry any remaining bytes to the next feed
+  while (size--) m_carry[m_carried++] = read(sp++, progmem);
+  return (m_error != 0 ? m_error : m_count);
+}
+
+int
+Base64::Encoder::finish()
+{
+  // Pad and encode carried bytes and write the buffered characters
+  if (m_carried != 0)
+    encode(m_carry[0], m_carried > 1 ? m_carry[1] : 0, 0, m_carried);
+  flush();
+  int res = (m_error != 0 ? m_error : m_count);
+  reset();
+  return (res);
+}
+
+void
+Base64::Decoder::flush()
+{
+  if (m_len == 0) return;
+  int res = m_dest->write(m_buf, m_len);
+  if (res < 0) m_error = res;
+  m_len = 0;
+}
+
+int
+Base64::Decoder::feed(const char* src, size_t size)
+{
+  while (size-- && m_error == 0) {
+    char c = *src++;
+
+    // Skip white space and count padding
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+    int8_t bits;
+    if (c == PAD) {
+      if (++m_pad > 2) m_error = EINVAL;
+      bits = 0;
+    }
+    else {
+      bits = value(c);
+      if (UNLIKELY(bits < 0 || m_pad != 0)) {
+	m_error = EINVAL;
+	break;
+      }
+    }
+
+    // Decode four characters to three bytes (less if padded)
+    m_bits = (m_bits << 6) | bits;
+    if (++m_chars < 4) continue;
+    put(m_bits >> 16);
+    if (m_pad < 2) put(m_bits >> 8);
+    if (m_pad < 1) put(m_bits);
+    m_bits = 0;
+    m_chars = 0;
+  }
+  return (m_error != 0 ? m_error : m_count);
+}
+
+int
+Base64::Decoder::finish()
+{
+  // Decode carried characters; unpadded end of data
+  if (m_chars == 1 || (m_pad != 0 && m_chars != 0)) m_error = EINVAL;
+  else if (m_chars == 2) put(m_bits >> 4);
+  else if (m_chars == 3) {
+    put(m_bits >> 10);
+    put(m_bits >> 2);
+  }
+  flush();
+  int res = (m_error != 0 ? m_error : m_count);
+  reset();
+  return (res);
+}
@@ -29,6 +29,8 @@
  * 4 printable characters, 32-bits. Allows encoding directly to an
  * IOStream::Device such as the UART. Long string to an device is
  * broken into multiple lines with a max length of 64 characters.
+ * Large payloads may be encoded and decoded in chunks with the
+ * streaming Base64::Encoder and Base64::Decoder.
  *
  * @section Acknowledgements
  * Inspired by implementation method by Bob Trower and Arduino Forum
@@ -98,6 +100,33 @@ public:
    */
   static int decode(void* dest, const char* src, size_t size);
 
+  /**
+   * Streaming Base64 encoder. Binary data is fed in any number of
+   * chunks and the encoded characters are written to the iostream
+   * device in blocks of a line (64 characters and new-line). Up to
+   * two bytes are carried between feeds. Large payloads (e.g. from
+   * program memory or a flash device) are encoded with constant
+   * memory.
+   * @code
+   * Base64::Encoder encoder(&socket);
+   * while ((n = flash.read(buf, addr, sizeof(buf))) > 0) {
+   *   encoder.feed(buf, n);
+   *   addr += n;
+   * }
+   * encoder.finish();
+   * @endcode
+   */
+  class Encoder;
+
+  /**
+   * Streaming Base64 decoder. Encoded characters are fed in any
+   * number of chunks and the decoded data is written to the iostream
+   * device in blocks. Up to three characters are carried between
+   * feeds. White space (new-line) is ignored and padding is
+   * optional.
+   */
+  class Decoder;
+
 private:
   /** Padding character for last encoded block */
   static const char PAD = '=';
@@ -142,6 +171,194 @@ private:
     uint8_t bits = pgm_read_byte(&DECODE[c - 43]);
     return (bits == '$' ? 0 : bits - 62);
   }
+
+  /**
+   * Decode given character to 6-bit number. Return negative value
+   * for illegal characters.
+   * @param[in] c character to decode.
+   * @return 6-bit representation or negative value.
+   */
+  static int8_t value(char c)
+    __attribute__((always_inline))
+  {
+    if (UNLIKELY(c < 43 || c > 122)) return (-1);
+    uint8_t bits = pgm_read_byte(&DECODE[c - 43]);
+    return (bits == '$' ? -1 : bits - 62);
+  }
+};
+
+class Base64::Encoder {
+public:
+  /** Max number of characters per line. */
+  static const uint8_t LINE_MAX = 64;
+
+  /**
+   * Construct streaming encoder to the given iostream device. A
+   * new-line is emitted every LINE_MAX characters if lines is
+   * true(1) (default).
+   * @param[in] dest output stream device.
+   * @param[in] lines line break (default true).
+   */
+  Encoder(IOStream::Device* dest, bool lines = true) :
+    m_dest(dest),
+    m_lines(lines)
+  {
+    reset();
+  }
+
+  /**
+   * Reset encoder state. Any carried bytes and buffered characters
+   * are discarded.
+   */
+  void reset()
+  {
+    m_carried = 0;
+    m_len = 0;
+    m_count = 0;
+    m_error = 0;
+  }
+
+  /**
+   * Encode the given number of bytes in the source buffer. Returns
+   * number of encoded characters so far or negative error code.
+   * @param[in] src source buffer pointer (binary).
+   * @param[in] size number of bytes to encode.
+   * @return length or negative error code.
+   */
+  int feed(const void* src, size_t size)
+  {
+    return (append((const uint8_t*) src, size, false));
+  }
+
+  /**
+   * Encode the given number of bytes in the source buffer in program
+   * memory. Returns number of encoded characters so far or negative
+   * error code.
+   * @param[in] src source buffer pointer (binary, in program memory).
+   * @param[in] size number of bytes to encode.
+   * @return length or negative error code.
+   */
+  int feed_P(const void* src, size_t size)
+  {
+    return (append((const uint8_t*) src, size, true));
+  }
+
+  /**
+   * Pad and encode any carried bytes and write buffered characters
+   * to the device. Returns total number of encoded characters (not
+   * including new-lines) or negative error code. The encoder is
+   * reset.
+   * @return length or negative error code.
+   */
+  int finish();
+
+protected:
+  IOStream::Device* m_dest;	//!< Output stream device.
+  bool m_lines;			//!< Line break.
+  uint8_t m_carry[3];		//!< Carried bytes.
+  uint8_t m_carried;		//!< Number of carried bytes.
+  uint8_t m_len;		//!< Number of buffered characters.
+  int m_count;			//!< Number of encoded characters.
+  int m_error;			//!< Latest device error code.
+  char m_buf[LINE_MAX + 2];	//!< Line buffer.
+
+  /**
+   * Encode given buffer.
+   * @param[in] sp source buffer pointer.
+   * @param[in] size number of bytes to encode.
+   * @param[in] progmem source in program memory.
+   * @return length or negative error code.
+   */
+  int append(const uint8_t* sp, size_t size, bool progmem);
+
+  /**
+   * Encode three byte block; given number of bytes (1..3) and the
+   * rest is padded.
+   * @param[in] d0 first byte.
+   * @param[in] d1 second byte.
+   * @param[in] d2 third byte.
+   * @param[in] n number of bytes.
+   */
+  void encode(uint8_t d0, uint8_t d1, uint8_t d2, uint8_t n = 3);
+
+  /**
+   * Write buffered characters (and new-line) to the device.
+   */
+  void flush();
+};
+
+class Base64::Decoder {
+public:
+  /** Size of output buffer. */
+  static const uint8_t BUF_MAX = 48;
+
+  /**
+   * Construct streaming decoder to the given iostream device.
+   * @param[in] dest output stream device.
+   */
+  Decoder(IOStream::Device* dest) :
+    m_dest(dest)
+  {
+    reset();
+  }
+
+  /**
+   * Reset decoder state. Any carried characters and buffered data
+   * are discarded.
+   */
+  void reset()
+  {
+    m_bits = 0;
+    m_chars = 0;
+    m_pad = 0;
+    m_len = 0;
+    m_count = 0;
+    m_error = 0;
+  }
+
+  /**
+   * Decode the given number of characters in the source buffer.
+   * Returns number of decoded bytes so far or negative error code;
+   * EINVAL for illegal characters.
+   * @param[in] src source buffer pointer (string).
+   * @param[in] size number of characters to decode.
+   * @return number of bytes or negative error code.
+   */
+  int feed(const char* src, size_t size);
+
+  /**
+   * Decode any carried characters (unpadded end of data) and write
+   * buffered data to the device. Returns total number of decoded
+   * bytes or negative error code. The decoder is reset.
+   * @return number of bytes or negative error code.
+   */
+  int finish();
+
+protected:
+  IOStream::Device* m_dest;	//!< Output stream device.
+  uint32_t m_bits;		//!< Carried bits.
+  uint8_t m_chars;		//!< Number of carried characters.
+  uint8_t m_pad;		//!< Number of padding characters.
+  uint8_t m_len;		//!< Number of buffered bytes.
+  int m_count;			//!< Number of decoded bytes.
+  int m_error;			//!< Latest error code.
+  uint8_t m_buf[BUF_MAX];	//!< Output buffer.
+
+  /**
+   * Buffer given byte and write buffer to device when full.
+   * @param[in] data byte.
+   */
+  void put(uint8_t data)
+  {
+    m_buf[m_len++] = data;
+    m_count += 1;
+    if (m_len == BUF_MAX) flush();
+  }
+
+  /**
+   * Write buffered data to the device.
+   */
+  void flush();
 };
 
 #endif
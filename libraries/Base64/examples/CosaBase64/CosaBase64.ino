@@ -123,6 +123,33 @@ void loop()
   // Note: the measurement is bound by the UART buffer size
   sleep(1);
 
+  // Stream encode the large string in chunks; constant memory
+  Base64::Encoder encoder(&uart);
+  size_t len = strlen_P(citation);
+  start = RTT::micros();
+  for (size_t i = 0; i < len; i += sizeof(temp)) {
+    size_t size = len - i;
+    if (size > sizeof(temp)) size = sizeof(temp);
+    encoder.feed_P(citation + i, size);
+  }
+  n = encoder.finish();
+  stop = RTT::micros();
+  trace << endl;
+  trace << n << PSTR(":encoder:") << (stop - start) << PSTR(" us") << endl;
+  trace << endl;
+  sleep(1);
+
+  // Stream decode in chunks with line break and without padding
+  Base64::Decoder decoder(&uart);
+  decoder.feed("TWFuIGlz", 8);
+  decoder.feed("IGRp\r\n", 6);
+  decoder.feed("c3Rpbmd1aXNoZWQ", 15);
+  m = decoder.finish();
+  trace << endl;
+  trace << m << PSTR(":decoder") << endl;
+  trace << endl;
+  sleep(1);
+
   ASSERT(true == false);
 }
 
@@ -71,6 +71,18 @@ public:
     return ((symbol >> 1) & 0xf);
   }
 
+  /**
+   * @override{VWI::Codec}
+   * Returns 8-bit data for given two packed symbols. Inline decode
+   * without virtual dispatch per symbol.
+   * @return 8-bit data.
+   */
+  virtual uint8_t decode8(uint16_t symbol)
+  {
+    return ((BitstuffingCodec::decode4(symbol) << 4) |
+	    (BitstuffingCodec::decode4(symbol >> BITS_PER_SYMBOL)));
+  }
+
 private:
   /** Message preamble */
   static const uint8_t s_preamble[] PROGMEM;
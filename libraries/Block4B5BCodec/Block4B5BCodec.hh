@@ -70,6 +70,18 @@ public:
     return (pgm_read_byte(&s_codes[symbol & SYMBOL_MASK]));
   }
 
+  /**
+   * @override{VWI::Codec}
+   * Returns 8-bit data for given two packed symbols. Inline decode
+   * without virtual dispatch per symbol.
+   * @return 8-bit data.
+   */
+  virtual uint8_t decode8(uint16_t symbol)
+  {
+    return ((Block4B5BCodec::decode4(symbol) << 4) |
+	    (Block4B5BCodec::decode4(symbol >> BITS_PER_SYMBOL)));
+  }
+
 private:
   /** Symbol mapping table: 4 to 5 bits */
   static const uint8_t s_symbols[] PROGMEM;
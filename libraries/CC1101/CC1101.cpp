@@ -93,7 +93,9 @@ CC1101::IRQPin::on_interrupt(uint16_t arg)
 {
   UNUSED(arg);
   if (m_rf == 0) return;
+  m_rf->m_stamp = RTT::micros();
   m_rf->m_avail = true;
+  if (m_rf->m_wor) disable();
 }
 
 CC1101::CC1101(uint16_t net, uint8_t dev,
@@ -102,7 +104,10 @@ CC1101::CC1101(uint16_t net, uint8_t dev,
   SPI::Driver(csn, SPI::ACTIVE_LOW, SPI::DIV4_CLOCK, 0, SPI::MSB_ORDER, &m_irq),
   Wireless::Driver(net, dev),
   m_irq(irq, ExternalInterrupt::ON_FALLING_MODE, this),
-  m_status(0)
+  m_status(0),
+  m_burst(0),
+  m_rx_time(WOR_RX_TIME),
+  m_wor(false)
 {
 }
 
@@ -177,22 +182,26 @@ CC1101::send(uint8_t dest, uint8_t port, const iovec_t* vec)
   size_t len = iovec_size(vec);
   if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
 
-  // Write frame length and header(dest, src, port) and payload buffers
-  spi.acquire(this);
-    spi.begin();
-      loop_until_bit_is_clear(PIN, Board::MISO);
-      m_status = spi.transfer(header_t(TXFIFO, 1, 0));
-      spi.transfer(len + 3);
-      spi.transfer(dest);
-      spi.transfer(m_addr.device);
-      spi.transfer(port);
-      spi.write(vec);
-    spi.end();
-  spi.release();
+  // Repeat the frame for the wake-up burst period (if any)
+  uint32_t start = RTT::millis();
+  do {
+    // Write frame length and header(dest, src, port) and payload buffers
+    spi.acquire(this);
+      spi.begin();
+        loop_until_bit_is_clear(PIN, Board::MISO);
+        m_status = spi.transfer(header_t(TXFIFO, 1, 0));
+        spi.transfer(len + 3);
+        spi.transfer(dest);
+        spi.transfer(m_addr.device);
+        spi.transfer(port);
+        spi.write(vec);
+      spi.end();
+    spi.release();
 
-  // Trigger transmission and wait for completion
-  strobe(STX);
-  await(IDLE_MODE);
+    // Trigger transmission and wait for completion
+    strobe(STX);
+    await(IDLE_MODE);
+  } while (RTT::since(start) < m_burst);
 
   return (len);
 }
@@ -213,14 +222,17 @@ CC1101::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
   uint32_t start = RTT::millis();
   uint8_t size;
 
-  // Put in receive mode and wait for incoming message
-  strobe(SFRX);
-  strobe(SRX);
-  m_avail = false;
+  // Put in receive mode (unless wake-on-radio) and wait for incoming
+  // message. The receiver stays in wake-on-radio mode on timeout
+  if (!m_wor) {
+    strobe(SFRX);
+    strobe(SRX);
+    m_avail = false;
+  }
   do {
     while (!m_avail && ((ms == 0) || (RTT::since(start) < ms))) yield();
     if (!m_avail) {
-      strobe(SIDLE);
+      if (!m_wor) strobe(SIDLE);
       return (ETIME);
     }
     // Check the received frame size
@@ -230,6 +242,7 @@ CC1101::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
 	size = read(RXBYTES);
       spi.end();
     spi.release();
+    if (m_wor && ((size & BYTES_MASK) == 0)) wor_restart();
   } while ((size & BYTES_MASK) == 0);
 
   // Put in idle mode and read the payload
@@ -245,6 +258,7 @@ CC1101::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
 	spi.end();
 	spi.release();
 	strobe(SFRX);
+	if (m_wor) wor_restart();
 	return (EMSGSIZE);
       }
 
@@ -252,10 +266,15 @@ CC1101::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
       m_dest = spi.transfer(0);
       src = spi.transfer(0);
       port = spi.transfer(0);
-      spi.read(buf, size);
-      spi.read(&m_recv_status, sizeof(m_recv_status));
+      iovec_t vec[3];
+      iovec_t* vp = vec;
+      iovec_arg(vp, buf, size);
+      iovec_arg(vp, &m_recv_status, sizeof(m_recv_status));
+      iovec_end(vp);
+      spi.read(vec);
     spi.end();
   spi.release();
+  if (m_wor) wor_restart();
 
   // Fix: Add address checking for robustness
   return (size);
@@ -268,11 +287,79 @@ CC1101::powerdown()
   strobe(SPWD);
 }
 
+void
+CC1101::powerup()
+{
+  // Wake up the device and restore the edge triggered interrupt and
+  // no receive timeout after wake-on-radio mode
+  strobe(SIDLE);
+  await(IDLE_MODE);
+  if (!m_wor) return;
+  m_irq.disable();
+  m_irq.interrupt_mode(ExternalInterrupt::ON_FALLING_MODE);
+  m_wor = false;
+  spi.acquire(this);
+    spi.begin();
+      loop_until_bit_is_clear(PIN, Board::MISO);
+      write(MCSM2, 0x07);
+    spi.end();
+  spi.release();
+  m_irq.enable();
+}
+
 void
 CC1101::wakeup_on_radio()
 {
+  // Low level interrupt; edge interrupts will not wake from power down
+  m_irq.disable();
+  m_irq.interrupt_mode(ExternalInterrupt::ON_LOW_LEVEL_MODE);
+  m_wor = true;
+
+  // Set receive timeout; continue receive on preamble quality reached
   await(IDLE_MODE);
+  spi.acquire(this);
+    spi.begin();
+      loop_until_bit_is_clear(PIN, Board::MISO);
+      write(MCSM2, 0x08 | m_rx_time);
+    spi.end();
+  spi.release();
+  strobe(SWORRST);
+  wor_restart();
+}
+
+void
+CC1101::wor_restart()
+{
+  strobe(SIDLE);
+  strobe(SFRX);
+  m_avail = false;
   strobe(SWOR);
+  m_irq.enable();
+}
+
+void
+CC1101::wor_timing(uint16_t ms, uint8_t rx_time, uint8_t event1)
+{
+  // EVENT0 period is 750/fXOSC * event0 * 2^(5 * WOR_RES); fXOSC 26 MHz.
+  // Use the finest resolution that covers the period
+  uint32_t event0 = (ms * 104UL) / 3;
+  uint8_t res = 0;
+  if (event0 > 0xffffUL) {
+    event0 = (ms * 13UL) / 12;
+    res = 1;
+    if (event0 > 0xffffUL) event0 = 0xffffUL;
+  }
+  uint16_t evt = hton((uint16_t) event0);
+
+  // Enable RC oscillator and calibration, set start-up time and resolution
+  m_rx_time = rx_time & 0x07;
+  spi.acquire(this);
+    spi.begin();
+      loop_until_bit_is_clear(PIN, Board::MISO);
+      write(WOREVT1, &evt, sizeof(evt));
+      write(WORCTRL, ((event1 & 0x07) << 4) | 0x08 | res);
+    spi.end();
+  spi.release();
 }
 
 void
@@ -52,6 +52,32 @@
  *                       +------------+
  * @endcode
  *
+ * @section Wake-on-Radio
+ * The receiver may duty-cycle with wake-on-radio. The device sleeps
+ * and wakes up every EVENT0 period to listen for a preamble. The
+ * interrupt pin is switched to low level in this mode so that the
+ * processor may sleep in SLEEP_MODE_PWR_DOWN (see Power::set()) until
+ * a frame is received. The sender should use a wake-up burst that
+ * is at least as long as the receiver period. The frame is repeated
+ * for the burst period, and a receiver may get more than one copy.
+ * A receive timeout requires a running timer. Use a blocking recv()
+ * to sleep in power down. Call powerup() before send().
+ * @code
+ * // Receiver
+ * rf.begin();
+ * rf.wor_timing(500);
+ * rf.wakeup_on_radio();
+ * Power::set(SLEEP_MODE_PWR_DOWN);
+ * ...
+ * int res = rf.recv(src, port, &msg, sizeof(msg));
+ *
+ * // Sender
+ * rf.begin();
+ * rf.wakeup_burst(500);
+ * ...
+ * rf.send(dest, port, &msg, sizeof(msg));
+ * @endcode
+ *
  * @section References
  * 1. Product Description, SWRS061H, Rev. H, 2012-10-09
  * http://www.ti.com/lit/ds/symlink/cc1101.pdf
@@ -168,10 +194,54 @@ public:
 
   /**
    * @override{Wireless::Driver}
-   * Set device in wakeup on radio mode.
+   * Set device in idle mode. Leaves wake-on-radio mode and restores
+   * the edge triggered interrupt pin.
+   */
+  virtual void powerup();
+
+  /**
+   * @override{Wireless::Driver}
+   * Set device in wake-on-radio mode. The timing should be set with
+   * wor_timing(). The device will stay in the mode after receiving
+   * messages with recv() until powerup().
    */
   virtual void wakeup_on_radio();
 
+  /**
+   * Default wake-on-radio receive timeout and oscillator start-up.
+   */
+  static const uint8_t WOR_RX_TIME = 2;
+  static const uint8_t WOR_EVENT1 = 7;
+
+  /**
+   * Set wake-on-radio timing; the EVENT0 period in milli-seconds
+   * (max 60 seconds), the receive timeout (MCSM2.RX_TIME) and the
+   * crystal oscillator start-up time (WORCTRL.EVENT1). The receive
+   * timeout is a fraction of the period; 3.6% for 0 and halved for
+   * each step (0..6). Receive continues after the timeout when a
+   * preamble is detected. The start-up time is 4, 6, 8, 12, 16, 24,
+   * 32 or 48 RC oscillator periods (0..7). The latency is the given
+   * period plus the message transmission time.
+   * @param[in] ms period (milli-seconds).
+   * @param[in] rx_time receive timeout (Default WOR_RX_TIME).
+   * @param[in] event1 oscillator start-up (Default WOR_EVENT1).
+   */
+  void wor_timing(uint16_t ms,
+		  uint8_t rx_time = WOR_RX_TIME,
+		  uint8_t event1 = WOR_EVENT1);
+
+  /**
+   * Set transmit wake-up burst period in milli-seconds. Messages
+   * are repeated for the given period so that a receiver in
+   * wake-on-radio mode with the same (or shorter) period will wake
+   * up and receive a copy. Zero(0) to disable (default).
+   * @param[in] ms burst period (milli-seconds).
+   */
+  void wakeup_burst(uint16_t ms)
+  {
+    m_burst = ms;
+  }
+
   /**
    * @override{Wireless::Driver}
    * Set output power level (-30..10 dBm)
@@ -642,6 +712,12 @@ protected:
     };
   };
 
+  /**
+   * Flush receiver fifo and restart wake-on-radio mode after a
+   * receive.
+   */
+  void wor_restart();
+
   /**
    * Handler for interrupt pin. Service interrupt on incoming message
    * with valid checksum.
@@ -664,6 +740,8 @@ protected:
     /**
      * @override{Interrupt::Handler}
      * Signal message has been receive and is available in receive fifo.
+     * The low level interrupt in wake-on-radio mode is disabled until
+     * the message has been read.
      * @param[in] arg (not used).
      */
     virtual void on_interrupt(uint16_t arg = 0);
@@ -679,6 +757,9 @@ private:
   IRQPin m_irq;			//!< Interrupt pin and handler.
   status_t m_status;		//!< Status from latest transaction.
   recv_status_t m_recv_status;	//!< Status frm latest message receive.
+  uint16_t m_burst;		//!< Transmit wake-up burst period (ms).
+  uint8_t m_rx_time;		//!< Wake-on-radio receive timeout.
+  bool m_wor;			//!< Wake-on-radio mode.
 };
 #endif
 #endif
@@ -154,8 +154,13 @@ CC3000::Driver::read(void* buf, size_t size)
 int
 CC3000::Driver::flush()
 {
-  // Force send of buffered message
-  return (ENOSYS);
+  // Wait for posted messages to be sent
+  uint32_t start = RTT::millis();
+  while (m_dev->pending() != 0) {
+    if (RTT::since(start) >= m_dev->m_timeout) return (ETIME);
+    if (m_dev->poll() == 0) yield();
+  }
+  return (0);
 }
 
 int
@@ -238,10 +243,11 @@ CC3000::Driver::recv(void* buf, size_t len, uint8_t src[4], uint16_t& port)
 int
 CC3000::Driver::write(const void* buf, size_t size, bool progmem)
 {
-  UNUSED(buf);
-  UNUSED(size);
-  UNUSED(progmem);
-  return (ENOSYS);
+  // Post message; wait for free device buffer
+  if (progmem) return (ENOSYS);
+  int res;
+  while ((res = m_dev->post(m_hndl, buf, size)) == EAGAIN) yield();
+  return (res);
 }
 
 int
@@ -715,6 +721,58 @@ CC3000::send(int hndl, const void* buf, size_t size)
   return (evnt.result);
 }
 
+int
+CC3000::post(int hndl, const void* buf, size_t size)
+{
+  if (size > BUFFER_MAX) return (EMSGSIZE);
+  if (m_buffer_avail == 0) poll();
+  if (m_buffer_avail == 0) return (EAGAIN);
+  hci_data_send_t cmnd(hndl, size);
+  int res = write_data(HCI_DATA_SEND, &cmnd, sizeof(cmnd), buf, size);
+  if (UNLIKELY(res < 0)) return (res);
+
+  // The send event is discarded when received
+  if (expect(HCI_EVNT_SEND) < 0) {
+    hci_evnt_send_t evnt;
+    res = await(HCI_EVNT_SEND, &evnt, sizeof(evnt));
+    if (UNLIKELY(res < 0)) return (res);
+  }
+  m_buffer_avail -= 1;
+  return (size);
+}
+
+int
+CC3000::select_request(int hndls,
+		       uint32_t readhndls, uint32_t writehndls, uint32_t errorhndls,
+		       uint32_t sec, uint32_t us)
+{
+  if (UNLIKELY(m_select >= 0)) return (EBUSY);
+  hci_cmnd_select_t cmnd(hndls, readhndls, writehndls, errorhndls, sec, us);
+  int res = issue(HCI_CMND_SELECT, &cmnd, sizeof(cmnd));
+  if (UNLIKELY(res < 0)) return (res);
+  res = expect(HCI_EVNT_SELECT, &m_select_evnt, sizeof(m_select_evnt));
+  if (UNLIKELY(res < 0)) return (res);
+  m_select = res;
+  return (0);
+}
+
+int
+CC3000::select_result(uint32_t &readhndls, uint32_t &writehndls,
+		      uint32_t &errorhndls)
+{
+  if (UNLIKELY(m_select < 0)) return (EINVAL);
+  poll();
+  int res = result(m_select);
+  if (res == EINPROGRESS) return (res);
+  m_select = -1;
+  if (UNLIKELY(res < 0)) return (res);
+  if (UNLIKELY(m_select_evnt.status != 0)) return (EFAULT);
+  readhndls = m_select_evnt.read_set;
+  writehndls = m_select_evnt.write_set;
+  errorhndls = m_select_evnt.error_set;
+  return (m_select_evnt.result);
+}
+
 int
 CC3000::bind(int hndl, int port)
 {
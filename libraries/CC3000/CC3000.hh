@@ -283,7 +283,8 @@ public:
     HCI(cs, irq, rate),
     m_vbat(vbat, 0),
     m_evnt_handler(this),
-    m_active_set(0)
+    m_active_set(0),
+    m_select(-1)
   {
     event_handler(&m_evnt_handler);
   }
@@ -628,6 +629,46 @@ public:
    */
   int send(int hndl, const void* buf, size_t size);
 
+  /**
+   * Post message from given buffer with given size. Does not wait for
+   * the send event; the message is pipelined with other commands.
+   * Returns number of bytes posted, EAGAIN if there are no free device
+   * buffers, or negative error code.
+   * @param[in] hndl socket descriptor.
+   * @param[in] buf message buffer.
+   * @param[in] size of message buffer.
+   * @return number of bytes or negative error code.
+   */
+  int post(int hndl, const void* buf, size_t size);
+
+  /**
+   * Issue select command for given set of handles without waiting for
+   * the result. Only one select may be in flight. Returns zero or
+   * negative error code (EBUSY if a select is already in flight).
+   * @param[in] hndls number of handles in set (max handle number + 1).
+   * @param[in] readhndls read handle set.
+   * @param[in] writehndls write handle set.
+   * @param[in] errorhndls error handle set.
+   * @param[in] sec timeout in seconds.
+   * @param[in] us timeout in micro-seconds.
+   * @return zero or negative error code.
+   */
+  int select_request(int hndls,
+		     uint32_t readhndls, uint32_t writehndls, uint32_t errorhndls,
+		     uint32_t sec = 0UL, uint32_t us = 0UL);
+
+  /**
+   * Poll for the result of the select command in flight. Returns
+   * number of handles and the handle sets, EINPROGRESS if not yet
+   * received, otherwise a negative error code.
+   * @param[out] readhndls read handle set.
+   * @param[out] writehndls write handle set.
+   * @param[out] errorhndls error handle set.
+   * @return number of handles or negative error code.
+   */
+  int select_result(uint32_t &readhndls, uint32_t &writehndls,
+		    uint32_t &errorhndls);
+
   /**
    * Bind socket to given port and . Returns zero or negative
    * error code.
@@ -1550,6 +1591,12 @@ protected:
     uint8_t count;
     uint16_t bytes;
   };
+
+  /** Select event slot in flight or negative. */
+  int8_t m_select;
+
+  /** Select event block for select_request(). */
+  hci_evnt_select_t m_select_evnt;
 };
 
 #endif
@@ -139,6 +139,9 @@ HCI::await(uint16_t op, void* args, uint8_t len)
     // Return on negative error code
     if (res < 0) return (res);
 
+    // Check for commands in flight; registered before this command
+    if (match(event, res)) continue;
+
     // Check for event code and event size match
     if (op == event && res == len) {
       if (args != NULL) memcpy(args, m_evnt, res);
@@ -154,6 +157,73 @@ HCI::await(uint16_t op, void* args, uint8_t len)
   return (ENOMSG);
 }
 
+int
+HCI::expect(uint16_t op, void* args, uint8_t len)
+{
+  for (uint8_t i = 0; i < EXPECT_MAX; i++) {
+    expect_t* ep = &m_expect[i];
+    if (ep->op != 0) continue;
+    ep->op = op;
+    ep->args = args;
+    ep->len = len;
+    ep->res = EINPROGRESS;
+    ep->seq = m_seq++;
+    m_pending += 1;
+    return (i);
+  }
+  return (ENOSPC);
+}
+
+int
+HCI::result(uint8_t slot)
+{
+  if (UNLIKELY(slot >= EXPECT_MAX)) return (EINVAL);
+  expect_t* ep = &m_expect[slot];
+  int res = ep->res;
+  if (res != EINPROGRESS) ep->op = 0;
+  return (res);
+}
+
+bool
+HCI::match(uint16_t op, int len)
+{
+  // Find the oldest expected event with the given code
+  expect_t* ep = NULL;
+  for (uint8_t i = 0; i < EXPECT_MAX; i++) {
+    if (m_expect[i].op != op || m_expect[i].res != EINPROGRESS) continue;
+    if (ep == NULL || (int8_t) (m_expect[i].seq - ep->seq) < 0)
+      ep = &m_expect[i];
+  }
+  if (ep == NULL) return (false);
+
+  // Copy the arguments or release the slot if discarded
+  m_pending -= 1;
+  if (ep->args == NULL) {
+    ep->op = 0;
+    return (true);
+  }
+  if (len > ep->len) len = ep->len;
+  memcpy(ep->args, m_evnt, len);
+  ep->res = len;
+  return (true);
+}
+
+int
+HCI::poll()
+{
+  // Check that a message is available
+  if (!m_available) return (0);
+  uint16_t event;
+  int res = read(event, m_evnt, EVNT_MAX);
+  if (res == ENOMSG) return (0);
+  if (res < 0) return (res);
+
+  // Match expected events and pass others to the message handler
+  if (!match(event, res) && (m_event_handler != NULL))
+    m_event_handler->on_event(event, m_evnt, res);
+  return (1);
+}
+
 int
 HCI::read_data(uint8_t op, void* args, uint8_t args_len,
 	       void* data, uint16_t data_len)
@@ -73,8 +73,11 @@ public:
     m_irq(irq, this),
     m_available(false),
     m_timeout(DEFAULT_TIMEOUT),
-    m_event_handler(NULL)
+    m_event_handler(NULL),
+    m_pending(0),
+    m_seq(0)
   {
+    memset(m_expect, 0, sizeof(m_expect));
   }
 
   /**
@@ -167,6 +170,48 @@ public:
    */
   int await(uint16_t op, void* args = NULL, uint8_t len = 0);
 
+  /**
+   * Register expected HCI event for a command in flight. The event
+   * is matched (in order of registration) by await() and poll()
+   * and the arguments are copied to the given block. The event is
+   * discarded when the argument block is NULL, otherwise the result
+   * should be collected with result(). Returns slot index or negative
+   * error code (ENOSPC).
+   * @param[in] op HCI event code expected.
+   * @param[in] args pointer to argument block (Default NULL).
+   * @param[in] len max number of bytes in argument block (Default 0).
+   * @return slot index or negative error code.
+   */
+  int expect(uint16_t op, void* args = NULL, uint8_t len = 0);
+
+  /**
+   * Return result of expected HCI event with given slot index;
+   * argument length or negative error code, or EINPROGRESS if the
+   * event has not been received. The slot is released when the
+   * event has been received.
+   * @param[in] slot index from expect().
+   * @return argument length or negative error code.
+   */
+  int result(uint8_t slot);
+
+  /**
+   * Return number of commands in flight (expected events).
+   * @return number of expected events.
+   */
+  uint8_t pending() const
+  {
+    return (m_pending);
+  }
+
+  /**
+   * Read and dispatch an incoming HCI event without waiting. Expected
+   * events are matched and other events are passed to the event
+   * handler. Returns one(1) if an event was dispatched, zero(0) if
+   * no message was available, otherwise negative error code.
+   * @return one, zero or negative error code.
+   */
+  int poll();
+
   /**
    * Write data with given data operation code, argument block and
    * data payload. Returns number of bytes written or negative error
@@ -354,5 +399,36 @@ protected:
 
   /** Default event block. */
   uint8_t m_evnt[EVNT_MAX];
+
+  /** Max number of commands in flight. */
+  static const uint8_t EXPECT_MAX = 4;
+
+  /** Expected HCI event; command in flight. */
+  struct expect_t {
+    uint16_t op;		//!< Expected event code (zero when free).
+    void* args;			//!< Argument block or NULL (discard).
+    uint8_t len;		//!< Max number of bytes in argument block.
+    int8_t res;			//!< Result or EINPROGRESS.
+    uint8_t seq;		//!< Registration sequence number.
+  };
+
+  /** Expected event table. */
+  expect_t m_expect[EXPECT_MAX];
+
+  /** Number of expected events in flight. */
+  uint8_t m_pending;
+
+  /** Next registration sequence number. */
+  uint8_t m_seq;
+
+  /**
+   * Match given event with the expected events (in order of
+   * registration) and copy the arguments from the default event
+   * block. Returns true(1) if matched otherwise false(0).
+   * @param[in] op HCI event code.
+   * @param[in] len number of bytes in event block.
+   * @return bool.
+   */
+  bool match(uint16_t op, int len);
 };
 #endif
@@ -19,9 +19,24 @@
  */
 
 #include "CFFS.hh"
+#include <util/crc16.h>
 
 Flash::Device* CFFS::device = NULL;
 uint32_t CFFS::current_dir_addr = 0L;
+uint16_t CFFS::next_sector = 1;
+uint16_t CFFS::free_count = 0;
+uint16_t CFFS::stale_count = 0;
+uint32_t CFFS::checkpoint_addr = 0L;
+bool CFFS::checkpoint_valid = false;
+
+static uint16_t
+checksum(const void* buf, size_t size)
+{
+  const uint8_t* bp = (const uint8_t*) buf;
+  uint16_t crc = 0xffff;
+  while (size--) crc = _crc_xmodem_update(crc, *bp++);
+  return (crc);
+}
 
 int
 CFFS::File::open(const char* filename, uint8_t oflag)
@@ -73,7 +88,7 @@ CFFS::File::close()
 {
   if (m_flags == 0) return (ENXIO);
   m_flags = 0;
-  return (0);
+  return (CFFS::sync());
 }
 
 int
@@ -246,9 +261,145 @@ CFFS::begin(Flash::Device* flash)
   // A file system and root directory exists
   device = flash;
   current_dir_addr = addr;
+
+  // Restore sector state from checkpoint or scan sector headers
+  if (restore()) return (true);
+  if (scan()) return (true);
+  device = NULL;
+  return (false);
+}
+
+bool
+CFFS::scan()
+{
+  // Count free and stale sectors. Continue allocation after the last
+  // sector before the largest run of free sectors
+  free_count = 0;
+  stale_count = 0;
+  next_sector = 1;
+  uint16_t run = 0;
+  uint16_t max = 0;
+  uint32_t addr = device->SECTOR_BYTES;
+  for (uint16_t i = 1; i < device->SECTOR_MAX; i++) {
+    uint16_t type;
+    if (device->read(&type, addr, sizeof(type)) != sizeof(type))
+      return (false);
+    if (type == FREE_TYPE) {
+      free_count += 1;
+      if (++run > max) {
+	max = run;
+	next_sector = i - run + 1;
+      }
+    }
+    else {
+      if (type == STALE_BLOCK_TYPE) stale_count += 1;
+      run = 0;
+    }
+    addr += device->SECTOR_BYTES;
+  }
+  return (true);
+}
+
+bool
+CFFS::restore()
+{
+  // Check for checkpoint sector
+  uint32_t sector = checkpoint_sector();
+  uint16_t type;
+  checkpoint_addr = 0L;
+  checkpoint_valid = false;
+  if (device->read(&type, sector, sizeof(type)) != sizeof(type))
+    return (false);
+  if (type != CHECKPOINT_BLOCK_TYPE) return (false);
+
+  // Binary search for the first free record
+  uint32_t base = sector + sizeof(descr_t);
+  uint16_t low = 0;
+  uint16_t high = (device->SECTOR_BYTES - sizeof(descr_t)) / sizeof(checkpoint_t);
+  while (low < high) {
+    uint16_t mid = (low + high) / 2;
+    uint32_t addr = base + (uint32_t) mid * sizeof(checkpoint_t);
+    if (device->read(&type, addr, sizeof(type)) != sizeof(type))
+      return (false);
+    if (type == FREE_TYPE) high = mid; else low = mid + 1;
+  }
+  if (low == 0) return (false);
+
+  // Read and validate the latest record
+  checkpoint_t checkpoint;
+  checkpoint_addr = base + (uint32_t) (low - 1) * sizeof(checkpoint_t);
+  if (device->read(&checkpoint, checkpoint_addr, sizeof(checkpoint))
+      != sizeof(checkpoint))
+    return (false);
+  if (checkpoint.type != CHECKPOINT_TYPE) return (false);
+  if (checkpoint.crc != checksum(&checkpoint, sizeof(checkpoint) - 2))
+    return (false);
+  next_sector = checkpoint.next_sector;
+  free_count = checkpoint.free_count;
+  stale_count = checkpoint.stale_count;
+  checkpoint_valid = true;
   return (true);
 }
 
+int
+CFFS::invalidate()
+{
+  // Clear the type of the latest checkpoint record
+  if (!checkpoint_valid) return (0);
+  checkpoint_valid = false;
+  const uint16_t type = 0;
+  if (device->write(checkpoint_addr, &type, sizeof(type)) != sizeof(type))
+    return (EIO);
+  return (0);
+}
+
+int
+CFFS::sync()
+{
+  // Check that the file system driver is initiated
+  if (device == NULL) return (ENXIO);
+
+  // Write buffered data and checkpoint if the state has changed
+  if (device->flush() != 0) return (EIO);
+  if (checkpoint_valid) return (0);
+
+  // Check for checkpoint sector
+  uint32_t sector = checkpoint_sector();
+  uint16_t type;
+  if (device->read(&type, sector, sizeof(type)) != sizeof(type))
+    return (EIO);
+  if (type != CHECKPOINT_BLOCK_TYPE) return (0);
+
+  // Next record address; erase and restart the sector when full
+  uint32_t addr = (checkpoint_addr == 0L) ?
+    sector + sizeof(descr_t) :
+    checkpoint_addr + sizeof(checkpoint_t);
+  if ((addr & device->SECTOR_MASK) + sizeof(checkpoint_t) > device->SECTOR_BYTES) {
+    descr_t header;
+    if (device->erase(sector, device->SECTOR_BYTES / 1024) != 0) return (EIO);
+    memset(&header, 0, sizeof(header));
+    header.type = CHECKPOINT_BLOCK_TYPE;
+    header.size = device->SECTOR_BYTES;
+    header.ref = NULL_REF;
+    if (device->write(sector, &header, sizeof(header)) != sizeof(header))
+      return (EIO);
+    addr = sector + sizeof(descr_t);
+  }
+
+  // Write the checkpoint record
+  checkpoint_t checkpoint;
+  checkpoint.type = CHECKPOINT_TYPE;
+  checkpoint.next_sector = next_sector;
+  checkpoint.free_count = free_count;
+  checkpoint.stale_count = stale_count;
+  checkpoint.crc = checksum(&checkpoint, sizeof(checkpoint) - 2);
+  if (device->write(addr, &checkpoint, sizeof(checkpoint)) != sizeof(checkpoint))
+    return (EIO);
+  checkpoint_addr = addr;
+  checkpoint_valid = true;
+  return (0);
+}
+
 int
 CFFS::ls(IOStream& outs)
 {
@@ -350,8 +501,17 @@ CFFS::format(Flash::Device* flash, const char* name)
   if (flash->write(addr, &header, sizeof(header)) != sizeof(header))
     return (EIO);
 
+  // Write checkpoint sector header
+  addr = (uint32_t) (flash->SECTOR_MAX - 1) * flash->SECTOR_BYTES;
+  memset(&header, 0, sizeof(header));
+  header.type = CHECKPOINT_BLOCK_TYPE;
+  header.size = flash->SECTOR_BYTES;
+  header.ref = NULL_REF;
+  if (flash->write(addr, &header, sizeof(header)) != sizeof(header))
+    return (EIO);
+
   // Write root directory
-  addr += sizeof(header);
+  addr = sizeof(header);
   memset(&header, 0, sizeof(header));
   header.type = DIR_BLOCK_TYPE;
   header.size = flash->DEFAULT_SECTOR_BYTES - sizeof(header);
@@ -455,22 +615,59 @@ CFFS::remove(uint32_t addr, uint16_t type)
 
   // Save reference to sector to erase
   uint32_t ref = entry.ref;
+  if (invalidate() != 0) return (EIO);
 
   // Mark the entry as removed in the directory block
   memset(&entry, 0, sizeof(entry));
   if (device->write(addr, &entry, sizeof(entry)) != sizeof(entry))
     return (EIO);
 
-  // Erase sectors
+  // Mark sectors as stale; erased by garbage collection
+  const uint16_t stale = STALE_BLOCK_TYPE;
   while (ref != NULL_REF) {
     if (device->read(&entry, ref, sizeof(entry)) != sizeof(entry))
       return (EIO);
-    if (device->erase(ref, entry.size / 1024) != 0) return (EIO);
+    if (entry.type != FILE_BLOCK_TYPE) return (ENXIO);
+    if (device->write(ref, &stale, sizeof(stale)) != sizeof(stale))
+      return (EIO);
+    stale_count += 1;
     ref = entry.ref;
   }
   return (0);
 }
 
+int
+CFFS::erase(uint32_t addr)
+{
+  if (invalidate() != 0) return (EIO);
+  if (device->erase(addr, device->SECTOR_BYTES / 1024) != 0) return (EIO);
+  stale_count -= 1;
+  free_count += 1;
+  return (0);
+}
+
+int
+CFFS::gc(uint16_t max)
+{
+  // Check that the file system driver is initiated
+  if (device == NULL) return (ENXIO);
+
+  // Erase stale sectors
+  uint32_t addr = device->SECTOR_BYTES;
+  uint16_t type;
+  int count = 0;
+  for (uint16_t i = 1; (i < device->SECTOR_MAX) && (stale_count != 0); i++) {
+    if (device->read(&type, addr, sizeof(type)) != sizeof(type))
+      return (EIO);
+    if (type == STALE_BLOCK_TYPE) {
+      if (erase(addr) != 0) return (EIO);
+      if ((uint16_t) ++count == max) break;
+    }
+    addr += device->SECTOR_BYTES;
+  }
+  return (count);
+}
+
 int
 CFFS::read(void* dest, uint32_t src, size_t size)
 {
@@ -504,16 +701,22 @@ CFFS::next_free_sector()
   // Check that the file system driver is initiated
   if (device == NULL) return (0L);
 
-  // Search for a free sector
+  // Search for a free sector from the next sector; erase a stale
+  // sector if there are no free sectors
   descr_t header;
-  uint32_t addr = device->SECTOR_BYTES;
+  uint16_t type = (free_count != 0) ? FREE_TYPE : STALE_BLOCK_TYPE;
+  uint16_t sector = next_sector;
   for (uint16_t i = 1; i < device->SECTOR_MAX; i++) {
+    uint32_t addr = sector * device->SECTOR_BYTES;
+    if (++sector == device->SECTOR_MAX) sector = 1;
     if (device->read(&header, addr, sizeof(header)) != sizeof(header))
       return (0L);
-    if (header.type != FREE_TYPE) {
-      addr += device->SECTOR_BYTES;
-      continue;
-    }
+    if (header.type != type) continue;
+    if ((type == STALE_BLOCK_TYPE) && (erase(addr) != 0)) return (0L);
+    if (invalidate() != 0) return (0L);
+    next_sector = sector;
+    free_count -= 1;
+
     // Initiate the sector header
     header.type = FILE_BLOCK_TYPE;
     header.size = device->SECTOR_BYTES;
@@ -543,6 +746,10 @@ CFFS::next_free_directory()
 	return (0L);
       if (header.type == FREE_TYPE) break;
     }
+    if (header.type == FREE_TYPE) {
+      if (invalidate() != 0) return (0L);
+      free_count -= 1;
+    }
   }
   else {
     addr = device->DEFAULT_SECTOR_BYTES;
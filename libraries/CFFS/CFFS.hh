@@ -28,6 +28,24 @@
 /**
  * Cosa Flash File System for Flash Memory.
  *
+ * @section Wear Leveling
+ * File data is always appended (page program). Sectors of removed
+ * files are marked as stale (page program of the sector header)
+ * instead of erased. Stale sectors are erased by gc(), or on demand
+ * when there are no free sectors. Sectors are allocated next-fit from
+ * a rotating position, which spreads erase cycles over the device.
+ * The sector state counters and allocation position are rebuilt when
+ * the volume is mounted.
+ *
+ * @section Checkpoint
+ * The last sector of the device is reserved for checkpoint records
+ * (sector counters and allocation position with check sum). A record
+ * is appended on file close and sync() when the state has changed,
+ * and invalidated on the first following change. Mount uses the
+ * latest valid record (binary search) and falls back to a full sector
+ * scan after an unclean shutdown or on volumes without a checkpoint
+ * sector.
+ *
  * @section Limitations
  * Directory entries are not reclaimed (directory block is not erased
  * and rewritten when full).
@@ -70,6 +88,10 @@ protected:
    * DIR_BLOCK_TYPE is directory block header; size is the directory
    * sector, ref is the address to the next directory block (NULL is
    * encoded as 0xffffffffL, NULL_REF)
+   *
+   * STALE_BLOCK_TYPE is a file block of a removed file; the
+   * allocated bit of the FILE_BLOCK_TYPE is cleared. The sector is
+   * erased by garbage collection.
    */
   enum {
     CFFS_TYPE = 0xf5cf,		//!< File System Master header.
@@ -77,11 +99,26 @@ protected:
     FILE_BLOCK_TYPE = 0x8002,	//!< File data block.
     DIR_ENTRY_TYPE = 0x8003,	//!< Directory reference entry.
     DIR_BLOCK_TYPE = 0x8004,	//!< Directory block.
+    STALE_BLOCK_TYPE = 0x0002,	//!< Removed file data block.
+    CHECKPOINT_BLOCK_TYPE = 0x8005, //!< Checkpoint sector.
+    CHECKPOINT_TYPE = 0x8006,	//!< Checkpoint record.
     FREE_TYPE = 0xffff,		//!< Free descriptor.
     ALLOC_MASK = 0x8000,	//!< Allocated mask.
     TYPE_MASK = 0x7fff		//!< Type mask.
   };
 
+  /**
+   * CFFS checkpoint record. The type is cleared (zero) when the
+   * checkpoint is invalidated.
+   */
+  struct checkpoint_t {
+    uint16_t type;		//!< Checkpoint record type and state.
+    uint16_t next_sector;	//!< Next sector to allocate.
+    uint16_t free_count;	//!< Number of free sectors.
+    uint16_t stale_count;	//!< Number of stale sectors.
+    uint16_t crc;		//!< Check sum of sector state.
+  };
+
   /**
    * CFFS null address in flash data structures.
    */
@@ -135,8 +172,9 @@ public:
     int remove();
 
     /**
-     * Close a file. Return zero(0) if successful otherwise a negative
-     * error code (EPREM).
+     * Close a file and write a checkpoint if the file system state
+     * has changed. Return zero(0) if successful otherwise a negative
+     * error code (EPREM, EIO).
      * @return zero or negative error code.
      */
     int close();
@@ -300,6 +338,42 @@ public:
    */
   static int rmdir(const char* filename);
 
+  /**
+   * Flush buffered device data and write a checkpoint record if the
+   * file system state has changed since the latest checkpoint. Return zero(0) if successful
+   * otherwise a negative error code (ENXIO, EIO).
+   * @return zero or negative error code.
+   */
+  static int sync();
+
+  /**
+   * Erase stale sectors of removed files (garbage collection). At
+   * most the given number of sectors are erased; zero for all. May be
+   * called when idle to avoid erase latency in file write. Return
+   * number of erased sectors or a negative error code (ENXIO, EIO).
+   * @param[in] max number of sectors to erase (default 0, all).
+   * @return number of sectors or negative error code.
+   */
+  static int gc(uint16_t max = 0);
+
+  /**
+   * Return number of free (erased) sectors.
+   * @return number of sectors.
+   */
+  static uint16_t free_sectors()
+  {
+    return (free_count);
+  }
+
+  /**
+   * Return number of stale sectors to be erased by garbage collection.
+   * @return number of sectors.
+   */
+  static uint16_t stale_sectors()
+  {
+    return (stale_count);
+  }
+
   /**
    * Format the flash. Create a CFFS volume with root directory.
    * Returns zero(0) if successful otherwise a negative error code
@@ -322,6 +396,60 @@ protected:
   /** Current directory address. */
   static uint32_t current_dir_addr;
 
+  /** Next sector to check for allocation (wear leveling). */
+  static uint16_t next_sector;
+
+  /** Number of free sectors. */
+  static uint16_t free_count;
+
+  /** Number of stale sectors. */
+  static uint16_t stale_count;
+
+  /** Address of latest checkpoint record or zero if none. */
+  static uint32_t checkpoint_addr;
+
+  /** Latest checkpoint record matches the state. */
+  static bool checkpoint_valid;
+
+  /**
+   * Return address of checkpoint sector.
+   * @return address.
+   */
+  static uint32_t checkpoint_sector()
+  {
+    return ((uint32_t) (device->SECTOR_MAX - 1) * device->SECTOR_BYTES);
+  }
+
+  /**
+   * Load sector state from the latest valid checkpoint record. Return
+   * true if successful otherwise false.
+   * @return bool.
+   */
+  static bool restore();
+
+  /**
+   * Invalidate the latest checkpoint record before the sector state
+   * is changed. Return zero(0) if successful otherwise a negative
+   * error code.
+   * @return zero or negative error code.
+   */
+  static int invalidate();
+
+  /**
+   * Scan sector headers and count free and stale sectors. Return
+   * true if successful otherwise false.
+   * @return bool.
+   */
+  static bool scan();
+
+  /**
+   * Erase the given sector. Return zero(0) if successful otherwise a
+   * negative error code.
+   * @param[in] addr sector address.
+   * @return zero or negative error code.
+   */
+  static int erase(uint32_t addr);
+
   /**
    * Read flash block with the given size into the buffer from the
    * source address. Return number of bytes read or negative error
@@ -390,7 +518,9 @@ protected:
   static int remove(uint32_t addr, uint16_t type);
 
   /**
-   * Allocate next free sector. Returns sector address or zero.
+   * Allocate next free sector. Sectors are searched next-fit from the
+   * last allocated sector. A stale sector is erased if there are no
+   * free sectors. Returns sector address or zero.
    * @return sector address or zero.
    */
   static uint32_t next_free_sector();
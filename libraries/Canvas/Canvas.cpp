@@ -59,6 +59,20 @@ Canvas::set_orientation(uint8_t direction)
   return (previous);
 }
 
+bool
+Canvas::set_scroll_area(uint16_t top, uint16_t height)
+{
+  UNUSED(top);
+  UNUSED(height);
+  return (false);
+}
+
+void
+Canvas::set_scroll_start(uint16_t row)
+{
+  UNUSED(row);
+}
+
 void
 Canvas::draw_pixel(uint16_t x, uint16_t y)
 {
@@ -70,6 +84,7 @@ Canvas::draw_bitmap(uint16_t x, uint16_t y, const uint8_t* bp,
 		    uint16_t width, uint16_t height,
 		    uint8_t scale)
 {
+  damage(x, y, width * scale, ((height + 7) & ~7) * scale);
   if (scale == 1) {
     for (uint16_t i = 0; i < height; i += 8) {
       for (uint16_t j = 0; j < width; j++) {
@@ -117,21 +132,52 @@ Canvas::draw_icon(uint16_t x, uint16_t y, const uint8_t* bp, uint8_t scale)
   draw_icon(x, y, bp, width, height, scale);
 }
 
+void
+Canvas::draw_compressed_icon(uint16_t x, uint16_t y, const uint8_t* bp,
+			     uint8_t scale)
+{
+  uint16_t width = pgm_read_byte(bp++);
+  uint16_t height = pgm_read_byte(bp++);
+  RLE rle(bp);
+  damage(x, y, width * scale, ((height + 7) & ~7) * scale);
+  for (uint16_t i = 0; i < height; i += 8) {
+    for (uint16_t j = 0; j < width; j++) {
+      uint8_t bits = rle.next();
+      if (bits == 0) continue;
+      if (scale == 1 && bits == 0xff) {
+	draw_vertical_line(x + j, y + i, CHARBITS);
+	continue;
+      }
+      for (uint8_t k = 0; k < 8; k++) {
+	if (bits == 0) break;
+	if (bits & 1) {
+	  if (scale == 1)
+	    draw_pixel(x + j, y + k + i);
+	  else
+	    fill_rect(x + j*scale, y + (k+i)*scale, scale, scale);
+	}
+	bits >>= 1;
+      }
+    }
+  }
+}
+
 void
 Canvas::draw_image(uint16_t x, uint16_t y, Image* image)
 {
   color16_t saved = set_pen_color(0);
   uint16_t width = image->WIDTH;
   uint16_t height = image->HEIGHT;
+  damage(x, y, width, height);
   for (uint16_t i = 0; i < height; i++) {
     color16_t buf[Image::BUFFER_MAX];
     size_t count;
     for (uint16_t j = 0; j < width; j += count) {
       count = (width - j > Image::BUFFER_MAX) ? Image::BUFFER_MAX : width - j;
-      image->read(buf, Image::BUFFER_MAX);
+      image->read(buf, count);
       for (uint8_t k = 0; k < count; k++) {
 	set_pen_color(buf[k]);
-	draw_pixel(x + j, y + i);
+	draw_pixel(x + j + k, y + i);
       }
     }
   }
@@ -141,6 +187,7 @@ Canvas::draw_image(uint16_t x, uint16_t y, Image* image)
 void
 Canvas::draw_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
 {
+  damage(x, y, width + 1, height + 1);
   draw_horizontal_line(x, y, width);
   draw_vertical_line(x + width, y, height);
   draw_vertical_line(x, y, height);
@@ -150,6 +197,7 @@ Canvas::draw_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
 void
 Canvas::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
 {
+  damage(x, y, width, height);
   if (width > height) {
     for (uint16_t h = 0; h < height; h++)
       draw_horizontal_line(x, y + h, width);
@@ -166,6 +214,8 @@ Canvas::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
 void
 Canvas::draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
+  damage(x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1,
+	 dist(x0, x1) + 1, dist(y0, y1) + 1);
   bool steep = (dist(y0, y1) > dist(x0, x1));
   if (steep) {
     swap(x0, y0);
@@ -246,6 +296,7 @@ Canvas::draw_stroke_P(const int8_t* stroke, uint8_t scale)
 void
 Canvas::draw_circle(uint16_t x, uint16_t y, uint16_t radius)
 {
+  damage_circle(x, y, radius);
   int16_t f = 1 - radius;
   int16_t dx = 1;
   int16_t dy = -2 * radius;
@@ -279,22 +330,8 @@ Canvas::draw_circle(uint16_t x, uint16_t y, uint16_t radius)
 void
 Canvas::fill_circle(uint16_t x, uint16_t y, uint16_t radius)
 {
-  int16_t dx = 0, dy = radius;
-  int16_t p = 1 - radius;
-
-  while (dx <= dy) {
-    draw_vertical_line(x + dx, y - dy, dy + dy);
-    draw_vertical_line(x - dx, y - dy, dy + dy);
-    draw_vertical_line(x + dy, y - dx, dx + dx);
-    draw_vertical_line(x - dy, y - dx, dx + dx);
-    dx++;
-    if (p < 0)
-      p = p + (dx << 1) + 1;
-    else {
-      dy--;
-      p = p + ((dx - dy) << 1) + 1;
-    }
-  }
+  damage_circle(x, y, radius);
+  fill_spans(x, y, x, y, radius);
 }
 
 void
@@ -302,6 +339,7 @@ Canvas::draw_roundrect(uint16_t x, uint16_t y,
 		       uint16_t width, uint16_t height,
 		       uint16_t radius)
 {
+  damage(x, y, width + 1, height + 1);
   uint16_t diameter = 2 * radius;
   int16_t f = 1 - radius;
   int16_t dx = 1;
@@ -347,27 +385,32 @@ Canvas::fill_roundrect(uint16_t x, uint16_t y,
 		       uint16_t width, uint16_t height,
 		       uint16_t radius)
 {
+  damage(x, y, width + 1, height + 1);
+
+  // Fill the rows between the corners and then the rounded rows
+  uint16_t y0 = y + radius;
+  uint16_t y1 = y + height - radius;
+  if (y1 > y0 + 1) fill_rect(x, y0 + 1, width, y1 - y0 - 1);
+  fill_spans(x + radius, y0, x + width - radius, y1, radius);
+}
+
+void
+Canvas::fill_spans(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+		   uint16_t radius)
+{
+  uint16_t width = x1 - x0;
   int16_t dx = 0, dy = radius;
   int16_t p = 1 - radius;
-  uint16_t diameter = 2 * radius;
-
-  // Adjust the position and fill the inner rectangle
-  x += radius;
-  width -= diameter;
-  fill_rect(x, y, width, height + 1);
-  height -= diameter;
-  y += radius;
 
-  // Draw the outer rectangle and corners
+  // Midpoint circle; each row is drawn once as a horizontal span
   while (dx <= dy) {
-    draw_vertical_line(x + dx + width, y - dy, dy + dy + height);
-    draw_vertical_line(x - dx, y - dy, dy + dy + height);
-    draw_vertical_line(x + dy + width, y - dx, dx + dx + height);
-    draw_vertical_line(x - dy, y - dx, dx + dx + height);
+    fill_span(x0 - dy, y0 - dx, y1 + dx, width + dy + dy);
     dx++;
     if (p < 0)
       p = p + (dx << 1) + 1;
     else {
+      // Last step on the rows at distance dy; span is complete
+      if (dy >= dx) fill_span(x0 - dx + 1, y0 - dy, y1 + dy, width + dx + dx - 2);
       dy--;
       p = p + ((dx - dy) << 1) + 1;
     }
@@ -380,6 +423,9 @@ Canvas::draw_char(uint16_t x, uint16_t y, char c)
   uint8_t scale = get_text_scale();
   color16_t saved = set_pen_color(get_text_color());
   Font* font = get_text_font();
+  damage(x, y,
+	 scale * (font->WIDTH + font->SPACING),
+	 scale * font->HEIGHT);
   font->draw(this, c, x, y, scale);
   set_cursor(x + scale * (font->WIDTH + font->SPACING), y);
   set_pen_color(saved);
@@ -410,6 +456,77 @@ Canvas::fill_screen()
   set_pen_color(saved);
 }
 
+void
+Canvas::damage_circle(uint16_t x, uint16_t y, uint16_t radius)
+{
+  uint16_t x0 = (x > radius) ? x - radius : 0;
+  uint16_t y0 = (y > radius) ? y - radius : 0;
+  damage(x0, y0, x + radius + 1 - x0, y + radius + 1 - y0);
+}
+
+void
+Canvas::Damage::join(rect16_t& res, const rect16_t& r1, const rect16_t& r2)
+{
+  uint16_t x0 = (r1.x < r2.x) ? r1.x : r2.x;
+  uint16_t y0 = (r1.y < r2.y) ? r1.y : r2.y;
+  uint16_t x1 = r1.x + r1.width;
+  uint16_t y1 = r1.y + r1.height;
+  if (r2.x + r2.width > x1) x1 = r2.x + r2.width;
+  if (r2.y + r2.height > y1) y1 = r2.y + r2.height;
+  res.x = x0;
+  res.y = y0;
+  res.width = x1 - x0;
+  res.height = y1 - y0;
+}
+
+void
+Canvas::Damage::add(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  if (UNLIKELY(width == 0 || height == 0)) return;
+  rect16_t r = { x, y, width, height };
+
+  // Check if the rectangle is already damaged
+  for (uint8_t i = 0; i < m_count; i++) {
+    rect16_t& d = m_rect[i];
+    if ((x >= d.x) && (y >= d.y)
+	&& (x + width <= d.x + d.width)
+	&& (y + height <= d.y + d.height))
+      return;
+  }
+
+  // Merge with rectangles when the union is not much larger. Repeat
+  // as the union may now be merged with other rectangles
+  uint8_t i = 0;
+  while (i < m_count) {
+    rect16_t u;
+    join(u, m_rect[i], r);
+    if (area(u) <= area(m_rect[i]) + area(r) + MERGE_MIN) {
+      r = u;
+      m_rect[i] = m_rect[--m_count];
+      i = 0;
+    }
+    else i++;
+  }
+  if (m_count < RECT_MAX) {
+    m_rect[m_count++] = r;
+    return;
+  }
+
+  // Merge with the rectangle that grows the least
+  uint8_t ix = 0;
+  uint32_t min = UINT32_MAX;
+  for (i = 0; i < m_count; i++) {
+    rect16_t u;
+    join(u, m_rect[i], r);
+    uint32_t growth = area(u) - area(m_rect[i]);
+    if (growth < min) {
+      min = growth;
+      ix = i;
+    }
+  }
+  join(m_rect[ix], m_rect[ix], r);
+}
+
 void
 Canvas::run(uint8_t ix, const void_P* tab, uint8_t max)
 {
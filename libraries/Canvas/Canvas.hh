@@ -326,6 +326,90 @@ public:
     Canvas* m_canvas;
   };
 
+  /**
+   * Canvas drawing; a sequence of drawing operations that may be
+   * rendered several times, e.g., once per band (Banded) or per
+   * damaged rectangle. See Banded::Script and DisplayList::Replay.
+   */
+  class Drawing {
+  public:
+    /**
+     * @override{Canvas::Drawing}
+     * Draw on the given canvas. Only the given clipping rectangle
+     * needs to be drawn; operations outside may be skipped.
+     * @param[in] canvas to draw on.
+     * @param[in] clip rectangle.
+     */
+    virtual void on_draw(Canvas* canvas, const rect16_t& clip) = 0;
+  };
+
+  /**
+   * Run-length decoder for compressed bitmaps in program memory
+   * (fonts with compression type 2 and compressed icons). The
+   * bitmap is a sequence of operations:
+   * @code
+   * 0nnnnnnn b0..bn	n+1 literal bytes (1..128)
+   * 10nnnnnn b		n+1 repeats of byte (1..64)
+   * 11nnnnnn		n+1 zero bytes (1..64)
+   * @endcode
+   * The bytes are decoded on demand; the decoder has no buffer.
+   * Generated with build/rle.py.
+   */
+  class RLE {
+  public:
+    /**
+     * Construct decoder for given compressed bitmap.
+     * @param[in] bp compressed bitmap (program memory).
+     */
+    RLE(const uint8_t* bp = NULL)
+    {
+      begin(bp);
+    }
+
+    /**
+     * Start decoding of given compressed bitmap.
+     * @param[in] bp compressed bitmap (program memory).
+     */
+    void begin(const uint8_t* bp)
+    {
+      m_bp = bp;
+      m_count = 0;
+    }
+
+    /**
+     * Return next decompressed byte.
+     * @return byte.
+     */
+    uint8_t next()
+    {
+      if (m_count == 0) {
+	uint8_t op = pgm_read_byte(m_bp++);
+	if (op & RUN) {
+	  m_count = (op & COUNT_MASK) + 1;
+	  m_literal = false;
+	  m_value = (op & ZERO) ? 0 : pgm_read_byte(m_bp++);
+	}
+	else {
+	  m_count = op + 1;
+	  m_literal = true;
+	}
+      }
+      m_count -= 1;
+      return (m_literal ? pgm_read_byte(m_bp++) : m_value);
+    }
+
+    /** Operation code bits. */
+    static const uint8_t RUN = 0x80;
+    static const uint8_t ZERO = 0x40;
+    static const uint8_t COUNT_MASK = 0x3f;
+
+  protected:
+    const uint8_t* m_bp;	//!< Compressed bitmap (program memory).
+    uint8_t m_count;		//!< Remaining bytes of operation.
+    uint8_t m_value;		//!< Repeated byte.
+    bool m_literal;		//!< Literal or repeat operation.
+  };
+
   /**
    * Canvas image abstract class. Allow implementation of pixel
    * streams with scanning order from left to right, top to bottom.
@@ -363,6 +447,98 @@ public:
     static const size_t BUFFER_MAX = 32;
   };
 
+  /**
+   * Damage tracking; accumulates the rectangles that have been drawn
+   * to a canvas. Overlapping and nearby rectangles are merged when
+   * the union is not much larger than the rectangles; each damaged
+   * rectangle may then be refreshed with a single window and pixel
+   * stream. When the maximum number of rectangles is reached a new
+   * rectangle is merged with the rectangle that grows the least.
+   */
+  class Damage {
+  public:
+    /** Max number of damaged rectangles. */
+    static const uint8_t RECT_MAX = 4;
+
+    /**
+     * Max number of additional pixels to merge two rectangles. Should
+     * be comparable to the cost of setting a window on the device.
+     */
+    static const uint16_t MERGE_MIN = 64;
+
+    /**
+     * Construct damage tracking with no damaged rectangles.
+     */
+    Damage() : m_count(0) {}
+
+    /**
+     * Add given rectangle to the damaged area.
+     * @param[in] x.
+     * @param[in] y.
+     * @param[in] width.
+     * @param[in] height.
+     */
+    void add(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+    /**
+     * Clear damaged area.
+     */
+    void clear()
+    {
+      m_count = 0;
+    }
+
+    /**
+     * Return true(1) if there is no damaged area otherwise false(0).
+     * @return bool.
+     */
+    bool is_empty() const
+    {
+      return (m_count == 0);
+    }
+
+    /**
+     * Return number of damaged rectangles.
+     * @return count.
+     */
+    uint8_t count() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * Return damaged rectangle with given index.
+     * @param[in] ix index (0..count() - 1).
+     * @return rectangle.
+     */
+    const rect16_t& operator[](uint8_t ix) const
+    {
+      return (m_rect[ix]);
+    }
+
+  protected:
+    rect16_t m_rect[RECT_MAX];	//!< Damaged rectangles.
+    uint8_t m_count;		//!< Number of damaged rectangles.
+
+    /**
+     * Return area of given rectangle.
+     * @param[in] r rectangle.
+     * @return number of pixels.
+     */
+    static uint32_t area(const rect16_t& r)
+    {
+      return ((uint32_t) r.width * r.height);
+    }
+
+    /**
+     * Assign the bounding rectangle of the given rectangles.
+     * @param[out] res bounding rectangle.
+     * @param[in] r1 rectangle.
+     * @param[in] r2 rectangle.
+     */
+    static void join(rect16_t& res, const rect16_t& r1, const rect16_t& r2);
+  };
+
   /**
    * Screen size; width/height and orientation.
    */
@@ -383,7 +559,8 @@ public:
     WIDTH(width),
     HEIGHT(height),
     m_context(context),
-    m_direction(PORTRAIT)
+    m_direction(PORTRAIT),
+    m_damage(NULL)
   {
   }
 
@@ -415,6 +592,29 @@ public:
     return (previous);
   }
 
+  /**
+   * Get damage tracking or NULL if not tracked.
+   * @return damage tracking.
+   */
+  Damage* get_damage() const
+  {
+    return (m_damage);
+  }
+
+  /**
+   * Set damage tracking. The drawing operations will add the bounding
+   * rectangle of the drawing to the damaged area. Return previous
+   * damage tracking.
+   * @param[in] damage tracking (NULL to disable).
+   * @return previous damage tracking.
+   */
+  Damage* set_damage(Damage* damage)
+  {
+    Damage* previous = m_damage;
+    m_damage = damage;
+    return (previous);
+  }
+
   /**
    * Get current canvas color.
    * @return color.
@@ -582,6 +782,27 @@ public:
    */
   virtual uint8_t set_orientation(uint8_t direction);
 
+  /**
+   * @override{Canvas}
+   * Set vertical scroll area; the given number of rows from the given
+   * top row. The rows above and below the area are fixed. Return
+   * true(1) if hardware scroll is supported in the current orientation
+   * otherwise false(0). Default is not supported.
+   * @param[in] top first row of scroll area.
+   * @param[in] height number of rows in scroll area.
+   * @return bool.
+   */
+  virtual bool set_scroll_area(uint16_t top, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Set vertical scroll start; the row in the scroll area that is
+   * shown first. Drawing is not affected and is performed in display
+   * memory rows. Default is null function.
+   * @param[in] row first row to show.
+   */
+  virtual void set_scroll_start(uint16_t row);
+
   /**
    * @override{Canvas}
    * Set pixel with current pen color.
@@ -674,6 +895,33 @@ public:
     draw_icon(x, y, bp, width, height, scale);
   }
 
+  /**
+   * Draw run-length compressed icon at given position with current
+   * pen color. The icon must be stored in program memory with width
+   * and height (bytes) followed by the compressed bitmap (see
+   * Canvas::RLE). The bitmap is decompressed while drawing.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] bp.
+   * @param[in] scale.
+   */
+  virtual void draw_compressed_icon(uint16_t x, uint16_t y,
+				    const uint8_t* bp,
+				    uint8_t scale = 1);
+
+  /**
+   * Draw run-length compressed icon at cursor position with current
+   * pen color.
+   * @param[in] bp.
+   * @param[in] scale.
+   */
+  void draw_compressed_icon(const uint8_t* bp, uint8_t scale = 1)
+  {
+    uint16_t x, y;
+    get_cursor(x, y);
+    draw_compressed_icon(x, y, bp, scale);
+  }
+
   /**
    * @override{Canvas}
    * Draw image on canvas at given position.
@@ -1013,6 +1261,62 @@ protected:
 
   /** Canvas direction (LANDSCAPE/PORTRAIT). */
   uint8_t m_direction;
+
+  /** Damage tracking or NULL. */
+  Damage* m_damage;
+
+  /**
+   * Add given rectangle, clipped to the canvas, to the damaged area
+   * if damage tracking is enabled.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   */
+  void damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+  {
+    if (m_damage == NULL) return;
+    if (x >= WIDTH || y >= HEIGHT) return;
+    if (width > WIDTH - x) width = WIDTH - x;
+    if (height > HEIGHT - y) height = HEIGHT - y;
+    m_damage->add(x, y, width, height);
+  }
+
+  /**
+   * Add bounding rectangle of given circle to the damaged area.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] radius.
+   */
+  void damage_circle(uint16_t x, uint16_t y, uint16_t radius);
+
+  /**
+   * Fill rounded area with horizontal spans; top half circle with
+   * given center (x0, y0) and bottom half circle with center (x1,
+   * y1) stretched to the width x1 - x0. Used by fill_circle() and
+   * fill_roundrect(); each row is drawn once.
+   * @param[in] x0 top left center.
+   * @param[in] y0 top left center.
+   * @param[in] x1 bottom right center.
+   * @param[in] y1 bottom right center.
+   * @param[in] radius.
+   */
+  void fill_spans(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+		  uint16_t radius);
+
+  /**
+   * Draw horizontal line at the given top and bottom rows. The line
+   * is only drawn once if the rows are the same.
+   * @param[in] x.
+   * @param[in] top row.
+   * @param[in] bottom row.
+   * @param[in] length.
+   */
+  void fill_span(uint16_t x, uint16_t top, uint16_t bottom, uint16_t length)
+  {
+    draw_horizontal_line(x, top, length);
+    if (bottom != top) draw_horizontal_line(x, bottom, length);
+  }
 };
 
 /**
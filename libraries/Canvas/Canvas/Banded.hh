@@ -0,0 +1,262 @@
+/**
+ * @file Canvas/Banded.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_CANVAS_BANDED_HH
+#define COSA_CANVAS_BANDED_HH
+
+#include "Cosa/Types.h"
+
+/**
+ * Banded off-screen canvas for displays where a full frame buffer
+ * will not fit in memory. A drawing (display list) is replayed once
+ * per horizontal band into a small 16-bit color strip which is then
+ * copied to the canvas device with draw_image(); one window and pixel
+ * stream per band. Drawing operations outside the current band are
+ * clipped. The drawing context (colors, font, cursor) is restored
+ * before each replay so that the drawing is rendered identically in
+ * all bands.
+ * @code
+ * typedef Banded<ILI9341::SCREEN_WIDTH, ILI9341::SCREEN_HEIGHT, 2> Screen;
+ * Screen banded;
+ * Screen::Script drawing(0, script, membersof(script));
+ * ...
+ * banded.render(&tft, &drawing);
+ * @endcode
+ * @param[in] width of canvas.
+ * @param[in] height of canvas.
+ * @param[in] rows number of pixel rows per band.
+ * @section Limitations
+ * Requires width * rows * 2 bytes of memory for the strip.
+ */
+template<uint16_t width, uint16_t height, uint8_t rows>
+class Banded : public Canvas {
+public:
+  /**
+   * Construct banded off-screen canvas with given width, height and
+   * band rows.
+   */
+  Banded() :
+    Canvas(width, height),
+    m_y0(0),
+    m_rows(rows)
+  {}
+
+  /**
+   * Canvas script (in program memory) as drawing.
+   */
+  class Script : public Canvas::Drawing {
+  public:
+    /**
+     * Construct drawing with given canvas script.
+     * @param[in] ix script to run.
+     * @param[in] tab script table in program memory.
+     * @param[in] max size of script table.
+     */
+    Script(uint8_t ix, const void_P* tab, uint8_t max) :
+      m_ix(ix),
+      m_tab(tab),
+      m_max(max)
+    {}
+
+    /**
+     * @override{Canvas::Drawing}
+     * Run the canvas script on the given canvas.
+     * @param[in] canvas to draw on.
+     * @param[in] clip rectangle (not used).
+     */
+    virtual void on_draw(Canvas* canvas, const rect16_t& clip)
+    {
+      UNUSED(clip);
+      canvas->run(m_ix, m_tab, m_max);
+    }
+
+  protected:
+    uint8_t m_ix;		//!< Script index.
+    const void_P* m_tab;	//!< Script table.
+    uint8_t m_max;		//!< Script table size.
+  };
+
+  /**
+   * Image of the current band; strip of pixels.
+   */
+  class Strip : public Image {
+  public:
+    /**
+     * Construct image of the given pixels.
+     * @param[in] buf pixel buffer.
+     * @param[in] lines number of rows.
+     */
+    Strip(const color16_t* buf, uint8_t lines) :
+      Image(width, lines),
+      m_buf(buf)
+    {}
+
+    /**
+     * @override{Canvas::Image}
+     * Read the given number of pixels into the given buffer.
+     * @param[in] buf pixel buffer pointer.
+     * @param[in] count number of pixels to read.
+     * @return bool.
+     */
+    virtual bool read(color16_t* buf, size_t count)
+    {
+      memcpy(buf, m_buf, count * sizeof(color16_t));
+      m_buf += count;
+      return (true);
+    }
+
+  protected:
+    const color16_t* m_buf;	//!< Next pixel.
+  };
+
+  /**
+   * Render the given drawing on the given canvas device at the given
+   * position. The drawing is replayed for each band and the band is
+   * copied to the device with draw_image(). The drawing context is
+   * restored before each band and is left as after the last band.
+   * @param[in] canvas device.
+   * @param[in] drawing to render.
+   * @param[in] x position on canvas device (default 0).
+   * @param[in] y position on canvas device (default 0).
+   */
+  void render(Canvas* canvas, Drawing* drawing, uint16_t x = 0, uint16_t y = 0)
+  {
+    Context saved = *get_context();
+    for (m_y0 = 0; m_y0 < HEIGHT; m_y0 += rows) {
+      m_rows = (HEIGHT - m_y0 < rows) ? HEIGHT - m_y0 : rows;
+      rect16_t band = { 0, m_y0, WIDTH, m_rows };
+      *get_context() = saved;
+      fill_screen();
+      drawing->on_draw(this, band);
+      Strip strip(m_band, m_rows);
+      canvas->draw_image(x, y + m_y0, &strip);
+    }
+    m_y0 = 0;
+    m_rows = rows;
+  }
+
+  /**
+   * @override{Canvas}
+   * Start interaction with banded canvas.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool begin()
+  {
+    return (true);
+  }
+
+  using Canvas::draw_pixel;
+  using Canvas::draw_vertical_line;
+  using Canvas::draw_horizontal_line;
+  using Canvas::fill_rect;
+
+  /**
+   * @override{Canvas}
+   * Set pixel in the current band according to the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   */
+  virtual void draw_pixel(uint16_t x, uint16_t y)
+  {
+    if (UNLIKELY((x >= WIDTH) || (y < m_y0) || (y >= m_y0 + m_rows))) return;
+    m_band[((y - m_y0) * width) + x] = get_pen_color();
+  }
+
+  /**
+   * @override{Canvas}
+   * Draw vertical line with the current pen color; clipped to the
+   * current band.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_vertical_line(uint16_t x, uint16_t y, uint16_t length)
+  {
+    fill_rect(x, y, 1, length + 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Draw horizontal line with the current pen color; clipped to the
+   * current band.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_horizontal_line(uint16_t x, uint16_t y, uint16_t length)
+  {
+    fill_rect(x, y, length + 1, 1);
+  }
+
+  /**
+   * @override{Canvas}
+   * Fill rectangle with the current pen color; clipped to the
+   * current band.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] w width.
+   * @param[in] h height.
+   */
+  virtual void fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+  {
+    uint16_t y1 = m_y0 + m_rows;
+    if (UNLIKELY((x >= WIDTH) || (y >= y1) || (y + h <= m_y0))) return;
+    if (y < m_y0) {
+      h -= m_y0 - y;
+      y = m_y0;
+    }
+    if (h > y1 - y) h = y1 - y;
+    if (w > WIDTH - x) w = WIDTH - x;
+    color16_t color = get_pen_color();
+    color16_t* bp = &m_band[((y - m_y0) * WIDTH) + x];
+    while (h--) {
+      for (uint16_t i = 0; i < w; i++) bp[i] = color;
+      bp += WIDTH;
+    }
+  }
+
+  /**
+   * @override{Canvas}
+   * Fill the current band with the canvas color.
+   */
+  virtual void fill_screen()
+  {
+    color16_t saved = set_pen_color(get_canvas_color());
+    fill_rect(0, m_y0, WIDTH, m_rows);
+    set_pen_color(saved);
+  }
+
+  /**
+   * @override{Canvas}
+   * Stop sequence of interaction with banded canvas.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool end()
+  {
+    return (true);
+  }
+
+private:
+  color16_t m_band[width * rows];
+  uint16_t m_y0;
+  uint8_t m_rows;
+};
+
+#endif
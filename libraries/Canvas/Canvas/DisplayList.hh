@@ -0,0 +1,445 @@
+/**
+ * @file Canvas/DisplayList.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_CANVAS_DISPLAYLIST_HH
+#define COSA_CANVAS_DISPLAYLIST_HH
+
+#include "Cosa/Types.h"
+
+#include <Canvas.h>
+
+/**
+ * Canvas display list recorder. Drawing operations on the display
+ * list canvas are recorded in a compact binary format in the given
+ * buffer instead of being drawn. The display list may be replayed
+ * on any canvas with play() or rendered as a Canvas::Drawing with
+ * Replay (e.g. per band with Banded or per damaged rectangle).
+ * Context changes (colors, text scale and font) are only recorded
+ * when they are used and have changed.
+ *
+ * @section Format
+ * A display list is a sequence of instructions; an operation code
+ * byte followed by arguments, and is terminated by END. Coordinates,
+ * sizes, colors and pointers are 16-bit little-endian.
+ * @code
+ * SET_PEN_COLOR color
+ * SET_CANVAS_COLOR color
+ * SET_TEXT_COLOR color
+ * SET_TEXT_SCALE scale(8)
+ * SET_TEXT_FONT font
+ * DRAW_PIXEL x y
+ * DRAW_BITMAP x y bitmap width height scale(8)
+ * DRAW_COMPRESSED_ICON x y icon scale(8)
+ * DRAW_LINE x0 y0 x1 y1
+ * DRAW_VERTICAL_LINE x y length
+ * DRAW_HORIZONTAL_LINE x y length
+ * DRAW_RECT x y width height
+ * FILL_RECT x y width height
+ * DRAW_ROUNDRECT x y width height radius
+ * FILL_ROUNDRECT x y width height radius
+ * DRAW_CIRCLE x y radius
+ * FILL_CIRCLE x y radius
+ * DRAW_CHAR x y char(8)
+ * FILL_SCREEN
+ * @endcode
+ * A recorded display list may be copied to program memory and
+ * replayed from there (progmem = true). Fonts and bitmaps are
+ * recorded as program memory addresses and are only valid for the
+ * same program build.
+ *
+ * @section Limitations
+ * Images (draw_image) are recorded pixel by pixel.
+ */
+class DisplayList : public Canvas {
+public:
+  /**
+   * Display list instructions.
+   */
+  enum {
+    END = 0,
+    SET_PEN_COLOR,
+    SET_CANVAS_COLOR,
+    SET_TEXT_COLOR,
+    SET_TEXT_SCALE,
+    SET_TEXT_FONT,
+    DRAW_PIXEL,
+    DRAW_BITMAP,
+    DRAW_COMPRESSED_ICON,
+    DRAW_LINE,
+    DRAW_VERTICAL_LINE,
+    DRAW_HORIZONTAL_LINE,
+    DRAW_RECT,
+    FILL_RECT,
+    DRAW_ROUNDRECT,
+    FILL_ROUNDRECT,
+    DRAW_CIRCLE,
+    FILL_CIRCLE,
+    DRAW_CHAR,
+    FILL_SCREEN
+  } __attribute__((packed));
+
+  /**
+   * Construct display list recorder with given buffer and canvas
+   * size.
+   * @param[in] buf display list buffer.
+   * @param[in] size of buffer.
+   * @param[in] width of canvas.
+   * @param[in] height of canvas.
+   */
+  DisplayList(uint8_t* buf, size_t size, uint16_t width, uint16_t height) :
+    Canvas(width, height),
+    m_buf(buf),
+    m_size(size)
+  {
+    begin();
+  }
+
+  /**
+   * Display list as canvas drawing. Instructions with a bounding box
+   * outside the clipping rectangle are skipped.
+   */
+  class Replay : public Canvas::Drawing {
+  public:
+    /**
+     * Construct drawing of given display list.
+     * @param[in] list display list.
+     * @param[in] progmem list in program memory (default false).
+     */
+    Replay(const uint8_t* list, bool progmem = false) :
+      m_list(list),
+      m_progmem(progmem)
+    {}
+
+    /**
+     * @override{Canvas::Drawing}
+     * Replay the display list on the given canvas.
+     * @param[in] canvas to draw on.
+     * @param[in] clip rectangle.
+     */
+    virtual void on_draw(Canvas* canvas, const rect16_t& clip)
+    {
+      play(canvas, m_list, m_progmem, &clip);
+    }
+
+  protected:
+    const uint8_t* m_list;	//!< Display list.
+    bool m_progmem;		//!< Display list in program memory.
+  };
+
+  /**
+   * Replay the given display list on the given canvas. Instructions
+   * with a bounding box outside the given clipping rectangle are
+   * skipped; context instructions are always performed.
+   * @param[in] canvas to draw on.
+   * @param[in] list display list.
+   * @param[in] progmem list in program memory (default false).
+   * @param[in] clip rectangle or NULL for no clipping (default NULL).
+   */
+  static void play(Canvas* canvas, const uint8_t* list,
+		   bool progmem = false,
+		   const rect16_t* clip = NULL);
+
+  /**
+   * Get the recorded display list.
+   * @return display list.
+   */
+  const uint8_t* get_list() const
+  {
+    return (m_buf);
+  }
+
+  /**
+   * Get length of the recorded display list including the END
+   * instruction.
+   * @return number of bytes.
+   */
+  size_t length() const
+  {
+    return (m_length + 1);
+  }
+
+  /**
+   * Return true(1) if instructions were dropped as the buffer was
+   * full otherwise false(0).
+   * @return bool.
+   */
+  bool is_overflow() const
+  {
+    return (m_overflow);
+  }
+
+  /**
+   * @override{Canvas}
+   * Start a new recording; clear the display list.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool begin();
+
+  using Canvas::draw_pixel;
+  using Canvas::draw_bitmap;
+  using Canvas::draw_compressed_icon;
+  using Canvas::draw_line;
+  using Canvas::draw_vertical_line;
+  using Canvas::draw_horizontal_line;
+  using Canvas::draw_rect;
+  using Canvas::fill_rect;
+  using Canvas::draw_roundrect;
+  using Canvas::fill_roundrect;
+  using Canvas::draw_circle;
+  using Canvas::fill_circle;
+  using Canvas::draw_char;
+
+  /**
+   * @override{Canvas}
+   * Record pixel with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   */
+  virtual void draw_pixel(uint16_t x, uint16_t y);
+
+  /**
+   * @override{Canvas}
+   * Record bitmap with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] bp bitmap in program memory.
+   * @param[in] width.
+   * @param[in] height.
+   * @param[in] scale.
+   */
+  virtual void draw_bitmap(uint16_t x, uint16_t y, const uint8_t* bp,
+			   uint16_t width, uint16_t height,
+			   uint8_t scale = 1);
+
+  /**
+   * @override{Canvas}
+   * Record compressed icon with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] bp compressed icon in program memory.
+   * @param[in] scale.
+   */
+  virtual void draw_compressed_icon(uint16_t x, uint16_t y,
+				    const uint8_t* bp,
+				    uint8_t scale = 1);
+
+  /**
+   * @override{Canvas}
+   * Record line with the current pen color.
+   * @param[in] x0.
+   * @param[in] y0.
+   * @param[in] x1.
+   * @param[in] y1.
+   */
+  virtual void draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+  /**
+   * @override{Canvas}
+   * Record vertical line with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_vertical_line(uint16_t x, uint16_t y, uint16_t length);
+
+  /**
+   * @override{Canvas}
+   * Record horizontal line with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] length.
+   */
+  virtual void draw_horizontal_line(uint16_t x, uint16_t y, uint16_t length);
+
+  /**
+   * @override{Canvas}
+   * Record rectangle with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   */
+  virtual void draw_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Record filled rectangle with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   */
+  virtual void fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Record rectangle with rounded corners with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   * @param[in] radius.
+   */
+  virtual void draw_roundrect(uint16_t x, uint16_t y,
+			      uint16_t width, uint16_t height,
+			      uint16_t radius);
+
+  /**
+   * @override{Canvas}
+   * Record filled rectangle with rounded corners with the current
+   * pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] width.
+   * @param[in] height.
+   * @param[in] radius.
+   */
+  virtual void fill_roundrect(uint16_t x, uint16_t y,
+			      uint16_t width, uint16_t height,
+			      uint16_t radius);
+
+  /**
+   * @override{Canvas}
+   * Record circle with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] radius.
+   */
+  virtual void draw_circle(uint16_t x, uint16_t y, uint16_t radius);
+
+  /**
+   * @override{Canvas}
+   * Record filled circle with the current pen color.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] radius.
+   */
+  virtual void fill_circle(uint16_t x, uint16_t y, uint16_t radius);
+
+  /**
+   * @override{Canvas}
+   * Record character with the current text color, font and scale.
+   * The cursor is moved as when drawing.
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] c character.
+   */
+  virtual void draw_char(uint16_t x, uint16_t y, char c);
+
+  /**
+   * @override{Canvas}
+   * Record fill of screen with the current canvas color.
+   */
+  virtual void fill_screen();
+
+  /**
+   * @override{Canvas}
+   * Stop recording.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool end();
+
+protected:
+  /** Recorded context state flags. */
+  enum {
+    PEN_COLOR = 0x01,
+    CANVAS_COLOR = 0x02,
+    TEXT_COLOR = 0x04,
+    TEXT_SCALE = 0x08,
+    TEXT_FONT = 0x10
+  } __attribute__((packed));
+
+  uint8_t* m_buf;		//!< Display list buffer.
+  size_t m_size;		//!< Size of buffer.
+  size_t m_length;		//!< Number of recorded bytes (without END).
+  bool m_overflow;		//!< Instructions dropped.
+  uint8_t m_recorded;		//!< Recorded context state.
+  color16_t m_pen_color;	//!< Recorded pen color.
+  color16_t m_canvas_color;	//!< Recorded canvas color.
+  color16_t m_text_color;	//!< Recorded text color.
+  uint8_t m_text_scale;		//!< Recorded text scale.
+  Font* m_font;			//!< Recorded text font.
+
+  /**
+   * Record pen color if changed since last recorded.
+   */
+  void record_pen_color();
+
+  /**
+   * Record text color, scale and font if changed since last
+   * recorded.
+   */
+  void record_text();
+
+  /**
+   * Start recording instruction with given operation code and
+   * number of argument bytes. Return true(1) if there is room in the
+   * buffer otherwise false(0) and the overflow flag is set.
+   * @param[in] op operation code.
+   * @param[in] size number of argument bytes.
+   * @return bool.
+   */
+  bool record(uint8_t op, uint8_t size);
+
+  /**
+   * Write given byte to the display list.
+   * @param[in] value to write.
+   */
+  void put8(uint8_t value)
+  {
+    m_buf[m_length++] = value;
+  }
+
+  /**
+   * Write given 16-bit value, little-endian, to the display list.
+   * @param[in] value to write.
+   */
+  void put16(uint16_t value)
+  {
+    m_buf[m_length++] = value;
+    m_buf[m_length++] = value >> 8;
+  }
+
+  /**
+   * Terminate the display list with END (not included in length).
+   */
+  void terminate()
+  {
+    m_buf[m_length] = END;
+  }
+
+  /**
+   * Record instruction with given operation code and 16-bit
+   * arguments.
+   * @param[in] op operation code.
+   * @param[in] count number of arguments.
+   * @param[in] a0 first argument.
+   * @param[in] a1 second argument.
+   * @param[in] a2 third argument (default 0).
+   * @param[in] a3 fourth argument (default 0).
+   * @param[in] a4 fifth argument (default 0).
+   */
+  void record(uint8_t op, uint8_t count,
+	      uint16_t a0, uint16_t a1,
+	      uint16_t a2 = 0, uint16_t a3 = 0,
+	      uint16_t a4 = 0);
+};
+
+#endif
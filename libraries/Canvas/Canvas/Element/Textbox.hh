@@ -34,7 +34,8 @@ extern System5x7 system5x7;
  * canvas. As an element it holds its own canvas state; context. The
  * textbox is defined by a port (x, y, width, height) on the canvas.
  * Basic special character handling of carriage-return, line- and
- * form-feed.
+ * form-feed. Scrolling is a wrap-around unless hardware scroll is
+ * enabled with set_scroll().
  */
 class Textbox : public Canvas::Element, public IOStream::Device {
 public:
@@ -44,7 +45,9 @@ public:
    */
   Textbox(Canvas* canvas, Font* font = (Font*) &system5x7) :
     Canvas::Element(canvas, font),
-    IOStream::Device()
+    IOStream::Device(),
+    m_scroll_height(0),
+    m_scroll_start(0)
   {
     set_text_port(0, 0, canvas->WIDTH, canvas->HEIGHT);
   }
@@ -98,11 +101,26 @@ public:
     m_canvas->get_context()->get_text_font()->LINE_SPACING = spacing;
   }
 
+  /**
+   * Enable/disable hardware vertical scroll. When enabled the canvas
+   * scrolls a line when the text reaches the bottom of the text port
+   * instead of clearing and redrawing. The scroll area is the whole
+   * lines of the text port with the current font and scale. The text
+   * port should span the canvas width as the scroll moves whole rows.
+   * Should be called after setting text port, font and scale. Return
+   * true(1) if successful otherwise false(0); not supported by the
+   * canvas (or orientation) and wrap-around is used.
+   * @param[in] flag enable(true) or disable(false).
+   * @return bool.
+   */
+  bool set_scroll(bool flag);
+
   /**
    * @override IOStream::Device
    * Write character at current cursor position, with current text
    * color, scale and font. The textbox will handle carriage-return,
-   * line-feed and form-feed. Scrolling is handled as a wrap-around.
+   * line-feed and form-feed. Scrolling is handled with hardware
+   * scroll when enabled otherwise as a wrap-around.
    * @param[in] c character to write.
    * @return character written or EOF(-1).
    */
@@ -111,6 +129,12 @@ public:
 protected:
   /** Textbox port rectangle. */
   Canvas::rect16_t m_text_port;
+
+  /** Hardware scroll area height or zero(0) when disabled. */
+  uint16_t m_scroll_height;
+
+  /** Hardware scroll start; offset from top of text port. */
+  uint16_t m_scroll_start;
 };
 
 #endif
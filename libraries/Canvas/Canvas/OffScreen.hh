@@ -26,7 +26,11 @@
 /**
  * Off-screen canvas for drawing before copying to the canvas device.
  * Supports monochrome, 1-bit, pixel in off-screen buffer. Minimum
- * implementation; draw_pixel() only.
+ * implementation; draw_pixel() only. The drawing operations are
+ * damage tracked and flush() will copy only the damaged rectangles
+ * to a canvas device with draw_image(); one window and pixel stream
+ * per rectangle. Large off-screen canvases may be placed in external
+ * memory on Mega boards with XMEM (static instance with __XMEM).
  * @param[in] width of canvas.
  * @param[in] height of canvas.
  */
@@ -36,7 +40,68 @@ public:
   /**
    * Construct off-screen canvas with given width and height.
    */
-  OffScreen() : Canvas(width, height) {}
+  OffScreen() : Canvas(width, height)
+  {
+    set_damage(&m_dirty);
+  }
+
+  /**
+   * Image of a rectangle of the off-screen canvas. Set pixels are
+   * read as the foreground color and cleared pixels as the background
+   * color.
+   */
+  class Window : public Image {
+  public:
+    /**
+     * Construct image of given rectangle of off-screen canvas.
+     * @param[in] offscreen canvas.
+     * @param[in] rect rectangle.
+     * @param[in] fg foreground color.
+     * @param[in] bg background color.
+     */
+    Window(OffScreen* offscreen, const rect16_t& rect,
+	   color16_t fg, color16_t bg) :
+      Image(rect.width, rect.height),
+      m_bitmap(offscreen->m_bitmap),
+      m_x0(rect.x),
+      m_x(rect.x),
+      m_y(rect.y),
+      m_fg(fg),
+      m_bg(bg)
+    {}
+
+    /**
+     * @override{Canvas::Image}
+     * Read the given number of pixels into the given buffer. Pixels
+     * are read row by row.
+     * @param[in] buf pixel buffer pointer.
+     * @param[in] count number of pixels to read.
+     * @return bool.
+     */
+    virtual bool read(color16_t* buf, size_t count)
+    {
+      const uint8_t* bp = &m_bitmap[((m_y >> 3) * width) + m_x];
+      uint8_t mask = (1 << (m_y & 0x07));
+      while (count--) {
+	*buf++ = (*bp++ & mask) ? m_fg : m_bg;
+	if (++m_x == m_x0 + WIDTH) {
+	  m_x = m_x0;
+	  m_y += 1;
+	  bp = &m_bitmap[((m_y >> 3) * width) + m_x];
+	  mask = (1 << (m_y & 0x07));
+	}
+      }
+      return (true);
+    }
+
+  protected:
+    const uint8_t* m_bitmap;	//!< Off-screen bitmap.
+    uint16_t m_x0;		//!< Rectangle left.
+    uint16_t m_x;		//!< Current column.
+    uint16_t m_y;		//!< Current row.
+    color16_t m_fg;		//!< Foreground color.
+    color16_t m_bg;		//!< Background color.
+  };
 
   /**
    * Get bitmap for the off-screen canvas.
@@ -66,7 +131,8 @@ public:
    */
   virtual void draw_pixel(uint16_t x, uint16_t y)
   {
-    if (UNLIKELY((x > WIDTH) || (y > HEIGHT))) return;
+    if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT))) return;
+    damage(x, y, 1, 1);
     uint8_t* bp = &m_bitmap[((y >> 3) * WIDTH) + x];
     uint8_t pos = (y & 0x07);
     if (get_pen_color().rgb == Canvas::BLACK)
@@ -81,7 +147,54 @@ public:
    */
   virtual void fill_screen()
   {
-    memset(m_bitmap, (get_canvas_color().rgb == Canvas::BLACK), COUNT);
+    damage(0, 0, WIDTH, HEIGHT);
+    memset(m_bitmap, (get_canvas_color().rgb == Canvas::BLACK) ? 0xff : 0, COUNT);
+  }
+
+  /**
+   * Copy the damaged rectangles to the given canvas at the given
+   * position with draw_image() and clear the damage. Set pixels are
+   * drawn with the canvas pen color and cleared pixels with the
+   * canvas color.
+   * @param[in] canvas device.
+   * @param[in] x position on canvas device (default 0).
+   * @param[in] y position on canvas device (default 0).
+   */
+  void flush(Canvas* canvas, uint16_t x = 0, uint16_t y = 0)
+  {
+    Damage* dirty = get_damage();
+    if (dirty == NULL) return;
+    color16_t fg = canvas->get_pen_color();
+    color16_t bg = canvas->get_canvas_color();
+    for (uint8_t i = 0; i < dirty->count(); i++) {
+      const rect16_t& r = (*dirty)[i];
+      Window window(this, r, fg, bg);
+      canvas->draw_image(x + r.x, y + r.y, &window);
+    }
+    dirty->clear();
+  }
+
+  /**
+   * Return bitmask of the damaged pages and clear the damage. A page
+   * is a bitmap row of bytes (eight pixel rows) and has the same
+   * layout as the display memory of page addressed controllers
+   * (e.g. PCD8544 and ST7565) that use the bitmap as frame buffer.
+   * @return page bitmask.
+   */
+  uint16_t damaged_pages()
+  {
+    Damage* dirty = get_damage();
+    if (dirty == NULL) return (0);
+    uint16_t pages = 0;
+    for (uint8_t i = 0; i < dirty->count(); i++) {
+      const rect16_t& r = (*dirty)[i];
+      if (UNLIKELY(r.height == 0)) continue;
+      uint8_t last = (r.y + r.height - 1) >> 3;
+      for (uint8_t page = (r.y >> 3); page <= last; page++)
+	pages |= (1U << page);
+    }
+    dirty->clear();
+    return (pages);
   }
 
   /**
@@ -97,6 +210,7 @@ public:
 private:
   static const uint16_t COUNT = (width * height) / CHARBITS;
   uint8_t m_bitmap[COUNT];
+  Damage m_dirty;
 };
 
 #endif
@@ -0,0 +1,413 @@
+/**
+ * @file DisplayList.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Canvas/DisplayList.hh"
+#include "Font.hh"
+
+bool
+DisplayList::begin()
+{
+  m_length = 0;
+  m_overflow = false;
+  m_recorded = 0;
+  if (m_size != 0) terminate();
+  return (true);
+}
+
+bool
+DisplayList::end()
+{
+  return (!m_overflow);
+}
+
+bool
+DisplayList::record(uint8_t op, uint8_t size)
+{
+  // Reserve room for the instruction and the END instruction
+  if (UNLIKELY(m_overflow || (m_length + size + 2 > m_size))) {
+    m_overflow = true;
+    return (false);
+  }
+  put8(op);
+  return (true);
+}
+
+void
+DisplayList::record(uint8_t op, uint8_t count,
+		    uint16_t a0, uint16_t a1,
+		    uint16_t a2, uint16_t a3,
+		    uint16_t a4)
+{
+  if (!record(op, count * 2)) return;
+  put16(a0);
+  put16(a1);
+  if (count > 2) put16(a2);
+  if (count > 3) put16(a3);
+  if (count > 4) put16(a4);
+  terminate();
+}
+
+void
+DisplayList::record_pen_color()
+{
+  color16_t color = get_pen_color();
+  if ((m_recorded & PEN_COLOR) && (m_pen_color.rgb == color.rgb)) return;
+  if (!record(SET_PEN_COLOR, 2)) return;
+  put16(color.rgb);
+  terminate();
+  m_pen_color = color;
+  m_recorded |= PEN_COLOR;
+}
+
+void
+DisplayList::record_text()
+{
+  color16_t color = get_text_color();
+  if (!(m_recorded & TEXT_COLOR) || (m_text_color.rgb != color.rgb)) {
+    if (!record(SET_TEXT_COLOR, 2)) return;
+    put16(color.rgb);
+    terminate();
+    m_text_color = color;
+    m_recorded |= TEXT_COLOR;
+  }
+  uint8_t scale = get_text_scale();
+  if (!(m_recorded & TEXT_SCALE) || (m_text_scale != scale)) {
+    if (!record(SET_TEXT_SCALE, 1)) return;
+    put8(scale);
+    terminate();
+    m_text_scale = scale;
+    m_recorded |= TEXT_SCALE;
+  }
+  Font* font = get_text_font();
+  if (!(m_recorded & TEXT_FONT) || (m_font != font)) {
+    if (!record(SET_TEXT_FONT, 2)) return;
+    put16((uint16_t) font);
+    terminate();
+    m_font = font;
+    m_recorded |= TEXT_FONT;
+  }
+}
+
+void
+DisplayList::draw_pixel(uint16_t x, uint16_t y)
+{
+  record_pen_color();
+  record(DRAW_PIXEL, 2, x, y);
+}
+
+void
+DisplayList::draw_bitmap(uint16_t x, uint16_t y, const uint8_t* bp,
+			 uint16_t width, uint16_t height,
+			 uint8_t scale)
+{
+  record_pen_color();
+  if (!record(DRAW_BITMAP, 11)) return;
+  put16(x);
+  put16(y);
+  put16((uint16_t) bp);
+  put16(width);
+  put16(height);
+  put8(scale);
+  terminate();
+}
+
+void
+DisplayList::draw_compressed_icon(uint16_t x, uint16_t y,
+				  const uint8_t* bp,
+				  uint8_t scale)
+{
+  record_pen_color();
+  if (!record(DRAW_COMPRESSED_ICON, 7)) return;
+  put16(x);
+  put16(y);
+  put16((uint16_t) bp);
+  put8(scale);
+  terminate();
+}
+
+void
+DisplayList::draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+  record_pen_color();
+  record(DRAW_LINE, 4, x0, y0, x1, y1);
+}
+
+void
+DisplayList::draw_vertical_line(uint16_t x, uint16_t y, uint16_t length)
+{
+  record_pen_color();
+  record(DRAW_VERTICAL_LINE, 3, x, y, length);
+}
+
+void
+DisplayList::draw_horizontal_line(uint16_t x, uint16_t y, uint16_t length)
+{
+  record_pen_color();
+  record(DRAW_HORIZONTAL_LINE, 3, x, y, length);
+}
+
+void
+DisplayList::draw_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  record_pen_color();
+  record(DRAW_RECT, 4, x, y, width, height);
+}
+
+void
+DisplayList::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  record_pen_color();
+  record(FILL_RECT, 4, x, y, width, height);
+}
+
+void
+DisplayList::draw_roundrect(uint16_t x, uint16_t y,
+			    uint16_t width, uint16_t height,
+			    uint16_t radius)
+{
+  record_pen_color();
+  record(DRAW_ROUNDRECT, 5, x, y, width, height, radius);
+}
+
+void
+DisplayList::fill_roundrect(uint16_t x, uint16_t y,
+			    uint16_t width, uint16_t height,
+			    uint16_t radius)
+{
+  record_pen_color();
+  record(FILL_ROUNDRECT, 5, x, y, width, height, radius);
+}
+
+void
+DisplayList::draw_circle(uint16_t x, uint16_t y, uint16_t radius)
+{
+  record_pen_color();
+  record(DRAW_CIRCLE, 3, x, y, radius);
+}
+
+void
+DisplayList::fill_circle(uint16_t x, uint16_t y, uint16_t radius)
+{
+  record_pen_color();
+  record(FILL_CIRCLE, 3, x, y, radius);
+}
+
+void
+DisplayList::draw_char(uint16_t x, uint16_t y, char c)
+{
+  record_text();
+  if (record(DRAW_CHAR, 5)) {
+    put16(x);
+    put16(y);
+    put8(c);
+    terminate();
+  }
+  uint8_t scale = get_text_scale();
+  Font* font = get_text_font();
+  set_cursor(x + scale * (font->WIDTH + font->SPACING), y);
+}
+
+void
+DisplayList::fill_screen()
+{
+  color16_t color = get_canvas_color();
+  if (!(m_recorded & CANVAS_COLOR) || (m_canvas_color.rgb != color.rgb)) {
+    if (!record(SET_CANVAS_COLOR, 2)) return;
+    put16(color.rgb);
+    terminate();
+    m_canvas_color = color;
+    m_recorded |= CANVAS_COLOR;
+  }
+  if (!record(FILL_SCREEN, 0)) return;
+  terminate();
+}
+
+// Read byte from display list in data or program memory
+static uint8_t
+get8(const uint8_t* &ip, bool progmem)
+{
+  return (progmem ? pgm_read_byte(ip++) : *ip++);
+}
+
+// Read 16-bit little-endian value from display list
+static uint16_t
+get16(const uint8_t* &ip, bool progmem)
+{
+  uint16_t res = get8(ip, progmem);
+  return (res | (get8(ip, progmem) << 8));
+}
+
+// Check if the bounding box is outside the clipping rectangle
+static bool
+is_outside(const Canvas::rect16_t* clip,
+	   uint16_t x, uint16_t y,
+	   uint16_t width, uint16_t height)
+{
+  if (clip == NULL) return (false);
+  return ((x >= clip->x + clip->width) ||
+	  (y >= clip->y + clip->height) ||
+	  (x + width <= clip->x) ||
+	  (y + height <= clip->y));
+}
+
+void
+DisplayList::play(Canvas* canvas, const uint8_t* list,
+		  bool progmem,
+		  const rect16_t* clip)
+{
+  const uint8_t* ip = list;
+  uint16_t x, y, w, h, r;
+  const uint8_t* bp;
+  uint8_t op, s;
+  while (1) {
+    switch (op = get8(ip, progmem)) {
+    case END:
+      return;
+    case SET_PEN_COLOR:
+      canvas->set_pen_color(color16_t(get16(ip, progmem)));
+      break;
+    case SET_CANVAS_COLOR:
+      canvas->set_canvas_color(color16_t(get16(ip, progmem)));
+      break;
+    case SET_TEXT_COLOR:
+      canvas->set_text_color(color16_t(get16(ip, progmem)));
+      break;
+    case SET_TEXT_SCALE:
+      canvas->set_text_scale(get8(ip, progmem));
+      break;
+    case SET_TEXT_FONT:
+      canvas->set_text_font((Font*) get16(ip, progmem));
+      break;
+    case DRAW_PIXEL:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      if (is_outside(clip, x, y, 1, 1)) break;
+      canvas->draw_pixel(x, y);
+      break;
+    case DRAW_BITMAP:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      bp = (const uint8_t*) get16(ip, progmem);
+      w = get16(ip, progmem);
+      h = get16(ip, progmem);
+      s = get8(ip, progmem);
+      if (is_outside(clip, x, y, w * s, ((h + 7) & ~7) * s)) break;
+      canvas->draw_bitmap(x, y, bp, w, h, s);
+      break;
+    case DRAW_COMPRESSED_ICON:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      bp = (const uint8_t*) get16(ip, progmem);
+      s = get8(ip, progmem);
+      w = pgm_read_byte(bp);
+      h = pgm_read_byte(bp + 1);
+      if (is_outside(clip, x, y, w * s, ((h + 7) & ~7) * s)) break;
+      canvas->draw_compressed_icon(x, y, bp, s);
+      break;
+    case DRAW_LINE:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      w = get16(ip, progmem);
+      h = get16(ip, progmem);
+      if (is_outside(clip,
+		     (x < w ? x : w), (y < h ? y : h),
+		     (x < w ? w - x : x - w) + 1,
+		     (y < h ? h - y : y - h) + 1)) break;
+      canvas->draw_line(x, y, w, h);
+      break;
+    case DRAW_VERTICAL_LINE:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      h = get16(ip, progmem);
+      if (is_outside(clip, x, y, 1, h + 1)) break;
+      canvas->draw_vertical_line(x, y, h);
+      break;
+    case DRAW_HORIZONTAL_LINE:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      w = get16(ip, progmem);
+      if (is_outside(clip, x, y, w + 1, 1)) break;
+      canvas->draw_horizontal_line(x, y, w);
+      break;
+    case DRAW_RECT:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      w = get16(ip, progmem);
+      h = get16(ip, progmem);
+      if (is_outside(clip, x, y, w + 1, h + 1)) break;
+      canvas->draw_rect(x, y, w, h);
+      break;
+    case FILL_RECT:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      w = get16(ip, progmem);
+      h = get16(ip, progmem);
+      if (is_outside(clip, x, y, w + 1, h + 1)) break;
+      canvas->fill_rect(x, y, w, h);
+      break;
+    case DRAW_ROUNDRECT:
+    case FILL_ROUNDRECT:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      w = get16(ip, progmem);
+      h = get16(ip, progmem);
+      r = get16(ip, progmem);
+      if (is_outside(clip, x, y, w + 1, h + 1)) break;
+      if (op == DRAW_ROUNDRECT)
+	canvas->draw_roundrect(x, y, w, h, r);
+      else
+	canvas->fill_roundrect(x, y, w, h, r);
+      break;
+    case DRAW_CIRCLE:
+    case FILL_CIRCLE:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      r = get16(ip, progmem);
+      if (is_outside(clip,
+		     (x > r ? x - r : 0), (y > r ? y - r : 0),
+		     2 * r + 1, 2 * r + 1)) break;
+      if (op == DRAW_CIRCLE)
+	canvas->draw_circle(x, y, r);
+      else
+	canvas->fill_circle(x, y, r);
+      break;
+    case DRAW_CHAR:
+      x = get16(ip, progmem);
+      y = get16(ip, progmem);
+      s = get8(ip, progmem);
+      {
+	Font* font = canvas->get_text_font();
+	uint8_t scale = canvas->get_text_scale();
+	w = scale * (font->WIDTH + font->SPACING);
+	if (is_outside(clip, x, y, w, scale * font->HEIGHT)) {
+	  canvas->set_cursor(x + w, y);
+	  break;
+	}
+      }
+      canvas->draw_char(x, y, (char) s);
+      break;
+    case FILL_SCREEN:
+      canvas->fill_screen();
+      break;
+    default:
+      return;
+    }
+  }
+}
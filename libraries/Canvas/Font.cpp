@@ -101,6 +101,15 @@ Font::Glyph::begin(char c)
       m_next = 0;
       break;
 
+    case 2:  // run-length encoded glyph
+      uint16_t offset;
+
+      offset = pgm_read_byte(&m_font->m_bitmap[(chr - m_font->FIRST)*2]) << 8;
+      offset |= pgm_read_byte(&m_font->m_bitmap[(chr - m_font->FIRST)*2 + 1]);
+      m_bitmap = (uint8_t*)&m_font->m_bitmap[offset];
+      m_rle.begin(m_bitmap);
+      break;
+
     default:
       m_bitmap = NULL;
     }
@@ -122,6 +131,10 @@ Font::Glyph::next()
       result = pgm_read_byte(&m_bitmap[m_offset++]);
       break;
 
+    case 2:  // run-length encoded glyph
+      result = m_rle.next();
+      break;
+
     case 1:  // non-zero "present" bitset
       uint8_t bitset_offset = m_offset >> 3;
       if (m_flags & ESCAPED_BITSET)
@@ -50,7 +50,7 @@ public:
    * @param[in] first character available.
    * @param[in] last character available.
    * @param[in] bitmap font storage.
-   * @param[in] compression_type.
+   * @param[in] compression_type (0 = none, 1 = bitset, 2 = run-length).
    * @param[in] spacing recommended character spacing.
    * @param[in] line_spacing recommended line spacing.
    */
@@ -136,6 +136,7 @@ public:
     uint8_t* m_bitset;  // in progmem
     uint8_t* m_bitmap;  // in progmem
     uint8_t m_next;
+    Canvas::RLE m_rle;  // run-length decoder
   };
 
 protected:
@@ -21,6 +21,29 @@
 #include <Canvas.h>
 #include "Canvas/Element/Textbox.hh"
 
+bool
+Textbox::set_scroll(bool flag)
+{
+  // Restore the full screen scroll area when disabled
+  m_scroll_start = 0;
+  if (!flag) {
+    if (m_scroll_height == 0) return (true);
+    m_scroll_height = 0;
+    m_canvas->set_scroll_area(0, m_canvas->HEIGHT);
+    m_canvas->set_scroll_start(0);
+    return (true);
+  }
+
+  // Scroll area is the whole lines of the text port
+  uint16_t line_height = m_text_scale * (m_font->HEIGHT + m_font->LINE_SPACING);
+  uint16_t height = (m_text_port.height / line_height) * line_height;
+  if (UNLIKELY(height == 0)) return (false);
+  if (!m_canvas->set_scroll_area(m_text_port.y, height)) return (false);
+  m_canvas->set_scroll_start(m_text_port.y);
+  m_scroll_height = height;
+  return (true);
+}
+
 int
 Textbox::putchar(char c)
 {
@@ -36,7 +59,19 @@ Textbox::putchar(char c)
     uint16_t font_height = scale * (m_font->HEIGHT);
     uint16_t line_height = scale * (m_font->HEIGHT + m_font->LINE_SPACING);
     uint16_t y = m_cursor.y + line_height;
-    if (y + font_height > m_text_port.y + m_text_port.height) {
+    if (m_scroll_height != 0) {
+      // Hardware scroll; wrap-around in the scroll area and scroll a
+      // line when the new line is the first shown line
+      if (y + line_height > m_text_port.y + m_scroll_height) {
+	y = m_text_port.y;
+      }
+      if (y == m_text_port.y + m_scroll_start) {
+	m_scroll_start += line_height;
+	if (m_scroll_start == m_scroll_height) m_scroll_start = 0;
+	m_canvas->set_scroll_start(m_text_port.y + m_scroll_start);
+      }
+    }
+    else if (y + font_height > m_text_port.y + m_text_port.height) {
       y = m_text_port.y;
     }
     x = m_text_port.x;
@@ -57,6 +92,10 @@ Textbox::putchar(char c)
     set_cursor(m_text_port.x, m_text_port.y);
     m_canvas->fill_rect(m_text_port.width, m_text_port.height);
     set_pen_color(saved);
+    if (m_scroll_start != 0) {
+      m_scroll_start = 0;
+      m_canvas->set_scroll_start(m_text_port.y);
+    }
   }
 
   // Draw other characters
@@ -90,6 +90,14 @@
 //#include <ILI9341.h>
 //ILI9341 tft;
 
+// ILI9341 on 8-bit parallel bus; data D22..D29, WR D30, CS D10 and
+// DC D9 on Mega (Uno data D0..D7 conflicts with UART). RD tied high
+//#define USE_TFT_ILI9341
+//#include <GDDRAM.h>
+//#include <ILI9341.h>
+//GDDRAM::Port8b port;
+//ILI9341 tft(&port);
+
 #define USE_TFT_ILI9163
 #include <GDDRAM.h>
 #include <ILI9163.h>
@@ -152,7 +152,7 @@ void
 Ciao::write(uint64_t* buf, uint16_t count)
 {
   write(UINT64_TYPE, count);
-  m_dev->write(buf, count * sizeof(uint32_t));
+  m_dev->write(buf, count * sizeof(uint64_t));
 }
 
 void
@@ -207,7 +207,7 @@ void
 Ciao::write(int64_t* buf, uint16_t count)
 {
   write(INT64_TYPE, count);
-  m_dev->write(buf, count * sizeof(int32_t));
+  m_dev->write(buf, count * sizeof(int64_t));
 }
 
 void
@@ -224,26 +224,34 @@ Ciao::write(float* buf, uint16_t count)
   m_dev->write(buf, count * sizeof(float));
 }
 
-void
-Ciao::write(uint8_t type, uint16_t count)
+uint8_t
+Ciao::encode(uint8_t* dp, uint8_t type, uint16_t count)
 {
   // Tag byte contains count[0..7]
   if (count < 8) {
-    count |= type;
+    dp[0] = type | count;
+    return (1);
   }
 
   // Else tag byte contains marker. Succeeding byte counter[8..255]
-  else if (count < 256) {
-    m_dev->putchar(type | COUNT8_ATTR);
+  if (count < 256) {
+    dp[0] = type | COUNT8_ATTR;
+    dp[1] = count;
+    return (2);
   }
 
   // Else tag byte contains marker. Succeeding two bytes counter[256..64K]
-  else {
-    m_dev->putchar(type | COUNT16_ATTR);
-    m_dev->putchar(count >> 8);
-  }
+  dp[0] = type | COUNT16_ATTR;
+  dp[1] = count >> 8;
+  dp[2] = count;
+  return (3);
+}
 
-  m_dev->putchar(count);
+void
+Ciao::write(uint8_t type, uint16_t count)
+{
+  uint8_t tag[TAG_MAX];
+  m_dev->write(tag, encode(tag, type, count));
 }
 
 void
@@ -300,44 +308,91 @@ static const uint8_t sizeoftype[] __PROGMEM = {
   0
 };
 
-void
-Ciao::write(const Descriptor::user_t* desc, void* buf, uint16_t count)
+uint8_t
+Ciao::size_of(uint8_t type)
+{
+  return (pgm_read_byte(&sizeoftype[type >> 4]));
+}
+
+Ciao::Layout::Layout(const Descriptor::user_t* desc) :
+  m_desc(desc),
+  m_size(0),
+  m_flat(true)
 {
   // Read descriptor from program memory
   Descriptor::user_t d;
   memcpy_P(&d, desc, sizeof(d));
+  m_id = d.id;
+
+  // Accumulate the size of the members; strings are pointers
+  const Descriptor::member_t* mp = d.member;
+  for (uint8_t i = 0; i < d.count; i++) {
+    Descriptor::member_t m;
+    memcpy_P(&m, mp++, sizeof(m));
+    if (m.count == 0 && m.type == UINT8_TYPE) {
+      m_size += sizeof(char*);
+      m_flat = false;
+    }
+    else {
+      uint16_t s = size_of(m.type) * m.count;
+      if (s == 0) {
+	m_size = 0;
+	return;
+      }
+      m_size += s;
+    }
+  }
+}
+
+void
+Ciao::write(const Descriptor::user_t* desc, void* buf, uint16_t count)
+{
+  write(Layout(desc), buf, count);
+}
+
+void
+Ciao::write(const Layout& layout, const void* buf, uint16_t count)
+{
+  // Allow strings and data elements vectors only
+  // Fix: Add table with user defined types
+  if (layout.size() == 0) return;
 
   // Write type tag for user data with count and type identity
-  if (d.id < 256) {
-    write(USER8_TYPE, count);
+  uint8_t tag[TAG_MAX];
+  uint16_t id = layout.id();
+  uint8_t len;
+  if (id < 256) {
+    len = encode(tag, USER8_TYPE, count);
   }
   else {
-    write(USER16_TYPE, count);
-    m_dev->putchar(d.id >> 8);
+    len = encode(tag, USER16_TYPE, count);
+    tag[len++] = id >> 8;
+  }
+  tag[len++] = id;
+  m_dev->write(tag, len);
+
+  // Write values as a block when there are no string members
+  if (layout.is_flat()) {
+    m_dev->write(buf, count * layout.size());
+    return;
   }
-  m_dev->putchar(d.id);
 
-  // Write data buffer to stream
-  uint8_t* dp = (uint8_t*) buf;
+  // Write data buffer to stream member by member
+  Descriptor::user_t d;
+  memcpy_P(&d, layout.descriptor(), sizeof(d));
+  const uint8_t* dp = (const uint8_t*) buf;
   while (count--) {
     const Descriptor::member_t* mp = d.member;
     for (uint16_t i = 0; i < d.count; i++) {
       Descriptor::member_t m;
       memcpy_P(&m, mp++, sizeof(m));
-      // Allow strings and data elements vectors only
-      // Fix: Add table with user defined types
       if (m.count == 0 && m.type == UINT8_TYPE) {
-	uint8_t* sp = *((uint8_t**) dp);
-	uint8_t d;
-	do {
-	  d = *sp++;
-	  m_dev->putchar(d);
-	} while (d != 0);
+	const char* sp = *((const char**) dp);
+	m_dev->write(sp, strlen(sp) + 1);
 	dp += sizeof(sp);
       }
       else {
-	size_t s = pgm_read_byte(&sizeoftype[m.type >> 4]) * m.count;
-	if (s == 0) return;
+	size_t s = size_of(m.type) * m.count;
 	m_dev->write(dp, s);
 	dp += s;
       }
@@ -130,6 +130,206 @@ public:
     BIG_ENDIAN = 1
   } __attribute__((packed));
 
+  /**
+   * Cached layout of a user defined data type. The descriptor in
+   * program memory is scanned once; the layout holds the identity,
+   * the size of a value in memory and if the value may be written as
+   * a single block (no string members). Use for streaming of arrays
+   * of user defined data types.
+   */
+  class Layout {
+  public:
+    /**
+     * Construct layout for given user defined data type descriptor.
+     * @param[in] desc descriptor (program memory).
+     */
+    Layout(const Descriptor::user_t* desc);
+
+    /**
+     * Return descriptor (program memory).
+     * @return descriptor.
+     */
+    const Descriptor::user_t* descriptor() const
+    {
+      return (m_desc);
+    }
+
+    /**
+     * Return user data type identity.
+     * @return identity.
+     */
+    uint16_t id() const
+    {
+      return (m_id);
+    }
+
+    /**
+     * Return size of value in memory, or zero(0) if the descriptor
+     * contains members that are not supported.
+     * @return size in bytes.
+     */
+    uint16_t size() const
+    {
+      return (m_size);
+    }
+
+    /**
+     * Return true(1) if the value is written to the stream as is
+     * (no string members) otherwise false(0).
+     * @return bool.
+     */
+    bool is_flat() const
+    {
+      return (m_flat);
+    }
+
+  protected:
+    const Descriptor::user_t* m_desc; //!< Descriptor (program memory).
+    uint16_t m_id;		      //!< User data type identity.
+    uint16_t m_size;		      //!< Size of value in memory.
+    bool m_flat;		      //!< Value written as block.
+  };
+
+  /**
+   * Streaming Ciao decoder. Data is pushed to the decoder in blocks
+   * of any size, e.g. as received from a device, and the decoder
+   * calls the member functions on_begin(), on_data() and on_end()
+   * for each data value, sequence or descriptor member. Data is
+   * passed as spans of the given block without copying. The size of
+   * a user defined data type value must be given by layout() for
+   * the data to be decoded.
+   */
+  class Decoder {
+  public:
+    /**
+     * Construct decoder in initial state.
+     */
+    Decoder() :
+      m_header(&Descriptor::header_t),
+      m_state(TAG_STATE),
+      m_desc(false)
+    {}
+
+    /**
+     * Decode the given block of stream data. Returns number of bytes
+     * decoded or negative error code(EINVAL) if the stream contains a
+     * reserved tag or a user defined data type with unknown layout.
+     * The decoder must be reset() after an error.
+     * @param[in] buf pointer to stream data.
+     * @param[in] size number of bytes.
+     * @return number of bytes or negative error code.
+     */
+    int decode(const void* buf, size_t size);
+
+    /**
+     * Reset decoder to initial state.
+     */
+    void reset()
+    {
+      m_state = TAG_STATE;
+      m_desc = false;
+    }
+
+    /**
+     * @override{Ciao::Decoder}
+     * Called when a tag and its attributes have been decoded; type
+     * tag, number of elements (zero for null terminated sequence)
+     * and user defined data type identity. Within a descriptor the
+     * member tags are passed and data is the member name.
+     * @param[in] type data type tag.
+     * @param[in] count number of elements.
+     * @param[in] id user defined data type identity.
+     */
+    virtual void on_begin(uint8_t type, uint16_t count, uint16_t id)
+    {
+      UNUSED(type);
+      UNUSED(count);
+      UNUSED(id);
+    }
+
+    /**
+     * @override{Ciao::Decoder}
+     * Called with the data for the current value. May be called
+     * several times for each value depending on the block size.
+     * Null terminated sequences (strings and names) are passed with
+     * the terminating null.
+     * @param[in] buf pointer to data.
+     * @param[in] size number of bytes.
+     */
+    virtual void on_data(const void* buf, size_t size)
+    {
+      UNUSED(buf);
+      UNUSED(size);
+    }
+
+    /**
+     * @override{Ciao::Decoder}
+     * Called when the current value has been decoded.
+     */
+    virtual void on_end() {}
+
+    /**
+     * @override{Ciao::Decoder}
+     * Return layout for given user defined data type identity or
+     * NULL if unknown. Default returns the layout of the Ciao header.
+     * @param[in] id user defined data type identity.
+     * @return layout or NULL.
+     */
+    virtual const Layout* layout(uint16_t id);
+
+  protected:
+    /** Decoder states. */
+    enum {
+      TAG_STATE,		//!< Tag byte.
+      COUNT_HIGH_STATE,		//!< Count MSB.
+      COUNT_LOW_STATE,		//!< Count LSB.
+      ID_HIGH_STATE,		//!< Identity MSB.
+      ID_LOW_STATE,		//!< Identity LSB.
+      DATA_STATE,		//!< Data; number of bytes.
+      STRING_STATE,		//!< Data; null terminated.
+      ERROR_STATE		//!< Reserved tag or unknown layout.
+    } __attribute__((packed));
+
+    Layout m_header;		//!< Ciao header layout.
+    uint8_t m_state;		//!< Decoder state.
+    bool m_desc;		//!< Within descriptor.
+    uint8_t m_type;		//!< Current type tag.
+    uint16_t m_count;		//!< Number of elements.
+    uint16_t m_id;		//!< User data type identity.
+    uint32_t m_size;		//!< Remaining number of data bytes.
+    const Layout* m_layout;	//!< Current user data type layout.
+    uint16_t m_elem;		//!< Remaining number of values.
+    uint8_t m_member;		//!< Next member in value.
+
+    /**
+     * Return next state after tag and count; identity or data.
+     * @return state.
+     */
+    uint8_t id_state();
+
+    /**
+     * Call on_begin() and return state for the data of the current
+     * tag.
+     * @return state.
+     */
+    uint8_t data_state();
+
+    /**
+     * Return state for the next member of a user defined data type
+     * value with string members, or TAG_STATE when all values have
+     * been decoded.
+     * @return state.
+     */
+    uint8_t member_state();
+
+    /**
+     * Return state when data has been decoded. Calls on_end() when
+     * the current value is completed.
+     * @return state.
+     */
+    uint8_t end_state();
+  };
+
 public:
   /**
    * Construct data streaming for given device.
@@ -296,7 +496,28 @@ public:
    */
   void write(const Descriptor::user_t* desc, void* buf, uint16_t count);
 
+  /**
+   * Write given user defined data type value(s) to data stream with
+   * cached layout. A sequence of values without string members is
+   * written with a single header and a single device write.
+   * @param[in] layout user defined data type layout.
+   * @param[in] buf pointer to value(s) to write.
+   * @param[in] count size of sequence to write.
+   */
+  void write(const Layout& layout, const void* buf, uint16_t count);
+
+  /**
+   * Return size of given elementary data type or zero(0) if not
+   * supported.
+   * @param[in] type data type tag.
+   * @return size in bytes.
+   */
+  static uint8_t size_of(uint8_t type);
+
 protected:
+  /** Max size of encoded tag with count and identity. */
+  static const uint8_t TAG_MAX = 5;
+
   /**
    * Write data tag to given stream.
    * @param[in] type data type tag.
@@ -304,6 +525,16 @@ protected:
    */
   void write(uint8_t type, uint16_t count);
 
+  /**
+   * Encode data tag with given type and count to given buffer.
+   * Return number of bytes.
+   * @param[in] dp buffer pointer (at least TAG_MAX bytes).
+   * @param[in] type data type tag.
+   * @param[in] count number of elements in sequence.
+   * @return number of bytes.
+   */
+  static uint8_t encode(uint8_t* dp, uint8_t type, uint16_t count);
+
   IOStream::Device* m_dev;
 };
 
@@ -0,0 +1,188 @@
+/**
+ * @file Ciao_Decoder.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Ciao.hh"
+
+const Ciao::Layout*
+Ciao::Decoder::layout(uint16_t id)
+{
+  if (id == Descriptor::HEADER_ID) return (&m_header);
+  return (NULL);
+}
+
+int
+Ciao::Decoder::decode(const void* buf, size_t size)
+{
+  const uint8_t* bp = (const uint8_t*) buf;
+  size_t n = size;
+  while (n != 0) {
+    switch (m_state) {
+    case TAG_STATE:
+      {
+	uint8_t c = *bp++;
+	uint8_t attr = c & MASK_ATTR;
+	n -= 1;
+	m_type = c & MASK_TYPE;
+	m_count = 0;
+	m_id = 0;
+	m_layout = NULL;
+
+	// Descriptor start or end tag
+	if (m_type == USER8_DESC_START || m_type == USER16_DESC_START) {
+	  if (attr == END_SEQUENCE_ATTR) {
+	    on_begin(c, 0, 0);
+	    on_end();
+	    m_desc = false;
+	  }
+	  else if (attr == COUNT0_ATTR) {
+	    m_state = (m_type == USER8_DESC_START) ? ID_LOW_STATE : ID_HIGH_STATE;
+	  }
+	  else m_state = ERROR_STATE;
+	}
+
+	// Data or member tag with count
+	else if (attr <= COUNT4_MASK) {
+	  m_count = attr;
+	  m_state = id_state();
+	}
+	else if (attr == COUNT8_ATTR)
+	  m_state = COUNT_LOW_STATE;
+	else if (attr == COUNT16_ATTR)
+	  m_state = COUNT_HIGH_STATE;
+	else
+	  m_state = ERROR_STATE;
+      }
+      break;
+    case COUNT_HIGH_STATE:
+      m_count = (*bp++) << 8;
+      n -= 1;
+      m_state = COUNT_LOW_STATE;
+      break;
+    case COUNT_LOW_STATE:
+      m_count |= *bp++;
+      n -= 1;
+      m_state = id_state();
+      break;
+    case ID_HIGH_STATE:
+      m_id = (*bp++) << 8;
+      n -= 1;
+      m_state = ID_LOW_STATE;
+      break;
+    case ID_LOW_STATE:
+      m_id |= *bp++;
+      n -= 1;
+      m_state = data_state();
+      break;
+    case DATA_STATE:
+      {
+	size_t s = (m_size < n) ? m_size : n;
+	on_data(bp, s);
+	bp += s;
+	n -= s;
+	m_size -= s;
+	if (m_size == 0) m_state = end_state();
+      }
+      break;
+    case STRING_STATE:
+      {
+	const uint8_t* sp = (const uint8_t*) memchr(bp, 0, n);
+	size_t s = (sp == NULL) ? n : (sp - bp) + 1;
+	on_data(bp, s);
+	bp += s;
+	n -= s;
+	if (sp != NULL) m_state = end_state();
+      }
+      break;
+    default:
+      return (EINVAL);
+    }
+  }
+  return (m_state == ERROR_STATE ? EINVAL : (int) size);
+}
+
+uint8_t
+Ciao::Decoder::id_state()
+{
+  // Member tags within a descriptor do not have an identity
+  if (!m_desc) {
+    if (m_type == USER8_TYPE) return (ID_LOW_STATE);
+    if (m_type == USER16_TYPE) return (ID_HIGH_STATE);
+  }
+  return (data_state());
+}
+
+uint8_t
+Ciao::Decoder::data_state()
+{
+  on_begin(m_type, m_count, m_id);
+
+  // Descriptor start and members are followed by a name
+  if (m_type == USER8_DESC_START || m_type == USER16_DESC_START) {
+    m_desc = true;
+    return (STRING_STATE);
+  }
+  if (m_desc) return (STRING_STATE);
+
+  // User defined data type values require the layout
+  if (m_type == USER8_TYPE || m_type == USER16_TYPE) {
+    m_layout = layout(m_id);
+    if (m_layout == NULL || m_layout->size() == 0 || m_count == 0)
+      return (ERROR_STATE);
+    if (!m_layout->is_flat()) {
+      m_elem = m_count;
+      m_member = 0;
+      return (member_state());
+    }
+    m_size = (uint32_t) m_count * m_layout->size();
+    return (DATA_STATE);
+  }
+
+  // Elementary data type values or null terminated sequence
+  if (m_count == 0) return (STRING_STATE);
+  m_size = (uint32_t) m_count * size_of(m_type);
+  return (m_size == 0 ? ERROR_STATE : DATA_STATE);
+}
+
+uint8_t
+Ciao::Decoder::member_state()
+{
+  Descriptor::user_t d;
+  memcpy_P(&d, m_layout->descriptor(), sizeof(d));
+  if (m_member == d.count) {
+    m_member = 0;
+    if (--m_elem == 0) return (TAG_STATE);
+  }
+  Descriptor::member_t m;
+  memcpy_P(&m, &d.member[m_member++], sizeof(m));
+  if (m.count == 0 && m.type == UINT8_TYPE) return (STRING_STATE);
+  m_size = size_of(m.type) * m.count;
+  return (DATA_STATE);
+}
+
+uint8_t
+Ciao::Decoder::end_state()
+{
+  if (m_layout != NULL && !m_layout->is_flat()) {
+    uint8_t state = member_state();
+    if (state != TAG_STATE) return (state);
+  }
+  on_end();
+  return (TAG_STATE);
+}
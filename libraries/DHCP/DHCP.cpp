@@ -27,7 +27,10 @@ DHCP::DHCP(const char* hostname, const uint8_t* mac) :
   m_mac(mac),
   m_sock(NULL),
   m_lease_obtained(0L),
-  m_lease_expires(0L)
+  m_lease_expires(0L),
+  m_lease_renew(0L),
+  m_eeprom(NULL),
+  m_lease(NULL)
 {
 }
 
@@ -79,15 +82,20 @@ DHCP::send(uint8_t type)
   res = m_sock->write(buf, 14 + len);
   if (UNLIKELY(res < 0)) return (res);
 
-  // On request add client and server address options
+  // On request add client and server address options. The server
+  // address is not known on INIT-REBOOT
   if (type == DHCP_REQUEST) {
     buf[0] = REQUESTED_IP_ADDR;
     buf[1] = INET::IP_MAX;
     memcpy(&buf[2], m_ip, INET::IP_MAX);
-    buf[6] = SERVER_IDENTIFIER;
-    buf[7] = INET::IP_MAX;
-    memcpy(&buf[8], m_dhcp, INET::IP_MAX);
-    res = m_sock->write(buf, 8 + INET::IP_MAX);
+    len = 2 + INET::IP_MAX;
+    if ((m_dhcp[0] | m_dhcp[1] | m_dhcp[2] | m_dhcp[3]) != 0) {
+      buf[6] = SERVER_IDENTIFIER;
+      buf[7] = INET::IP_MAX;
+      memcpy(&buf[8], m_dhcp, INET::IP_MAX);
+      len += 2 + INET::IP_MAX;
+    }
+    res = m_sock->write(buf, len);
     if (UNLIKELY(res < 0)) return (res);
   }
 
@@ -144,6 +152,7 @@ DHCP::recv(uint8_t type, uint16_t ms)
   // Parse options and collect; subnet mask, server addresses and lease time
   uint8_t op;
   uint8_t len;
+  uint32_t t1 = 0L;
   res = 0;
   while (m_sock->read(&op, sizeof(op)) == sizeof(op)) {
     if (op == END_OPTION) break;
@@ -163,6 +172,9 @@ DHCP::recv(uint8_t type, uint16_t ms)
     case ROUTERS_ON_SUBNET:
       memcpy(m_gateway, buf, sizeof(m_gateway));
       break;
+    case T1_VALUE:
+      t1 = ntoh(*((int32_t*) buf));
+      break;
     case IP_ADDR_LEASE_TIME:
       m_lease_obtained = Watchdog::millis() / 1000;
       int32_t* expire_p = (int32_t*) buf;
@@ -171,6 +183,10 @@ DHCP::recv(uint8_t type, uint16_t ms)
     };
   };
 
+  // Renewal time (T1); default half the lease time
+  if (t1 == 0L) t1 = (m_lease_expires - m_lease_obtained) / 2;
+  m_lease_renew = m_lease_obtained + t1;
+
   // Flush any remains of the reply
   while (m_sock->available() > 0) m_sock->read(buf, sizeof(buf));
   return (res);
@@ -213,21 +229,79 @@ DHCP::request(uint8_t ip[4], uint8_t subnet[4], uint8_t gateway[4])
   memcpy(ip, m_ip, sizeof(m_ip));
   memcpy(subnet, m_subnet, sizeof(m_subnet));
   memcpy(gateway, m_gateway, sizeof(m_gateway));
+  save(true);
+  return (0);
+}
+
+int
+DHCP::reboot(uint8_t ip[4], uint8_t subnet[4], uint8_t gateway[4])
+{
+  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+
+  // Read persistent lease and check that it is valid
+  if (UNLIKELY(m_eeprom == NULL)) return (ENOENT);
+  lease_t lease;
+  int res = m_eeprom->read(&lease, m_lease, sizeof(lease));
+  if (UNLIKELY(res != sizeof(lease))) return (EIO);
+  if (lease.magic != LEASE_MAGIC) return (ENOENT);
+
+  // Request the previous network address; the server is not known.
+  // Use the previous options as default
+  memcpy(m_ip, lease.ip, sizeof(m_ip));
+  memcpy(m_subnet, lease.subnet, sizeof(m_subnet));
+  memcpy(m_gateway, lease.gateway, sizeof(m_gateway));
+  memcpy(m_dns, lease.dns, sizeof(m_dns));
+  memset(m_dhcp, 0, sizeof(m_dhcp));
+  res = send(DHCP_REQUEST);
+  if (UNLIKELY(res < 0)) return (res);
+  res = recv(DHCP_ACK);
+  if (res == ETIME) return (res);
+
+  // Invalidate the persistent lease if rejected
+  if (UNLIKELY(res < 0)) {
+    save(false);
+    return (EACCES);
+  }
+  memcpy(ip, m_ip, sizeof(m_ip));
+  memcpy(subnet, m_subnet, sizeof(m_subnet));
+  memcpy(gateway, m_gateway, sizeof(m_gateway));
+  save(true);
   return (0);
 }
 
+void
+DHCP::save(bool valid)
+{
+  if (m_eeprom == NULL) return;
+  lease_t lease;
+  if (valid) {
+    lease.magic = LEASE_MAGIC;
+    memcpy(lease.ip, m_ip, sizeof(lease.ip));
+    memcpy(lease.subnet, m_subnet, sizeof(lease.subnet));
+    memcpy(lease.gateway, m_gateway, sizeof(lease.gateway));
+    memcpy(lease.dhcp, m_dhcp, sizeof(lease.dhcp));
+    memcpy(lease.dns, m_dns, sizeof(lease.dns));
+    lease.time = m_lease_expires - m_lease_obtained;
+  }
+  else {
+    memset(&lease, 0, sizeof(lease));
+  }
+  m_eeprom->write(m_lease, &lease, sizeof(lease));
+}
+
 int
 DHCP::renew(Socket* sock)
 {
   if (UNLIKELY(m_sock != NULL)) return (ENOTSOCK);
   if (UNLIKELY(m_lease_expires == 0L)) return (EACCES);
+  if (UNLIKELY(sock == NULL)) return (ENOTSOCK);
   m_sock = sock;
   int res = send(DHCP_REQUEST);
-  if (UNLIKELY(res < 0)) return (res);
-  res = recv(DHCP_ACK);
-  if (UNLIKELY(res < 0)) return (res);
+  if (res == 0) res = recv(DHCP_ACK);
   m_sock->close();
   m_sock = NULL;
+  if (UNLIKELY(res < 0)) return (res);
+  save(true);
   return (0);
 }
 
@@ -245,6 +319,8 @@ DHCP::release(Socket* sock)
   memset(m_ip, 0, sizeof(m_ip));
   m_lease_obtained = 0L;
   m_lease_expires = 0L;
+  m_lease_renew = 0L;
+  save(false);
   return (0);
 }
 
@@ -23,6 +23,7 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Socket.hh"
+#include "Cosa/EEPROM.hh"
 
 /**
  * Dynamic Host Configuration Protocol. Supports dynamic assignment of
@@ -35,6 +36,20 @@ public:
   /** DHCP Client port numbers. */
   static const uint16_t PORT = 68;
 
+  /**
+   * Persistent network address lease; stored in EEPROM after each
+   * granted request and used for INIT-REBOOT, see reboot().
+   */
+  struct lease_t {
+    uint16_t magic;		//!< Magic number; valid lease.
+    uint8_t ip[4];		//!< Granted network address.
+    uint8_t subnet[4];		//!< Subnet mask.
+    uint8_t gateway[4];		//!< Router in network.
+    uint8_t dhcp[4];		//!< DHCP server address.
+    uint8_t dns[4];		//!< DNS server address.
+    uint32_t time;		//!< Lease time (seconds).
+  };
+
   /**
    * Construct DHCP client access with given hostname and hardware
    * address.
@@ -99,6 +114,33 @@ public:
    */
   int release(Socket* sock);
 
+  /**
+   * Use the given EEPROM and address for the persistent network
+   * address lease. The lease is written when granted and invalidated
+   * on release or when rejected by the server.
+   * @param[in] eeprom device.
+   * @param[in] lease address in EEPROM.
+   */
+  void persist(EEPROM* eeprom, lease_t* lease)
+  {
+    m_eeprom = eeprom;
+    m_lease = lease;
+  }
+
+  /**
+   * Request the persistent network address lease (INIT-REBOOT) from
+   * the DHCP server. Should be used after begin() and before
+   * discover(). Returns zero if successful otherwise a negative error
+   * code; ENOENT no persistent lease, ETIME no response, EACCES
+   * lease rejected. Client network address, subnet mask and gateway
+   * are returned in given reference parameters.
+   * @param[in,out] ip granted network address.
+   * @param[in,out] subnet mask.
+   * @param[in,out] gateway network address.
+   * @return zero if successful otherwise a negative error code.
+   */
+  int reboot(uint8_t ip[4], uint8_t subnet[4], uint8_t gateway[4]);
+
   /** Return time when lease was obtained. */
   uint32_t lease_obtained() const
   {
@@ -111,6 +153,12 @@ public:
     return (m_lease_expires);
   }
 
+  /** Return time when lease should be renewed (T1). */
+  uint32_t lease_renew() const
+  {
+    return (m_lease_renew);
+  }
+
   /** Return network address of DHCP server. */
   const uint8_t* dhcp_addr() const
   {
@@ -229,6 +277,18 @@ private:
   /** Lease expires. */
   uint32_t m_lease_expires;
 
+  /** Lease should be renewed (T1). */
+  uint32_t m_lease_renew;
+
+  /** EEPROM for persistent lease. */
+  EEPROM* m_eeprom;
+
+  /** Persistent lease address in EEPROM. */
+  lease_t* m_lease;
+
+  /** Persistent lease magic number. */
+  static const uint16_t LEASE_MAGIC = 0xD4C9;
+
   /** DHCP Server port numbers. */
   static const uint16_t SERVER_PORT = 67;
 
@@ -249,6 +309,13 @@ private:
    * @return zero if successful otherwise negative error code.
    */
   int recv(uint8_t type, uint16_t ms = 2000);
+
+  /**
+   * Write granted lease to the persistent lease in EEPROM, or
+   * invalidate when given false.
+   * @param[in] valid lease flag.
+   */
+  void save(bool valid);
 };
 
 #endif
@@ -24,12 +24,14 @@
 
 /*
  * The interrupt handler, enabled after the request pulse, and on
- * falling (low to high) transition. This allows lower interrupt
+ * falling (high to low) transition. This allows lower interrupt
  * frequency than on change mode (which would be required for pin
  * change interrupts. First pulse is the device response and a
  * one(1) bit is encoded as a long pulse (54 + 80 = 134 us), a
  * zero(0) bit as a short pulse (54 + 24 = 78 us). Sequence ends
  * with a low pulse (54 us) which allows falling/rising detection.
+ * Only the pulse widths are captured; the bits are decoded outside
+ * the interrupt handler.
  */
 void
 DHT::on_interrupt(uint16_t arg)
@@ -39,62 +41,94 @@ DHT::on_interrupt(uint16_t arg)
   // Calculate the pulse width and check against thresholds
   uint16_t stop = RTT::micros();
   uint16_t us = (stop - m_start);
-  bool valid = false;
+  m_start = stop;
 
   // Check the initial response pulse
   if (m_state == RESPONSE) {
     if (us < BIT_THRESHOLD) goto exception;
     m_state = SAMPLING;
-    m_start = stop;
-    m_bits = 0;
     m_ix = 0;
     return;
   }
 
-  // Sanity check the pulse length
+  // Sanity check the pulse length and capture
   if (us < LOW_THRESHOLD || us > HIGH_THRESHOLD) goto exception;
-  m_start = stop;
-
-  // Sample was valid, collect bit and check for more
-  m_value = (m_value << 1) + (us > BIT_THRESHOLD);
-  m_bits += 1;
-  if (m_bits != CHARBITS) return;
-
-  // Next byte ready
-  m_data.as_byte[m_ix++] = m_value;
-  m_bits = 0;
-  valid = (m_ix == DATA_MAX);
-  if (valid) goto completed;
-  return;
+  m_width[m_ix++] = us;
+  if (m_ix != BITS_MAX) return;
+  goto completed;
 
   // Invalid sample reject sequence
  exception:
   m_ix = 0;
 
-  // Sequence completed
+  // Sequence completed; decode in event handler
  completed:
   m_state = COMPLETED;
   disable();
-  if (valid) adjust_data();
-  on_sample_completed(valid);
+  Event::push(Event::SAMPLE_COMPLETED_TYPE, this);
 }
 
-bool
-DHT::sample_request()
+void
+DHT::response()
 {
-  // Issue a request; pull down for more than 18 ms
-  mode(OUTPUT_MODE);
-  IOPin::clear();
-  Watchdog::delay(32);
-
   // Request pulse completed; pull up for 40 us and collect
-  // data as a sequence of on rising mode interrupts
+  // data as a sequence of on falling mode interrupts
   m_state = RESPONSE;
+  m_ix = 0;
   m_start = RTT::micros();
   IOPin::set();
   mode(INPUT_MODE);
   DELAY(40);
   enable();
+}
+
+bool
+DHT::decode()
+{
+  // Assemble the data bytes from the captured pulse widths
+  if (m_ix == BITS_MAX) {
+    const uint8_t* wp = m_width;
+    for (uint8_t i = 0; i < DATA_MAX; i++) {
+      uint8_t value = 0;
+      for (uint8_t j = 0; j < CHARBITS; j++)
+	value = (value << 1) + (*wp++ > BIT_THRESHOLD);
+      m_data.as_byte[i] = value;
+    }
+  }
+
+  // Validate check sum and adjust data
+  m_valid = is_valid();
+  if (m_valid) adjust_data();
+  m_state = IDLE;
+  return (m_valid);
+}
+
+void
+DHT::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (type != Event::SAMPLE_COMPLETED_TYPE || m_state != COMPLETED) return;
+  on_sample_completed(decode());
+}
+
+bool
+DHT::sample_request()
+{
+  // Check that a request is not in progress
+  if (m_state == REQUEST || m_state == RESPONSE || m_state == SAMPLING)
+    return (false);
+
+  // Issue a request; pull down for more than 18 ms
+  m_state = REQUEST;
+  mode(OUTPUT_MODE);
+  IOPin::clear();
+  if (m_request.is_scheduled()) {
+    m_request.expire_at(m_request.time() + REQUEST_PULSE);
+    m_request.start();
+    return (true);
+  }
+  Watchdog::delay(32);
+  response();
   return (true);
 }
 
@@ -103,19 +137,27 @@ DHT::sample_await()
 {
   // Wait for the sample request to complete
   uint32_t start = RTT::millis();
-  while (m_state != COMPLETED && (RTT::since(start) < MIN_PERIOD))
+  while (m_state != COMPLETED
+	 && m_state != IDLE
+	 && (RTT::since(start) < MIN_PERIOD))
     yield();
-  if (m_state != COMPLETED) return (false);
+  if (m_state == COMPLETED) decode();
+  if (m_state != IDLE) {
+    m_request.stop();
+    disable();
+    m_state = INIT;
+    return (false);
+  }
 
-  // Data reading was completed; validate data and check sum
+  // Data reading was completed; return validity
   m_state = INIT;
-  return (is_valid());
+  return (m_valid);
 }
 
 bool
 DHT::is_valid()
 {
-  if (m_ix != DATA_MAX) return (false);
+  if (m_ix != BITS_MAX) return (false);
   uint8_t sum = 0;
   for (uint8_t i = 0; i < DATA_LAST; i++)
     sum += m_data.as_byte[i];
@@ -23,15 +23,21 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Job.hh"
 #include "Cosa/IOStream.hh"
 
 /**
  * DHT11/22 Humidity & Temperature Sensor common device driver.
  * Uses external interrupt on high to low transition to capture
- * serial data from the device. Please note that excessive interrupt
- * sources may affect the capture.
+ * the pulse widths of the serial data from the device. The frame is
+ * decoded in the event handler (or sample_await) and the result is
+ * delivered with on_sample_completed(). With a job scheduler (milli-
+ * second time base, e.g. Watchdog::Scheduler) the request pulse is
+ * also non-blocking. Please note that excessive interrupt sources
+ * may affect the capture.
  */
-class DHT : public ExternalInterrupt {
+class DHT : public ExternalInterrupt, public Event::Handler {
 public:
   /** Initial humidity; 100.0 % RH. */
   static const int16_t INIT_HUMIDITY_SAMPLE = 1000;
@@ -40,16 +46,21 @@ public:
   static const int16_t INIT_TEMPERATURE_SAMPLE = 850;
 
   /**
-   * Construct DHT device connected to given pin.
+   * Construct DHT device connected to given pin. The request pulse
+   * is timed with the given job scheduler (milli-seconds) if given
+   * otherwise with a blocking delay.
    * @param[in] pin external interrupt pin (Default EXT0).
+   * @param[in] scheduler for request pulse (Default NULL).
    */
-  DHT(Board::ExternalInterruptPin pin = Board::EXT0) :
+  DHT(Board::ExternalInterruptPin pin = Board::EXT0,
+      Job::Scheduler* scheduler = NULL) :
     ExternalInterrupt(pin, ExternalInterrupt::ON_FALLING_MODE),
+    Event::Handler(),
     m_state(INIT),
     m_start(0),
-    m_value(0),
-    m_bits(0),
     m_ix(0),
+    m_valid(false),
+    m_request(scheduler, this),
     m_humidity(INIT_HUMIDITY_SAMPLE),
     m_temperature(INIT_TEMPERATURE_SAMPLE)
   {}
@@ -73,8 +84,11 @@ public:
   }
 
   /**
-   * Initiate a sample request from the device. Return true(1) and
-   * values if successful otherwise false(0).
+   * Initiate a sample request from the device. Returns immediately
+   * when a job scheduler is used. The result is delivered with
+   * on_sample_completed() from the event handler, or returned by
+   * sample_await(). Return true(1) if successful otherwise false(0)
+   * if a request is already in progress.
    * @return bool.
    */
   bool sample_request();
@@ -86,6 +100,15 @@ public:
    */
   bool sample_await();
 
+  /**
+   * @override{Event::Handler}
+   * Decode the captured frame on sample completed event and call
+   * on_sample_completed().
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+
   /**
    * Read temperature and humidity from the device. Return true(1) and
    * values if successful otherwise false(0).
@@ -114,18 +137,71 @@ public:
   }
 
 protected:
+  /**
+   * Request pulse timer; releases the data line and starts the
+   * capture when the request pulse has expired.
+   */
+  class Request : public Job {
+  public:
+    /**
+     * Construct request pulse timer for given device.
+     * @param[in] scheduler for request pulse.
+     * @param[in] dht device.
+     */
+    Request(Job::Scheduler* scheduler, DHT* dht) :
+      Job(scheduler),
+      m_dht(dht)
+    {}
+
+    /**
+     * @override{Job}
+     * Release data line and start capture. Called from the
+     * scheduler (interrupt service routine).
+     */
+    virtual void on_expired()
+    {
+      m_dht->response();
+    }
+
+    /**
+     * Return true(1) if there is a scheduler otherwise false(0).
+     * @return bool.
+     */
+    bool is_scheduled() const
+    {
+      return (m_scheduler != NULL);
+    }
+
+  protected:
+    DHT* m_dht;			//!< Device.
+  };
+
   /**
    * @override{Interrupt::Handler}
-   * The device driver interrupt level state machine.
+   * The device driver interrupt level state machine. Captures the
+   * pulse widths; decoding is performed by decode().
    * @param[in] arg argument from interrupt service routine.
    */
   virtual void on_interrupt(uint16_t arg = 0);
 
+  /**
+   * Release data line after request pulse and start capture of the
+   * device response.
+   */
+  void response();
+
+  /**
+   * Decode captured pulse widths to data, validate and adjust.
+   * Return true(1) if valid otherwise false(0).
+   * @return bool.
+   */
+  bool decode();
+
   /**
    * @override{DHT}
-   * Callback when data sample is completed. Called from interrupt
-   * service routine. Typically used to push an event for further
-   * processing. Default implementation is an empty function.
+   * Callback when data sample is completed. Called from the event
+   * handler (not when sample_await() is used). Default
+   * implementation is an empty function.
    * @param[in] valid data received and adjusted.
    */
   virtual void on_sample_completed(bool valid)
@@ -158,6 +234,9 @@ protected:
     COMPLETED			//!< Data transfer completed.
   } __attribute__((packed));
 
+  /** Request pulse width (ms); more than 18 ms. */
+  static const uint16_t REQUEST_PULSE = 20;
+
   /** Minimum periodic wait (approx. 2 seconds). */
   static const uint16_t MIN_PERIOD = 2048;
 
@@ -172,6 +251,9 @@ protected:
   /** Last data element index */
   static const uint8_t DATA_LAST = DATA_MAX - 1;
 
+  /** Number of data bits in frame. */
+  static const uint8_t BITS_MAX = DATA_MAX * CHARBITS;
+
   /**
    * Data read from the device. Allow mapping between received byte
    * vector and data fields.
@@ -191,14 +273,17 @@ protected:
   /** Micro-seconds since latest rising of data signal; pulse start. */
   uint16_t m_start;
 
-  /** Current byte being read from device. */
-  uint8_t m_value;
+  /** Number of captured pulses. */
+  volatile uint8_t m_ix;
+
+  /** Captured pulse widths (us). */
+  uint8_t m_width[BITS_MAX];
 
-  /** Current number of bits read. */
-  uint8_t m_bits;
+  /** Validity of latest decoded frame. */
+  bool m_valid;
 
-  /** Current data byte index stream. */
-  uint8_t m_ix;
+  /** Request pulse timer. */
+  Request m_request;
 
   /** Current data being transfered. */
   data_t m_data;
@@ -246,9 +331,11 @@ public:
   /**
    * Construct connection to a DHT11 device on given in/output-pin.
    * @param[in] pin data (Default EXT0).
+   * @param[in] scheduler for request pulse (Default NULL).
    */
-  DHT11(Board::ExternalInterruptPin pin = Board::EXT0) :
-    DHT(pin)
+  DHT11(Board::ExternalInterruptPin pin = Board::EXT0,
+	Job::Scheduler* scheduler = NULL) :
+    DHT(pin, scheduler)
   {
   }
 
@@ -288,9 +375,11 @@ public:
   /**
    * Construct connection to a DHT22 device on given in/output-pin.
    * @param[in] pin data (Default EXT0).
+   * @param[in] scheduler for request pulse (Default NULL).
    */
-  DHT22(Board::ExternalInterruptPin pin = Board::EXT0) :
-    DHT(pin)
+  DHT22(Board::ExternalInterruptPin pin = Board::EXT0,
+	Job::Scheduler* scheduler = NULL) :
+    DHT(pin, scheduler)
   {
   }
 
@@ -21,6 +21,12 @@
 #include "DNS.hh"
 #include "Cosa/INET.hh"
 #include "Cosa/Errno.h"
+#include "Cosa/RTT.hh"
+
+#if (COSA_DNS_CACHE_MAX > 0)
+DNS::entry_t DNS::s_cache[COSA_DNS_CACHE_MAX];
+uint8_t DNS::s_next = 0;
+#endif
 
 bool
 DNS::begin(Socket* sock, uint8_t server[4])
@@ -39,18 +45,95 @@ DNS::end()
   return (true);
 }
 
+uint32_t
+DNS::hash(const char* path, int len)
+{
+  uint32_t res = 2166136261UL;
+  while (len--) {
+    res ^= (uint8_t) *path++;
+    res *= 16777619UL;
+  }
+  return (res);
+}
+
 int
-DNS::gethostbyname(const char* hostname, uint8_t addr[4], bool progmem)
+DNS::lookup(uint32_t hash, uint8_t ip[4])
 {
-  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+#if (COSA_DNS_CACHE_MAX > 0)
+  uint32_t now = RTT::millis();
+  for (uint8_t i = 0; i < COSA_DNS_CACHE_MAX; i++) {
+    entry_t* entry = &s_cache[i];
+    if (entry->hash != hash) continue;
+    if ((int32_t) (entry->expires - now) <= 0) {
+      entry->hash = 0;
+      return (ENOENT);
+    }
+    memcpy(ip, entry->ip, sizeof(entry->ip));
+    return (0);
+  }
+#else
+  UNUSED(hash);
+  UNUSED(ip);
+#endif
+  return (ENOENT);
+}
 
-  // Check if we already have a network address (as a string)
-  if (INET::aton(hostname, addr, progmem) == 0) return (0);
+void
+DNS::insert(uint32_t hash, const uint8_t ip[4], uint32_t ttl)
+{
+#if (COSA_DNS_CACHE_MAX > 0)
+  if (ttl == 0) return;
+  if (ttl > TTL_MAX) ttl = TTL_MAX;
+
+  // Update existing entry or replace next entry (round-robin)
+  entry_t* entry = NULL;
+  for (uint8_t i = 0; i < COSA_DNS_CACHE_MAX; i++) {
+    if (s_cache[i].hash != hash) continue;
+    entry = &s_cache[i];
+    break;
+  }
+  if (entry == NULL) {
+    entry = &s_cache[s_next];
+    s_next = (s_next + 1) % COSA_DNS_CACHE_MAX;
+  }
+  entry->hash = hash;
+  entry->expires = RTT::millis() + (ttl * 1000UL);
+  memcpy(entry->ip, ip, sizeof(entry->ip));
+#else
+  UNUSED(hash);
+  UNUSED(ip);
+  UNUSED(ttl);
+#endif
+}
+
+int
+DNS::lookup(const char* hostname, uint8_t ip[4], bool progmem)
+{
+  char path[INET::PATH_MAX];
+  int len = INET::nametopath(hostname, path, progmem);
+  if (UNLIKELY(len <= 0)) return (EFAULT);
+  return (lookup(hash(path, len), ip));
+}
+
+void
+DNS::flush()
+{
+#if (COSA_DNS_CACHE_MAX > 0)
+  memset(s_cache, 0, sizeof(s_cache));
+  s_next = 0;
+#endif
+}
+
+int
+DNS::request(const char* hostname, bool progmem)
+{
+  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
 
   // Convert hostname to a path
   char path[INET::PATH_MAX];
   int len = INET::nametopath(hostname, path, progmem);
   if (UNLIKELY(len <= 0)) return (EFAULT);
+  m_hash = hash(path, len);
 
   // Construct request header
   header_t request;
@@ -66,64 +149,149 @@ DNS::gethostbyname(const char* hostname, uint8_t addr[4], bool progmem)
   attr.TYPE = hton(TYPE_A);
   attr.CLASS = hton(CLASS_IN);
 
+  // Send request
+  m_sock->datagram(m_server, PORT);
+  m_sock->write(&request, sizeof(request));
+  m_sock->write(path, len);
+  m_sock->write(&attr, sizeof(attr));
+  return (m_sock->flush());
+}
+
+int
+DNS::response(uint8_t addr[4])
+{
+  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+
+  // Check for a reply
+  if (m_sock->available() == 0) return (0);
+
+  // Receive the DNS response
+  uint8_t response[128];
+  uint8_t dest[4];
+  uint16_t port;
+  int res = m_sock->recv(response, sizeof(response), dest, port);
+  if (UNLIKELY(res <= 0)) return (0);
+
+  // The response header
+  header_t* header = (header_t*) response;
+  ntoh((int16_t*) header, (int16_t*) header, sizeof(header_t) / 2);
+  if (header->ID != ID) return (0);
+  if ((header->FC & RESP_MASK) == RESP_NAME_ERROR) return (ENOENT);
+  uint8_t* ptr = &response[sizeof(header_t)];
+
+  // The query; Path and attributes
+  uint8_t n;
+  while ((n = *ptr++) != 0) ptr += n;
+  ptr += sizeof(attr_t);
+
+  // The answer; domain name, attributes and data (address)
+  for (uint16_t i = 0; i < header->ANC; i++) {
+    do {
+      n = *ptr++;
+      if ((n & LABEL_COMPRESSION_MASK) == 0) {
+	if ((n & 0x80) == 0) {
+	  ptr += n;
+	}
+      }
+      else {
+	ptr += 1;
+	n = 0;
+      }
+    } while (n != 0);
+    rec_t* rec = (rec_t*) ptr;
+    ntoh((int16_t*) rec, (int16_t*) rec, sizeof(rec_t) / 2);
+    ptr += sizeof(rec_t);
+    ptr += rec->RDL;
+    if (rec->TYPE != TYPE_A) continue;
+    if (rec->CLASS != CLASS_IN) continue;
+    if (rec->RDL != INET::IP_MAX) continue;
+    memcpy(addr, rec->RD, INET::IP_MAX);
+
+    // Add to cache. Swap words in time-to-live (converted as 16-bit)
+    uint32_t ttl = (rec->TTL << 16) | (rec->TTL >> 16);
+    insert(m_hash, addr, ttl);
+    return (1);
+  }
+  return (0);
+}
+
+int
+DNS::gethostbyname(const char* hostname, uint8_t addr[4], bool progmem)
+{
+  if (UNLIKELY(m_sock == NULL)) return (ENOTSOCK);
+
+  // Check if we already have a network address (as a string)
+  if (INET::aton(hostname, addr, progmem) == 0) return (0);
+
+  // Check the resolver cache
+  if (lookup(hostname, addr, progmem) == 0) return (0);
+
   // Send request and wait for reply
   for (int8_t retry = 0; retry < RETRY_MAX; retry++) {
-    m_sock->datagram(m_server, PORT);
-    m_sock->write(&request, sizeof(request));
-    m_sock->write(path, len);
-    m_sock->write(&attr, sizeof(attr));
-    m_sock->flush();
-
-    // Wait for a reply
-    int res;
+    int res = request(hostname, progmem);
+    if (UNLIKELY(res == EFAULT)) return (res);
     for (uint16_t i = 0; i < TIMEOUT; i += 32) {
-      if ((res = m_sock->available()) != 0) break;
+      if ((res = response(addr)) != 0) break;
       delay(32);
     }
-    if (res == 0) continue;
-
-    // Receive the DNS response
-    uint8_t response[128];
-    uint8_t dest[4];
-    uint16_t port;
-    res = m_sock->recv(response, sizeof(response), dest, port);
-    if (UNLIKELY(res <= 0)) continue;
-
-    // The response header
-    header_t* header = (header_t*) response;
-    ntoh((int16_t*) header, (int16_t*) header, sizeof(header_t) / 2);
-    if (header->ID != ID) continue;
-    uint8_t* ptr = &response[sizeof(header_t)];
-
-    // The query; Path and attributes
-    uint8_t n;
-    while ((n = *ptr++) != 0) ptr += n;
-    ptr += sizeof(attr_t);
-
-    // The answer; domain name, attributes and data (address)
-    for (uint16_t i = 0; i < header->ANC; i++) {
-      do {
-	n = *ptr++;
-	if ((n & LABEL_COMPRESSION_MASK) == 0) {
-	  if ((n & 0x80) == 0) {
-	    ptr += n;
-	  }
-	}
-	else {
-	  ptr += 1;
-	  n = 0;
-	}
-      } while (n != 0);
-      rec_t* rec = (rec_t*) ptr;
-      ntoh((int16_t*) rec, (int16_t*) rec, sizeof(rec_t) / 2);
-      ptr += sizeof(rec_t);
-      ptr += rec->RDL;
-      if (rec->TYPE != TYPE_A) continue;
-      if (rec->CLASS != CLASS_IN) continue;
-      if (rec->RDL != INET::IP_MAX) continue;
-      memcpy(addr, rec->RD, INET::IP_MAX);
-      return (0);
-    }
+    if (res > 0) return (0);
+    if (res < 0) return (res);
   }
   return (EIO);
 }
+
+int
+DNS::Resolver::gethostbyname(const char* hostname, bool progmem)
+{
+  // Stop any lookup in progress
+  if (is_started()) stop();
+  m_hostname = hostname;
+  m_progmem = progmem;
+  m_retry = 0;
+
+  // Check if we already have a network address; string or cache
+  if ((INET::aton(hostname, m_addr, progmem) == 0)
+      || (lookup(hostname, m_addr, progmem) == 0)) {
+    complete(0);
+    return (0);
+  }
+
+  // Send request and start polling for the response
+  int res = m_dns->request(hostname, progmem);
+  if (UNLIKELY(res == EFAULT || res == ENOTSOCK)) return (res);
+  m_result = EINPROGRESS;
+  m_sent = time();
+  expire_at(m_sent + m_period);
+  start();
+  return (0);
+}
+
+void
+DNS::Resolver::run()
+{
+  // Check for response
+  int res = m_dns->response(m_addr);
+  if (res != 0) {
+    complete(res > 0 ? 0 : res);
+    return;
+  }
+
+  // Check for request timeout and retry
+  if (time() - m_sent >= m_timeout) {
+    if (++m_retry == RETRY_MAX) {
+      complete(ETIME);
+      return;
+    }
+    m_dns->request(m_hostname, m_progmem);
+    m_sent = time();
+  }
+  expire_after(m_period);
+  start();
+}
+
+void
+DNS::Resolver::complete(int res)
+{
+  m_result = res;
+  Event::push(Event::RECEIVE_COMPLETED_TYPE, m_target, this);
+}
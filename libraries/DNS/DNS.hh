@@ -23,16 +23,32 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Socket.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Job.hh"
+
+/**
+ * Number of entries in resolver cache. Default is 4 entries. Zero
+ * will disable the cache.
+ */
+#ifndef COSA_DNS_CACHE_MAX
+#define COSA_DNS_CACHE_MAX 4
+#endif
 
 /**
  * Domain Name Server request handler. Allows mapping from symbolic
  * human readable names in dot notation to network addresses.
+ * Resolved network addresses are kept in a cache, shared by all
+ * request handlers, for the time-to-live given by the server
+ * (max TTL_MAX seconds).
  */
 class DNS {
 public:
   /** DNS standard port number. */
   static const uint16_t PORT = 53;
 
+  /** Max time-to-live for cached network address (seconds). */
+  static const uint32_t TTL_MAX = 3600;
+
   /**
    * Construct DNS request handler. Use begin() to initiate the
    * handler and end() to terminate.
@@ -99,6 +115,183 @@ public:
     return (gethostbyname((const char*) hostname, ip, true));
   }
 
+  /**
+   * Send request for the network address of the given hostname. Does
+   * not wait for the response; use response(). Returns zero if
+   * successful otherwise negative error code.
+   * @param[in] hostname to lookup.
+   * @param[in] progmem flag if hostname string in program memory.
+   * @return zero if successful otherwise negative error code.
+   */
+  int request(const char* hostname, bool progmem = false);
+
+  /**
+   * Check for response to the latest request. Returns one(1) if the
+   * network address was received, zero(0) if there is no response
+   * yet, otherwise negative error code. The network address is added
+   * to the cache.
+   * @param[in] ip network address.
+   * @return one if received, zero if no response otherwise negative
+   * error code.
+   */
+  int response(uint8_t ip[4]);
+
+  /**
+   * Lookup the given hostname in the resolver cache. Does not require
+   * a socket. Returns zero if found otherwise negative error code.
+   * @param[in] hostname to lookup.
+   * @param[in] ip network address.
+   * @param[in] progmem flag if hostname string in program memory.
+   * @return zero if successful otherwise negative error code.
+   */
+  static int lookup(const char* hostname, uint8_t ip[4], bool progmem = false);
+
+  /**
+   * Lookup the given hostname in the resolver cache. Returns zero if
+   * found otherwise negative error code.
+   * @param[in] hostname to lookup (in program memory).
+   * @param[in] ip network address.
+   * @return zero if successful otherwise negative error code.
+   */
+  static int lookup_P(str_P hostname, uint8_t ip[4])
+    __attribute__((always_inline))
+  {
+    return (lookup((const char*) hostname, ip, true));
+  }
+
+  /**
+   * Remove all entries in the resolver cache.
+   */
+  static void flush();
+
+  /**
+   * Asynchronous hostname lookup. The request is sent and the socket
+   * polled with the given period in the time unit of the scheduler.
+   * The request is retried after the given timeout. An event
+   * (Event::RECEIVE_COMPLETED_TYPE) is pushed to the target with the
+   * resolver as environment when the lookup is completed. Use
+   * result() and addr() to get the outcome.
+   * @code
+   * DNS dns(ethernet.socket(Socket::UDP), server);
+   * DNS::Resolver resolver(&scheduler, &dns, &handler, 32, 300);
+   * ...
+   * resolver.gethostbyname_P(PSTR("www.google.com"));
+   * @endcode
+   */
+  class Resolver : public Job {
+  public:
+    /**
+     * Construct asynchronous resolver for the given request handler
+     * and event target. Poll period and retry timeout in the time
+     * unit of the scheduler.
+     * @param[in] scheduler for socket poll.
+     * @param[in] dns request handler.
+     * @param[in] target event handler.
+     * @param[in] period of socket poll.
+     * @param[in] timeout before request retry.
+     */
+    Resolver(Job::Scheduler* scheduler, DNS* dns,
+	     Event::Handler* target,
+	     uint16_t period, uint16_t timeout) :
+      Job(scheduler),
+      m_dns(dns),
+      m_target(target),
+      m_period(period),
+      m_timeout(timeout),
+      m_hostname(NULL),
+      m_progmem(false),
+      m_retry(0),
+      m_result(EINVAL)
+    {}
+
+    /**
+     * Start lookup of the network address of the given hostname. The
+     * hostname string must be valid until the lookup is
+     * completed. The completion event is pushed directly if the
+     * address is in the cache. Returns zero if successful otherwise
+     * negative error code.
+     * @param[in] hostname to lookup.
+     * @param[in] progmem flag if hostname string in program memory.
+     * @return zero if successful otherwise negative error code.
+     */
+    int gethostbyname(const char* hostname, bool progmem = false);
+
+    /**
+     * Start lookup of the network address of the given hostname.
+     * Returns zero if successful otherwise negative error code.
+     * @param[in] hostname to lookup (in program memory).
+     * @return zero if successful otherwise negative error code.
+     */
+    int gethostbyname_P(str_P hostname)
+    {
+      return (gethostbyname((const char*) hostname, true));
+    }
+
+    /**
+     * Return result of lookup; zero if successful, EINPROGRESS if
+     * in progress otherwise negative error code.
+     * @return result code.
+     */
+    int result() const
+    {
+      return (m_result);
+    }
+
+    /**
+     * Get network address from latest successful lookup.
+     * @param[in] ip network address.
+     */
+    void addr(uint8_t ip[4]) const
+    {
+      memcpy(ip, m_addr, sizeof(m_addr));
+    }
+
+  protected:
+    /** Request handler. */
+    DNS* m_dns;
+
+    /** Event handler for completion event. */
+    Event::Handler* m_target;
+
+    /** Socket poll period. */
+    uint16_t m_period;
+
+    /** Request retry timeout. */
+    uint16_t m_timeout;
+
+    /** Time of latest request. */
+    uint32_t m_sent;
+
+    /** Hostname to lookup. */
+    const char* m_hostname;
+
+    /** Hostname in program memory flag. */
+    bool m_progmem;
+
+    /** Number of request retries. */
+    uint8_t m_retry;
+
+    /** Result of lookup. */
+    int8_t m_result;
+
+    /** Network address. */
+    uint8_t m_addr[4];
+
+    /**
+     * @override{Job}
+     * Poll the socket for the response. Retry the request on timeout.
+     * Push completion event when the lookup is completed, otherwise
+     * reschedule.
+     */
+    virtual void run();
+
+    /**
+     * Set result of lookup and push completion event.
+     * @param[in] res result code.
+     */
+    void complete(int res);
+  };
+
 private:
   /**
    * Header Flags and Codes (little-endian).
@@ -156,12 +349,56 @@ private:
     uint8_t RD[];		//!< Resource Data.
   };
 
+  /** Resolver cache entry. */
+  struct entry_t {
+    uint32_t hash;		//!< Hash of hostname path.
+    uint32_t expires;		//!< Expire time (RTT::millis()).
+    uint8_t ip[4];		//!< Network address.
+  };
+
   static const uint16_t TIMEOUT = 300;
   static const uint8_t RETRY_MAX = 8;
   static const uint16_t ID = 0xC05AU;
   uint8_t m_server[4];
   Socket* m_sock;
 
+  /** Hash of hostname path of latest request. */
+  uint32_t m_hash;
+
+#if (COSA_DNS_CACHE_MAX > 0)
+  /** Resolver cache; shared by all request handlers. */
+  static entry_t s_cache[COSA_DNS_CACHE_MAX];
+
+  /** Next cache entry to replace. */
+  static uint8_t s_next;
+#endif
+
+  /**
+   * Return hash (FNV-1a) of given hostname path.
+   * @param[in] path hostname path.
+   * @param[in] len length of path.
+   * @return hash.
+   */
+  static uint32_t hash(const char* path, int len);
+
+  /**
+   * Lookup given hash in the resolver cache. Returns zero if found
+   * otherwise negative error code.
+   * @param[in] hash of hostname path.
+   * @param[in] ip network address.
+   * @return zero if successful otherwise negative error code.
+   */
+  static int lookup(uint32_t hash, uint8_t ip[4]);
+
+  /**
+   * Add network address with given hash and time-to-live (seconds) to
+   * the resolver cache.
+   * @param[in] hash of hostname path.
+   * @param[in] ip network address.
+   * @param[in] ttl time-to-live (seconds).
+   */
+  static void insert(uint32_t hash, const uint8_t ip[4], uint32_t ttl);
+
   /**
    * Lookup the given hostname and return the network address. Returns
    * zero if successful otherwise negative error code.
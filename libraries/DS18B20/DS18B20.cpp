@@ -30,6 +30,35 @@ DS18B20::Search::next()
   return (dev);
 }
 
+bool
+DS18B20::Sampler::convert_request()
+{
+  if (UNLIKELY(is_started())) return (false);
+  if (!DS18B20::convert_request(m_owi, 0, m_parasite)) return (false);
+  uint8_t bits = m_resolution;
+  if (bits < 9) bits = 9; else if (bits > 12) bits = 12;
+  expire_at(time() + (MAX_CONVERSION_TIME >> (12 - bits)));
+  return (start());
+}
+
+void
+DS18B20::Sampler::run()
+{
+  if (m_parasite) m_owi->power_off();
+  uint8_t valid = 0;
+  for (uint8_t i = 0; i < m_count; i++) {
+    DS18B20* sensor = m_sensors[i];
+    if (sensor->read_scratchpad()) {
+      m_temperatures[i] = sensor->temperature();
+      valid += 1;
+    }
+    else
+      m_temperatures[i] = INVALID_TEMPERATURE;
+  }
+  m_valid = valid;
+  on_sample_completed(valid);
+}
+
 bool
 DS18B20::connect(uint8_t index)
 {
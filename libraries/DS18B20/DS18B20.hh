@@ -24,6 +24,8 @@
 #include <OWI.h>
 
 #include "Cosa/Types.h"
+#include "Cosa/Event.hh"
+#include "Cosa/Job.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -69,6 +71,110 @@ public:
     DS18B20* next();
   };
 
+  /**
+   * Bus level sampler. Issues a single broadcast conversion (SKIP
+   * ROM) for all thermometers on the bus, schedules a job at the
+   * resolution specific conversion time instead of blocking, and
+   * then reads the scratchpads of the given thermometers back to
+   * back. The temperatures are stored in the given vector and a
+   * single Event::SAMPLE_COMPLETED_TYPE, with the number of valid
+   * readings as value, is pushed to the target (if given). The
+   * scheduler should have a time unit of milli-seconds (e.g.
+   * Watchdog::Scheduler).
+   * @code
+   * DS18B20* sensors[] = { &indoors, &outdoors, ... };
+   * int16_t temps[membersof(sensors)];
+   * DS18B20::Sampler sampler(&scheduler, &owi, sensors, temps,
+   *                          membersof(sensors), &handler);
+   * ...
+   * sampler.convert_request();
+   * @endcode
+   */
+  class Sampler : public Job {
+  public:
+    /** Temperature value for failed reading. */
+    static const int16_t INVALID_TEMPERATURE = INT16_MIN;
+
+    /**
+     * Construct bus sampler for the given thermometers on the given
+     * one-wire bus. The thermometers should be connected (rom
+     * address known) and have the given conversion resolution.
+     * @param[in] scheduler for conversion time (milli-seconds).
+     * @param[in] owi one-wire interface pin.
+     * @param[in] sensors vector of thermometers.
+     * @param[in] temperatures vector for readings.
+     * @param[in] count number of thermometers.
+     * @param[in] target event handler for completed event (default NULL).
+     * @param[in] resolution of conversion (default 12).
+     * @param[in] parasite power mode flag (default false).
+     */
+    Sampler(Job::Scheduler* scheduler,
+	    OWI* owi,
+	    DS18B20** sensors,
+	    int16_t* temperatures,
+	    uint8_t count,
+	    Event::Handler* target = NULL,
+	    uint8_t resolution = 12,
+	    bool parasite = false) :
+      Job(scheduler),
+      m_owi(owi),
+      m_sensors(sensors),
+      m_temperatures(temperatures),
+      m_count(count),
+      m_target(target),
+      m_resolution(resolution),
+      m_parasite(parasite),
+      m_valid(0)
+    {}
+
+    /**
+     * Initiate a broadcast conversion and schedule reading of the
+     * thermometers. Return true(1) if successful otherwise false(0),
+     * i.e. no device presence or conversion already in progress.
+     * @return bool.
+     */
+    bool convert_request();
+
+    /**
+     * Return number of valid readings in latest sample.
+     * @return count.
+     */
+    uint8_t valid() const
+    {
+      return (m_valid);
+    }
+
+    /**
+     * @override{DS18B20::Sampler}
+     * Called when the thermometers have been read. Default
+     * implementation pushes an Event::SAMPLE_COMPLETED_TYPE with the
+     * number of valid readings to the target.
+     * @param[in] valid number of valid readings.
+     */
+    virtual void on_sample_completed(uint8_t valid)
+    {
+      if (m_target != NULL)
+	Event::push(Event::SAMPLE_COMPLETED_TYPE, m_target, valid);
+    }
+
+  protected:
+    OWI* m_owi;			//!< One-wire bus.
+    DS18B20** m_sensors;	//!< Thermometers.
+    int16_t* m_temperatures;	//!< Temperature readings.
+    uint8_t m_count;		//!< Number of thermometers.
+    Event::Handler* m_target;	//!< Completed event target.
+    uint8_t m_resolution;	//!< Conversion resolution.
+    bool m_parasite;		//!< Parasite power mode.
+    uint8_t m_valid;		//!< Number of valid readings.
+
+    /**
+     * @override{Job}
+     * Conversion completed; read the scratchpads of all thermometers
+     * and deliver the readings.
+     */
+    virtual void run();
+  };
+
   /**
    * Construct a DS18B20 device connected to the given 1-Wire bus. Use
    * connect() to lookup, set power supply mode and configuration.
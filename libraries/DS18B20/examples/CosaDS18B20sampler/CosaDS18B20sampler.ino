@@ -0,0 +1,111 @@
+/**
+ * @file CosaDS18B20sampler.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstrate the DS18B20 bus sampler; a single broadcast
+ * conversion for all thermometers on the bus, non-blocking wait for
+ * the conversion and reading of all thermometers back to back.
+ *
+ * @section Circuit
+ * @code
+ *                           DS18B20/1..n
+ *                       +------------+
+ * (GND)---------------1-|GND         |\
+ * (D7)------+---------2-|DQ          | |
+ *           |       +-3-|VDD         |/
+ *          4K7      |   +------------+
+ *           |       |
+ * (VCC)-----+       +---(VCC/GND)
+ *
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <OWI.h>
+#include <DS18B20.h>
+
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// One-wire pin and connected thermometers
+OWI owi(Board::D7);
+DS18B20 indoors(&owi);
+DS18B20 outdoors(&owi);
+DS18B20 basement(&owi);
+
+DS18B20* sensors[] = { &indoors, &outdoors, &basement };
+int16_t temperatures[membersof(sensors)];
+
+// Use the watchdog job scheduler
+Watchdog::Scheduler scheduler;
+
+// Print the temperatures on sample completed
+class Monitor : public Event::Handler {
+public:
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    if (type != Event::SAMPLE_COMPLETED_TYPE) return;
+    trace << Watchdog::millis() << ':' << value << PSTR(" valid:");
+    for (uint8_t i = 0; i < membersof(sensors); i++) {
+      trace << ' ';
+      DS18B20::print(trace, temperatures[i]);
+    }
+    trace << endl;
+  }
+};
+
+Monitor monitor;
+DS18B20::Sampler sampler(&scheduler, &owi,
+			 sensors, temperatures, membersof(sensors),
+			 &monitor);
+
+// Periodic conversion request
+class Request : public Periodic {
+public:
+  Request() : Periodic(&scheduler, 2048) {}
+  virtual void run()
+  {
+    sampler.convert_request();
+  }
+};
+
+Request request;
+
+void setup()
+{
+  // Start trace output stream on the serial port
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaDS18B20sampler: started"));
+
+  // Start the watchdog ticks counter
+  Watchdog::begin();
+
+  // Connect to the devices and start periodic conversion request
+  for (uint8_t i = 0; i < membersof(sensors); i++)
+    ASSERT(sensors[i]->connect(i));
+  request.start();
+}
+
+void loop()
+{
+  // Service events
+  Event::service();
+}
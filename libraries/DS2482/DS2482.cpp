@@ -19,6 +19,7 @@
  */
 
 #include "DS2482.hh"
+#include "Cosa/CRC.hh"
 
 bool
 DS2482::device_reset()
@@ -273,7 +274,7 @@ DS2482::one_wire_triplet(bool direction)
     if (count == sizeof(status) && !status.IWB) break;
   }
   twi.release();
-  if (count != sizeof(status) && status.IWB) return (-1);
+  if (count != sizeof(status) || status.IWB) return (-1);
 
   // Return (DIR, NID, ID)
   return (status >> 5);
@@ -283,3 +284,68 @@ DS2482::one_wire_triplet(bool direction)
   return (-1);
 }
 
+bool
+DS2482::Bus::reset()
+{
+  return (m_bridge->one_wire_reset());
+}
+
+uint8_t
+DS2482::Bus::read(uint8_t bits)
+{
+  if (bits == CHARBITS) {
+    uint8_t res = m_bridge->one_wire_read_byte();
+    m_crc = CRC::crc8_maxim_update(m_crc, res);
+    return (res);
+  }
+  uint8_t res = 0;
+  uint8_t adjust = CHARBITS - bits;
+  while (bits--) {
+    res >>= 1;
+    if (m_bridge->one_wire_read_bit() > 0) res |= 0x80;
+    uint8_t mix = (m_crc ^ (res >> 7));
+    m_crc >>= 1;
+    if (mix & 1) m_crc ^= 0x8C;
+  }
+  return (res >> adjust);
+}
+
+void
+DS2482::Bus::write(uint8_t value, uint8_t bits, bool power)
+{
+  if (power) m_bridge->device_config(true, true, m_overdrive);
+  if (bits == CHARBITS) {
+    m_bridge->one_wire_write_byte(value);
+    m_crc = CRC::crc8_maxim_update(m_crc, value);
+    return;
+  }
+  while (bits--) {
+    m_bridge->one_wire_write_bit(value & 1);
+    uint8_t mix = (m_crc ^ value);
+    value >>= 1;
+    m_crc >>= 1;
+    if (mix & 1) m_crc ^= 0x8C;
+  }
+}
+
+void
+DS2482::Bus::power_off()
+{
+  m_bridge->device_config(true, false, m_overdrive);
+}
+
+uint8_t
+DS2482::Bus::triplet(uint8_t direction)
+{
+  int res = m_bridge->one_wire_triplet(direction);
+  if (res < 0) return (0b011);
+  return (res & 0b111);
+}
+
+bool
+DS2482::Bus::speed(bool overdrive)
+{
+  if (!m_bridge->device_config(true, false, overdrive)) return (false);
+  m_overdrive = overdrive;
+  return (true);
+}
@@ -22,6 +22,7 @@
 #define COSA_DS2482_HH
 
 #include "Cosa/TWI.hh"
+#include <OWI.h>
 
 /**
  * TWI Device Driver for DS2482 I2C to 1-Wire Bridge. Low level device
@@ -39,6 +40,23 @@ public:
    */
   DS2482(uint8_t subaddr = 0) : TWI::Driver(0x18 | (subaddr & 0x03)) {}
 
+  /**
+   * One-wire bus over the bridge. Allows the OWI device drivers
+   * (e.g. DS18B20) to be used with the bridge. The bus time slots
+   * are generated by the bridge; there are no interrupt disabled
+   * periods and the rom search uses the triplet command.
+   * @code
+   * DS2482 bridge;
+   * DS2482::Bus owi(&bridge);
+   * DS18B20 sensor(&owi);
+   * ...
+   * bridge.device_reset();
+   * bridge.device_config();
+   * sensor.connect(0);
+   * @endcode
+   */
+  class Bus;
+
   /**
    * Global reset of device state machine logic. Returns true if
    * successful otherwise false.
@@ -191,4 +209,67 @@ protected:
   static const int POLL_MAX = 20;
 };
 
+class DS2482::Bus : public OWI {
+public:
+  /**
+   * Construct one-wire bus over the given bridge.
+   * @param[in] bridge device driver.
+   */
+  Bus(DS2482* bridge) : OWI(), m_bridge(bridge) {}
+
+  /**
+   * @override{OWI}
+   * Reset the one wire bus and check that at least one device is
+   * presence.
+   * @return true(1) if successful otherwise false(0).
+   */
+  virtual bool reset();
+
+  /**
+   * @override{OWI}
+   * Read the given number of bits from the one wire bus (slave).
+   * Full bytes are read with a single bridge command.
+   * @param[in] bits to be read.
+   * @return value read.
+   */
+  virtual uint8_t read(uint8_t bits = CHARBITS);
+
+  /**
+   * @override{OWI}
+   * Write the given value to the one wire bus. Full bytes are
+   * written with a single bridge command. Strong pullup is used
+   * for the power parameter.
+   * @param[in] value to write.
+   * @param[in] bits to be written.
+   * @param[in] power on for parasite device.
+   */
+  virtual void write(uint8_t value, uint8_t bits = CHARBITS, bool power = false);
+
+  /**
+   * @override{OWI}
+   * Turn off strong pullup.
+   */
+  virtual void power_off();
+
+  /**
+   * @override{OWI}
+   * Search triplet with the bridge triplet command.
+   * @param[in] direction on discrepancy.
+   * @return triplet status.
+   */
+  virtual uint8_t triplet(uint8_t direction);
+
+protected:
+  /** Bridge device driver. */
+  DS2482* m_bridge;
+
+  /**
+   * @override{OWI}
+   * Set bridge one-wire speed.
+   * @param[in] overdrive speed.
+   * @return bool.
+   */
+  virtual bool speed(bool overdrive);
+};
+
 #endif
@@ -91,6 +91,67 @@ DS3231::square_wave(bool flag)
   return (res == sizeof(control));
 }
 
+bool
+DS3231::get_clock(clock_t& now)
+{
+  time_t clock;
+  if (UNLIKELY(!get_time(clock))) return (false);
+  clock.to_binary();
+  now = clock;
+  return (true);
+}
+
+bool
+DS3231::set_wakeup(clock_t when)
+{
+  // Set alarm 1 to date and time match
+  time_t clock(when);
+  alarm1_t alarm;
+  alarm.seconds = clock.seconds;
+  alarm.minutes = clock.minutes;
+  alarm.hours = clock.hours;
+  alarm.date = clock.date;
+  alarm.to_bcd();
+  if (UNLIKELY(!set_alarm1(alarm, alarm1_t::WHEN_DATE_TIME_MATCH)))
+    return (false);
+
+  // Enable alarm 1 interrupt output
+  control_t control;
+  int res;
+  res = read(&control, sizeof(control), offsetof(timekeeper_t, control));
+  if (UNLIKELY(res != sizeof(control))) return (false);
+  control.a1ie = 1;
+  control.intcn = 1;
+  res = write(&control, sizeof(control), offsetof(timekeeper_t, control));
+  if (UNLIKELY(res != sizeof(control))) return (false);
+
+  // Clear pending alarm; releases the interrupt output
+  status_t status;
+  res = read(&status, sizeof(status), offsetof(timekeeper_t, status));
+  if (UNLIKELY(res != sizeof(status))) return (false);
+  status.a1f = 0;
+  res = write(&status, sizeof(status), offsetof(timekeeper_t, status));
+  return (res == sizeof(status));
+}
+
+bool
+DS3231::clear_wakeup()
+{
+  control_t control;
+  int res;
+  res = read(&control, sizeof(control), offsetof(timekeeper_t, control));
+  if (UNLIKELY(res != sizeof(control))) return (false);
+  control.a1ie = 0;
+  res = write(&control, sizeof(control), offsetof(timekeeper_t, control));
+  if (UNLIKELY(res != sizeof(control))) return (false);
+  status_t status;
+  res = read(&status, sizeof(status), offsetof(timekeeper_t, status));
+  if (UNLIKELY(res != sizeof(status))) return (false);
+  status.a1f = 0;
+  res = write(&status, sizeof(status), offsetof(timekeeper_t, status));
+  return (res == sizeof(status));
+}
+
 IOStream& operator<<(IOStream& outs, DS3231::alarm1_t& t)
 {
   outs << bcd << t.date << ' '
@@ -23,6 +23,7 @@
 
 #include "Cosa/TWI.hh"
 #include "Cosa/Time.hh"
+#include "Cosa/Alarm.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -46,8 +47,12 @@
  * @section References
  * 1. Maxim Integrated product description;
  * http://datasheets.maximintegrated.com/en/ds/DS3231.pdf
+ *
+ * @section Limitations
+ * The wakeup device (Alarm::Device) uses alarm 1 and the INT/SQW
+ * output (active low); square wave output is disabled.
  */
-class DS3231 : private TWI::Driver {
+class DS3231 : private TWI::Driver, public Alarm::Device {
 public:
   /**
    * Alarm1 register sub-set type and mask bits (Table 2, pp. 12).
@@ -298,6 +303,33 @@ public:
    */
   bool square_wave(bool flag);
 
+  /**
+   * @override{Alarm::Device}
+   * Read current time in seconds from the real-time clock. Return
+   * true(1) if successful otherwise false(0).
+   * @param[out] now seconds.
+   * @return bool.
+   */
+  virtual bool get_clock(clock_t& now);
+
+  /**
+   * @override{Alarm::Device}
+   * Program alarm 1 (date and time match) to given time in seconds and clear
+   * any pending alarm. Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] when seconds.
+   * @return bool.
+   */
+  virtual bool set_wakeup(clock_t when);
+
+  /**
+   * @override{Alarm::Device}
+   * Disable alarm 1 interrupt and clear any pending alarm.
+   * Return true(1) if successful otherwise false(0).
+   * @return bool.
+   */
+  virtual bool clear_wakeup();
+
 private:
   /**
    * Read alarm setting, time and mask, from real-time clock. Return
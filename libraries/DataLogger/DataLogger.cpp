@@ -0,0 +1,125 @@
+/**
+ * @file DataLogger.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "DataLogger.hh"
+
+bool
+DataLogger::begin(str_P schema)
+{
+  if (UNLIKELY(m_logging || m_blocks < 2 || m_records == 0)) return (false);
+
+  // Build the header block in the first ring-buffer block
+  header_t* header = (header_t*) block(0);
+  memset(header, 0, BLOCK_MAX);
+  header->magic = MAGIC;
+  header->block_size = BLOCK_MAX;
+  header->record_size = m_size;
+  header->records = m_records;
+  strncpy_P(header->schema, (const char*) schema, sizeof(header->schema) - 1);
+  if (m_dev->write(header, BLOCK_MAX) != BLOCK_MAX) return (false);
+
+  // Reset the ring-buffer and start logging
+  m_put = 0;
+  m_get = 0;
+  m_pending = 0;
+  m_count = 0;
+  m_dropped = 0;
+  m_total = 0;
+  m_seq = 0;
+  m_logging = true;
+  return (true);
+}
+
+bool
+DataLogger::end()
+{
+  // Stop logging and write the full blocks
+  m_logging = false;
+  if (write() < 0) return (false);
+
+  // Write the last partial block
+  if (m_count > 0) {
+    uint8_t* bp = block(m_put);
+    block_t* header = (block_t*) bp;
+    uint16_t pos = sizeof(block_t) + m_count * m_size;
+    header->count = m_count;
+    memset(bp + pos, 0, BLOCK_MAX - pos);
+    m_count = 0;
+    if (m_dev->write(bp, BLOCK_MAX) != BLOCK_MAX) return (false);
+  }
+  return (true);
+}
+
+bool
+DataLogger::log(const void* rec)
+{
+  synchronized {
+    // Check that there is a free block
+    if (UNLIKELY(!m_logging || m_pending == m_blocks)) {
+      if (m_logging) {
+	m_dropped += 1;
+	m_total += 1;
+      }
+      return (false);
+    }
+
+    // Start a new block with the sequence number and dropped count
+    uint8_t* bp = block(m_put);
+    block_t* header = (block_t*) bp;
+    if (m_count == 0) {
+      header->seq = m_seq++;
+      header->dropped = m_dropped;
+      m_dropped = 0;
+    }
+
+    // Append the record; signal the writer when the block is full
+    memcpy(bp + sizeof(block_t) + m_count * m_size, rec, m_size);
+    if (++m_count < m_records) return (true);
+    uint16_t pos = sizeof(block_t) + m_count * m_size;
+    header->count = m_count;
+    memset(bp + pos, 0, BLOCK_MAX - pos);
+    m_count = 0;
+    m_put = (m_put + 1 == m_blocks) ? 0 : m_put + 1;
+    m_pending += 1;
+    Event::push(Event::WRITE_REQUEST_TYPE, this);
+  }
+  return (true);
+}
+
+int
+DataLogger::write()
+{
+  // Write full blocks; free each block after the write
+  int res = 0;
+  while (m_pending != 0) {
+    if (m_dev->write(block(m_get), BLOCK_MAX) != BLOCK_MAX) return (EOF);
+    m_get = (m_get + 1 == m_blocks) ? 0 : m_get + 1;
+    synchronized m_pending -= 1;
+    res += 1;
+  }
+  return (res);
+}
+
+void
+DataLogger::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (type == Event::WRITE_REQUEST_TYPE) write();
+}
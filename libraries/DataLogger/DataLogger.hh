@@ -0,0 +1,202 @@
+/**
+ * @file DataLogger.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_DATA_LOGGER_HH
+#define COSA_DATA_LOGGER_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Event.hh"
+#include "Cosa/IOStream.hh"
+
+/**
+ * Binary data logger with block ring-buffer and background writer.
+ * Fixed size records are captured into 512 byte blocks in a ring of
+ * blocks in data memory. The records may be logged from interrupt
+ * service routines or event handlers. Full blocks are written as a
+ * whole to the output device (e.g. FAT16::File or CFFS::File) by the
+ * event handler (write request event) or by calling write(). Logging
+ * continues into free blocks while the device is busy. Records are
+ * dropped, and counted, only when all blocks are full.
+ *
+ * @section Format
+ * The first block of the log is a header with magic, record size,
+ * records per block and a record schema string. Each following
+ * block has a block header with sequence number, number of records
+ * and number of records dropped before the block. The block
+ * remainder is zero filled. All blocks are BLOCK_MAX bytes.
+ *
+ * @section Performance
+ * Preallocate the file (FAT16::File::reserve()) before begin() so
+ * that block writes do not allocate clusters. The ring should have
+ * at least two blocks; one for logging while the other is written.
+ */
+class DataLogger : public Event::Handler {
+public:
+  /** Block size; device sector size. */
+  static const uint16_t BLOCK_MAX = 512;
+
+  /** Log header magic; "CLOG". */
+  static const uint32_t MAGIC = 0x474f4c43UL;
+
+  /**
+   * Log header block.
+   */
+  struct header_t {
+    uint32_t magic;		//!< Magic (MAGIC).
+    uint16_t block_size;	//!< Block size (BLOCK_MAX).
+    uint8_t record_size;	//!< Record size in bytes.
+    uint8_t records;		//!< Records per block.
+    char schema[BLOCK_MAX - 8];	//!< Record schema; null terminated.
+  };
+
+  /**
+   * Data block header.
+   */
+  struct block_t {
+    uint32_t seq;		//!< Block sequence number.
+    uint16_t count;		//!< Number of records in block.
+    uint16_t dropped;		//!< Records dropped before block.
+  };
+
+  /**
+   * Construct data logger with given ring-buffer and number of
+   * blocks, record size and output device.
+   * @param[in] buf ring-buffer (blocks * BLOCK_MAX bytes).
+   * @param[in] blocks number of blocks in ring-buffer (min 2).
+   * @param[in] size record size in bytes.
+   * @param[in] dev output device.
+   */
+  DataLogger(void* buf, uint8_t blocks, uint8_t size,
+	     IOStream::Device* dev) :
+    Event::Handler(),
+    m_buf((uint8_t*) buf),
+    m_blocks(blocks),
+    m_size(size),
+    m_records((BLOCK_MAX - sizeof(block_t)) / size),
+    m_dev(dev),
+    m_put(0),
+    m_get(0),
+    m_pending(0),
+    m_count(0),
+    m_dropped(0),
+    m_total(0),
+    m_seq(0),
+    m_logging(false)
+  {}
+
+  /**
+   * Write log header with given record schema in program memory and
+   * start logging. The schema describes the record fields, e.g.
+   * "u32:time,u16:a0,u16:a1". Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] schema record schema (program memory).
+   * @return bool.
+   */
+  bool begin(str_P schema);
+
+  /**
+   * Stop logging and write all blocks, including the last partial
+   * block, to the device. The device (file) should be closed or
+   * synchronized after end(). Return true(1) if successful otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool end();
+
+  /**
+   * Log given record. May be called from interrupt service routines.
+   * Return true(1) if successful otherwise false(0) if the record was
+   * dropped; ring-buffer full or not logging.
+   * @param[in] rec record to log (record size).
+   * @return bool.
+   */
+  bool log(const void* rec);
+
+  /**
+   * Write full blocks to the device. Return number of blocks written
+   * or EOF(-1) on write error.
+   * @return number of blocks or EOF(-1).
+   */
+  int write();
+
+  /**
+   * Return number of full blocks waiting to be written.
+   * @return blocks.
+   */
+  uint8_t pending() const
+  {
+    return (m_pending);
+  }
+
+  /**
+   * Return total number of dropped records.
+   * @return records.
+   */
+  uint32_t dropped() const
+  {
+    uint32_t res;
+    synchronized res = m_total;
+    return (res);
+  }
+
+  /**
+   * Return number of records per block.
+   * @return records.
+   */
+  uint8_t records() const
+  {
+    return (m_records);
+  }
+
+protected:
+  uint8_t* m_buf;		//!< Ring-buffer of blocks.
+  uint8_t m_blocks;		//!< Number of blocks.
+  uint8_t m_size;		//!< Record size.
+  uint8_t m_records;		//!< Records per block.
+  IOStream::Device* m_dev;	//!< Output device.
+  volatile uint8_t m_put;	//!< Block being filled.
+  uint8_t m_get;		//!< Next block to write.
+  volatile uint8_t m_pending;	//!< Number of full blocks.
+  volatile uint8_t m_count;	//!< Records in block being filled.
+  volatile uint16_t m_dropped;	//!< Dropped since last block.
+  volatile uint32_t m_total;	//!< Total dropped records.
+  uint32_t m_seq;		//!< Next block sequence number.
+  volatile bool m_logging;	//!< Logging state.
+
+  /**
+   * Return pointer to given block in ring-buffer.
+   * @param[in] ix block index.
+   * @return block pointer.
+   */
+  uint8_t* block(uint8_t ix) const
+  {
+    return (m_buf + ix * BLOCK_MAX);
+  }
+
+  /**
+   * @override{Event::Handler}
+   * Write full blocks on write request event.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+};
+
+#endif
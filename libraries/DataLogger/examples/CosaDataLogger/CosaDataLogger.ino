@@ -0,0 +1,115 @@
+/**
+ * @file CosaDataLogger.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * High rate binary data logging to FAT16/SD. Analog samples are
+ * logged with a timestamp at 1 KHz from a periodic job (RTT
+ * interrupt context) into a block ring-buffer. Full blocks are
+ * written to a preallocated file by the event handler.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <SD.h>
+#include <FAT16.h>
+#include <DataLogger.h>
+
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/Periodic.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Number of samples and sample period (us)
+const uint32_t SAMPLES = 10000;
+const uint16_t PERIOD = 1000;
+
+// Log record; timestamp and analog sample
+struct record_t {
+  uint32_t timestamp;
+  uint16_t sample;
+};
+
+// Record schema
+static const char schema[] __PROGMEM = "u32:time,u16:a0";
+
+// Block ring-buffer; one block logging while the other is written
+static uint8_t buf[2 * DataLogger::BLOCK_MAX];
+
+SD sd;
+FAT16::File file;
+DataLogger logger(buf, 2, sizeof(record_t), &file);
+RTT::Scheduler scheduler;
+
+class Sampler : public Periodic {
+public:
+  Sampler(Job::Scheduler* scheduler) :
+    Periodic(scheduler, PERIOD),
+    m_count(0)
+  {}
+
+  // Sample and log in the scheduler interrupt handler
+  virtual void on_expired()
+  {
+    record_t rec;
+    rec.timestamp = expire_at();
+    rec.sample = AnalogPin::sample(Board::A0);
+    logger.log(&rec);
+    if (++m_count < SAMPLES) reschedule();
+    else Event::push(Event::END_TYPE, this);
+  }
+
+  virtual void on_event(uint8_t type, uint16_t value)
+  {
+    UNUSED(value);
+    if (type != Event::END_TYPE) return;
+    ASSERT(logger.end());
+    file.close();
+    TRACE(logger.dropped());
+  }
+
+private:
+  uint32_t m_count;
+};
+
+Sampler sampler(&scheduler);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaDataLogger: started"));
+  RTT::begin();
+  ASSERT(sd.begin(SPI::DIV2_CLOCK));
+  ASSERT(FAT16::begin(&sd));
+
+  // Create and preallocate the log file
+  ASSERT(file.open("LOG.BIN", O_WRITE | O_CREAT | O_TRUNC));
+  uint32_t blocks = SAMPLES / logger.records() + 2;
+  ASSERT(file.reserve(blocks * DataLogger::BLOCK_MAX));
+
+  // Write header and start sampling
+  ASSERT(logger.begin((str_P) schema));
+  sampler.expire_at(sampler.time());
+  sampler.expire_after(PERIOD);
+  sampler.start();
+}
+
+void loop()
+{
+  Event::service();
+}
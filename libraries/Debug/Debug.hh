@@ -131,6 +131,12 @@ public:
    */
   bool end();
 
+  /**
+   * Non-stopping remote inspection agent with binary protocol. See
+   * DebugAgent.hh.
+   */
+  class Agent;
+
   /**
    * Debug Variable information class. Contains function, variable
    * name, reference and size. Used by macro REGISTER(var) to allow
@@ -168,6 +174,7 @@ public:
 
   protected:
     friend class Debug;
+    friend class Agent;
     class Variable* m_next;	//!< Next variable.
     const char* m_func;		//!< Registered in function.
     str_P m_name;		//!< Function name.
@@ -264,6 +271,7 @@ protected:
 #endif
 
   friend class Variable;
+  friend class Agent;
   Variable* m_var;		//!< Last registered variable.
   char EXITCHARACTER;		//!< Character to emit on exit.
   int DATAEND;			//!< End of data segment.
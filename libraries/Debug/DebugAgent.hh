@@ -0,0 +1,153 @@
+/**
+ * @file DebugAgent.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_DEBUG_AGENT_HH
+#define COSA_DEBUG_AGENT_HH
+
+#include "Debug.hh"
+#include "Cosa/Periodic.hh"
+#include <Ciao.h>
+
+/**
+ * Number of watchpoints in the remote inspection agent. Default is 4.
+ */
+#ifndef COSA_DEBUG_AGENT_WATCH_MAX
+#define COSA_DEBUG_AGENT_WATCH_MAX 4
+#endif
+
+/**
+ * Debug remote inspection agent. Serves memory reads, the registered
+ * variables (REGISTER) and watchpoint sampling with a compact binary
+ * protocol without stopping the program. The agent is a periodic job;
+ * each period pending request bytes are read from the device, and
+ * watchpoints are sampled and written only when changed. There is no
+ * formatting on the target; replies are Ciao data values (see
+ * CIAO.txt) for the host to decode.
+ *
+ * @section Protocol
+ * Requests (little-endian):
+ * @code
+ * READ_MEMORY   'R' addr:uint16 size:uint8
+ * VARIABLES     'V'
+ * WATCH         'W' addr:uint16 size:uint8
+ * UNWATCH       'U' ix:uint8
+ * MEMORY_USAGE  'M'
+ * @endcode
+ * Replies start with the request op (uint8), followed by:
+ * @code
+ * READ_MEMORY   addr:uint16 data:uint8[size]
+ * VARIABLES     for each; ref:uint16 size:uint16 name:str
+ * WATCH         ix:uint8 (or 0xff if no free watchpoint)
+ * UNWATCH       ix:uint8
+ * MEMORY_USAGE  data:uint16 heap:uint16 free:uint16
+ * SAMPLE('S')   ix:uint8 addr:uint16 data:uint8[size]
+ * @endcode
+ * @code
+ * Debug::Agent agent(&uart, Watchdog::scheduler(), 128);
+ * ...
+ * agent.start();
+ * ...
+ * Event::service();
+ * @endcode
+ */
+class Debug::Agent : public Periodic {
+public:
+  /** Request operations. */
+  enum {
+    READ_MEMORY = 'R',
+    VARIABLES = 'V',
+    WATCH = 'W',
+    UNWATCH = 'U',
+    MEMORY_USAGE = 'M',
+    SAMPLE = 'S'
+  } __attribute__((packed));
+
+  /** Number of watchpoints. */
+  static const uint8_t WATCH_MAX = COSA_DEBUG_AGENT_WATCH_MAX;
+
+  /** Max number of bytes per read or watchpoint. */
+  static const uint8_t DATA_MAX = 32;
+
+  /**
+   * Construct remote inspection agent for given device, scheduler
+   * and period (scheduler time base).
+   * @param[in] dev iostream device (request and reply).
+   * @param[in] scheduler for the periodic job.
+   * @param[in] period of request polling and watchpoint sampling.
+   */
+  Agent(IOStream::Device* dev, Job::Scheduler* scheduler, uint32_t period) :
+    Periodic(scheduler, period),
+    m_dev(dev),
+    m_ciao(dev),
+    m_len(0)
+  {
+    memset(m_watch, 0, sizeof(m_watch));
+  }
+
+  /**
+   * @override{Job}
+   * Handle pending requests and sample watchpoints.
+   */
+  virtual void run();
+
+protected:
+  /** Watchpoint; address, size and checksum of latest sample. */
+  struct watch_t {
+    uint16_t addr;		//!< Data address.
+    uint8_t size;		//!< Number of bytes (zero if free).
+    uint8_t sum;		//!< Checksum of latest sample.
+  };
+
+  /** Request and reply device. */
+  IOStream::Device* m_dev;
+
+  /** Reply data stream. */
+  Ciao m_ciao;
+
+  /** Request buffer and length. */
+  uint8_t m_req[4];
+  uint8_t m_len;
+
+  /** Watchpoints. */
+  watch_t m_watch[WATCH_MAX];
+
+  /**
+   * Return request length for the given operation, zero if unknown.
+   * @param[in] op request operation.
+   * @return length.
+   */
+  static uint8_t length(uint8_t op);
+
+  /**
+   * Handle request in buffer.
+   */
+  void handle();
+
+  /**
+   * Copy given number of bytes from given address in data memory
+   * into given buffer with interrupts disabled and return checksum.
+   * @param[in] buf buffer.
+   * @param[in] addr data address.
+   * @param[in] size number of bytes.
+   * @return checksum.
+   */
+  static uint8_t copy(uint8_t* buf, uint16_t addr, uint8_t size);
+};
+#endif
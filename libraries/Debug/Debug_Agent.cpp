@@ -0,0 +1,142 @@
+/**
+ * @file Debug_Agent.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "DebugAgent.hh"
+#include "Cosa/Memory.h"
+
+extern int __heap_start, *__brkval;
+
+uint8_t
+Debug::Agent::length(uint8_t op)
+{
+  switch (op) {
+  case READ_MEMORY:
+  case WATCH:
+    return (4);
+  case UNWATCH:
+    return (2);
+  case VARIABLES:
+  case MEMORY_USAGE:
+    return (1);
+  }
+  return (0);
+}
+
+uint8_t
+Debug::Agent::copy(uint8_t* buf, uint16_t addr, uint8_t size)
+{
+  const uint8_t* src = (const uint8_t*) addr;
+  uint8_t sum = 0;
+  synchronized {
+    for (uint8_t i = 0; i < size; i++) {
+      uint8_t data = src[i];
+      buf[i] = data;
+      sum = ((sum << 1) | (sum >> 7)) + data;
+    }
+  }
+  return (sum);
+}
+
+void
+Debug::Agent::handle()
+{
+  uint8_t op = m_req[0];
+  uint16_t addr = m_req[1] | (m_req[2] << 8);
+  uint8_t size = m_req[3];
+  if (size > DATA_MAX) size = DATA_MAX;
+  m_ciao.write(op);
+
+  switch (op) {
+  case READ_MEMORY:
+    {
+      uint8_t buf[DATA_MAX];
+      copy(buf, addr, size);
+      m_ciao.write(addr);
+      m_ciao.write(buf, size);
+    }
+    break;
+  case VARIABLES:
+    for (Variable* var = debug.m_var; var != NULL; var = var->m_next) {
+      m_ciao.write((uint16_t) var->m_ref);
+      m_ciao.write((uint16_t) var->m_size);
+      m_ciao.write(var->m_name);
+    }
+    break;
+  case WATCH:
+    {
+      uint8_t ix = 0;
+      for (; ix < WATCH_MAX; ix++) if (m_watch[ix].size == 0) break;
+      if (ix < WATCH_MAX && size != 0) {
+	uint8_t buf[DATA_MAX];
+	m_watch[ix].addr = addr;
+	m_watch[ix].size = size;
+	m_watch[ix].sum = ~copy(buf, addr, size);
+      }
+      else ix = 0xff;
+      m_ciao.write(ix);
+    }
+    break;
+  case UNWATCH:
+    {
+      uint8_t ix = m_req[1];
+      if (ix < WATCH_MAX) m_watch[ix].size = 0;
+      m_ciao.write(ix);
+    }
+    break;
+  case MEMORY_USAGE:
+    {
+      uint16_t data = (uint16_t) &__heap_start - RAMSTART;
+      uint16_t heap = (__brkval == 0) ? 0 : (uint16_t) __brkval - (uint16_t) &__heap_start;
+      m_ciao.write(data);
+      m_ciao.write(heap);
+      m_ciao.write((uint16_t) free_memory());
+    }
+    break;
+  }
+}
+
+void
+Debug::Agent::run()
+{
+  // Read pending request bytes; unknown operations are dropped
+  while (m_dev->available() > 0) {
+    int c = m_dev->getchar();
+    if (c < 0) break;
+    if (m_len == 0 && length(c) == 0) continue;
+    m_req[m_len++] = c;
+    if (m_len < length(m_req[0])) continue;
+    handle();
+    m_len = 0;
+  }
+
+  // Sample watchpoints and write when changed
+  for (uint8_t ix = 0; ix < WATCH_MAX; ix++) {
+    watch_t* watch = &m_watch[ix];
+    if (watch->size == 0) continue;
+    uint8_t buf[DATA_MAX];
+    uint8_t sum = copy(buf, watch->addr, watch->size);
+    if (sum == watch->sum) continue;
+    watch->sum = sum;
+    m_ciao.write((uint8_t) SAMPLE);
+    m_ciao.write(ix);
+    m_ciao.write(watch->addr);
+    m_ciao.write(buf, watch->size);
+  }
+}
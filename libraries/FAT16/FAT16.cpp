@@ -58,12 +58,44 @@ uint32_t FAT16::fatStartBlock;
 uint32_t FAT16::rootDirStartBlock;
 uint32_t FAT16::dataStartBlock;
 
-uint32_t FAT16::cacheBlockNumber = 0XFFFFFFFF;
-FAT16::cache16_t FAT16::cacheBuffer;
-uint8_t FAT16::cacheDirty = 0;
-uint32_t FAT16::cacheMirrorBlock = 0;
+FAT16::cache16_t FAT16::cacheBlock[CACHE_MAX] __XMEM;
+FAT16::cache_entry_t FAT16::cacheEntry[CACHE_MAX];
+FAT16::cache16_t* FAT16::cacheBuffer = FAT16::cacheBlock;
+uint8_t FAT16::cacheCurrent = 0;
 void (*FAT16::dateTime)(uint16_t* date, uint16_t* time) = NULL;
 
+#if (COSA_FAT16_INDEX_MAX > 0)
+uint8_t FAT16::dirIndex[COSA_FAT16_INDEX_MAX];
+bool FAT16::dirIndexed = false;
+
+uint8_t
+FAT16::dirHash(const uint8_t* name)
+{
+  uint8_t hash = 0;
+  for (uint8_t i = 0; i < 11; i++)
+    hash = ((hash << 1) | (hash >> 7)) ^ name[i];
+  return (hash > INDEX_DELETED ? hash : hash + 2);
+}
+
+bool
+FAT16::dirIndexBuild()
+{
+  if (rootDirEntryCount > COSA_FAT16_INDEX_MAX) return (false);
+  memset(dirIndex, INDEX_FREE, sizeof(dirIndex));
+  for (uint16_t index = 0; index < rootDirEntryCount; index++) {
+    dir_t* p = cacheDirEntry(index);
+    if (!p) return (false);
+    // Done if no entries follow
+    if (p->name[0] == DIR_NAME_FREE) break;
+    if (p->name[0] == DIR_NAME_DELETED)
+      dirIndex[index] = INDEX_DELETED;
+    else
+      dirIndex[index] = dirHash(p->name);
+  }
+  return (true);
+}
+#endif
+
 bool
 FAT16::begin(SD* sd, uint8_t part)
 {
@@ -72,19 +104,22 @@ FAT16::begin(SD* sd, uint8_t part)
   device = sd;
   uint32_t volumeStartBlock = 0;
 
+  // Invalidate all blocks in the cache
+  cacheInvalidate(0, 0);
+
   // If part == 0 assume super floppy with FAT16 boot sector in block zero
   // If part > 0 assume mbr volume with partition table
   if (part) {
     if (!cacheRawBlock(volumeStartBlock)) return (false);
-    volumeStartBlock = cacheBuffer.mbr.part[part - 1].firstSector;
+    volumeStartBlock = cacheBuffer->mbr.part[part - 1].firstSector;
   }
   if (!cacheRawBlock(volumeStartBlock)) return (false);
 
   // Check boot block signature
-  if (cacheBuffer.data[510] != BOOTSIG0 ||
-      cacheBuffer.data[511] != BOOTSIG1) return (false);
+  if (cacheBuffer->data[510] != BOOTSIG0 ||
+      cacheBuffer->data[511] != BOOTSIG1) return (false);
 
-  bpb_t* bpb = &cacheBuffer.fbs.bpb;
+  bpb_t* bpb = &cacheBuffer->fbs.bpb;
   fatCount = bpb->fatCount;
   blocksPerCluster = bpb->sectorsPerCluster;
   blocksPerFat = bpb->sectorsPerFat16;
@@ -108,6 +143,9 @@ FAT16::begin(SD* sd, uint8_t part)
     return (false);
   }
   volumeInitialized = true;
+#if (COSA_FAT16_INDEX_MAX > 0)
+  dirIndexed = dirIndexBuild();
+#endif
   return (true);
 }
 
@@ -151,6 +189,26 @@ FAT16::File::open(const char* fileName, uint8_t oflag)
   // Check valid 8.3 file name
   if (!make83Name(fileName, dname)) return (false);
 
+#if (COSA_FAT16_INDEX_MAX > 0)
+  // Lookup name in index; only directory entries with matching hash are read
+  uint8_t hash = dirHash(dname);
+  if (dirIndexed) {
+    for (uint16_t index = 0; index < rootDirEntryCount; index++) {
+      uint8_t h = dirIndex[index];
+      if (h == INDEX_FREE || h == INDEX_DELETED) {
+	if (empty < 0) empty = index;
+	if (h == INDEX_FREE) break;
+	continue;
+      }
+      if (h != hash) continue;
+      if (!(p = cacheDirEntry(index))) return (false);
+      if (memcmp(dname, p->name, 11)) continue;
+      if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL)) return (false);
+      return (open(index, oflag));
+    }
+  }
+  else
+#endif
   for (uint16_t index = 0; index < rootDirEntryCount; index++) {
     if (!(p = cacheDirEntry(index))) return (false);
     if (p->name[0] == DIR_NAME_FREE || p->name[0] == DIR_NAME_DELETED) {
@@ -191,6 +249,9 @@ FAT16::File::open(const char* fileName, uint8_t oflag)
 
   // Force created directory entry will be written to storage device
   if (!cacheFlush()) return (false);
+#if (COSA_FAT16_INDEX_MAX > 0)
+  if (dirIndexed) dirIndex[empty] = hash;
+#endif
 
   // Open entry
   return (open(empty, oflag));
@@ -216,6 +277,7 @@ FAT16::File::open(uint16_t index, uint8_t oflag)
 
   m_curCluster = 0;
   m_curPosition = 0;
+  m_extentEnd = 0;
   m_dirEntryIndex = index;
   m_fileSize = d->fileSize;
   m_firstCluster = d->firstClusterLow;
@@ -233,6 +295,9 @@ FAT16::File::remove(void)
   dir_t* d = cacheDirEntry(m_dirEntryIndex, CACHE_FOR_WRITE);
   if (!d) return (false);
   d->name[0] = DIR_NAME_DELETED;
+#if (COSA_FAT16_INDEX_MAX > 0)
+  if (dirIndexed) dirIndex[m_dirEntryIndex] = INDEX_DELETED;
+#endif
   m_flags = 0;
   return (cacheFlush());
 }
@@ -265,6 +330,9 @@ FAT16::File::read(void* buf, size_t nbyte)
       // Start next cluster
       if (m_curCluster == 0) {
         m_curCluster = m_firstCluster;
+      } else if (m_curCluster < m_extentEnd) {
+        // Next cluster in contiguous extent
+        m_curCluster += 1;
       } else {
         if (!fatGet(m_curCluster, &m_curCluster)) return (IOStream::EOF);
       }
@@ -272,12 +340,23 @@ FAT16::File::read(void* buf, size_t nbyte)
       if (m_curCluster < 2 || isEOC(m_curCluster)) return (IOStream::EOF);
     }
 
+    // Stream full blocks in contiguous extent directly to caller
+    if (blockOffset == 0 && nToRead >= 512) {
+      uint16_t blocks = nToRead >> 9;
+      if (!readExtent(blkOfCluster, dst, blocks)) return (IOStream::EOF);
+      uint16_t n = blocks << 9;
+      m_curPosition += n;
+      dst += n;
+      nToRead -= n;
+      continue;
+    }
+
     // Cache data block
     if (!cacheRawBlock(dataBlockLba(m_curCluster, blkOfCluster)))
       return (IOStream::EOF);
 
     // Location of data in cache
-    uint8_t* src = cacheBuffer.data + blockOffset;
+    uint8_t* src = cacheBuffer->data + blockOffset;
 
     // Max number of byte available in block
     uint16_t n = 512 - blockOffset;
@@ -333,16 +412,33 @@ FAT16::File::write(const void* buf, size_t nbyte)
       }
     }
     uint32_t lba = dataBlockLba(m_curCluster, blkOfCluster);
+    if (blockOffset == 0 && m_curPosition >= m_fileSize && nToWrite >= 512) {
+      // Stream full blocks in the cluster directly to the device
+      uint8_t blocks = blocksPerCluster - blkOfCluster;
+      if (blocks > (nToWrite >> 9)) blocks = (nToWrite >> 9);
+      cacheInvalidate(lba, blocks);
+      if (!device->begin_write(lba, blocks)) return (IOStream::EOF);
+      for (uint8_t i = 0; i < blocks; i++) {
+	if (!device->write_next(src)) {
+	  device->end_write();
+	  return (IOStream::EOF);
+	}
+	src += 512;
+      }
+      if (!device->end_write()) return (IOStream::EOF);
+      uint16_t n = (uint16_t) blocks << 9;
+      m_curPosition += n;
+      nToWrite -= n;
+      continue;
+    }
     if (blockOffset == 0 && m_curPosition >= m_fileSize) {
       // Start of new block don't need to read into cache
-      if (!cacheFlush()) return (IOStream::EOF);
-      cacheBlockNumber = lba;
-      cacheSetDirty();
+      if (!cacheNewBlock(lba)) return (IOStream::EOF);
     } else {
       // Rewrite part of block
       if (!cacheRawBlock(lba, CACHE_FOR_WRITE)) return (IOStream::EOF);
     }
-    uint8_t* dst = cacheBuffer.data + blockOffset;
+    uint8_t* dst = cacheBuffer->data + blockOffset;
 
     // Max space in block
     uint16_t n = 512 - blockOffset;
@@ -388,6 +484,7 @@ FAT16::File::seek(uint32_t pos, uint8_t whence)
 
   // Error if file not open or seek past end of file
   if (!is_open() || pos > m_fileSize) return (false);
+  m_extentEnd = 0;
   if (pos == 0) {
     // Set position to start of file
     m_curCluster = 0;
@@ -423,7 +520,7 @@ FAT16::File::truncate(uint32_t length)
   if (length == 0) {
     // Free all clusters
     if (!freeChain(m_firstCluster)) return (false);
-    m_curCluster = m_firstCluster = 0;
+    m_curCluster = m_firstCluster = m_extentEnd = 0;
   }
   else {
     fat_t toFree;
@@ -557,41 +654,222 @@ FAT16::File::addCluster()
   return (true);
 }
 
+bool
+FAT16::File::readExtent(uint8_t blkOfCluster, uint8_t* dst, uint16_t& blocks)
+{
+  // Find the end of the contiguous extent covering the blocks
+  uint16_t avail = blocksPerCluster - blkOfCluster;
+  if (m_curCluster >= m_extentEnd) {
+    m_extentEnd = m_curCluster;
+    while (avail < blocks) {
+      fat_t next;
+      if (!fatGet(m_extentEnd, &next)) return (false);
+      if (next != m_extentEnd + 1) break;
+      m_extentEnd = next;
+      avail += blocksPerCluster;
+    }
+  }
+  else {
+    avail += (uint16_t) (m_extentEnd - m_curCluster) * blocksPerCluster;
+  }
+  if (blocks > avail) blocks = avail;
+
+  // Write back cached blocks and stream the blocks from the device
+  if (!cacheFlush()) return (false);
+  if (!device->begin_read(dataBlockLba(m_curCluster, blkOfCluster)))
+    return (false);
+  for (uint16_t i = 0; i < blocks; i++) {
+    if (!device->read_next(dst)) {
+      device->end_read();
+      return (false);
+    }
+    dst += 512;
+  }
+  if (!device->end_read()) return (false);
+
+  // Step to the cluster of the last block read
+  m_curCluster += (blkOfCluster + blocks - 1) / blocksPerCluster;
+  return (true);
+}
+
+bool
+FAT16::File::reserve(uint32_t bytes)
+{
+  // Error if file is not open for write
+  if (!(m_flags & O_WRITE)) return (false);
+
+  // Number of clusters needed for the file and reserved bytes
+  uint32_t clusterSize = (uint32_t) blocksPerCluster << 9;
+  uint32_t need = (m_fileSize + bytes + clusterSize - 1) / clusterSize;
+
+  // Find the last cluster of the file
+  fat_t last = 0;
+  fat_t cluster = m_firstCluster;
+  while (cluster != 0 && !isEOC(cluster)) {
+    if (need == 0) return (true);
+    need -= 1;
+    last = cluster;
+    if (!fatGet(cluster, &cluster)) return (false);
+  }
+
+  // Allocate runs of free clusters starting after the last cluster
+  fat_t freeCluster = last ? last : 1;
+  while (need != 0) {
+    fat_t value;
+    for (fat_t i = 0; ; i++) {
+      if (i >= clusterCount) return (false);
+      if (freeCluster > clusterCount) freeCluster = 1;
+      freeCluster++;
+      if (!fatGet(freeCluster, &value)) return (false);
+      if (value == 0) break;
+    }
+
+    // Extend the run while the following clusters are free
+    fat_t start = freeCluster;
+    fat_t end = start;
+    while ((--need != 0) && (end <= clusterCount)) {
+      if (!fatGet(end + 1, &value)) return (false);
+      if (value != 0) break;
+      end += 1;
+    }
+
+    // Link the run and append to the chain
+    for (cluster = start; cluster < end; cluster++)
+      if (!fatPut(cluster, cluster + 1)) return (false);
+    if (!fatPut(end, EOC16)) return (false);
+    if (last != 0) {
+      if (!fatPut(last, start)) return (false);
+    }
+    else {
+      m_flags |= F_FILE_DIR_DIRTY;
+      m_firstCluster = start;
+    }
+    last = end;
+    freeCluster = end;
+  }
+  return (true);
+}
+
 FAT16::dir_t*
 FAT16::cacheDirEntry(uint16_t index, uint8_t action)
 {
   if (index >= rootDirEntryCount) return NULL;
-  if (!cacheRawBlock(rootDirStartBlock + (index >> 4), action)) return NULL;
-  return &cacheBuffer.dir[index & 0XF];
+  if (!cacheRawBlock(rootDirStartBlock + (index >> 4), action | CACHE_DIR))
+    return NULL;
+  return &cacheBuffer->dir[index & 0XF];
+}
+
+void
+FAT16::cacheTouch(uint8_t ix)
+{
+  for (uint8_t i = 0; i < CACHE_MAX; i++)
+    if (cacheEntry[i].age < 255) cacheEntry[i].age += 1;
+  cacheEntry[ix].age = 0;
+  cacheCurrent = ix;
+  cacheBuffer = &cacheBlock[ix];
 }
 
 uint8_t
-FAT16::cacheFlush(void)
+FAT16::cacheWriteBack(uint8_t ix)
 {
-  if (cacheDirty) {
-    if (!device->write(cacheBlockNumber, cacheBuffer.data)) {
+  cache_entry_t* entry = &cacheEntry[ix];
+  if (entry->flags & CACHE_FOR_WRITE) {
+    if (!device->write(entry->blockNumber, cacheBlock[ix].data)) {
       return (false);
     }
-    if (cacheMirrorBlock) {
-      if (!device->write(cacheMirrorBlock, cacheBuffer.data)) {
+    // Update the FAT mirror when the block is written back
+    if ((entry->flags & CACHE_FAT) && (fatCount > 1)) {
+      uint32_t mirror = entry->blockNumber + blocksPerFat;
+      if (!device->write(mirror, cacheBlock[ix].data)) {
         return (false);
       }
-      cacheMirrorBlock = 0;
     }
-    cacheDirty = 0;
+    entry->flags &= ~CACHE_FOR_WRITE;
   }
   return (true);
 }
 
+uint8_t
+FAT16::cacheAllocate(uint32_t blockNumber, uint8_t tag)
+{
+  // Replace a free entry, the least recently used data block or
+  // the least recently used block
+  uint8_t ix = 0;
+  uint8_t age = 0;
+  bool data = false;
+  for (uint8_t i = 0; i < CACHE_MAX; i++) {
+    cache_entry_t* entry = &cacheEntry[i];
+    if (entry->blockNumber == 0XFFFFFFFF) {
+      ix = i;
+      break;
+    }
+    bool isData = ((entry->flags & (CACHE_DIR | CACHE_FAT)) == 0);
+    if ((i == 0) || (isData && !data) || ((isData == data) && (entry->age > age))) {
+      ix = i;
+      age = entry->age;
+      data = isData;
+    }
+  }
+  if (!cacheWriteBack(ix)) return (CACHE_MAX);
+  cacheEntry[ix].blockNumber = blockNumber;
+  cacheEntry[ix].flags = tag;
+  return (ix);
+}
+
 uint8_t
 FAT16::cacheRawBlock(uint32_t blockNumber, uint8_t action)
 {
-  if (cacheBlockNumber != blockNumber) {
-    if (!cacheFlush()) return (false);
-    if (!device->read(blockNumber, cacheBuffer.data)) return (false);
-    cacheBlockNumber = blockNumber;
+  uint8_t ix;
+  for (ix = 0; ix < CACHE_MAX; ix++)
+    if (cacheEntry[ix].blockNumber == blockNumber) break;
+  if (ix == CACHE_MAX) {
+    ix = cacheAllocate(blockNumber, action & (CACHE_DIR | CACHE_FAT));
+    if (ix == CACHE_MAX) return (false);
+    if (!device->read(blockNumber, cacheBlock[ix].data)) {
+      cacheEntry[ix].blockNumber = 0XFFFFFFFF;
+      return (false);
+    }
+  }
+  cacheEntry[ix].flags |= action;
+  cacheTouch(ix);
+  return (true);
+}
+
+uint8_t
+FAT16::cacheNewBlock(uint32_t blockNumber)
+{
+  uint8_t ix;
+  for (ix = 0; ix < CACHE_MAX; ix++)
+    if (cacheEntry[ix].blockNumber == blockNumber) break;
+  if (ix == CACHE_MAX) {
+    ix = cacheAllocate(blockNumber, CACHE_DATA);
+    if (ix == CACHE_MAX) return (false);
+  }
+  cacheEntry[ix].flags |= CACHE_FOR_WRITE;
+  cacheTouch(ix);
+  return (true);
+}
+
+void
+FAT16::cacheInvalidate(uint32_t blockNumber, uint8_t count)
+{
+  // Drop blocks in the given range; all blocks if count is zero
+  for (uint8_t ix = 0; ix < CACHE_MAX; ix++) {
+    cache_entry_t* entry = &cacheEntry[ix];
+    if ((count == 0) || ((entry->blockNumber - blockNumber) < count)) {
+      entry->blockNumber = 0XFFFFFFFF;
+      entry->flags = 0;
+      entry->age = 0;
+    }
   }
-  cacheDirty |= action;
+}
+
+uint8_t
+FAT16::cacheFlush(void)
+{
+  // Write back all dirty blocks; FAT mirror updates are batched here
+  for (uint8_t ix = 0; ix < CACHE_MAX; ix++)
+    if (!cacheWriteBack(ix)) return (false);
   return (true);
 }
 
@@ -600,10 +878,8 @@ FAT16::fatGet(fat_t cluster, fat_t* value)
 {
   if (cluster > (clusterCount + 1)) return (false);
   uint32_t lba = fatStartBlock + (cluster >> 8);
-  if (lba != cacheBlockNumber) {
-    if (!cacheRawBlock(lba)) return (false);
-  }
-  *value = cacheBuffer.fat[cluster & 0XFF];
+  if (!cacheRawBlock(lba, CACHE_FAT)) return (false);
+  *value = cacheBuffer->fat[cluster & 0XFF];
   return (true);
 }
 
@@ -613,12 +889,8 @@ FAT16::fatPut(fat_t cluster, fat_t value)
   if (cluster < 2) return (false);
   if (cluster > (clusterCount + 1)) return (false);
   uint32_t lba = fatStartBlock + (cluster >> 8);
-  if (lba != cacheBlockNumber) {
-    if (!cacheRawBlock(lba)) return (false);
-  }
-  cacheBuffer.fat[cluster & 0XFF] = value;
-  cacheSetDirty();
-  if (fatCount > 1) cacheMirrorBlock = lba + blocksPerFat;
+  if (!cacheRawBlock(lba, CACHE_FAT | CACHE_FOR_WRITE)) return (false);
+  cacheBuffer->fat[cluster & 0XFF] = value;
   return (true);
 }
 
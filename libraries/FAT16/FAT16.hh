@@ -27,6 +27,27 @@
 #include "Cosa/IOStream.hh"
 #include "Cosa/FS.hh"
 
+/**
+ * Number of blocks in the FAT16 block cache. Default is four blocks
+ * on devices with more than 8 Kbyte SRAM otherwise one block.
+ */
+#ifndef COSA_FAT16_CACHE_MAX
+# if (RAMEND > 0x2000)
+#   define COSA_FAT16_CACHE_MAX 4
+# else
+#   define COSA_FAT16_CACHE_MAX 1
+# endif
+#endif
+
+/**
+ * Max number of root directory entries in the in-memory directory
+ * name index (one byte per entry). Default is zero; no index. The
+ * index is not used if the volume has more root directory entries.
+ */
+#ifndef COSA_FAT16_INDEX_MAX
+# define COSA_FAT16_INDEX_MAX 0
+#endif
+
 /*
  * FAT16 file structures on SD card. Note: may only access files on the
  * root directory.
@@ -634,7 +655,7 @@ public:
     /**
      * Rewind to the start of the file.
      */
-    void rewind() { m_curPosition = m_curCluster = 0; }
+    void rewind() { m_curPosition = m_curCluster = m_extentEnd = 0; }
 
     /**
      * Return number of bytes in file.
@@ -653,6 +674,20 @@ public:
      */
     bool truncate(uint32_t size);
 
+    /**
+     * Preallocate clusters for the given number of bytes after the
+     * end of file. Clusters are allocated in contiguous runs
+     * following the last cluster of the file when possible. The file
+     * size is not changed; the clusters are used by following
+     * writes and remain allocated to the file. Returns true if
+     * successful otherwise false for failure. Reasons for failure
+     * include file is read only, the volume is full or an I/O error
+     * occurs.
+     * @param[in] bytes number of bytes to reserve.
+     * @return bool.
+     */
+    bool reserve(uint32_t bytes);
+
     /**
      * @override{IOStream::Device}
      * Write character to the file.
@@ -699,9 +734,11 @@ public:
     uint32_t m_fileSize;      // fileSize
     fat_t m_curCluster;       // current cluster
     uint32_t m_curPosition;   // current byte offset
+    fat_t m_extentEnd;        // last cluster of contiguous extent
 
     static uint8_t isEOC(fat_t cluster) { return cluster >= 0XFFF8; }
     bool addCluster();
+    bool readExtent(uint8_t blkOfCluster, uint8_t* dst, uint16_t& blocks);
     bool freeChain(fat_t cluster);
     bool open(uint16_t entry, uint8_t oflag);
     bool dirEntry(dir_t* dir);
@@ -786,13 +823,32 @@ protected:
   static uint32_t rootDirStartBlock;	// start of root dir
   static uint32_t dataStartBlock;	// start of data clusters
 
-  // block cache
+  // block cache; least recently used blocks with tags are replaced
   static uint8_t const CACHE_FOR_READ  = 0;    // cache a block for read
   static uint8_t const CACHE_FOR_WRITE = 1;    // cache a block and set dirty
-  static cache16_t cacheBuffer;		// 512 byte cache for raw blocks
-  static uint32_t cacheBlockNumber; 	// Logical number of block in the cache
-  static uint8_t cacheDirty;         	// cacheFlush() will write block if true
-  static uint32_t cacheMirrorBlock;  	// mirror block for second FAT
+  static uint8_t const CACHE_DATA = 0;	       // tag for file data block
+  static uint8_t const CACHE_DIR = 2;	       // tag for directory block
+  static uint8_t const CACHE_FAT = 4;	       // tag for FAT block (mirror)
+  static uint8_t const CACHE_MAX = COSA_FAT16_CACHE_MAX;
+  struct cache_entry_t {
+    uint32_t blockNumber;		// Logical number of block in entry
+    uint8_t flags;			// Dirty flag and tag
+    uint8_t age;			// Number of accesses since last use
+  };
+  static cache16_t cacheBlock[CACHE_MAX]; // 512 byte cache for raw blocks
+  static cache_entry_t cacheEntry[CACHE_MAX]; // Cache entry state
+  static cache16_t* cacheBuffer;	// Current block in the cache
+  static uint8_t cacheCurrent;		// Current cache entry index
+
+#if (COSA_FAT16_INDEX_MAX > 0)
+  // directory name index; hash per root directory entry
+  static uint8_t const INDEX_FREE = 0;	       // free entry, no entries follow
+  static uint8_t const INDEX_DELETED = 1;      // deleted entry
+  static uint8_t dirIndex[COSA_FAT16_INDEX_MAX];
+  static bool dirIndexed;		// true if index is valid for volume
+  static uint8_t dirHash(const uint8_t* name);
+  static bool dirIndexBuild();
+#endif
 
   // callback function for date/time
   static void (*dateTime)(uint16_t* date, uint16_t* time);
@@ -813,11 +869,16 @@ protected:
   }
   static dir_t* cacheDirEntry(uint16_t index, uint8_t action = 0);
   static uint8_t cacheRawBlock(uint32_t blockNumber, uint8_t action = 0);
+  static uint8_t cacheNewBlock(uint32_t blockNumber);
+  static void cacheInvalidate(uint32_t blockNumber, uint8_t count);
   static uint8_t cacheFlush(void);
   static void cacheSetDirty(void)
   {
-    cacheDirty |= CACHE_FOR_WRITE;
+    cacheEntry[cacheCurrent].flags |= CACHE_FOR_WRITE;
   }
+  static uint8_t cacheAllocate(uint32_t blockNumber, uint8_t tag);
+  static void cacheTouch(uint8_t ix);
+  static uint8_t cacheWriteBack(uint8_t ix);
   static uint32_t dataBlockLba(fat_t cluster, uint8_t blockOfCluster)
   {
     return (dataStartBlock +
@@ -37,32 +37,26 @@ Fai::begin()
 
 #if defined(BOARD_ATTINYX5)
 
-void
-Fai::write(uint32_t mask)
+uint32_t
+Fai::read(uint32_t mask)
 {
-  digital_pins_t dgl;
-  dgl.values = (PINB & mask);
-  Ciao::write(&Descriptor::digital_pins_t, &dgl, 1);
+  return (PINB & mask);
 }
 
 #elif defined(BOARD_ATTINYX4) || defined(BOARD_ATTINYX61)
 
-void
-Fai::write(uint32_t mask)
+uint32_t
+Fai::read(uint32_t mask)
 {
-  digital_pins_t dgl;
-  dgl.values = ((PINB << 8) | PINA) & mask;
-  Ciao::write(&Descriptor::digital_pins_t, &dgl, 1);
+  return (((PINB << 8) | PINA) & mask);
 }
 
 #else
 
-void
-Fai::write(uint32_t mask)
+uint32_t
+Fai::read(uint32_t mask)
 {
-  digital_pins_t dgl;
-  dgl.values = ((PINB << 8) | PIND) & mask;
-  Ciao::write(&Descriptor::digital_pins_t, &dgl, 1);
+  return (((PINB << 8) | PIND) & mask);
 }
 
 #endif
@@ -25,6 +25,7 @@
 #include "Cosa/Pin.hh"
 #include "Cosa/AnalogPin.hh"
 #include "Cosa/Event.hh"
+#include "Cosa/Periodic.hh"
 
 #include <Ciao.h>
 
@@ -104,11 +105,23 @@ public:
    */
   void begin();
 
+  /**
+   * Read digital pins value (port registers) for given mask.
+   * @param[in] mask digital pins to read.
+   * @return pins value.
+   */
+  static uint32_t read(uint32_t mask);
+
   /**
    * Write digital pins value to data stream.
    * @param[in] mask digital pins to write to data stream.
    */
-  void write(uint32_t mask);
+  void write(uint32_t mask)
+  {
+    digital_pins_t dgl;
+    dgl.values = read(mask);
+    Ciao::write(&Descriptor::digital_pins_t, &dgl, 1);
+  }
 
   /**
    * Write digital pin value to data stream.
@@ -130,6 +143,137 @@ public:
   {
     Ciao::write(&Descriptor::event_t, event, 1);
   }
+
+  /**
+   * Periodic change-only sampling of digital and analog pins. Each
+   * period the digital pins are sampled and written as a single
+   * digital_pins_t bitmap only when a subscribed pin has changed
+   * (edge-only). Analog pins are written as analog_pin_t when the
+   * value has changed more than the deadband of the pin. The number
+   * of records per period may be limited; analog pins that are not
+   * written are served first in the next period.
+   * @code
+   * Fai fai(&uart);
+   * Fai::Subscription sub(&fai, Watchdog::scheduler(), 100);
+   * ...
+   * sub.digital(_BV(Board::D2) | _BV(Board::D3));
+   * sub.analog(0, 8);
+   * sub.limit(4);
+   * sub.start();
+   * @endcode
+   */
+  class Subscription : public Periodic {
+  public:
+    /** Number of analog pins. */
+    static const uint8_t ANALOG_MAX = Board::ANALOG_PIN_MAX;
+
+    /**
+     * Construct subscription for given data stream with given
+     * scheduler and period (scheduler time base).
+     * @param[in] fai data stream.
+     * @param[in] scheduler for the periodic job.
+     * @param[in] period of sampling.
+     */
+    Subscription(Fai* fai, Job::Scheduler* scheduler, uint32_t period) :
+      Periodic(scheduler, period),
+      m_fai(fai),
+      m_digital(0),
+      m_values(0),
+      m_analog(0),
+      m_limit(0),
+      m_next(0),
+      m_sync(false)
+    {}
+
+    /**
+     * Subscribe to given digital pins (mask as in digital_pins_t).
+     * @param[in] pins digital pin mask.
+     */
+    void digital(uint32_t pins)
+    {
+      m_digital = pins;
+      m_sync = false;
+    }
+
+    /**
+     * Subscribe to analog pin with given index in analog pin map
+     * (A0 is zero) and given deadband. The value is written when it
+     * has changed more than the deadband.
+     * @param[in] ix analog pin index.
+     * @param[in] deadband for pin.
+     */
+    void analog(uint8_t ix, uint16_t deadband)
+    {
+      if (UNLIKELY(ix >= ANALOG_MAX)) return;
+      m_analog |= _BV(ix);
+      m_deadband[ix] = deadband;
+      m_value[ix] = UINT16_MAX;
+    }
+
+    /**
+     * Unsubscribe analog pin with given index.
+     * @param[in] ix analog pin index.
+     */
+    void unsubscribe(uint8_t ix)
+    {
+      if (UNLIKELY(ix >= ANALOG_MAX)) return;
+      m_analog &= ~_BV(ix);
+    }
+
+    /**
+     * Set max number of records per period (zero for no limit).
+     * @param[in] records per period.
+     */
+    void limit(uint8_t records)
+    {
+      m_limit = records;
+    }
+
+    /**
+     * Subscribe to digital pins and set period from the given sample
+     * request.
+     * @param[in] req sample request.
+     */
+    void subscribe(const sample_request_t* req)
+    {
+      digital(req->pins);
+      period(req->period);
+    }
+
+    /**
+     * @override{Job}
+     * Sample pins and write changes to data stream.
+     */
+    virtual void run();
+
+  protected:
+    /** Data stream. */
+    Fai* m_fai;
+
+    /** Subscribed digital pins. */
+    uint32_t m_digital;
+
+    /** Latest written digital pins value. */
+    uint32_t m_values;
+
+    /** Subscribed analog pins (index bitset). */
+    uint16_t m_analog;
+
+    /** Max records per period (zero for no limit). */
+    uint8_t m_limit;
+
+    /** Next analog pin index to sample. */
+    uint8_t m_next;
+
+    /** Digital pins value written. */
+    bool m_sync;
+
+    /** Deadband per analog pin. */
+    uint16_t m_deadband[ANALOG_MAX];
+
+    /** Latest written value per analog pin. */
+    uint16_t m_value[ANALOG_MAX];
+  };
 };
 
 #endif
@@ -0,0 +1,65 @@
+/**
+ * @file Subscription.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Fai.hh"
+
+void
+Fai::Subscription::run()
+{
+  uint8_t budget = m_limit;
+
+  // Write digital pins bitmap on change (edge-only)
+  if (m_digital != 0) {
+    uint32_t values = Fai::read(m_digital);
+    if (!m_sync || values != m_values) {
+      digital_pins_t dgl;
+      dgl.values = values;
+      m_fai->Ciao::write(&Descriptor::digital_pins_t, &dgl, 1);
+      m_values = values;
+      m_sync = true;
+      if (budget != 0 && --budget == 0) return;
+    }
+  }
+
+  // Write analog pins that have changed more than the deadband. Start
+  // with the pin after the latest written to share the budget
+  if (m_analog == 0) return;
+  uint8_t ix = m_next;
+  for (uint8_t i = 0; i < ANALOG_MAX; i++, ix++) {
+    if (ix == ANALOG_MAX) ix = 0;
+    if ((m_analog & _BV(ix)) == 0) continue;
+    Board::AnalogPin pin;
+    pin = (Board::AnalogPin) pgm_read_byte(analog_pin_map + ix);
+    uint16_t value = AnalogPin::sample(pin);
+    uint16_t last = m_value[ix];
+    uint16_t diff = (value > last) ? value - last : last - value;
+    if ((last != UINT16_MAX) && (diff <= m_deadband[ix])) continue;
+    analog_pin_t ang;
+    ang.pin = pin;
+    ang.value = value;
+    m_fai->Ciao::write(&Descriptor::analog_pin_t, &ang, 1);
+    m_value[ix] = value;
+    if (budget != 0 && --budget == 0) {
+      m_next = ix + 1;
+      if (m_next == ANALOG_MAX) m_next = 0;
+      return;
+    }
+  }
+}
@@ -10,646 +10,60 @@ Spacing:	C
 Copyright:	UNKNOWN
 */
 
-/* encoding format is 8 rows at a time (byte) sweeping across columns */
+/* run-length encoded (build/rle.py); format is 8 rows at a time (byte) sweeping across columns */
 
 const uint8_t Segment32x50::width = 32;
 const uint8_t Segment32x50::height = 50;
 const uint8_t Segment32x50::first = 0x30;
 const uint8_t Segment32x50::last = 0x3a;
-const uint8_t Segment32x50::compression_type = 1;
+const uint8_t Segment32x50::compression_type = 2;
 
 /* glyph_size=224 */
 /* uncompressed_size=2464 */
-/* bitmap_size=1311 */
-/* compression saved 46% */
+/* bitmap_size=671 (was 1311) */
 
 const uint8_t Segment32x50::bitmap[] __PROGMEM = {
-/* '0'    ( 48, 0x30)    +22 */  0x00,0x16,
-/* '1'    ( 49, 0x31)   +151 */  0x00,0x97,
-/* '2'    ( 50, 0x32)   +215 */  0x00,0xd7,
-/* '3'    ( 51, 0x33)   +349 */  0x01,0x5d,
-/* '4'    ( 52, 0x34)   +483 */  0x01,0xe3,
-/* '5'    ( 53, 0x35)   +597 */  0x02,0x55,
-/* '6'    ( 54, 0x36)   +730 */  0x02,0xda,
-/* '7'    ( 55, 0x37)   +875 */  0x03,0x6b,
-/* '8'    ( 56, 0x38)   +956 */  0x03,0xbc,
-/* '9'    ( 57, 0x39)  +1115 */  0x04,0x5b,
-/* ':'    ( 58, 0x3a)  +1262 */  0x04,0xee,
-
-/* '0'    ( 48, 0x30) offset=22 length=129 compressed=42% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |....@@..@@@@@@@@@@@@@@@.@@@@....| */
-/* |...@@@@................@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@......................@@...| */
-/* |..@.........................@...| */
-/* |................................| */
-/* |..@.............................| */
-/* |..@@@......................@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |...@@@@.................@@@@....| */
-/* |....@@..@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1f,0xff,0xff,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x90,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0x3f,0x1f,0x1f,0x1f,0x3f,0x3f,0x7f,0xff,0xfe,0xfc,0xfc,0xf8,0xf8,0xf0,0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x27,0x73,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* '1'    ( 49, 0x31) offset=151 length=64 compressed=71% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |.........................@@.....| */
-/* |........................@@@@....| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.........................@@@@...| */
-/* |...........................@@...| */
-/* |............................@...| */
-/* |................................| */
-/* |................................| */
-/* |...........................@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |.........................@@.....| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0x1f,0x1f,0x3f,0x3f,0x7f,0xff,0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x07,0x03,
-
-/* '2'    ( 50, 0x32) offset=215 length=134 compressed=40% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |........@@@@@@@@@@@@@@@.@@@@....| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.........................@@@@...| */
-/* |.......@@@@@@@@@@@@@@@@....@@...| */
-/* |......@@@@@@@@@@@@@@@@@@@...@...| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |..@..@@@@@@@@@@@@@@@@@@@@@......| */
-/* |..@@@..@@@@@@@@@@@@@@@@@........| */
-/* |..@@@@@.........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |...@@@@.........................| */
-/* |....@@..@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x03,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x03,0xff,0xff,0xf8,0x3f,0xff,0xff,0xe0,0x3f,0x00,0x00,0x00,0x3f,0xff,0xff,0x80,0x00,0x00,0x00,0x00,
-0x10,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0x80,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0xfe,0xfc,0xfd,0xfb,0xfb,0xf7,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x03,0x03,0x01,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x27,0x73,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x70,0x20,
-
-/* '3'    ( 51, 0x33) offset=349 length=134 compressed=40% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |........@@@@@@@@@@@@@@@.@@@@....| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.........................@@@@...| */
-/* |.......@@@@@@@@@@@@@@@@....@@...| */
-/* |......@@@@@@@@@@@@@@@@@@@...@...| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |.....@@@@@@@@@@@@@@@@@@@@@......| */
-/* |.......@@@@@@@@@@@@@@@@@...@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |........@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x03,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x03,0xff,0xff,0xf8,0x0f,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x03,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x10,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0x80,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0x01,0x03,0x03,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x20,0x70,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* '4'    ( 52, 0x34) offset=483 length=114 compressed=49% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |.........................@@.....| */
-/* |....@@..................@@@@....| */
-/* |...@@@@................@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@..@@@@@@@@@@@@@@@@....@@...| */
-/* |..@...@@@@@@@@@@@@@@@@@@@...@...| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |.....@@@@@@@@@@@@@@@@@@@@@......| */
-/* |.......@@@@@@@@@@@@@@@@@...@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |.........................@@.....| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1e,0x00,0x01,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x0f,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x80,0x80,0xc0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0x01,0x03,0x03,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x07,0x03,
-
-/* '5'    ( 53, 0x35) offset=597 length=133 compressed=40% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |....@@..@@@@@@@@@@@@@@@.........| */
-/* |...@@@@.........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@.........................| */
-/* |..@@@..@@@@@@@@@@@@@@@@.........| */
-/* |..@...@@@@@@@@@@@@@@@@@@@.......| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |.....@@@@@@@@@@@@@@@@@@@@@......| */
-/* |.......@@@@@@@@@@@@@@@@@...@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |........@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1f,0xff,0xff,0x80,0x3f,0x00,0x00,0x00,0x3f,0xff,0xff,0x80,0x0f,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x03,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x90,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x38,0x10,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x80,0x80,0x01,0x03,0x03,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x20,0x70,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* '6'    ( 54, 0x36) offset=730 length=145 compressed=35% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |....@@..@@@@@@@@@@@@@@@.........| */
-/* |...@@@@.........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@@........................| */
-/* |..@@@@@.........................| */
-/* |..@@@..@@@@@@@@@@@@@@@@.........| */
-/* |..@...@@@@@@@@@@@@@@@@@@@.......| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |..@..@@@@@@@@@@@@@@@@@@@@@......| */
-/* |..@@@..@@@@@@@@@@@@@@@@@...@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |...@@@@.................@@@@....| */
-/* |....@@..@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1f,0xff,0xff,0x80,0x3f,0x00,0x00,0x00,0x3f,0xff,0xff,0x80,0x3f,0xff,0xff,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x90,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x38,0x10,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x80,0x80,0xfe,0xfc,0xfd,0xfb,0xfb,0xf7,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x27,0x73,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* '7'    ( 55, 0x37) offset=875 length=81 compressed=63% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |........@@@@@@@@@@@@@@@.@@@@....| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.........................@@@@...| */
-/* |...........................@@...| */
-/* |............................@...| */
-/* |................................| */
-/* |................................| */
-/* |...........................@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |.........................@@.....| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x03,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x01,0xf8,0x00,0x00,0x00,0x00,
-0x10,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0x1f,0x1f,0x3f,0x3f,0x7f,0xff,0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x07,0x03,
-
-/* '8'    ( 56, 0x38) offset=956 length=159 compressed=29% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |....@@..@@@@@@@@@@@@@@@.@@@@....| */
-/* |...@@@@................@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@..@@@@@@@@@@@@@@@@....@@...| */
-/* |..@...@@@@@@@@@@@@@@@@@@@...@...| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |..@..@@@@@@@@@@@@@@@@@@@@@......| */
-/* |..@@@..@@@@@@@@@@@@@@@@@...@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |...@@@@.................@@@@....| */
-/* |....@@..@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1f,0xff,0xff,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x3f,0xff,0xff,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x90,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0xfe,0xfc,0xfd,0xfb,0xfb,0xf7,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x03,0x07,0x0f,0x0f,0x27,0x73,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* '9'    ( 57, 0x39) offset=1115 length=147 compressed=34% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@.@@.....| */
-/* |....@@..@@@@@@@@@@@@@@@.@@@@....| */
-/* |...@@@@................@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@@...............@@@@@@...| */
-/* |..@@@@@..................@@@@...| */
-/* |..@@@..@@@@@@@@@@@@@@@@....@@...| */
-/* |..@...@@@@@@@@@@@@@@@@@@@...@...| */
-/* |....@@@@@@@@@@@@@@@@@@@@@@@.....| */
-/* |.....@@@@@@@@@@@@@@@@@@@@@......| */
-/* |.......@@@@@@@@@@@@@@@@@...@@...| */
-/* |.........................@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |.......................@@@@@@...| */
-/* |........................@@@@....| */
-/* |........@@@@@@@@@@@@@@@..@@.....| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |......@@@@@@@@@@@@@@@@@@@.......| */
-/* |.......@@@@@@@@@@@@@@@@@........| */
-/* |........@@@@@@@@@@@@@@@.........| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x1f,0xff,0xff,0xf8,0x3f,0x00,0x01,0xf8,0x3f,0xff,0xff,0xf8,0x0f,0xff,0xff,0xf8,0x00,0x00,0x01,0xf8,0x03,0xff,0xff,0xf8,0x00,0x00,0x00,0x00,
-0x80,0xc0,0xc0,0x90,0x38,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0x7c,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0xc0,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0x01,0x03,0x03,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0x07,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xff,0xff,0xff,0xff,0xff,0xff,0x20,0x70,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0xf8,0x73,0x27,0x0f,0x0f,0x07,0x03,
-
-/* ':'    ( 58, 0x3a) offset=1262 length=49 compressed=78% */
-/* +--------------------------------+ */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................@@@.............| */
-/* |...............@@@@@............| */
-/* |..............@@@@@@@...........| */
-/* |..............@@@@@@@...........| */
-/* |..............@@@@@@@...........| */
-/* |...............@@@@@............| */
-/* |................@@@.............| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................@@@.............| */
-/* |...............@@@@@............| */
-/* |..............@@@@@@@...........| */
-/* |..............@@@@@@@...........| */
-/* |..............@@@@@@@...........| */
-/* |...............@@@@@............| */
-/* |................@@@.............| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* |................................| */
-/* +--------------------------------+ */
-0x00,0x00,0x00,0x00,0x00,0x03,0xf8,0x00,0x00,0x03,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
-0xc0,0xe0,0xf0,0xf0,0xf0,0xe0,0xc0,0x01,0x03,0x07,0x07,0x07,0x03,0x01,0x38,0x7c,0xfe,0xfe,0xfe,0x7c,0x38,
-
+  0x00,0x16,0x00,0x64,0x00,0x8b,0x00,0xc6,0x01,0x01,0x01,0x40,0x01,0x7b,0x01,0xc0,
+  0x01,0xec,0x02,0x3c,0x02,0x82,
+  0xc2,0x04,0x80,0xc0,0xc0,0x90,0x38,0x8e,0x7c,0x05,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,
+  0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,0x05,0xff,0x7f,0x7f,0x3f,0x3f,0x1f,0xce,0x05,
+  0x1f,0x1f,0x3f,0x3f,0x7f,0xff,0xc4,0x05,0xfe,0xfc,0xfc,0xf8,0xf8,0xf0,0xce,0x05,
+  0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,0x05,0x03,0x07,
+  0x0f,0x0f,0x27,0x73,0x8e,0xf8,0x05,0x73,0x27,0x0f,0x0f,0x07,0x03,0xe2,0xd6,0x05,
+  0x80,0xc0,0xe0,0xe0,0xc0,0x80,0xd9,0x85,0xff,0xd9,0x05,0x1f,0x1f,0x3f,0x3f,0x7f,
+  0xff,0xd9,0x05,0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xd9,0x85,0xff,0xd9,0x05,0x03,0x07,
+  0x0f,0x0f,0x07,0x03,0xe2,0xc5,0x01,0x10,0x38,0x8e,0x7c,0x05,0xb8,0xd0,0xe0,0xe0,
+  0xc0,0x80,0xd9,0x85,0xff,0xc8,0x00,0x80,0x8f,0xc0,0x05,0x9f,0x9f,0x3f,0x3f,0x7f,
+  0xff,0xc4,0x05,0xfe,0xfc,0xfd,0xfb,0xfb,0xf7,0x8f,0x07,0x02,0x03,0x03,0x01,0xc6,
+  0x85,0xff,0xd9,0x05,0x03,0x07,0x0f,0x0f,0x27,0x73,0x8e,0xf8,0x01,0x70,0x20,0xe6,
+  0xc5,0x01,0x10,0x38,0x8e,0x7c,0x05,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xd9,0x85,0xff,
+  0xc8,0x00,0x80,0x8f,0xc0,0x05,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0xc6,0x02,0x01,0x03,
+  0x03,0x8f,0x07,0x05,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xd9,0x85,0xff,0xc8,0x01,0x20,
+  0x70,0x8e,0xf8,0x05,0x73,0x27,0x0f,0x0f,0x07,0x03,0xe2,0xc2,0x03,0x80,0xc0,0xc0,
+  0x80,0xcf,0x05,0x80,0xc0,0xe0,0xe0,0xc0,0x80,0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,
+  0x05,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0x8e,0xc0,0x05,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,
+  0xc6,0x02,0x01,0x03,0x03,0x8f,0x07,0x05,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xd9,0x85,
+  0xff,0xd9,0x05,0x03,0x07,0x0f,0x0f,0x07,0x03,0xe2,0xc2,0x04,0x80,0xc0,0xc0,0x90,
+  0x38,0x8e,0x7c,0x01,0x38,0x10,0xc8,0x85,0xff,0xd9,0x05,0xff,0x7f,0x7f,0x3f,0xbf,
+  0xdf,0x8e,0xc0,0x01,0x80,0x80,0xca,0x02,0x01,0x03,0x03,0x8f,0x07,0x05,0xf7,0xf3,
+  0xfb,0xf9,0xfc,0xfc,0xd9,0x85,0xff,0xc8,0x01,0x20,0x70,0x8e,0xf8,0x05,0x73,0x27,
+  0x0f,0x0f,0x07,0x03,0xe2,0xc2,0x04,0x80,0xc0,0xc0,0x90,0x38,0x8e,0x7c,0x01,0x38,
+  0x10,0xc8,0x85,0xff,0xd9,0x05,0xff,0x7f,0x7f,0x3f,0xbf,0xdf,0x8e,0xc0,0x01,0x80,
+  0x80,0xc8,0x05,0xfe,0xfc,0xfd,0xfb,0xfb,0xf7,0x8e,0x07,0x05,0xf7,0xf3,0xfb,0xf9,
+  0xfc,0xfc,0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,0x05,0x03,0x07,0x0f,0x0f,0x27,0x73,
+  0x8e,0xf8,0x05,0x73,0x27,0x0f,0x0f,0x07,0x03,0xe2,0xc5,0x01,0x10,0x38,0x8e,0x7c,
+  0x05,0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xd9,0x85,0xff,0xd9,0x05,0x1f,0x1f,0x3f,0x3f,
+  0x7f,0xff,0xd9,0x05,0xf0,0xf0,0xf8,0xf8,0xfc,0xfc,0xd9,0x85,0xff,0xd9,0x05,0x03,
+  0x07,0x0f,0x0f,0x07,0x03,0xe2,0xc2,0x04,0x80,0xc0,0xc0,0x90,0x38,0x8e,0x7c,0x05,
+  0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,0x05,0xff,0x7f,
+  0x7f,0x3f,0xbf,0xdf,0x8e,0xc0,0x05,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0xc4,0x05,0xfe,
+  0xfc,0xfd,0xfb,0xfb,0xf7,0x8e,0x07,0x05,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xc4,0x85,
+  0xff,0xce,0x85,0xff,0xc4,0x05,0x03,0x07,0x0f,0x0f,0x27,0x73,0x8e,0xf8,0x05,0x73,
+  0x27,0x0f,0x0f,0x07,0x03,0xe2,0xc2,0x04,0x80,0xc0,0xc0,0x90,0x38,0x8e,0x7c,0x05,
+  0xb8,0xd0,0xe0,0xe0,0xc0,0x80,0xc4,0x85,0xff,0xce,0x85,0xff,0xc4,0x05,0xff,0x7f,
+  0x7f,0x3f,0xbf,0xdf,0x8e,0xc0,0x05,0x9f,0x9f,0x3f,0x3f,0x7f,0xff,0xc6,0x02,0x01,
+  0x03,0x03,0x8f,0x07,0x05,0xf7,0xf3,0xfb,0xf9,0xfc,0xfc,0xd9,0x85,0xff,0xc8,0x01,
+  0x20,0x70,0x8e,0xf8,0x05,0x73,0x27,0x0f,0x0f,0x07,0x03,0xe2,0xed,0x01,0xc0,0xe0,
+  0x82,0xf0,0x01,0xe0,0xc0,0xd8,0x01,0x01,0x03,0x82,0x07,0x01,0x03,0x01,0xf8,0x01,
+  0x38,0x7c,0x82,0xfe,0x01,0x7c,0x38,0xff,0xca
 };
@@ -19,6 +19,7 @@
  */
 
 #include "GDDRAM.hh"
+#include "Font.hh"
 
 GDDRAM::GDDRAM(uint16_t width,
 	       uint16_t height,
@@ -26,6 +27,20 @@ GDDRAM::GDDRAM(uint16_t width,
 	       Board::DigitalPin dc) :
   Canvas(width, height),
   SPI::Driver(cs, SPI::ACTIVE_LOW, SPI::DIV2_CLOCK, 3, SPI::MSB_ORDER, NULL),
+  m_io(NULL),
+  m_dc(dc, 1),
+  m_initiated(false)
+{
+}
+
+GDDRAM::GDDRAM(uint16_t width,
+	       uint16_t height,
+	       IO* io,
+	       Board::DigitalPin cs,
+	       Board::DigitalPin dc) :
+  Canvas(width, height),
+  SPI::Driver(cs, SPI::ACTIVE_LOW, SPI::DIV2_CLOCK, 3, SPI::MSB_ORDER, NULL),
+  m_io(io),
   m_dc(dc, 1),
   m_initiated(false)
 {
@@ -38,22 +53,20 @@ GDDRAM::begin()
   const uint8_t* bp = script();
   uint8_t count;
   uint8_t cmd;
-  spi.acquire(this);
-    spi.begin();
-      while ((cmd = pgm_read_byte(bp++)) != SCRIPTEND) {
-	count = pgm_read_byte(bp++);
-	if (cmd == SWDELAY) {
-	  DELAY(count);
-	}
-	else {
-	  asserted(m_dc) {
-	    spi.transfer(cmd);
-	  }
-	  while (count--) spi.transfer(pgm_read_byte(bp++));
+  select();
+    while ((cmd = pgm_read_byte(bp++)) != SCRIPTEND) {
+      count = pgm_read_byte(bp++);
+      if (cmd == SWDELAY) {
+	DELAY(count);
+      }
+      else {
+	asserted(m_dc) {
+	  transfer(cmd);
 	}
+	while (count--) transfer(pgm_read_byte(bp++));
       }
-    spi.end();
-  spi.release();
+    }
+  deselect();
   m_initiated = true;
   return (true);
 }
@@ -73,26 +86,42 @@ GDDRAM::set_orientation(uint8_t direction)
   else {
     setting = (MADCTL_MX | MADCTL_BGR);
   }
-  spi.acquire(this);
-    spi.begin();
-      write(MADCTL, setting);
-    spi.end();
-  spi.release();
+  select();
+    write(MADCTL, setting);
+  deselect();
   return (previous);
 }
 
+bool
+GDDRAM::set_scroll_area(uint16_t top, uint16_t height)
+{
+  if (UNLIKELY(m_direction != PORTRAIT)) return (false);
+  if (UNLIKELY((top + height) > HEIGHT)) return (false);
+  select();
+    write(VSCRDEF, top, height);
+    write((uint16_t) (HEIGHT - top - height));
+  deselect();
+  return (true);
+}
+
+void
+GDDRAM::set_scroll_start(uint16_t row)
+{
+  select();
+    write(VSCRSADD, row);
+  deselect();
+}
+
 void
 GDDRAM::draw_pixel(uint16_t x, uint16_t y)
 {
   const color16_t color = get_pen_color();
-  spi.acquire(this);
-    spi.begin();
-      write(CASET, x, x + 1);
-      write(PASET, y, y + 1);
-      write(RAMWR);
-      write(color.rgb);
-    spi.end();
-  spi.release();
+  select();
+    write(CASET, x, x + 1);
+    write(PASET, y, y + 1);
+    write(RAMWR);
+    write(color.rgb);
+  deselect();
 }
 
 void
@@ -100,25 +129,22 @@ GDDRAM::draw_image(uint16_t x, uint16_t y, Image* image)
 {
   uint16_t width = image->WIDTH;
   uint16_t height = image->HEIGHT;
-  spi.acquire(this);
-    spi.begin();
-      write(CASET, x, x + width - 1);
-      write(PASET, y, y + height - 1);
-      write(RAMWR);
-    spi.end();
-  spi.release();
-  for (uint16_t i = 0; i < height; i++) {
-    color16_t buf[Image::BUFFER_MAX];
-    size_t count;
-    for (uint16_t j = 0; j < width; j += count) {
-      count = (width - j > Image::BUFFER_MAX) ? Image::BUFFER_MAX : width - j;
-      image->read(buf, count);
-      spi.acquire(this);
-        spi.begin();
-	for (uint16_t k = 0; k < count; k++) write(buf[k]);
-	spi.end();
-      spi.release();
-    }
+  select();
+    write(CASET, x, x + width - 1);
+    write(PASET, y, y + height - 1);
+    write(RAMWR);
+  deselect();
+  // The address window wraps; stream the image in buffer chunks. The
+  // image may use the SPI bus (e.g. SD) so release between chunks
+  uint32_t pixels = (uint32_t) width * height;
+  color16_t buf[Image::BUFFER_MAX];
+  while (pixels != 0) {
+    size_t count = (pixels > Image::BUFFER_MAX) ? Image::BUFFER_MAX : pixels;
+    if (!image->read(buf, count)) return;
+    select();
+      write(buf, count);
+    deselect();
+    pixels -= count;
   }
 }
 
@@ -134,14 +160,12 @@ GDDRAM::draw_vertical_line(uint16_t x, uint16_t y, uint16_t length)
   }
   if ((y + length - 1) >= HEIGHT) length = HEIGHT - y;
   const color16_t color = get_pen_color();
-  spi.acquire(this);
-    spi.begin();
-      write(CASET, x, x);
-      write(PASET, y, y + length - 1);
-      write(RAMWR);
-      write(color.rgb, length);
-    spi.end();
-  spi.release();
+  select();
+    write(CASET, x, x);
+    write(PASET, y, y + length - 1);
+    write(RAMWR);
+    fill(color.rgb, length);
+  deselect();
 }
 
 void
@@ -156,14 +180,12 @@ GDDRAM::draw_horizontal_line(uint16_t x, uint16_t y, uint16_t length)
   }
   if ((x + length - 1) >= WIDTH) length = WIDTH - x;
   const color16_t color = get_pen_color();
-  spi.acquire(this);
-    spi.begin();
-      write(CASET, x, x + length - 1);
-      write(PASET, y, y);
-      write(RAMWR);
-      write(color.rgb, length);
-    spi.end();
-  spi.release();
+  select();
+    write(CASET, x, x + length - 1);
+    write(PASET, y, y);
+    write(RAMWR);
+    fill(color.rgb, length);
+  deselect();
 }
 
 void
@@ -174,21 +196,140 @@ GDDRAM::fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
   if ((x + width - 1) >= WIDTH) width = WIDTH - x;
   if ((y + height - 1) >= HEIGHT) height = HEIGHT - y;
   const color16_t color = get_pen_color();
-  spi.acquire(this);
-    spi.begin();
-      write(CASET, x, x + width - 1);
-      write(PASET, y, y + height - 1);
-      write(RAMWR);
-      if (width > height) {
-	for (y = 0; y < height; y++)
-	  write(color.rgb, width);
+  select();
+    write(CASET, x, x + width - 1);
+    write(PASET, y, y + height - 1);
+    write(RAMWR);
+    fill(color.rgb, (uint32_t) width * height);
+  deselect();
+}
+
+void
+GDDRAM::draw_char(uint16_t x, uint16_t y, char c)
+{
+  Font* font = get_text_font();
+  if (UNLIKELY(font->WIDTH > GLYPH_WIDTH_MAX)) {
+    Canvas::draw_char(x, y, c);
+    return;
+  }
+
+  // Character cell; move cursor and clip to canvas
+  uint8_t scale = get_text_scale();
+  uint16_t width = scale * (font->WIDTH + font->SPACING);
+  uint16_t height = scale * font->HEIGHT;
+  set_cursor(x + width, y);
+  damage(x, y, width, height);
+  if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT))) return;
+  if (width > WIDTH - x) width = WIDTH - x;
+  if (height > HEIGHT - y) height = HEIGHT - y;
+
+  // Set the address window for the cell
+  uint16_t fg = get_text_color().rgb;
+  uint16_t bg = get_canvas_color().rgb;
+  Font::Glyph glyph(font, c);
+  uint8_t band[GLYPH_WIDTH_MAX];
+  bool started = false;
+  select();
+    write(CASET, x, x + width - 1);
+    write(PASET, y, y + height - 1);
+    write(RAMWR);
+
+    // Stream the cell row by row. The glyph is stored as column
+    // bytes per band of eight rows; read the next band when needed
+    uint16_t rows = height;
+    for (uint8_t gr = 0; rows != 0; gr++) {
+      if ((gr & 0x07) == 0) {
+	for (uint8_t j = 0; j < font->WIDTH; j++) band[j] = glyph.next();
       }
-      else {
-	for (x = 0; x < width; x++)
-	  write(color.rgb, height);
+      uint8_t mask = (1 << (gr & 0x07));
+      for (uint8_t sr = 0; (sr < scale) && (rows != 0); sr++, rows--) {
+	uint16_t cols = width;
+	for (uint8_t gc = 0; cols != 0; gc++) {
+	  uint16_t color = fg;
+	  if ((gc >= font->WIDTH) || ((band[gc] & mask) == 0)) color = bg;
+	  if (m_io != NULL) {
+	    uint8_t n = (cols < scale) ? cols : scale;
+	    m_io->fill(color, n);
+	    cols -= n;
+	    continue;
+	  }
+	  uint8_t high = color >> 8;
+	  uint8_t low = color;
+	  for (uint8_t sc = 0; (sc < scale) && (cols != 0); sc++, cols--) {
+	    if (started) {
+	      spi.transfer_next(high);
+	    }
+	    else {
+	      spi.transfer_start(high);
+	      started = true;
+	    }
+	    spi.transfer_next(low);
+	  }
+	}
       }
-    spi.end();
-  spi.release();
+    }
+    if (started) spi.transfer_await();
+  deselect();
+}
+
+void
+GDDRAM::fill(uint16_t color, uint32_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  if (m_io != NULL) {
+    m_io->fill(color, count);
+    return;
+  }
+  uint8_t high = color >> 8;
+  uint8_t low = color;
+  spi.transfer_start(high);
+  spi.transfer_next(low);
+  count -= 1;
+  uint8_t n = count & 0x03;
+  while (n--) {
+    spi.transfer_next(high);
+    spi.transfer_next(low);
+  }
+  for (count >>= 2; count != 0; count--) {
+    spi.transfer_next(high);
+    spi.transfer_next(low);
+    spi.transfer_next(high);
+    spi.transfer_next(low);
+    spi.transfer_next(high);
+    spi.transfer_next(low);
+    spi.transfer_next(high);
+    spi.transfer_next(low);
+  }
+  spi.transfer_await();
+}
+
+void
+GDDRAM::write(const color16_t* buf, size_t count)
+{
+  if (UNLIKELY(count == 0)) return;
+  if (m_io != NULL) {
+    m_io->write(buf, count);
+    return;
+  }
+  const uint8_t* bp = (const uint8_t*) buf;
+  spi.transfer_start(bp[1]);
+  spi.transfer_next(bp[0]);
+  bp += 2;
+  count -= 1;
+  uint8_t n = count & 0x01;
+  if (n) {
+    spi.transfer_next(bp[1]);
+    spi.transfer_next(bp[0]);
+    bp += 2;
+  }
+  for (count >>= 1; count != 0; count--) {
+    spi.transfer_next(bp[1]);
+    spi.transfer_next(bp[0]);
+    spi.transfer_next(bp[3]);
+    spi.transfer_next(bp[2]);
+    bp += 4;
+  }
+  spi.transfer_await();
 }
 
 bool
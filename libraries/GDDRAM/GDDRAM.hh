@@ -27,9 +27,129 @@
 
 /**
  * Abstract device driver for Graphical Display Data RAM Devices.
+ * The device is connected with SPI (default) or with an 8080-style
+ * parallel bus adapter (GDDRAM::IO). The chip select and data/command
+ * select pins are handled by the driver for both transports.
  */
 class GDDRAM : public Canvas, protected SPI::Driver {
 public:
+  /**
+   * Abstract parallel bus adapter. Writes bytes and pixels to the
+   * device data bus. Chip select and data/command select are handled
+   * by the driver. The bulk operations (fill and pixel buffer) should
+   * be implemented with unrolled loops.
+   */
+  class IO {
+  public:
+    /**
+     * @override{GDDRAM::IO}
+     * Write byte to device.
+     * @param[in] data to write.
+     */
+    virtual void write(uint8_t data) = 0;
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write 16-bit data to device, MSB first.
+     * @param[in] data to write.
+     */
+    virtual void write(uint16_t data) = 0;
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write given number of pixels with given color to device, MSB
+     * first.
+     * @param[in] color pixel color.
+     * @param[in] count number of pixels.
+     */
+    virtual void fill(uint16_t color, uint32_t count) = 0;
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write given buffer of pixels to device, MSB first.
+     * @param[in] buf pixel buffer.
+     * @param[in] count number of pixels.
+     */
+    virtual void write(const color16_t* buf, size_t count) = 0;
+  };
+
+#if !defined(BOARD_ATTINY)
+  /**
+   * 8-bit parallel bus adapter (8080-style). The data bus is a whole
+   * AVR port; the data pin must be bit zero of the port and the other
+   * seven port pins are used for the bus. Each byte is written with a
+   * single port store and a write strobe (WR). The read strobe (RD)
+   * should be tied high. Pixel fills where the high and low byte of
+   * the color are equal (e.g. black and white) only strobe.
+   *
+   * @section Circuit
+   * @code
+   *                           ILI9341
+   *                       +------------+
+   * (D0..D7/D22..D29)---/-|DB0..DB7    |
+   * (D8/D30)--------------|WR          |
+   * (VCC)-----------------|RD          |
+   * (D10)-----------------|CS          |
+   * (D9)------------------|DC/RS       |
+   *                       +------------+
+   * @endcode
+   */
+  class Port8b : public IO {
+  public:
+    /**
+     * Construct 8-bit parallel bus adapter with given data port (pin
+     * with bit zero of the port) and write strobe pin. Pins are set
+     * to output mode; the write strobe is idle high.
+     * @param[in] data first data pin (Default D0, Mega D22).
+     * @param[in] wr write strobe pin (Default D8, Mega D30).
+     */
+#if defined(BOARD_ATMEGA2560)
+    Port8b(Board::DigitalPin data = Board::D22,
+	   Board::DigitalPin wr = Board::D30);
+#else
+    Port8b(Board::DigitalPin data = Board::D0,
+	   Board::DigitalPin wr = Board::D8);
+#endif
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write byte to device.
+     * @param[in] data to write.
+     */
+    virtual void write(uint8_t data);
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write 16-bit data to device, MSB first.
+     * @param[in] data to write.
+     */
+    virtual void write(uint16_t data);
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write given number of pixels with given color to device, MSB
+     * first. Unrolled; four pixels per loop.
+     * @param[in] color pixel color.
+     * @param[in] count number of pixels.
+     */
+    virtual void fill(uint16_t color, uint32_t count);
+
+    /**
+     * @override{GDDRAM::IO}
+     * Write given buffer of pixels to device, MSB first. Unrolled;
+     * two pixels per loop.
+     * @param[in] buf pixel buffer.
+     * @param[in] count number of pixels.
+     */
+    virtual void write(const color16_t* buf, size_t count);
+
+  protected:
+    volatile uint8_t* m_port;	//!< Data bus port register.
+    volatile uint8_t* m_wr;	//!< Write strobe pin register (toggle).
+    uint8_t m_mask;		//!< Write strobe pin mask.
+  };
+#endif
+
   /**
    * Construct GDDRAM canvas object with given control pins.
    * @param[in] cs slave selection pin.
@@ -42,6 +162,21 @@ public:
 	 Board::DigitalPin cs,
 	 Board::DigitalPin dc);
 
+  /**
+   * Construct GDDRAM canvas object with given parallel bus adapter
+   * and control pins.
+   * @param[in] width screen.
+   * @param[in] height screen.
+   * @param[in] io parallel bus adapter.
+   * @param[in] cs chip select pin.
+   * @param[in] dc data/command selection pin.
+   */
+  GDDRAM(uint16_t width,
+	 uint16_t height,
+	 IO* io,
+	 Board::DigitalPin cs,
+	 Board::DigitalPin dc);
+
   /**
    * @override{Canvas}
    * Start interaction with device.
@@ -56,6 +191,24 @@ public:
    */
   virtual uint8_t set_orientation(uint8_t direction);
 
+  /**
+   * @override{Canvas}
+   * Set vertical scroll area (VSCRDEF). Supported in portrait
+   * orientation only; the scroll is along the display memory rows.
+   * Return true(1) if successful otherwise false(0).
+   * @param[in] top first row of scroll area.
+   * @param[in] height number of rows in scroll area.
+   * @return bool.
+   */
+  virtual bool set_scroll_area(uint16_t top, uint16_t height);
+
+  /**
+   * @override{Canvas}
+   * Set vertical scroll start (VSCRSADD).
+   * @param[in] row first row to show.
+   */
+  virtual void set_scroll_start(uint16_t row);
+
   /**
    * @override{Canvas}
    * Set pixel with current color.
@@ -101,6 +254,21 @@ public:
    */
   virtual void fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 
+  /**
+   * @override{Canvas}
+   * Draw character with current text color, font and scale. The
+   * character cell (including spacing) is drawn with one address
+   * window and the glyph bitmap is streamed with the text color and
+   * the canvas color as background; the cell is opaque. The cell is
+   * clipped to the canvas. Fonts wider than GLYPH_WIDTH_MAX are drawn
+   * with Canvas::draw_char().
+   * @param[in] x.
+   * @param[in] y.
+   * @param[in] c character.
+   */
+  virtual void draw_char(uint16_t x, uint16_t y, char c);
+  using Canvas::draw_char;
+
   /**
    * @override{Canvas}
    * Stop sequence of interaction with device.
@@ -109,9 +277,52 @@ public:
   virtual bool end();
 
 protected:
+  /** Max font width for the streamed glyph path (band buffer). */
+  static const uint8_t GLYPH_WIDTH_MAX = 32;
+
+  IO* m_io;			//!< Parallel bus adapter or NULL(SPI).
   OutputPin m_dc;		//!< Data/Command select pin.
   bool m_initiated;		//!< Initialization state.
 
+  /**
+   * Start interaction with device; acquire the SPI bus or select the
+   * device on the parallel bus.
+   */
+  void select()
+    __attribute__((always_inline))
+  {
+    if (m_io == NULL) {
+      spi.acquire(this);
+      spi.begin();
+    }
+    else m_cs.clear();
+  }
+
+  /**
+   * Stop interaction with device; release the SPI bus or deselect
+   * the device on the parallel bus.
+   */
+  void deselect()
+    __attribute__((always_inline))
+  {
+    if (m_io == NULL) {
+      spi.end();
+      spi.release();
+    }
+    else m_cs.set();
+  }
+
+  /**
+   * Write byte to device.
+   * @param[in] data to write.
+   */
+  void transfer(uint8_t data)
+    __attribute__((always_inline))
+  {
+    if (m_io == NULL) spi.transfer(data);
+    else m_io->write(data);
+  }
+
   /**
    * @override{GDDRAM}
    * Get initialization script (in program memory).
@@ -241,11 +452,35 @@ protected:
   void write(uint16_t data)
     __attribute__((always_inline))
   {
+    if (m_io != NULL) {
+      m_io->write(data);
+      return;
+    }
     spi.transfer_start(data >> 8);
     spi.transfer_next(data);
     spi.transfer_await();
   }
 
+  /**
+   * Stream given number of pixels with given color to device, MSB
+   * first. The SPI transfers are pipelined and unrolled; four pixels
+   * per loop. Should be called after select() and after the address
+   * window has been set.
+   * @param[in] color pixel color.
+   * @param[in] count number of pixels.
+   */
+  void fill(uint16_t color, uint32_t count);
+
+  /**
+   * Stream given buffer of pixels to device, MSB first. The bytes
+   * are swapped while streaming; the buffer is not modified. Should
+   * be called after select() and after the address window has been
+   * set.
+   * @param[in] buf pixel buffer.
+   * @param[in] count number of pixels.
+   */
+  void write(const color16_t* buf, size_t count);
+
   /**
    * Write given number of 16-bit data to device, MSB first.
    * @param[in] data to write.
@@ -255,6 +490,10 @@ protected:
   void write(uint16_t data, uint16_t count)
     __attribute__((always_inline))
   {
+    if (m_io != NULL) {
+      m_io->fill(data, count);
+      return;
+    }
     uint8_t high = data >> 8;
     uint8_t low = data;
     spi.transfer_start(high);
@@ -274,7 +513,7 @@ protected:
     __attribute__((always_inline))
   {
     asserted(m_dc) {
-      spi.transfer(cmd);
+      transfer(cmd);
     }
   }
 
@@ -287,9 +526,9 @@ protected:
     __attribute__((always_inline))
   {
     asserted(m_dc) {
-      spi.transfer(cmd);
+      transfer(cmd);
     }
-    spi.transfer(data);
+    transfer(data);
   }
 
   /**
@@ -301,11 +540,9 @@ protected:
     __attribute__((always_inline))
   {
     asserted(m_dc) {
-      spi.transfer(cmd);
+      transfer(cmd);
     }
-    spi.transfer_start(data >> 8);
-    spi.transfer_next(data);
-    spi.transfer_await();
+    write(data);
   }
 
   /**
@@ -318,7 +555,12 @@ protected:
     __attribute__((always_inline))
   {
     asserted(m_dc) {
-      spi.transfer(cmd);
+      transfer(cmd);
+    }
+    if (m_io != NULL) {
+      m_io->write(x);
+      m_io->write(y);
+      return;
     }
     spi.transfer_start(x >> 8);
     spi.transfer_next(x);
@@ -0,0 +1,160 @@
+/**
+ * @file GDDRAM_Port8b.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "Cosa/Board.hh"
+#if !defined(BOARD_ATTINY)
+#include "GDDRAM.hh"
+
+/**
+ * Pulse the write strobe; toggle low and high with the pin input
+ * register. The data is latched by the device on the rising edge.
+ * @param[in] wr pin input register.
+ * @param[in] mask pin mask.
+ */
+static inline void
+strobe(volatile uint8_t* wr, uint8_t mask)
+  __attribute__((always_inline));
+
+static inline void
+strobe(volatile uint8_t* wr, uint8_t mask)
+{
+  *wr = mask;
+  *wr = mask;
+}
+
+GDDRAM::Port8b::Port8b(Board::DigitalPin data, Board::DigitalPin wr) :
+  m_port(Pin::PORT(data)),
+  m_wr(Pin::PIN(wr)),
+  m_mask(Pin::MASK(wr))
+{
+  synchronized {
+    *m_port = 0;
+    *Pin::DDR(data) = 0xff;
+    *Pin::PORT(wr) |= m_mask;
+    *Pin::DDR(wr) |= m_mask;
+  }
+}
+
+void
+GDDRAM::Port8b::write(uint8_t data)
+{
+  *m_port = data;
+  strobe(m_wr, m_mask);
+}
+
+void
+GDDRAM::Port8b::write(uint16_t data)
+{
+  volatile uint8_t* port = m_port;
+  volatile uint8_t* wr = m_wr;
+  const uint8_t mask = m_mask;
+  *port = data >> 8;
+  strobe(wr, mask);
+  *port = data;
+  strobe(wr, mask);
+}
+
+void
+GDDRAM::Port8b::fill(uint16_t color, uint32_t count)
+{
+  // Use local copies of the registers; the port stores may alias
+  volatile uint8_t* port = m_port;
+  volatile uint8_t* wr = m_wr;
+  const uint8_t mask = m_mask;
+  uint8_t high = color >> 8;
+  uint8_t low = color;
+  uint8_t n = count & 0x03;
+  count >>= 2;
+
+  // Same high and low byte; set the bus once and only strobe
+  if (high == low) {
+    *port = high;
+    while (n--) {
+      strobe(wr, mask);
+      strobe(wr, mask);
+    }
+    for (; count != 0; count--) {
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+      strobe(wr, mask);
+    }
+    return;
+  }
+
+  // Otherwise write high and low byte per pixel
+  while (n--) {
+    *port = high;
+    strobe(wr, mask);
+    *port = low;
+    strobe(wr, mask);
+  }
+  for (; count != 0; count--) {
+    *port = high;
+    strobe(wr, mask);
+    *port = low;
+    strobe(wr, mask);
+    *port = high;
+    strobe(wr, mask);
+    *port = low;
+    strobe(wr, mask);
+    *port = high;
+    strobe(wr, mask);
+    *port = low;
+    strobe(wr, mask);
+    *port = high;
+    strobe(wr, mask);
+    *port = low;
+    strobe(wr, mask);
+  }
+}
+
+void
+GDDRAM::Port8b::write(const color16_t* buf, size_t count)
+{
+  // Pixels are stored little-endian; write MSB first
+  volatile uint8_t* port = m_port;
+  volatile uint8_t* wr = m_wr;
+  const uint8_t mask = m_mask;
+  const uint8_t* bp = (const uint8_t*) buf;
+  if (count & 0x01) {
+    *port = bp[1];
+    strobe(wr, mask);
+    *port = bp[0];
+    strobe(wr, mask);
+    bp += 2;
+  }
+  for (count >>= 1; count != 0; count--) {
+    *port = bp[1];
+    strobe(wr, mask);
+    *port = bp[0];
+    strobe(wr, mask);
+    *port = bp[3];
+    strobe(wr, mask);
+    *port = bp[2];
+    strobe(wr, mask);
+    bp += 4;
+  }
+}
+#endif
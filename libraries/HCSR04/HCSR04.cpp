@@ -40,8 +40,8 @@ HCSR04::read(uint16_t& distance)
   }
   if (timeout == 0) return (false);
 
-  // And calculate the distance in milli-meters
-  distance = (count * 100L) / COUNT_PER_DM;
+  // And calculate the distance in milli-meters; scale instead of divide
+  distance = Fixed::umulhi(count, MM_PER_COUNT);
   return (true);
 }
 
@@ -59,3 +59,127 @@ HCSR04::on_event(uint8_t type, uint16_t value)
   m_distance = distance;
   on_change(distance);
 }
+
+void
+HCSR04::Sensor::fire()
+{
+  m_start = 0L;
+  enable();
+  m_trigger.pulse(10);
+}
+
+void
+HCSR04::Sensor::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  uint32_t now = RTT::micros();
+
+  // Timestamp the start of the echo pulse
+  if (is_set()) {
+    m_start = now;
+    return;
+  }
+
+  // Ignore falling edge without start; signal the echo width
+  if (UNLIKELY(m_start == 0L)) return;
+  disable();
+  Event::push(Event::CHANGE_TYPE, m_ranger, now - m_start);
+}
+
+void
+HCSR04::Sensor::sample(uint16_t width)
+{
+  // Add the distance to the sample buffer
+  m_sample[m_ix] = Fixed::umulhi(width, MM_PER_US);
+  if (++m_ix == SAMPLE_MAX) m_ix = 0;
+
+  // Median of the latest samples; insertion sort of a copy
+  uint16_t value[SAMPLE_MAX];
+  for (uint8_t i = 0; i < SAMPLE_MAX; i++) {
+    uint16_t v = m_sample[i];
+    uint8_t j = i;
+    for (; j > 0 && value[j - 1] > v; j--) value[j] = value[j - 1];
+    value[j] = v;
+  }
+  uint16_t distance = value[SAMPLE_MAX / 2];
+
+  // Check if there was a change
+  if (distance == m_distance) return;
+  m_distance = distance;
+  on_change(distance);
+}
+
+bool
+HCSR04::Ranger::attach(Sensor* sensor)
+{
+  if (UNLIKELY(sensor->m_ranger != NULL)) return (false);
+  sensor->m_ranger = this;
+  if (m_last == NULL)
+    m_first = sensor;
+  else
+    m_last->m_next = sensor;
+  m_last = sensor;
+  return (true);
+}
+
+void
+HCSR04::Ranger::begin()
+{
+  m_current = NULL;
+  m_ranging = false;
+  schedule(0);
+}
+
+void
+HCSR04::Ranger::end()
+{
+  stop();
+  if (m_current != NULL) m_current->disable();
+  m_current = NULL;
+  m_ranging = false;
+}
+
+void
+HCSR04::Ranger::schedule(uint16_t us)
+{
+  stop();
+  expire_at(time());
+  expire_after(us);
+  start();
+}
+
+void
+HCSR04::Ranger::on_event(uint8_t type, uint16_t value)
+{
+  // Echo width from the current sensor; filter and start guard time
+  if (type == Event::CHANGE_TYPE) {
+    if (UNLIKELY(!m_ranging)) return;
+    m_ranging = false;
+    m_current->sample(value);
+    schedule(m_guard);
+    return;
+  }
+
+  // Ignore timeout events from a rescheduled job
+  if (type == Event::TIMEOUT_TYPE && expire_after() <= 0) run();
+}
+
+void
+HCSR04::Ranger::run()
+{
+  // Echo timeout; no object in range. Wait for guard time
+  if (m_ranging) {
+    m_ranging = false;
+    m_current->disable();
+    schedule(m_guard);
+    return;
+  }
+
+  // Fire the next sensor in the sequence
+  if (UNLIKELY(m_first == NULL)) return;
+  m_current = (m_current == NULL || m_current->m_next == NULL) ?
+    m_first : m_current->m_next;
+  m_ranging = true;
+  m_current->fire();
+  schedule(m_timeout);
+}
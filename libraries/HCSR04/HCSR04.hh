@@ -22,10 +22,13 @@
 #define COSA_HCSR04_HH
 
 #include "Cosa/Types.h"
+#include "Cosa/Fixed.hh"
 #include "Cosa/InputPin.hh"
 #include "Cosa/OutputPin.hh"
 #include "Cosa/Periodic.hh"
+#include "Cosa/PinChangeInterrupt.hh"
 #include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
 
 /**
  * Device driver for Ultrasonic range module HC-SR04. Subclass and
@@ -47,7 +50,8 @@
  *
  * @section Limitations
  * The driver will turn off interrupt handling during data read
- * from the device.
+ * from the device. Use HCSR04::Ranger and HCSR04::Sensor for non-
+ * blocking measurement with several devices.
  */
 class HCSR04 : public Periodic {
 public:
@@ -107,6 +111,192 @@ public:
     UNUSED(distance);
   }
 
+  class Ranger;
+
+  /**
+   * Non-blocking HC-SR04 device for HCSR04::Ranger. The echo pin must
+   * be a pin change interrupt pin; the echo pulse width is measured
+   * with RTT::micros() timestamps on the edges. The latest samples
+   * are median filtered. PinChangeInterrupt::begin() and RTT::begin()
+   * must be called.
+   */
+  class Sensor : public PinChangeInterrupt {
+  public:
+    /**
+     * Construct ranging sensor with given trigger and echo pin.
+     * @param[in] trigger trigger pin.
+     * @param[in] echo echo interrupt pin.
+     */
+    Sensor(Board::DigitalPin trigger, Board::InterruptPin echo) :
+      PinChangeInterrupt(echo, ON_CHANGE_MODE),
+      m_trigger(trigger),
+      m_next(NULL),
+      m_ranger(NULL),
+      m_start(0),
+      m_ix(0),
+      m_distance(0)
+    {
+      memset(m_sample, 0, sizeof(m_sample));
+    }
+
+    /**
+     * Latest median filtered distance reading.
+     * @return distance in millimeters.
+     */
+    uint16_t distance() const
+    {
+      return (m_distance);
+    }
+
+    /**
+     * @override{HCSR04::Sensor}
+     * Default on change function. Override for callback when the
+     * filtered distance has changed.
+     * @param[in] distance in milli-meters.
+     */
+    virtual void on_change(uint16_t distance)
+    {
+      UNUSED(distance);
+    }
+
+  protected:
+    /** Number of samples in median filter. */
+    static const uint8_t SAMPLE_MAX = 3;
+
+    /** Trigger output pin. */
+    OutputPin m_trigger;
+
+    /** Next sensor in ranging sequence. */
+    Sensor* m_next;
+
+    /** Ranger to signal echo width. */
+    Ranger* m_ranger;
+
+    /** Echo rising edge timestamp (us). */
+    volatile uint32_t m_start;
+
+    /** Latest samples (mm) and next index. */
+    uint16_t m_sample[SAMPLE_MAX];
+    uint8_t m_ix;
+
+    /** Latest filtered distance (mm). */
+    uint16_t m_distance;
+
+    /**
+     * Enable echo detection and give the device a trigger pulse.
+     */
+    void fire();
+
+    /**
+     * Add echo pulse width to the median filter and call on_change()
+     * if the filtered distance has changed.
+     * @param[in] width echo pulse width (us).
+     */
+    void sample(uint16_t width);
+
+    /**
+     * @override{Interrupt::Handler}
+     * Timestamp echo rising edge. On falling edge disable and signal
+     * the echo width to the ranger.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg);
+
+    friend class Ranger;
+  };
+
+  /**
+   * Ranging scheduler for several HC-SR04 devices. The sensors are
+   * fired one at a time in the attach order. The next sensor is
+   * fired a guard time after the echo, or after the echo timeout,
+   * of the previous sensor so that late echoes do not cause cross-
+   * talk. Measurement is interrupt and event driven; there is no
+   * busy-wait. Requires a micro-second scheduler (RTT::Scheduler).
+   */
+  class Ranger : public Job {
+  public:
+    /** Default guard time between sensors (us). */
+    static const uint16_t GUARD_DEFAULT = 10000;
+
+    /** Default echo timeout (us); approx. 4 m range. */
+    static const uint16_t TIMEOUT_DEFAULT = 25000;
+
+    /**
+     * Construct ranging scheduler with given job scheduler, guard
+     * time and echo timeout.
+     * @param[in] scheduler micro-second job scheduler.
+     * @param[in] guard time between sensors (Default GUARD_DEFAULT).
+     * @param[in] timeout echo timeout (Default TIMEOUT_DEFAULT).
+     */
+    Ranger(Job::Scheduler* scheduler,
+	   uint16_t guard = GUARD_DEFAULT,
+	   uint16_t timeout = TIMEOUT_DEFAULT) :
+      Job(scheduler),
+      m_first(NULL),
+      m_last(NULL),
+      m_current(NULL),
+      m_guard(guard),
+      m_timeout(timeout),
+      m_ranging(false)
+    {}
+
+    /**
+     * Append given sensor to the ranging sequence. Return true(1) if
+     * successful otherwise false(0) if already attached.
+     * @param[in] sensor to append.
+     * @return bool.
+     */
+    bool attach(Sensor* sensor);
+
+    /**
+     * Set guard time between sensors.
+     * @param[in] us guard time.
+     */
+    void guard(uint16_t us)
+    {
+      m_guard = us;
+    }
+
+    /**
+     * Start ranging sequence.
+     */
+    void begin();
+
+    /**
+     * Stop ranging sequence.
+     */
+    void end();
+
+  protected:
+    Sensor* m_first;		//!< First sensor in sequence.
+    Sensor* m_last;		//!< Last sensor in sequence.
+    Sensor* m_current;		//!< Current sensor.
+    uint16_t m_guard;		//!< Guard time (us).
+    uint16_t m_timeout;		//!< Echo timeout (us).
+    bool m_ranging;		//!< Waiting for echo.
+
+    /**
+     * Schedule job after given time from now.
+     * @param[in] us micro-seconds.
+     */
+    void schedule(uint16_t us);
+
+    /**
+     * @override{Event::Handler}
+     * Handle echo width (CHANGE_TYPE) from current sensor and
+     * timeout events.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+
+    /**
+     * @override{Job}
+     * Echo timeout or guard time expired; fire next sensor.
+     */
+    virtual void run();
+  };
+
 private:
   /** Timeout on failed to detect echo. */
   static const uint16_t TIMEOUT = 0xffffU;
@@ -114,6 +304,13 @@ private:
   /** Count per decimeter. */
   static const uint16_t COUNT_PER_DM = (555 * I_CPU) / 16;
 
+  /** Milli-meter per count scale factor (Q0.16). */
+  static const uint16_t MM_PER_COUNT =
+    (100 * 65536UL + COUNT_PER_DM / 2) / COUNT_PER_DM;
+
+  /** Milli-meter per micro-second echo scale factor (Q0.16). */
+  static const uint16_t MM_PER_US = 11239;
+
   /** Trigger output pin. */
   OutputPin m_trigger;
 
@@ -0,0 +1,88 @@
+/**
+ * @file CosaHCSR04Ranger.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of non-blocking ranging with several HC-SR04
+ * modules. The sensors are fired in sequence with a guard time.
+ *
+ * @section Circuit
+ * @code
+ *                           HC-SR04 (left)
+ *                       +------------+
+ * (VCC)---------------1-|VCC         |
+ * (D2)----------------2-|TRIG        |
+ * (D10/PCI2)----------3-|ECHO        |
+ * (GND)---------------4-|GND         |
+ *                       +------------+
+ *                           HC-SR04 (right)
+ *                       +------------+
+ * (VCC)---------------1-|VCC         |
+ * (D3)----------------2-|TRIG        |
+ * (D11/PCI3)----------3-|ECHO        |
+ * (GND)---------------4-|GND         |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <HCSR04.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+class Ping : public HCSR04::Sensor {
+public:
+  Ping(Board::DigitalPin trigger, Board::InterruptPin echo, char id) :
+    HCSR04::Sensor(trigger, echo),
+    m_id(id)
+  {}
+  virtual void on_change(uint16_t distance)
+  {
+    trace << m_id << ':' << distance << endl;
+  }
+private:
+  char m_id;
+};
+
+RTT::Scheduler scheduler;
+HCSR04::Ranger ranger(&scheduler);
+Ping left(Board::D2, Board::PCI2, 'L');
+Ping right(Board::D3, Board::PCI3, 'R');
+
+void setup()
+{
+  // Start trace output stream on the serial port
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaHCSR04Ranger: started"));
+
+  // Start the real-time clock and pin change interrupt handler
+  RTT::begin();
+  PinChangeInterrupt::begin();
+
+  // Ranging sequence; left and right
+  ranger.attach(&left);
+  ranger.attach(&right);
+  ranger.begin();
+}
+
+void loop()
+{
+  Event::service();
+}
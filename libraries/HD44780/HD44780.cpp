@@ -101,6 +101,11 @@ HD44780::display_clear()
   m_x = 0;
   m_y = 0;
   m_mode |= INCREMENT;
+  if (m_shadow != NULL) {
+    uint8_t count = WIDTH * HEIGHT;
+    memset(m_shadow, ' ', count);
+    memset(m_dirty, 0, (count + 7) / 8);
+  }
   DELAY(LONG_EXEC_TIME);
 }
 
@@ -118,8 +123,7 @@ HD44780::set_cursor(uint8_t x, uint8_t y)
 {
   if (x >= WIDTH) x = 0;
   if (y >= HEIGHT) y = 0;
-  uint8_t offset = (uint8_t) pgm_read_byte(&m_offset[y]);
-  write(SET_DDRAM_ADDR | ((x + offset) & SET_DDRAM_MASK));
+  if (m_shadow == NULL) set_address(x, y);
   m_x = x;
   m_y = y;
 }
@@ -127,13 +131,8 @@ HD44780::set_cursor(uint8_t x, uint8_t y)
 void
 HD44780::set_custom_char(uint8_t id, const uint8_t* bitmap)
 {
-  write(SET_CGRAM_ADDR | ((id << 3) & SET_CGRAM_MASK));
-  set_data_mode();
-  {
-    for (uint8_t i = 0; i < BITMAP_MAX; i++)
-      write(*bitmap++);
-  }
-  set_instruction_mode();
+  m_io->write8n(SET_CGRAM_ADDR | ((id << 3) & SET_CGRAM_MASK),
+		bitmap, BITMAP_MAX);
 }
 
 void
@@ -165,11 +164,16 @@ HD44780::putchar(char c)
       uint8_t x, y;
       set_cursor(0, m_y + 1);
       get_cursor(x, y);
-      set_data_mode();
-      {
-	for (uint8_t i = 0; i < WIDTH; i++) write(' ');
+      if (m_shadow != NULL) {
+	for (uint8_t i = 0; i < WIDTH; i++) shadow_put(' ');
+      }
+      else {
+	set_data_mode();
+	{
+	  for (uint8_t i = 0; i < WIDTH; i++) write(' ');
+	}
+	set_instruction_mode();
       }
-      set_instruction_mode();
       set_cursor(x, y);
       return (c);
     }
@@ -182,9 +186,18 @@ HD44780::putchar(char c)
       return (c);
     }
 
-    // Form-feed: clear the display
+    // Form-feed: clear the display (or the shadow buffer)
     if (c == '\f') {
-      display_clear();
+      if (m_shadow != NULL) {
+	for (uint8_t y = 0; y < HEIGHT; y++) {
+	  set_cursor(0, y);
+	  for (uint8_t i = 0; i < WIDTH; i++) shadow_put(' ');
+	}
+	set_cursor(0, 0);
+      }
+      else {
+	display_clear();
+      }
       return (c);
     }
 
@@ -205,6 +218,10 @@ HD44780::putchar(char c)
 
   // Write character
   if (m_x == WIDTH) putchar('\n');
+  if (m_shadow != NULL) {
+    shadow_put(c);
+    return (c & 0xff);
+  }
   m_x += 1;
   set_data_mode();
   {
@@ -218,6 +235,11 @@ HD44780::putchar(char c)
 int
 HD44780::write(const void* buf, size_t size)
 {
+  if (m_shadow != NULL) {
+    const uint8_t* bp = (const uint8_t*) buf;
+    for (size_t i = 0; i < size; i++) shadow_put(*bp++);
+    return (size);
+  }
   set_data_mode();
   {
     m_io->write8n(buf, size);
@@ -227,3 +249,57 @@ HD44780::write(const void* buf, size_t size)
   return (size);
 }
 
+
+bool
+HD44780::set_shadow(uint8_t* buf, size_t size)
+{
+  if (buf == NULL) {
+    if (m_shadow != NULL) set_address(m_x, m_y);
+    m_shadow = NULL;
+    m_dirty = NULL;
+    return (true);
+  }
+  if (size < shadow_size(WIDTH, HEIGHT)) return (false);
+  uint8_t count = WIDTH * HEIGHT;
+  memset(buf, ' ', count);
+  m_shadow = buf;
+  m_dirty = buf + count;
+  memset(m_dirty, 0xff, (count + 7) / 8);
+  return (true);
+}
+
+int
+HD44780::flush()
+{
+  if (m_shadow == NULL) return (0);
+  bool sent = false;
+  for (uint8_t y = 0; y < HEIGHT; y++) {
+    uint8_t row = y * WIDTH;
+    uint8_t x = 0;
+    while (x < WIDTH) {
+      if (!is_dirty(row + x)) {
+	x += 1;
+	continue;
+      }
+      // Find the run of changed characters. A single unchanged
+      // character is included as it costs less than a cursor setting
+      uint8_t end = x + 1;
+      while (end < WIDTH) {
+	if (is_dirty(row + end))
+	  end += 1;
+	else if ((end + 1 < WIDTH) && is_dirty(row + end + 1))
+	  end += 2;
+	else break;
+      }
+      m_io->write8n(address(x, y), &m_shadow[row + x], end - x);
+      for (uint8_t ix = row + x; ix < row + end; ix++)
+	m_dirty[ix >> 3] &= ~_BV(ix & 0x07);
+      sent = true;
+      x = end;
+    }
+  }
+
+  // Restore the display cursor position
+  if (sent) set_address(m_x, m_y);
+  return (0);
+}
@@ -24,6 +24,7 @@
 #include "Cosa/SPI.hh"
 #include "Cosa/LCD.hh"
 #include "Cosa/OutputPin.hh"
+#include "Cosa/OutputPins.hh"
 
 /**
  * HD44780 (LCD-II) Dot Matix Liquid Crystal Display Controller/Driver
@@ -73,6 +74,17 @@ public:
      */
     virtual void write8n(const void* buf, size_t size);
 
+    /**
+     * @override{HD44780::IO}
+     * Write instruction followed by character buffer to display.
+     * Called and returns in instruction mode. Allows adapters to send
+     * the instruction and data in a single transfer.
+     * @param[in] cmd instruction.
+     * @param[in] buf pointer to buffer.
+     * @param[in] size number of bytes in buffer.
+     */
+    virtual void write8n(uint8_t cmd, const void* buf, size_t size);
+
     /**
      * @override{HD44780::IO}
      * Set data/command mode; zero(0) for command,
@@ -113,7 +125,9 @@ public:
     m_mode(ENTRY_MODE_SET | INCREMENT),
     m_cntl(CONTROL_SET),
     m_func(FUNCTION_SET | DATA_LENGTH_4BITS | NR_LINES_2 | FONT_5X8DOTS),
-    m_offset((height == 4) && (width == 16) ? offset1 : offset0)
+    m_offset((height == 4) && (width == 16) ? offset1 : offset0),
+    m_shadow(NULL),
+    m_dirty(NULL)
   {}
 
   /**
@@ -309,6 +323,47 @@ public:
    */
   virtual int write(const void* buf, size_t size);
 
+  /**
+   * Return size of shadow buffer for display with given width and
+   * height; characters and changed character bitset.
+   * @param[in] width of display.
+   * @param[in] height of display.
+   * @return number of bytes.
+   */
+  static constexpr size_t shadow_size(uint8_t width, uint8_t height)
+  {
+    return ((width * height) + ((width * height + 7) / 8));
+  }
+
+  /**
+   * Set shadow display buffer. When set the output is written to the
+   * buffer and flush() will send only the changed characters to the
+   * display; consecutive characters as a single cursor setting and
+   * write. The buffer should be at least shadow_size(). The display
+   * content is assumed unknown and all characters are sent on the
+   * first flush(). Returns true(1) if successful otherwise false(0).
+   * Passing NULL will disable the shadow buffer.
+   * @param[in] buf shadow buffer.
+   * @param[in] size of buffer.
+   * @return bool.
+   * @section Limitations
+   * Only left-to-right text flow without display shift is supported.
+   * @code
+   * uint8_t shadow[HD44780::shadow_size(20, 4)];
+   * ...
+   * lcd.set_shadow(shadow, sizeof(shadow));
+   * @endcode
+   */
+  bool set_shadow(uint8_t* buf, size_t size);
+
+  /**
+   * @override{IOStream::Device}
+   * Send changed characters in the shadow buffer to the display.
+   * Returns zero(0).
+   * @return zero(0) or negative error code.
+   */
+  virtual int flush();
+
 #if !defined(BOARD_ATTINYX5)
   /**
    * HD44780 (LCD-II) Dot Matix Liquid Crystal Display Controller/Driver
@@ -368,14 +423,16 @@ public:
 	   Board::DigitalPin rs = Board::D8,
 	   Board::DigitalPin en = Board::D9,
 	   Board::DigitalPin bt = Board::D10) :
-      m_d0(d0, 0),
-      m_d1(d1, 0),
-      m_d2(d2, 0),
-      m_d3(d3, 0),
+      m_data(),
       m_rs(rs, 0),
       m_en(en, 0),
       m_bt(bt, 1)
-    {}
+    {
+      m_data.attach(0, d0);
+      m_data.attach(1, d1);
+      m_data.attach(2, d2);
+      m_data.attach(3, d3);
+    }
 
     /**
      * @override{HD44780::IO}
@@ -417,10 +474,14 @@ public:
     /** Execution time delay (us). */
     static const uint16_t SHORT_EXEC_TIME = 32;
 
-    OutputPin m_d0;		//!< Data pin; d0.
-    OutputPin m_d1;		//!< Data pin; d1.
-    OutputPin m_d2;		//!< Data pin; d2.
-    OutputPin m_d3;		//!< Data pin; d3.
+    /** Max number of ports for data pins. */
+#if defined(BOARD_ATTINY)
+    static const uint8_t DATA_PORTS = 2;
+#else
+    static const uint8_t DATA_PORTS = 4;
+#endif
+
+    OutputPins<4, DATA_PORTS> m_data; //!< Data pins; d0..d3.
     OutputPin m_rs;		//!< Register select (0/instruction, 1/data).
     OutputPin m_en;		//!< Starts data read/write.
     OutputPin m_bt;		//!< Back-light control (0/on, 1/off).
@@ -911,6 +972,59 @@ public:
   uint8_t m_cntl;		//!< Control.
   uint8_t m_func;		//!< Function set.
   const uint8_t* m_offset;	//!< Row offset table.
+  uint8_t* m_shadow;		//!< Shadow display buffer or NULL.
+  uint8_t* m_dirty;		//!< Changed characters in shadow buffer.
+
+  /**
+   * Return set display data address instruction for the given
+   * position.
+   * @param[in] x.
+   * @param[in] y.
+   * @return instruction.
+   */
+  uint8_t address(uint8_t x, uint8_t y)
+  {
+    uint8_t offset = (uint8_t) pgm_read_byte(&m_offset[y]);
+    return (SET_DDRAM_ADDR | ((x + offset) & SET_DDRAM_MASK));
+  }
+
+  /**
+   * Set display data address to the given position.
+   * @param[in] x.
+   * @param[in] y.
+   */
+  void set_address(uint8_t x, uint8_t y)
+  {
+    write(address(x, y));
+  }
+
+  /**
+   * Write character to shadow buffer at the cursor position and
+   * mark it as changed. Characters beyond the line are ignored.
+   * Advance the cursor.
+   * @param[in] c character to write.
+   */
+  void shadow_put(uint8_t c)
+  {
+    if (m_x < WIDTH) {
+      uint8_t ix = (m_y * WIDTH) + m_x;
+      if (m_shadow[ix] != c) {
+	m_shadow[ix] = c;
+	m_dirty[ix >> 3] |= _BV(ix & 0x07);
+      }
+    }
+    m_x += 1;
+  }
+
+  /**
+   * Check if character at given index in shadow buffer has changed.
+   * @param[in] ix character index.
+   * @return bool.
+   */
+  bool is_dirty(uint8_t ix) const
+  {
+    return ((m_dirty[ix >> 3] & _BV(ix & 0x07)) != 0);
+  }
 
   /**
    * Write data or command to display.
@@ -34,3 +34,11 @@ HD44780::IO::write8n(const void* buf, size_t size)
   while (size--) write8b(*bp++);
 }
 
+void
+HD44780::IO::write8n(uint8_t cmd, const void* buf, size_t size)
+{
+  write8b(cmd);
+  set_mode(1);
+  write8n(buf, size);
+  set_mode(0);
+}
@@ -32,10 +32,7 @@ void
 HD44780::Port4b::write4b(uint8_t data)
 {
   synchronized {
-    m_d0._set(data & 0x01);
-    m_d1._set(data & 0x02);
-    m_d2._set(data & 0x04);
-    m_d3._set(data & 0x08);
+    m_data._write(data);
     m_en._toggle();
     m_en._toggle();
   }
@@ -45,16 +42,10 @@ void
 HD44780::Port4b::write8b(uint8_t data)
 {
   synchronized {
-    m_d0._set(data & 0x10);
-    m_d1._set(data & 0x20);
-    m_d2._set(data & 0x40);
-    m_d3._set(data & 0x80);
+    m_data._write(data >> 4);
     m_en._toggle();
     m_en._toggle();
-    m_d0._set(data & 0x01);
-    m_d1._set(data & 0x02);
-    m_d2._set(data & 0x04);
-    m_d3._set(data & 0x08);
+    m_data._write(data);
     m_en._toggle();
     m_en._toggle();
   }
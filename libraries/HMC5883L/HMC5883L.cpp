@@ -98,6 +98,18 @@ HMC5883L::read_heading()
   return (true);
 }
 
+#if !defined(BOARD_ATTINY)
+void
+HMC5883L::Source::on_decode()
+{
+  swap<Sensor::sample_t>(&m_sample);
+  m_overflow =
+    (m_sample.x == -4096) ||
+    (m_sample.y == -4096) ||
+    (m_sample.z == -4096);
+}
+#endif
+
 void
 HMC5883L::to_milli_gauss()
 {
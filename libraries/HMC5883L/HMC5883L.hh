@@ -22,6 +22,7 @@
 #define COSA_HMC5883L_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/Sensor.hh"
 #include "Cosa/Power.hh"
 #include "Cosa/IOStream.hh"
 
@@ -316,6 +317,57 @@ public:
    */
   void to_milli_gauss();
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Magnetometer sample source for Sensor::Stream; burst read of the
+   * output registers. The device should be in continuous measurement
+   * mode. Decoding adjusts byte order and checks overflow.
+   */
+  class Source : public Sensor::Source {
+  public:
+    /**
+     * Construct sample source for given magnetometer.
+     * @param[in] dev magnetometer driver.
+     */
+    Source(HMC5883L* dev) :
+      Sensor::Source(dev, OUTPUT, &m_sample, sizeof(m_sample)),
+      m_overflow(false)
+    {}
+
+    /**
+     * Return latest sample.
+     * @return sample.
+     */
+    const Sensor::sample_t& sample() const
+    {
+      return (m_sample);
+    }
+
+    /**
+     * Returns true(1) if the latest sample contained an overflow on
+     * any of the channels.
+     * @return bool.
+     */
+    bool is_overflow() const
+    {
+      return (m_overflow);
+    }
+
+    /**
+     * @override{Sensor::Source}
+     * Adjust to little endian and check overflow.
+     */
+    virtual void on_decode();
+
+  protected:
+    /** Latest sample. */
+    Sensor::sample_t m_sample;
+
+    /** Overflow in latest sample. */
+    bool m_overflow;
+  };
+#endif
+
 protected:
   /**
    * Register List (Table 2, pp 11).
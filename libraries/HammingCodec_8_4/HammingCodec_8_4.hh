@@ -79,6 +79,18 @@ public:
     return ((symbol & 0x01) ? (code & 0x0f) : (code >> 4));
   }
 
+  /**
+   * @override{VWI::Codec}
+   * Returns 8-bit data for given two packed symbols. Inline decode
+   * without virtual dispatch per symbol.
+   * @return 8-bit data.
+   */
+  virtual uint8_t decode8(uint16_t symbol)
+  {
+    return ((HammingCodec_8_4::decode4(symbol) << 4) |
+	    (HammingCodec_8_4::decode4(symbol >> BITS_PER_SYMBOL)));
+  }
+
 private:
   /** Symbol mapping table: 4 to 8 bits. */
   static const uint8_t s_symbols[] PROGMEM;
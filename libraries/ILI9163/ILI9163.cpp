@@ -80,6 +80,13 @@ ILI9163::ILI9163(Board::DigitalPin cs, Board::DigitalPin dc) :
 {
 }
 
+#if !defined(BOARD_ATTINY)
+ILI9163::ILI9163(GDDRAM::IO* io, Board::DigitalPin cs, Board::DigitalPin dc) :
+  GDDRAM(SCREEN_WIDTH, SCREEN_HEIGHT, io, cs, dc)
+{
+}
+#endif
+
 uint8_t
 ILI9163::set_orientation(uint8_t direction)
 {
@@ -95,10 +102,8 @@ ILI9163::set_orientation(uint8_t direction)
   else {
     setting = MADCTL_MX | MADCTL_MY | MADCTL_BGR;
   }
-  spi.acquire(this);
-    spi.begin();
-      write(MADCTL, setting);
-    spi.end();
-  spi.release();
+  select();
+    write(MADCTL, setting);
+  deselect();
   return (previous);
 }
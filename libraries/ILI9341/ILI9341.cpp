@@ -100,3 +100,10 @@ ILI9341::ILI9341(Board::DigitalPin cs, Board::DigitalPin dc) :
   GDDRAM(SCREEN_WIDTH, SCREEN_HEIGHT, cs, dc)
 {
 }
+
+#if !defined(BOARD_ATTINY)
+ILI9341::ILI9341(GDDRAM::IO* io, Board::DigitalPin cs, Board::DigitalPin dc) :
+  GDDRAM(SCREEN_WIDTH, SCREEN_HEIGHT, io, cs, dc)
+{
+}
+#endif
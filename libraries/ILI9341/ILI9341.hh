@@ -72,6 +72,19 @@ public:
 	  Board::DigitalPin dc = Board::D9);
 #endif
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Construct ILI9341 canvas object with given parallel bus adapter
+   * and control pins.
+   * @param[in] io parallel bus adapter.
+   * @param[in] cs chip select pin (default pin 10).
+   * @param[in] dc data/command selection pin (default pin 9).
+   */
+  ILI9341(GDDRAM::IO* io,
+	  Board::DigitalPin cs = Board::D10,
+	  Board::DigitalPin dc = Board::D9);
+#endif
+
   /**
    * Screen size (width and height).
    */
@@ -93,3 +93,220 @@ IOStream& operator<<(IOStream& outs, IR::Receiver& receiver)
     outs << ix << ':' << receiver.m_sample[ix] << endl;
   return (outs);
 }
+
+#if !defined(BOARD_ATTINY)
+IR::Capture::Capture(Job::Scheduler* scheduler, uint32_t gap) :
+  InputCapture(InputCapture::ON_FALLING_MODE),
+  Job(scheduler),
+  m_gap(gap),
+  m_last(0),
+  m_hash(FNV_OFFSET),
+  m_start(0),
+  m_width(0),
+  m_edges(0)
+{
+}
+
+void
+IR::Capture::reset()
+{
+  // Remove from any queue
+  stop();
+
+  // Initial state; the receiver output is active low
+  synchronized {
+    TCCR1B = (TCCR1B & ~(_BV(CS12) | _BV(CS11) | _BV(CS10)))
+      | _BV(CS11) | _BV(CS10);
+    mode(InputCapture::ON_FALLING_MODE);
+    m_edges = 0;
+    m_width = 0;
+    m_hash = FNV_OFFSET;
+    InputCapture::clear();
+  }
+  enable();
+}
+
+void
+IR::Capture::end()
+{
+  disable();
+  stop();
+}
+
+void
+IR::Capture::on_interrupt(uint16_t arg)
+{
+  // Capture the other edge next
+  if (mode() == InputCapture::ON_FALLING_MODE)
+    mode(InputCapture::ON_RISING_MODE);
+  else
+    mode(InputCapture::ON_FALLING_MODE);
+  InputCapture::clear();
+
+  // Width since the previous edge
+  uint16_t width = arg - m_start;
+  m_start = arg;
+  m_last = time();
+
+  // First edge; start of code and gap timeout
+  if (m_edges == 0) {
+    m_edges = 1;
+    expire_at(m_last + m_gap);
+    start();
+    return;
+  }
+
+  // Normalize the width relative the previous width; shorter(0),
+  // same(1) or longer(2), and hash
+  if (m_width != 0) {
+    uint32_t curr = width;
+    uint32_t prev = m_width;
+    uint8_t value = 1;
+    if (curr * 4 < prev * 3) value = 0;
+    else if (curr * 3 > prev * 4) value = 2;
+    m_hash = (m_hash ^ value) * FNV_PRIME;
+  }
+  m_width = width;
+  if (m_edges != UINT8_MAX) m_edges += 1;
+}
+
+void
+IR::Capture::on_expired()
+{
+  // Check if there has been an edge during the gap time
+  uint32_t last = m_last;
+  if ((time() - last) < m_gap) {
+    expire_at(last + m_gap);
+    start();
+    return;
+  }
+
+  // End of code; disable capture and push event
+  disable();
+  Event::push(Event::READ_COMPLETED_TYPE, this);
+}
+
+void
+IR::Capture::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (type != Event::READ_COMPLETED_TYPE) return;
+  if (m_edges >= EDGES_MIN) on_code(m_hash);
+  reset();
+}
+#endif
+
+int
+IR::Keymap::begin()
+{
+  uint8_t count;
+  int res = m_eeprom->read(&count, m_addr);
+  if (UNLIKELY(res < 0)) return (res);
+  if (UNLIKELY(count > m_max)) return (clear());
+  m_count = count;
+  return (count);
+}
+
+bool
+IR::Keymap::search(uint32_t code, uint8_t& ix)
+{
+  uint8_t low = 0;
+  uint8_t high = m_count;
+  while (low < high) {
+    uint8_t mid = (low + high) / 2;
+    uint32_t value;
+    m_eeprom->read(&value, &entry(mid)->code);
+    if (value == code) {
+      ix = mid;
+      return (true);
+    }
+    if (value < code)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  ix = low;
+  return (false);
+}
+
+int
+IR::Keymap::lookup(uint32_t code)
+{
+  uint8_t ix;
+  if (!search(code, ix)) return (-1);
+  char key;
+  m_eeprom->read(&key, &entry(ix)->key);
+  return (key);
+}
+
+int
+IR::Keymap::learn(uint32_t code, char key)
+{
+  uint8_t ix;
+  int res;
+
+  // Update key of existing entry
+  if (search(code, ix)) return (m_eeprom->write(&entry(ix)->key, key));
+  if (UNLIKELY(m_count == m_max)) return (ENOSPC);
+
+  // Move the larger entries and insert
+  entry_t e;
+  for (uint8_t i = m_count; i > ix; i--) {
+    res = m_eeprom->read(&e, entry(i - 1), sizeof(e));
+    if (UNLIKELY(res < 0)) return (res);
+    res = m_eeprom->write(entry(i), &e, sizeof(e));
+    if (UNLIKELY(res < 0)) return (res);
+  }
+  e.code = code;
+  e.key = key;
+  res = m_eeprom->write(entry(ix), &e, sizeof(e));
+  if (UNLIKELY(res < 0)) return (res);
+  m_count += 1;
+  res = m_eeprom->write(m_addr, m_count);
+  return (res < 0 ? res : 0);
+}
+
+int
+IR::Keymap::remove(uint32_t code)
+{
+  uint8_t ix;
+  int res;
+
+  // Move the larger entries down over the removed entry
+  if (!search(code, ix)) return (ENOENT);
+  entry_t e;
+  for (uint8_t i = ix + 1; i < m_count; i++) {
+    res = m_eeprom->read(&e, entry(i), sizeof(e));
+    if (UNLIKELY(res < 0)) return (res);
+    res = m_eeprom->write(entry(i - 1), &e, sizeof(e));
+    if (UNLIKELY(res < 0)) return (res);
+  }
+  m_count -= 1;
+  res = m_eeprom->write(m_addr, m_count);
+  return (res < 0 ? res : 0);
+}
+
+int
+IR::Keymap::clear()
+{
+  m_count = 0;
+  int res = m_eeprom->write(m_addr, m_count);
+  return (res < 0 ? res : 0);
+}
+
+int
+IR::Keymap::lookup_P(const entry_t* keymap, uint8_t keys, uint32_t code)
+{
+  uint8_t low = 0;
+  uint8_t high = keys;
+  while (low < high) {
+    uint8_t mid = (low + high) / 2;
+    uint32_t value = pgm_read_dword(&keymap[mid].code);
+    if (value == code) return (pgm_read_byte(&keymap[mid].key));
+    if (value < code)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return (-1);
+}
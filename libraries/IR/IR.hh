@@ -22,7 +22,9 @@
 #define COSA_IR_HH
 
 #include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/InputCapture.hh"
 #include "Cosa/Periodic.hh"
+#include "Cosa/EEPROM.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -38,6 +40,9 @@
  *                       +------------+
  * @endcode
  *
+ * IR::Capture is a protocol independent receiver; the output pin
+ * is connected to the input capture pin (ICP1, D8) instead.
+ *
  * @section References
  * 1. http://www.vishay.com/docs/82459/tsop48.pdf
  */
@@ -129,6 +134,226 @@ public:
      */
     friend IOStream& operator<<(IOStream& outs, Receiver& receiver);
   };
+
+#if !defined(BOARD_ATTINY)
+  /**
+   * Protocol independent IR receiver. Captures the pulse and space
+   * widths with the Input Capture Unit (Timer1) and normalizes the
+   * sequence to a 32-bit signature hash; each width is compared with
+   * the previous width (shorter, same or longer) and the result is
+   * hashed (FNV-1a). The hash is independent of the remote protocol
+   * and may be looked up in a sorted key map (Keymap). A code is
+   * completed when there has been no edge for the given gap time.
+   *
+   * @section Limitations
+   * Uses Timer1 with prescale 64. Cannot be used with Tone, VWI or
+   * other Timer1 users.
+   */
+  class Capture : private InputCapture, public Job {
+  public:
+    /**
+     * Construct IR capture with given scheduler and gap time (in
+     * the scheduler time base) to detect end of code, e.g., 20000 us
+     * with RTT::Scheduler.
+     * @param[in] scheduler for gap timeout.
+     * @param[in] gap time between codes.
+     */
+    Capture(Job::Scheduler* scheduler, uint32_t gap);
+
+    /**
+     * Start capture of the next code.
+     */
+    void reset();
+
+    /**
+     * Stop capture.
+     */
+    void end();
+
+    /**
+     * Return signature hash of the latest code.
+     * @return hash.
+     */
+    uint32_t code() const
+    {
+      return (m_hash);
+    }
+
+    /**
+     * Return number of edges in the latest code.
+     * @return edges.
+     */
+    uint8_t edges() const
+    {
+      return (m_edges);
+    }
+
+    /**
+     * @override{IR::Capture}
+     * Callback when a code has been received. Called from the event
+     * handler. Capture of the next code is started on return.
+     * @param[in] code signature hash.
+     */
+    virtual void on_code(uint32_t code) = 0;
+
+  protected:
+    /** Minimum number of edges in a code; filter noise. */
+    static const uint8_t EDGES_MIN = 8;
+
+    /** FNV-1a hash offset basis and prime. */
+    static const uint32_t FNV_OFFSET = 2166136261UL;
+    static const uint32_t FNV_PRIME = 16777619UL;
+
+    const uint32_t m_gap;	//!< Gap time between codes.
+    volatile uint32_t m_last;	//!< Time of latest edge.
+    volatile uint32_t m_hash;	//!< Signature hash.
+    volatile uint16_t m_start;	//!< Timer count of latest edge.
+    volatile uint16_t m_width;	//!< Latest width (timer count).
+    volatile uint8_t m_edges;	//!< Number of edges.
+
+    /**
+     * @override{Interrupt::Handler}
+     * Measure the width since the last edge, switch edge and update
+     * the signature hash.
+     * @param[in] arg timer count on edge.
+     */
+    virtual void on_interrupt(uint16_t arg);
+
+    /**
+     * @override{Job}
+     * Check for gap after the last edge. Complete the code or wait
+     * for the remaining gap time.
+     */
+    virtual void on_expired();
+
+    /**
+     * @override{Event::Handler}
+     * Call on_code() with completed code (READ_COMPLETED_TYPE) and
+     * restart capture.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+  };
+#endif
+
+  /**
+   * Sorted key map of signature hash codes. Lookup is a binary
+   * search so that the decode time does not increase with the number
+   * of remotes and keys. The learned key map is stored in EEPROM;
+   * count byte followed by the entries sorted on code. Program memory
+   * key maps should be sorted on code and used with lookup_P().
+   */
+  class Keymap {
+  public:
+    /**
+     * Key map entry; signature hash code and key.
+     */
+    struct entry_t {
+      uint32_t code;
+      char key;
+    };
+
+    /**
+     * Construct key map in given EEPROM at given address with given
+     * max number of entries. The area should be 1 + max *
+     * sizeof(entry_t) bytes.
+     * @param[in] eeprom device.
+     * @param[in] addr of key map in EEPROM.
+     * @param[in] max number of entries.
+     */
+    Keymap(EEPROM* eeprom, void* addr, uint8_t max) :
+      m_eeprom(eeprom),
+      m_addr((uint8_t*) addr),
+      m_max(max),
+      m_count(0)
+    {}
+
+    /**
+     * Read the key map count from EEPROM. An erased or invalid
+     * key map is cleared. Return number of entries or negative error
+     * code.
+     * @return number of entries or negative error code.
+     */
+    int begin();
+
+    /**
+     * Return number of entries.
+     * @return count.
+     */
+    uint8_t count() const
+    {
+      return (m_count);
+    }
+
+    /**
+     * Lookup given code and return key or EOF(-1).
+     * @param[in] code signature hash.
+     * @return key or EOF(-1).
+     */
+    int lookup(uint32_t code);
+
+    /**
+     * Learn given code for key. An existing entry is updated
+     * otherwise the entry is inserted in order. Return zero if
+     * successful otherwise negative error code (ENOSPC when full).
+     * @param[in] code signature hash.
+     * @param[in] key for code.
+     * @return zero or negative error code.
+     */
+    int learn(uint32_t code, char key);
+
+    /**
+     * Remove given code. Return zero if successful otherwise negative
+     * error code (ENOENT when not found).
+     * @param[in] code signature hash.
+     * @return zero or negative error code.
+     */
+    int remove(uint32_t code);
+
+    /**
+     * Remove all entries. Return zero if successful otherwise
+     * negative error code.
+     * @return zero or negative error code.
+     */
+    int clear();
+
+    /**
+     * Lookup given code in key map in program memory sorted on code.
+     * Return key or EOF(-1).
+     * @param[in] keymap in program memory.
+     * @param[in] keys number of members in keymap.
+     * @param[in] code signature hash.
+     * @return key or EOF(-1).
+     */
+    static int lookup_P(const entry_t* keymap, uint8_t keys, uint32_t code);
+
+  protected:
+    EEPROM* m_eeprom;		//!< EEPROM device.
+    uint8_t* m_addr;		//!< Key map address in EEPROM.
+    const uint8_t m_max;	//!< Max number of entries.
+    uint8_t m_count;		//!< Number of entries.
+
+    /**
+     * Return EEPROM address of entry with given index.
+     * @param[in] ix index.
+     * @return entry address.
+     */
+    entry_t* entry(uint8_t ix) const
+    {
+      return ((entry_t*) (m_addr + 1 + ix * sizeof(entry_t)));
+    }
+
+    /**
+     * Binary search for given code. Return true(1) if found
+     * otherwise false(0). The index is the entry or the insert
+     * position.
+     * @param[in] code signature hash.
+     * @param[out] ix index.
+     * @return bool.
+     */
+    bool search(uint32_t code, uint8_t& ix);
+  };
 };
 
 #endif
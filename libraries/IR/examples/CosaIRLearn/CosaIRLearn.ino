@@ -0,0 +1,110 @@
+/**
+ * @file CosaIRLearn.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the protocol independent IR receiver with
+ * learning mode. Type a character on the serial monitor and press a
+ * remote key to learn the key. Learned keys are stored in EEPROM and
+ * printed when received. Type '!' to clear the key map.
+ *
+ * @section Circuit
+ * @code
+ *                       TSOP4838
+ *                       +------------+
+ * (ICP1/D8)-----------1-|OUT         |
+ * (GND)---------------2-|GND    ( )  |
+ * (VCC)---------------3-|VCC         |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <IR.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/EEPROM.hh"
+#include "Cosa/IOStream.hh"
+#include "Cosa/UART.hh"
+
+IOStream cout(&uart);
+
+// Key map storage in internal EEPROM; count and 32 entries
+static const uint8_t KEYS_MAX = 32;
+static uint8_t keys[1 + KEYS_MAX * sizeof(IR::Keymap::entry_t)] EEMEM;
+EEPROM eeprom;
+IR::Keymap keymap(&eeprom, keys, KEYS_MAX);
+
+class Remote : public IR::Capture {
+public:
+  Remote(Job::Scheduler* scheduler) :
+    IR::Capture(scheduler, 20000UL),
+    m_learn(0)
+  {}
+
+  void learn(char key)
+  {
+    m_learn = key;
+  }
+
+  virtual void on_code(uint32_t code)
+  {
+    if (m_learn != 0) {
+      int res = keymap.learn(code, m_learn);
+      cout << PSTR("learn ") << m_learn << ':' << hex << code
+	   << (res < 0 ? PSTR(" failed") : PSTR("")) << endl;
+      m_learn = 0;
+      return;
+    }
+    int key = keymap.lookup(code);
+    if (key < 0)
+      cout << PSTR("unknown ") << hex << code << endl;
+    else
+      cout << PSTR("key ") << (char) key << endl;
+  }
+
+private:
+  char m_learn;
+};
+
+RTT::Scheduler scheduler;
+Remote remote(&scheduler);
+
+void setup()
+{
+  uart.begin(9600);
+  cout << PSTR("CosaIRLearn: started") << endl;
+  RTT::begin();
+  InputCapture::begin();
+  cout << PSTR("keys = ") << keymap.begin() << endl;
+  remote.reset();
+}
+
+void loop()
+{
+  Event::service(100);
+  int c = uart.getchar();
+  if (c == IOStream::EOF || c < ' ') return;
+  if (c == '!') {
+    keymap.clear();
+    cout << PSTR("cleared") << endl;
+    return;
+  }
+  remote.learn(c);
+  cout << PSTR("press remote key for ") << (char) c << endl;
+}
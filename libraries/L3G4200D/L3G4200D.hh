@@ -22,6 +22,7 @@
 #define COSA_L3G4200D_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/Sensor.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -93,6 +94,37 @@ public:
     read(OUT, &s, sizeof(s));
   }
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Gyroscope sample source for Sensor::Stream; burst read of the
+   * output registers with auto increment (little endian, no
+   * decoding).
+   */
+  class Source : public Sensor::Source {
+  public:
+    /**
+     * Construct sample source for given gyroscope.
+     * @param[in] dev gyroscope driver.
+     */
+    Source(L3G4200D* dev) :
+      Sensor::Source(dev, OUT | AUTO_INC, &m_sample, sizeof(m_sample))
+    {}
+
+    /**
+     * Return latest sample.
+     * @return sample.
+     */
+    const Sensor::sample_t& sample() const
+    {
+      return (m_sample);
+    }
+
+  protected:
+    /** Latest sample. */
+    Sensor::sample_t m_sample;
+  };
+#endif
+
 protected:
   /**
    * Register address map (See tab. 18, pp. 27).
@@ -136,6 +136,236 @@ public:
    */
   virtual int putchar(char c);
 
+  /**
+   * Frame buffer for cascaded MAX72XX devices; LED matrix modules
+   * with the digit registers as rows. Device zero(0) is nearest the
+   * processor (DIN) and holds columns 0..7, bit 7 is the first
+   * column. The frame is updated with one chip select window per
+   * row; the row register of all devices are shifted through the
+   * chain and latched together. Only changed rows are sent.
+   * @param[in] DEVICES number of cascaded devices.
+   */
+  template<uint8_t DEVICES>
+  class Cascade {
+  public:
+    /** Frame size in pixels. */
+    static const uint16_t WIDTH = DEVICES * 8;
+    static const uint8_t HEIGHT = 8;
+
+    /**
+     * Construct frame buffer for cascaded devices with given io
+     * adapter.
+     * @param[in] io adapter, SPI or in/output pin based.
+     */
+    Cascade(LCD::IO* io) :
+      m_io(io),
+      m_dirty(0xff)
+    {
+      clear();
+    }
+
+    /**
+     * Start interaction with the devices. Turns the displays on,
+     * clears and sets the intensity to mid-level(7).
+     * @return true(1) if successful otherwise false(0)
+     */
+    bool begin()
+    {
+      set(DISPLAY_TEST, 0);
+      set(DECODE_MODE, NO_DECODE);
+      set(SCAN_LIMIT, 7);
+      set(INTENSITY, 7);
+      clear();
+      flush();
+      set(DISPLAY_MODE, NORMAL_OPERATION);
+      return (true);
+    }
+
+    /**
+     * Stop interaction with the devices; shutdown mode.
+     * @return true(1) if successful otherwise false(0)
+     */
+    bool end()
+    {
+      set(DISPLAY_MODE, SHUTDOWN_MODE);
+      return (true);
+    }
+
+    /**
+     * Set intensity level (0..15) of all devices.
+     * @param[in] level intensity.
+     */
+    void display_contrast(uint8_t level)
+    {
+      set(INTENSITY, level);
+    }
+
+    /**
+     * Clear frame buffer. Call flush() to update the devices.
+     */
+    void clear()
+    {
+      memset(m_frame, 0, sizeof(m_frame));
+      m_dirty = 0xff;
+    }
+
+    /**
+     * Return pixel at given position.
+     * @param[in] x column (0..WIDTH-1).
+     * @param[in] y row (0..HEIGHT-1).
+     * @return bool.
+     */
+    bool get_pixel(uint16_t x, uint8_t y) const
+    {
+      if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT))) return (false);
+      return ((m_frame[y][x >> 3] & (0x80 >> (x & 0x07))) != 0);
+    }
+
+    /**
+     * Set or clear pixel at given position.
+     * @param[in] x column (0..WIDTH-1).
+     * @param[in] y row (0..HEIGHT-1).
+     * @param[in] on pixel state (default true).
+     */
+    void set_pixel(uint16_t x, uint8_t y, bool on = true)
+    {
+      if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT))) return;
+      uint8_t mask = (0x80 >> (x & 0x07));
+      if (on)
+	m_frame[y][x >> 3] |= mask;
+      else
+	m_frame[y][x >> 3] &= ~mask;
+      m_dirty |= _BV(y);
+    }
+
+    /**
+     * Set column at given position; bit 0 is row zero(0).
+     * @param[in] x column (0..WIDTH-1).
+     * @param[in] bits column pixels.
+     */
+    void set_column(uint16_t x, uint8_t bits)
+    {
+      for (uint8_t y = 0; y < HEIGHT; y++, bits >>= 1)
+	set_pixel(x, y, bits & 1);
+    }
+
+    /**
+     * Return frame buffer row; one byte per device. Mark the row as
+     * changed with touch() after direct updates.
+     * @param[in] y row (0..HEIGHT-1).
+     * @return row buffer.
+     */
+    uint8_t* row(uint8_t y)
+    {
+      return (m_frame[y]);
+    }
+
+    /**
+     * Mark given row as changed.
+     * @param[in] y row (0..HEIGHT-1).
+     */
+    void touch(uint8_t y)
+    {
+      m_dirty |= _BV(y);
+    }
+
+    /**
+     * Scroll frame buffer one column to the left. The last column is
+     * set to the given column pixels; bit 0 is row zero(0).
+     * @param[in] bits new column pixels (default 0).
+     */
+    void scroll_left(uint8_t bits = 0)
+    {
+      for (uint8_t y = 0; y < HEIGHT; y++, bits >>= 1) {
+	uint8_t* rp = m_frame[y];
+	uint8_t carry = bits & 1;
+	for (uint8_t i = DEVICES; i-- > 0;) {
+	  uint8_t next = rp[i] >> 7;
+	  rp[i] = (rp[i] << 1) | carry;
+	  carry = next;
+	}
+      }
+      m_dirty = 0xff;
+    }
+
+    /**
+     * Scroll frame buffer one column to the right. The first column
+     * is set to the given column pixels; bit 0 is row zero(0).
+     * @param[in] bits new column pixels (default 0).
+     */
+    void scroll_right(uint8_t bits = 0)
+    {
+      for (uint8_t y = 0; y < HEIGHT; y++, bits >>= 1) {
+	uint8_t* rp = m_frame[y];
+	uint8_t carry = (bits & 1) << 7;
+	for (uint8_t i = 0; i < DEVICES; i++) {
+	  uint8_t next = rp[i] << 7;
+	  rp[i] = (rp[i] >> 1) | carry;
+	  carry = next;
+	}
+      }
+      m_dirty = 0xff;
+    }
+
+    /**
+     * Write changed rows to the devices; one chip select window and
+     * buffer write per row.
+     */
+    void flush()
+    {
+      for (uint8_t y = 0; y < HEIGHT; y++) {
+	if ((m_dirty & _BV(y)) == 0) continue;
+	uint8_t buf[DEVICES * 2];
+	uint8_t* bp = buf;
+	for (uint8_t i = DEVICES; i-- > 0;) {
+	  *bp++ = DIGIT0 + y;
+	  *bp++ = m_frame[y][i];
+	}
+	m_io->begin();
+	m_io->write(buf, sizeof(buf));
+	m_io->end();
+      }
+      m_dirty = 0;
+    }
+
+    /**
+     * Set register of given device to the given value. The other
+     * devices are passed no-operation.
+     * @param[in] device index (0..DEVICES-1).
+     * @param[in] reg register address.
+     * @param[in] value.
+     */
+    void set(uint8_t device, uint8_t reg, uint8_t value)
+    {
+      m_io->begin();
+      for (uint8_t i = DEVICES; i-- > 0;) {
+	m_io->write(i == device ? reg : NOP);
+	m_io->write(value);
+      }
+      m_io->end();
+    }
+
+  protected:
+    LCD::IO* m_io;			//!< Display adapter.
+    uint8_t m_frame[HEIGHT][DEVICES];	//!< Frame buffer; row and device.
+    uint8_t m_dirty;			//!< Changed rows.
+
+    /**
+     * Set register of all devices to the given value.
+     * @param[in] reg register address.
+     * @param[in] value.
+     */
+    void set(uint8_t reg, uint8_t value)
+    {
+      m_io->begin();
+      for (uint8_t i = 0; i < DEVICES; i++) {
+	m_io->write(reg);
+	m_io->write(value);
+      }
+      m_io->end();
+    }
+  };
+
 protected:
   /**
    * Register Address Map (Table 2, pp 7).
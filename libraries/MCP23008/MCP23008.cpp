@@ -19,6 +19,7 @@
  */
 
 #include "MCP23008.hh"
+#include "Cosa/Event.hh"
 
 bool
 MCP23008::begin()
@@ -159,3 +160,60 @@ MCP23008::write(void* buf, size_t size)
   m_reg = OLAT;
   return (res == (int) size + 1);
 }
+
+bool
+MCP23008::read_interrupt(uint8_t& intf, uint8_t& intcap)
+{
+  // Sequential operation is disabled; address the registers in turn
+  // within the same bus acquire
+  int res;
+  twi.acquire(this);
+  twi.write((uint8_t) INTF);
+  res = twi.read(&intf, sizeof(intf));
+  if (res != sizeof(intf)) goto error;
+  twi.write((uint8_t) INTCAP);
+  res = twi.read(&intcap, sizeof(intcap));
+  if (res != sizeof(intcap)) goto error;
+  twi.release();
+  m_reg = INTCAP;
+  return (true);
+ error:
+  twi.release();
+  m_reg = REG_MAX;
+  return (false);
+}
+
+void
+MCP23008::InterruptPin::enable()
+{
+  // Check for interrupt that was signalled while disabled
+  synchronized {
+    if (is_clear() && !m_pending) {
+      m_pending = true;
+      Event::push(Event::CHANGE_TYPE, this);
+    }
+  }
+  ExternalInterrupt::enable();
+}
+
+void
+MCP23008::InterruptPin::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  if (m_pending) return;
+  m_pending = true;
+  Event::push(Event::CHANGE_TYPE, this);
+}
+
+void
+MCP23008::InterruptPin::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(type);
+  UNUSED(value);
+  m_pending = false;
+  uint8_t intf;
+  uint8_t intcap;
+  if (!m_dev->read_interrupt(intf, intcap)) return;
+  for (uint8_t pin = 0; intf != 0; pin++, intf >>= 1)
+    if (intf & 1) on_change(pin, (intcap & _BV(pin)) != 0);
+}
@@ -22,6 +22,7 @@
 #define COSA_MCP23008_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/ExternalInterrupt.hh"
 
 /**
  * Driver for the MCP23008 8-bit I/O Expander with I2C Interface
@@ -165,6 +166,57 @@ public:
     return (write(m_olat));
   }
 
+  /**
+   * Set given output pin in the output latch shadow register if value
+   * is non-zero, otherwise clear. The pin is not written to the
+   * device until commit() or update(). Allows a number of pin
+   * changes to be written in a single bus transaction.
+   * @param[in] pin number (0..7).
+   * @param[in] value.
+   */
+  void set_pin(uint8_t pin, uint8_t value)
+    __attribute__((always_inline))
+  {
+    uint8_t mask = _BV(pin & PIN_MASK);
+    if (value)
+      m_olat |= mask;
+    else
+      m_olat &= ~mask;
+  }
+
+  /**
+   * Write the output latch shadow register to the output pins.
+   * Return true if successful otherwise false.
+   * @return bool.
+   */
+  bool commit()
+    __attribute__((always_inline))
+  {
+    return (write(m_olat));
+  }
+
+  /**
+   * Write given value to the output pins in the given mask. Other
+   * pins are not changed. Return true if successful otherwise false.
+   * @param[in] mask pins to update.
+   * @param[in] value.
+   * @return bool.
+   */
+  bool update(uint8_t mask, uint8_t value)
+    __attribute__((always_inline))
+  {
+    return (write((m_olat & ~mask) | (value & mask)));
+  }
+
+  /**
+   * Read interrupt flag and capture registers. Clears the device
+   * interrupt. Return true if successful otherwise false.
+   * @param[out] intf interrupt flags; pins that caused the interrupt.
+   * @param[out] intcap pin values at the time of the interrupt.
+   * @return bool.
+   */
+  bool read_interrupt(uint8_t& intf, uint8_t& intcap);
+
   /**
    * Read pins and return current values.
    * @return input pin values.
@@ -198,6 +250,78 @@ public:
    */
   bool write(void* buf, size_t size);
 
+  /**
+   * MCP23008 interrupt pin handler. Connect the device INT pin to an
+   * external interrupt pin. The interrupt flag and capture registers
+   * are read in the event handler (not in the interrupt service
+   * routine) and on_change() is called for each pin that caused the
+   * interrupt. Enable interrupt for the pins with interrupt_pin().
+   * @code
+   * class Keypad : public MCP23008::InterruptPin {
+   * public:
+   *   Keypad(MCP23008* dev) : MCP23008::InterruptPin(dev, Board::EXT0) {}
+   *   virtual void on_change(uint8_t pin, bool value) { ... }
+   * };
+   * @endcode
+   */
+  class InterruptPin : public ExternalInterrupt {
+  public:
+    /**
+     * Construct interrupt pin handler for given device and external
+     * interrupt pin. The device INT pin is active low.
+     * @param[in] dev device.
+     * @param[in] pin external interrupt pin.
+     */
+    InterruptPin(MCP23008* dev, Board::ExternalInterruptPin pin) :
+      ExternalInterrupt(pin, ExternalInterrupt::ON_FALLING_MODE, true),
+      m_dev(dev),
+      m_pending(false)
+    {}
+
+    /**
+     * @override{Interrupt::Handler}
+     * Check for an interrupt that was signalled while the interrupt
+     * handler was disabled, and enable.
+     */
+    virtual void enable();
+
+    /**
+     * @override{Interrupt::Handler}
+     * Push an event to read the device interrupt registers.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg = 0);
+
+    /**
+     * @override{Event::Handler}
+     * Read the device interrupt registers and dispatch on_change()
+     * for each pin that caused the interrupt.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+
+    /**
+     * @override{MCP23008::InterruptPin}
+     * Called for each pin that caused an interrupt with the pin
+     * value at the time of the interrupt.
+     * @param[in] pin number (0..7).
+     * @param[in] value of pin.
+     */
+    virtual void on_change(uint8_t pin, bool value)
+    {
+      UNUSED(pin);
+      UNUSED(value);
+    }
+
+  protected:
+    /** Device. */
+    MCP23008* m_dev;
+
+    /** Event pending. */
+    volatile bool m_pending;
+  };
+
 protected:
   /** Sub-address mask. */
   static const uint8_t SUBADDR_MASK = 0x07;
@@ -171,6 +171,54 @@ MCP7940N::square_wave(bool flag)
   return (write(&cntrl, sizeof(cntrl), pos) == sizeof(cntrl));
 }
 
+bool
+MCP7940N::get_clock(clock_t& now)
+{
+  time_t clock;
+  if (UNLIKELY(!get_time(clock))) return (false);
+  clock.to_binary();
+  now = clock;
+  return (true);
+}
+
+bool
+MCP7940N::set_wakeup(clock_t when)
+{
+  // Set alarm 0 to time match with active low output; clears flag
+  time_t alarm(when);
+  alarm.to_bcd();
+  alarm_t::config_t config(alarm.day);
+  config.when = WHEN_TIME_MATCH;
+  alarm.day = config.as_uint8;
+  uint8_t pos = offsetof(rtcc_t,alarm0);
+  if (write(&alarm, sizeof(alarm_t), pos) != sizeof(alarm_t)) return (false);
+
+  // Enable alarm 0 (without the driver alarm interrupt handler)
+  control_t cntrl;
+  pos = offsetof(rtcc_t,control);
+  if (read(&cntrl, sizeof(cntrl), pos) != sizeof(cntrl)) return (false);
+  cntrl.alm0en = 1;
+  return (write(&cntrl, sizeof(cntrl), pos) == sizeof(cntrl));
+}
+
+bool
+MCP7940N::clear_wakeup()
+{
+  // Disable alarm 0
+  control_t cntrl;
+  uint8_t pos = offsetof(rtcc_t,control);
+  if (read(&cntrl, sizeof(cntrl), pos) != sizeof(cntrl)) return (false);
+  cntrl.alm0en = 0;
+  if (write(&cntrl, sizeof(cntrl), pos) != sizeof(cntrl)) return (false);
+
+  // Clear alarm 0 flag
+  alarm_t::config_t config;
+  pos = offsetof(rtcc_t,alarm0.day);
+  if (read(&config, sizeof(config), pos) != sizeof(config)) return (false);
+  config.triggered = 0;
+  return (write(&config, sizeof(config), pos) == sizeof(config));
+}
+
 IOStream& operator<<(IOStream& outs, MCP7940N::alarm_t& t)
 {
   outs << bcd << t.month << '-'
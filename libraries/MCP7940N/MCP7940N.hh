@@ -23,6 +23,7 @@
 
 #include "Cosa/TWI.hh"
 #include "Cosa/Time.hh"
+#include "Cosa/Alarm.hh"
 #include "Cosa/IOStream.hh"
 #include "Cosa/ExternalInterrupt.hh"
 
@@ -33,8 +34,13 @@
  * @section References
  * 1. Microchip MCP7940N data sheet;
  * http://ww1.microchip.com/downloads/en/DeviceDoc/20005010F.pdf
+ *
+ * @section Limitations
+ * The wakeup device (Alarm::Device) uses alarm 0 with an active low
+ * MFP output and does not use the driver alarm interrupt handler.
+ * Alarm 1 should not be used together with the wakeup device.
  */
-class MCP7940N : private TWI::Driver {
+class MCP7940N : private TWI::Driver, public Alarm::Device {
 public:
   /**
    * The RTCC configuration/status bitfields. Embedded in day field (pp. 18).
@@ -276,6 +282,33 @@ public:
    */
   bool square_wave(bool flag);
 
+  /**
+   * @override{Alarm::Device}
+   * Read current time in seconds from the real-time clock. Return
+   * true(1) if successful otherwise false(0).
+   * @param[out] now seconds.
+   * @return bool.
+   */
+  virtual bool get_clock(clock_t& now);
+
+  /**
+   * @override{Alarm::Device}
+   * Program alarm 0 (time match) to given time in seconds and clear
+   * any pending alarm. Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] when seconds.
+   * @return bool.
+   */
+  virtual bool set_wakeup(clock_t when);
+
+  /**
+   * @override{Alarm::Device}
+   * Disable alarm 0 and clear any pending alarm.
+   * Return true(1) if successful otherwise false(0).
+   * @return bool.
+   */
+  virtual bool clear_wakeup();
+
 protected:
   /**
    * Read register block with the given size into the buffer from the
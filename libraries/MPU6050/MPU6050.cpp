@@ -116,6 +116,145 @@ MPU6050::read_gyroscope(sample_t& s)
   swap<sample_t>(&s);
 }
 
+#if !defined(BOARD_ATTINY)
+void
+MPU6050::Source::on_decode()
+{
+  swap<motion_t>(&m_sample);
+  m_sample.temp = (m_sample.temp + 12410) / 34;
+}
+#endif
+
+MPU6050::Stream::Stream(MPU6050* mpu, motion_t* buffer, uint8_t nmemb,
+			Board::ExternalInterruptPin pin) :
+  ExternalInterrupt(pin, ExternalInterrupt::ON_RISING_MODE),
+  m_mpu(mpu),
+  m_buffer(buffer),
+  m_mask(nmemb - 1),
+  m_put(0),
+  m_get(0),
+  m_ready(false),
+  m_overflows(0)
+{
+}
+
+void
+MPU6050::Stream::begin(uint8_t div)
+{
+  // Set sample rate; gyroscope output rate 1 kHz with low pass filter
+  config_t config;
+  config.DLPF_CFG = 1;
+  m_mpu->write(CONFIG, config);
+  m_mpu->write(SMPRT_DIV, div);
+
+  // Clear interrupt status on any read
+  int_pin_cfg_t pin_cfg;
+  pin_cfg.INT_RD_CLEAR = 1;
+  m_mpu->write(INT_PIN_CFG, pin_cfg);
+
+  // Store accelerometer, temperature and gyroscope in register order
+  fifo_en_t fifo_en;
+  fifo_en.ACCEL_FIFO_EN = 1;
+  fifo_en.TEMP_FIFO_EN = 1;
+  fifo_en.XG_FIFO_EN = 1;
+  fifo_en.YG_FIFO_EN = 1;
+  fifo_en.ZG_FIFO_EN = 1;
+  m_mpu->write(FIFO_EN, fifo_en);
+
+  // Reset and enable the FIFO
+  user_ctrl_t user_ctrl;
+  user_ctrl.FIFO_RESET = 1;
+  user_ctrl.FIFO_EN = 1;
+  m_mpu->write(USER_CTRL, user_ctrl);
+
+  // Enable data ready and overflow interrupt
+  int_enable_t int_enable;
+  int_enable.DATA_RDY_EN = 1;
+  int_enable.FIFO_OFLOW_EN = 1;
+  m_put = 0;
+  m_get = 0;
+  m_ready = true;
+  m_mpu->write(INT_ENABLE, int_enable);
+  enable();
+}
+
+void
+MPU6050::Stream::end()
+{
+  disable();
+  m_mpu->write(INT_ENABLE, 0);
+  m_mpu->write(USER_CTRL, 0);
+  m_mpu->write(FIFO_EN, 0);
+}
+
+void
+MPU6050::Stream::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  m_ready = true;
+}
+
+void
+MPU6050::Stream::read(uint8_t count)
+{
+  motion_t* mp = &m_buffer[m_put];
+  m_mpu->read(FIFO_R_W, mp, count * SAMPLE_MAX);
+  m_put = (m_put + count) & m_mask;
+  while (count--) {
+    swap<motion_t>(mp);
+    mp->temp = (mp->temp + 12410) / 34;
+    mp += 1;
+  }
+}
+
+uint8_t
+MPU6050::Stream::service()
+{
+  // Check data ready and overflow
+  if (!m_ready) return (0);
+  m_ready = false;
+  int_status_t status = m_mpu->read(INT_STATUS);
+  if (UNLIKELY(status.FIFO_OFLOW_INT)) {
+    user_ctrl_t user_ctrl;
+    user_ctrl.FIFO_RESET = 1;
+    user_ctrl.FIFO_EN = 1;
+    m_mpu->write(USER_CTRL, user_ctrl);
+    m_overflows += 1;
+    return (0);
+  }
+
+  // Read number of complete samples that fit in the ring buffer
+  uint16_t bytes;
+  m_mpu->read(FIFO_COUNT, &bytes, sizeof(bytes));
+  bytes = swap((int16_t) bytes);
+  uint16_t samples = bytes / SAMPLE_MAX;
+  uint8_t room = m_mask - available();
+  if (samples > room) {
+    samples = room;
+    m_ready = true;
+  }
+  if (samples == 0) return (0);
+
+  // Burst read contiguous blocks; before and after ring wrap
+  uint8_t count = samples;
+  uint8_t tail = m_mask + 1 - m_put;
+  if (count > tail) {
+    read(tail);
+    count -= tail;
+  }
+  read(count);
+  return (samples);
+}
+
+bool
+MPU6050::Stream::get(motion_t& sample)
+{
+  if (m_get == m_put) return (false);
+  sample = m_buffer[m_get];
+  m_get = (m_get + 1) & m_mask;
+  return (true);
+}
+
 IOStream&
 operator<<(IOStream& outs, MPU6050& mpu)
 {
@@ -22,6 +22,8 @@
 #define COSA_MPU6050_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/Sensor.hh"
+#include "Cosa/ExternalInterrupt.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -118,6 +120,150 @@ public:
    */
   void read_gyroscope(sample_t& s);
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Motion sample source for Sensor::Stream; burst read of the
+   * accelerometer, temperature and gyroscope registers. Decoding
+   * adjusts byte order and scales temperature.
+   */
+  class Source : public Sensor::Source {
+  public:
+    /**
+     * Construct sample source for given device.
+     * @param[in] dev device driver.
+     */
+    Source(MPU6050* dev) :
+      Sensor::Source(dev, ACCEL_OUT, &m_sample, sizeof(m_sample))
+    {}
+
+    /**
+     * Return latest sample.
+     * @return sample.
+     */
+    const motion_t& sample() const
+    {
+      return (m_sample);
+    }
+
+    /**
+     * @override{Sensor::Source}
+     * Adjust to little endian and scale temperature.
+     */
+    virtual void on_decode();
+
+  protected:
+    /** Latest sample. */
+    motion_t m_sample;
+  };
+#endif
+
+  /**
+   * FIFO streaming mode. The device stores accelerometer,
+   * temperature and gyroscope samples in the FIFO at the given
+   * sample rate and the data ready interrupt (INT pin) signals new
+   * samples. The FIFO is read in bursts, with a single TWI read per
+   * contiguous block, into the given ring buffer by service(); called
+   * from the main loop. FIFO overflow is detected and counted; the
+   * FIFO is then reset to restore sample alignment.
+   * @code
+   * MPU6050 mpu;
+   * MPU6050::motion_t samples[32];
+   * MPU6050::Stream stream(&mpu, samples, membersof(samples));
+   * ...
+   * mpu.begin();
+   * stream.begin();
+   * ...
+   * stream.service();
+   * while (stream.get(sample)) ...
+   * @endcode
+   */
+  class Stream : public ExternalInterrupt {
+  public:
+    /**
+     * Construct FIFO stream for given device with ring buffer and
+     * data ready interrupt pin.
+     * @param[in] mpu device driver.
+     * @param[in] buffer sample ring buffer.
+     * @param[in] nmemb number of samples in buffer (power of 2, max 128).
+     * @param[in] pin data ready interrupt pin (default EXT0).
+     */
+    Stream(MPU6050* mpu, motion_t* buffer, uint8_t nmemb,
+	   Board::ExternalInterruptPin pin = Board::EXT0);
+
+    /**
+     * Start streaming with given sample rate divisor; sample rate is
+     * 1 kHz / (1 + div). Default 500 Hz.
+     * @param[in] div sample rate divisor (default 1).
+     */
+    void begin(uint8_t div = 1);
+
+    /**
+     * Stop streaming; disable FIFO and data ready interrupt.
+     */
+    void end();
+
+    /**
+     * Read available samples from the device FIFO into the ring
+     * buffer. Returns number of samples read. Samples are left in
+     * the device FIFO when the ring buffer is full.
+     * @return samples.
+     */
+    uint8_t service();
+
+    /**
+     * Return number of samples in ring buffer.
+     * @return samples.
+     */
+    uint8_t available() const
+    {
+      return ((m_put - m_get) & m_mask);
+    }
+
+    /**
+     * Get next sample from the ring buffer. Return true(1) if
+     * available otherwise false(0).
+     * @param[out] sample storage.
+     * @return bool.
+     */
+    bool get(motion_t& sample);
+
+    /**
+     * Return number of device FIFO overflows; samples have been
+     * dropped.
+     * @return overflows.
+     */
+    uint16_t overflows() const
+    {
+      return (m_overflows);
+    }
+
+    /**
+     * @override{Interrupt::Handler}
+     * Data ready interrupt; mark samples available in device FIFO.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg = 0);
+
+  protected:
+    /** Size of sample in FIFO. */
+    static const uint8_t SAMPLE_MAX = sizeof(motion_t);
+
+    MPU6050* m_mpu;		//!< Device driver.
+    motion_t* m_buffer;		//!< Sample ring buffer.
+    const uint8_t m_mask;	//!< Ring buffer index mask.
+    uint8_t m_put;		//!< Ring buffer put index.
+    uint8_t m_get;		//!< Ring buffer get index.
+    volatile bool m_ready;	//!< Data ready flag.
+    uint16_t m_overflows;	//!< Number of FIFO overflows.
+
+    /**
+     * Read given number of samples from the device FIFO into the
+     * ring buffer at the put index (contiguous).
+     * @param[in] count number of samples.
+     */
+    void read(uint8_t count);
+  };
+
 protected:
   /**
    * Register address map (See chap. 3 Register Map, pp. 6-7).
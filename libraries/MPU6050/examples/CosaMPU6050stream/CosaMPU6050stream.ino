@@ -0,0 +1,90 @@
+/**
+ * @file CosaMPU6050stream.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of MPU6050 FIFO streaming mode. Samples are
+ * collected by the device FIFO at 100 Hz and read in bursts on data
+ * ready interrupt.
+ *
+ * @section Circuit
+ * The MPU6050 module ITG/MPU with pull-up resistors (4K7) for TWI
+ * signals and 3V3 internal voltage converter. The INT signal is
+ * connected to EXT0 (D2).
+ * @code
+ *                           ITG/MPU
+ *                       +------------+
+ * (VCC)---------------1-|VCC         |
+ * (GND)---------------2-|GND         |
+ * (A5/SCL)------------3-|SCL         |
+ * (A4/SDA)------------4-|SDA         |
+ *                     6-|XDA         |
+ *                     7-|XCL         |
+ *                     8-|AD0         |
+ * (EXT0/D2)-----------9-|INT         |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <MPU6050.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+
+MPU6050 mpu;
+MPU6050::motion_t samples[32];
+MPU6050::Stream stream(&mpu, samples, membersof(samples));
+
+void setup()
+{
+  // Start trace output stream on the serial port
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaMPU6050stream: started"));
+
+  // Start the watchdog, real-time clock and the mpu
+  Watchdog::begin();
+  RTT::begin();
+  TRACE(mpu.begin());
+
+  // Stream samples at 100 Hz (1 kHz / (1 + 9))
+  stream.begin(9);
+}
+
+void loop()
+{
+  static uint32_t start = RTT::millis();
+  static uint16_t count = 0;
+  static MPU6050::motion_t sample;
+
+  // Collect samples from the device FIFO and consume ring buffer
+  stream.service();
+  while (stream.get(sample)) count += 1;
+
+  // Print statistics and latest sample every second
+  if (RTT::since(start) < 1000) return;
+  start = RTT::millis();
+  trace << PSTR("samples=") << count
+	<< PSTR(", overflows=") << stream.overflows()
+	<< PSTR(", accel=") << sample.accel.x
+	<< ',' << sample.accel.y
+	<< ',' << sample.accel.z
+	<< endl;
+  count = 0;
+}
@@ -40,17 +40,6 @@ const uint8_t ManchesterCodec::s_symbols[] __PROGMEM = {
   0b01010101
 };
 
-uint8_t
-ManchesterCodec::decode4(uint8_t symbol)
-{
-  uint8_t res = 0;
-  if (symbol & 1) res |= 1;
-  if (symbol & 4) res |= 2;
-  if (symbol & 16) res |= 4;
-  if (symbol & 64) res |= 8;
-  return (res);
-}
-
 // Ethernet frame preamble and delimiter/start symbol
 const uint8_t ManchesterCodec::s_preamble[] __PROGMEM = {
   0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x5d
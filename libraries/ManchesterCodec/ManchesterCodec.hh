@@ -65,7 +65,27 @@ public:
    * @param[in] symbol to decode.
    * @return 4-bit data.
    */
-  virtual uint8_t decode4(uint8_t symbol);
+  virtual uint8_t decode4(uint8_t symbol)
+  {
+    uint8_t res = 0;
+    if (symbol & 1) res |= 1;
+    if (symbol & 4) res |= 2;
+    if (symbol & 16) res |= 4;
+    if (symbol & 64) res |= 8;
+    return (res);
+  }
+
+  /**
+   * @override{VWI::Codec}
+   * Returns 8-bit data for given two packed symbols. Inline decode
+   * without virtual dispatch per symbol.
+   * @return 8-bit data.
+   */
+  virtual uint8_t decode8(uint16_t symbol)
+  {
+    return ((ManchesterCodec::decode4(symbol) << 4) |
+	    (ManchesterCodec::decode4(symbol >> BITS_PER_SYMBOL)));
+  }
 
 private:
   /** Symbol mapping table: 4 to 8 bits */
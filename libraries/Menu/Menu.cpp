@@ -56,57 +56,87 @@ Menu::print(IOStream& outs, int_range_P var, bool selected)
        << PSTR("]");
 }
 
-IOStream&
-operator<<(IOStream& outs, Menu::Walker& walker)
+void
+Menu::Walker::cache()
 {
-  // Access the current state of the menu walker
-  Menu::item_list_P menu = walker.m_stack[walker.m_top];
-  Menu::item_vec_P list = (Menu::item_vec_P) pgm_read_word(&menu->list);
-  Menu::item_P item = &menu->item;
-  Menu::type_t type;
-
-  // Print asterics to mark selection
-  if (walker.m_selected) outs << '*';
-
-  // Print the name of the current menu item with parent
-  outs << (str_P) pgm_read_word(&item->name) << ':';
-  item = (Menu::item_P) pgm_read_word(&list[walker.m_ix]);
-  outs << (str_P) pgm_read_word(&item->name) << endl;
-  type = (Menu::type_t) pgm_read_byte(&item->type);
+  Menu::item_list_P menu = m_stack[m_top];
+  m_list = (Menu::item_vec_P) pgm_read_word(&menu->list);
+  m_item = (Menu::item_P) pgm_read_word(&m_list[m_ix]);
+  m_type = (Menu::type_t) pgm_read_byte(&m_item->type);
+}
 
-  // Print possible value of current menu item
-  switch (type) {
+void
+Menu::Walker::print_value(IOStream& outs)
+{
+  switch (m_type) {
   case Menu::ONE_OF:
     // Print the one-of variable value string
-    Menu::print(outs, (Menu::one_of_P) item);
+    Menu::print(outs, (Menu::one_of_P) m_item);
     break;
   case Menu::ZERO_OR_MANY:
     // Print the zero-or-many variable when selected
-    Menu::print(outs, (Menu::zero_or_many_P) item,
-		walker.m_selected, walker.m_bv);
+    Menu::print(outs, (Menu::zero_or_many_P) m_item, m_selected, m_bv);
     break;
   case Menu::INT_RANGE:
     // Print the range variable and limits when selected
-    Menu::print(outs, (Menu::int_range_P) item, walker.m_selected);
+    Menu::print(outs, (Menu::int_range_P) m_item, m_selected);
     break;
   default:
     ;
   }
+}
+
+void
+Menu::Walker::render(uint8_t mode)
+{
+  uint8_t x, y;
+  switch (mode) {
+  case REDRAW_NONE:
+    return;
+  case REDRAW_VALUE:
+    // Overwrite the value line and clear the remains of the previous
+    m_lcd->set_cursor(0, 1);
+    print_value(m_out);
+    m_lcd->get_cursor(x, y);
+    for (uint8_t i = x; i < m_len; i++) m_out << ' ';
+    break;
+  default:
+    m_out << clear << *this;
+    m_lcd->get_cursor(x, y);
+  }
+  m_len = x;
+  m_out.device()->flush();
+}
+
+IOStream&
+operator<<(IOStream& outs, Menu::Walker& walker)
+{
+  // Print asterics to mark selection
+  if (walker.m_selected) outs << '*';
+
+  // Print the name of the current menu item with parent
+  Menu::item_list_P menu = walker.m_stack[walker.m_top];
+  outs << (str_P) pgm_read_word(&menu->item.name) << ':';
+  outs << (str_P) pgm_read_word(&walker.m_item->name) << endl;
+
+  // Print possible value of current menu item
+  walker.print_value(outs);
   return (outs);
 }
 
 void
 Menu::Walker::on_key_down(uint8_t nr)
 {
-  // Access the current menu item
-  Menu::item_list_P menu = m_stack[m_top];
-  Menu::item_vec_P list = (Menu::item_vec_P) pgm_read_word(&menu->list);
-  Menu::item_P item = (Menu::item_P) pgm_read_word(&list[m_ix]);
-  Menu::type_t type = (Menu::type_t) pgm_read_byte(&item->type);
+  // Access the current menu item (cached)
+  Menu::item_P item = m_item;
+  Menu::type_t type = m_type;
+  Menu::item_vec_P list;
+  uint8_t mode = REDRAW_ALL;
 
   // React to key event
   switch (nr) {
   case NO_KEY:
+    mode = REDRAW_NONE;
     break;
   case SELECT_KEY:
   case RIGHT_KEY:
@@ -121,13 +151,12 @@ Menu::Walker::on_key_down(uint8_t nr)
 	}
 	Menu::zero_or_many_P var = (Menu::zero_or_many_P) item;
 	uint16_t* vp = (uint16_t*) pgm_read_word(&var->value);
-	list = (Menu::item_vec_P) pgm_read_word(&var->list);
-	item = (Menu::item_P) pgm_read_word(&list[m_bv]);
 	uint16_t value = *vp;
 	if ((value & _BV(m_bv)) == 0)
 	  *vp = (value | _BV(m_bv));
 	else
 	  *vp = (value & ~_BV(m_bv));
+	mode = REDRAW_VALUE;
       }
       break;
     case Menu::ITEM_LIST:
@@ -145,6 +174,7 @@ Menu::Walker::on_key_down(uint8_t nr)
 	bool res = obj->run(item);
 	m_top = 0;
 	m_ix = 0;
+	cache();
 	if (!res) return;
       }
       break;
@@ -163,13 +193,16 @@ Menu::Walker::on_key_down(uint8_t nr)
       m_top -= 1;
       m_ix = 0;
     }
+    else mode = REDRAW_NONE;
     break;
   case DOWN_KEY:
     // Step to the next menu item or value in item modification mode
+    mode = REDRAW_NONE;
     if (!m_selected) {
+      item = (Menu::item_P) pgm_read_word(&m_list[m_ix + 1]);
+      if (item == NULL) break;
       m_ix += 1;
-      item = (Menu::item_P) pgm_read_word(&list[m_ix]);
-      if (item == NULL) m_ix -= 1;
+      mode = REDRAW_ALL;
     }
     else {
       switch (type) {
@@ -183,6 +216,7 @@ Menu::Walker::on_key_down(uint8_t nr)
 	  item = (Menu::item_P) pgm_read_word(&list[value]);
 	  if (item == NULL) break;
 	  *vp = value;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       case Menu::ZERO_OR_MANY:
@@ -193,6 +227,7 @@ Menu::Walker::on_key_down(uint8_t nr)
 	  item = (Menu::item_P) pgm_read_word(&list[m_bv + 1]);
 	  if (item == NULL) break;
 	  m_bv += 1;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       case Menu::INT_RANGE:
@@ -204,6 +239,7 @@ Menu::Walker::on_key_down(uint8_t nr)
 	  int low = (int) pgm_read_word(&range->low);
 	  if (value == low) break;
 	  *vp = value - 1;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       default:
@@ -213,11 +249,15 @@ Menu::Walker::on_key_down(uint8_t nr)
     break;
   case UP_KEY:
     // Step to the previous menu item or value in item modification mode
+    mode = REDRAW_NONE;
     if (!m_selected) {
-      if (m_ix > 0)
+      if (m_ix > 0) {
 	m_ix -= 1;
+	mode = REDRAW_ALL;
+      }
       else if (m_top > 0) {
 	m_top -= 1;
+	mode = REDRAW_ALL;
       }
     }
     else {
@@ -229,10 +269,8 @@ Menu::Walker::on_key_down(uint8_t nr)
 	  uint16_t* vp = (uint16_t*) pgm_read_word(&evar->value);
 	  uint16_t value = *vp;
 	  if (value == 0) break;
-	  value -= 1;
-	  list = (Menu::item_vec_P) pgm_read_word(&evar->list);
-	  item = (Menu::item_P) pgm_read_word(&list[value]);
-	  *vp = value;
+	  *vp = value - 1;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       case Menu::ZERO_OR_MANY:
@@ -240,9 +278,11 @@ Menu::Walker::on_key_down(uint8_t nr)
 	{
 	  if (m_bv == 0) {
 	    m_selected = 0;
+	    mode = REDRAW_ALL;
 	    break;
 	  }
 	  m_bv -= 1;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       case Menu::INT_RANGE:
@@ -254,6 +294,7 @@ Menu::Walker::on_key_down(uint8_t nr)
 	  int high = (int) pgm_read_word(&range->high);
 	  if (value == high) break;
 	  *vp = value + 1;
+	  mode = REDRAW_VALUE;
 	}
 	break;
       default:
@@ -263,31 +304,24 @@ Menu::Walker::on_key_down(uint8_t nr)
     break;
   }
 
-  // Display the new walker state
-  m_out << clear << *this;
-}
-
-Menu::type_t
-Menu::Walker::type()
-{
-  if (!m_selected) return (ITEM_LIST);
-  Menu::item_list_P menu = m_stack[m_top];
-  Menu::item_vec_P list = (Menu::item_vec_P) pgm_read_word(&menu->list);
-  Menu::item_P item = (Menu::item_P) pgm_read_word(&list[m_ix]);
-  Menu::type_t type = (Menu::type_t) pgm_read_byte(&item->type);
-  return (type);
+  // Update the cache and display the new walker state
+  if (mode == REDRAW_ALL) cache();
+  render(mode);
 }
 
 void
-Menu::RotaryController::on_event(uint8_t type, uint16_t direction)
+Menu::RotaryController::on_turn(int16_t steps)
 {
-  UNUSED(type);
-  if (m_walker->type() == Menu::INT_RANGE)
-    m_walker->on_key_down(direction == CW ?
-			  Menu::Walker::UP_KEY :
-			  Menu::Walker::DOWN_KEY);
-  else
-    m_walker->on_key_down(direction == CW ?
-			  Menu::Walker::DOWN_KEY :
-			  Menu::Walker::UP_KEY);
+  bool cw = (steps > 0);
+  if (!cw) steps = -steps;
+  while (steps--) {
+    if (m_walker->type() == Menu::INT_RANGE)
+      m_walker->on_key_down(cw ?
+			    Menu::Walker::UP_KEY :
+			    Menu::Walker::DOWN_KEY);
+    else
+      m_walker->on_key_down(cw ?
+			    Menu::Walker::DOWN_KEY :
+			    Menu::Walker::UP_KEY);
+  }
 }
@@ -120,6 +120,11 @@ public:
   /**
    * The Menu Walker reacts to key events from the key pad. It maintains
    * a stack with the path to the current position in the menu three.
+   * The current item list, item and type are cached in data memory.
+   * Only the value line is redrawn when a variable is modified, and
+   * nothing when a key has no effect. The output is flushed after
+   * each redraw so that LCD devices with a shadow buffer (e.g.
+   * HD44780::set_shadow()) only send the changed characters.
    */
   class Walker {
   private:
@@ -137,10 +142,43 @@ public:
     /** Item selection state. */
     bool m_selected;
 
+    /** LCD device for partial redraw. */
+    LCD::Device* m_lcd;
+
     /** Output stream for menu printout. */
     IOStream m_out;
 
-    void on_key_down(uint8_t nr, zero_or_many_P var);
+    /** Cached current item list, item and item type. */
+    Menu::item_vec_P m_list;
+    Menu::item_P m_item;
+    Menu::type_t m_type;
+
+    /** Length of value line; cleared on partial redraw. */
+    uint8_t m_len;
+
+    /** Redraw modes. */
+    enum {
+      REDRAW_NONE,		//!< No change.
+      REDRAW_VALUE,		//!< Value line changed.
+      REDRAW_ALL		//!< Menu position or selection changed.
+    } __attribute__((packed));
+
+    /**
+     * Cache current item list, item and type from program memory.
+     */
+    void cache();
+
+    /**
+     * Print value of the current item to the given output stream.
+     * @param[in] outs output stream.
+     */
+    void print_value(IOStream& outs);
+
+    /**
+     * Redraw the menu with the given mode and flush the output.
+     * @param[in] mode redraw mode.
+     */
+    void render(uint8_t mode);
 
   public:
     /** Menu walker key index (same as LCDkeypad map for simplicity). */
@@ -163,9 +201,12 @@ public:
       m_ix(0),
       m_bv(0),
       m_selected(false),
-      m_out(lcd)
+      m_lcd(lcd),
+      m_out(lcd),
+      m_len(0)
     {
       m_stack[m_top] = root;
+      cache();
     }
 
     /**
@@ -191,13 +232,16 @@ public:
      */
     void begin(bool flag = true)
     {
-      if (flag) m_out << clear << *this;
+      if (flag) render(REDRAW_ALL);
     }
 
     /**
      * Get current menu item type.
      */
-    Menu::type_t type();
+    Menu::type_t type()
+    {
+      return (m_selected ? m_type : ITEM_LIST);
+    }
   };
 
   /**
@@ -293,13 +337,12 @@ public:
     {}
 
     /**
-     * @override{Event::Handler}
-     * Rotary change event handler. Forward change as a key; CW is mapped
+     * @override{Rotary::Encoder}
+     * Rotary turn handler. Forward each step as a key; CW is mapped
      * to DOWN_KEY and CCW to UP_KEY (and reverse for RANGE).
-     * @param[in] type the event type.
-     * @param[in] direction the event value.
+     * @param[in] steps accumulated since previous call.
      */
-    virtual void on_event(uint8_t type, uint16_t direction);
+    virtual void on_turn(int16_t steps);
 
     /**
      * Start the rotary encoder change detector.
@@ -37,8 +37,26 @@ NRF24L01P::NRF24L01P(uint16_t net, uint8_t dev,
   m_state(POWER_DOWN_STATE),
   m_trans(0),
   m_retrans(0),
-  m_drops(0)
+  m_drops(0),
+  m_pending(0),
+  m_failed(false),
+  m_tx_dest(0),
+  m_pipe(0)
+#if !defined(BOARD_ATTINY)
+  , m_gateway(false)
+#endif
+#if (COSA_NRF24L01P_RING_MAX > 0)
+  , m_put(0),
+  m_get(0),
+  m_overflows(0),
+  m_timestamp(0L)
+#endif
 {
+#if !defined(BOARD_ATTINY)
+  memset(m_sender, 0, sizeof(m_sender));
+  memset(m_received, 0, sizeof(m_received));
+  memset(m_active, 0, sizeof(m_active));
+#endif
   channel(64);
 }
 
@@ -131,6 +149,9 @@ NRF24L01P::receiver_mode()
   // Check already in receive mode
   if (m_state == RX_STATE) return;
 
+  // Wait for posted messages
+  if (m_pending != 0) flush();
+
   // Configure primary receiver mode
   write(CONFIG, (_BV(EN_CRC) | _BV(CRCO) | _BV(PWR_UP) | _BV(PRIM_RX)));
   m_ce.set();
@@ -193,12 +214,17 @@ NRF24L01P::begin(const void* config)
   // P0: auto-acknowledge (see transmit_mode)
   // P1: node address<network:device> with auto-acknowledge
   // P2: broadcast<network:0>
+  // P3..P5: gateway sender pipes<network:device+1..3> with auto-acknowledge
   addr_t rx_addr = m_addr;
   write(SETUP_AW, AW_3BYTES);
   write(RX_ADDR_P1, &rx_addr, sizeof(rx_addr));
   write(RX_ADDR_P2, BROADCAST);
-  write(EN_RXADDR, (_BV(ERX_P2) | _BV(ERX_P1)));
-  write(EN_AA, (_BV(ENAA_P1) | _BV(ENAA_P0)));
+  write(RX_ADDR_P3, m_addr.device + 1);
+  write(RX_ADDR_P4, m_addr.device + 2);
+  write(RX_ADDR_P5, m_addr.device + 3);
+  write(EN_RXADDR, rx_pipes());
+  write(EN_AA, (_BV(ENAA_P5) | _BV(ENAA_P4) | _BV(ENAA_P3)
+		| _BV(ENAA_P1) | _BV(ENAA_P0)));
 
   // Ready to go
   powerup();
@@ -215,6 +241,9 @@ NRF24L01P::send(uint8_t dest, uint8_t port, const iovec_t* vec)
   size_t len = iovec_size(vec);
   if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
 
+  // Wait for posted messages
+  if (m_pending != 0) flush();
+
   // Setting transmit destination
   transmit_mode(dest);
 
@@ -237,7 +266,7 @@ NRF24L01P::send(uint8_t dest, uint8_t port, const iovec_t* vec)
   if (dest != BROADCAST) {
     addr_t tx_addr(m_addr.network, dest);
     write(RX_ADDR_P0, &tx_addr, sizeof(tx_addr));
-    write(EN_RXADDR, (_BV(ERX_P2) | _BV(ERX_P1) | _BV(ERX_P0)));
+    write(EN_RXADDR, (rx_pipes() | _BV(ERX_P0)));
   }
 
   // Wait for transmission
@@ -249,7 +278,7 @@ NRF24L01P::send(uint8_t dest, uint8_t port, const iovec_t* vec)
 
   // Check for auto-acknowledge pipe(0) disable
   if (dest != BROADCAST) {
-    write(EN_RXADDR, (_BV(ERX_P2) | _BV(ERX_P1)));
+    write(EN_RXADDR, rx_pipes());
   }
 
   // Reset status bits and read retransmission counter and update
@@ -276,6 +305,286 @@ NRF24L01P::send(uint8_t dest, uint8_t port, const void* buf, size_t len)
   return (send(dest, port, vec));
 }
 
+void
+NRF24L01P::IRQPin::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  if (m_nrf->m_state == TX_STATE) {
+    if (m_nrf->m_pending != 0) m_nrf->complete();
+  }
+#if (COSA_NRF24L01P_RING_MAX > 0)
+  else if (m_nrf->m_state == RX_STATE) {
+    m_nrf->drain();
+  }
+#endif
+}
+
+void
+NRF24L01P::complete()
+{
+  spi.acquire(this);
+    spi.begin();
+      m_status = spi.transfer(NOP);
+    spi.end();
+
+    // Maximum number of retransmits; drop the pending messages
+    if (m_status.max_rt) {
+      spi.begin();
+        spi.transfer(FLUSH_TX);
+      spi.end();
+      spi.begin();
+        spi.transfer(W_REGISTER | (REG_MASK & STATUS));
+	spi.transfer(_BV(MAX_RT) | _BV(TX_DS));
+      spi.end();
+      m_drops += m_pending;
+      m_pending = 0;
+      m_failed = true;
+    }
+
+    // Message delivered; account retransmissions
+    else if (m_status.tx_ds) {
+      spi.begin();
+        spi.transfer(W_REGISTER | (REG_MASK & STATUS));
+	spi.transfer(_BV(TX_DS));
+      spi.end();
+      spi.begin();
+        m_status = spi.transfer(R_REGISTER | (REG_MASK & OBSERVE_TX));
+	observe_tx_t observe = spi.transfer(0);
+      spi.end();
+      m_retrans += observe.arc_cnt;
+      if (m_pending != 0) m_pending -= 1;
+    }
+
+    // Status flags may be merged; an empty fifo has no pending messages
+    spi.begin();
+      m_status = spi.transfer(R_REGISTER | (REG_MASK & FIFO_STATUS));
+      fifo_status_t fifo = spi.transfer(0);
+    spi.end();
+    if (fifo.tx_empty) m_pending = 0;
+  spi.release();
+}
+
+int
+NRF24L01P::post(uint8_t dest, uint8_t port, const iovec_t* vec)
+{
+  // Sanity check the payload size
+  if (UNLIKELY(vec == NULL)) return (EINVAL);
+  size_t len = iovec_size(vec);
+  if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
+
+  // Wait for pending messages to another destination
+  if ((m_pending != 0) && (dest != m_tx_dest)) flush();
+
+  // Setting transmit destination and auto-acknowledge pipe(0)
+  if (m_pending == 0) {
+    transmit_mode(dest);
+    m_tx_dest = dest;
+    if (dest != BROADCAST) {
+      addr_t tx_addr(m_addr.network, dest);
+      write(RX_ADDR_P0, &tx_addr, sizeof(tx_addr));
+      write(EN_RXADDR, (rx_pipes() | _BV(ERX_P0)));
+    }
+  }
+
+  // Wait for room in the transmit fifo
+  while (m_pending == TX_FIFO_MAX) {
+    complete();
+    if (m_pending == TX_FIFO_MAX) yield();
+  }
+
+  // Write source address and payload to the transmit fifo
+  spi.acquire(this);
+    spi.begin();
+      uint8_t command = ((dest != BROADCAST)
+			 ? W_TX_PAYLOAD
+			 : W_TX_PAYLOAD_NO_ACK);
+      m_status = spi.transfer(command);
+      spi.transfer(m_addr.device);
+      spi.transfer(port);
+      spi.write(vec);
+    spi.end();
+    m_pending += 1;
+  spi.release();
+  m_trans += 1;
+  return (len);
+}
+
+int
+NRF24L01P::flush()
+{
+  // Wait for the transmit fifo to become empty
+  while (m_pending != 0) {
+    complete();
+    if (m_pending != 0) yield();
+  }
+
+  // Check for auto-acknowledge pipe(0) disable
+  if (m_tx_dest != BROADCAST) {
+    write(EN_RXADDR, rx_pipes());
+    m_tx_dest = BROADCAST;
+  }
+
+  // Return error code if a message was dropped
+  if (!m_failed) return (0);
+  m_failed = false;
+  return (EIO);
+}
+
+int
+NRF24L01P::ack(uint8_t port, const void* buf, size_t len, uint8_t pipe)
+{
+  if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
+  if (UNLIKELY(pipe == 0 || pipe >= PIPE_MAX)) return (EINVAL);
+  spi.acquire(this);
+    spi.begin();
+      m_status = spi.transfer(W_ACK_PAYLOAD | pipe);
+      spi.transfer(m_addr.device);
+      spi.transfer(port);
+      spi.write(buf, len);
+    spi.end();
+  spi.release();
+  return (len);
+}
+
+#if !defined(BOARD_ATTINY)
+void
+NRF24L01P::gateway(bool enable)
+{
+  // Release the sender pipes and enable/disable the receive pipes
+  m_gateway = enable;
+  memset(m_sender, 0, sizeof(m_sender));
+  if (m_state != POWER_DOWN_STATE) write(EN_RXADDR, rx_pipes());
+}
+
+uint8_t
+NRF24L01P::assign(uint8_t src)
+{
+  if (!m_gateway) return (m_addr.device);
+
+  // Check for assigned pipe, otherwise free or least recently active
+  uint16_t now = RTT::millis();
+  uint8_t pipe = SENDER_PIPE;
+  uint16_t idle = 0;
+  for (uint8_t ix = SENDER_PIPE; ix < PIPE_MAX; ix++) {
+    if (m_sender[ix] == src) {
+      pipe = ix;
+      break;
+    }
+    uint16_t age = (m_sender[ix] == 0) ? UINT16_MAX : now - m_active[ix];
+    if (age > idle) {
+      idle = age;
+      pipe = ix;
+    }
+  }
+  m_sender[pipe] = src;
+  m_active[pipe] = now;
+  return (m_addr.device + pipe - BROADCAST_PIPE);
+}
+
+void
+NRF24L01P::received_on(uint8_t pipe)
+{
+  m_received[pipe] += 1;
+  m_active[pipe] = RTT::millis();
+}
+#endif
+
+#if (COSA_NRF24L01P_RING_MAX > 0)
+
+void
+NRF24L01P::drain()
+{
+  spi.acquire(this);
+    // Clear data ready before reading the receiver fifo
+    spi.begin();
+      m_status = spi.transfer(W_REGISTER | (REG_MASK & STATUS));
+      spi.transfer(_BV(RX_DR));
+    spi.end();
+    while (1) {
+      // Read payload width; pipe number is none when the fifo is empty
+      spi.begin();
+        m_status = spi.transfer(R_RX_PL_WID);
+	uint8_t width = spi.transfer(0);
+      spi.end();
+      if (m_status.rx_p_no == RX_P_NO_NONE) break;
+
+      // Check for payload error from device (Tab. 20, pp. 51)
+      if ((width < 2) || (width > DEVICE_PAYLOAD_MAX)) {
+	spi.begin();
+	  m_status = spi.transfer(FLUSH_RX);
+	spi.end();
+	break;
+      }
+
+      // Leave the message in the fifo if the ring is full
+      uint8_t next = (m_put + 1) & RING_MASK;
+      if (UNLIKELY(next == m_get)) {
+	m_overflows += 1;
+	break;
+      }
+
+      // Read the source address, port and payload into the ring
+      frame_t* fp = &m_ring[next];
+      fp->stamp = RTT::micros();
+      fp->pipe = m_status.rx_p_no;
+      fp->dest = (fp->pipe == BROADCAST_PIPE ? BROADCAST : m_addr.device);
+      fp->len = width - 2;
+#if !defined(BOARD_ATTINY)
+      received_on(fp->pipe);
+#endif
+      spi.begin();
+        m_status = spi.transfer(R_RX_PAYLOAD);
+	fp->src = spi.transfer(0);
+	fp->port = spi.transfer(0);
+	spi.read(fp->payload, fp->len);
+      spi.end();
+      m_put = next;
+    }
+  spi.release();
+}
+
+bool
+NRF24L01P::available()
+{
+  // Check the receive ring and the receiver fifo
+  if (m_put != m_get) return (true);
+  drain();
+  return (m_put != m_get);
+}
+
+int
+NRF24L01P::recv(uint8_t& src, uint8_t& port,
+		void* buf, size_t size,
+		uint32_t ms)
+{
+  // Run in receiver mode
+  receiver_mode();
+
+  // Wait for a message in the receive ring
+  uint32_t start = RTT::millis();
+  while (!available()) {
+    if ((ms != 0) && (RTT::since(start) > ms)) return (ETIME);
+    yield();
+  }
+
+  // Copy the message and step the ring
+  uint8_t next = (m_get + 1) & RING_MASK;
+  frame_t* fp = &m_ring[next];
+  int res = EMSGSIZE;
+  if (fp->len <= size) {
+    memcpy(buf, fp->payload, fp->len);
+    m_dest = fp->dest;
+    m_pipe = fp->pipe;
+    m_timestamp = fp->stamp;
+    src = fp->src;
+    port = fp->port;
+    res = fp->len;
+  }
+  m_get = next;
+  return (res);
+}
+
+#else
 bool
 NRF24L01P::available()
 {
@@ -302,8 +611,12 @@ NRF24L01P::recv(uint8_t& src, uint8_t& port,
     if ((ms != 0) && (RTT::since(start) > ms)) return (ETIME);
     yield();
   }
-  m_dest = (m_status.rx_p_no == 1 ? m_addr.device : BROADCAST);
+  m_pipe = m_status.rx_p_no;
+  m_dest = (m_pipe == BROADCAST_PIPE ? BROADCAST : m_addr.device);
   write(STATUS, _BV(RX_DR));
+#if !defined(BOARD_ATTINY)
+  received_on(m_pipe);
+#endif
 
   // Check for payload error from device (Tab. 20, pp. 51, R_RX_PL_WID)
   uint8_t count = read(R_RX_PL_WID) - 2;
@@ -323,6 +636,7 @@ NRF24L01P::recv(uint8_t& src, uint8_t& port,
   spi.release();
   return (count);
 }
+#endif
 
 void
 NRF24L01P::output_power_level(int8_t dBm)
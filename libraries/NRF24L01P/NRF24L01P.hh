@@ -27,6 +27,16 @@
 #include "Cosa/Wireless.hh"
 #if !defined(BOARD_ATTINYX5)
 
+/**
+ * Number of frames in the interrupt driven receive ring. Must be zero
+ * or a power of 2. One slot is reserved to detect a full ring. Each
+ * frame requires 39 bytes of data memory. Default is zero; messages
+ * are read from the device fifo in recv().
+ */
+#ifndef COSA_NRF24L01P_RING_MAX
+#define COSA_NRF24L01P_RING_MAX 0
+#endif
+
 /**
  * Nordic Semiconductor nRF24L01+ Single Chip 2.4GHz Transceiver
  * device driver.
@@ -60,6 +70,21 @@ public:
    */
   static const size_t DEVICE_PAYLOAD_MAX = 32;
 
+  /**
+   * Number of messages in the device transmit fifo.
+   */
+  static const uint8_t TX_FIFO_MAX = 3;
+
+  /**
+   * Number of data pipes. Pipe 0 is used for transmit auto-acknowledge,
+   * pipe 1 for the node address and pipe 2 for broadcast. Pipes 3..5
+   * are assigned to senders in gateway mode.
+   */
+  static const uint8_t PIPE_MAX = 6;
+  static const uint8_t NODE_PIPE = 1;
+  static const uint8_t BROADCAST_PIPE = 2;
+  static const uint8_t SENDER_PIPE = 3;
+
   /**
    * Maximum size of payload. The device allows 32 bytes payload.
    * The source address one byte and port one byte as header.
@@ -167,6 +192,130 @@ public:
    */
   virtual int send(uint8_t dest, uint8_t port, const void* buf, size_t len);
 
+  /**
+   * Post message in given null terminated io vector to the device
+   * transmit fifo and return without waiting for the transmission.
+   * Up to TX_FIFO_MAX messages to the same destination are pipelined.
+   * The call will wait for queued messages if the fifo is full or
+   * the destination address is changed. Completions are handled by
+   * the interrupt handler and accounted in trans(), retrans() and
+   * drops(). Returns number of bytes posted or negative error code.
+   * @param[in] dest destination network address.
+   * @param[in] port device port (or message type).
+   * @param[in] vec null termianted io vector.
+   * @return number of bytes posted or negative error code.
+   */
+  int post(uint8_t dest, uint8_t port, const iovec_t* vec);
+
+  /**
+   * Post message in given buffer, with given number of bytes, to the
+   * device transmit fifo. See post(dest, port, vec).
+   * @param[in] dest destination network address.
+   * @param[in] port device port (or message type).
+   * @param[in] buf buffer to transmit.
+   * @param[in] len number of bytes in buffer.
+   * @return number of bytes posted or negative error code.
+   */
+  int post(uint8_t dest, uint8_t port, const void* buf, size_t len)
+  {
+    iovec_t vec[2];
+    iovec_t* vp = vec;
+    iovec_arg(vp, buf, len);
+    iovec_end(vp);
+    return (post(dest, port, vec));
+  }
+
+  /**
+   * Wait for all posted messages to be transmitted. Returns zero(0)
+   * if all messages since the previous flush were delivered
+   * otherwise error code(EIO).
+   * @return zero or negative error code.
+   */
+  int flush();
+
+  /**
+   * Return number of posted messages not yet completed.
+   * @return pending count.
+   */
+  uint8_t pending() const
+  {
+    return (m_pending);
+  }
+
+  /**
+   * Set message in given buffer as payload of the next auto
+   * acknowledge sent by this device on the given data pipe. The
+   * message is received by the transmitter with recv() (source
+   * address and port as any other message). In gateway mode the
+   * payload may be queued on the pipe assigned to a sender. Returns
+   * number of bytes queued or negative error code.
+   * @param[in] port device port (or message type).
+   * @param[in] buf buffer with acknowledge payload.
+   * @param[in] len number of bytes in buffer.
+   * @param[in] pipe data pipe (default node address pipe).
+   * @return number of bytes or negative error code.
+   */
+  int ack(uint8_t port, const void* buf, size_t len, uint8_t pipe = NODE_PIPE);
+
+  /**
+   * Return data pipe of the latest received message; NODE_PIPE,
+   * BROADCAST_PIPE or a sender pipe in gateway mode.
+   * @return pipe.
+   */
+  uint8_t pipe() const
+  {
+    return (m_pipe);
+  }
+
+#if !defined(BOARD_ATTINY)
+  /**
+   * Enable or disable gateway mode. In gateway mode the data pipes
+   * 3..5 receive on alias device addresses (device + 1..3) in the
+   * same network with auto-acknowledge. The pipes are assigned to
+   * senders with assign(); a sender uses the returned alias address
+   * as destination and the messages from the sender are received,
+   * acknowledged and counted on its own pipe. The pipe of a received
+   * message is returned by pipe() and may be used to dispatch the
+   * payload to per-sender queues. The device address should leave
+   * room for the alias addresses.
+   * @param[in] enable gateway mode (default true).
+   */
+  void gateway(bool enable = true);
+
+  /**
+   * Assign a data pipe to the given sender device address and return
+   * the device address that the sender should send to. A sender that
+   * already has a pipe keeps it. Otherwise a free pipe is assigned,
+   * or the pipe of the least recently active sender is reassigned.
+   * Returns the node address (shared pipe) if gateway mode is not
+   * enabled.
+   * @param[in] src sender device address.
+   * @return destination device address for sender.
+   */
+  uint8_t assign(uint8_t src);
+
+  /**
+   * Return sender device address assigned to given data pipe or
+   * zero(0) if not assigned.
+   * @param[in] pipe data pipe.
+   * @return sender device address.
+   */
+  uint8_t sender(uint8_t pipe) const
+  {
+    return (pipe < PIPE_MAX ? m_sender[pipe] : 0);
+  }
+
+  /**
+   * Return number of messages received on given data pipe.
+   * @param[in] pipe data pipe.
+   * @return message count.
+   */
+  uint16_t received(uint8_t pipe) const
+  {
+    return (pipe < PIPE_MAX ? m_received[pipe] : 0);
+  }
+#endif
+
   /**
    * @override{Wireless::Device}
    * Receive message and store into given buffer with given maximum
@@ -219,6 +368,29 @@ public:
     return (m_drops);
   }
 
+#if (COSA_NRF24L01P_RING_MAX > 0)
+  /**
+   * Return number of messages that could not be stored in the
+   * receive ring because it was full.
+   * @return overflow count.
+   */
+  uint16_t overflows() const
+  {
+    return (m_overflows);
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Return receive time stamp (RTT::micros) of the latest received
+   * message.
+   * @return micro-seconds.
+   */
+  virtual uint32_t timestamp()
+  {
+    return (m_timestamp);
+  }
+#endif
+
 protected:
   /**
    * NRF transceiver states (See chap. 6.1.1, fig. 4, pp. 22).
@@ -612,6 +784,15 @@ protected:
       ExternalInterrupt(pin, mode),
       m_nrf(nrf)
     {}
+
+    /**
+     * @override{Interrupt::Handler}
+     * Handle completion of posted messages in transmitter mode. Drain
+     * the device receiver fifo to the receive ring in receiver mode.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg = 0);
+
     friend class NRF24L01P;
   private:
     NRF24L01P* m_nrf;		//!< Device driver.
@@ -625,6 +806,75 @@ protected:
   uint16_t m_trans;		//!< Send count.
   uint16_t m_retrans;		//!< Retransmittion count.
   uint16_t m_drops;		//!< Dropped messages.
+  volatile uint8_t m_pending;	//!< Posted messages in transmit fifo.
+  volatile bool m_failed;	//!< Posted message dropped since flush.
+  uint8_t m_tx_dest;		//!< Destination of posted messages.
+  uint8_t m_pipe;		//!< Data pipe of latest message.
+#if !defined(BOARD_ATTINY)
+  bool m_gateway;		//!< Gateway mode.
+  uint8_t m_sender[PIPE_MAX];	//!< Sender assigned to data pipe.
+  uint16_t m_received[PIPE_MAX]; //!< Messages received per data pipe.
+  uint16_t m_active[PIPE_MAX];	//!< Latest activity (ms, truncated).
+
+  /**
+   * Account received message on given data pipe.
+   * @param[in] pipe data pipe.
+   */
+  void received_on(uint8_t pipe);
+#endif
+
+  /**
+   * Return enabled receive data pipes; node address and broadcast,
+   * and sender pipes in gateway mode.
+   * @return enabled rx address bitset.
+   */
+  uint8_t rx_pipes() const
+  {
+#if !defined(BOARD_ATTINY)
+    if (m_gateway)
+      return (_BV(ERX_P5) | _BV(ERX_P4) | _BV(ERX_P3)
+	      | _BV(ERX_P2) | _BV(ERX_P1));
+#endif
+    return (_BV(ERX_P2) | _BV(ERX_P1));
+  }
+
+  /**
+   * Handle transmit status of posted messages; account for delivered
+   * or dropped messages and clear status. Called from the interrupt
+   * handler and when waiting for the transmit fifo.
+   */
+  void complete();
+
+#if (COSA_NRF24L01P_RING_MAX > 0)
+  /**
+   * Received frame in receive ring.
+   */
+  struct frame_t {
+    uint32_t stamp;		//!< Receive time stamp (us).
+    uint8_t dest;		//!< Destination device address.
+    uint8_t pipe;		//!< Data pipe.
+    uint8_t src;		//!< Source device address.
+    uint8_t port;		//!< Device port (or message type).
+    uint8_t len;		//!< Payload length.
+    uint8_t payload[PAYLOAD_MAX]; //!< Payload.
+  };
+  static_assert(!(COSA_NRF24L01P_RING_MAX & (COSA_NRF24L01P_RING_MAX - 1)),
+		"COSA_NRF24L01P_RING_MAX should be power of 2");
+  static const uint8_t RING_MAX = COSA_NRF24L01P_RING_MAX;
+  static const uint8_t RING_MASK = RING_MAX - 1;
+  frame_t m_ring[RING_MAX];	//!< Receive ring.
+  volatile uint8_t m_put;	//!< Receive ring put index (ISR).
+  volatile uint8_t m_get;	//!< Receive ring get index.
+  uint16_t m_overflows;		//!< Receive ring overflow count.
+  uint32_t m_timestamp;		//!< Latest received message time stamp.
+
+  /**
+   * Read messages in the device receiver fifo to the receive ring.
+   * Called from the interrupt handler and from recv() for messages
+   * that arrived while a transmit interrupt was pending.
+   */
+  void drain();
+#endif
 
   /**
    * Read status. Issue NOP command to read status.
@@ -0,0 +1,92 @@
+/**
+ * @file CosaNRF24L01PGateway.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa NRF24L01P star gateway demo. Senders request an address with
+ * a join message to the gateway node address. The gateway assigns a
+ * data pipe (alias address) and replies with the address. Messages
+ * are dispatched by the data pipe they were received on and the
+ * message count per pipe is printed periodically.
+ *
+ * @section Circuit
+ * See NRF24L01P.hh for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <NRF24L01P.h>
+
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Periodic.hh"
+
+// Configuration; network and gateway device address
+#define NETWORK 0xC05A
+#define DEVICE 0x10
+
+// Message ports
+static const uint8_t JOIN_PORT = 0x80;
+static const uint8_t DATA_PORT = 0x81;
+
+NRF24L01P rf(NETWORK, DEVICE);
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaNRF24L01PGateway: started"));
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(rf.begin());
+  rf.gateway();
+}
+
+void loop()
+{
+  // Print message count per data pipe every 10 seconds
+  periodic(timer, 10000) {
+    for (uint8_t pipe = rf.NODE_PIPE; pipe < rf.PIPE_MAX; pipe++)
+      trace << PSTR("pipe[") << pipe << PSTR("]:sender=") << hex
+	    << rf.sender(pipe) << PSTR(",received=") << dec
+	    << rf.received(pipe) << endl;
+  }
+
+  // Receive message and dispatch on data pipe
+  uint8_t src;
+  uint8_t port;
+  uint8_t msg[NRF24L01P::PAYLOAD_MAX];
+  int res = rf.recv(src, port, msg, sizeof(msg), 1000L);
+  if (res < 0) return;
+  uint8_t pipe = rf.pipe();
+
+  // Assign a sender pipe and reply with the alias address
+  if (port == JOIN_PORT) {
+    uint8_t alias = rf.assign(src);
+    rf.send(src, JOIN_PORT, &alias, sizeof(alias));
+    trace << PSTR("join:src=") << hex << src
+	  << PSTR(",alias=") << alias << endl;
+    return;
+  }
+
+  // Data from sender on assigned or shared pipe
+  if (port == DATA_PORT) {
+    trace << PSTR("data:src=") << hex << src
+	  << PSTR(",pipe=") << dec << pipe
+	  << PSTR(",len=") << res << endl;
+  }
+}
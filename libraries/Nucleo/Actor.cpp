@@ -35,8 +35,8 @@ Actor::send(uint8_t port, const void* buf, size_t size)
   sender->m_buf = buf;
 
   // And queue in sending. Resume receiver or next thread
-  Thread* thread = (m_receiving ? this : (Thread*) sender->succ());
   m_sending.attach(sender);
+  Thread* thread = (m_receiving ? this : select());
   sender->resume(thread);
   return (size);
 }
@@ -51,11 +51,11 @@ Actor::recv(Actor*& sender, uint8_t& port, void* buf, size_t size)
   uint8_t key = lock();
   if (m_sending.is_empty()) {
     m_receiving = true;
-    Thread* thread = (Thread*) succ();
     detach();
     unlock(key);
-    resume(thread);
+    resume(select());
     key = lock();
+    schedule(this);
   }
 
   // Copy sender message parameters
@@ -69,7 +69,7 @@ Actor::recv(Actor*& sender, uint8_t& port, void* buf, size_t size)
   m_receiving = false;
 
   // Reschedule the sender
-  succ()->attach(sender);
+  schedule(sender);
   unlock(key);
   return (res);
 }
@@ -0,0 +1,124 @@
+/**
+ * @file Nucleo/Mailbox.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_NUCLEO_MAILBOX_HH
+#define COSA_NUCLEO_MAILBOX_HH
+
+#include "Cosa/Queue.hh"
+#include "Thread.hh"
+
+namespace Nucleo {
+
+/**
+ * The Cosa Nucleo Mailbox; bounded message queue for a receiving
+ * thread (actor). Messages are posted without blocking and may be
+ * posted from an interrupt handler. The receiving thread waits for
+ * messages and is rescheduled by post(). The ring-buffer is single
+ * producer and single consumer; interrupts are only disabled while
+ * the receiving thread is rescheduled.
+ * @code
+ * Nucleo::Mailbox<uint16_t, 8> mailbox;
+ * ...
+ * virtual void on_interrupt(uint16_t arg) { mailbox.post(&arg); }
+ * ...
+ * virtual void run() { uint16_t msg; mailbox.recv(&msg); ... }
+ * @endcode
+ * @param[in] T message type.
+ * @param[in] NMEMB number of messages in mailbox (power of 2).
+ */
+template<class T, uint8_t NMEMB>
+class Mailbox {
+public:
+  /**
+   * Construct empty mailbox.
+   */
+  Mailbox() : m_queue(), m_receiver(NULL) {}
+
+  /**
+   * Return number of messages in mailbox.
+   * @return messages.
+   */
+  uint8_t available() const
+  {
+    return (m_queue.available());
+  }
+
+  /**
+   * Post given message to mailbox. Does not block. Returns true(1) if
+   * successful otherwise false(0) if the mailbox is full. The waiting
+   * receiver is rescheduled and will run at the next yield point.
+   * Single producer; may be called from an interrupt handler.
+   * @param[in] msg pointer to message.
+   * @return bool.
+   */
+  bool post(const T* msg)
+  {
+    if (UNLIKELY(!m_queue.put(msg))) return (false);
+    Thread* receiver = m_receiver;
+    if (receiver != NULL) {
+      m_receiver = NULL;
+      Thread::schedule(receiver);
+    }
+    return (true);
+  }
+
+  /**
+   * Receive message from mailbox. The running thread waits until a
+   * message is available. Single consumer.
+   * @param[in,out] msg pointer to message buffer.
+   */
+  void recv(T* msg)
+  {
+    Thread* running = Thread::running();
+    while (!m_queue.get(msg)) {
+      uint8_t key = lock();
+      if (m_queue.available() == 0) {
+	m_receiver = running;
+	running->detach();
+	unlock(key);
+	running->resume(Thread::select());
+      }
+      else {
+	unlock(key);
+      }
+    }
+  }
+
+  /**
+   * Receive message from mailbox if available. Returns true(1) if a
+   * message was received otherwise false(0). Does not block.
+   * @param[in,out] msg pointer to message buffer.
+   * @return bool.
+   */
+  bool try_recv(T* msg)
+  {
+    return (m_queue.get(msg));
+  }
+
+protected:
+  /** Message ring-buffer. */
+  Queue<T,NMEMB> m_queue;
+
+  /** Waiting receiver thread. */
+  Thread* volatile m_receiver;
+};
+
+};
+#endif
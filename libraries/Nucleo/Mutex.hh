@@ -28,7 +28,11 @@ namespace Nucleo {
 /**
  * The Cosa Nucleo Mutex; mutual exclusion block. Used as a local
  * variable in a block to wait and signal a semaphore to achive mutual
- * exclusive execution of the block.
+ * exclusive execution of the block. The thread in the block inherits
+ * the priority of higher priority threads waiting to enter the block
+ * until the semaphore is signaled. Inheritance is not transitive; a
+ * boosted thread waiting for another semaphore does not boost that
+ * owner.
  */
 class Mutex {
 public:
@@ -26,21 +26,36 @@ using namespace Nucleo;
 void
 Semaphore::wait(uint8_t count)
 {
+  Thread* running = Thread::s_running;
   uint8_t key = lock();
   while (count > m_count) {
+    // Raise owner priority to the waiting thread (inheritance)
+    if ((m_owner != NULL) && (m_owner->m_priority < running->m_priority))
+      m_owner->inherit(running->m_priority);
+
+    // Queue after waiting threads with the same or higher priority
+    Thread* thread = (Thread*) m_queue.succ();
+    while ((thread != (Thread*) &m_queue)
+	   && (thread->m_priority >= running->m_priority))
+      thread = (Thread*) thread->succ();
     unlock(key);
-    Thread::s_running->enqueue(&m_queue);
+    running->enqueue((Head*) thread);
     key = lock();
   }
   m_count -= count;
+  if (m_count == 0) m_owner = running;
   unlock(key);
 }
 
 void
 Semaphore::signal(uint8_t count, bool flag)
 {
+  Thread* owner;
   synchronized {
     m_count += count;
+    owner = m_owner;
+    m_owner = NULL;
   }
+  if (owner != NULL) owner->inherit(owner->m_base);
   Thread::s_running->dequeue(&m_queue, flag);
 }
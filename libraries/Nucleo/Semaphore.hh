@@ -26,8 +26,14 @@
 
 namespace Nucleo {
 
+class Thread;
+
 /**
  * The Cosa Nucleo Semaphore; counting synchronization primitive.
+ * Waiting threads are queued in priority order. The thread that takes
+ * the last count is the owner until the semaphore is signaled. The
+ * owner inherits the priority of a higher priority waiting thread;
+ * priority inheritance for mutual exclusion (see Mutex).
  */
 class Semaphore {
 public:
@@ -35,11 +41,11 @@ public:
    * Construct and initiate semaphore with given counter.
    * @param[in] count initial semaphore value (Default mutex, 1).
    */
-  Semaphore(uint8_t count = 1) : m_queue(), m_count(count) {}
+  Semaphore(uint8_t count = 1) : m_queue(), m_owner(NULL), m_count(count) {}
 
   /**
-   * Wait for required count. Threads are queued until count is
-   * available.
+   * Wait for required count. Threads are queued in priority order
+   * until count is available.
    * @param[in] count requested count (Default mutex, 1).
    */
   void wait(uint8_t count = 1);
@@ -56,6 +62,9 @@ private:
   /** Queue for waiting threads. */
   Head m_queue;
 
+  /** Thread that took the last count; inherits waiter priority. */
+  Thread* m_owner;
+
   /** Current count. */
   volatile uint8_t m_count;
 };
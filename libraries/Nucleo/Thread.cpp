@@ -38,30 +38,66 @@ static void thread_sleep(uint16_t s)
   Nucleo::Thread::running()->delay(s * 1000L);
 }
 
+// Initial entry of thread; returned to from first context switch
+static void thread_start()
+{
+  while (1) Nucleo::Thread::running()->run();
+}
+
+// Most significant bit of nibble; run queue bitmap lookup
+static const uint8_t msb[16] __PROGMEM = {
+  0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+};
+
 using namespace Nucleo;
 
 Head Thread::s_delayed;
+Thread::Wakeup Thread::s_wakeup;
 Thread Thread::s_main;
+Head Thread::s_ready[PRIORITY_MAX];
+uint8_t Thread::s_bitmap = 0;
 Thread* Thread::s_running = &s_main;
 size_t Thread::s_top = MAIN_STACK_MAX;
+Thread* Thread::s_threads = NULL;
 
 void
-Thread::init(void* stack)
+Thread::init(void* stack, size_t size)
 {
-  UNUSED(stack);
-  s_main.attach(this);
-  if (setjmp(m_context)) while (1) run();
+  // Paint the stack with the canary pattern
+  m_size = size;
+  m_stack = (uint8_t*) stack - size;
+  memset(m_stack, STACK_CANARY, size);
+  m_next = s_threads;
+  s_threads = this;
+
+  // Build initial frame as pushed by swap(); the return address is
+  // the thread start function followed by the registers and status
+  uint8_t* sp = (uint8_t*) stack;
+  uint16_t pc = (uint16_t) thread_start;
+  *--sp = pc;
+  *--sp = pc >> 8;
+#if defined(__AVR_3_BYTE_PC__)
+  *--sp = 0;
+#endif
+  for (uint8_t i = 0; i < 18; i++) *--sp = 0;
+  *--sp = _BV(SREG_I);
+  m_sp = sp - 1;
+  schedule(this);
 }
 
 void
-Thread::begin(Thread* thread, size_t size)
+Thread::begin(Thread* thread, size_t size, uint8_t priority)
 {
   if (thread != NULL) {
-    void* stack = alloca(s_top);
+    uint8_t* stack = (uint8_t*) alloca(s_top + size);
     s_top += size;
-    thread->init(stack);
+    if (priority >= PRIORITY_MAX) priority = PRIORITY_MAX - 1;
+    thread->m_priority = priority;
+    thread->m_base = priority;
+    thread->init(stack + size, size);
   }
   else {
+    schedule(&s_main);
     ::delay = thread_delay;
     ::sleep = thread_sleep;
     ::yield = thread_yield;
@@ -72,34 +108,154 @@ void
 Thread::run()
 {
   Thread* thread;
-  if (!s_delayed.is_empty()) {
+  if (!s_wakeup.is_enabled() && !s_delayed.is_empty()) {
     uint32_t now = Watchdog::millis();
     while ((thread = (Thread*) s_delayed.succ()) != (Thread*) &s_delayed) {
       if (thread->m_expires > now) break;
-      this->attach(thread);
+      schedule(thread);
     }
   }
-  thread = (Thread*) succ();
+  schedule(this);
+  thread = select();
   if (thread != this)
     resume(thread);
   else
     Power::sleep();
 }
 
+void
+Thread::yield()
+{
+  schedule(this);
+  Thread* thread = select();
+  if (thread != this) resume(thread);
+}
+
+void
+Thread::schedule(Thread* thread)
+{
+  synchronized {
+    s_ready[thread->m_priority].attach(thread);
+    s_bitmap |= _BV(thread->m_priority);
+  }
+}
+
+Thread*
+Thread::select()
+{
+  synchronized {
+    while (s_bitmap != 0) {
+      uint8_t level = (s_bitmap & 0xf0) ?
+	4 + pgm_read_byte(&msb[s_bitmap >> 4]) :
+	pgm_read_byte(&msb[s_bitmap]);
+      Head* queue = &s_ready[level];
+      if (!queue->is_empty()) return ((Thread*) queue->succ());
+      s_bitmap &= ~_BV(level);
+    }
+  }
+  return (&s_main);
+}
+
+bool
+Thread::is_ready() const
+{
+  Head* queue = &s_ready[m_priority];
+  for (Linkage* link = queue->succ(); link != queue; link = link->succ())
+    if (link == this) return (true);
+  return (false);
+}
+
+void
+Thread::inherit(uint8_t level)
+{
+  if (level == m_priority) return;
+  synchronized {
+    bool ready = is_ready();
+    m_priority = level;
+    if (ready) schedule(this);
+  }
+}
+
+void
+Thread::priority(uint8_t level)
+{
+  if (level >= PRIORITY_MAX) level = PRIORITY_MAX - 1;
+  m_base = level;
+  inherit(level);
+}
+
 void
 Thread::resume(Thread* thread)
 {
-  if (setjmp(m_context)) return;
   s_running = thread;
-  longjmp(thread->m_context, 1);
+  swap(&m_sp, &thread->m_sp);
+}
+
+void
+Thread::swap(void** sp, void** next)
+{
+  UNUSED(sp);
+  UNUSED(next);
+  asm volatile("push r2"			"\n\t"
+	       "push r3"			"\n\t"
+	       "push r4"			"\n\t"
+	       "push r5"			"\n\t"
+	       "push r6"			"\n\t"
+	       "push r7"			"\n\t"
+	       "push r8"			"\n\t"
+	       "push r9"			"\n\t"
+	       "push r10"			"\n\t"
+	       "push r11"			"\n\t"
+	       "push r12"			"\n\t"
+	       "push r13"			"\n\t"
+	       "push r14"			"\n\t"
+	       "push r15"			"\n\t"
+	       "push r16"			"\n\t"
+	       "push r17"			"\n\t"
+	       "push r28"			"\n\t"
+	       "push r29"			"\n\t"
+	       "in r0, __SREG__"		"\n\t"
+	       "push r0"			"\n\t"
+	       "movw r30, r24"			"\n\t"
+	       "in r26, __SP_L__"		"\n\t"
+	       "in r27, __SP_H__"		"\n\t"
+	       "st Z, r26"			"\n\t"
+	       "std Z+1, r27"			"\n\t"
+	       "movw r30, r22"			"\n\t"
+	       "ld r26, Z"			"\n\t"
+	       "ldd r27, Z+1"			"\n\t"
+	       "cli"				"\n\t"
+	       "out __SP_H__, r27"		"\n\t"
+	       "out __SP_L__, r26"		"\n\t"
+	       "pop r0"				"\n\t"
+	       "out __SREG__, r0"		"\n\t"
+	       "pop r29"			"\n\t"
+	       "pop r28"			"\n\t"
+	       "pop r17"			"\n\t"
+	       "pop r16"			"\n\t"
+	       "pop r15"			"\n\t"
+	       "pop r14"			"\n\t"
+	       "pop r13"			"\n\t"
+	       "pop r12"			"\n\t"
+	       "pop r11"			"\n\t"
+	       "pop r10"			"\n\t"
+	       "pop r9"				"\n\t"
+	       "pop r8"				"\n\t"
+	       "pop r7"				"\n\t"
+	       "pop r6"				"\n\t"
+	       "pop r5"				"\n\t"
+	       "pop r4"				"\n\t"
+	       "pop r3"				"\n\t"
+	       "pop r2"				"\n\t"
+	       "ret"				"\n\t"
+	       ::);
 }
 
 void
 Thread::enqueue(Head* queue, Thread* thread)
 {
-  if (thread == NULL)
-    thread = (Thread*) succ();
   queue->attach(this);
+  if (thread == NULL) thread = select();
   resume(thread);
 }
 
@@ -108,7 +264,11 @@ Thread::dequeue(Head* queue, bool flag)
 {
   if (UNLIKELY(queue->is_empty())) return;
   Thread* thread = (Thread*) queue->succ();
-  if (flag) {
+  if (thread->m_priority != m_priority) {
+    schedule(thread);
+    if (flag && thread->m_priority > m_priority) resume(thread);
+  }
+  else if (flag) {
     attach(thread);
     resume(thread);
   }
@@ -120,13 +280,49 @@ Thread::dequeue(Head* queue, bool flag)
 void
 Thread::delay(uint32_t ms)
 {
-  m_expires = Watchdog::millis() + ms;
-  Thread* thread = (Thread*) s_delayed.succ();
-  while (thread != (Thread*) &s_delayed) {
-    if (thread->m_expires > m_expires) break;
-    thread = (Thread*) thread->succ();
+  // Poll the delay queue in the main thread without scheduler
+  if (!s_wakeup.is_enabled()) {
+    m_expires = Watchdog::millis() + ms;
+    Thread* thread = (Thread*) s_delayed.succ();
+    while (thread != (Thread*) &s_delayed) {
+      if (thread->m_expires > m_expires) break;
+      thread = (Thread*) thread->succ();
+    }
+    enqueue((Head*) thread);
+    return;
+  }
+
+  // Insert into the delay queue and restart the wakeup job if first
+  synchronized {
+    m_expires = s_wakeup.time() + ms * s_wakeup.scale();
+    Thread* thread = (Thread*) s_delayed.succ();
+    while (thread != (Thread*) &s_delayed) {
+      if ((int32_t) (thread->m_expires - m_expires) > 0) break;
+      thread = (Thread*) thread->succ();
+    }
+    thread->attach(this);
+    if (s_delayed.succ() == this) {
+      s_wakeup.stop();
+      s_wakeup.expire_at(m_expires);
+      s_wakeup.start();
+    }
+  }
+  resume(select());
+}
+
+void
+Thread::Wakeup::on_expired()
+{
+  uint32_t now = time();
+  Thread* thread;
+  while ((thread = (Thread*) s_delayed.succ()) != (Thread*) &s_delayed) {
+    if ((int32_t) (thread->m_expires - now) > 0) {
+      expire_at(thread->m_expires);
+      start();
+      return;
+    }
+    schedule(thread);
   }
-  enqueue((Head*) thread);
 }
 
 void
@@ -134,3 +330,28 @@ Thread::service()
 {
   s_main.run();
 }
+
+size_t
+Thread::stack_free() const
+{
+  size_t res = 0;
+  while (res < m_size && m_stack[res] == STACK_CANARY) res++;
+  return (res);
+}
+
+void
+Thread::print_stacks(IOStream& outs)
+{
+  for (Thread* thread = s_threads; thread != NULL; thread = thread->m_next)
+    outs << *thread << endl;
+}
+
+IOStream&
+operator<<(IOStream& outs, Nucleo::Thread& thread)
+{
+  outs << PSTR("thread@") << &thread
+       << PSTR(":stack=") << thread.stack_size()
+       << PSTR(",used=") << thread.stack_used()
+       << PSTR(",free=") << thread.stack_free();
+  return (outs);
+}
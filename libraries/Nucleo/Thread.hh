@@ -23,15 +23,27 @@
 
 #include "Cosa/Types.h"
 #include "Cosa/Linkage.hh"
-#include <setjmp.h>
+#include "Cosa/IOStream.hh"
+#include "Cosa/Job.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
 
 namespace Nucleo {
 
+template<class T, uint8_t NMEMB> class Mailbox;
+
 /**
- * The Cosa Nucleo Thread; run-to-completion multi-tasking.
+ * The Cosa Nucleo Thread; run-to-completion multi-tasking. Threads
+ * are scheduled by priority; there is a run queue per priority level
+ * and the highest priority ready thread is selected at each yield
+ * point. Threads with the same priority are run round-robin. The
+ * main thread has the lowest priority (zero).
  */
 class Thread : public Link {
 public:
+  /** Number of priority levels. */
+  static const uint8_t PRIORITY_MAX = 8;
+
   /**
    * Return running thread.
    * @return thread.
@@ -42,12 +54,32 @@ public:
   }
 
   /**
-   * Schedule static thread with given stack size. Using the default
-   * parameters will start the main thread.
+   * Schedule static thread with given stack size and priority. Using
+   * the default parameters will start the main thread.
    * @param[in] thread to initiate and schedule.
    * @param[in] size of stack.
+   * @param[in] priority of thread (0..PRIORITY_MAX-1, default 0).
+   */
+  static void begin(Thread* thread = NULL, size_t size = 0,
+		    uint8_t priority = 0);
+
+  /**
+   * Return current (effective) priority of thread. May be higher than
+   * the given priority while holding a semaphore that a higher
+   * priority thread is waiting for (priority inheritance).
+   * @return priority.
+   */
+  uint8_t priority() const
+  {
+    return (m_priority);
+  }
+
+  /**
+   * Set priority of thread (0..PRIORITY_MAX-1). The thread is moved
+   * to the run queue of the new priority if ready.
+   * @param[in] level priority.
    */
-  static void begin(Thread* thread = NULL, size_t size = 0);
+  void priority(uint8_t level);
 
   /**
    * @override{Nucleo::Thread}
@@ -69,22 +101,18 @@ public:
   void resume(Thread* thread);
 
   /**
-   * Yield control to the next thread in the thread queue. Preserve
-   * stack and machine state and later continue.
+   * Yield control to the highest priority ready thread; next thread
+   * in the run queue if same priority. Preserve stack and machine
+   * state and later continue.
    */
-  void yield()
-    __attribute__((always_inline))
-  {
-    Thread* thread = (Thread*) succ();
-    if (thread == this) thread = &s_main;
-    resume(thread);
-  }
+  void yield();
 
   /**
    * Delay at least the given time period in milli-seconds. The resolution
    * is determined by the Watchdog clock and has a resolution of 16
-   * milli-seconds (per tick). The actual delay also depends on how
-   * other threads yield.
+   * milli-seconds (per tick) unless a job scheduler is used (see
+   * scheduler()). The actual delay also depends on how other threads
+   * yield. With the RTT scheduler the maximum delay is 71 minutes.
    * @param[in] ms minimum delay time period in milli-seconds.
    */
   void delay(uint32_t ms);
@@ -99,49 +127,252 @@ public:
   /**
    * If given queue is not empty dequeue first thread and resume
    * direct if flag is true otherwise enqueue first in run queue.
+   * A thread with lower priority than the running thread is only
+   * enqueued in its run queue.
    * @param[in] queue to transfer from.
    * @param[in] flag resume direct otherwise on yield (Default true).
    */
   void dequeue(Head* queue, bool flag = true);
 
+  /**
+   * Use the given RTT job scheduler for delayed threads. Threads are
+   * resumed at micro-second resolution when the delay expires and the
+   * main thread does not need to poll the delay queue. Should be
+   * called before starting the main thread.
+   * @param[in] scheduler job scheduler.
+   */
+  static void scheduler(RTT::Scheduler* scheduler)
+  {
+    s_wakeup.set(scheduler, 1000);
+  }
+
+  /**
+   * Use the given watchdog job scheduler for delayed threads. Threads
+   * are resumed at the watchdog resolution when the delay expires.
+   * Should be called before starting the main thread.
+   * @param[in] scheduler job scheduler.
+   */
+  static void scheduler(Watchdog::Scheduler* scheduler)
+  {
+    s_wakeup.set(scheduler, 1);
+  }
+
   /**
    * Service the nucleos main thread. Should be called in the
    * loop() function.
    */
   static void service();
 
+  /**
+   * Return size of thread stack in bytes. The main thread returns
+   * zero(0).
+   * @return size.
+   */
+  size_t stack_size() const
+  {
+    return (m_size);
+  }
+
+  /**
+   * Return number of stack bytes that have not been used by the
+   * thread. The stack is painted with a canary pattern when the
+   * thread is started; the free bytes are the unchanged bytes at
+   * the bottom of the stack.
+   * @return free bytes.
+   */
+  size_t stack_free() const;
+
+  /**
+   * Return stack high-water mark; maximum number of bytes used
+   * by the thread.
+   * @return used bytes.
+   */
+  size_t stack_used() const
+  {
+    return (m_size - stack_free());
+  }
+
+  /**
+   * Print stack size, high-water mark and free bytes of all started
+   * threads to the given output stream. Used to tune the stack sizes
+   * given to begin().
+   * @param[in] outs output stream.
+   */
+  static void print_stacks(IOStream& outs);
+
 protected:
   /** Size of main thread stack. */
   static const size_t MAIN_STACK_MAX = 64;
 
+  /**
+   * Wakeup job for delayed threads. Expires when the first thread in
+   * the delay queue should be resumed and moves the expired threads to
+   * the thread queue. Disabled (no scheduler) by default; the main
+   * thread will then poll the delay queue.
+   */
+  class Wakeup : public Job {
+  public:
+    /**
+     * Construct disabled wakeup job.
+     */
+    Wakeup() : Job(NULL), m_scale(1) {}
+
+    /**
+     * Set job scheduler and time scale.
+     * @param[in] scheduler job scheduler.
+     * @param[in] scale scheduler time units per milli-second.
+     */
+    void set(Job::Scheduler* scheduler, uint16_t scale)
+    {
+      m_scheduler = scheduler;
+      m_scale = scale;
+    }
+
+    /**
+     * Return true(1) if a job scheduler is used otherwise false(0).
+     * @return bool.
+     */
+    bool is_enabled() const
+    {
+      return (m_scheduler != NULL);
+    }
+
+    /**
+     * Return scheduler time units per milli-second.
+     * @return scale.
+     */
+    uint16_t scale() const
+    {
+      return (m_scale);
+    }
+
+    /**
+     * @override{Job}
+     * Move expired threads to the thread queue and restart for the
+     * next delayed thread. Called from the scheduler interrupt
+     * service routine.
+     */
+    virtual void on_expired();
+
+  protected:
+    /** Scheduler time units per milli-second. */
+    uint16_t m_scale;
+  };
+
   /** Queue for delayed threads. */
   static Head s_delayed;
 
-  /** Main thread and thread queue head. */
+  /** Wakeup job for delayed threads. */
+  static Wakeup s_wakeup;
+
+  /** Main thread; lowest priority. */
   static Thread s_main;
 
+  /** Run queue per priority level. */
+  static Head s_ready[PRIORITY_MAX];
+
+  /** Bitmap of possibly non-empty run queues. */
+  static uint8_t s_bitmap;
+
   /** Running thread. */
   static Thread* s_running;
 
   /** Top of stack allocation. */
   static size_t s_top;
 
-  /** Thread context. */
-  jmp_buf m_context;
+  /** Stack canary pattern; unused stack bytes. */
+  static const uint8_t STACK_CANARY = 0xa5;
+
+  /** List of started threads. */
+  static Thread* s_threads;
+
+  /** Next started thread. */
+  Thread* m_next;
+
+  /** Stack bottom. */
+  uint8_t* m_stack;
+
+  /** Stack size. */
+  size_t m_size;
+
+  /**
+   * Thread context; stack pointer of the suspended thread. The
+   * call-saved registers and status register are saved on the thread
+   * stack by swap().
+   */
+  void* m_sp;
 
   /** Delay time expires; should not run for more than 2**32 seconds. */
   uint32_t m_expires;
 
+  /** Current (effective) priority. */
+  uint8_t m_priority;
+
+  /** Given priority; restored when inherited priority is released. */
+  uint8_t m_base;
+
+  /**
+   * Enqueue given thread last in the run queue of its priority.
+   * @param[in] thread to schedule.
+   */
+  static void schedule(Thread* thread);
+
+  /**
+   * Return highest priority ready thread; first thread in the highest
+   * priority non-empty run queue. Uses the run queue bitmap.
+   * @return thread.
+   */
+  static Thread* select();
+
+  /**
+   * Return true(1) if the thread is in the run queue of its priority
+   * otherwise false(0).
+   * @return bool.
+   */
+  bool is_ready() const;
+
+  /**
+   * Set current (effective) priority without changing the given
+   * priority. Used for priority inheritance.
+   * @param[in] level priority.
+   */
+  void inherit(uint8_t level);
+
   /**
    * Initiate thread and prepare for initial call to virtual member
-   * function run(). Stack frame is allocated by begin().
+   * function run(). Stack frame is allocated by begin(). The stack
+   * is painted with the canary pattern.
    * @param[in] stack top pointer.
+   * @param[in] size of stack.
+   */
+  void init(void* stack, size_t size);
+
+  /**
+   * Context switch; push call-saved registers (r2-r17, r28-r29) and
+   * status register on the current stack, save the stack pointer in
+   * the given location, load the stack pointer from the next location
+   * and pop the registers. Returns in the context of the resumed
+   * thread. The locations may be the same.
+   * @param[in] sp location to save current stack pointer.
+   * @param[in] next location of stack pointer to switch to.
    */
-  void init(void* stack);
+  static void swap(void** sp, void** next)
+    __attribute__((naked, noinline));
 
   /** Allow friends to use the queue member functions. */
   friend class Semaphore;
+  template<class T, uint8_t NMEMB> friend class Mailbox;
 };
 
 };
+
+/**
+ * Print stack size, high-water mark and free bytes of given thread
+ * to the given output stream.
+ * @param[in] outs output stream.
+ * @param[in] thread to print.
+ * @return output stream.
+ */
+extern IOStream& operator<<(IOStream& outs, Nucleo::Thread& thread);
+
 #endif
@@ -16,7 +16,9 @@
  * Lesser General Public License for more details.
  *
  * @section Description
- * Demonstration of Cosa Nucleo Actors and message passing.
+ * Demonstration of Cosa Nucleo Actors and message passing. Messages
+ * are allocated from a pool by the producers and only the message
+ * pointer is passed. The consumer returns the message to the pool.
  *
  * This file is part of the Arduino Che Cosa project.
  */
@@ -26,6 +28,14 @@
 #include "Cosa/Trace.hh"
 #include "Cosa/Watchdog.hh"
 #include "Cosa/UART.hh"
+#include "Cosa/Pool.hh"
+
+// Message pool shared by the producers
+struct msg_t {
+  uint16_t count;
+  uint32_t timestamp;
+};
+Pool<msg_t, 4> pool;
 
 // Send message to given consumer actor and port
 class Producer : public Nucleo::Actor {
@@ -49,7 +59,11 @@ Producer::run()
     trace << Watchdog::millis()
 	  << PSTR(":Producer:count=") << count
 	  << endl;
-    m_consumer->send(m_port, &count, sizeof(count));
+    msg_t* msg;
+    while ((msg = pool.create()) == NULL) yield();
+    msg->count = count;
+    msg->timestamp = Watchdog::millis();
+    m_consumer->send(m_port, &msg, sizeof(msg));
     count += 1;
   }
 }
@@ -66,13 +80,16 @@ Consumer::run()
   while (1) {
     Actor* sender = NULL;
     uint8_t port = 0;
-    uint16_t count = 0;
-    recv(sender, port, &count, sizeof(count));
+    msg_t* msg = NULL;
+    recv(sender, port, &msg, sizeof(msg));
     trace << Watchdog::millis()
 	  << PSTR(":Consumer:sender=") << sender
 	  << PSTR(",port=") << port
-	  << PSTR(",count=") << count
+	  << PSTR(",count=") << msg->count
+	  << PSTR(",timestamp=") << msg->timestamp
+	  << PSTR(",free=") << pool.available()
 	  << endl;
+    pool.destroy(msg);
     delay(500);
   }
 }
@@ -0,0 +1,88 @@
+/**
+ * @file CosaNucleoMailbox.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of Cosa Nucleo Mailbox; messages are posted from an
+ * external interrupt handler to a receiving thread.
+ *
+ * @section Circuit
+ * Connect a push button or signal to the external interrupt pin
+ * (EXT0, D2 on Uno).
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Nucleo.h>
+
+#include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/UART.hh"
+
+// Mailbox with interrupt time stamps
+Nucleo::Mailbox<uint32_t, 8> mailbox;
+
+class Button : public ExternalInterrupt {
+public:
+  Button() : ExternalInterrupt(Board::EXT0, ON_FALLING_MODE, true) {}
+  virtual void on_interrupt(uint16_t arg)
+  {
+    UNUSED(arg);
+    uint32_t now = RTT::micros();
+    mailbox.post(&now);
+  }
+};
+
+class Receiver : public Nucleo::Thread {
+public:
+  virtual void run()
+  {
+    uint32_t stamp;
+    mailbox.recv(&stamp);
+    uint32_t us = RTT::micros() - stamp;
+    trace << stamp << PSTR(":Receiver:latency=") << us
+	  << PSTR(",available=") << mailbox.available()
+	  << endl;
+  }
+};
+
+// The button and receiver thread
+Button button;
+Receiver receiver;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaNucleoMailbox: started"));
+  trace.flush();
+
+  // Start timers and interrupt handler
+  Watchdog::begin();
+  RTT::begin();
+  button.enable();
+
+  // Start threads
+  Nucleo::Thread::begin(&receiver, 128);
+  Nucleo::Thread::begin();
+}
+
+void loop()
+{
+  // Run the kernel
+  Nucleo::Thread::service();
+}
@@ -79,7 +79,6 @@ void setup()
   Watchdog::begin();
 
   // Some information about memory foot print
-  TRACE(sizeof(jmp_buf));
   TRACE(sizeof(Nucleo::Thread));
   TRACE(sizeof(Counter));
   TRACE(sizeof(Nucleo::Semaphore));
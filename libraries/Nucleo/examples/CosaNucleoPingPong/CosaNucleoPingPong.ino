@@ -83,6 +83,9 @@ public:
 Ping ping;
 Pong pong;
 
+// Job scheduler for delayed threads
+RTT::Scheduler scheduler;
+
 void setup()
 {
   // Setup trace output stream and start watchdog timer
@@ -93,7 +96,6 @@ void setup()
   RTT::begin();
 
   // Some information about memory foot print
-  TRACE(sizeof(jmp_buf));
   TRACE(sizeof(Nucleo::Thread));
   TRACE(sizeof(Ping));
   TRACE(sizeof(Pong));
@@ -103,6 +105,9 @@ void setup()
   Nucleo::Thread::begin(&pong, 128);
   Nucleo::Thread::begin(&ping, 128);
 
+  // Resume delayed threads with the RTT job scheduler
+  Nucleo::Thread::scheduler(&scheduler);
+
   // Start the main thread
   Nucleo::Thread::begin();
 }
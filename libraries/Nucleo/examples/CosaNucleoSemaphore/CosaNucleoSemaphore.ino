@@ -74,7 +74,6 @@ void setup()
   Watchdog::begin();
 
   // Some information about memory foot print
-  TRACE(sizeof(jmp_buf));
   TRACE(sizeof(Nucleo::Thread));
   TRACE(sizeof(Nucleo::Semaphore));
 
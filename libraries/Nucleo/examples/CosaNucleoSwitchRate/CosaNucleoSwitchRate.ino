@@ -0,0 +1,112 @@
+/**
+ * @file CosaNucleoSwitchRate.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa Nucleo context switch rate benchmark; two threads resume each
+ * other (ping-pong). Each round is two context switches. Reports the
+ * time per round and the number of context switches per second.
+ *
+ * @section Circuit
+ * This example requires no special circuit. Uses serial output,
+ * internal timer for RTC and watchdog.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Nucleo.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/UART.hh"
+
+// Number of ping-pong rounds per measurement
+static const uint16_t ROUNDS = 1000;
+
+class Ping : public Nucleo::Thread {
+public:
+  Ping() : Nucleo::Thread(), m_pong(NULL) {}
+  void set(Nucleo::Thread* pong) { m_pong = pong; }
+  virtual void run()
+  {
+    trace << PSTR("Thread::Ping: started") << endl;
+
+    // Measure time per round; two context switches
+    MEASURE("thread ping-pong: ", ROUNDS) {
+      resume(m_pong);
+    }
+
+    // Calculate the context switch rate
+    uint32_t start = RTT::micros();
+    for (uint16_t i = 0; i < ROUNDS; i++) resume(m_pong);
+    uint32_t us = RTT::micros() - start;
+    trace << PSTR("context switches per second: ")
+	  << (2L * ROUNDS * 1000000L) / us
+	  << endl;
+    trace.flush();
+
+    // Report stack high-water marks
+    Nucleo::Thread::print_stacks(trace);
+    trace.flush();
+
+    // Stop the benchmark run
+    ASSERT(true == false);
+  }
+private:
+  Nucleo::Thread* m_pong;
+};
+
+class Pong : public Nucleo::Thread {
+public:
+  Pong(Nucleo::Thread* ping) : Nucleo::Thread(), m_ping(ping) {}
+  virtual void run()
+  {
+    while (1) resume(m_ping);
+  }
+private:
+  Nucleo::Thread* m_ping;
+};
+
+// The threads
+Ping ping;
+Pong pong(&ping);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaNucleoSwitchRate: started"));
+  trace.flush();
+
+  // Memory foot print of context
+  TRACE(sizeof(Nucleo::Thread));
+
+  // Start timers
+  Watchdog::begin();
+  RTT::begin();
+
+  // Start threads
+  ping.set(&pong);
+  Nucleo::Thread::begin(&pong, 64);
+  Nucleo::Thread::begin(&ping, 128);
+  Nucleo::Thread::begin();
+}
+
+void loop()
+{
+  // Run the kernel
+  Nucleo::Thread::service();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file OTA.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "OTA.hh"
+#include "Cosa/CRC.hh"
+#include "Cosa/RTT.hh"
+#include <avr/wdt.h>
+
+bool
+OTA::begin()
+{
+  // Read the descriptor. Restore offset if an image is being received
+  m_offset = 0;
+  if (m_flash->read(&m_header, m_base, sizeof(m_header)) < 0) return (false);
+  if (m_header.magic != MAGIC || m_header.state != RECEIVING) return (true);
+
+  // Resume at the first incomplete image sector
+  uint32_t sectors = (m_header.size + m_flash->SECTOR_MASK) / m_flash->SECTOR_BYTES;
+  for (uint16_t i = 0; i < sectors; i++) {
+    uint8_t mark;
+    if (m_flash->read(&mark, m_base + PROGRESS + i, sizeof(mark)) < 0)
+      return (false);
+    if (mark != 0) break;
+    m_offset += m_flash->SECTOR_BYTES;
+  }
+  if (m_offset > m_header.size) m_offset = m_header.size;
+  return (true);
+}
+
+int
+OTA::state(uint8_t state)
+{
+  uint32_t dest = m_base + offsetof(header_t, state);
+  int res = m_flash->write(dest, &state, sizeof(state));
+  if (res < 0) return (res);
+  m_header.state = state;
+  return (0);
+}
+
+int
+OTA::on_begin(const begin_t* msg)
+{
+  // Resume if the image is the same as the one being received
+  if ((m_header.magic == MAGIC)
+      && (m_header.state == RECEIVING)
+      && (m_header.version == msg->version)
+      && (m_header.size == msg->size)
+      && (m_header.crc == msg->crc))
+    return (0);
+
+  // Check that the image and progress table fit the region
+  uint32_t sectors = (msg->size + m_flash->SECTOR_MASK) / m_flash->SECTOR_BYTES;
+  if ((msg->size == 0)
+      || (PROGRESS + sectors > m_flash->SECTOR_BYTES)
+      || (sectors + 1 > m_flash->SECTOR_MAX - (m_base / m_flash->SECTOR_BYTES)))
+    return (EINVAL);
+
+  // Erase the descriptor sector and write the new descriptor
+  int res = m_flash->erase(m_base, m_flash->SECTOR_BYTES / 1024);
+  if (res < 0) return (res);
+  m_header.magic = MAGIC;
+  m_header.version = msg->version;
+  m_header.size = msg->size;
+  m_header.crc = msg->crc;
+  m_header.state = RECEIVING;
+  res = m_flash->write(m_base, &m_header, sizeof(m_header));
+  if (res < 0) return (res);
+  m_offset = 0;
+  return (0);
+}
+
+int
+OTA::on_chunk(const chunk_t* msg, size_t size)
+{
+  // Check chunk offset, size and crc
+  uint32_t offset = msg->offset;
+  const uint8_t* data = (const uint8_t*) (msg + 1);
+  if ((m_header.magic != MAGIC) || (m_header.state != RECEIVING))
+    return (EINVAL);
+  if (offset != m_offset) return (EINVAL);
+  if ((size == 0) || (size > CHUNK_MAX) || (offset + size > m_header.size))
+    return (EINVAL);
+  if ((offset & m_flash->SECTOR_MASK) + size > m_flash->SECTOR_BYTES)
+    return (EINVAL);
+  if (CRC::crc16_xmodem(data, size) != msg->crc) return (EFAULT);
+
+  // Erase the image sector on the first chunk of the sector
+  uint32_t dest = image() + offset;
+  int res;
+  if ((offset & m_flash->SECTOR_MASK) == 0) {
+    res = m_flash->erase(dest, m_flash->SECTOR_BYTES / 1024);
+    if (res < 0) return (res);
+  }
+
+  // Write the chunk and mark the sector when complete
+  res = m_flash->write(dest, data, size);
+  if (res < 0) return (res);
+  m_offset += size;
+  if (((m_offset & m_flash->SECTOR_MASK) == 0) || (m_offset == m_header.size)) {
+    uint16_t sector = offset / m_flash->SECTOR_BYTES;
+    uint8_t mark = 0;
+    res = m_flash->write(m_base + PROGRESS + sector, &mark, sizeof(mark));
+    if (res < 0) return (res);
+  }
+  return (0);
+}
+
+int
+OTA::on_end()
+{
+  if ((m_header.magic != MAGIC) || (m_header.state != RECEIVING))
+    return (m_header.state == VERIFIED ? 0 : EINVAL);
+  if (m_offset != m_header.size) return (EINVAL);
+
+  // Read back the image and check the crc
+  uint8_t buf[CHUNK_MAX];
+  uint16_t crc = 0;
+  uint32_t src = image();
+  for (uint32_t offset = 0; offset < m_header.size; offset += sizeof(buf)) {
+    size_t size = sizeof(buf);
+    if (offset + size > m_header.size) size = m_header.size - offset;
+    int res = m_flash->read(buf, src + offset, size);
+    if (res < 0) return (res);
+    crc = CRC::crc16_xmodem(buf, size, crc);
+  }
+
+  // Restart the transfer on crc error
+  if (crc != m_header.crc) {
+    m_header.magic = 0;
+    m_offset = 0;
+    return (EFAULT);
+  }
+  return (state(VERIFIED));
+}
+
+void
+OTA::reply(uint8_t dest)
+{
+  status_t status;
+  status.type = STATUS;
+  status.state = (m_header.magic == MAGIC ? m_header.state : RECEIVING);
+  status.offset = m_offset;
+  status.pause = m_pause;
+  m_dev->send(dest, PORT, &status, sizeof(status));
+}
+
+int
+OTA::handle(uint8_t src, const void* buf, size_t len)
+{
+  const uint8_t* msg = (const uint8_t*) buf;
+  int res = EINVAL;
+
+  // Throttle; do not accept requests while flash is busy or within
+  // the pause period after the latest chunk
+  if (!m_flash->is_ready() || (RTT::since(m_stamp) < m_pause)) {
+    res = EAGAIN;
+  }
+  else if (len > 0) {
+    switch (msg[0]) {
+    case BEGIN:
+      if (len == sizeof(begin_t)) res = on_begin((const begin_t*) msg);
+      break;
+    case CHUNK:
+      if (len > sizeof(chunk_t)) {
+	res = on_chunk((const chunk_t*) msg, len - sizeof(chunk_t));
+	m_stamp = RTT::millis();
+      }
+      break;
+    case END:
+      res = on_end();
+      break;
+    }
+  }
+  reply(src);
+  return (res);
+}
+
+void
+OTA::install()
+{
+  if (!is_verified()) return;
+  if (state(INSTALL) < 0) return;
+  m_flash->flush();
+
+  // Reset with the watchdog; the bootloader installs the image
+  wdt_enable(WDTO_15MS);
+  while (1);
+}
@@ -0,0 +1,273 @@
+/**
+ * @file OTA.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_OTA_HH
+#define COSA_OTA_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/Wireless.hh"
+#include "Cosa/Flash.hh"
+
+/**
+ * Over-the-air firmware update chunk size (bytes). Should be a power
+ * of 2 and fit the max payload of the wireless device driver with
+ * the chunk header (7 bytes). Default is 16 bytes.
+ */
+#ifndef COSA_OTA_CHUNK_MAX
+#define COSA_OTA_CHUNK_MAX 16
+#endif
+
+/**
+ * Over-the-air firmware update receiver. Images are received in the
+ * background, in chunks with CRC, and written to an external flash
+ * memory device region. The region layout is:
+ * @code
+ * base + 0		descriptor (header_t)
+ * base + PROGRESS	progress table; one byte per image sector
+ * base + SECTOR_BYTES	image
+ * @endcode
+ * The progress table byte is programmed to zero when an image
+ * sector is complete. After interruption (e.g. power loss) the
+ * transfer resumes at the first incomplete sector. The descriptor
+ * state is programmed (bits cleared) as the image progresses;
+ * RECEIVING, VERIFIED (image CRC checked) and INSTALL (handed over
+ * to the bootloader). The bootloader should check the magic and
+ * INSTALL state, copy the image to program memory and program the
+ * state to INSTALLED.
+ *
+ * The application receive loop passes messages on OTA::PORT to
+ * handle(). Each request is answered with a status message holding
+ * the next expected image offset; the sender continues from that
+ * offset. Chunks that arrive within the pause period after the
+ * previous chunk, or while the flash device is busy, are not
+ * accepted (the status offset is unchanged) so that the update is
+ * throttled.
+ * @code
+ * OTA ota(&rf, &flash, OTA_BASE);
+ * ...
+ * int res = rf.recv(src, port, msg, sizeof(msg), TIMEOUT);
+ * if (res >= 0 && port == OTA::PORT) ota.handle(src, msg, res);
+ * ...
+ * if (ota.is_verified()) ota.install();
+ * @endcode
+ * @section Limitations
+ * Chunks must be sent in order at offsets that are a multiple of
+ * the chunk size. The image must fit the flash region. The
+ * bootloader stubs in bootloaders/ do not implement the hand-over.
+ */
+class OTA {
+public:
+  /** Device port (message type) for update messages. */
+  static const uint8_t PORT = 0xf2;
+
+  /** Max size of chunk data. */
+  static const uint8_t CHUNK_MAX = COSA_OTA_CHUNK_MAX;
+
+  /** Descriptor magic number. */
+  static const uint16_t MAGIC = 0xC05A;
+
+  /** Offset of progress table in region. */
+  static const uint8_t PROGRESS = 16;
+
+  /** Default pause between chunks (ms). */
+  static const uint16_t DEFAULT_PAUSE = 20;
+
+  /** Descriptor state; bits are cleared as the image progresses. */
+  enum {
+    RECEIVING = 0xff,		//!< Image is being received.
+    VERIFIED = 0x7f,		//!< Image CRC is verified.
+    INSTALL = 0x3f,		//!< Image handed over to bootloader.
+    INSTALLED = 0x00		//!< Image installed by bootloader.
+  };
+
+  /** Message types. */
+  enum {
+    BEGIN = 0,			//!< Start or resume transfer.
+    CHUNK = 1,			//!< Image chunk.
+    END = 2,			//!< End of transfer; verify image.
+    STATUS = 3			//!< Reply with state and next offset.
+  };
+
+  /** Region descriptor. */
+  struct header_t {
+    uint16_t magic;		//!< Magic number (MAGIC).
+    uint16_t version;		//!< Image version.
+    uint32_t size;		//!< Image size in bytes.
+    uint16_t crc;		//!< Image CRC (CRC-16/XMODEM).
+    uint8_t state;		//!< Image state.
+  };
+
+  /** Begin message. */
+  struct begin_t {
+    uint8_t type;		//!< Message type (BEGIN).
+    uint16_t version;		//!< Image version.
+    uint32_t size;		//!< Image size in bytes.
+    uint16_t crc;		//!< Image CRC (CRC-16/XMODEM).
+  };
+
+  /** Chunk message header; followed by chunk data. */
+  struct chunk_t {
+    uint8_t type;		//!< Message type (CHUNK).
+    uint32_t offset;		//!< Image offset of chunk.
+    uint16_t crc;		//!< Chunk data CRC (CRC-16/XMODEM).
+  };
+
+  /** Status message. */
+  struct status_t {
+    uint8_t type;		//!< Message type (STATUS).
+    uint8_t state;		//!< Image state.
+    uint32_t offset;		//!< Next expected image offset.
+    uint16_t pause;		//!< Pause between chunks (ms).
+  };
+
+  /**
+   * Construct firmware update receiver for given wireless device
+   * driver, flash memory device and region base address (sector
+   * aligned).
+   * @param[in] dev wireless device driver.
+   * @param[in] flash memory device.
+   * @param[in] base region address.
+   * @param[in] pause between chunks (ms, default DEFAULT_PAUSE).
+   */
+  OTA(Wireless::Driver* dev, Flash::Device* flash, uint32_t base,
+      uint16_t pause = DEFAULT_PAUSE) :
+    m_dev(dev),
+    m_flash(flash),
+    m_base(base),
+    m_pause(pause),
+    m_offset(0),
+    m_stamp(0)
+  {
+    memset(&m_header, 0, sizeof(m_header));
+  }
+
+  /**
+   * Read the region descriptor and progress table. Restores the
+   * image offset of an interrupted transfer. Returns true(1) if
+   * successful otherwise false(0).
+   * @return bool.
+   */
+  bool begin();
+
+  /**
+   * Handle given update message from given source and reply with
+   * status. Returns zero(0) if the message was accepted otherwise a
+   * negative error code; EINVAL illegal message, EAGAIN throttled
+   * or flash busy, EFAULT flash or CRC error.
+   * @param[in] src source device address.
+   * @param[in] buf message buffer.
+   * @param[in] len number of bytes in message.
+   * @return zero or negative error code.
+   */
+  int handle(uint8_t src, const void* buf, size_t len);
+
+  /**
+   * Return true(1) if a complete image has been received and
+   * verified otherwise false(0).
+   * @return bool.
+   */
+  bool is_verified() const
+  {
+    return ((m_header.magic == MAGIC) && (m_header.state == VERIFIED));
+  }
+
+  /**
+   * Return next expected image offset.
+   * @return offset.
+   */
+  uint32_t offset() const
+  {
+    return (m_offset);
+  }
+
+  /**
+   * Hand the verified image over to the bootloader; program the
+   * descriptor state to INSTALL and reset the processor with the
+   * watchdog. Returns only if the image is not verified.
+   */
+  void install();
+
+protected:
+  /** Wireless device driver. */
+  Wireless::Driver* m_dev;
+
+  /** Flash memory device. */
+  Flash::Device* m_flash;
+
+  /** Region base address. */
+  uint32_t m_base;
+
+  /** Pause between chunks (ms). */
+  uint16_t m_pause;
+
+  /** Next expected image offset. */
+  uint32_t m_offset;
+
+  /** Time of latest accepted chunk (ms). */
+  uint32_t m_stamp;
+
+  /** Region descriptor. */
+  header_t m_header;
+
+  /**
+   * Return flash address of the image.
+   * @return address.
+   */
+  uint32_t image() const
+  {
+    return (m_base + m_flash->SECTOR_BYTES);
+  }
+
+  /**
+   * Program descriptor state.
+   * @param[in] state to program.
+   * @return zero or negative error code.
+   */
+  int state(uint8_t state);
+
+  /**
+   * Start or resume transfer for given begin message.
+   * @param[in] msg begin message.
+   * @return zero or negative error code.
+   */
+  int on_begin(const begin_t* msg);
+
+  /**
+   * Write given chunk message with given data size.
+   * @param[in] msg chunk message.
+   * @param[in] size number of bytes of data.
+   * @return zero or negative error code.
+   */
+  int on_chunk(const chunk_t* msg, size_t size);
+
+  /**
+   * Verify image CRC and program descriptor state to VERIFIED.
+   * @return zero or negative error code.
+   */
+  int on_end();
+
+  /**
+   * Send status message to given destination.
+   * @param[in] dest device address.
+   */
+  void reply(uint8_t dest);
+};
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file CosaOTA.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of over-the-air firmware update; receive image in
+ * the background to external flash memory while handling normal
+ * messages, and hand the verified image over to the bootloader.
+ *
+ * @section Circuit
+ * See Wireless and Flash drivers for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <OTA.h>
+#include "Cosa/RTT.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Configuration; network and device addresses
+#define NETWORK 0xC05A
+#define DEVICE 0x01
+
+// Select Wireless device driver
+// #include <CC1101.h>
+// CC1101 rf(NETWORK, DEVICE);
+
+#include <NRF24L01P.h>
+NRF24L01P rf(NETWORK, DEVICE);
+
+// #include <RFM69.h>
+// RFM69 rf(NETWORK, DEVICE);
+
+// Select Flash memory device driver
+#define USE_FLASH_S25FL127S
+//#define USE_FLASH_W25X40CL
+
+#if defined(USE_FLASH_S25FL127S) || defined(ANARDUINO_MINIWIRELESS)
+#include <S25FL127S.h>
+S25FL127S flash;
+#endif
+
+#if defined(USE_FLASH_W25X40CL) || defined(WICKEDDEVICE_WILDFIRE)
+#include <W25X40CL.h>
+W25X40CL flash;
+#endif
+
+// Firmware update region; last 64 Kbyte of flash memory
+#define OTA_BASE (flash.DEVICE_BYTES - 0x10000UL)
+OTA ota(&rf, &flash, OTA_BASE);
+
+void setup()
+{
+  uart.begin(57600);
+  trace.begin(&uart, PSTR("CosaOTA: started"));
+  Watchdog::begin();
+  RTT::begin();
+  ASSERT(flash.begin());
+  ASSERT(rf.begin());
+  ASSERT(ota.begin());
+  TRACE(ota.offset());
+}
+
+void loop()
+{
+  uint8_t msg[32];
+  uint8_t src;
+  uint8_t port;
+  int res = rf.recv(src, port, msg, sizeof(msg), 1000);
+  if (res < 0) return;
+
+  // Update messages are handled in the background
+  if (port == OTA::PORT) {
+    if (ota.handle(src, msg, res) < 0) return;
+    if (!ota.is_verified()) return;
+    trace << PSTR("OTA: image verified; install") << endl << flush;
+    ota.install();
+    return;
+  }
+
+  // Normal message handling
+  trace << PSTR("src=") << hex << src
+	<< PSTR(",port=") << hex << port
+	<< PSTR(",len=") << res
+	<< endl;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file FastOWI.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section References
+ * AVR318: Dallas 1-Wire(R) master, Rev. 2579A-AVR-09/04,
+ * Table 3. Bit transfer layer delays.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_FAST_OWI_HH
+#define COSA_FAST_OWI_HH
+
+#include "Cosa/FastPin.hh"
+#include "Cosa/CRC.hh"
+#include "OWI.hh"
+
+/**
+ * 1-wire bus master with compile-time pin. Same bit transfer layer
+ * as OWI but with the pin access reduced to single instructions;
+ * shorter and more accurate time slots. There is no device driver
+ * list or rom search; intended for a single device on the bus
+ * (OWI::SKIP_ROM/READ_ROM) in time critical code. Use OWI and
+ * OWI::Driver for multiple devices.
+ * @param[in] PIN one wire bus pin.
+ */
+template<Board::DigitalPin PIN>
+class FastOWI {
+public:
+  /**
+   * Construct one wire bus master.
+   */
+  FastOWI() : m_crc(0) {}
+
+  /**
+   * Reset the one wire bus and check that at least one device is
+   * presence.
+   * @return true(1) if successful otherwise false(0).
+   */
+  bool reset()
+  {
+    uint8_t retry = 4;
+    uint8_t res = 0;
+    do {
+      FastPin<PIN>::output(1);
+      FastPin<PIN>::clear();
+      DELAY(480);
+      FastPin<PIN>::set();
+      synchronized {
+	FastPin<PIN>::input(1);
+	DELAY(70);
+	res = FastPin<PIN>::is_clear();
+      }
+      DELAY(410);
+    } while (retry-- && !res);
+    return (res != 0);
+  }
+
+  /**
+   * Read the given number of bits from the one wire bus. Default
+   * number of bits is 8. Returns the value read LSB aligned.
+   * @param[in] bits to be read.
+   * @return value read.
+   */
+  uint8_t read(uint8_t bits = CHARBITS)
+  {
+    uint8_t res = 0;
+    uint8_t adjust = CHARBITS - bits;
+    while (bits--) {
+      synchronized {
+	FastPin<PIN>::output(1);
+	FastPin<PIN>::clear();
+	DELAY(6);
+	FastPin<PIN>::input(1);
+	DELAY(9);
+	res >>= 1;
+	if (FastPin<PIN>::is_set()) res |= 0x80;
+      }
+      DELAY(55);
+    }
+    res >>= adjust;
+    crc_update(res, CHARBITS - adjust);
+    return (res);
+  }
+
+  /**
+   * Read the given number of bytes from the one wire bus to the
+   * given buffer. Return true(1) if the crc is correct otherwise
+   * false(0).
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes to read.
+   * @return bool.
+   */
+  bool read(void* buf, uint8_t size)
+  {
+    uint8_t* bp = (uint8_t*) buf;
+    m_crc = 0;
+    while (size--) *bp++ = read();
+    return (m_crc == 0);
+  }
+
+  /**
+   * Write the given value to the one wire bus. The bits are written
+   * from LSB to MSB. Pass true(1) for power to leave the pin high
+   * for parasite powered devices; turn off with power_off().
+   * @param[in] value to write.
+   * @param[in] bits to be written.
+   * @param[in] power on for parasite device.
+   */
+  void write(uint8_t value, uint8_t bits = CHARBITS, bool power = false)
+  {
+    crc_update(value, bits);
+    FastPin<PIN>::output(1);
+    while (bits--) {
+      synchronized {
+	FastPin<PIN>::clear();
+	if (value & 1) {
+	  DELAY(6);
+	  FastPin<PIN>::set();
+	  DELAY(64);
+	}
+	else {
+	  DELAY(60);
+	  FastPin<PIN>::set();
+	  DELAY(10);
+	}
+      }
+      value >>= 1;
+    }
+    if (!power) power_off();
+  }
+
+  /**
+   * Write the given value and given number of bytes from buffer to
+   * the one wire bus.
+   * @param[in] value to write.
+   * @param[in] buf buffer pointer.
+   * @param[in] size number of bytes to write.
+   */
+  void write(uint8_t value, void* buf, uint8_t size)
+  {
+    write(value);
+    uint8_t* bp = (uint8_t*) buf;
+    while (size--) write(*bp++);
+  }
+
+  /**
+   * Turn off parasite powering of pin. See also write().
+   */
+  void power_off()
+    __attribute__((always_inline))
+  {
+    FastPin<PIN>::input();
+  }
+
+  /**
+   * Reset the bus and skip device rom; single device or broadcast
+   * access. Device specific function command should follow.
+   * @return true(1) if successful otherwise false(0).
+   */
+  bool skip_rom()
+  {
+    if (!reset()) return (false);
+    write(OWI::SKIP_ROM);
+    return (true);
+  }
+
+private:
+  /** Intermediate CRC sum. */
+  uint8_t m_crc;
+
+  /**
+   * Update intermediate CRC sum with given number of bits (LSB
+   * first). Full bytes use the table driven CRC8-Maxim.
+   * @param[in] value bits.
+   * @param[in] bits number of bits.
+   */
+  void crc_update(uint8_t value, uint8_t bits)
+  {
+    if (bits == CHARBITS) {
+      m_crc = CRC::crc8_maxim_update(m_crc, value);
+      return;
+    }
+    while (bits--) {
+      uint8_t mix = (m_crc ^ value);
+      value >>= 1;
+      m_crc >>= 1;
+      if (mix & 1) m_crc ^= 0x8C;
+    }
+  }
+};
+
+#endif
@@ -24,20 +24,51 @@
  */
 
 #include "OWI.hh"
+#include "Cosa/CRC.hh"
+
+// Update check sum with given number of bits (LSB first)
+static uint8_t
+crc_update(uint8_t crc, uint8_t value, uint8_t bits)
+{
+  if (bits == CHARBITS) return (CRC::crc8_maxim_update(crc, value));
+  while (bits--) {
+    uint8_t mix = (crc ^ value);
+    value >>= 1;
+    crc >>= 1;
+    if (mix & 1) crc ^= 0x8C;
+  }
+  return (crc);
+}
 
 bool
 OWI::reset()
 {
   uint8_t retry = 4;
   uint8_t res = 0;
+  if (m_overdrive) {
+    do {
+      output();
+      set();
+      clear();
+      DELAY(70);
+      set();
+      synchronized {
+	input();
+	DELAY(8);
+	res = is_clear();
+      }
+      DELAY(40);
+    } while (retry-- && !res);
+    return (res != 0);
+  }
   do {
-    mode(OUTPUT_MODE);
+    output();
     set();
     clear();
     DELAY(480);
     set();
     synchronized {
-      mode(INPUT_MODE);
+      input();
       DELAY(70);
       res = is_clear();
     }
@@ -50,30 +81,37 @@ uint8_t
 OWI::read(uint8_t bits)
 {
   uint8_t res = 0;
-  uint8_t mix = 0;
   uint8_t adjust = CHARBITS - bits;
   while (bits--) {
-    synchronized {
-      mode(OUTPUT_MODE);
-      set();
-      clear();
-      DELAY(6);
-      mode(INPUT_MODE);
-      DELAY(9);
-      res >>= 1;
-      if (is_set()) {
-	res |= 0x80;
-	mix = (m_crc ^ 1);
+    if (m_overdrive) {
+      synchronized {
+	output();
+	set();
+	clear();
+	DELAY(1);
+	input();
+	DELAY(1);
+	res >>= 1;
+	if (is_set()) res |= 0x80;
       }
-      else {
-	mix = (m_crc ^ 0);
+      DELAY(7);
+    }
+    else {
+      synchronized {
+	output();
+	set();
+	clear();
+	DELAY(6);
+	input();
+	DELAY(9);
+	res >>= 1;
+	if (is_set()) res |= 0x80;
       }
+      DELAY(55);
     }
-    m_crc >>= 1;
-    if (mix & 1) m_crc ^= 0x8C;
-    DELAY(55);
   }
   res >>= adjust;
+  m_crc = crc_update(m_crc, res, CHARBITS - adjust);
   return (res);
 }
 
@@ -89,29 +127,44 @@ OWI::read(void* buf, uint8_t size)
 void
 OWI::write(uint8_t value, uint8_t bits, bool power)
 {
-  uint8_t mix = 0;
-  mode(OUTPUT_MODE);
+  uint8_t data = value;
+  uint8_t count = bits;
+  output();
   set();
   while (bits--) {
-    synchronized {
-      clear();
-      if (value & 1) {
-	DELAY(6);
-	set();
-	DELAY(64);
-	mix = (m_crc ^ 1);
+    if (m_overdrive) {
+      synchronized {
+	clear();
+	if (value & 1) {
+	  DELAY(1);
+	  set();
+	  DELAY(8);
+	}
+	else {
+	  DELAY(8);
+	  set();
+	  DELAY(2);
+	}
       }
-      else {
-	DELAY(60);
-	set();
-	DELAY(10);
-	mix = (m_crc ^ 0);
+    }
+    else {
+      synchronized {
+	clear();
+	if (value & 1) {
+	  DELAY(6);
+	  set();
+	  DELAY(64);
+	}
+	else {
+	  DELAY(60);
+	  set();
+	  DELAY(10);
+	}
       }
     }
     value >>= 1;
-    m_crc >>= 1;
-    if (mix & 1) m_crc ^= 0x8C;
   }
+  m_crc = crc_update(m_crc, data, count);
   if (!power) power_off();
 }
 
@@ -123,6 +176,39 @@ OWI::write(uint8_t value, void* buf, uint8_t size)
   while (size--) write(*bp++);
 }
 
+uint8_t
+OWI::triplet(uint8_t direction)
+{
+  uint8_t res = read(2);
+  switch (res) {
+  case 0b00: // Discrepancy between device roms
+    break;
+  case 0b01: // Only one's at this position
+    direction = 1;
+    break;
+  case 0b10: // Only zero's at this position
+    direction = 0;
+    break;
+  case 0b11: // No device detected
+    return (res);
+  }
+  write(direction, 1);
+  return (res | (direction << 2));
+}
+
+bool
+OWI::overdrive(bool enable)
+{
+  if (enable == m_overdrive) return (true);
+  if (enable) {
+    if (!reset()) return (false);
+    write(OVERDRIVE_SKIP_ROM);
+    return (speed(true));
+  }
+  if (!speed(false)) return (false);
+  return (reset());
+}
+
 OWI::Driver*
 OWI::lookup(uint8_t* rom)
 {
@@ -146,6 +232,15 @@ OWI::alarm_dispatch()
   return (true);
 }
 
+uint8_t
+OWI::verify()
+{
+  uint8_t res = 0;
+  for (Driver* dev = m_device; dev != NULL; dev = dev->m_next)
+    if (!dev->verify_rom()) res += 1;
+  return (res);
+}
+
 IOStream& operator<<(IOStream& outs, OWI& owi)
 {
   OWI::Driver dev(&owi);
@@ -165,6 +260,14 @@ OWI::Driver::Driver(OWI* pin, const uint8_t* rom, const char* name) :
   m_pin(pin)
 {
   eeprom_read_block(m_rom, rom, sizeof(m_rom));
+  attach();
+}
+
+void
+OWI::Driver::attach()
+{
+  for (Driver* dev = m_pin->m_device; dev != NULL; dev = dev->m_next)
+    if (dev == this) return;
   m_pin->m_devices += 1;
   m_next = m_pin->m_device;
   m_pin->m_device = this;
@@ -186,37 +289,22 @@ OWI::Driver::search(int8_t last)
   for (uint8_t i = 0; i < 8; i++) {
     uint8_t data = 0;
     for (uint8_t j = 0; j < 8; j++) {
-      data >>= 1;
-      switch (m_pin->read(2)) {
-      case 0b00: // Discrepency between device roms
-	if (pos == last) {
-	  m_pin->write(1, 1);
-	  data |= 0x80;
-	  last = FIRST;
-	}
-	else if (pos > last) {
-	  m_pin->write(0, 1);
-	  next = pos;
-	}
-	else if (m_rom[i] & (1 << j)) {
-	  m_pin->write(1, 1);
-	  data |= 0x80;
-	}
-	else {
-	  m_pin->write(0, 1);
-	  next = pos;
-	}
-	break;
-      case 0b01: // Only one's at this position
-	m_pin->write(1, 1);
-	data |= 0x80;
-	break;
-      case 0b10: // Only zero's at this position
-	m_pin->write(0, 1);
-	break;
-      case 0b11: // No device detected
-	return (ERROR);
+      // Select direction on discrepancy between device roms
+      uint8_t dir;
+      if (pos == last) dir = 1;
+      else if (pos > last) dir = 0;
+      else dir = ((m_rom[i] & (1 << j)) != 0);
+      uint8_t res = m_pin->triplet(dir);
+      if (res == 0b011) return (ERROR);
+      dir = (res >> 2);
+      if (res == 0b000) {
+	// Follow the new branch on the last discrepancy; record
+	// the latest zero branch as next discrepancy
+	if (pos == last) last = FIRST;
+	else if (dir == 0) next = pos;
       }
+      data >>= 1;
+      if (dir) data |= 0x80;
       pos += 1;
     }
     m_rom[i] = data;
@@ -268,6 +356,20 @@ OWI::Driver::alarm_search(int8_t last)
   return (search(last));
 }
 
+bool
+OWI::Driver::verify_rom()
+{
+  // Search following the rom code; at each discrepancy the rom bit
+  // is selected. The result differs from the rom code if the device
+  // is not present
+  if (m_rom[0] == 0) return (false);
+  uint8_t rom[ROM_MAX];
+  memcpy(rom, m_rom, ROM_MAX);
+  bool res = (search_rom(LAST) != ERROR) && !memcmp(rom, m_rom, ROM_MAX);
+  memcpy(m_rom, rom, ROM_MAX);
+  return (res);
+}
+
 bool
 OWI::Driver::connect(uint8_t family, uint8_t index)
 {
@@ -277,9 +379,7 @@ OWI::Driver::connect(uint8_t family, uint8_t index)
     if (last == ERROR) return (false);
     if (m_rom[0] == family) {
       if (index == 0) {
-	m_pin->m_devices += 1;
-	m_next = m_pin->m_device;
-	m_pin->m_device = this;
+	attach();
 	return (true);
       }
       index -= 1;
@@ -289,6 +389,18 @@ OWI::Driver::connect(uint8_t family, uint8_t index)
   return (false);
 }
 
+bool
+OWI::Driver::reconnect(uint8_t family, uint8_t index)
+{
+  if (m_rom[0] == family && verify_rom()) {
+    attach();
+    return (true);
+  }
+  if (!connect(family, index)) return (false);
+  update_rom();
+  return (true);
+}
+
 IOStream& operator<<(IOStream& outs, OWI::Driver& dev)
 {
   uint8_t i;
@@ -306,11 +418,14 @@ IOStream& operator<<(IOStream& outs, OWI::Driver& dev)
 OWI::Driver*
 OWI::Search::next()
 {
+  Driver* dev;
   do {
     if (m_last == LAST) return (NULL);
     m_last = alarm_search(m_last);
     if (m_last == ERROR) return (NULL);
-  } while ((m_family != 0) && (m_rom[0] != m_family));
-  return (m_pin->lookup(m_rom));
+    if ((m_family != 0) && (m_rom[0] != m_family)) continue;
+    dev = m_pin->lookup(m_rom);
+    if (dev != NULL) return (dev);
+  } while (1);
 }
 
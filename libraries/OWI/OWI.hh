@@ -27,13 +27,19 @@
 
 /**
  * 1-wire device driver support class. Allows device rom search
- * and connection to multiple devices on one-wire bus.
+ * and connection to multiple devices on one-wire bus. The default
+ * transport bit-bangs the given pin with standard or overdrive
+ * speed timing. The bus primitives; reset(), read(), write(),
+ * power_off(), triplet() and speed() are virtual and may be
+ * overridden by a bus master bridge (e.g. DS2482::Bus) so that the
+ * device drivers run unchanged over the bridge.
  *
  * @section Limitations
- * The driver will turn off interrupt handling during data read
- * from the device.
+ * The bit-bang transport will turn off interrupt handling during
+ * each time slot; max 70 us at standard speed and 10 us at
+ * overdrive speed. Overdrive speed requires 16 MHz.
  */
-class OWI : private IOPin {
+class OWI {
 public:
   /**
    * Standard ROM Commands.
@@ -43,7 +49,9 @@ public:
     READ_ROM = 0x33,
     MATCH_ROM = 0x55,
     SKIP_ROM = 0xCC,
-    ALARM_SEARCH = 0xEC
+    ALARM_SEARCH = 0xEC,
+    OVERDRIVE_SKIP_ROM = 0x3C,
+    OVERDRIVE_MATCH_ROM = 0x69
   } __attribute__((packed));
 
   /** ROM size in bytes. */
@@ -144,6 +152,15 @@ public:
      */
     int8_t alarm_search(int8_t last = FIRST);
 
+    /**
+     * Verify that the device with the current rom code is present on
+     * the bus. Performs a single search pass that follows the rom
+     * code; the time is independent of the number of devices on the
+     * bus. Return true(1) if present otherwise false(0).
+     * @return bool.
+     */
+    bool verify_rom();
+
     /**
      * Connect to one-wire device with given family code and index.
      * @param[in] family device family code.
@@ -152,6 +169,18 @@ public:
      */
     bool connect(uint8_t family, uint8_t index);
 
+    /**
+     * Reconnect to one-wire device with given family code and
+     * index. The cached rom code (e.g. from EEPROM) is verified and
+     * the full rom search is only performed if the device is not
+     * present; the new rom code is then saved with update_rom().
+     * Return true(1) if successful otherwise false(0).
+     * @param[in] family device family code.
+     * @param[in] index device order.
+     * @return bool.
+     */
+    bool reconnect(uint8_t family, uint8_t index);
+
     /**
      * @override{OWI::Driver}
      * Callback on alarm dispatch. Default is empty function.
@@ -172,13 +201,21 @@ public:
      */
     int8_t search(int8_t last = FIRST);
 
+    /**
+     * Add driver to the device list of the bus if not already
+     * attached.
+     */
+    void attach();
+
     friend class OWI;
     friend IOStream& operator<<(IOStream& outs, OWI& owi);
     friend IOStream& operator<<(IOStream& outs, Driver& dev);
   };
 
   /**
-   * Alarm search iterator class.
+   * Alarm search iterator class. Uses the conditional search command
+   * (ALARM_SEARCH); only devices with an alarm flag respond. Alarming
+   * devices without a driver are skipped.
    */
   class Search : protected Driver {
   public:
@@ -219,26 +256,52 @@ public:
    * @param[in] pin number.
    */
   OWI(Board::DigitalPin pin) :
-    IOPin(pin),
+    m_sfr(Pin::PIN(pin)),
+    m_mask(Pin::MASK(pin)),
+    m_overdrive(false),
     m_devices(0),
     m_device(NULL),
     m_crc(0)
-  {}
+  {
+    input();
+  }
+
+  /**
+   * Return true(1) if the bus is in overdrive speed otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool is_overdrive() const
+  {
+    return (m_overdrive);
+  }
 
   /**
+   * Set bus speed. Overdrive is entered with OVERDRIVE_SKIP_ROM at
+   * standard speed; all overdrive capable devices on the bus switch
+   * speed. Standard speed is restored with a standard speed reset.
+   * Return true(1) if successful otherwise false(0).
+   * @param[in] enable overdrive speed.
+   * @return bool.
+   */
+  bool overdrive(bool enable);
+
+  /**
+   * @override{OWI}
    * Reset the one wire bus and check that at least one device is
    * presence.
    * @return true(1) if successful otherwise false(0).
    */
-  bool reset();
+  virtual bool reset();
 
   /**
+   * @override{OWI}
    * Read the given number of bits from the one wire bus (slave).
    * Default number of bits is 8. Returns the value read LSB aligned.
    * @param[in] bits to be read.
    * @return value read.
    */
-  uint8_t read(uint8_t bits = CHARBITS);
+  virtual uint8_t read(uint8_t bits = CHARBITS);
 
   /**
    * Read given number of bytes from one wire bus (slave) to given
@@ -250,6 +313,7 @@ public:
   bool read(void* buf, uint8_t size);
 
   /**
+   * @override{OWI}
    * Write the given value to the one wire bus. The bits are written
    * from LSB to MSB. Pass true(1) for power parameter to allow
    * parasite devices to be powered. Should be turned off with power_off().
@@ -257,7 +321,7 @@ public:
    * @param[in] bits to be written.
    * @param[in] power on for parasite device.
    */
-  void write(uint8_t value, uint8_t bits = CHARBITS, bool power = false);
+  virtual void write(uint8_t value, uint8_t bits = CHARBITS, bool power = false);
 
   /**
    * Write the given value and given number of bytes from buffer to
@@ -269,15 +333,27 @@ public:
   void write(uint8_t value, void* buf, uint8_t size);
 
   /**
+   * @override{OWI}
    * Turn off parasite powering of pin. See also write().
    */
-  void power_off()
-    __attribute__((always_inline))
+  virtual void power_off()
   {
-    mode(INPUT_MODE);
+    input();
     clear();
   }
 
+  /**
+   * @override{OWI}
+   * Search triplet; read rom bit and complement, and write the
+   * selected direction. The given direction is used on discrepancy
+   * (both bits zero). Returns rom bit (bit 0), complement (bit 1)
+   * and direction taken (bit 2). Both bits set (0b011) when no
+   * device responded; direction is then not written.
+   * @param[in] direction on discrepancy.
+   * @return triplet status.
+   */
+  virtual uint8_t triplet(uint8_t direction);
+
   /**
    * Lookup the driver instance with the given rom address.
    * @return driver pointer or null(0).
@@ -292,7 +368,50 @@ public:
    */
   bool alarm_dispatch();
 
-private:
+  /**
+   * Verify that all attached drivers are present on the bus. Return
+   * number of drivers that could not be verified; zero(0) if no
+   * device has vanished.
+   * @return number of missing devices.
+   */
+  uint8_t verify();
+
+protected:
+  /**
+   * Construct one wire bus without pin; bus master bridge. The bus
+   * primitives must be overridden.
+   */
+  OWI() :
+    m_sfr(NULL),
+    m_mask(0),
+    m_overdrive(false),
+    m_devices(0),
+    m_device(NULL),
+    m_crc(0)
+  {}
+
+  /**
+   * @override{OWI}
+   * Set bus master speed. Default sets the bit-bang time slots.
+   * Return true(1) if successful otherwise false(0).
+   * @param[in] overdrive speed.
+   * @return bool.
+   */
+  virtual bool speed(bool overdrive)
+  {
+    m_overdrive = overdrive;
+    return (true);
+  }
+
+  /** Pin input register (followed by data direction and port). */
+  volatile uint8_t* m_sfr;
+
+  /** Pin mask. */
+  uint8_t m_mask;
+
+  /** Overdrive speed. */
+  bool m_overdrive;
+
   /** Number of devices. */
   uint8_t m_devices;
 
@@ -301,6 +420,43 @@ private:
 
   /** Intermediate CRC sum. */
   uint8_t m_crc;
+
+  /** Pin access for the bit-bang transport. */
+  void input()
+    __attribute__((always_inline))
+  {
+    synchronized *(m_sfr + 1) &= ~m_mask;
+  }
+
+  void output()
+    __attribute__((always_inline))
+  {
+    synchronized *(m_sfr + 1) |= m_mask;
+  }
+
+  void set()
+    __attribute__((always_inline))
+  {
+    synchronized *(m_sfr + 2) |= m_mask;
+  }
+
+  void clear()
+    __attribute__((always_inline))
+  {
+    synchronized *(m_sfr + 2) &= ~m_mask;
+  }
+
+  bool is_set() const
+    __attribute__((always_inline))
+  {
+    return ((*m_sfr & m_mask) != 0);
+  }
+
+  bool is_clear() const
+    __attribute__((always_inline))
+  {
+    return ((*m_sfr & m_mask) == 0);
+  }
 };
 
 /**
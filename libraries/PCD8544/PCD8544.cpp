@@ -37,7 +37,11 @@ PCD8544::PCD8544(LCD::IO* io, Board::DigitalPin dc, Font* font) :
   LCD::Device(),
   m_io(io),
   m_dc(dc, 1),
-  m_font(font)
+  m_font(font),
+  m_fb(NULL),
+  m_fx(0),
+  m_fy(0),
+  m_dirty(0)
 {
 }
 
@@ -54,6 +58,11 @@ PCD8544::set(uint8_t cmd)
 void
 PCD8544::set(uint8_t x, uint8_t y)
 {
+  if (m_fb != NULL) {
+    m_fx = (x < WIDTH) ? x : 0;
+    m_fy = (y < LINES) ? y : 0;
+    return;
+  }
   m_io->begin();
   asserted(m_dc) {
     m_io->write(SET_X_ADDR | (x & X_ADDR_MASK));
@@ -62,12 +71,60 @@ PCD8544::set(uint8_t x, uint8_t y)
   m_io->end();
 }
 
+void
+PCD8544::data(uint8_t data)
+{
+  if (m_fb == NULL) {
+    m_io->write(data);
+    return;
+  }
+  m_fb->bitmap()[(m_fy * WIDTH) + m_fx] = data;
+  m_dirty |= (1 << m_fy);
+  if (++m_fx < WIDTH) return;
+  m_fx = 0;
+  if (++m_fy == LINES) m_fy = 0;
+}
+
 void
 PCD8544::fill(uint8_t data, uint16_t count)
 {
-  m_io->begin();
-  while (count--) m_io->write(data);
-  m_io->end();
+  data_begin();
+  while (count--) this->data(data);
+  data_end();
+}
+
+PCD8544::FrameBuffer*
+PCD8544::set_framebuffer(FrameBuffer* fb)
+{
+  FrameBuffer* previous = m_fb;
+  m_fb = fb;
+  m_dirty = (fb != NULL) ? 0xff : 0;
+  set(m_x, m_y);
+  return (previous);
+}
+
+int
+PCD8544::flush()
+{
+  if (m_fb == NULL) return (0);
+
+  // Collect changed pages; text and canvas drawing
+  uint8_t dirty = m_dirty | m_fb->damaged_pages();
+  m_dirty = 0;
+
+  // Send each changed page with a single address setting and burst
+  const uint8_t* bp = m_fb->bitmap();
+  for (uint8_t y = 0; y < LINES; y++, bp += WIDTH) {
+    if ((dirty & (1 << y)) == 0) continue;
+    m_io->begin();
+    asserted(m_dc) {
+      m_io->write(SET_X_ADDR);
+      m_io->write(SET_Y_ADDR | y);
+    }
+    m_io->write(bp, WIDTH);
+    m_io->end();
+  }
+  return (0);
 }
 
 bool
@@ -153,11 +210,11 @@ PCD8544::draw_icon(const uint8_t* bp)
   uint8_t height = pgm_read_byte(bp++);
   uint8_t lines = (height >> 3);
   for (uint8_t y = 0; y < lines; y++) {
-    m_io->begin();
+    data_begin();
     for (uint8_t x = 0; x < width; x++) {
-      m_io->write(m_mode ^ pgm_read_byte(bp++));
+      data(m_mode ^ pgm_read_byte(bp++));
     }
-    m_io->end();
+    data_end();
     set_cursor(m_x, m_y + 1);
   }
   set_cursor(m_x, m_y + 1);
@@ -168,11 +225,11 @@ PCD8544::draw_bitmap(uint8_t* bp, uint8_t width, uint8_t height)
 {
   uint8_t lines = (height >> 3);
   for (uint8_t y = 0; y < lines; y++) {
-    m_io->begin();
+    data_begin();
     for (uint8_t x = 0; x < width; x++) {
-      m_io->write(m_mode ^ (*bp++));
+      data(m_mode ^ (*bp++));
     }
-    m_io->end();
+    data_end();
     set_cursor(m_x, m_y + 1);
   }
   m_y += 1;
@@ -186,20 +243,20 @@ PCD8544::draw_bar(uint8_t percent, uint8_t width, uint8_t pattern)
   uint8_t filled = (percent * (width - 2U)) / 100;
   uint8_t boarder = (m_y == 0 ? 0x81 : 0x80);
   width -= (filled + 1);
-  m_io->begin();
-  m_io->write(m_mode ^ 0xff);
+  data_begin();
+  data(m_mode ^ 0xff);
   while (filled--) {
-    m_io->write(m_mode ^ (pattern | boarder));
+    data(m_mode ^ (pattern | boarder));
     pattern = ~pattern;
   }
-  m_io->write(m_mode ^ 0xff);
+  data(m_mode ^ 0xff);
   width -= 1;
   if (width > 0) {
     while (width--)
-      m_io->write(m_mode ^ boarder);
+      data(m_mode ^ boarder);
   }
-  m_io->write(m_mode ^ 0xff);
-  m_io->end();
+  data(m_mode ^ 0xff);
+  data_end();
 }
 
 int
@@ -265,11 +322,11 @@ PCD8544::putchar(char c)
   }
 
   // Write character to the display memory and an extra byte
-  m_io->begin();
+  data_begin();
   while (--width)
-    m_io->write(m_mode ^ glyph.next());
-  m_io->write(m_mode);
-  m_io->end();
+    data(m_mode ^ glyph.next());
+  data(m_mode);
+  data_end();
 
   return (c);
 }
@@ -26,6 +26,7 @@
 #include "Cosa/LCD.hh"
 
 #include <Canvas.h>
+#include "Canvas/OffScreen.hh"
 #include "System5x7.hh"
 
 /**
@@ -35,6 +36,11 @@
  * form-feed, back-space and new-line. Graphics may be performed
  * with OffScreen Canvas and copied to the display with draw_bitmap().
  *
+ * An off-screen canvas may also be set as frame buffer. Text and
+ * graphics are then written to the buffer and flush() sends only
+ * the changed pages (bitmap rows of eight pixels) to the display;
+ * one address setting and data burst per page.
+ *
  * @section Circuit
  * PCD8544 is a low voltage device (3V3) and signals require level
  * shifter (74HC4050 or 10K resistor).
@@ -75,6 +81,9 @@ public:
   static const uint8_t HEIGHT = 48;
   static const uint8_t LINES = HEIGHT / CHARBITS;
 
+  /** Frame buffer; off-screen canvas with display memory layout. */
+  typedef OffScreen<WIDTH, HEIGHT> FrameBuffer;
+
   /**
    * Construct display device driver with given io adapter, chip
    * select pin and font.
@@ -171,6 +180,46 @@ public:
     return (previous);
   }
 
+  /**
+   * Get frame buffer.
+   * @return frame buffer or NULL.
+   */
+  FrameBuffer* get_framebuffer() const
+  {
+    return (m_fb);
+  }
+
+  /**
+   * Set frame buffer. When set text and drawing is written to the
+   * buffer (504 bytes) and flush() will send the changed pages to the
+   * display. Drawing on the frame buffer canvas is tracked as damaged
+   * pages. The display content is assumed unknown and all pages are
+   * sent on the first flush(). Passing NULL will disable the frame
+   * buffer. Returns previous setting.
+   * @param[in] fb frame buffer.
+   * @return previous frame buffer.
+   *
+   * @section Usage
+   * @code
+   * PCD8544::FrameBuffer fb;
+   * ...
+   * lcd.set_framebuffer(&fb);
+   * fb.draw_circle(20, 20, 10);
+   * lcd.set_cursor(0, 5);
+   * trace << PSTR("circle");
+   * lcd.flush();
+   * @endcode
+   */
+  FrameBuffer* set_framebuffer(FrameBuffer* fb);
+
+  /**
+   * @override{IOStream::Device}
+   * Send changed pages in the frame buffer to the display. Returns
+   * zero(0).
+   * @return zero(0) or negative error code.
+   */
+  virtual int flush();
+
   /**
    * Draw icon in the current mode. The icon must be stored in program
    * memory with width, height and data.
@@ -242,6 +291,10 @@ protected:
   LCD::IO* m_io;		//!< Display adapter.
   OutputPin m_dc;		//!< Data/command output pin.
   Font* m_font;			//!< Font.
+  FrameBuffer* m_fb;		//!< Frame buffer or NULL.
+  uint8_t m_fx;			//!< Frame buffer column.
+  uint8_t m_fy;			//!< Frame buffer page.
+  uint8_t m_dirty;		//!< Changed pages in frame buffer.
 
   /**
    * Set the given command code.
@@ -256,6 +309,30 @@ protected:
    */
   void set(uint8_t x, uint8_t y);
 
+  /**
+   * Start data block; display adapter unless frame buffer.
+   */
+  void data_begin()
+  {
+    if (m_fb == NULL) m_io->begin();
+  }
+
+  /**
+   * Write given data to the display or frame buffer at the current
+   * address. The address is incremented as the display memory
+   * (horizontal addressing).
+   * @param[in] data to write.
+   */
+  void data(uint8_t data);
+
+  /**
+   * End data block; display adapter unless frame buffer.
+   */
+  void data_end()
+  {
+    if (m_fb == NULL) m_io->end();
+  }
+
   /**
    * Fill display with given data.
    * @param[in] data to fill with.
@@ -158,6 +158,16 @@ void setup()
   lcd.set_cursor(0, 0);
   lcd.draw_bitmap(offscreen.bitmap(), offscreen.WIDTH, offscreen.HEIGHT);
   sleep(4);
+
+  // Use the off-screen canvas as frame buffer; mixed text and graphics.
+  // Only the changed pages are sent to the LCD on flush
+  lcd.set_framebuffer(&offscreen);
+  lcd.set_cursor(0, 5);
+  trace << PSTR("\aFRAME BUFFER\a");
+  offscreen.fill_circle(72, 20, 8);
+  lcd.flush();
+  sleep(4);
+  lcd.set_framebuffer(NULL);
 #endif
 }
 
@@ -50,7 +50,7 @@ PCF8563::get_time(time_t& now)
   now.hours &= 0x3f;
   now.day &= 0x3f;
   now.date &= 0x07;
-  now.month &= 0x0f;
+  now.month &= 0x1f;
   // Map to time struct
   uint8_t temp = now.day;
   now.day = now.date + 1;
@@ -129,6 +129,39 @@ PCF8563::clear_alarm()
   return (res == sizeof(alarm));
 }
 
+bool
+PCF8563::get_clock(clock_t& now)
+{
+  time_t clock;
+  if (UNLIKELY(!get_time(clock))) return (false);
+  clock.to_binary();
+  now = clock;
+  return (true);
+}
+
+bool
+PCF8563::set_wakeup(clock_t when)
+{
+  // Round up to alarm resolution (minute)
+  when += 59;
+  when -= when % 60;
+
+  // Set alarm to date and time match; clears alarm flag
+  time_t clock(when);
+  clock.to_bcd();
+  alarm_t alarm;
+  alarm.minutes = clock.minutes;
+  alarm.hours = clock.hours;
+  alarm.date = clock.date;
+  return (set_alarm(alarm));
+}
+
+bool
+PCF8563::clear_wakeup()
+{
+  return (clear_alarm());
+}
+
 IOStream& operator<<(IOStream& cout, PCF8563::alarm_t &alarm)
 {
   if (alarm.day & PCF8563::alarm_t::DISABLE)
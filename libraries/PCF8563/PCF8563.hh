@@ -23,6 +23,7 @@
 
 #include "Cosa/TWI.hh"
 #include "Cosa/Time.hh"
+#include "Cosa/Alarm.hh"
 #include "Cosa/IOStream.hh"
 
 /**
@@ -31,8 +32,12 @@
  * @section References
  * 1. NXP PCF8563 data sheet;
  * http://www.nxp.com/documents/data_sheet/PCF8563.pdf
+ *
+ * @section Limitations
+ * The alarm resolution is one minute. The wakeup device
+ * (Alarm::Device) rounds the wakeup time up to the next minute.
  */
-class PCF8563 : private TWI::Driver {
+class PCF8563 : private TWI::Driver, public Alarm::Device {
 public:
   /**
    * Construct PCF8563 device with bus address(0x51).
@@ -112,6 +117,33 @@ public:
    */
   bool pending_alarm();
 
+  /**
+   * @override{Alarm::Device}
+   * Read current time in seconds from the real-time clock. Return
+   * true(1) if successful otherwise false(0).
+   * @param[out] now seconds.
+   * @return bool.
+   */
+  virtual bool get_clock(clock_t& now);
+
+  /**
+   * @override{Alarm::Device}
+   * Program the alarm (date and time match) to given time in
+   * seconds, rounded up to minute, and clear any pending alarm.
+   * Return true(1) if successful otherwise false(0).
+   * @param[in] when seconds.
+   * @return bool.
+   */
+  virtual bool set_wakeup(clock_t when);
+
+  /**
+   * @override{Alarm::Device}
+   * Disable the alarm interrupt and clear any pending alarm.
+   * Return true(1) if successful otherwise false(0).
+   * @return bool.
+   */
+  virtual bool clear_wakeup();
+
 protected:
   /**
    * The RTCC control and status register 1 bitfields (pp. 7).
@@ -132,6 +132,48 @@ public:
    */
   bool write(void* buf, size_t size);
 
+  /**
+   * Set given output pin in the port shadow register if value is
+   * non-zero, otherwise clear. The pin is not written to the device
+   * until commit() or update(). Allows a number of pin changes to be
+   * written in a single bus transaction.
+   * @param[in] pin number (0..7).
+   * @param[in] value.
+   */
+  void set(uint8_t pin, uint8_t value)
+    __attribute__((always_inline))
+  {
+    uint8_t mask = _BV(pin & PIN_MASK);
+    if (value)
+      m_port |= mask;
+    else
+      m_port &= ~mask;
+  }
+
+  /**
+   * Write the port shadow register to the output pins. Return true
+   * if successful otherwise false.
+   * @return bool.
+   */
+  bool commit()
+    __attribute__((always_inline))
+  {
+    return (write(m_port));
+  }
+
+  /**
+   * Write given value to the output pins in the given mask. Other
+   * pins are not changed. Return true if successful otherwise false.
+   * @param[in] mask pins to update.
+   * @param[in] value.
+   * @return bool.
+   */
+  bool update(uint8_t mask, uint8_t value)
+    __attribute__((always_inline))
+  {
+    return (write((m_port & ~mask) | (value & mask)));
+  }
+
 protected:
   /** Pin number mask. */
   static const uint8_t PIN_MASK = 0x07;
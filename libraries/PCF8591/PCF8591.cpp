@@ -30,6 +30,23 @@ PCF8591::begin(uint8_t cntl)
   return (true);
 }
 
+int
+PCF8591::sample_all(uint8_t* buf, uint8_t cntl)
+{
+  // Set channel zero and auto-increment. The first byte of the read
+  // is the previous conversion and is discarded
+  uint8_t count = channels(cntl);
+  uint8_t res[5];
+  m_cntl = (cntl & ~CHANNEL_MASK) | AUTO_INCREMENT;
+  twi.acquire(this);
+  twi.write(m_cntl);
+  int n = twi.read(res, count + 1);
+  twi.release();
+  if (n != count + 1) return (n < 0 ? n : EIO);
+  memcpy(buf, &res[1], count);
+  return (count);
+}
+
 bool
 PCF8591::convert(uint8_t value)
 {
@@ -120,17 +120,51 @@ public:
 
   /**
    * Read a sequence of samples the channel defined by the latest
-   * begin() call.
+   * begin() call. With AUTO_INCREMENT in the control byte the
+   * samples are interleaved; one per channel in turn starting with
+   * the channel in the control byte (continuous mode).
+   * @code
+   * adc.begin(PCF8591::AUTO_INCREMENT | PCF8591::FOUR_INPUTS);
+   * adc.sample(buf, sizeof(buf));
+   * adc.end();
+   * @endcode
    * @param[in] buf sample buffer.
    * @param[in] size of sample buffer.
    * @return count or negative error code.
    */
-  int sample(uint8_t* buf, uint8_t size)
+  int sample(uint8_t* buf, size_t size)
     __attribute__((always_inline))
   {
     return (twi.read(buf, size));
   }
 
+  /**
+   * Sample all channels for the input mode in the given control byte
+   * (FOUR_INPUTS, THREE_DIFF_INPUTS, TWO_MIXED_INPUTS or
+   * TWO_DIFF_INPUTS) with auto-increment in a single read request.
+   * The buffer must hold channels(cntl) samples. Returns number of
+   * samples or negative error code.
+   * @param[in] buf sample buffer.
+   * @param[in] cntl control byte (default FOUR_INPUTS).
+   * @return count or negative error code.
+   */
+  int sample_all(uint8_t* buf, uint8_t cntl = FOUR_INPUTS);
+
+  /**
+   * Return number of channels for the input mode in the given
+   * control byte.
+   * @param[in] cntl control byte.
+   * @return number of channels.
+   */
+  static uint8_t channels(uint8_t cntl)
+  {
+    switch (cntl & TWO_DIFF_INPUTS) {
+    case FOUR_INPUTS: return (4);
+    case TWO_DIFF_INPUTS: return (2);
+    default: return (3);
+    }
+  }
+
   /**
    * Convert given value to analog output (voltage).
    * Return true(1) if successful otherwise false(0).
@@ -22,6 +22,7 @@
 #include "Cosa/Watchdog.hh"
 
 Head ProtoThread::runq;
+Job::Scheduler* ProtoThread::s_scheduler = NULL;
 
 void
 ProtoThread::on_event(uint8_t type, uint16_t value)
@@ -37,16 +38,14 @@ ProtoThread::on_event(uint8_t type, uint16_t value)
   }
 }
 
-uint16_t
+int32_t
 ProtoThread::dispatch(bool flag)
 {
-  uint16_t count = 0;
   // Check if events should be processed and the run queue is empty
   if (flag && runq.is_empty()) {
     Event event;
     Event::queue.await(&event);
     event.dispatch();
-    count += 1;
   }
   // Iterate once through the run queue and call all threads run method
   Linkage* link = runq.succ();
@@ -59,25 +58,28 @@ ProtoThread::dispatch(bool flag)
       thread->m_state = READY;
     }
     link = succ;
-    count += 1;
     // Check if events should be processed
     if (flag) {
       while (Event::queue.available()) {
 	Event event;
 	Event::queue.dequeue(&event);
 	event.dispatch();
-	count += 1;
       }
     }
   }
-  // Return total number of function dispatch
-  return (count);
+  // Return time until next wakeup; zero if there is more to run
+  if (!runq.is_empty() || (flag && Event::queue.available())) return (0);
+  if (s_scheduler == NULL) return (INT32_MAX);
+  int32_t res = s_scheduler->expire_after();
+  return (res < 0 ? 0 : res);
 }
 
 void
 ProtoThread::schedule(ProtoThread* thread)
 {
-  if (UNLIKELY(thread->m_state == TERMINATED)) thread->m_ip = 0;
-  thread->m_state = READY;
-  runq.attach(thread);
+  synchronized {
+    if (UNLIKELY(thread->m_state == TERMINATED)) thread->m_ip = 0;
+    thread->m_state = READY;
+    runq.attach(thread);
+  }
 }
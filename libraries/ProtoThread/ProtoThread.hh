@@ -67,13 +67,17 @@ public:
   /**
    * Construct thread, initiate state and continuation. Does not
    * schedule the thread. This is done with begin().
-   * @param[in] scheduler wiht milli-seconds time unit.
+   * @param[in] scheduler wiht milli-seconds time unit. The scheduler
+   * of the first thread is used for the wakeup time returned by
+   * dispatch(); all threads should use the same scheduler.
    */
   ProtoThread(Job::Scheduler* scheduler) :
     Job(scheduler),
     m_state(INITIATED),
     m_ip(0)
-  {}
+  {
+    if (s_scheduler == NULL) s_scheduler = scheduler;
+  }
 
   /**
    * Start the thread. Must be in INITIATED state to be allowed to be
@@ -161,23 +165,28 @@ public:
 
   /**
    * Run threads in the run queue. If given flag is true events will
-   * be processes. Returns number of dispatched threads and events.
-   * The run queue is only iterated once per call to dispatch to allow
-   * user defined outer loop, i.e., arduino loop() function.
+   * be processes. The run queue is only iterated once per call to
+   * dispatch to allow user defined outer loop, i.e., arduino loop()
+   * function. Returns zero(0) if there are threads in the run queue
+   * (or pending events) otherwise the time until the next timed
+   * wakeup in the scheduler time unit, or INT32_MAX if there is no
+   * timer. May be used to sleep in the outer loop.
    * @param[in] flag process events if non zero.
-   * @return number of dispatched threads and events.
+   * @return time until next wakeup.
    */
-  static uint16_t dispatch(bool flag = true);
+  static int32_t dispatch(bool flag = true);
 
   /**
    * Add the given thread to the run queue (last). A terminated thread
-   * may be restarted.
+   * may be restarted. Constant time and may be called from an
+   * interrupt service routine.
    * @param[in] thread to enqueue.
    */
   static void schedule(ProtoThread* thread);
 
 protected:
   static Head runq;
+  static Job::Scheduler* s_scheduler;
   uint8_t m_state;
   void* m_ip;
 
@@ -228,7 +237,7 @@ protected:
 #define PROTO_THREAD_WAKE(thread)			\
   do {							\
     if (thread->m_state == SLEEPING)			\
-      Thread::schedule(thread);				\
+      ProtoThread::schedule(thread);			\
   } while (0)
 
 /**
@@ -39,3 +39,46 @@ RC4::restart(const void* key, size_t len)
   }
 }
 
+
+// Keystream step; indices in registers and state access by pointer
+static inline void
+step(uint8_t* state, uint8_t &x, uint8_t &y,
+     uint8_t* &dp, const uint8_t* &sp)
+  __attribute__((always_inline));
+
+static inline void
+step(uint8_t* state, uint8_t &x, uint8_t &y,
+     uint8_t* &dp, const uint8_t* &sp)
+{
+  x += 1;
+  uint8_t sx = state[x];
+  y += sx;
+  uint8_t sy = state[y];
+  state[x] = sy;
+  state[y] = sx;
+  *dp++ = *sp++ ^ state[(uint8_t) (sx + sy)];
+}
+
+void
+RC4::encrypt(void* dest, const void* src, size_t n)
+{
+  uint8_t* state = m_state;
+  uint8_t* dp = (uint8_t*) dest;
+  const uint8_t* sp = (const uint8_t*) src;
+  uint8_t x = m_x;
+  uint8_t y = m_y;
+
+  // Handle the remainder and then unrolled blocks of four bytes
+  while (n & 0x03) {
+    step(state, x, y, dp, sp);
+    n--;
+  }
+  for (n >>= 2; n != 0; n--) {
+    step(state, x, y, dp, sp);
+    step(state, x, y, dp, sp);
+    step(state, x, y, dp, sp);
+    step(state, x, y, dp, sp);
+  }
+  m_x = x;
+  m_y = y;
+}
@@ -25,6 +25,9 @@
 
 /**
  * RC4 cipher.
+ * @section Limitations
+ * No authentication and 258 bytes of state. Use Ascon for wireless
+ * messages.
  * @section References
  * 1. http://en.wikipedia.org/wiki/RC4
  * 2. http://cypherpunks.venona.com/archive/1994/09/msg00304.html
@@ -72,21 +75,29 @@ public:
    */
   void encrypt(void* buf, size_t n)
   {
-    for (char* bp = (char*) buf; n--; bp++)
-      *bp = encrypt(*bp);
+    encrypt(buf, buf, n);
   }
 
   /**
-   * Encrypt the given src buffer to the dest buffer.
+   * Encrypt the given src buffer to the dest buffer. The buffers may
+   * be the same (in place). Block keystream generation with the
+   * state indices in registers and an unrolled loop.
    * @param[in] dest buffer pointer.
    * @param[in] src buffer pointer.
    * @param[in] n number of bytes.
    */
-  void encrypt(void* dest, const void* src, size_t n)
+  void encrypt(void* dest, const void* src, size_t n);
+
+  /**
+   * Encrypt the buffers in the given null terminated io vector in
+   * place, e.g. a message before Wireless::Driver::send(dest, port,
+   * vec); no extra copy is needed.
+   * @param[in] vec io vector.
+   */
+  void encrypt(const iovec_t* vec)
   {
-    char* dp = (char*) dest;
-    const char* sp = (const char*) src;
-    while (n--) *dp++ = encrypt(*sp++);
+    for (const iovec_t* vp = vec; vp->buf != NULL; vp++)
+      encrypt(vp->buf, vp->buf, vp->size);
   }
 
   /**
@@ -106,21 +117,29 @@ public:
    */
   void decrypt(void* buf, size_t n)
   {
-    for (char* bp = (char*) buf; n--; bp++)
-      *bp = decrypt(*bp);
+    encrypt(buf, buf, n);
   }
 
   /**
-   * Decrypt the given src buffer to the dest buffer.
+   * Decrypt the given src buffer to the dest buffer. The buffers may
+   * be the same (in place).
    * @param[in] dest buffer pointer.
    * @param[in] src buffer pointer.
    * @param[in] n number of bytes.
    */
   void decrypt(void* dest, const void* src, size_t n)
   {
-    char* dp = (char*) dest;
-    const char* sp = (const char*) src;
-    while (n--) *dp++ = decrypt(*sp++);
+    encrypt(dest, src, n);
+  }
+
+  /**
+   * Decrypt the buffers in the given null terminated io vector in
+   * place, e.g. a message received with Wireless::Driver::recv().
+   * @param[in] vec io vector.
+   */
+  void decrypt(const iovec_t* vec)
+  {
+    encrypt(vec);
   }
 
 private:
@@ -158,7 +158,30 @@ void setup()
     trace << buf[i];
   trace << endl;
 
-  // Test#5: OpenSSL test vectors
+  // Test#5: Block encrypt of buffer and io vector; measure processing time
+  trace << endl << PSTR("BLOCK ENCRYPT") << endl;
+  sender.restart(key, strlen(key));
+  memcpy_P(buf, &msg[0], sizeof(buf));
+  start = RTT::micros();
+  sender.encrypt(buf, sizeof(buf));
+  us = RTT::micros() - start;
+  trace << sizeof(buf) << PSTR(" bytes, ")
+	<< us << PSTR(" us (")
+	<< (us * 1000) / sizeof(buf) << PSTR(" ns/byte)")
+	<< endl;
+  iovec_t vec[3];
+  iovec_t* vp = vec;
+  iovec_arg(vp, buf, 16);
+  iovec_arg(vp, buf + 16, sizeof(buf) - 16);
+  iovec_end(vp);
+  receiver.restart(key, strlen(key));
+  receiver.decrypt(vec);
+  if (memcmp_P(buf, &msg[0], sizeof(buf)))
+    trace << PSTR("TEST FAILED") << endl;
+  else
+    trace << PSTR("OK") << endl;
+
+  // Test#6: OpenSSL test vectors
   trace << endl << PSTR("OPENSSL TEST VECTORS") << endl;
   bool failed = false;
   for (uint8_t i = 0; i < 7; i++) {
@@ -112,7 +112,9 @@ RFM69::RFM69(uint16_t net, uint8_t dev,
 	     Board::ExternalInterruptPin irq) :
   SPI::Driver(csn, SPI::ACTIVE_LOW, SPI::DIV4_CLOCK, 0, SPI::MSB_ORDER, &m_irq),
   Wireless::Driver(net, dev),
-  m_irq(irq, ExternalInterrupt::ON_RISING_MODE, this)
+  m_irq(irq, ExternalInterrupt::ON_RISING_MODE, this),
+  m_listen(false),
+  m_aes(false)
 {
 }
 
@@ -124,8 +126,10 @@ RFM69::IRQPin::on_interrupt(uint16_t arg)
   // The interrupt handler is called on rising signal (RFM69:DIO0).
   // This occures on TX: PACKET_SENT and RX: CRC_OK
   if (UNLIKELY(m_rf == 0)) return;
-  if (m_rf->m_opmode == RECEIVER_MODE)
+  if (m_rf->m_opmode == RECEIVER_MODE) {
+    m_rf->m_stamp = RTT::micros();
     m_rf->m_avail = true;
+  }
   else if (m_rf->m_opmode == TRANSMITTER_MODE)
     m_rf->m_done = true;
 }
@@ -182,7 +186,8 @@ RFM69::send(uint8_t dest, uint8_t port, const iovec_t* vec)
   // Sanity check the payload size
   if (UNLIKELY(vec == NULL)) return (EINVAL);
   size_t len = iovec_size(vec);
-  if (UNLIKELY(len > PAYLOAD_MAX)) return (EMSGSIZE);
+  if (UNLIKELY(len > (m_aes ? AES_PAYLOAD_MAX : PAYLOAD_MAX)))
+    return (EMSGSIZE);
 
   // Check if a packet available. Should receive before send
   if (UNLIKELY(m_avail)) return (ENXIO);
@@ -222,14 +227,19 @@ RFM69::send(uint8_t dest, uint8_t port, const void* buf, size_t len)
 int
 RFM69::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
 {
-  // Set receive mode and wait for a message
-  set(RECEIVER_MODE);
+  // Set receive mode (unless listen mode) and wait for a message
+  if (!m_listen) set(RECEIVER_MODE);
   uint32_t start = RTT::millis();
   while (!m_avail && ((ms == 0) || (RTT::since(start) < ms))) yield();
 
-  // Set standby and check if a message was received
-  set(STANDBY_MODE);
-  if (!m_avail) return (ETIME);
+  // Set standby and check if a message was received. In listen mode
+  // the device is in standby after a message. Restart on timeout as
+  // the receiver may be kept on by noise
+  if (!m_listen) set(STANDBY_MODE);
+  if (!m_avail) {
+    if (m_listen) listen_restart();
+    return (ETIME);
+  }
   m_avail = false;
 
   // Read the payload size and check size
@@ -241,6 +251,7 @@ RFM69::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
       if (size > len) {
 	spi.end();
 	spi.release();
+	if (m_listen) listen_restart();
 	return (EMSGSIZE);
       }
       // Read the frame (dest, src, payload)
@@ -250,6 +261,7 @@ RFM69::recv(uint8_t& src, uint8_t& port, void* buf, size_t len, uint32_t ms)
       spi.read(buf, size);
     spi.end();
   spi.release();
+  if (m_listen) listen_restart();
 
   return (size);
 }
@@ -260,11 +272,84 @@ RFM69::powerdown()
   set(SLEEP_MODE);
 }
 
+void
+RFM69::powerup()
+{
+  // Abort listen mode (if active) and set standby mode
+  if (m_listen) {
+    write(OP_MODE, SEQUENCER_ON | LISTEN_OFF | LISTEN_ABORT | STANDBY_MODE);
+    m_listen = false;
+  }
+  set(STANDBY_MODE);
+}
+
 void
 RFM69::wakeup_on_radio()
 {
-  // Fix: Use LISTEN_ON instead
+  // The interrupt handler signals messages in receiver mode
   set(STANDBY_MODE);
+  m_listen = true;
+  listen_restart();
+}
+
+void
+RFM69::listen_restart()
+{
+  // Listen mode stops after a message (END_MODE1); abort and restart.
+  // Listen mode is started from standby mode
+  write(OP_MODE, SEQUENCER_ON | LISTEN_OFF | LISTEN_ABORT | STANDBY_MODE);
+  write(OP_MODE, SEQUENCER_ON | LISTEN_OFF | STANDBY_MODE);
+  m_avail = false;
+  m_opmode = RECEIVER_MODE;
+  write(OP_MODE, SEQUENCER_ON | LISTEN_ON | STANDBY_MODE);
+}
+
+void
+RFM69::listen_timing(uint16_t idle_ms, uint16_t rx_us)
+{
+  // Select idle resolution; 4.1 ms or 262 ms
+  uint8_t resol = RESOL_IDLE_410_US;
+  uint16_t idle = (idle_ms * 10UL) / 41;
+  if (idle > 255) {
+    resol = RESOL_IDLE_262000_US;
+    idle = idle_ms / 262;
+    if (idle > 255) idle = 255;
+  }
+  if (idle == 0) idle = 1;
+
+  // Select receive resolution; 64 us or 4.1 ms
+  uint16_t rx = rx_us / 64;
+  if (rx > 255) {
+    resol |= RESOL_RX_410_US;
+    rx = rx_us / 4100;
+  }
+  else resol |= RESOL_RX_64_US;
+  if (rx == 0) rx = 1;
+
+  // Accept on RSSI threshold and stop listen mode on message
+  write(LISTEN1, resol | CRITERIA_RSSI_THRESHOLD | END_MODE1);
+  write(LISTEN2, idle);
+  write(LISTEN3, rx);
+}
+
+void
+RFM69::preamble_length(uint16_t bytes)
+{
+  uint16_t preamble = hton(bytes);
+  write(PREAMBLE, &preamble, sizeof(preamble));
+}
+
+void
+RFM69::aes_key(const void* key)
+{
+  // The key may only be written in standby or sleep mode
+  uint8_t config = read(PACKET_CONFIG2) & ~AES_ON;
+  m_aes = (key != NULL);
+  if (m_aes) {
+    write(CYPHER_KEY, key, AES_KEY_MAX);
+    config |= AES_ON;
+  }
+  write(PACKET_CONFIG2, config);
 }
 
 void
@@ -47,6 +47,20 @@
  *                       +------------+
  * @endcode
  *
+ * @section Listen
+ * The receiver may duty-cycle with the device listen mode. The device
+ * idles and wakes up to listen for the given receive period. A signal
+ * above the RSSI threshold keeps the receiver on until a message is
+ * received. The sender should use a preamble that is at least as long
+ * as the receiver idle period, see preamble_length(). The interrupt
+ * pin is edge triggered and the processor should not sleep deeper
+ * than SLEEP_MODE_IDLE. Call powerup() before send().
+ *
+ * @section Encryption
+ * The packet engine may encrypt and decrypt messages with AES-128,
+ * see aes_key(). The frame destination address is not encrypted. The
+ * payload is limited to AES_PAYLOAD_MAX.
+ *
  * @section References
  * 1. Product datasheet, RFM69W ISM Transceiver Module V1.3,
  * http://www.hoperf.com/rf/fsk_module/RFM69W.htm
@@ -66,6 +80,18 @@ public:
    */
   static const size_t PAYLOAD_MAX = 66 - HEADER_MAX;
 
+  /**
+   * Maximum size of payload with AES encryption. The device allows
+   * 64 bytes encrypted message after the address. Adjust for the
+   * frame header source and port.
+   */
+  static const size_t AES_PAYLOAD_MAX = 64 - (HEADER_MAX - 1);
+
+  /**
+   * Size of AES-128 key.
+   */
+  static const size_t AES_KEY_MAX = 16;
+
   /**
    * Construct RFM69 device driver with given network and device
    * address. Connected to SPI bus and given chip select pin. Default
@@ -161,10 +187,44 @@ public:
 
   /**
    * @override{Wireless::Driver}
-   * Set device in wakeup on radio mode.
+   * Set device in standby mode. Leaves listen mode.
+   */
+  virtual void powerup();
+
+  /**
+   * @override{Wireless::Driver}
+   * Set device in listen mode. The timing may be set with
+   * listen_timing(). The device will stay in the mode after receiving
+   * messages with recv() until powerup().
    */
   virtual void wakeup_on_radio();
 
+  /**
+   * Set listen mode timing; the idle period in milli-seconds (max
+   * 66 seconds) and the receive period in micro-seconds (max 62
+   * milli-seconds). The idle period resolution is 4.1 ms up to about
+   * one second and 262 ms above. The receive period resolution is 64
+   * us up to 16 ms and 4.1 ms above.
+   * @param[in] idle_ms idle period (milli-seconds).
+   * @param[in] rx_us receive period (micro-seconds).
+   */
+  void listen_timing(uint16_t idle_ms, uint16_t rx_us);
+
+  /**
+   * Set transmit preamble length in bytes (Default 3). A receiver in
+   * listen mode requires a preamble that is longer than the receiver
+   * idle period; bitrate / 8 bytes per second.
+   * @param[in] bytes preamble length.
+   */
+  void preamble_length(uint16_t bytes);
+
+  /**
+   * Set AES-128 key (AES_KEY_MAX bytes) and enable encryption in the
+   * packet engine. Disable encryption if the key is NULL.
+   * @param[in] key encryption key (or NULL).
+   */
+  void aes_key(const void* key);
+
   /**
    * @override{Wireless::Driver}
    * Set output power level [-18..13] dBm.
@@ -690,6 +750,13 @@ private:
   IRQPin m_irq;			//!< Interrupt pin and handler.
   volatile bool m_done;		//!< Packet sent flag (may be set by ISR).
   Mode m_opmode;		//!< Current operation mode.
+  bool m_listen;		//!< Listen mode.
+  bool m_aes;			//!< AES encryption enabled.
+
+  /**
+   * Restart listen mode after a receive.
+   */
+  void listen_restart();
 };
 #endif
 #endif
@@ -22,32 +22,7 @@
 #if !defined(BOARD_ATTINY)
 #include "RS485.hh"
 #include "Cosa/RTT.hh"
-#include <util/crc16.h>
-
-static uint8_t
-crc7(const void* buf, size_t size)
-{
-  uint8_t* bp = (uint8_t*) buf;
-  uint8_t crc = 0;
-  while (size--) {
-    uint8_t data = *bp++;
-    data ^= crc << 1;
-    if (data & 0x80) data ^= 9;
-    crc = data ^ (crc & 0x78) ^ (crc << 4) ^ ((crc >> 3) & 0x0f);
-  }
-  crc = (crc << 1) ^ (crc << 4) ^ (crc & 0x70) ^ ((crc >> 3) & 0x0f);
-  return (crc | 1);
-}
-
-static uint16_t
-crc_xmodem(const void* buf, size_t len)
-{
-  if (UNLIKELY(len == 0)) return (0);
-  uint8_t* bp = (uint8_t*) buf;
-  uint16_t crc = 0;
-  do crc = _crc_xmodem_update(crc, *bp++); while (--len);
-  return (crc);
-}
+#include "Cosa/CRC.hh"
 
 int
 RS485::putchar(char c)
@@ -96,8 +71,8 @@ RS485::send(const void* buf, size_t len, uint8_t dest)
   header.length = len;
   header.dest = dest;
   header.src = m_addr;
-  header.crc = crc7(&header, sizeof(header) - 1);
-  uint16_t crc = crc_xmodem(buf, len);
+  header.crc = CRC::crc7(&header, sizeof(header) - 1) | 1;
+  uint16_t crc = CRC::crc16_xmodem(buf, len);
 
   // Write message; SOT, header, payload and crc
   m_de.set();
@@ -133,7 +108,7 @@ RS485::recv(void* buf, size_t len, uint32_t ms)
     m_state = 2;
     if (m_ibuf->read(&m_header, sizeof(header_t)) != (int) sizeof(header_t))
       goto error;
-    if (m_header.crc != crc7(&m_header, sizeof(header_t) - 1))
+    if (m_header.crc != (CRC::crc7(&m_header, sizeof(header_t) - 1) | 1))
       goto error;
 
   case 2: // Read message payload and verify payload check-sum
@@ -148,7 +123,7 @@ RS485::recv(void* buf, size_t len, uint32_t ms)
   if (m_header.length > len) goto error;
   if (m_ibuf->read(buf, m_header.length) != (int) m_header.length) goto error;
   if (m_ibuf->read(&crc, sizeof(crc)) != sizeof(crc)) goto error;
-  if (crc_xmodem(buf, m_header.length) != crc) return (0);
+  if (CRC::crc16_xmodem(buf, m_header.length) != crc) return (0);
   m_state = 0;
 
   // Check that the message was addressed to this device
@@ -163,6 +138,106 @@ RS485::recv(void* buf, size_t len, uint32_t ms)
   return (EFAULT);
 }
 
+bool
+RS485::Poller::add(uint8_t addr)
+{
+  if (UNLIKELY(m_count == m_max)) return (false);
+  if (UNLIKELY(addr == BROADCAST || addr == MASTER)) return (false);
+  slave_t* slave = &m_slave[m_count++];
+  slave->addr = addr;
+  slave->misses = 0;
+  slave->skip = 0;
+  slave->latency = TIMEOUT_MAX / 2;
+  slave->timeout = TIMEOUT_MAX;
+  return (true);
+}
+
+const RS485::Poller::slave_t*
+RS485::Poller::slave(uint8_t addr) const
+{
+  for (uint8_t i = 0; i < m_count; i++)
+    if (m_slave[i].addr == addr) return (&m_slave[i]);
+  return (NULL);
+}
+
+void
+RS485::Poller::response(slave_t* slave, uint16_t latency)
+{
+  // Smoothed latency (7/8 old + 1/8 new) and timeout
+  if (latency > TIMEOUT_MAX) latency = TIMEOUT_MAX;
+  latency = (slave->latency * 7 + latency + 7) >> 3;
+  slave->latency = latency;
+  latency = 2 * latency + TIMEOUT_MIN;
+  slave->timeout = (latency < TIMEOUT_MAX) ? latency : TIMEOUT_MAX;
+  slave->misses = 0;
+  slave->skip = 0;
+}
+
+void
+RS485::Poller::timeout(slave_t* slave)
+{
+  // Double timeout on missed response
+  uint16_t timeout = slave->timeout * 2;
+  slave->timeout = (timeout < TIMEOUT_MAX) ? timeout : TIMEOUT_MAX;
+
+  // Exponential back-off for dead slave
+  if (slave->misses < 255) slave->misses += 1;
+  if (slave->misses < MISSES_MAX) return;
+  uint8_t shift = slave->misses - MISSES_MAX;
+  slave->skip = (shift < 5) ? (1 << shift) : BACKOFF_MAX;
+  if (slave->skip > BACKOFF_MAX) slave->skip = BACKOFF_MAX;
+}
+
+int
+RS485::Poller::poll()
+{
+  if (UNLIKELY(m_count == 0)) return (0);
+
+  // Find the next slave that is not in back-off
+  slave_t* slave = NULL;
+  for (uint8_t i = 0; i < m_count; i++) {
+    slave_t* sp = &m_slave[m_next];
+    if (++m_next == m_count) m_next = 0;
+    if (sp->skip == 0) {
+      slave = sp;
+      break;
+    }
+    sp->skip -= 1;
+  }
+  if (slave == NULL) return (0);
+
+  // Build and send request
+  uint8_t addr = slave->addr;
+  int res = on_request(addr, m_buf, m_size);
+  if (res <= 0) return (res);
+  uint32_t start = RTT::millis();
+  res = m_dev->send(m_buf, res, addr);
+  if (UNLIKELY(res < 0)) return (res);
+
+  // Receive response within slave timeout; skip messages from others
+  do {
+    uint32_t ms = RTT::millis() - start;
+    if (ms >= slave->timeout) {
+      res = ETIME;
+      break;
+    }
+    res = m_dev->recv(m_buf, m_size, slave->timeout - ms);
+  } while (res == 0 || (res > 0 && m_dev->m_header.src != addr));
+
+  // Update slave state and pass response or timeout
+  if (res > 0) {
+    response(slave, RTT::millis() - start);
+    on_response(addr, m_buf, res);
+  }
+  else {
+    m_dev->m_ibuf->empty();
+    m_dev->m_state = 0;
+    timeout(slave);
+    on_timeout(addr);
+  }
+  return (addr);
+}
+
 #define UART_TX_ISR(vec,nr)			\
 ISR(vec ## _TX_vect)				\
 {						\
@@ -140,6 +140,153 @@ public:
    */
   int recv(void* buf, size_t len, uint32_t ms = 0L);
 
+  /**
+   * RS485 master polling scheduler. Polls a table of slaves round
+   * robin with a per-slave state; smoothed response latency,
+   * adaptive response timeout and back-off for slaves that do not
+   * respond. The response timeout is twice the smoothed latency plus
+   * TIMEOUT_MIN milli-seconds. After MISSES_MAX consecutive missed
+   * responses the slave is considered dead and skipped for an
+   * exponentially increasing number of polling cycles (max
+   * BACKOFF_MAX). Sub-class should implement on_request() and
+   * on_response().
+   * @code
+   * class Master : public RS485::Poller {
+   *   ...
+   *   virtual int on_request(uint8_t addr, void* buf, size_t size);
+   *   virtual void on_response(uint8_t addr, const void* buf, size_t len);
+   * };
+   * RS485::Poller::slave_t slave[SLAVE_MAX];
+   * Master master(&rs485, slave, membersof(slave), buf, sizeof(buf));
+   * ...
+   * master.add(addr);
+   * ...
+   * master.poll();
+   * @endcode
+   */
+  class Poller {
+  public:
+    /** Minimum response timeout (ms). */
+    static const uint8_t TIMEOUT_MIN = 4;
+
+    /** Maximum (and initial) response timeout (ms). */
+    static const uint8_t TIMEOUT_MAX = 100;
+
+    /** Number of consecutive missed responses for dead slave. */
+    static const uint8_t MISSES_MAX = 3;
+
+    /** Maximum number of polling cycles to skip a dead slave. */
+    static const uint8_t BACKOFF_MAX = 32;
+
+    /** Per-slave polling state. */
+    struct slave_t {
+      uint8_t addr;		//!< Slave address.
+      uint8_t misses;		//!< Consecutive missed responses.
+      uint8_t skip;		//!< Polling cycles to skip (back-off).
+      uint8_t latency;		//!< Smoothed response latency (ms).
+      uint8_t timeout;		//!< Response timeout (ms).
+    };
+
+    /**
+     * Construct polling scheduler for given RS485 master device and
+     * slave table with given number of entries. The given buffer is
+     * used for request and response messages.
+     * @param[in] dev RS485 master device.
+     * @param[in] slave table.
+     * @param[in] max number of entries in slave table.
+     * @param[in] buf message buffer.
+     * @param[in] size of message buffer.
+     */
+    Poller(RS485* dev, slave_t* slave, uint8_t max, void* buf, size_t size) :
+      m_dev(dev),
+      m_slave(slave),
+      m_max(max),
+      m_count(0),
+      m_next(0),
+      m_buf(buf),
+      m_size(size)
+    {}
+
+    /**
+     * Add slave with given address to the polling table. Return
+     * true(1) if successful otherwise false(0).
+     * @param[in] addr slave address.
+     * @return bool.
+     */
+    bool add(uint8_t addr);
+
+    /**
+     * Poll the next slave that is not in back-off. Request message is
+     * given by on_request() and response passed to on_response(), or
+     * on_timeout() if there was no valid response within the slave
+     * timeout. Returns the address of the polled slave, zero if all
+     * slaves are in back-off, otherwise negative error code.
+     * @return slave address, zero or negative error code.
+     */
+    int poll();
+
+    /**
+     * Return slave state for given address or NULL if not found.
+     * @param[in] addr slave address.
+     * @return slave state or NULL.
+     */
+    const slave_t* slave(uint8_t addr) const;
+
+    /**
+     * @override{RS485::Poller}
+     * Build request for the slave with the given address in the given
+     * buffer with the given max size. Return length of request or
+     * zero to skip the slave in this cycle.
+     * @param[in] addr slave address.
+     * @param[in] buf request buffer.
+     * @param[in] size max size of request.
+     * @return length of request.
+     */
+    virtual int on_request(uint8_t addr, void* buf, size_t size) = 0;
+
+    /**
+     * @override{RS485::Poller}
+     * Handle response from the slave with the given address.
+     * @param[in] addr slave address.
+     * @param[in] buf response buffer.
+     * @param[in] len length of response.
+     */
+    virtual void on_response(uint8_t addr, const void* buf, size_t len) = 0;
+
+    /**
+     * @override{RS485::Poller}
+     * Called when the slave with the given address did not respond
+     * within the timeout. Default is no action.
+     * @param[in] addr slave address.
+     */
+    virtual void on_timeout(uint8_t addr)
+    {
+      UNUSED(addr);
+    }
+
+  protected:
+    RS485* m_dev;		//!< RS485 master device.
+    slave_t* m_slave;		//!< Slave table.
+    uint8_t m_max;		//!< Max number of slaves.
+    uint8_t m_count;		//!< Number of slaves.
+    uint8_t m_next;		//!< Next slave to poll.
+    void* m_buf;		//!< Message buffer.
+    size_t m_size;		//!< Size of message buffer.
+
+    /**
+     * Update slave state with response latency (ms).
+     * @param[in] slave state.
+     * @param[in] latency response time.
+     */
+    static void response(slave_t* slave, uint16_t latency);
+
+    /**
+     * Update slave state with missed response.
+     * @param[in] slave state.
+     */
+    static void timeout(slave_t* slave);
+  };
+
 protected:
   /** Maximum payload size. */
   const uint16_t PAYLOAD_MAX;
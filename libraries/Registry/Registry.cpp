@@ -112,8 +112,19 @@ Registry::get_value(blob_P blob, void* buf, size_t len)
     memcpy_P(buf, (const void*) pgm_read_word(&blob->value), size);
   else if (storage == IN_SRAM)
     memcpy(buf, (const void*) pgm_read_word(&blob->value), size);
-  else if (storage == IN_EEMEM && m_eeprom != NULL)
-    m_eeprom->read(buf, (const void*) pgm_read_word(&blob->value), size);
+  else if (storage == IN_EEMEM && m_eeprom != NULL) {
+    // Check for cached value; read and add to the cache otherwise
+    void* value = NULL;
+    if (m_cache != NULL) value = m_cache->lookup(blob);
+    if (value != NULL) {
+      memcpy(buf, value, size);
+    }
+    else {
+      m_eeprom->read(buf, (const void*) pgm_read_word(&blob->value), size);
+      if (m_cache != NULL) value = m_cache->insert(blob, size);
+      if (value != NULL) memcpy(value, buf, size);
+    }
+  }
   else return (EINVAL);
 
   // Return the number of bytes read
@@ -138,14 +149,44 @@ Registry::set_value(blob_P blob, const void* buf, size_t len)
   storage_t storage = get_storage(&blob->item);
   if (storage == IN_SRAM)
     memcpy((void*) pgm_read_word(&blob->value), buf, size);
-  else if (storage == IN_EEMEM && m_eeprom != NULL)
+  else if (storage == IN_EEMEM && m_eeprom != NULL) {
+    // Write through and update the cached value
     m_eeprom->write((void*) pgm_read_word(&blob->value), buf, size);
+    if (m_cache != NULL) {
+      void* value = m_cache->lookup(blob);
+      if (value == NULL) value = m_cache->insert(blob, size);
+      if (value != NULL) memcpy(value, buf, size);
+    }
+  }
   else return (EINVAL);
 
   // Return the number of bytes written
   return (size);
 }
 
+void*
+Registry::Cache::lookup(blob_P blob) const
+{
+  size_t ix = 0;
+  while (ix < m_used) {
+    entry_t* entry = (entry_t*) &m_buf[ix];
+    if (entry->blob == blob) return (entry + 1);
+    ix += sizeof(entry_t) + entry->size;
+  }
+  return (NULL);
+}
+
+void*
+Registry::Cache::insert(blob_P blob, size_t size)
+{
+  if (UNLIKELY(m_used + sizeof(entry_t) + size > m_size)) return (NULL);
+  entry_t* entry = (entry_t*) &m_buf[m_used];
+  entry->blob = blob;
+  entry->size = size;
+  m_used += sizeof(entry_t) + size;
+  return (entry + 1);
+}
+
 IOStream& operator<<(IOStream& outs, Registry::item_P item)
 {
   outs << PSTR("item@") << (void*) item;
@@ -32,6 +32,9 @@
  * data stored in SRAM, PROGMEM or EEMEM. The low level access is
  * type-less. Applications may add run-time data-types by extending
  * the item type system. Any type tag larger than BLOB may be used.
+ * An optional flat index (REGISTRY_INDEX_BEGIN/END) allows constant
+ * time lookup by item identity, and an optional cache keeps copies
+ * of EEMEM blob values in SRAM (write-through).
  */
 class Registry {
 public:
@@ -329,6 +332,74 @@ public:
     return (set_value(blob, value, sizeof(T)) == sizeof(T));
   }
 
+  /**
+   * Registry flat index; vector of items in program memory for
+   * constant time lookup by item identity (vector index).
+   */
+  struct index_t {
+    uint8_t length;		//!< Item vector length.
+    item_vec_P list;		//!< Item vector in program memory.
+  };
+
+  /** Pointer to index in program memory. */
+  typedef const PROGMEM index_t* index_P;
+
+  /**
+   * Registry blob value cache. Copies of EEMEM blob values are kept
+   * in the given buffer (SRAM) when read or written. Writes are
+   * written through to the EEPROM device. Entries are added while
+   * there is space in the buffer; there is no replacement.
+   */
+  class Cache {
+  public:
+    /**
+     * Construct cache with given buffer and size.
+     * @param[in] buf cache buffer.
+     * @param[in] size of cache buffer.
+     */
+    Cache(void* buf, size_t size) :
+      m_buf((uint8_t*) buf),
+      m_size(size),
+      m_used(0)
+    {}
+
+    /**
+     * Return pointer to cached value of given blob or NULL if not
+     * cached.
+     * @param[in] blob pointer to blob in program memory.
+     * @return pointer to value or NULL.
+     */
+    void* lookup(blob_P blob) const;
+
+    /**
+     * Add entry for given blob and value size. Return pointer to
+     * value storage or NULL if the cache is full.
+     * @param[in] blob pointer to blob in program memory.
+     * @param[in] size of value.
+     * @return pointer to value or NULL.
+     */
+    void* insert(blob_P blob, size_t size);
+
+    /**
+     * Remove all entries.
+     */
+    void flush()
+    {
+      m_used = 0;
+    }
+
+  protected:
+    /** Cache entry header; followed by value. */
+    struct entry_t {
+      blob_P blob;		//!< Cached blob.
+      size_t size;		//!< Size of value.
+    };
+
+    uint8_t* m_buf;		//!< Cache buffer.
+    size_t m_size;		//!< Size of cache buffer.
+    size_t m_used;		//!< Number of bytes used.
+  };
+
   /** Max length of a path. */
   static const size_t PATH_MAX = 8;
 
@@ -336,10 +407,17 @@ public:
    * Construct registery root object.
    * @param[in] root item list.
    * @param[in] eeprom device driver (default internal EEPROM).
+   * @param[in] index flat item index (default NULL).
+   * @param[in] cache for EEMEM blob values (default NULL).
    */
-  Registry(item_list_P root, EEPROM::Device* eeprom = NULL) :
+  Registry(item_list_P root,
+	   EEPROM::Device* eeprom = NULL,
+	   index_P index = NULL,
+	   Cache* cache = NULL) :
     m_root(root),
-    m_eeprom(eeprom == NULL ? &EEPROM::Device::eeprom : eeprom)
+    m_eeprom(eeprom == NULL ? &EEPROM::Device::eeprom : eeprom),
+    m_index(index),
+    m_cache(cache)
   {}
 
   /**
@@ -351,6 +429,20 @@ public:
    */
   item_P lookup(const uint8_t* path = NULL, size_t count = 0);
 
+  /**
+   * Lookup registry item with given identity in the flat index.
+   * Returns pointer to item if found otherwise NULL.
+   * @param[in] id item identity (index vector position).
+   * @return item pointer or NULL.
+   */
+  item_P lookup_index(uint8_t id) const
+  {
+    if (UNLIKELY(m_index == NULL)) return (NULL);
+    if (UNLIKELY(id >= pgm_read_byte(&m_index->length))) return (NULL);
+    item_vec_P vec = (item_vec_P) pgm_read_word(&m_index->list);
+    return ((item_P) pgm_read_word(&vec[id]));
+  }
+
   void print(IOStream& outs, const uint8_t* path, size_t count);
 
   /**
@@ -375,6 +467,12 @@ private:
 
   /** EEPROM device driver. */
   EEPROM::Device* m_eeprom;
+
+  /** Flat item index. */
+  index_P m_index;
+
+  /** EEMEM blob value cache. */
+  Cache* m_cache;
 };
 
 /**
@@ -435,6 +533,31 @@ IOStream& operator<<(IOStream& outs, Registry::item_list_P list);
     var ## _list					\
   };
 
+/**
+ * Support macro to start the definition of a flat registry index in
+ * program memory. The item identity is the position in the index.
+ * Used in the form:
+ *   REGISTRY_INDEX_BEGIN(var)
+ *     REGISTRY_XXX_ITEM(item-0)
+ *     ...
+ *     REGISTRY_XXX_ITEM(item-n)
+ *   REGISTRY_INDEX_END(var)
+ * @param[in] var registry index to create.
+ */
+#define REGISTRY_INDEX_BEGIN(var)			\
+  const Registry::item_P var ## _index[] __PROGMEM = {
+
+/**
+ * Support macro to complete a registry index in program memory.
+ * @param[in] var registry index to create.
+ */
+#define REGISTRY_INDEX_END(var)				\
+  };							\
+  const Registry::index_t var __PROGMEM = {		\
+    membersof(var ## _index),				\
+    var ## _index					\
+  };
+
 /**
  * Support macro to define a registry action in program memory.
  * @param[in] var registry action item to create.
@@ -112,8 +112,21 @@ REGISTRY_BEGIN(ROOT, "root")		// -
   REGISTRY_LIST_ITEM(ACTION)		// 3
 REGISTRY_END(ROOT)
 
+// Flat index of the configuration and status items
+REGISTRY_INDEX_BEGIN(INDEX)
+  REGISTRY_BLOB_ITEM(NETWORK)		// #0
+  REGISTRY_BLOB_ITEM(DEVICE)		// #1
+  REGISTRY_BLOB_ITEM(TIMEOUT)		// #2
+  REGISTRY_BLOB_ITEM(sensor)		// #3
+  REGISTRY_BLOB_ITEM(load)		// #4
+REGISTRY_INDEX_END(INDEX)
+
+// Cache for EEMEM configuration values
+uint8_t buffer[32];
+Registry::Cache cache(buffer, sizeof(buffer));
+
 // Application registry (1218 bytes)
-Registry reg(&ROOT);
+Registry reg(&ROOT, NULL, &INDEX, &cache);
 
 // Use internal eeprom for some application settings
 EEPROM eeprom;
@@ -270,6 +283,16 @@ void loop()
   ASSERT(reg.get_value<bool>(blob, &flag));
   trace << flag << endl;
 
+  // Access configuration network (via index and cache)
+  item = reg.lookup_index(0);
+  trace << item << endl;
+  blob = Registry::to_blob(item);
+  ASSERT(blob != NULL);
+  ASSERT(reg.get_value<uint16_t>(blob, &network));
+  trace << hex << network << endl;
+  ASSERT(reg.get_value<uint16_t>(blob, &network));
+  ASSERT(reg.lookup_index(membersof(INDEX_index)) == NULL);
+
   // Access 3.2 illegal path
   path[0] = 3;
   path[1] = 2;
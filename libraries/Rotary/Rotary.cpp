@@ -215,7 +215,13 @@ Rotary::Encoder::SignalPin::on_interrupt(uint16_t arg)
 {
   UNUSED(arg);
   Rotary::Encoder::Direction change = m_encoder->detect();
-  if (change) Event::push(Event::CHANGE_TYPE, m_encoder, change);
+  if (change == NONE) return;
+  if (change == CW)
+    m_encoder->m_count += 1;
+  else
+    m_encoder->m_count -= 1;
+  if (m_encoder->m_pending) return;
+  m_encoder->m_pending = Event::push(Event::CHANGE_TYPE, m_encoder);
 }
 
 Rotary::Encoder::Direction
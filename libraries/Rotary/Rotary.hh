@@ -41,8 +41,12 @@ class Rotary {
 public:
   /**
    * Rotary Encoder using pin change interrupts. Handles half and full
-   * cycle detection. Will push an Event::CHANGE_TYPE with the
-   * direction of the change.
+   * cycle detection with a state transition table. The interrupt
+   * handler accumulates a signed step count and pushes a single
+   * Event::CHANGE_TYPE until the event has been handled. The event
+   * handler collects the accumulated steps and calls on_turn() once
+   * per service; fast turns do not lose steps or flood the event
+   * queue.
    *
    * @section Circuit
    * KY-040 Rotary Encoder Module.
@@ -88,7 +92,9 @@ public:
       m_clk(clk, this),
       m_dt(dt, this),
       m_state(0),
-      m_mode(mode)
+      m_mode(mode),
+      m_count(0),
+      m_pending(false)
     {
       enable();
     }
@@ -131,6 +137,49 @@ public:
       m_dt.disable();
     }
 
+    /**
+     * Return number of accumulated steps since latest call and reset
+     * count; positive for clock-wise and negative for anti-clock-wise.
+     * @return steps.
+     * @note atomic
+     */
+    int16_t delta()
+    {
+      int16_t res;
+      synchronized {
+	res = m_count;
+	m_count = 0;
+	m_pending = false;
+      }
+      return (res);
+    }
+
+    /**
+     * @override{Rotary::Encoder}
+     * Called with the accumulated number of steps when the encoder
+     * has been turned; positive for clock-wise and negative for
+     * anti-clock-wise. Default is an empty function.
+     * @param[in] steps accumulated since previous call.
+     */
+    virtual void on_turn(int16_t steps)
+    {
+      UNUSED(steps);
+    }
+
+    /**
+     * @override{Event::Handler}
+     * Collect the accumulated steps and call on_turn().
+     * @param[in] type the event type.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value)
+    {
+      UNUSED(value);
+      if (UNLIKELY(type != Event::CHANGE_TYPE)) return;
+      int16_t steps = delta();
+      if (steps != 0) on_turn(steps);
+    }
+
   protected:
     /**
      * Rotary signal pin handler (pin change interrupt). Delegates to
@@ -148,8 +197,8 @@ public:
 
       /**
        * @override{Interrupt::Handler}
-       * Signal pin interrupt handler. Check possible state change and will
-       * push Event::CHANGE_TYPE with direction (CW or CCW).
+       * Signal pin interrupt handler. Check possible state change,
+       * accumulate step and push Event::CHANGE_TYPE if not pending.
        */
       virtual void on_interrupt(uint16_t arg);
     };
@@ -166,6 +215,10 @@ public:
     uint8_t m_state;
     Mode m_mode;
 
+    /** Accumulated steps and pending event flag. */
+    volatile int16_t m_count;
+    volatile bool m_pending;
+
     /**
      * Detect Rotary Encoder state change. Reads current input pin
      * values and performs a possible state change. Return turn
@@ -261,24 +314,19 @@ public:
     T m_step;
 
     /**
-     * @override{Event::Handler}
-     * Update the dial value on change. The event value is the
-     * direction (CW or CCW).
-     * @param[in] type the event type.
-     * @param[in] value the event value.
+     * @override{Rotary::Encoder}
+     * Update the dial value with the accumulated steps; the value is
+     * limited to the range.
+     * @param[in] steps accumulated since previous call.
      */
-    virtual void on_event(uint8_t type, uint16_t value)
+    virtual void on_turn(int16_t steps)
     {
-      UNUSED(type);
-      if (value == CW) {
-	if (m_value == m_max) return;
-	m_value += m_step;
-      }
-      else {
-	if (m_value == m_min) return;
-	m_value -= m_step;
-      }
-      on_change(m_value);
+      T value = m_value;
+      for (; steps > 0 && m_value < m_max; steps--) m_value += m_step;
+      for (; steps < 0 && m_value > m_min; steps++) m_value -= m_step;
+      if (m_value > m_max) m_value = m_max;
+      if (m_value < m_min) m_value = m_min;
+      if (m_value != value) on_change(m_value);
     }
   };
 
@@ -391,36 +439,26 @@ public:
     T m_steps;
 
     /**
-     * @override{Event::Handler}
-     * Update the accelerated dial value on change. The event value is the
-     * direction (CW or CCW). If the time period between events is
-     * larger than the threshold a slow step is used otherwise the
-     * fast step (steps).
-     * @param[in] type the event type.
-     * @param[in] direction the event value.
+     * @override{Rotary::Encoder}
+     * Update the accelerated dial value with the accumulated steps.
+     * If the time period per step since the previous call is larger
+     * than the threshold a slow step is used otherwise the fast step
+     * (steps).
+     * @param[in] steps accumulated since previous call.
      */
-    virtual void on_event(uint8_t type, uint16_t direction)
+    virtual void on_turn(int16_t steps)
     {
       uint32_t now = RTT::micros();
-      int32_t diff = now - m_latest;
+      uint32_t diff = now - m_latest;
       m_latest = now;
-      if (direction == CW) {
-	if (m_value == m_max) return;
-	if (diff > THRESHOLD)
-	  m_value += m_step;
-	else
-	  m_value += m_steps;
-	if (m_value > m_max) m_value = m_max;
-      }
-      else {
-	if (m_value == m_min) return;
-	if (diff > THRESHOLD)
-	  m_value -= m_step;
-	else
-	  m_value -= m_steps;
-	if (m_value < m_min) m_value = m_min;
-      }
-      on_change(m_value);
+      uint16_t count = (steps < 0) ? -steps : steps;
+      T step = (diff / count > THRESHOLD) ? m_step : m_steps;
+      T value = m_value;
+      for (; steps > 0 && m_value < m_max; steps--) m_value += step;
+      for (; steps < 0 && m_value > m_min; steps++) m_value -= step;
+      if (m_value > m_max) m_value = m_max;
+      if (m_value < m_min) m_value = m_min;
+      if (m_value != value) on_change(m_value);
     }
   };
 };
@@ -60,6 +60,9 @@ S25FL127S::is_ready()
 int
 S25FL127S::read(void* dest, uint32_t src, size_t size)
 {
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Use READ with 24-bit address; Big-endian
   uint8_t* sp = (uint8_t*) &src;
   int res = (int) size;
@@ -87,6 +90,7 @@ S25FL127S::erase(uint32_t dest, uint8_t size)
   case 255: op = BER; break;
   default: return (EINVAL);
   }
+  await();
   spi.acquire(this);
     // Write enable before page erase.
     spi.begin();
@@ -104,6 +108,9 @@ S25FL127S::erase(uint32_t dest, uint8_t size)
     spi.end();
   spi.release();
 
+  // Return directly in asynchronous mode
+  if (m_async) return (0);
+
   // Wait for completion
   while (!is_ready()) yield();
 
@@ -117,6 +124,9 @@ S25FL127S::write(uint32_t dest, const void* src, size_t size)
   // Check for zero buffer size
   if (UNLIKELY(size == 0)) return (0);
 
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Set up destination and source pointers
   uint8_t* dp = (uint8_t*) &dest;
   uint8_t* sp = (uint8_t*) src;
@@ -142,6 +152,10 @@ S25FL127S::write(uint32_t dest, const void* src, size_t size)
       spi.end();
     spi.release();
 
+    // Return directly after the last page in asynchronous mode
+    size -= count;
+    if (UNLIKELY(size == 0 && m_async)) break;
+
     // Wait for completion
     while (!is_ready()) yield();
 
@@ -149,7 +163,6 @@ S25FL127S::write(uint32_t dest, const void* src, size_t size)
     if (UNLIKELY(m_status.P_ERR)) return (EFAULT);
 
     // Step to next page
-    size -= count;
     if (UNLIKELY(size == 0)) break;
     dest += count;
     sp += count;
@@ -166,6 +179,9 @@ S25FL127S::write_P(uint32_t dest, const void* src, size_t size)
   // Check for zero buffer size
   if (UNLIKELY(size == 0)) return (0);
 
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Set up destination and source pointers
   uint8_t* dp = (uint8_t*) &dest;
   uint8_t* sp = (uint8_t*) src;
@@ -191,6 +207,10 @@ S25FL127S::write_P(uint32_t dest, const void* src, size_t size)
       spi.end();
     spi.release();
 
+    // Return directly after the last page in asynchronous mode
+    size -= count;
+    if (UNLIKELY(size == 0 && m_async)) break;
+
     // Wait for completion
     while (!is_ready()) yield();
 
@@ -198,7 +218,6 @@ S25FL127S::write_P(uint32_t dest, const void* src, size_t size)
     if (UNLIKELY(m_status.P_ERR)) return (EFAULT);
 
     // Step to next page
-    size -= count;
     if (UNLIKELY(size == 0)) break;
     dest += count;
     sp += count;
@@ -20,76 +20,37 @@
 
 #include "SD.hh"
 #include "Cosa/RTT.hh"
+#include "Cosa/CRC.hh"
 
-// Configuration: Allow SPI transfer interleaving, table driven CRC.
+// Configuration: Allow SPI transfer interleaving.
 #define USE_SPI_PREFETCH
-#define USE_CRCTAB
 
-static inline uint8_t crc7(const void* buf, size_t size)
+#if defined(USE_SPI_PREFETCH)
+/*
+ * Block transfer steps for the unrolled read and write loops. The
+ * check sum is updated while the next byte is shifted.
+ */
+static inline void read_byte(uint8_t* &dst, uint16_t &crc)
   __attribute__((always_inline));
 
-static inline uint8_t
-crc7(const void* buf, size_t size)
+static inline void
+read_byte(uint8_t* &dst, uint16_t &crc)
 {
-  uint8_t* bp = (uint8_t*) buf;
-  uint8_t crc = 0;
-  while (size--) {
-    uint8_t data = *bp++;
-    data ^= crc << 1;
-    if (data & 0x80) data ^= 9;
-    crc = data ^ (crc & 0x78) ^ (crc << 4) ^ ((crc >> 3) & 0x0f);
-  }
-  crc = (crc << 1) ^ (crc << 4) ^ (crc & 0x70) ^ ((crc >> 3) & 0x0f);
-  return (crc | 1);
+  uint8_t data = spi.transfer_next(0xff);
+  *dst++ = data;
+  crc = CRC::crc16_xmodem_update(crc, data);
 }
 
-#if defined(USE_CRCTAB)
-static const uint16_t crctab[] __PROGMEM = {
-  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
-  0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
-  0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
-  0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
-  0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
-  0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
-  0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
-  0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
-  0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
-  0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
-  0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
-  0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
-  0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
-  0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
-  0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
-  0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
-  0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
-  0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
-  0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
-  0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
-  0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
-  0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-  0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
-  0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
-  0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
-  0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
-  0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
-  0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
-  0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
-  0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
-  0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
-  0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
-};
-
-static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data)
+static inline void write_byte(const uint8_t* &src, uint16_t &crc)
   __attribute__((always_inline));
 
-static inline uint16_t
-_crc_xmodem_update(uint16_t crc, uint8_t data)
+static inline void
+write_byte(const uint8_t* &src, uint16_t &crc)
 {
-  return (pgm_read_word(&crctab[((crc >> 8) ^ data) & 0Xff]) ^ (crc << 8));
+  uint8_t data = *src++;
+  spi.transfer_next(data);
+  crc = CRC::crc16_xmodem_update(crc, data);
 }
-
-#else
-#include <util/crc16.h>
 #endif
 
 uint8_t
@@ -99,7 +60,7 @@ SD::send(CMD command, uint32_t arg)
   request_t request;
   request.command = (0x40 | command);
   request.arg = swap(arg);
-  request.crc = crc7(&request, sizeof(request) - 1);
+  request.crc = CRC::crc7(&request, sizeof(request) - 1) | 1;
 
   // Issue the command; wait while busy
   while (spi.transfer(0xff) != 0xff)
@@ -160,6 +121,16 @@ SD::await(uint16_t ms, uint8_t token)
   return (false);
 }
 
+bool
+SD::ready(uint16_t ms)
+{
+  uint16_t start = RTT::millis();
+  do {
+    if (spi.transfer(0xff) == 0xff) return (true);
+  } while (((uint16_t) RTT::millis()) - start < ms);
+  return (false);
+}
+
 uint32_t
 SD::receive()
 {
@@ -180,42 +151,100 @@ SD::receive()
 }
 
 bool
-SD::read(CMD command, uint32_t arg, void* buf, size_t count)
+SD::read_data(void* buf, size_t count)
 {
   uint8_t* dst = (uint8_t*) buf;
   uint16_t crc = 0;
-  bool res = false;
   uint8_t data;
 
-  // Issue read command and receive data into buffer
-  spi.acquire(this);
-    spi.begin();
-      if (send(command, arg)) goto error;
-      if (!await(READ_TIMEOUT, DATA_START_BLOCK)) goto error;
+  // Wait for start of data block and receive data into buffer
+  if (!await(READ_TIMEOUT, DATA_START_BLOCK)) return (false);
 
 #if defined(USE_SPI_PREFETCH)
-      spi.transfer_start(0xff);
-      while (--count) {
-	data = spi.transfer_next(0xff);
-	*dst++ = data;
-	crc = _crc_xmodem_update(crc, data);
-      }
-      data = spi.transfer_await();
-      *dst = data;
-      crc = _crc_xmodem_update(crc, data);
+  spi.transfer_start(0xff);
+  while (--count & 0x07) read_byte(dst, crc);
+  for (count >>= 3; count != 0; count--) {
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+    read_byte(dst, crc);
+  }
+  data = spi.transfer_await();
+  *dst = data;
+  crc = CRC::crc16_xmodem_update(crc, data);
 #else
-      do {
-	uint8_t data = spi.transfer(0xff);
-	*dst++ = data;
-	crc = _crc_xmodem_update(crc, data);
-      } while (--count);
+  do {
+    data = spi.transfer(0xff);
+    *dst++ = data;
+    crc = CRC::crc16_xmodem_update(crc, data);
+  } while (--count);
 #endif
 
-      // Receive the check sum and check
-      crc = _crc_xmodem_update(crc, spi.transfer(0xff));
-      crc = _crc_xmodem_update(crc, spi.transfer(0xff));
-      res = (crc == 0);
+  // Receive the check sum and check
+  crc = CRC::crc16_xmodem_update(crc, spi.transfer(0xff));
+  crc = CRC::crc16_xmodem_update(crc, spi.transfer(0xff));
+  return (crc == 0);
+}
 
+bool
+SD::write_data(uint8_t token, const uint8_t* src)
+{
+  uint16_t crc = 0;
+  uint16_t count = BLOCK_MAX;
+  uint8_t status;
+  uint8_t data;
+
+  // Transfer start token and block, calculate check sum
+  spi.transfer(token);
+
+#if defined(USE_SPI_PREFETCH)
+  data = *src++;
+  spi.transfer_start(data);
+  crc = CRC::crc16_xmodem_update(crc, data);
+  while (--count & 0x07) write_byte(src, crc);
+  for (count >>= 3; count != 0; count--) {
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+    write_byte(src, crc);
+  }
+  spi.transfer_await();
+#else
+  do {
+    data = *src++;
+    spi.transfer(data);
+    crc = CRC::crc16_xmodem_update(crc, data);
+  } while (--count);
+#endif
+
+  // Transfer the check sum and receive data response token and check status
+  spi.transfer(crc >> 8);
+  spi.transfer(crc);
+  status = spi.transfer(0xff);
+  if ((status & DATA_RES_MASK) != DATA_RES_ACCEPTED) return (false);
+
+  // Wait for the write operation to complete
+  return (ready(WRITE_TIMEOUT));
+}
+
+bool
+SD::read(CMD command, uint32_t arg, void* buf, size_t count)
+{
+  bool res = false;
+
+  // Issue read command and receive data into buffer
+  spi.acquire(this);
+    spi.begin();
+      if (send(command, arg)) goto error;
+      res = read_data(buf, count);
  error:
     spi.end();
   spi.release();
@@ -313,48 +342,121 @@ SD::erase(uint32_t start, uint32_t end)
 bool
 SD::write(uint32_t block, const uint8_t* src)
 {
-  uint16_t crc = 0;
-  uint16_t count = BLOCK_MAX;
   uint8_t status;
-  uint8_t data;
   bool res = false;
 
   // Check for byte address adjustment
   if (m_type != TYPE_SDHC) block <<= 9;
 
-  // Issue write block command, transfer block, calculate check sum
+  // Issue write block command and transfer block
   spi.acquire(this);
     spi.begin();
       if (send(WRITE_BLOCK, block)) goto error;
-      spi.transfer(DATA_START_BLOCK);
-
-#if defined(USE_SPI_PREFETCH)
-      data = *src++;
-      spi.transfer_start(data);
-      while (--count) {
-	crc = _crc_xmodem_update(crc, data);
-	data = *src++;
-	spi.transfer_await();
-	spi.transfer_start(data);
-      }
-      crc = _crc_xmodem_update(crc, data);
-      spi.transfer_await();
-#else
-      do {
-	data = *src++;
-	spi.transfer(data);
-	crc = _crc_xmodem_update(crc, data);
-      } while (--count);
-#endif
+      if (!write_data(DATA_START_BLOCK, src)) goto error;
 
-      // Transfer the check sum and receive data response token and check status
-      spi.transfer(crc >> 8);
-      spi.transfer(crc);
+      // Check status of the write operation
+      status = send(SEND_STATUS);
+      if (status != 0) goto error;
       status = spi.transfer(0xff);
-      if ((status & DATA_RES_MASK) != DATA_RES_ACCEPTED) goto error;
+      res = (status == 0);
+
+ error:
+    spi.end();
+  spi.release();
+  return (res);
+}
 
-      // Wait for the write operation to complete and check status
-      if (!await(WRITE_TIMEOUT)) goto error;
+bool
+SD::begin_read(uint32_t block)
+{
+  bool res;
+
+  // Check for byte address adjustment
+  if (m_type != TYPE_SDHC) block <<= 9;
+
+  // Issue read multiple block command
+  spi.acquire(this);
+    spi.begin();
+      res = (send(READ_MULTIPLE_BLOCK, block) == 0);
+    spi.end();
+  spi.release();
+  return (res);
+}
+
+bool
+SD::read_next(uint8_t* dst)
+{
+  bool res;
+
+  // Receive next data block in the stream
+  spi.acquire(this);
+    spi.begin();
+      res = read_data(dst, BLOCK_MAX);
+    spi.end();
+  spi.release();
+  return (res);
+}
+
+bool
+SD::end_read()
+{
+  bool res;
+
+  // Stop the stream and wait for the card to become ready
+  spi.acquire(this);
+    spi.begin();
+      send(STOP_TRANSMISSION);
+      res = ready(READ_TIMEOUT);
+    spi.end();
+  spi.release();
+  return (res);
+}
+
+bool
+SD::begin_write(uint32_t block, uint32_t count)
+{
+  bool res = false;
+
+  // Check for byte address adjustment
+  if (m_type != TYPE_SDHC) block <<= 9;
+
+  // Issue pre-erase hint and write multiple block command
+  spi.acquire(this);
+    spi.begin();
+      if ((count > 1) && send(SET_WR_BLK_ERASE_COUNT, count)) goto error;
+      res = (send(WRITE_MULTIPLE_BLOCK, block) == 0);
+ error:
+    spi.end();
+  spi.release();
+  return (res);
+}
+
+bool
+SD::write_next(const uint8_t* src)
+{
+  bool res;
+
+  // Transfer next data block in the stream
+  spi.acquire(this);
+    spi.begin();
+      res = write_data(WRITE_MULTIPLE_TOKEN, src);
+    spi.end();
+  spi.release();
+  return (res);
+}
+
+bool
+SD::end_write()
+{
+  uint8_t status;
+  bool res = false;
+
+  // Stop the stream, wait for the programming to complete and check status
+  spi.acquire(this);
+    spi.begin();
+      spi.transfer(STOP_TRAN_TOKEN);
+      spi.transfer(0xff);
+      if (!ready(WRITE_TIMEOUT)) goto error;
       status = send(SEND_STATUS);
       if (status != 0) goto error;
       status = spi.transfer(0xff);
@@ -365,4 +467,3 @@ SD::write(uint32_t block, const uint8_t* src)
   spi.release();
   return (res);
 }
-
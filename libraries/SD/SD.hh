@@ -361,6 +361,15 @@ protected:
    */
   bool await(uint16_t ms = 0, uint8_t token = 0);
 
+  /**
+   * Wait for the card to become ready (not busy). Wait for at most
+   * given period in milli-seconds. Return true if the card is ready
+   * otherwise false if the time limit was exceeded.
+   * @param[in] ms timeout period in number of milli-seconds.
+   * @return bool.
+   */
+  bool ready(uint16_t ms);
+
   /**
    * Receive 32-bit response from device.
    * @return long reponse.
@@ -379,6 +388,26 @@ protected:
    */
   bool read(CMD command, uint32_t arg, void* buf, size_t count);
 
+  /**
+   * Wait for data start token and receive data block with given
+   * number of bytes into given buffer. Returns true if successful
+   * and the check sum is correct otherwise false.
+   * @param[in] buf pointer to buffer for data.
+   * @param[in] count number of bytes.
+   * @return bool.
+   */
+  bool read_data(void* buf, size_t count);
+
+  /**
+   * Transfer given start token and data block of BLOCK_MAX bytes
+   * with check sum, and wait for the card to complete programming.
+   * Returns true if the data block was accepted otherwise false.
+   * @param[in] token data start token.
+   * @param[in] src pointer to source buffer.
+   * @return bool.
+   */
+  bool write_data(uint8_t token, const uint8_t* src);
+
 public:
   /**
    * Construct Secure Disk low-level SPI device driver with given chip
@@ -483,6 +512,61 @@ public:
    * @return bool.
    */
   bool write(uint32_t block, const uint8_t* src);
+
+  /**
+   * Start streaming read of consecutive blocks from the given block
+   * address (READ_MULTIPLE_BLOCK). Blocks are read with read_next()
+   * and the stream is terminated with end_read(). The card may not
+   * be accessed with other commands until the stream is terminated.
+   * Returns true if successful otherwise false.
+   * @param[in] block address.
+   * @return bool.
+   */
+  bool begin_read(uint32_t block);
+
+  /**
+   * Read next block in the stream into the given destination buffer.
+   * The buffer must be able to hold BLOCK_MAX bytes. Returns true if
+   * successful otherwise false.
+   * @param[in] dst pointer to destination buffer.
+   * @return bool.
+   */
+  bool read_next(uint8_t* dst);
+
+  /**
+   * Terminate streaming read (STOP_TRANSMISSION). Returns true if
+   * successful otherwise false.
+   * @return bool.
+   */
+  bool end_read();
+
+  /**
+   * Start streaming write of consecutive blocks to the given block
+   * address (WRITE_MULTIPLE_BLOCK). The number of blocks, if known,
+   * is given to the card as a pre-erase hint. Blocks are written with
+   * write_next() and the stream is terminated with end_write(). The
+   * card may not be accessed with other commands until the stream is
+   * terminated. Returns true if successful otherwise false.
+   * @param[in] block address.
+   * @param[in] count number of blocks to pre-erase (default 0).
+   * @return bool.
+   */
+  bool begin_write(uint32_t block, uint32_t count = 0);
+
+  /**
+   * Write given source buffer with BLOCK_MAX bytes as next block in
+   * the stream. Returns true if successful otherwise false.
+   * @param[in] src pointer to source buffer.
+   * @return bool.
+   */
+  bool write_next(const uint8_t* src);
+
+  /**
+   * Terminate streaming write (stop token) and wait for the card to
+   * complete programming. Returns true if successful otherwise false.
+   * @return bool.
+   */
+  bool end_write();
 };
 
 #endif
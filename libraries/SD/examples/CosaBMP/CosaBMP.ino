@@ -16,13 +16,15 @@
  * Lesser General Public License for more details.
  *
  * @section Description
- * Short demo, test and benchmark of the BMP file on SD.
+ * Short demo, test and benchmark of the BMP file on SD. The bitmap
+ * is drawn on the ST7735 with BMP::Image; full screen and clipped.
  *
  * This file is part of the Arduino Che Cosa project.
  */
 
 #include <SD.h>
 #include <FAT16.h>
+#include <BMP.h>
 
 #include "Cosa/Memory.h"
 #include "Cosa/RTT.hh"
@@ -46,43 +48,16 @@ SD sd(Board::D4);
 OutputPin eth(Board::D10, 1);
 
 #elif defined(USE_TFT_ST7735)
+#include <Canvas.h>
+#include <ST7735.h>
 SD sd;
-OutputPin tft(Board::D10, 1);
+ST7735 tft;
 #endif
 
 #define SLOW_CLOCK SPI::DIV4_CLOCK
 #define FAST_CLOCK SPI::DIV2_CLOCK
 #define CLOCK FAST_CLOCK
 
-class BMP {
-public:
-  struct file_header_t {
-    uint16_t signature;
-    uint32_t file_size;
-    uint16_t reserved[2];
-    uint32_t image_offset;
-  };
-  struct image_header_t {
-    uint32_t header_size;
-    uint32_t image_width;
-    uint32_t image_height;
-    uint16_t color_planes;
-    uint16_t bits_per_pixel;
-    uint32_t compression_method;
-    uint32_t image_size;
-    uint32_t horizontal_resolution;
-    uint32_t vertical_resolution;
-    uint32_t colors_in_palette;
-    uint32_t important_colors;
-  };
-  struct color24_t {
-    uint8_t red;
-    uint8_t green;
-    uint8_t blue;
-  };
-  static const uint16_t SIGNATURE = 0x4d42;
-};
-
 bool operator>>(FAT16::File& file, BMP::file_header_t& header)
 {
   return ((file.read(&header, sizeof(header)) == sizeof(header))
@@ -91,16 +66,7 @@ bool operator>>(FAT16::File& file, BMP::file_header_t& header)
 
 bool operator>>(FAT16::File& file, BMP::image_header_t& header)
 {
-  return ((file.read(&header, sizeof(header)) == sizeof(header))
-	  && (header.header_size == sizeof(header))
-	  && (header.color_planes == 1)
-	  && (header.bits_per_pixel == 24)
-	  && (header.compression_method == 0));
-}
-
-bool operator>>(FAT16::File& file, BMP::color24_t buf[32])
-{
-  return (file.read(buf, sizeof(buf)) == sizeof(buf));
+  return (file.read(&header, sizeof(header)) == sizeof(header));
 }
 
 IOStream& operator<<(IOStream& outs, BMP::file_header_t& header)
@@ -127,23 +93,6 @@ IOStream& operator<<(IOStream& outs, BMP::image_header_t& header)
   return (outs);
 }
 
-IOStream& operator<<(IOStream& outs, BMP::color24_t pixel)
-{
-  outs << '<'
-       << pixel.red << '.'
-       << pixel.green << '.'
-       << pixel.blue
-       << '>';
-  return (outs);
-}
-
-IOStream& operator<<(IOStream& outs, BMP::color24_t buf[32])
-{
-  for (uint16_t i = 0; i < 32; i++)
-    outs << i << ':' << buf[i] << endl;
-  return (outs);
-}
-
 void setup()
 {
   Watchdog::begin();
@@ -153,6 +102,9 @@ void setup()
   TRACE(free_memory());
   trace.println();
 
+#if defined(USE_TFT_ST7735)
+  tft.begin();
+#endif
   ASSERT(sd.begin(CLOCK));
   ASSERT(FAT16::begin(&sd));
 }
@@ -173,10 +125,20 @@ void loop()
   ASSERT(file >> image_header);
   trace << image_header << endl;
 
-  INFO("Read some pixels and print", 0);
-  BMP::color24_t image_buffer[32];
-  ASSERT(file >> image_buffer);
-  trace << image_buffer << endl;
+  INFO("Verify image", 0);
+  BMP::Image image(&file);
+  ASSERT(image.begin());
+  TRACE(image.WIDTH);
+  TRACE(image.HEIGHT);
+
+#if defined(USE_TFT_ST7735)
+  INFO("Draw image and clipped image", 0);
+  MEASURE("draw_image:", 1) tft.draw_image(0, 0, &image);
+  image.clip(image.WIDTH / 4, image.HEIGHT / 4,
+	     image.WIDTH / 2, image.HEIGHT / 2);
+  tft.fill_screen();
+  MEASURE("draw_image(clip):", 1) tft.draw_image(0, 0, &image);
+#endif
 
   INFO("Cleanup and terminate", 0);
   ASSERT(file.close());
@@ -0,0 +1,232 @@
+/**
+ * @file SRAM23LC.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "SRAM23LC.hh"
+
+bool
+SRAM23LC::begin()
+{
+  // Reset to SPI access and set sequential mode
+  spi.acquire(this);
+    spi.begin();
+      spi.transfer(RSTIO);
+    spi.end();
+    spi.begin();
+      spi.transfer(WRMR);
+      spi.transfer(SEQUENTIAL_MODE);
+    spi.end();
+    spi.begin();
+      spi.transfer(RDMR);
+      uint8_t mode = spi.transfer(0);
+    spi.end();
+  spi.release();
+
+  // And check
+  return (mode == SEQUENTIAL_MODE);
+}
+
+uint8_t
+SRAM23LC::header(uint8_t* header, Command cmd, uint32_t addr)
+{
+  // Command with 16 or 24-bit address; Big-endian
+  uint8_t* ap = (uint8_t*) &addr;
+  uint8_t* hp = header;
+  *hp++ = cmd;
+  if (m_device == LC1024) *hp++ = ap[2];
+  *hp++ = ap[1];
+  *hp++ = ap[0];
+  return (hp - header);
+}
+
+int
+SRAM23LC::read(void* dest, uint32_t src, size_t size)
+{
+  if (UNLIKELY(!is_valid(src, size))) return (EINVAL);
+  uint8_t buf[4];
+  uint8_t len = header(buf, READ, src);
+  spi.acquire(this);
+    spi.begin();
+      spi.write(buf, len);
+      spi.read(dest, size);
+    spi.end();
+  spi.release();
+  return ((int) size);
+}
+
+int
+SRAM23LC::write(uint32_t dest, const void* src, size_t size)
+{
+  if (UNLIKELY(!is_valid(dest, size))) return (EINVAL);
+  uint8_t buf[4];
+  uint8_t len = header(buf, WRITE, dest);
+  spi.acquire(this);
+    spi.begin();
+      spi.write(buf, len);
+      spi.write(src, size);
+    spi.end();
+  spi.release();
+  return ((int) size);
+}
+
+int
+SRAM23LC::write_P(uint32_t dest, const void* src, size_t size)
+{
+  if (UNLIKELY(!is_valid(dest, size))) return (EINVAL);
+  uint8_t buf[4];
+  uint8_t len = header(buf, WRITE, dest);
+  spi.acquire(this);
+    spi.begin();
+      spi.write(buf, len);
+      spi.write_P(src, size);
+    spi.end();
+  spi.release();
+  return ((int) size);
+}
+
+#if defined(SPDR)
+bool
+SRAM23LC::read(Transfer* transfer, void* dest, uint32_t src, size_t size)
+{
+  if (UNLIKELY(transfer->is_pending() || !is_valid(src, size))) return (false);
+
+  // Exchange mode; the header is sent and overwritten with the
+  // received bytes. The device ignores the data sent while reading
+  iovec_t* vp = transfer->m_iov;
+  uint8_t len = header(transfer->m_header, READ, src);
+  iovec_arg(vp, transfer->m_header, len);
+  iovec_arg(vp, dest, size);
+  iovec_end(vp);
+  transfer->set(transfer->m_iov, SPI::Transfer::EXCHANGE_MODE);
+  return (spi.start(transfer));
+}
+
+bool
+SRAM23LC::write(Transfer* transfer, uint32_t dest, const void* src, size_t size)
+{
+  if (UNLIKELY(transfer->is_pending() || !is_valid(dest, size))) return (false);
+  iovec_t* vp = transfer->m_iov;
+  uint8_t len = header(transfer->m_header, WRITE, dest);
+  iovec_arg(vp, transfer->m_header, len);
+  iovec_arg(vp, src, size);
+  iovec_end(vp);
+  transfer->set(transfer->m_iov, SPI::Transfer::WRITE_MODE);
+  return (spi.start(transfer));
+}
+#endif
+
+int
+SRAM23LC::Buffer::available()
+{
+  return (m_length > INT16_MAX ? INT16_MAX : (int) m_length);
+}
+
+int
+SRAM23LC::Buffer::room()
+{
+  uint32_t res = m_size - m_length;
+  return (res > INT16_MAX ? INT16_MAX : (int) res);
+}
+
+int
+SRAM23LC::Buffer::putchar(char c)
+{
+  if (UNLIKELY(m_length == m_size)) return (IOStream::EOF);
+  m_sram->write(m_base + m_head, &c, sizeof(c));
+  if (++m_head == m_size) m_head = 0L;
+  m_length += 1;
+  return (c & 0xff);
+}
+
+int
+SRAM23LC::Buffer::write(const void* buf, size_t size)
+{
+  // Limit to room in buffer
+  uint32_t free = m_size - m_length;
+  if (size > free) size = free;
+  if (UNLIKELY(size == 0)) return (0);
+
+  // Write to the end of the buffer and wrap-around to the start
+  const uint8_t* bp = (const uint8_t*) buf;
+  size_t n = size;
+  uint32_t count = m_size - m_head;
+  if (count < n) {
+    m_sram->write(m_base + m_head, bp, count);
+    bp += count;
+    n -= count;
+    m_head = 0L;
+  }
+  m_sram->write(m_base + m_head, bp, n);
+  m_head += n;
+  if (m_head == m_size) m_head = 0L;
+  m_length += size;
+  return (size);
+}
+
+int
+SRAM23LC::Buffer::peekchar()
+{
+  if (UNLIKELY(m_length == 0L)) return (IOStream::EOF);
+  uint8_t c;
+  m_sram->read(&c, m_base + m_tail, sizeof(c));
+  return (c);
+}
+
+int
+SRAM23LC::Buffer::getchar()
+{
+  if (UNLIKELY(m_length == 0L)) return (IOStream::EOF);
+  uint8_t c;
+  m_sram->read(&c, m_base + m_tail, sizeof(c));
+  if (++m_tail == m_size) m_tail = 0L;
+  m_length -= 1;
+  return (c);
+}
+
+int
+SRAM23LC::Buffer::read(void* buf, size_t size)
+{
+  // Limit to available data in buffer
+  if (size > m_length) size = m_length;
+  if (UNLIKELY(size == 0)) return (0);
+
+  // Read from the end of the buffer and wrap-around to the start
+  uint8_t* bp = (uint8_t*) buf;
+  size_t n = size;
+  uint32_t count = m_size - m_tail;
+  if (count < n) {
+    m_sram->read(bp, m_base + m_tail, count);
+    bp += count;
+    n -= count;
+    m_tail = 0L;
+  }
+  m_sram->read(bp, m_base + m_tail, n);
+  m_tail += n;
+  if (m_tail == m_size) m_tail = 0L;
+  m_length -= size;
+  return (size);
+}
+
+void
+SRAM23LC::Buffer::empty()
+{
+  m_head = 0L;
+  m_tail = 0L;
+  m_length = 0L;
+}
@@ -0,0 +1,357 @@
+/**
+ * @file SRAM23LC.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_SRAM23LC_HH
+#define COSA_SRAM23LC_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/SPI.hh"
+#include "Cosa/IOStream.hh"
+
+/**
+ * Cosa Microchip 23LC512/23LC1024 SPI Serial SRAM device driver.
+ * The device is used in sequential mode; a read or write command may
+ * access the whole memory array in a single transfer. Blocks may be
+ * read and written synchronously or queued as asynchronous SPI
+ * transfers (SRAM23LC::Transfer). The memory may also be used as a
+ * large ring buffer with the IOStream::Device interface
+ * (SRAM23LC::Buffer).
+ *
+ * @section Circuit
+ * The 23LC512/23LC1024 is a 2.5-5.5V device.
+ * @code
+ *                       23LC1024
+ *                       +------------+
+ * (D10)---------------1-|CS       VCC|-8--------------(VCC)
+ * (MISO/D12)----------2-|SO      HOLD|-7--------------(VCC)
+ * (VCC)---------------3-|SIO2     SCK|-6-------(SCK/D13)
+ * (GND)---------------4-|VSS       SI|-5------(MOSI/D11)
+ *                       +------------+
+ * @endcode
+ *
+ * @section References
+ * 1. Microchip 23A1024/23LC1024, 1Mbit SPI Serial SRAM with SDI and
+ * SQI Interface, DS20005142C.
+ * 2. Microchip 23A512/23LC512, 512Kbit SPI Serial SRAM with SDI and
+ * SQI Interface, DS20005155B.
+ */
+class SRAM23LC : protected SPI::Driver {
+public:
+  /** Device variants. */
+  enum Device {
+    LC512 = 0,			//!< 23LC512; 64 Kbyte, 16-bit address.
+    LC1024 = 1			//!< 23LC1024; 128 Kbyte, 24-bit address.
+  } __attribute__((packed));
+
+  /**
+   * Construct 23LC512/23LC1024 device driver with given chip select
+   * pin and device variant.
+   * @param[in] csn chip select pin (default D10/D3).
+   * @param[in] device variant (default LC1024).
+   */
+#if !defined(BOARD_ATTINY)
+  SRAM23LC(Board::DigitalPin csn = Board::D10, Device device = LC1024) :
+    SPI::Driver(csn, SPI::ACTIVE_LOW, SPI::DIV2_CLOCK, 0, SPI::MSB_ORDER, NULL),
+    m_device(device)
+  {}
+#else
+  SRAM23LC(Board::DigitalPin csn = Board::D3, Device device = LC1024) :
+    SPI::Driver(csn, SPI::ACTIVE_LOW, SPI::DIV2_CLOCK, 0, SPI::MSB_ORDER, NULL),
+    m_device(device)
+  {}
+#endif
+
+  /**
+   * Initiate the device driver; reset to SPI mode and set sequential
+   * mode. Return true(1) if successful otherwise false(0).
+   * @return bool.
+   */
+  bool begin();
+
+  /**
+   * Return size of memory array in bytes.
+   * @return bytes.
+   */
+  uint32_t size() const
+  {
+    return (m_device == LC1024 ? 0x20000UL : 0x10000UL);
+  }
+
+  /**
+   * Read memory block with the given size into the buffer from the
+   * source address. Return number of bytes read or negative error
+   * code (EINVAL if outside the memory array).
+   * @param[in] dest buffer to read into.
+   * @param[in] src address in memory to read from.
+   * @param[in] size number of bytes to read.
+   * @return number of bytes or negative error code.
+   */
+  int read(void* dest, uint32_t src, size_t size);
+
+  /**
+   * Write memory block at given destination address with the contents
+   * of the source buffer. Return number of bytes written or negative
+   * error code (EINVAL if outside the memory array).
+   * @param[in] dest address in memory to write to.
+   * @param[in] src buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes or negative error code.
+   */
+  int write(uint32_t dest, const void* src, size_t size);
+
+  /**
+   * Write memory block at given destination address with the contents
+   * of the source buffer in program memory. Return number of bytes
+   * written or negative error code (EINVAL if outside the memory
+   * array).
+   * @param[in] dest address in memory to write to.
+   * @param[in] src buffer in program memory to write.
+   * @param[in] size number of bytes to write.
+   * @return number of bytes or negative error code.
+   */
+  int write_P(uint32_t dest, const void* src, size_t size);
+
+#if defined(SPDR)
+  /**
+   * Asynchronous memory block transfer. Holds the command and address
+   * header and the io buffer vector. The transfer is started with
+   * SRAM23LC::read() or SRAM23LC::write() and performed by the SPI
+   * interrupt service routine. Completion may be awaited or handled
+   * with on_completed().
+   * @code
+   * SRAM23LC sram;
+   * SRAM23LC::Transfer transfer(&sram);
+   * uint8_t buf[256];
+   * ...
+   * sram.write(&transfer, addr, buf, sizeof(buf));
+   * ...
+   * transfer.await();
+   * @endcode
+   */
+  class Transfer : public SPI::Transfer {
+  public:
+    /**
+     * Construct asynchronous transfer descriptor for given device.
+     * @param[in] sram device driver.
+     */
+    Transfer(SRAM23LC* sram) : SPI::Transfer(sram) {}
+
+  protected:
+    /** Command and address header; max 24-bit address. */
+    uint8_t m_header[4];
+
+    /** Io buffer vector; header, data block and terminator. */
+    iovec_t m_iov[3];
+
+    friend class SRAM23LC;
+  };
+
+  /**
+   * Start asynchronous read of memory block with the given size into
+   * the buffer from the source address. The buffer must not be used
+   * until the transfer is completed. Returns true(1) if the transfer
+   * was started otherwise false(0); pending transfer or outside the
+   * memory array.
+   * @param[in] transfer descriptor.
+   * @param[in] dest buffer to read into.
+   * @param[in] src address in memory to read from.
+   * @param[in] size number of bytes to read.
+   * @return bool.
+   */
+  bool read(Transfer* transfer, void* dest, uint32_t src, size_t size);
+
+  /**
+   * Start asynchronous write of memory block at given destination
+   * address with the contents of the source buffer. The buffer must
+   * not be changed until the transfer is completed. Returns true(1)
+   * if the transfer was started otherwise false(0); pending transfer
+   * or outside the memory array.
+   * @param[in] transfer descriptor.
+   * @param[in] dest address in memory to write to.
+   * @param[in] src buffer to write.
+   * @param[in] size number of bytes to write.
+   * @return bool.
+   */
+  bool write(Transfer* transfer, uint32_t dest, const void* src, size_t size);
+#endif
+
+  /**
+   * Ring buffer in a region of the memory array with the IOStream
+   * device interface. The data is transferred in at most two
+   * sequential segments (wrap-around) per read or write. The buffer
+   * should only be used from the main context; not from interrupt
+   * handlers. Block read and write should be used for performance;
+   * each character operation is a memory command.
+   */
+  class Buffer : public IOStream::Device {
+  public:
+    /**
+     * Construct ring buffer in given device with given base address
+     * and size in bytes.
+     * @param[in] sram device driver.
+     * @param[in] base address in memory (default 0).
+     * @param[in] size number of bytes (default whole memory array).
+     */
+    Buffer(SRAM23LC* sram, uint32_t base = 0L, uint32_t size = 0L) :
+      IOStream::Device(),
+      m_sram(sram),
+      m_base(base),
+      m_size(size != 0L ? size : sram->size() - base),
+      m_head(0L),
+      m_tail(0L),
+      m_length(0L)
+    {}
+
+    /**
+     * Return number of bytes in buffer.
+     * @return bytes.
+     */
+    uint32_t length() const
+    {
+      return (m_length);
+    }
+
+    /**
+     * @override{IOStream::Device}
+     * Number of bytes available; limited to max int.
+     * @return bytes.
+     */
+    virtual int available();
+
+    /**
+     * @override{IOStream::Device}
+     * Number of bytes room; limited to max int.
+     * @return bytes.
+     */
+    virtual int room();
+
+    /**
+     * @override{IOStream::Device}
+     * Write character to buffer.
+     * @param[in] c character to write.
+     * @return character written or EOF(-1).
+     */
+    virtual int putchar(char c);
+
+    /** Overloaded virtual member function write. */
+    using IOStream::Device::write;
+
+    /**
+     * @override{IOStream::Device}
+     * Write data from buffer with given size to ring buffer. Returns
+     * number of bytes written (limited by room in buffer).
+     * @param[in] buf buffer to write.
+     * @param[in] size number of bytes to write.
+     * @return number of bytes written.
+     */
+    virtual int write(const void* buf, size_t size);
+
+    /**
+     * @override{IOStream::Device}
+     * Peek at the next character from buffer.
+     * @return character or EOF(-1).
+     */
+    virtual int peekchar();
+
+    /**
+     * @override{IOStream::Device}
+     * Read character from buffer.
+     * @return character or EOF(-1).
+     */
+    virtual int getchar();
+
+    /** Overloaded virtual member function read. */
+    using IOStream::Device::read;
+
+    /**
+     * @override{IOStream::Device}
+     * Read data to given buffer with given size from ring buffer.
+     * Returns number of bytes read (limited by available data).
+     * @param[in] buf buffer to read into.
+     * @param[in] size number of bytes to read.
+     * @return number of bytes read.
+     */
+    virtual int read(void* buf, size_t size);
+
+    /**
+     * @override{IOStream::Device}
+     * Empty ring buffer.
+     */
+    virtual void empty();
+
+  protected:
+    SRAM23LC* m_sram;		//!< Device driver.
+    uint32_t m_base;		//!< Base address in memory.
+    uint32_t m_size;		//!< Size of ring buffer.
+    uint32_t m_head;		//!< Write offset.
+    uint32_t m_tail;		//!< Read offset.
+    uint32_t m_length;		//!< Number of bytes in buffer.
+  };
+
+protected:
+  /**
+   * Instruction Set (Table 2-1, pp. 6).
+   */
+  enum Command {
+    READ = 0x03,		//!< Read data from memory.
+    WRITE = 0x02,		//!< Write data to memory.
+    EDIO = 0x3b,		//!< Enter Dual I/O access.
+    EQIO = 0x38,		//!< Enter Quad I/O access.
+    RSTIO = 0xff,		//!< Reset Dual and Quad I/O access.
+    RDMR = 0x05,		//!< Read mode register.
+    WRMR = 0x01			//!< Write mode register.
+  } __attribute__((packed));
+
+  /**
+   * Mode register operating modes (Table 2-2, pp. 7).
+   */
+  enum Mode {
+    BYTE_MODE = 0x00,		//!< Byte mode.
+    PAGE_MODE = 0x80,		//!< Page mode (32 byte).
+    SEQUENTIAL_MODE = 0x40	//!< Sequential mode (default).
+  } __attribute__((packed));
+
+  /** Device variant. */
+  Device m_device;
+
+  /**
+   * Write command header with given command and address to given
+   * buffer. Return header length; command and 16 or 24-bit address.
+   * @param[in] header buffer (at least 4 bytes).
+   * @param[in] cmd command code.
+   * @param[in] addr memory address.
+   * @return header length.
+   */
+  uint8_t header(uint8_t* header, Command cmd, uint32_t addr);
+
+  /**
+   * Return true(1) if the given block is within the memory array
+   * otherwise false(0).
+   * @param[in] addr memory address.
+   * @param[in] size number of bytes.
+   * @return bool.
+   */
+  bool is_valid(uint32_t addr, size_t size) const
+  {
+    return (addr + size <= SRAM23LC::size());
+  }
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file CosaSRAM23LC.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the 23LC1024 SPI Serial SRAM device driver.
+ * Measure performance of block read and write, asynchronous
+ * transfer and use of the memory as a ring buffer.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <SRAM23LC.h>
+#include "Cosa/UART.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Memory.h"
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+
+SRAM23LC sram;
+SRAM23LC::Transfer transfer(&sram);
+SRAM23LC::Buffer buffer(&sram, 0x10000L, 0x1000L);
+IOStream cout(&buffer);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaSRAM23LC: started"));
+  Watchdog::begin();
+  RTT::begin();
+  TRACE(free_memory());
+  TRACE(sizeof(sram));
+  TRACE(sizeof(transfer));
+  TRACE(sizeof(buffer));
+  ASSERT(sram.begin());
+  TRACE(sram.size());
+}
+
+void loop()
+{
+  static uint32_t addr = 0L;
+  uint8_t buf[256];
+  uint32_t start, us;
+
+  // Write and read back a block
+  for (uint16_t i = 0; i < sizeof(buf); i++) buf[i] = addr + i;
+  start = RTT::micros();
+  ASSERT(sram.write(addr, buf, sizeof(buf)) == sizeof(buf));
+  us = RTT::micros() - start;
+  trace << PSTR("write: dest = ") << hex << addr
+	<< PSTR(", bytes = ") << sizeof(buf)
+	<< PSTR(", us = ") << us
+	<< endl;
+  memset(buf, 0, sizeof(buf));
+  start = RTT::micros();
+  ASSERT(sram.read(buf, addr, sizeof(buf)) == sizeof(buf));
+  us = RTT::micros() - start;
+  trace << PSTR("read: src = ") << hex << addr
+	<< PSTR(", bytes = ") << sizeof(buf)
+	<< PSTR(", us = ") << us
+	<< endl;
+  for (uint16_t i = 0; i < sizeof(buf); i++)
+    ASSERT(buf[i] == (uint8_t) (addr + i));
+
+  // Asynchronous read; count while the transfer is performed
+  memset(buf, 0, sizeof(buf));
+  uint32_t count = 0L;
+  start = RTT::micros();
+  ASSERT(sram.read(&transfer, buf, addr, sizeof(buf)));
+  while (transfer.is_pending()) count++;
+  us = RTT::micros() - start;
+  trace << PSTR("read(async): src = ") << hex << addr
+	<< PSTR(", count = ") << count
+	<< PSTR(", us = ") << us
+	<< endl;
+  for (uint16_t i = 0; i < sizeof(buf); i++)
+    ASSERT(buf[i] == (uint8_t) (addr + i));
+  Event event;
+  while (Event::queue.dequeue(&event));
+
+  // Ring buffer; print and read back
+  cout << PSTR("addr = ") << hex << addr << endl;
+  trace << PSTR("buffer: available = ") << buffer.available() << endl;
+  while (buffer.available()) trace << (char) buffer.getchar();
+
+  addr = (addr + sizeof(buf)) & 0xffff;
+  sleep(2);
+}
@@ -0,0 +1,227 @@
+/**
+ * @file SRPI.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_SRPI_HH
+#define COSA_SRPI_HH
+
+#include "Cosa/SPI.hh"
+#include "Cosa/Periodic.hh"
+
+/**
+ * N-Shift Register Parallel Input, 3-Wire SPI device driver. The
+ * shift registers (74HC165) may be cascaded for N*8-bit parallel
+ * input port (see circuit below). The pins are numbered from the
+ * first connect shift register (Q0..Q7) and updwards in the chain
+ * (Q8..Q15) and so on. The chip select pin is used as the parallel
+ * load signal.
+ *
+ * @section Circuit
+ * @code
+ *                         74HC165    (VCC)
+ *                       +----U----+    |
+ * (EN/D10)---+--------1-|/PL   VCC|-16-+
+ * (SCK/D13)+-)--------2-|CP    /CE|-15-----------(GND)
+ * (Q4)-----)-)--------3-|D4     D3|-14------------(Q3)
+ * (Q5)-----)-)--------4-|D5     D2|-13------------(Q2)
+ * (Q6)-----)-)--------5-|D6     D1|-12------------(Q1)
+ * (Q7)-----)-)--------6-|D7     D0|-11------------(Q0)
+ *          | |        7-|/Q7    DS|-10-----------------+
+ *          | |      +-8-|GND    Q7|--9-------(MISO/D12)|
+ *          | |      |   +---------+                    |
+ *          | |      |      0.1uF                       |
+ *          | |    (GND)-----||-------(VCC)             |
+ *          | |                         |               |
+ *          | |            74HC165      |               |
+ *          | |          +----U----+    |               |
+ *          | +--------1-|/PL   VCC|-16-+               |
+ *          +-)--------2-|CP    /CE|-15-----------(GND) |
+ * (Q12)----)-)--------3-|D4     D3|-14-----------(Q11) |
+ * (Q13)----)-)--------4-|D5     D2|-13-----------(Q10) |
+ * (Q14)----)-)--------5-|D6     D1|-12------------(Q9) |
+ * (Q15)----)-)--------6-|D7     D0|-11------------(Q8) |
+ *          | |        7-|/Q7    DS|-10-----------------)--+
+ *          | |      +-8-|GND    Q7|--9-----------------+  |
+ *          | |      |   +---------+                       |
+ *          | |      |      0.1uF                          |
+ *          v v    (GND)-----||-------(VCC)                v
+ * @endcode
+ *
+ * @section Note
+ * The 74HC165 serial output (Q7) is not tri-stated. A buffer is
+ * needed on MISO if other devices share the SPI bus.
+ *
+ * @param[in] N number of shift registers (N * 8 input pins).
+ */
+template<uint8_t N>
+class SRPI : public SPI::Driver {
+public:
+  /** Number of pins for N ports */
+  static const uint8_t PINS = N * CHARBITS;
+
+  /**
+   * Construct N-shift register connected to SPI (MISO, SCK) and given
+   * parallel load (chip select) pin.
+   * @param[in] pld parallel load pin (Default Board::D10/D3).
+   * @param[in] clock SPI hardware setting (default DIV4_CLOCK).
+   */
+#if !defined(BOARD_ATTINY)
+  SRPI(Board::DigitalPin pld = Board::D10,
+       SPI::Clock rate = SPI::DEFAULT_CLOCK) :
+    SPI::Driver(pld, SPI::PULSE_LOW, rate)
+  {
+    memset(m_port, 0, N);
+  }
+#else
+  SRPI(Board::DigitalPin pld = Board::D3,
+       SPI::Clock rate = SPI::DEFAULT_CLOCK) :
+    SPI::Driver(pld, SPI::PULSE_LOW, rate)
+  {
+    memset(m_port, 0, N);
+  }
+#endif
+
+  /**
+   * Return true(1) if the given pin in shadow register is set,
+   * otherwise false(0).
+   * @param[in] pin pin number.
+   * @return bool.
+   */
+  bool is_set(uint8_t pin)
+    __attribute__((always_inline))
+  {
+    uint8_t ix = (pin >> 3);
+    return ((m_port[ix] & _BV(pin & 0x7)) != 0);
+  }
+
+  /**
+   * Return true(1) if the given pin in shadow register is clear,
+   * otherwise false(0).
+   * @param[in] pin pin number.
+   * @return bool.
+   */
+  bool is_clear(uint8_t pin)
+    __attribute__((always_inline))
+  {
+    uint8_t ix = (pin >> 3);
+    return ((m_port[ix] & _BV(pin & 0x7)) == 0);
+  }
+
+  /**
+   * Update shadow registers with value of shift registers. Parallel
+   * load (chip select pulse) and shift the chain once. Return true(1)
+   * if any pin has changed since the latest update otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool update()
+  {
+    uint8_t port[N];
+    spi.acquire(this);
+      spi.begin();
+      spi.end();
+      spi.begin();
+        spi.read(port, N);
+      spi.end();
+    spi.release();
+    bool changed = (memcmp(m_port, port, N) != 0);
+    memcpy(m_port, port, N);
+    return (changed);
+  }
+
+  /**
+   * Input pin in shift-register parallel input port.
+   */
+  class InputPin {
+  public:
+    InputPin(SRPI<N>* srpi, uint8_t pin) :
+      m_srpi(srpi),
+      m_pin(pin)
+    {
+    }
+
+    /**
+     * Return true(1) if the pin in shadow register is set,
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_set()
+      __attribute__((always_inline))
+    {
+      return (m_srpi->is_set(m_pin));
+    }
+
+    /**
+     * Return true(1) if the pin in shadow register is clear,
+     * otherwise false(0).
+     * @return bool.
+     */
+    bool is_clear()
+      __attribute__((always_inline))
+    {
+      return (m_srpi->is_clear(m_pin));
+    }
+
+  protected:
+    SRPI<N>* m_srpi;
+    const uint8_t m_pin;
+  };
+
+  /**
+   * Periodic sampling of shift register. Calls on_change() when any
+   * pin has changed.
+   */
+  class Scanner : public Periodic {
+  public:
+    /**
+     * Construct periodic sampling of given shift register with given
+     * scheduler and period.
+     * @param[in] scheduler for the periodic job.
+     * @param[in] srpi shift register.
+     * @param[in] period of sampling (scheduler time base).
+     */
+    Scanner(Job::Scheduler* scheduler, SRPI<N>* srpi, uint32_t period) :
+      Periodic(scheduler, period),
+      m_srpi(srpi)
+    {}
+
+    /**
+     * @override{Job}
+     * Sample shift register and call on_change() if modified.
+     */
+    virtual void run()
+    {
+      if (m_srpi->update()) on_change();
+    }
+
+    /**
+     * @override{SRPI::Scanner}
+     * Called when any pin has changed.
+     */
+    virtual void on_change() {}
+
+  protected:
+    SRPI<N>* m_srpi;
+  };
+
+protected:
+  /** Shadow port register; LSB..MSB byte */
+  uint8_t m_port[N];
+};
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file CosaSRPI.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstrate Cosa N-Shift Register (SRPI) SPI device driver. Cascade
+ * two shift registers (74HC165), sample the inputs periodically and
+ * print the pins when changed.
+ *
+ * @section Circuit
+ * See SRPI.hh for circuit connections.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <SRPI.h>
+
+#include "Cosa/Event.hh"
+#include "Cosa/Watchdog.hh"
+#include "Cosa/Trace.hh"
+#include "Cosa/UART.hh"
+
+// Two cascaded shift registers
+SRPI<2> srpi;
+
+// Print pins on change
+class Scanner : public SRPI<2>::Scanner {
+public:
+  Scanner() : SRPI<2>::Scanner(Watchdog::scheduler(), &srpi, 64) {}
+
+  virtual void on_change()
+  {
+    for (uint8_t pin = 0; pin < srpi.PINS; pin++)
+      trace << srpi.is_set(pin);
+    trace << endl;
+  }
+};
+
+Scanner scanner;
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaSRPI: started"));
+  Watchdog::begin();
+  scanner.start();
+}
+
+void loop()
+{
+  Event::service();
+}
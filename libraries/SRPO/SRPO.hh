@@ -22,6 +22,7 @@
 #define COSA_SRPO_HH
 
 #include "Cosa/SPI.hh"
+#include "Cosa/Periodic.hh"
 
 /**
  * N-Shift Register Parallel Output, 3-Wire SPI device driver. The
@@ -136,6 +137,7 @@ public:
   {
     uint8_t ix = (pin >> 3);
     m_port[ix] |= _BV(pin & 0x7);
+    m_dirty = true;
   }
 
   /**
@@ -148,6 +150,7 @@ public:
   {
     uint8_t ix = (pin >> 3);
     m_port[ix] &= ~_BV(pin & 0x7);
+    m_dirty = true;
   }
 
   /**
@@ -172,6 +175,7 @@ public:
     __attribute__((always_inline))
   {
     memset(m_port, 0xff, N);
+    m_dirty = true;
   }
 
   /**
@@ -182,6 +186,46 @@ public:
     __attribute__((always_inline))
   {
     memset(m_port, 0, N);
+    m_dirty = true;
+  }
+
+  /**
+   * Write given value to given pin in shadow register. Call update()
+   * or commit() to write to shift register.
+   * @param[in] pin pin number.
+   * @param[in] value to write.
+   */
+  void write(uint8_t pin, bool value)
+    __attribute__((always_inline))
+  {
+    if (value)
+      set(pin);
+    else
+      clear(pin);
+  }
+
+  /**
+   * Return true(1) if the shadow registers have been modified since
+   * the latest update, otherwise false(0).
+   * @return bool.
+   */
+  bool is_dirty() const
+    __attribute__((always_inline))
+  {
+    return (m_dirty);
+  }
+
+  /**
+   * Update shift register with value of shadow registers if modified
+   * since the latest update. Return true(1) if updated otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool commit()
+  {
+    if (!m_dirty) return (false);
+    update();
+    return (true);
   }
 
   /**
@@ -189,6 +233,7 @@ public:
    */
   void update()
   {
+    m_dirty = false;
     spi.acquire(this);
       spi.begin();
         uint8_t ix = N - 1;
@@ -244,13 +289,64 @@ public:
       m_srpo->toggle(m_pin);
     }
 
+    /**
+     * Write given value to pin in shadow register. Call update() to
+     * write to shift register.
+     * @param[in] value to write.
+     */
+    void write(bool value)
+      __attribute__((always_inline))
+    {
+      m_srpo->write(m_pin, value);
+    }
+
   protected:
     SRPO<N>* m_srpo;
     const uint8_t m_pin;
   };
 
+  /**
+   * Periodic update of shift register. The shift register is only
+   * written when the shadow registers have been modified.
+   * @code
+   * SRPO<4> srpo;
+   * SRPO<4>::Refresher refresher(Watchdog::scheduler(), &srpo, 64);
+   * ...
+   * refresher.start();
+   * @endcode
+   */
+  class Refresher : public Periodic {
+  public:
+    /**
+     * Construct periodic update of given shift register with given
+     * scheduler and period.
+     * @param[in] scheduler for the periodic job.
+     * @param[in] srpo shift register.
+     * @param[in] period of update (scheduler time base).
+     */
+    Refresher(Job::Scheduler* scheduler, SRPO<N>* srpo, uint32_t period) :
+      Periodic(scheduler, period),
+      m_srpo(srpo)
+    {}
+
+    /**
+     * @override{Job}
+     * Update shift register if modified.
+     */
+    virtual void run()
+    {
+      m_srpo->commit();
+    }
+
+  protected:
+    SRPO<N>* m_srpo;
+  };
+
 protected:
   /** Shadow port register. */
   uint8_t m_port[N];
+
+  /** Shadow port register modified. */
+  bool m_dirty;
 };
 #endif
@@ -44,7 +44,11 @@ ST7565::ST7565(LCD::IO* io, Board::DigitalPin dc, Font* font) :
   LCD::Device(),
   m_io(io),
   m_dc(dc, 1),
-  m_font(font)
+  m_font(font),
+  m_fb(NULL),
+  m_fx(0),
+  m_fy(0),
+  m_dirty(0)
 {
 }
 
@@ -61,6 +65,11 @@ ST7565::set(uint8_t cmd)
 void
 ST7565::set(uint8_t x, uint8_t y)
 {
+  if (m_fb != NULL) {
+    m_fx = x;
+    m_fy = (y & (LINES - 1));
+    return;
+  }
   m_io->begin();
   asserted(m_dc) {
     m_io->write(SET_X_ADDR | ((x >> 4) & X_ADDR_MASK));
@@ -70,12 +79,59 @@ ST7565::set(uint8_t x, uint8_t y)
   m_io->end();
 }
 
+void
+ST7565::data(uint8_t data)
+{
+  if (m_fb == NULL) {
+    m_io->write(data);
+    return;
+  }
+  if (UNLIKELY(m_fx >= WIDTH)) return;
+  m_fb->bitmap()[(m_fy * WIDTH) + m_fx++] = data;
+  m_dirty |= (1 << m_fy);
+}
+
 void
 ST7565::fill(uint8_t data, uint16_t count)
 {
-  m_io->begin();
-  while (count--) m_io->write(data);
-  m_io->end();
+  data_begin();
+  while (count--) this->data(data);
+  data_end();
+}
+
+ST7565::FrameBuffer*
+ST7565::set_framebuffer(FrameBuffer* fb)
+{
+  FrameBuffer* previous = m_fb;
+  m_fb = fb;
+  m_dirty = (fb != NULL) ? 0xff : 0;
+  set(m_x, m_y);
+  return (previous);
+}
+
+int
+ST7565::flush()
+{
+  if (m_fb == NULL) return (0);
+
+  // Collect changed pages; text and canvas drawing
+  uint8_t dirty = m_dirty | m_fb->damaged_pages();
+  m_dirty = 0;
+
+  // Send each changed page with a single address setting and burst
+  const uint8_t* bp = m_fb->bitmap();
+  for (uint8_t y = 0; y < LINES; y++, bp += WIDTH) {
+    if ((dirty & (1 << y)) == 0) continue;
+    m_io->begin();
+    asserted(m_dc) {
+      m_io->write(SET_X_ADDR);
+      m_io->write(0);
+      m_io->write(SET_Y_ADDR | y);
+    }
+    m_io->write(bp, WIDTH);
+    m_io->end();
+  }
+  return (0);
 }
 
 bool
@@ -168,11 +224,11 @@ ST7565::draw_icon(const uint8_t* bp)
   uint8_t height = pgm_read_byte(bp++);
   uint8_t lines = (height >> 3);
   for (uint8_t y = 0; y < lines; y++) {
-    m_io->begin();
+    data_begin();
     for (uint8_t x = 0; x < width; x++) {
-      m_io->write(m_mode ^ pgm_read_byte(bp++));
+      data(m_mode ^ pgm_read_byte(bp++));
     }
-    m_io->end();
+    data_end();
     set_cursor(m_x, m_y + 1);
   }
   set_cursor(m_x, m_y + 1);
@@ -183,11 +239,11 @@ ST7565::draw_bitmap(uint8_t* bp, uint8_t width, uint8_t height)
 {
   uint8_t lines = (height >> 3);
   for (uint8_t y = 0; y < lines; y++) {
-    m_io->begin();
+    data_begin();
     for (uint8_t x = 0; x < width; x++) {
-      m_io->write(m_mode ^ (*bp++));
+      data(m_mode ^ (*bp++));
     }
-    m_io->end();
+    data_end();
     set_cursor(m_x, m_y + 1);
   }
   set_cursor(m_x, m_y + 1);
@@ -200,20 +256,20 @@ ST7565::draw_bar(uint8_t percent, uint8_t width, uint8_t pattern)
   uint8_t filled = (percent * (width - 2U)) / 100;
   uint8_t boarder = (m_y == 0 ? 0x81 : 0x80);
   width -= (filled + 1);
-  m_io->begin();
-  m_io->write(m_mode ^ 0xff);
+  data_begin();
+  data(m_mode ^ 0xff);
   while (filled--) {
-    m_io->write(m_mode ^ (pattern | boarder));
+    data(m_mode ^ (pattern | boarder));
     pattern = ~pattern;
   }
-  m_io->write(m_mode ^ 0xff);
+  data(m_mode ^ 0xff);
   width -= 1;
   if (width > 0) {
     while (width--)
-      m_io->write(m_mode ^ boarder);
+      data(m_mode ^ boarder);
   }
-  m_io->write(m_mode ^ 0xff);
-  m_io->end();
+  data(m_mode ^ 0xff);
+  data_end();
 }
 
 int
@@ -286,11 +342,11 @@ ST7565::putchar(char c)
     putchar('\n');
     m_x = width;
   }
-  m_io->begin();
+  data_begin();
   while (--width)
-    m_io->write(m_mode ^ glyph.next());
-  m_io->write(m_mode);
-  m_io->end();
+    data(m_mode ^ glyph.next());
+  data(m_mode);
+  data_end();
 
   return (c & 0xff);
 }
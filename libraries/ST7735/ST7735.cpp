@@ -93,6 +93,13 @@ ST7735::ST7735(Board::DigitalPin cs, Board::DigitalPin dc) :
 {
 }
 
+#if !defined(BOARD_ATTINY)
+ST7735::ST7735(GDDRAM::IO* io, Board::DigitalPin cs, Board::DigitalPin dc) :
+  GDDRAM(SCREEN_WIDTH, SCREEN_HEIGHT, io, cs, dc)
+{
+}
+#endif
+
 uint8_t
 ST7735::set_orientation(uint8_t direction)
 {
@@ -108,10 +115,8 @@ ST7735::set_orientation(uint8_t direction)
   else {
     setting = (MADCTL_MX | MADCTL_MY);
   }
-  spi.acquire(this);
-    spi.begin();
-      write(MADCTL, setting);
-    spi.end();
-  spi.release();
+  select();
+    write(MADCTL, setting);
+  deselect();
   return (previous);
 }
@@ -23,11 +23,14 @@
 
 #include "Cosa/LCD.hh"
 #include <HD44780.h>
+#include <Canvas.h>
 
 /**
  * ST7920 LCD controller/driver. Binding to trace, etc. Supports simple text
  * scroll, cursor, and handling of special characters such as carriage-
  * return, form-feed, back-space, horizontal tab and new-line.
+ * Graphics may be performed with ST7920::Graphics; a canvas with a
+ * frame buffer that is written to the graphic display memory (GDRAM).
  *
  * @section Circuit
  * Circuit when using HD44780::Port4b and ignoring back-light control (BT).
@@ -73,6 +76,149 @@ public:
     m_offset = offset2;
   }
 
+  /**
+   * Graphics mode canvas for ST7920 128x64 display. Drawing is
+   * performed in a frame buffer (1 Kbyte) with the graphic display
+   * memory layout and changed rows are tracked. flush() writes the
+   * changed rows to the display; one address setting and data burst
+   * (horizontal address auto-increment) per display memory row. The
+   * upper and lower half of the display share the vertical address
+   * and both are written in a single burst when changed. The graphics
+   * are shown together with the text.
+   *
+   * @section Usage
+   * @code
+   * ST7920 lcd(&port);
+   * ST7920::Graphics canvas(&lcd);
+   * ...
+   * lcd.begin();
+   * canvas.begin();
+   * canvas.draw_circle(64, 32, 20);
+   * canvas.flush();
+   * @endcode
+   */
+  class Graphics : public Canvas {
+  public:
+    /** Display size in pixels. */
+    static const uint8_t SCREEN_WIDTH = 128;
+    static const uint8_t SCREEN_HEIGHT = 64;
+
+    /**
+     * Construct graphics canvas for given display.
+     * @param[in] lcd display.
+     */
+    Graphics(ST7920* lcd);
+
+    /**
+     * @override{Canvas}
+     * Turn on the graphic display and clear the frame buffer. The
+     * display should be started with begin() first. Call flush() to
+     * write the frame buffer to the display.
+     * @return true(1) if successful otherwise false(0).
+     */
+    virtual bool begin();
+
+    /**
+     * @override{Canvas}
+     * Set pixel according to the current pen color.
+     * @param[in] x.
+     * @param[in] y.
+     */
+    virtual void draw_pixel(uint16_t x, uint16_t y);
+
+    /**
+     * @override{Canvas}
+     * Draw horizontal line with the current pen color. The frame
+     * buffer is updated a byte (eight pixels) at a time.
+     * @param[in] x.
+     * @param[in] y.
+     * @param[in] length.
+     */
+    virtual void draw_horizontal_line(uint16_t x, uint16_t y,
+				      uint16_t length);
+
+    /**
+     * @override{Canvas}
+     * Fill frame buffer with canvas background color.
+     */
+    virtual void fill_screen();
+
+    /**
+     * Write the changed rows of the frame buffer to the display.
+     */
+    void flush();
+
+    /**
+     * @override{Canvas}
+     * Turn off the graphic display.
+     * @return true(1) if successful otherwise false(0).
+     */
+    virtual bool end();
+
+  protected:
+    /** Number of bytes per pixel row. */
+    static const uint8_t ROW_BYTES = SCREEN_WIDTH / CHARBITS;
+
+    /** Number of display memory rows (vertical addresses). */
+    static const uint8_t ROWS = SCREEN_HEIGHT / 2;
+
+    /** Frame buffer size in bytes. */
+    static const uint16_t COUNT = SCREEN_HEIGHT * ROW_BYTES;
+
+    /** Display. */
+    ST7920* m_lcd;
+
+    /** Frame buffer; display memory row order. */
+    uint8_t m_bitmap[COUNT];
+
+    /** Changed pixel rows in frame buffer; bitset. */
+    uint8_t m_dirty[SCREEN_HEIGHT / CHARBITS];
+
+    /**
+     * Return frame buffer index of given pixel. The lower half of the
+     * display follows the upper half in the display memory row.
+     * @param[in] x.
+     * @param[in] y.
+     * @return index.
+     */
+    static uint16_t index(uint8_t x, uint8_t y)
+    {
+      return (((y & (ROWS - 1)) * (2 * ROW_BYTES))
+	      + ((y & ROWS) ? ROW_BYTES : 0)
+	      + (x >> 3));
+    }
+
+    /**
+     * Mark given pixel row as changed.
+     * @param[in] y.
+     */
+    void mark(uint8_t y)
+    {
+      m_dirty[y >> 3] |= _BV(y & 0x07);
+    }
+
+    /**
+     * Return true(1) if the given pixel row has changed otherwise
+     * false(0).
+     * @param[in] y.
+     * @return bool.
+     */
+    bool is_dirty(uint8_t y) const
+    {
+      return ((m_dirty[y >> 3] & _BV(y & 0x07)) != 0);
+    }
+  };
+
+protected:
+  /**
+   * Extended instruction set (table 6, pp. 17).
+   */
+  enum {
+    GRAPHIC_ON = 0x02,		//!< Function set; graphic display on.
+    SET_GDRAM_ADDR = 0x80,	//!< Set graphic display address.
+    SET_GDRAM_MASK = 0x3f	//!< - mask address.
+  } __attribute__((packed));
+
 private:
   /** Row offset tables for display dimensions (16X4). */
   static const uint8_t offset2[] PROGMEM;
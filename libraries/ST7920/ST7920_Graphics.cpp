@@ -0,0 +1,126 @@
+/**
+ * @file ST7920_Graphics.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "ST7920.hh"
+
+ST7920::Graphics::Graphics(ST7920* lcd) :
+  Canvas(SCREEN_WIDTH, SCREEN_HEIGHT),
+  m_lcd(lcd)
+{
+  memset(m_dirty, 0, sizeof(m_dirty));
+}
+
+bool
+ST7920::Graphics::begin()
+{
+  // Select extended instruction set before turning on graphic display
+  HD44780::IO* io = m_lcd->m_io;
+  io->write8b(m_lcd->m_func | EXTENDED_SET);
+  io->write8b(m_lcd->m_func | EXTENDED_SET | GRAPHIC_ON);
+  io->write8b(m_lcd->m_func);
+  fill_screen();
+  return (true);
+}
+
+void
+ST7920::Graphics::draw_pixel(uint16_t x, uint16_t y)
+{
+  if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT))) return;
+  uint8_t* bp = &m_bitmap[index(x, y)];
+  uint8_t mask = (0x80 >> (x & 0x07));
+  uint8_t data;
+  if (get_pen_color().rgb == Canvas::BLACK)
+    data = *bp | mask;
+  else
+    data = *bp & ~mask;
+  if (data == *bp) return;
+  *bp = data;
+  mark(y);
+}
+
+void
+ST7920::Graphics::draw_horizontal_line(uint16_t x, uint16_t y,
+				       uint16_t length)
+{
+  if (UNLIKELY((x >= WIDTH) || (y >= HEIGHT) || (length == 0))) return;
+  if ((x + length) > WIDTH) length = WIDTH - x;
+  bool black = (get_pen_color().rgb == Canvas::BLACK);
+  uint8_t* bp = &m_bitmap[index(x, y)];
+
+  // Update the frame buffer a byte at a time; partial first and last
+  while (length != 0) {
+    uint8_t pos = (x & 0x07);
+    uint8_t count = CHARBITS - pos;
+    if (count > length) count = length;
+    uint8_t mask = (0xff >> pos) & ~(0xff >> (pos + count));
+    if (black) *bp++ |= mask; else *bp++ &= ~mask;
+    x += count;
+    length -= count;
+  }
+  mark(y);
+}
+
+void
+ST7920::Graphics::fill_screen()
+{
+  memset(m_bitmap, (get_canvas_color().rgb == Canvas::BLACK) ? 0xff : 0, COUNT);
+  memset(m_dirty, 0xff, sizeof(m_dirty));
+}
+
+void
+ST7920::Graphics::flush()
+{
+  HD44780::IO* io = m_lcd->m_io;
+  bool extended = false;
+
+  // Write changed display memory rows; upper and/or lower half
+  for (uint8_t row = 0; row < ROWS; row++) {
+    bool upper = is_dirty(row);
+    bool lower = is_dirty(row + ROWS);
+    if (!upper && !lower) continue;
+    if (!extended) {
+      io->write8b(m_lcd->m_func | EXTENDED_SET | GRAPHIC_ON);
+      extended = true;
+    }
+    const uint8_t* bp = &m_bitmap[row * (2 * ROW_BYTES)];
+    uint8_t size = ROW_BYTES;
+    uint8_t addr = 0;
+    if (upper && lower) size = 2 * ROW_BYTES;
+    else if (lower) {
+      bp += ROW_BYTES;
+      addr = ROW_BYTES / 2;
+    }
+    io->write8b(SET_GDRAM_ADDR | row);
+    io->write8n(SET_GDRAM_ADDR | addr, bp, size);
+  }
+  memset(m_dirty, 0, sizeof(m_dirty));
+
+  // Return to basic instruction set for text mode
+  if (extended) io->write8b(m_lcd->m_func);
+}
+
+bool
+ST7920::Graphics::end()
+{
+  HD44780::IO* io = m_lcd->m_io;
+  io->write8b(m_lcd->m_func | EXTENDED_SET);
+  io->write8b(m_lcd->m_func);
+  return (true);
+}
@@ -0,0 +1,73 @@
+/**
+ * @file CosaST7920Graphics.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of the ST7920 graphics mode canvas; scrolling graph
+ * of analog samples (A0) with text title. Only the changed rows of
+ * the frame buffer are written to the display.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <HD44780.h>
+#include <ST7920.h>
+#include <Canvas.h>
+
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/RTT.hh"
+#include "Cosa/Trace.hh"
+
+HD44780::Port4b port;
+ST7920 lcd(&port);
+ST7920::Graphics canvas(&lcd);
+
+// Graph area below the first text line
+static const uint8_t GRAPH_X = 1;
+static const uint8_t GRAPH_Y = 17;
+static const uint8_t GRAPH_WIDTH = 126;
+static const uint8_t GRAPH_HEIGHT = 46;
+uint8_t x = 0;
+
+void setup()
+{
+  RTT::begin();
+  lcd.begin();
+  trace.begin(&lcd);
+  canvas.begin();
+  canvas.draw_rect(GRAPH_X - 1, GRAPH_Y - 1, GRAPH_WIDTH + 1, GRAPH_HEIGHT + 1);
+  canvas.flush();
+}
+
+void loop()
+{
+  // Erase the oldest column and plot a new sample
+  uint16_t value = AnalogPin::sample(Board::A0);
+  uint8_t y = (value * (GRAPH_HEIGHT - 1UL)) / 1023;
+  canvas.set_pen_color(Canvas::WHITE);
+  canvas.draw_vertical_line(GRAPH_X + x, GRAPH_Y, GRAPH_HEIGHT - 1);
+  canvas.set_pen_color(Canvas::BLACK);
+  canvas.draw_pixel(GRAPH_X + x, GRAPH_Y + (GRAPH_HEIGHT - 1) - y);
+  if (++x == GRAPH_WIDTH) x = 0;
+
+  // Write the changed rows and measure the update time
+  uint32_t start = RTT::micros();
+  canvas.flush();
+  uint32_t us = RTT::micros() - start;
+  lcd.set_cursor(0, 0);
+  trace << value << ':' << us << PSTR(" us    ");
+  delay(100);
+}
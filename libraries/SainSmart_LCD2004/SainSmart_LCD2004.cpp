@@ -43,16 +43,7 @@ void
 SainSmart_LCD2004::write8b(uint8_t data)
 {
   uint8_t buf[4];
-  m_port.data = (data >> 4);
-  m_port.en = 1;
-  buf[0] = m_port;
-  m_port.en = 0;
-  buf[1] = m_port;
-  m_port.data = data;
-  m_port.en = 1;
-  buf[2] = m_port.as_uint8;
-  m_port.en = 0;
-  buf[3] = m_port.as_uint8;
+  encode(buf, data);
   write(buf, sizeof(buf));
 }
 
@@ -63,25 +54,32 @@ SainSmart_LCD2004::write8n(const void* buf, size_t size)
   while (size != 0) {
     uint8_t tmp[TMP_MAX];
     uint8_t n = (size > sizeof(tmp) / 4 ? sizeof(tmp) / 4 : size);
+    uint8_t* dp = tmp;
     size -= n;
-    uint8_t m = n * 4;
-    for (uint8_t i = 0; i < m;) {
-      uint8_t data = *bp++;
-      m_port.data = (data >> 4);
-      m_port.en = 1;
-      tmp[i++] = m_port;
-      m_port.en = 0;
-      tmp[i++] = m_port;
-      m_port.data = data;
-      m_port.en = 1;
-      tmp[i++] = m_port;
-      m_port.en = 0;
-      tmp[i++] = m_port;
-    }
-    write(tmp, m);
+    while (n--) dp = encode(dp, *bp++);
+    write(tmp, dp - tmp);
   }
 }
 
+void
+SainSmart_LCD2004::write8n(uint8_t cmd, const void* buf, size_t size)
+{
+  // Encode the instruction and the first characters in one message
+  const uint8_t* bp = (const uint8_t*) buf;
+  uint8_t tmp[TMP_MAX];
+  uint8_t* dp = encode(tmp, cmd);
+  m_port.rs = 1;
+  do {
+    uint8_t n = (sizeof(tmp) - (dp - tmp)) / 4;
+    if (n > size) n = size;
+    size -= n;
+    while (n--) dp = encode(dp, *bp++);
+    write(tmp, dp - tmp);
+    dp = tmp;
+  } while (size != 0);
+  m_port.rs = 0;
+}
+
 void
 SainSmart_LCD2004::set_mode(uint8_t flag)
 {
@@ -82,6 +82,17 @@ public:
    */
   virtual void write8n(const void* buf, size_t size);
 
+  /**
+   * @override{HD44780::IO}
+   * Write instruction followed by character buffer to display. The
+   * instruction and up to a line of characters are sent as a single
+   * TWI message.
+   * @param[in] cmd instruction.
+   * @param[in] buf pointer to buffer.
+   * @param[in] size number of bytes in buffer.
+   */
+  virtual void write8n(uint8_t cmd, const void* buf, size_t size);
+
   /**
    * @override{HD44780::IO}
    * Set instruction/data mode; zero for instruction,
@@ -98,8 +109,11 @@ public:
   virtual void set_backlight(uint8_t flag);
 
 protected:
-  /** Max size of temporary buffer for TWI message. */
-  static const uint8_t TMP_MAX = 32;
+  /**
+   * Max size of temporary buffer for TWI message; instruction and a
+   * line of 20 characters (4 encoded bytes each).
+   */
+  static const uint8_t TMP_MAX = 84;
 
   /** Expander port bit fields; little endian. */
   union port_t {
@@ -121,6 +135,28 @@ protected:
     }
   };
   port_t m_port;		//!< Port setting.
+
+  /**
+   * Encode given byte as two nibbles with enable pulse in given
+   * buffer. Return pointer to next position in buffer.
+   * @param[in] dp buffer pointer.
+   * @param[in] data to encode.
+   * @return buffer pointer.
+   */
+  uint8_t* encode(uint8_t* dp, uint8_t data)
+  {
+    m_port.data = (data >> 4);
+    m_port.en = 1;
+    *dp++ = m_port;
+    m_port.en = 0;
+    *dp++ = m_port;
+    m_port.data = data;
+    m_port.en = 1;
+    *dp++ = m_port;
+    m_port.en = 0;
+    *dp++ = m_port;
+    return (dp);
+  }
 };
 
 #endif
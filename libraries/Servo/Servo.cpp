@@ -22,62 +22,133 @@
 #if !defined(BOARD_ATTINYX5)
 #include "Servo.hh"
 
-Servo* Servo::servo[2] = { 0, 0 };
+Servo* Servo::servo[Servo::CHANNEL_MAX] = { 0 };
+Servo::slot_t Servo::s_slot[2][Servo::CHANNEL_MAX];
+uint8_t Servo::s_count[2] = { 0, 0 };
+volatile uint8_t Servo::s_active = 0;
+volatile bool Servo::s_pending = false;
+bool Servo::s_hold = false;
+uint8_t Servo::s_next = 0;
+uint16_t Servo::s_start = 0;
 
-#define US_TO_TICKS(us) ((I_CPU * (us)) / 8)
+#define US_TO_TICKS(us) ((uint16_t) ((I_CPU * (uint32_t) (us)) / 8))
+
+// Turn off pulses within this number of ticks in the same interrupt
+static const uint16_t GUARD_TICKS = US_TO_TICKS(8);
 
 bool
 Servo::begin()
 {
-  TCCR1A = 0;
-  TCCR1B = _BV(CS11);
-  TCNT1 = 0;
-  TIMSK1 |= _BV(OCIE1A);
-  TIMSK1 |= _BV(OCIE1B);
-  OCR1A = TCNT1 + PERIOD;
-  OCR1B = TCNT1 + PERIOD;
+  commit();
+  synchronized {
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    TCNT1 = 0;
+    OCR1A = US_TO_TICKS(100);
+    TIFR1 = _BV(OCF1A) | _BV(OCF1B);
+    TIMSK1 |= _BV(OCIE1A);
+  }
   return (true);
 }
 
 bool
 Servo::end()
 {
-  TIMSK1 &= ~_BV(OCIE1A);
-  TIMSK1 &= ~_BV(OCIE1B);
+  synchronized {
+    TIMSK1 &= ~(_BV(OCIE1A) | _BV(OCIE1B));
+    for (uint8_t ix = 0; ix < CHANNEL_MAX; ix++)
+      if (servo[ix] != NULL) servo[ix]->OutputPin::clear();
+  }
   return (true);
 }
 
+void
+Servo::commit()
+{
+  // Retract pending schedule; the inactive schedule is then not used
+  // by the interrupt handler
+  synchronized s_pending = false;
+  uint8_t buf = s_active ^ 1;
+  slot_t* slot = s_slot[buf];
+  uint8_t count = 0;
+
+  // Insertion sort of channels on pulse width
+  for (uint8_t ix = 0; ix < CHANNEL_MAX; ix++) {
+    Servo* s = servo[ix];
+    if (s == NULL) continue;
+    uint16_t ticks = US_TO_TICKS(s->m_width);
+    uint8_t i = count++;
+    while (i > 0 && slot[i - 1].ticks > ticks) {
+      slot[i] = slot[i - 1];
+      i -= 1;
+    }
+    slot[i].ticks = ticks;
+    slot[i].servo = s;
+  }
+  s_count[buf] = count;
+
+  // Publish for next frame start
+  s_hold = false;
+  synchronized s_pending = true;
+}
+
 void
 Servo::angle(uint8_t degree)
 {
   if (UNLIKELY(degree > 180)) degree = 180;
   uint16_t width = (((uint32_t) (m_max - m_min)) * degree) / 180L;
-  synchronized {
-    m_width = m_min + width;
-    m_angle = degree;
-  }
+  m_width = m_min + width;
+  m_angle = degree;
+  if (!s_hold) commit();
 }
 
+/*
+ * Frame start; swap to committed schedule, start all pulses and the
+ * compare chain for the first pulse end.
+ */
 ISR(TIMER1_COMPA_vect)
 {
-  Servo* servo = Servo::servo[0];
-  if (UNLIKELY(servo == NULL)) return;
-  servo->toggle();
-  if (servo->is_set())
-    OCR1A = TCNT1 + US_TO_TICKS(servo->m_width);
-  else
-    OCR1A = TCNT1 + US_TO_TICKS(Servo::PERIOD - servo->m_width);
+  Servo::s_start = OCR1A;
+  OCR1A = Servo::s_start + US_TO_TICKS(Servo::PERIOD);
+  if (Servo::s_pending) {
+    Servo::s_active ^= 1;
+    Servo::s_pending = false;
+  }
+  uint8_t active = Servo::s_active;
+  uint8_t count = Servo::s_count[active];
+  if (UNLIKELY(count == 0)) return;
+  const Servo::slot_t* slot = Servo::s_slot[active];
+  for (uint8_t ix = 0; ix < count; ix++) slot[ix].servo->OutputPin::set();
+  Servo::s_next = 0;
+  OCR1B = Servo::s_start + slot[0].ticks;
+  TIFR1 = _BV(OCF1B);
+  TIMSK1 |= _BV(OCIE1B);
 }
 
+/*
+ * Pulse end; turn off all channels that are due (within guard time)
+ * and schedule the next pulse end. The chain is stopped after the
+ * last channel.
+ */
 ISR(TIMER1_COMPB_vect)
 {
-  Servo* servo = Servo::servo[1];
-  if (UNLIKELY(servo == NULL)) return;
-  servo->toggle();
-  if (servo->is_set())
-    OCR1B = TCNT1 + US_TO_TICKS(servo->m_width);
-  else
-    OCR1B = TCNT1 + US_TO_TICKS(Servo::PERIOD - servo->m_width);
+  uint8_t active = Servo::s_active;
+  uint8_t count = Servo::s_count[active];
+  const Servo::slot_t* slot = Servo::s_slot[active];
+  uint8_t next = Servo::s_next;
+  do {
+    slot[next++].servo->OutputPin::clear();
+    if (next == count) {
+      TIMSK1 &= ~_BV(OCIE1B);
+      break;
+    }
+    uint16_t at = Servo::s_start + slot[next].ticks;
+    if ((int16_t) (at - TCNT1) > (int16_t) GUARD_TICKS) {
+      OCR1B = at;
+      break;
+    }
+  } while (1);
+  Servo::s_next = next;
 }
 
 #endif
@@ -24,19 +24,43 @@
 #include "Cosa/Types.h"
 #include "Cosa/OutputPin.hh"
 
+/**
+ * Max number of servo channels. Default is 8 channels.
+ */
+#ifndef COSA_SERVO_CHANNEL_MAX
+#define COSA_SERVO_CHANNEL_MAX 8
+#endif
+
 /**
  * Servo motor driver. Uses Timer#1 and the two compare output
- * registers.
+ * registers. All channels are started together at the beginning of
+ * each 20 ms frame (compare A interrupt) and a single compare chain
+ * (compare B interrupt) turns them off in order of pulse width. The
+ * number of interrupts per frame is the number of channels plus one,
+ * and channels with the same width are turned off in the same
+ * interrupt. The pulse schedule is sorted outside the interrupt
+ * handler and committed at the next frame start. Several channels
+ * may be updated atomically with hold() and commit().
+ * @code
+ * Servo::hold();
+ * pan.angle(45);
+ * tilt.angle(120);
+ * Servo::commit();
+ * @endcode
  *
  * @section Limitations
  * Cannot be used together with other classes that use Timer#1.
+ * Max COSA_SERVO_CHANNEL_MAX channels.
  */
 class Servo : private OutputPin {
 public:
+  /** Max number of channels. */
+  static const uint8_t CHANNEL_MAX = COSA_SERVO_CHANNEL_MAX;
+
   /**
    * Construct a servo instance connected to the given pin.
    * Default angle is 90 degree.
-   * @param[in] ix index of servo [0..1].
+   * @param[in] ix index of servo [0..CHANNEL_MAX-1].
    * @param[in] pin digital pin to use as servo control output pin.
    */
   Servo(uint8_t ix, Board::DigitalPin pin) :
@@ -44,8 +68,8 @@ public:
     m_min(MIN_WIDTH),
     m_max(MAX_WIDTH)
   {
+    if (ix < CHANNEL_MAX) servo[ix] = this;
     angle(INIT_ANGLE);
-    servo[ix != 0] = this;
   }
 
   /**
@@ -58,6 +82,22 @@ public:
    */
   static bool end();
 
+  /**
+   * Hold updates of the pulse schedule. New positions are collected
+   * until commit().
+   */
+  static void hold()
+  {
+    s_hold = true;
+  }
+
+  /**
+   * Sort the pulse widths of all channels and commit the schedule.
+   * The new positions take effect together at the next frame start.
+   * Releases hold().
+   */
+  static void commit();
+
   /**
    * Set pulse limits; min and max number of micro seconds.
    * These will correspond to angle 0 and 180.
@@ -81,7 +121,8 @@ public:
   }
 
   /**
-   * Set servo to given angle degree.
+   * Set servo to given angle degree. Committed directly unless
+   * updates are on hold().
    * @param[in] degree angle, 0..180.
    */
   void angle(uint8_t degree);
@@ -103,7 +144,34 @@ private:
   static const uint8_t INIT_ANGLE = 90;
 
   /** Servo map. */
-  static Servo* servo[2];
+  static Servo* servo[CHANNEL_MAX];
+
+  /** Pulse schedule entry; end of pulse (timer ticks) and servo. */
+  struct slot_t {
+    uint16_t ticks;
+    Servo* servo;
+  };
+
+  /** Double buffered pulse schedules, sorted on ticks. */
+  static slot_t s_slot[2][CHANNEL_MAX];
+
+  /** Number of channels in schedules. */
+  static uint8_t s_count[2];
+
+  /** Index of schedule used by interrupt handlers. */
+  static volatile uint8_t s_active;
+
+  /** Committed schedule pending for next frame. */
+  static volatile bool s_pending;
+
+  /** Schedule updates on hold. */
+  static bool s_hold;
+
+  /** Next schedule entry to turn off. */
+  static uint8_t s_next;
+
+  /** Timer count at frame start. */
+  static uint16_t s_start;
 
   /**
    * Servo state; Min/Max/Width of pulse, angle.
@@ -16,7 +16,8 @@
  * Lesser General Public License for more details.
  *
  * @section Description
- * Demonstration of the Servo control class.
+ * Demonstration of the Servo control class. The servos are updated
+ * together with hold() and commit().
  *
  * @section Circuit
  * @code
@@ -61,16 +62,20 @@ void loop()
 
   // Step servo from 10 to 170 degrees by 45 degrees
   for (; degree < 170; degree += inc) {
+    Servo::hold();
     door.angle(degree);
     servo.angle(degree);
+    Servo::commit();
     delay(512);
   }
   if (degree > 170) degree -= inc;
 
   // Step servo from 170 to 10 degrees by -45 degrees
   for (; degree > 10; degree -= inc) {
+    Servo::hold();
     door.angle(degree);
     servo.angle(degree);
+    Servo::commit();
     delay(512);
   }
   if (degree < 10) degree += inc;
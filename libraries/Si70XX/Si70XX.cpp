@@ -19,17 +19,8 @@
  */
 
 #include "Si70XX.hh"
-
-static uint8_t crc_update(uint8_t crc, uint8_t data)
-{
-  crc ^= data;
-  for (uint8_t i = CHARBITS; i != 0; i--) {
-    uint8_t msb = (crc & 0x80);
-    crc <<= 1;
-    if (msb) crc ^= 0x31;
-  }
-  return (crc);
-}
+#include "Cosa/CRC.hh"
+#include "Cosa/Fixed.hh"
 
 bool
 Si70XX::issue(uint8_t cmd)
@@ -59,10 +50,7 @@ Si70XX::read(uint16_t& value, bool check)
   }
   if (count != size) return (false);
   if (check) {
-    uint8_t crc;
-    crc = crc_update(0, buf[0]);
-    crc = crc_update(crc, buf[1]);
-    if (crc != buf[2]) return (false);
+    if (CRC::crc8(buf, 2) != buf[2]) return (false);
   }
   value = ((buf[0] << 8) | buf[1]);
   return (true);
@@ -103,7 +91,7 @@ Si70XX::read_electronic_serial_number(uint8_t snr[8])
   crc = 0;
   j = 0;
   for (size_t i = 0; i < sizeof(sna);) {
-    crc = crc_update(crc, sna[i]);
+    crc = CRC::crc8_update(crc, sna[i]);
     snr[j++] = sna[i++];
     if (sna[i++] != crc) goto err;
   }
@@ -116,9 +104,9 @@ Si70XX::read_electronic_serial_number(uint8_t snr[8])
   if (count != sizeof(snb)) goto err;
   crc = 0;
   for (size_t i = 0; i < sizeof(snb); ) {
-    crc = crc_update(crc, snb[i]);
+    crc = CRC::crc8_update(crc, snb[i]);
     snr[j++] = snb[i++];
-    crc = crc_update(crc, snb[i]);
+    crc = CRC::crc8_update(crc, snb[i]);
     snr[j++] = snb[i++];
     if (snb[i++] != crc) goto err;
   }
@@ -143,3 +131,44 @@ Si70XX::read_firmware_revision(uint8_t &rev)
   return (count == sizeof(rev));
 }
 
+bool
+Si70XX::sample_request()
+{
+  // Check that a request is not in progress
+  if (UNLIKELY(m_busy)) return (false);
+  if (!issue(MEASURE_RH_NO_HOLD)) return (false);
+  m_busy = true;
+
+  // Read result directly (retry) without scheduler
+  if (!m_conversion.is_scheduled()) {
+    sample_completed();
+    return (true);
+  }
+
+  // Time the conversion
+  m_conversion.expire_at(m_conversion.time() + CONV_MS);
+  m_conversion.start();
+  return (true);
+}
+
+void
+Si70XX::sample_completed()
+{
+  uint16_t rh;
+  uint16_t temp;
+  bool valid = false;
+
+  // Read humidity and temperature from humidity measurement
+  m_busy = false;
+  if (read(rh) && issue(READ_RH_TEMP) && read(temp, false)) {
+    // Fixed-point conversion; RH = 125 * value / 65536 - 6 and
+    // T = 175.72 * value / 65536 - 46.85, in steps of 0.1
+    int16_t humidity = Fixed::umulhi(rh, 1250) - 60;
+    if (humidity < 0) humidity = 0;
+    else if (humidity > 1000) humidity = 1000;
+    m_humidity = humidity;
+    m_temperature = Fixed::umulhi(temp, 1757) - 469;
+    valid = true;
+  }
+  on_sample_completed(valid);
+}
@@ -22,12 +22,17 @@
 #define COSA_Si70XX_HH
 
 #include "Cosa/TWI.hh"
+#include "Cosa/Job.hh"
 #include <math.h>
 
 /**
  * Cosa TWI driver for Silicon Labs, Si70XX I2C Humidity and
  * Temperature Sensor. The device driver does not block on
- * measurements.
+ * measurements. With a job scheduler (milli-second time base,
+ * e.g. Watchdog::Scheduler) sample_request() issues a humidity
+ * measurement and the result is read when the conversion time has
+ * expired; humidity and temperature are delivered in fixed-point
+ * with on_sample_completed() from the event handler.
  *
  * @section Circuit
  * The GY-21 module with pull-up resistors for TWI signals and 3V3
@@ -49,9 +54,18 @@
 class Si70XX : private TWI::Driver {
 public:
   /**
-   * Create device driver instance.
+   * Create device driver instance. The conversion of
+   * sample_request() is timed with the given job scheduler
+   * (milli-seconds) if given otherwise with a blocking read.
+   * @param[in] scheduler for conversion time (Default NULL).
    */
-  Si70XX() : TWI::Driver(0x40) {}
+  Si70XX(Job::Scheduler* scheduler = NULL) :
+    TWI::Driver(0x40),
+    m_conversion(scheduler, this),
+    m_busy(false),
+    m_humidity(0),
+    m_temperature(0)
+  {}
 
   /**
    * Read configuration register, Return true(1) if successful
@@ -98,7 +112,7 @@ public:
   float read_humidity()
   {
     uint16_t value;
-    if (!read(value)) (NAN);
+    if (!read(value)) return (NAN);
     return (((125.00 * value) / 65536) - 6.00);
   }
 
@@ -138,7 +152,115 @@ public:
     return (((175.72 * value) / 65536) - 46.85);
   }
 
+  /**
+   * Initiate an asynchronous humidity and temperature sample
+   * request. Returns immediately when a job scheduler is used. The
+   * result is delivered with on_sample_completed(). Return true(1) if
+   * successful otherwise false(0), e.g. a request is already in
+   * progress.
+   * @return bool.
+   */
+  bool sample_request();
+
+  /**
+   * Return true(1) if a sample request is in progress otherwise
+   * false(0).
+   * @return bool.
+   */
+  bool is_busy() const
+  {
+    return (m_busy);
+  }
+
+  /**
+   * Return relative humidity from latest sample request.
+   * @return humidity in steps of 0.1 % RH.
+   */
+  int16_t humidity() const
+  {
+    return (m_humidity);
+  }
+
+  /**
+   * Return temperature from latest sample request.
+   * @return temperature in steps of 0.1 C.
+   */
+  int16_t temperature() const
+  {
+    return (m_temperature);
+  }
+
 protected:
+  /** Humidity and temperature conversion time max (ms). */
+  static const uint8_t CONV_MS = 23;
+
+  /**
+   * Conversion timer; reads the result of the sample request when
+   * the conversion time has expired. Run from the event handler.
+   */
+  class Conversion : public Job {
+  public:
+    /**
+     * Construct conversion timer for given device.
+     * @param[in] scheduler for conversion time.
+     * @param[in] dev device.
+     */
+    Conversion(Job::Scheduler* scheduler, Si70XX* dev) :
+      Job(scheduler),
+      m_dev(dev)
+    {}
+
+    /**
+     * Return true(1) if there is a scheduler otherwise false(0).
+     * @return bool.
+     */
+    bool is_scheduled() const
+    {
+      return (m_scheduler != NULL);
+    }
+
+    /**
+     * @override{Job}
+     * Read the result of the sample request.
+     */
+    virtual void run()
+    {
+      m_dev->sample_completed();
+    }
+
+  protected:
+    Si70XX* m_dev;		//!< Device.
+  };
+
+  /** Conversion timer. */
+  Conversion m_conversion;
+
+  /** Sample request in progress. */
+  bool m_busy;
+
+  /** Latest humidity (0.1 % RH). */
+  int16_t m_humidity;
+
+  /** Latest temperature (0.1 C). */
+  int16_t m_temperature;
+
+  /**
+   * @override{Si70XX}
+   * Called when a sample request has completed; from the event
+   * handler when a job scheduler is used. Default handler is empty.
+   * @param[in] valid humidity and temperature read.
+   */
+  virtual void on_sample_completed(bool valid)
+  {
+    UNUSED(valid);
+  }
+
+  /**
+   * Read humidity and temperature, convert to fixed-point and call
+   * on_sample_completed().
+   */
+  void sample_completed();
+
   /**
    * I2C Command Table (See tab. 11, pp. 19).
    */
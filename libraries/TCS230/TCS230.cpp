@@ -104,3 +104,62 @@ TCS230::IRQPin::on_interrupt(uint16_t arg)
 }
 
 
+
+#if !defined(BOARD_ATTINY)
+// Timer1 clock select; external clock source on T1 rising edge
+#define EXTERNAL_CLOCK (_BV(CS12) | _BV(CS11) | _BV(CS10))
+
+void
+TCS230::Sampler::begin()
+{
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TIMSK1 = 0;
+  m_filter = RED_FILTER;
+  measure();
+}
+
+void
+TCS230::Sampler::end()
+{
+  stop();
+  TCCR1B = 0;
+}
+
+void
+TCS230::Sampler::measure()
+{
+  m_sensor->photodiode((Filter) m_filter);
+  synchronized {
+    TCNT1 = 0;
+    TIFR1 = _BV(TOV1);
+    TCCR1B = EXTERNAL_CLOCK;
+    expire_at(time());
+  }
+  expire_after(m_window);
+  start();
+}
+
+void
+TCS230::Sampler::on_expired()
+{
+  // Stop the counter and check for over-flow
+  TCCR1B = 0;
+  m_count[m_filter] = (TIFR1 & _BV(TOV1)) ? UINT16_MAX : TCNT1;
+  Event::push(Event::TIMEOUT_TYPE, this);
+}
+
+void
+TCS230::Sampler::run()
+{
+  // Measure the next filter or callback at the end of the sequence
+  if (++m_filter <= GREEN_FILTER) {
+    measure();
+    return;
+  }
+  m_filter = RED_FILTER;
+  measure();
+  on_sample(m_count[RED_FILTER], m_count[GREEN_FILTER],
+	    m_count[BLUE_FILTER], m_count[NO_FILTER]);
+}
+#endif
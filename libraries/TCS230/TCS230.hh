@@ -23,6 +23,7 @@
 
 #include "Cosa/OutputPin.hh"
 #include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/Job.hh"
 
 /**
  * Cosa Device Driver for TCS230 Programmable Color Light-to-Frequency
@@ -101,6 +102,114 @@ public:
    */
   uint16_t sample(uint8_t ms = 10);
 
+#if !defined(BOARD_ATTINY)
+  /**
+   * Hardware counter sampler. The device output is connected to the
+   * Timer1 external clock input (T1) and the pulses are counted by
+   * the timer for a window given by a micro-second scheduler
+   * (RTT::Scheduler). There is no interrupt per pulse. The sampler
+   * is a job that sequences the four photodiode filters and calls
+   * on_sample() with the counts when all have been measured. The
+   * sequence is repeated until end().
+   *
+   * @section Circuit
+   * The device output (OUT) should be connected to T1; D5 on
+   * ATmega328, D1 on ATmega1284P and D12 on ATmega32U4 boards. The
+   * scaling option pin S1 must be moved if the default pins are used.
+   *
+   * @section Limitations
+   * Uses Timer1 and cannot be used together with other classes that
+   * use the same timer (e.g. Tone, VWI, InputCapture).
+   */
+  class Sampler : public Job {
+  public:
+    /** Default sample window (us). */
+    static const uint16_t WINDOW_DEFAULT = 10000;
+
+    /**
+     * Construct hardware counter sampler for given device with given
+     * scheduler and sample window.
+     * @param[in] scheduler micro-second job scheduler.
+     * @param[in] sensor device driver; filter selection.
+     * @param[in] window sample time in micro-seconds (default 10 ms).
+     */
+    Sampler(Job::Scheduler* scheduler, TCS230* sensor,
+	    uint16_t window = WINDOW_DEFAULT) :
+      Job(scheduler),
+      m_sensor(sensor),
+      m_window(window),
+      m_filter(RED_FILTER)
+    {
+      memset((void*) m_count, 0, sizeof(m_count));
+    }
+
+    /**
+     * Start the sampling sequence.
+     */
+    void begin();
+
+    /**
+     * Stop the sampling sequence and the counter.
+     */
+    void end();
+
+    /**
+     * Return the latest count for the given photodiode filter or
+     * UINT16_MAX if over-flow.
+     * @param[in] type of color filter.
+     * @return pulses.
+     */
+    uint16_t count(Filter type) const
+    {
+      return (m_count[type]);
+    }
+
+    /**
+     * @override{TCS230::Sampler}
+     * Callback when all filters have been sampled. Default is null
+     * function.
+     * @param[in] red pulses with red filter.
+     * @param[in] green pulses with green filter.
+     * @param[in] blue pulses with blue filter.
+     * @param[in] clear pulses without filter.
+     */
+    virtual void on_sample(uint16_t red, uint16_t green,
+			   uint16_t blue, uint16_t clear)
+    {
+      UNUSED(red);
+      UNUSED(green);
+      UNUSED(blue);
+      UNUSED(clear);
+    }
+
+  protected:
+    TCS230* m_sensor;		//!< Device driver.
+    uint16_t m_window;		//!< Sample window (us).
+    uint8_t m_filter;		//!< Current filter.
+    volatile uint16_t m_count[4]; //!< Latest count per filter.
+
+    /**
+     * Select the current filter, reset and start the counter, and
+     * schedule the end of the sample window.
+     */
+    void measure();
+
+    /**
+     * @override{Job}
+     * Stop the counter and save the count at the end of the window.
+     * Called from the interrupt service routine.
+     */
+    virtual void on_expired();
+
+    /**
+     * @override{Job}
+     * Step to the next filter. Call on_sample() at the end of the
+     * sequence.
+     */
+    virtual void run();
+  };
+#endif
+
 private:
   class IRQPin : public ExternalInterrupt {
   public:
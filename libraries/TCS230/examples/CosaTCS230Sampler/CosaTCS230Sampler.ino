@@ -0,0 +1,74 @@
+/**
+ * @file CosaTCS230Sampler.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Cosa demonstration of the TCS230 hardware counter sampler. The
+ * device output is counted by Timer1 and the filters are sequenced
+ * by a job.
+ *
+ * @section Circuit
+ * @code
+ *                       TCS230 Module
+ *                   P1 +------------+ P2
+ * (D4)---------------1-|S0        S3|-1-----------------(D7)
+ * (D8)---------------2-|S1        S2|-2-----------------(D6)
+ *                    3-|OE       OUT|-3--------------(D5/T1)
+ * (GND)--------------4-|GND      VCC|-4----------------(VCC)
+ *                      +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <TCS230.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/UART.hh"
+#include "Cosa/Trace.hh"
+
+class Sampler : public TCS230::Sampler {
+public:
+  Sampler(Job::Scheduler* scheduler, TCS230* sensor) :
+    TCS230::Sampler(scheduler, sensor)
+  {}
+  virtual void on_sample(uint16_t red, uint16_t green,
+			 uint16_t blue, uint16_t clear)
+  {
+    trace << clear << ':' << red << ',' << green << ',' << blue;
+    if (clear == UINT16_MAX) trace << PSTR(":overflow");
+    trace << endl;
+  }
+};
+
+RTT::Scheduler scheduler;
+TCS230 sensor(Board::EXT1, Board::D4, Board::D8, Board::D6, Board::D7);
+Sampler sampler(&scheduler, &sensor);
+
+void setup()
+{
+  uart.begin(9600);
+  trace.begin(&uart, PSTR("CosaTCS230Sampler: started"));
+  RTT::begin();
+  sensor.frequency_scaling(20);
+  sampler.begin();
+}
+
+void loop()
+{
+  Event::service();
+}
@@ -22,5 +22,6 @@
 #define COSA_TOUCH_H
 
 #include "Touch.hh"
+#include "TouchPanel.hh"
 
 #endif
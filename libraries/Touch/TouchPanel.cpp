@@ -0,0 +1,207 @@
+/**
+ * @file TouchPanel.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "TouchPanel.hh"
+
+TouchPanel::TouchPanel(Job::Scheduler* scheduler,
+		       Board::InterruptPin xp, Board::AnalogPin xa,
+		       Board::DigitalPin xm,
+		       Board::DigitalPin yp, Board::AnalogPin ya,
+		       Board::DigitalPin ym,
+		       uint16_t period) :
+  Periodic(scheduler, period),
+  m_xp(xp, this),
+  m_xa(xa),
+  m_xm(xm, IOPin::INPUT_MODE),
+  m_yp(yp, IOPin::INPUT_MODE),
+  m_ya(ya),
+  m_ym(ym, IOPin::OUTPUT_MODE),
+  m_touched(false)
+{
+  // Default calibration is identity; raw samples
+  m_matrix.a = 0x10000L;
+  m_matrix.b = 0;
+  m_matrix.c = 0;
+  m_matrix.d = 0;
+  m_matrix.e = 0x10000L;
+  m_matrix.f = 0;
+  m_raw.x = 0;
+  m_raw.y = 0;
+}
+
+void
+TouchPanel::begin()
+{
+  m_touched = false;
+  detect();
+  m_xp.enable();
+}
+
+void
+TouchPanel::end()
+{
+  m_xp.disable();
+  stop();
+  m_touched = false;
+}
+
+void
+TouchPanel::PenDown::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+  disable();
+  Event::push(Event::CHANGE_TYPE, m_panel);
+}
+
+bool
+TouchPanel::detect()
+{
+  // Release X- and Y+. Pull Y- low and X+ high. A touch connects
+  // the plates and pulls X+ low
+  m_xm.mode(IOPin::INPUT_MODE);
+  m_xm.clear();
+  m_yp.mode(IOPin::INPUT_MODE);
+  m_yp.clear();
+  m_ym.mode(IOPin::OUTPUT_MODE);
+  m_ym.clear();
+  m_xp.mode(IOPin::INPUT_MODE);
+  m_xp.set();
+  DELAY(10);
+  return (m_xp.is_clear());
+}
+
+uint16_t
+TouchPanel::sample(Board::AnalogPin pin)
+{
+  uint16_t value[SAMPLE_MAX];
+
+  // Discard the first conversion after switching the plates
+  AnalogPin::sample(pin);
+
+  // Insertion sort the conversions and return the median
+  for (uint8_t i = 0; i < SAMPLE_MAX; i++) {
+    uint16_t v = AnalogPin::sample(pin);
+    uint8_t j = i;
+    for (; j > 0 && value[j - 1] > v; j--) value[j] = value[j - 1];
+    value[j] = v;
+  }
+  return (value[SAMPLE_MAX / 2]);
+}
+
+bool
+TouchPanel::sample()
+{
+  // X coordinate; voltage divider over X plate, sense on Y+
+  m_yp.mode(IOPin::INPUT_MODE);
+  m_yp.clear();
+  m_ym.mode(IOPin::INPUT_MODE);
+  m_ym.clear();
+  m_xp.mode(IOPin::OUTPUT_MODE);
+  m_xp.set();
+  m_xm.mode(IOPin::OUTPUT_MODE);
+  m_xm.clear();
+  uint16_t x = sample(m_ya);
+
+  // Y coordinate; voltage divider over Y plate, sense on X+
+  m_xp.mode(IOPin::INPUT_MODE);
+  m_xp.clear();
+  m_xm.mode(IOPin::INPUT_MODE);
+  m_yp.mode(IOPin::OUTPUT_MODE);
+  m_yp.set();
+  m_ym.mode(IOPin::OUTPUT_MODE);
+  m_ym.clear();
+  uint16_t y = sample(m_xa);
+
+  // Discard the sample if the pen was lifted during sampling
+  if (!detect()) return (false);
+  m_raw.x = x;
+  m_raw.y = y;
+  return (true);
+}
+
+bool
+TouchPanel::calibrate(const Point raw[3], const Point screen[3])
+{
+  int32_t x0 = raw[0].x, x1 = raw[1].x, x2 = raw[2].x;
+  int32_t y0 = raw[0].y, y1 = raw[1].y, y2 = raw[2].y;
+  int32_t X0 = screen[0].x, X1 = screen[1].x, X2 = screen[2].x;
+  int32_t Y0 = screen[0].y, Y1 = screen[1].y, Y2 = screen[2].y;
+
+  // Determinant of the raw samples; zero if on a line
+  int64_t div = (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
+  if (UNLIKELY(div == 0)) return (false);
+
+  // Solve the affine transformation and scale to fixed-point (Q16)
+  int64_t n;
+  n = (X0 - X2) * (y1 - y2) - (X1 - X2) * (y0 - y2);
+  m_matrix.a = (n << 16) / div;
+  n = (x0 - x2) * (X1 - X2) - (X0 - X2) * (x1 - x2);
+  m_matrix.b = (n << 16) / div;
+  n = (int64_t) (x2 * X1 - x1 * X2) * y0
+    + (int64_t) (x0 * X2 - x2 * X0) * y1
+    + (int64_t) (x1 * X0 - x0 * X1) * y2;
+  m_matrix.c = (n << 16) / div;
+  n = (Y0 - Y2) * (y1 - y2) - (Y1 - Y2) * (y0 - y2);
+  m_matrix.d = (n << 16) / div;
+  n = (x0 - x2) * (Y1 - Y2) - (Y0 - Y2) * (x1 - x2);
+  m_matrix.e = (n << 16) / div;
+  n = (int64_t) (x2 * Y1 - x1 * Y2) * y0
+    + (int64_t) (x0 * Y2 - x2 * Y0) * y1
+    + (int64_t) (x1 * Y0 - x0 * Y1) * y2;
+  m_matrix.f = (n << 16) / div;
+  return (true);
+}
+
+void
+TouchPanel::on_event(uint8_t type, uint16_t value)
+{
+  UNUSED(value);
+  if (UNLIKELY(type != Event::CHANGE_TYPE && type != Event::TIMEOUT_TYPE))
+    return;
+
+  // Sample while touched; map to screen coordinates and callback
+  if (sample()) {
+    int32_t rx = m_raw.x;
+    int32_t ry = m_raw.y;
+    int16_t x = (m_matrix.a * rx + m_matrix.b * ry + m_matrix.c) >> 16;
+    int16_t y = (m_matrix.d * rx + m_matrix.e * ry + m_matrix.f) >> 16;
+    m_touched = true;
+    on_touch(x, y);
+    if (type == Event::TIMEOUT_TYPE) {
+      reschedule();
+    }
+    else {
+      expire_after(m_period);
+      start();
+    }
+    return;
+  }
+
+  // Released; back to pen-down detect. Check for missed pen-down
+  if (m_touched) {
+    m_touched = false;
+    on_release();
+  }
+  m_xp.enable();
+  if (UNLIKELY(m_xp.is_clear())) {
+    m_xp.disable();
+    Event::push(Event::CHANGE_TYPE, this);
+  }
+}
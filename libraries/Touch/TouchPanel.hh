@@ -0,0 +1,239 @@
+/**
+ * @file TouchPanel.hh
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#ifndef COSA_TOUCH_PANEL_HH
+#define COSA_TOUCH_PANEL_HH
+
+#include "Cosa/Types.h"
+#include "Cosa/IOPin.hh"
+#include "Cosa/AnalogPin.hh"
+#include "Cosa/PinChangeInterrupt.hh"
+#include "Cosa/Periodic.hh"
+
+/**
+ * Four-wire resistive touch panel. Pen-down is detected with a pin
+ * change interrupt and the panel is only sampled periodically while
+ * touched. Each coordinate is oversampled and median filtered, and
+ * mapped to screen coordinates with a fixed-point calibration
+ * matrix. The virtual member function on_touch() is called for each
+ * sample while touched and on_release() when the pen is lifted.
+ *
+ * @section Circuit
+ * The X+ and Y+ pins must be analog pins. The X+ pin must also have
+ * pin change interrupt. PinChangeInterrupt::begin() must be called.
+ * @code
+ *                       TouchPanel
+ *                       +------------+
+ * (A0/PCI14)----------1-|X+          |
+ * (D8)----------------2-|X-          |
+ * (A1/D15)------------3-|Y+          |
+ * (D9)----------------4-|Y-          |
+ *                       +------------+
+ * @endcode
+ */
+class TouchPanel : public Periodic {
+public:
+  /**
+   * Fixed-point (Q16) affine calibration matrix; screen coordinates
+   * x = (a*rx + b*ry + c) >> 16 and y = (d*rx + e*ry + f) >> 16
+   * for raw sample rx and ry.
+   */
+  struct Matrix {
+    int32_t a, b, c;
+    int32_t d, e, f;
+  };
+
+  /**
+   * Raw sample or screen coordinate.
+   */
+  struct Point {
+    int16_t x;
+    int16_t y;
+  };
+
+  /**
+   * Construct resistive touch panel with given pins; X+ pin as
+   * interrupt and analog pin, X- pin, Y+ pin as digital and analog
+   * pin, and Y- pin. The panel is sampled with the given period in
+   * the scheduler time base while touched.
+   * @param[in] scheduler for sampling.
+   * @param[in] xp X+ interrupt pin.
+   * @param[in] xa X+ analog pin.
+   * @param[in] xm X- pin.
+   * @param[in] yp Y+ pin.
+   * @param[in] ya Y+ analog pin.
+   * @param[in] ym Y- pin.
+   * @param[in] period sample period while touched (default 20).
+   */
+  TouchPanel(Job::Scheduler* scheduler,
+	     Board::InterruptPin xp, Board::AnalogPin xa,
+	     Board::DigitalPin xm,
+	     Board::DigitalPin yp, Board::AnalogPin ya,
+	     Board::DigitalPin ym,
+	     uint16_t period = 20);
+
+  /**
+   * Start pen-down detection.
+   */
+  void begin();
+
+  /**
+   * Stop pen-down detection and sampling.
+   */
+  void end();
+
+  /**
+   * Return true(1) if the panel is touched otherwise false(0).
+   * @return bool.
+   */
+  bool is_touched() const
+  {
+    return (m_touched);
+  }
+
+  /**
+   * Set calibration matrix.
+   * @param[in] matrix calibration.
+   */
+  void calibration(const Matrix& matrix)
+  {
+    m_matrix = matrix;
+  }
+
+  /**
+   * Get calibration matrix; may be saved in EEPROM.
+   * @return calibration matrix.
+   */
+  const Matrix& calibration() const
+  {
+    return (m_matrix);
+  }
+
+  /**
+   * Calculate the calibration matrix from three raw samples and the
+   * corresponding screen coordinates. The points should be spread
+   * out and not on a line. Return true(1) if successful otherwise
+   * false(0).
+   * @param[in] raw samples.
+   * @param[in] screen coordinates.
+   * @return bool.
+   */
+  bool calibrate(const Point raw[3], const Point screen[3]);
+
+  /**
+   * Return last raw sample.
+   * @return raw sample.
+   */
+  Point raw() const
+  {
+    return (m_raw);
+  }
+
+  /**
+   * @override{TouchPanel}
+   * Callback when the panel is sampled while touched with screen
+   * coordinates. Default is null function.
+   * @param[in] x coordinate.
+   * @param[in] y coordinate.
+   */
+  virtual void on_touch(int16_t x, int16_t y)
+  {
+    UNUSED(x);
+    UNUSED(y);
+  }
+
+  /**
+   * @override{TouchPanel}
+   * Callback when the pen is lifted. Default is null function.
+   */
+  virtual void on_release() {}
+
+protected:
+  /** Number of conversions per coordinate (median filter). */
+  static const uint8_t SAMPLE_MAX = 5;
+
+  /**
+   * Pen-down interrupt handler on X+ pin.
+   */
+  class PenDown : public PinChangeInterrupt {
+  public:
+    /**
+     * Construct pen-down detect on given pin for panel.
+     * @param[in] pin X+ interrupt pin.
+     * @param[in] panel to signal.
+     */
+    PenDown(Board::InterruptPin pin, TouchPanel* panel) :
+      PinChangeInterrupt(pin, ON_FALLING_MODE, true),
+      m_panel(panel)
+    {}
+
+    /**
+     * @override{Interrupt::Handler}
+     * Disable the interrupt and signal pen-down to the panel.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg);
+
+  protected:
+    TouchPanel* m_panel;
+  };
+
+  PenDown m_xp;			//!< X+ pin; pen-down interrupt.
+  Board::AnalogPin m_xa;	//!< X+ analog pin.
+  IOPin m_xm;			//!< X- pin.
+  IOPin m_yp;			//!< Y+ pin.
+  Board::AnalogPin m_ya;	//!< Y+ analog pin.
+  IOPin m_ym;			//!< Y- pin.
+  Matrix m_matrix;		//!< Calibration matrix.
+  Point m_raw;			//!< Last raw sample.
+  bool m_touched;		//!< Touched state.
+
+  /**
+   * Set pins for pen-down detect; Y- low and X+ with pullup. Return
+   * true(1) if the panel is touched otherwise false(0).
+   * @return bool.
+   */
+  bool detect();
+
+  /**
+   * Sample given analog pin and return median of the conversions.
+   * @param[in] pin analog pin.
+   * @return filtered sample.
+   */
+  static uint16_t sample(Board::AnalogPin pin);
+
+  /**
+   * Sample X and Y coordinates. Return true(1) if the panel was
+   * touched during the sampling otherwise false(0).
+   * @return bool.
+   */
+  bool sample();
+
+  /**
+   * @override{Event::Handler}
+   * Start sampling on pen-down (CHANGE_TYPE) event and sample while
+   * touched on timeout events.
+   * @param[in] type the type of event.
+   * @param[in] value the event value.
+   */
+  virtual void on_event(uint8_t type, uint16_t value);
+};
+
+#endif
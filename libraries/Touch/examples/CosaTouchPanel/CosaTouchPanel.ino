@@ -0,0 +1,89 @@
+/**
+ * @file CosaTouchPanel.ino
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * @section Description
+ * Demonstration of Cosa TouchPanel resistive touch panel. Prints
+ * screen coordinates while touched. The panel is only sampled after
+ * pen-down.
+ *
+ * @section Circuit
+ * @code
+ *                       TouchPanel
+ *                       +------------+
+ * (A0/PCI14)----------1-|X+          |
+ * (D8)----------------2-|X-          |
+ * (A1/D15)------------3-|Y+          |
+ * (D9)----------------4-|Y-          |
+ *                       +------------+
+ * @endcode
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include <Touch.h>
+
+#include "Cosa/RTT.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/IOStream.hh"
+#include "Cosa/UART.hh"
+
+IOStream cout(&uart);
+
+class Panel : public TouchPanel {
+public:
+  Panel(Job::Scheduler* scheduler) :
+    TouchPanel(scheduler,
+	       Board::PCI14, Board::A0, Board::D8,
+	       Board::D15, Board::A1, Board::D9)
+  {}
+
+  virtual void on_touch(int16_t x, int16_t y)
+  {
+    cout << PSTR("touch(") << x << PSTR(", ") << y << ')' << endl;
+  }
+
+  virtual void on_release()
+  {
+    cout << PSTR("release") << endl;
+  }
+};
+
+RTT::Scheduler scheduler;
+Panel panel(&scheduler);
+
+void setup()
+{
+  uart.begin(9600);
+  cout << PSTR("CosaTouchPanel: started") << endl;
+  RTT::begin();
+  PinChangeInterrupt::begin();
+
+  // Calibration for a 320x240 screen; raw samples from the corners
+  static const TouchPanel::Point raw[3] = {
+    { 120, 150 }, { 900, 160 }, { 510, 870 }
+  };
+  static const TouchPanel::Point screen[3] = {
+    { 0, 0 }, { 319, 0 }, { 160, 239 }
+  };
+  panel.calibrate(raw, screen);
+  panel.begin();
+}
+
+void loop()
+{
+  Event::service();
+}
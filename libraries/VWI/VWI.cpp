@@ -184,5 +184,9 @@ ISR(TIMER1_COMPA_vect)
   // Check if the receiver should run the phase locked loop
   if (!transmitting && receiving)
     receiver->PLL();
+
+  // Disable the timer interrupt when idle; enabled again on transmit
+  else if (!transmitting && !receiving)
+    TIMSK1 &= ~_BV(OCIE1A);
 }
 
@@ -25,6 +25,7 @@
 
 #include "Cosa/InputPin.hh"
 #include "Cosa/OutputPin.hh"
+#include "Cosa/PinChangeInterrupt.hh"
 #include "Cosa/Wireless.hh"
 
 /**
@@ -60,6 +61,9 @@
  *
  * @section Limitations
  * Cannot be used together with other classes that use Timer#1.
+ * The timer interrupt is only enabled while transmitting or sampling
+ * with Receiver. EdgeReceiver decodes from pin change timestamps
+ * (RTT::micros()) and requires RTT.
  */
 class VWI : public Wireless::Driver {
 public:
@@ -188,10 +192,11 @@ public:
      * Start the Phase Locked Loop listening for the receiver. Must do
      * this before receiving any messages,
      */
-    void begin()
+    virtual void begin()
     {
       m_enabled = true;
       m_active = false;
+      m_lent = false;
     }
 
     /**
@@ -199,7 +204,7 @@ public:
      * messages will be received until begin() is called again. Saves
      * interrupt processing cycles.
      */
-    void end()
+    virtual void end()
     {
       m_enabled = false;
     }
@@ -229,6 +234,27 @@ public:
     int recv(uint8_t& src, uint8_t& port, void* buf, size_t len,
 	     uint32_t ms = 0L);
 
+    /**
+     * Wait for a valid message and lend the receive buffer. The
+     * message header and payload reference is returned in the given
+     * message view. Messages are not received until release().
+     * Returns number of payload bytes, or negative error code.
+     * @param[out] msg message view.
+     * @param[in] ms timeout period (zero for blocking)
+     * @return number of bytes received or negative error code.
+     */
+    int borrow(message_t& msg, uint32_t ms = 0L);
+
+    /**
+     * Release the receive buffer and allow the next message to be
+     * received.
+     */
+    void release()
+    {
+      m_done = false;
+      m_lent = false;
+    }
+
     /**
      * Return link quality indicator; milli-seconds that the receiver
      * pin is low after receiving a message. RF433 RX modules will
@@ -242,7 +268,7 @@ public:
      */
     int link_quality_indicator();
 
-  private:
+  protected:
     /** The size of the receiver ramp. Ramp wraps modulo this number. */
     static const uint8_t RAMP_MAX = 160;
 
@@ -301,6 +327,9 @@ public:
     /** Flag to indicate that a new message is available. */
     volatile bool m_done;
 
+    /** Flag to indicate that the buffer is lent with borrow(). */
+    volatile bool m_lent;
+
     /** Flag to indicate the receiver PLL is to run. */
     uint8_t m_enabled;
 
@@ -326,10 +355,117 @@ public:
      */
     void PLL();
 
+    /**
+     * Shift the given bit into the received bits. Detect start symbol
+     * and decode symbols to the message buffer.
+     * @param[in] bit received bit value.
+     */
+    void decode(uint8_t bit);
+
+    /**
+     * @override{VWI::Receiver}
+     * Decode pending bits while waiting for a message. Default is no
+     * pending bits.
+     */
+    virtual void poll() {}
+
+    /**
+     * Wait for a valid message with the given timeout period. Returns
+     * zero(0) if a message is available otherwise error code(ETIME).
+     * @param[in] ms timeout period (zero for blocking)
+     * @return zero or negative error code.
+     */
+    int await(uint32_t ms);
+
     /** Interrupt Service Routine. */
     friend void TIMER1_COMPA_vect(void);
   };
 
+  /**
+   * Virtual Wire Receiver with edge timing. Bits are reconstructed
+   * from the time between pin changes instead of sampling the pin in
+   * the timer interrupt. There is one interrupt per transition and
+   * Timer#1 is not used while receiving. Glitches shorter than half a
+   * bit are filtered.
+   */
+  class EdgeReceiver : public Receiver {
+  public:
+    /**
+     * Construct VWI edge timing receiver instance connected to the
+     * given pin change interrupt pin.
+     * @param[in] pin receiver pin.
+     * @param[in] codec for the receiver.
+     */
+    EdgeReceiver(Board::InterruptPin pin, Codec* codec) :
+      Receiver((Board::DigitalPin) pin, codec),
+      m_edge(pin, this)
+    {
+    }
+
+    /**
+     * @override{VWI::Receiver}
+     * Start decoding pin changes. PinChangeInterrupt::begin() should
+     * have been called.
+     */
+    virtual void begin();
+
+    /**
+     * @override{VWI::Receiver}
+     * Stop decoding pin changes.
+     */
+    virtual void end();
+
+  protected:
+    /** Max number of bits in a run between transitions. */
+    static const uint8_t RUN_MAX = 12;
+
+    /** Pin change handler. */
+    class Edge : public PinChangeInterrupt {
+    public:
+      Edge(Board::InterruptPin pin, EdgeReceiver* rx) :
+	PinChangeInterrupt(pin),
+	m_rx(rx)
+      {}
+
+      /**
+       * @override{Interrupt::Handler}
+       * Decode the bits since the previous transition.
+       * @param[in] arg (not used).
+       */
+      virtual void on_interrupt(uint16_t arg = 0);
+
+    private:
+      EdgeReceiver* m_rx;
+    };
+
+    /** Pin change handler. */
+    Edge m_edge;
+
+    /** Latest transition timestamp (us). */
+    uint32_t m_last;
+
+    /** Bit period (us). */
+    uint16_t m_bit_time;
+
+    /** Current pin level. */
+    uint8_t m_level;
+
+    /**
+     * Decode run of current level up to the given time, and return
+     * number of bits. The time is rounded to bits by the caller.
+     * @param[in] us time since latest transition.
+     * @return number of bits.
+     */
+    uint8_t run(uint32_t us);
+
+    /**
+     * @override{VWI::Receiver}
+     * Decode the bits of the current level that are complete; keeps
+     * half a bit period for the next transition.
+     */
+    virtual void poll();
+  };
+
   /**
    * Internal Virtual Wire Transmitter.
    */
@@ -580,6 +716,33 @@ public:
     return (m_rx->recv(src, port, buf, len, ms));
   }
 
+  /**
+   * @override{Wireless::Driver}
+   * Receive message and lend the receiver buffer. Returns error
+   * code(ETIME) if no message is available and/or a timeout occured.
+   * Otherwise the number of payload bytes is returned. The message
+   * must be released before the next message may be received.
+   * @param[out] msg message view.
+   * @param[in] ms maximum time out period.
+   * @return number of bytes received or negative error code.
+   */
+  virtual int borrow(message_t& msg, uint32_t ms = 0L)
+  {
+    if (m_rx == NULL) return (-1);
+    return (m_rx->borrow(msg, ms));
+  }
+
+  /**
+   * @override{Wireless::Driver}
+   * Release the given borrowed message and the receiver buffer.
+   * @param[in] msg message view.
+   */
+  virtual void release(message_t& msg)
+  {
+    Wireless::Driver::release(msg);
+    if (m_rx != NULL) m_rx->release();
+  }
+
   /**
    * @override{Wireless::Driver}
    * Return link quality indicator.
@@ -0,0 +1,95 @@
+/**
+ * @file VWI_EdgeReceiver.cpp
+ * @version 1.0
+ *
+ * @section License
+ * Copyright (C) 2015, Mikael Patel
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * This file is part of the Arduino Che Cosa project.
+ */
+
+#include "VWI.hh"
+#include "Cosa/RTT.hh"
+
+void
+VWI::EdgeReceiver::begin()
+{
+  // The phase locked loop is not used; decode on pin change
+  m_enabled = false;
+  m_active = false;
+  m_lent = false;
+  m_bit_time = 1000000UL / s_rf->m_speed;
+  synchronized {
+    m_last = RTT::micros();
+    m_level = m_edge.is_set();
+  }
+  m_edge.enable();
+}
+
+void
+VWI::EdgeReceiver::end()
+{
+  m_edge.disable();
+}
+
+uint8_t
+VWI::EdgeReceiver::run(uint32_t us)
+{
+  // Count number of bits with repeated subtract; max RUN_MAX bits.
+  // A longer run will drop the current message
+  uint8_t res = 0;
+  if (us >= (uint32_t) m_bit_time * RUN_MAX) {
+    m_active = false;
+    res = RUN_MAX;
+  }
+  else {
+    uint16_t t = us;
+    while (t >= m_bit_time) {
+      t -= m_bit_time;
+      res += 1;
+    }
+  }
+
+  // Decode the bits of the current level
+  for (uint8_t i = 0; i < res; i++) decode(m_level);
+  return (res);
+}
+
+void
+VWI::EdgeReceiver::poll()
+{
+  synchronized {
+    if (m_active) {
+      uint32_t us = RTT::micros() - m_last;
+      uint16_t half = m_bit_time / 2;
+      if (us > half) {
+	uint8_t n = run(us - half);
+	m_last += (uint32_t) n * m_bit_time;
+      }
+    }
+  }
+}
+
+void
+VWI::EdgeReceiver::Edge::on_interrupt(uint16_t arg)
+{
+  UNUSED(arg);
+
+  // Decode the run of the previous level rounded to bits. A transition
+  // within half a bit is a glitch and keeps the timestamp
+  uint32_t now = RTT::micros();
+  uint8_t level = is_set();
+  if (m_rx->run(now - m_rx->m_last + (m_rx->m_bit_time / 2)) != 0)
+    m_rx->m_last = now;
+  m_rx->m_level = level;
+}
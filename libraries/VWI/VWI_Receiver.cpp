@@ -23,7 +23,7 @@
 #include "VWI.hh"
 #include "Cosa/RTT.hh"
 #include "Cosa/Power.hh"
-#include <util/crc16.h>
+#include "Cosa/CRC.hh"
 
 /**
  * Calculate check sum for given buffer and number of bytes with CRC.
@@ -36,10 +36,7 @@
 static bool
 is_valid_crc(uint8_t* ptr, uint8_t count)
 {
-  uint16_t crc = 0xffff;
-  while (count-- > 0)
-    crc = _crc_ccitt_update(crc, *ptr++);
-  return (crc == 0xf0b8);
+  return (CRC::crc16_ccitt(ptr, count) == 0xf0b8);
 }
 
 void
@@ -59,72 +56,78 @@ VWI::Receiver::PLL()
     m_pll_ramp += RAMP_INC;
   }
   if (m_pll_ramp >= RAMP_MAX) {
-    // Add this to the MSB bit of rx_bits, LSB first. The last bits are kept
-    m_bits >>= 1;
+    m_pll_ramp -= RAMP_MAX;
 
     // Check the integrator to see how many samples in this cycle were
     // high. If < 5 out of 8, then its declared a 0 bit, else a 1;
-    if (m_integrator >= INTEGRATOR_THRESHOLD)
-      m_bits |= m_codec->BITS_MSB;
-
-    m_pll_ramp -= RAMP_MAX;
+    uint8_t bit = (m_integrator >= INTEGRATOR_THRESHOLD);
 
     // Clear the integral for the next cycle
     m_integrator = 0;
+    decode(bit);
+  }
+}
 
-    if (m_active) {
-      // We have the start symbol and now we are collecting message
-      // bits for two symbols before decoding to a byte
-      if (++m_bit_count >= (m_codec->BITS_PER_SYMBOL * 2)) {
-	uint8_t data = m_codec->decode8(m_bits);
-
-	// The first decoded byte is the byte count of the following
-	// message the count includes the byte count and the 2
-	// trailing FCS bytes.
-	if (m_length == 0) {
-	  // The first byte is the byte count. Check it for
-	  // sensibility. It cant be less than min, since it includes
-	  // the bytes count itself and the 2 byte FCS
-	  m_count = data;
-	  if (m_count < MESSAGE_MIN || m_count > MESSAGE_MAX) {
-	    // Stupid message length, drop the whole thing
-	    m_active = false;
-	    return;
-	  }
-	}
-	m_buffer[m_length++] = data;
-	if (m_length >= m_count) {
-	  // Got all the bytes now
+void
+VWI::Receiver::decode(uint8_t bit)
+{
+  // Add this to the MSB bit of rx_bits, LSB first. The last bits are kept
+  m_bits >>= 1;
+  if (bit) m_bits |= m_codec->BITS_MSB;
+
+  if (m_active) {
+    // We have the start symbol and now we are collecting message
+    // bits for two symbols before decoding to a byte
+    if (++m_bit_count >= (m_codec->BITS_PER_SYMBOL * 2)) {
+      uint8_t data = m_codec->decode8(m_bits);
+
+      // The first decoded byte is the byte count of the following
+      // message the count includes the byte count and the 2
+      // trailing FCS bytes.
+      if (m_length == 0) {
+	// The first byte is the byte count. Check it for
+	// sensibility. It cant be less than min, since it includes
+	// the bytes count itself and the 2 byte FCS
+	m_count = data;
+	if (m_count < MESSAGE_MIN || m_count > MESSAGE_MAX) {
+	  // Stupid message length, drop the whole thing
 	  m_active = false;
-	  // Better come get it before the next one starts
-	  m_done = true;
+	  return;
 	}
-	m_bit_count = 0;
       }
-    }
-
-    // Not in a message, see if we have a start symbol
-    else if (m_bits == m_codec->START_SYMBOL) {
-      // Have start symbol, start collecting message
-      m_active = true;
+      m_buffer[m_length++] = data;
+      if (m_length >= m_count) {
+	// Got all the bytes now
+	m_active = false;
+	// Better come get it before the next one starts
+	m_done = true;
+      }
       m_bit_count = 0;
-      m_length = 0;
-      // Too bad if you missed the last message
-      m_done = false;
     }
   }
+
+  // Not in a message, see if we have a start symbol
+  else if (m_bits == m_codec->START_SYMBOL && !(m_lent && m_done)) {
+    // Have start symbol, start collecting message
+    m_active = true;
+    m_bit_count = 0;
+    m_length = 0;
+    // Too bad if you missed the last message
+    m_done = false;
+  }
 }
 
 int
-VWI::Receiver::recv(uint8_t& src, uint8_t& port,
-		    void* buf, size_t len,
-		    uint32_t ms)
+VWI::Receiver::await(uint32_t ms)
 {
   // Wait until a valid message is available or timeout
   uint32_t start = RTT::millis();
   header_t* hp = (header_t*) (m_buffer + 1);
   do {
-    while (!m_done && (ms == 0 || (RTT::since(start) < ms))) yield();
+    while (!m_done && (ms == 0 || (RTT::since(start) < ms))) {
+      poll();
+      if (!m_done) yield();
+    }
     if (!m_done) return (ETIME);
 
     // Check the crc and the network and device destination address
@@ -134,6 +137,18 @@ VWI::Receiver::recv(uint8_t& src, uint8_t& port,
       m_done = false;
     }
   } while (!m_done);
+  return (0);
+}
+
+int
+VWI::Receiver::recv(uint8_t& src, uint8_t& port,
+		    void* buf, size_t len,
+		    uint32_t ms)
+{
+  // Wait until a valid message is available or timeout
+  int res = await(ms);
+  if (res < 0) return (res);
+  header_t* hp = (header_t*) (m_buffer + 1);
 
   // Sanity check message length
   size_t rxlen = m_length - sizeof(header_t) - 3;
@@ -152,6 +167,29 @@ VWI::Receiver::recv(uint8_t& src, uint8_t& port,
   return (rxlen);
 }
 
+int
+VWI::Receiver::borrow(message_t& msg, uint32_t ms)
+{
+  // Hold the receiver buffer while waiting for a valid message
+  m_lent = true;
+  int res = await(ms);
+  if (res < 0) {
+    m_lent = false;
+    return (res);
+  }
+
+  // Return the message header and payload reference
+  header_t* hp = (header_t*) (m_buffer + 1);
+  size_t rxlen = m_length - sizeof(header_t) - 3;
+  s_rf->m_dest = hp->dest;
+  msg.src = hp->src;
+  msg.dest = hp->dest;
+  msg.port = hp->port;
+  msg.payload = m_buffer + sizeof(header_t) + 1;
+  msg.len = rxlen;
+  return (rxlen);
+}
+
 int
 VWI::Receiver::link_quality_indicator()
 {
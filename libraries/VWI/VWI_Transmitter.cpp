@@ -21,7 +21,7 @@
  */
 
 #include "VWI.hh"
-#include <util/crc16.h>
+#include "Cosa/CRC.hh"
 
 int
 VWI::Transmitter::send(uint8_t dest, uint8_t port, const iovec_t* vec)
@@ -41,7 +41,7 @@ VWI::Transmitter::send(uint8_t dest, uint8_t port, const iovec_t* vec)
 
   // Encode the message total length = length(1)+header(4)+payload(len)+crc(2)
   uint8_t count = 1 + sizeof(header_t) + len + 2;
-  crc = _crc_ccitt_update(crc, count);
+  crc = CRC::crc16_ccitt_update(crc, count);
   *tp++ = m_codec->encode4(count >> 4);
   *tp++ = m_codec->encode4(count);
 
@@ -54,7 +54,7 @@ VWI::Transmitter::send(uint8_t dest, uint8_t port, const iovec_t* vec)
   uint8_t* bp = (uint8_t*) &header;
   for (uint8_t i = 0; i < sizeof(header); i++) {
     uint8_t data = *bp++;
-    crc = _crc_ccitt_update(crc, data);
+    crc = CRC::crc16_ccitt_update(crc, data);
     *tp++ = m_codec->encode4(data >> 4);
     *tp++ = m_codec->encode4(data);
   }
@@ -65,7 +65,7 @@ VWI::Transmitter::send(uint8_t dest, uint8_t port, const iovec_t* vec)
     uint8_t *bp = (uint8_t*) vp->buf;
     for (uint8_t i = 0; i < vp->size; i++) {
       uint8_t data = *bp++;
-      crc = _crc_ccitt_update(crc, data);
+      crc = CRC::crc16_ccitt_update(crc, data);
       *tp++ = m_codec->encode4(data >> 4);
       *tp++ = m_codec->encode4(data);
     }
@@ -27,6 +27,10 @@
  * Vigenere auto-key cipher.
  * @param[in] N number of bytes in key.
  *
+ * @section Limitations
+ * Obfuscation only; no authentication. Use Ascon for wireless
+ * messages.
+ *
  * @section References
  * http://en.wikipedia.org/wiki/Vigen%C3%A8re_cipher
  */
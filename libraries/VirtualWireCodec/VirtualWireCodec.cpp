@@ -26,6 +26,18 @@ const uint8_t VirtualWireCodec::s_symbols[] __PROGMEM = {
   0x23, 0x25, 0x26, 0x29, 0x2a, 0x2c, 0x32, 0x34
 };
 
+// Decoder table 6 to 4 bits; indexed by symbol, invalid symbols are zero
+const uint8_t VirtualWireCodec::s_codes[] __PROGMEM = {
+  0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+  0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x1, 0x0,
+  0x0, 0x0, 0x0, 0x2, 0x0, 0x3, 0x4, 0x0,
+  0x0, 0x5, 0x6, 0x0, 0x7, 0x0, 0x0, 0x0,
+  0x0, 0x0, 0x0, 0x8, 0x0, 0x9, 0xa, 0x0,
+  0x0, 0xb, 0xc, 0x0, 0xd, 0x0, 0x0, 0x0,
+  0x0, 0x0, 0xe, 0x0, 0xf, 0x0, 0x0, 0x0,
+  0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0
+};
+
 /*
  * Calculating the start symbol (6-bits per symbol):
  * 0x2a, 0x2a => 10.1010, 10.1010 (preamble 6-bit).
@@ -34,15 +46,3 @@ const uint8_t VirtualWireCodec::s_symbols[] __PROGMEM = {
 const uint8_t VirtualWireCodec::s_preamble[] __PROGMEM = {
   0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x2a, 0x38, 0x2c
 };
-
-uint8_t
-VirtualWireCodec::decode4(uint8_t symbol)
-{
-  symbol &= SYMBOL_MASK;
-  // FIX: Binary search for better speed
-  for (uint8_t i = 0; i < membersof(s_symbols); i++)
-    if (symbol == pgm_read_byte(&s_symbols[i]))
-      return (i);
-  return (0);
-}
-
@@ -64,12 +64,30 @@ public:
    * Returns 4-bit data for given symbol.
    * @return 4-bit data.
    */
-  virtual uint8_t decode4(uint8_t symbol);
+  virtual uint8_t decode4(uint8_t symbol)
+  {
+    return (pgm_read_byte(&s_codes[symbol & SYMBOL_MASK]));
+  }
+
+  /**
+   * @override{VWI::Codec}
+   * Returns 8-bit data for given two packed symbols. Inline decode
+   * without virtual dispatch per symbol.
+   * @return 8-bit data.
+   */
+  virtual uint8_t decode8(uint16_t symbol)
+  {
+    return ((VirtualWireCodec::decode4(symbol) << 4) |
+	    (VirtualWireCodec::decode4(symbol >> BITS_PER_SYMBOL)));
+  }
 
 private:
   /** Symbol mapping table: 4 to 6 bits */
   static const uint8_t s_symbols[] PROGMEM;
 
+  /** Code mapping table: 6 to 4 bits */
+  static const uint8_t s_codes[] PROGMEM;
+
   /** Message preamble with start symbol */
   static const uint8_t s_preamble[] PROGMEM;
 };
@@ -60,6 +60,9 @@ W25X40CL::is_ready()
 int
 W25X40CL::read(void* dest, uint32_t src, size_t size)
 {
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Use READ with 24-bit address; Big-endian
   uint8_t* sp = (uint8_t*) &src;
   spi.acquire(this);
@@ -87,6 +90,7 @@ W25X40CL::erase(uint32_t dest, uint8_t size)
   case 255: op = CER; break;
   default: return (EINVAL);
   }
+  await();
   spi.acquire(this);
     // Write enable before page erase.
     spi.begin();
@@ -104,8 +108,8 @@ W25X40CL::erase(uint32_t dest, uint8_t size)
     spi.end();
   spi.release();
 
-  // Wait for completion and return no error
-  while (!is_ready()) yield();
+  // Wait for completion (unless asynchronous mode) and return no error
+  if (!m_async) while (!is_ready()) yield();
   return (0);
 }
 
@@ -115,6 +119,9 @@ W25X40CL::write(uint32_t dest, const void* src, size_t size)
   // Check for zero buffer size
   if (UNLIKELY(size == 0)) return (0);
 
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Set up destination and source pointers
   uint8_t* dp = (uint8_t*) &dest;
   uint8_t* sp = (uint8_t*) src;
@@ -140,11 +147,14 @@ W25X40CL::write(uint32_t dest, const void* src, size_t size)
       spi.end();
     spi.release();
 
+    // Return directly after the last page in asynchronous mode
+    size -= count;
+    if (size == 0 && m_async) break;
+
     // Wait for completion
     while (!is_ready()) yield();
 
     // Step to next page
-    size -= count;
     if (size == 0) break;
     dest += count;
     sp += count;
@@ -161,6 +171,9 @@ W25X40CL::write_P(uint32_t dest, const void* src, size_t size)
   // Check for zero buffer size
   if (UNLIKELY(size == 0)) return (0);
 
+  // Wait for pending operation in asynchronous mode
+  await();
+
   // Set up destination and source pointers
   uint8_t* dp = (uint8_t*) &dest;
   uint8_t* sp = (uint8_t*) src;
@@ -186,11 +199,14 @@ W25X40CL::write_P(uint32_t dest, const void* src, size_t size)
       spi.end();
     spi.release();
 
+    // Return directly after the last page in asynchronous mode
+    size -= count;
+    if (size == 0 && m_async) break;
+
     // Wait for completion
     while (!is_ready()) yield();
 
     // Step to next page
-    size -= count;
     if (size == 0) break;
     dest += count;
     sp += count;
@@ -26,24 +26,35 @@
 #if !defined(BOARD_ATTINY)
 
 #define W5X00 W5100
+#define W5X00_SIR IR
 #include <W5X00.inc>
 
 void
 W5100::write(uint16_t addr, const void* buf, size_t len, bool progmem)
 {
+  // One frame per data byte; [OP_WRITE][addr high][addr low][data].
+  // The address bytes are precomputed and the next data byte is fetched
+  // while the previous frame byte is shifted out. Socket buffer copies
+  // are split at the buffer wrap by the caller so the address is
+  // only carried into the high byte
+  if (UNLIKELY(len == 0)) return;
   const uint8_t* bp = (const uint8_t*) buf;
-  uint16_t last = addr + len;
+  uint8_t hi = addr >> 8;
+  uint8_t lo = addr;
   spi.acquire(this);
   spi.begin();
-  while (addr < last) {
+  do {
     spi.transfer_start(OP_WRITE);
-    spi.transfer_next(addr >> 8);
-    spi.transfer_next(addr++);
-    spi.transfer_next(progmem ? pgm_read_byte(bp++) : *bp++);
+    uint8_t data = progmem ? pgm_read_byte(bp) : *bp;
+    spi.transfer_next(hi);
+    spi.transfer_next(lo);
+    spi.transfer_next(data);
+    bp += 1;
+    if (UNLIKELY(++lo == 0)) hi += 1;
     spi.transfer_await();
     m_cs.set();
     m_cs.clear();
-  }
+  } while (--len);
   spi.end();
   spi.release();
 }
@@ -51,34 +62,90 @@ W5100::write(uint16_t addr, const void* buf, size_t len, bool progmem)
 void
 W5100::read(uint16_t addr, void* buf, size_t len)
 {
+  // One frame per data byte; [OP_READ][addr high][addr low][dummy].
+  // Next address is computed while the dummy byte is shifted
+  if (UNLIKELY(len == 0)) return;
   uint8_t* bp = (uint8_t*) buf;
-  uint16_t last = addr + len;
+  uint8_t hi = addr >> 8;
+  uint8_t lo = addr;
   spi.acquire(this);
   spi.begin();
-  while (addr < last) {
+  do {
     spi.transfer_start(OP_READ);
-    spi.transfer_next(addr >> 8);
-    spi.transfer_next(addr++);
+    spi.transfer_next(hi);
+    spi.transfer_next(lo);
     spi.transfer_next(0);
+    if (UNLIKELY(++lo == 0)) hi += 1;
     *bp++ = spi.transfer_await();
     m_cs.set();
     m_cs.clear();
-  }
+  } while (--len);
   spi.end();
   spi.release();
 }
 
+bool
+W5100::is_valid(const uint8_t* size)
+{
+  uint8_t total = 0;
+  for (uint8_t i = 0; i < SOCK_MAX; i++) {
+    uint8_t kb = size[i];
+    if (kb == 0) {
+      if (total != TX_MEMORY_MAX / 1024) return (false);
+      continue;
+    }
+    if ((kb & (kb - 1)) != 0) return (false);
+    total += kb;
+    if (total > TX_MEMORY_MAX / 1024) return (false);
+  }
+  return (true);
+}
+
+uint8_t
+W5100::msr(uint16_t size, uint8_t sock)
+{
+  uint8_t code = 0;
+  size >>= 11;
+  while (size != 0) {
+    size >>= 1;
+    code++;
+  }
+  return (code << (sock * 2));
+}
+
+bool
+W5100::memory(const uint8_t tx[SOCK_MAX], const uint8_t rx[SOCK_MAX])
+{
+  // Validate socket buffer sizes
+  if (!is_valid(tx) || !is_valid(rx)) return (false);
+
+  // Set socket buffer sizes; allocated in begin()
+  for (uint8_t i = 0; i < SOCK_MAX; i++) {
+    m_sock[i].m_tx_size = tx[i] * 1024;
+    m_sock[i].m_rx_size = rx[i] * 1024;
+  }
+  return (true);
+}
+
 bool
 W5100::begin(uint8_t ip[4], uint8_t subnet[4], uint16_t timeout)
 {
   // Initiate socket structure; buffer allocation and socket register pointer
+  uint16_t tx_buf = TX_MEMORY_BASE;
+  uint16_t rx_buf = RX_MEMORY_BASE;
+  uint8_t tmsr = 0;
+  uint8_t rmsr = 0;
   for (uint8_t i = 0; i < SOCK_MAX; i++) {
     SocketRegister* sreg = &((SocketRegister*) SOCKET_REGISTER_BASE)[i];
     m_sock[i].m_proto = 0;
     m_sock[i].m_sreg = sreg;
-    m_sock[i].m_tx_buf = TX_MEMORY_BASE + (i * BUF_MAX);
-    m_sock[i].m_rx_buf = RX_MEMORY_BASE + (i * BUF_MAX);
+    m_sock[i].m_tx_buf = tx_buf;
+    m_sock[i].m_rx_buf = rx_buf;
     m_sock[i].m_dev = this;
+    tx_buf += m_sock[i].m_tx_size;
+    rx_buf += m_sock[i].m_rx_size;
+    tmsr |= msr(m_sock[i].m_tx_size, i);
+    rmsr |= msr(m_sock[i].m_rx_size, i);
   }
 
   // Check for default network address
@@ -99,14 +166,18 @@ W5100::begin(uint8_t ip[4], uint8_t subnet[4], uint16_t timeout)
   write(M_CREG(MR), MR_RST);
   write(M_CREG(SHAR), mac, sizeof(m_creg->SHAR));
   write(M_CREG(RTR), &timeout, sizeof(m_creg->RTR));
-  write(M_CREG(TMSR), TX_MEMORY_SIZE);
-  write(M_CREG(RMSR), RX_MEMORY_SIZE);
+  write(M_CREG(TMSR), tmsr);
+  write(M_CREG(RMSR), rmsr);
 
   // Set source network address, subnet mask and default gateway
   bind(ip, subnet);
 
-  // TODO: Attach interrupt handler
-  // spi.attach(this);
+  // Attach interrupt handler and enable socket interrupts
+  if (m_irq != NULL) {
+    write(M_CREG(IMR), (1 << SOCK_MAX) - 1);
+    spi.attach(this);
+    m_irq->enable();
+  }
 
   return (true);
 }
@@ -26,6 +26,7 @@
 #if !defined(BOARD_ATTINY)
 
 #define W5X00 W5200
+#define W5X00_SIR IR2
 #include <W5X00.inc>
 
 void
@@ -64,17 +65,48 @@ W5200::read(uint16_t addr, void* buf, size_t len)
   spi.release();
 }
 
+bool
+W5200::is_valid(const uint8_t* size)
+{
+  uint8_t total = 0;
+  for (uint8_t i = 0; i < SOCK_MAX; i++) {
+    uint8_t kb = size[i];
+    if ((kb & (kb - 1)) != 0) return (false);
+    total += kb;
+    if (total > TX_MEMORY_MAX / 1024) return (false);
+  }
+  return (true);
+}
+
+bool
+W5200::memory(const uint8_t tx[SOCK_MAX], const uint8_t rx[SOCK_MAX])
+{
+  // Validate socket buffer sizes
+  if (!is_valid(tx) || !is_valid(rx)) return (false);
+
+  // Set socket buffer sizes; allocated in begin()
+  for (uint8_t i = 0; i < SOCK_MAX; i++) {
+    m_sock[i].m_tx_size = tx[i] * 1024;
+    m_sock[i].m_rx_size = rx[i] * 1024;
+  }
+  return (true);
+}
+
 bool
 W5200::begin(uint8_t ip[4], uint8_t subnet[4], uint16_t timeout)
 {
   // Initiate socket structure; buffer allocation and socket register pointer
+  uint16_t tx_buf = TX_MEMORY_BASE;
+  uint16_t rx_buf = RX_MEMORY_BASE;
   for (uint8_t i = 0; i < SOCK_MAX; i++) {
     SocketRegister* sreg = &((SocketRegister*) SOCKET_REGISTER_BASE)[i];
     m_sock[i].m_proto = 0;
     m_sock[i].m_sreg = sreg;
-    m_sock[i].m_tx_buf = TX_MEMORY_BASE + (i * BUF_MAX);
-    m_sock[i].m_rx_buf = RX_MEMORY_BASE + (i * BUF_MAX);
+    m_sock[i].m_tx_buf = tx_buf;
+    m_sock[i].m_rx_buf = rx_buf;
     m_sock[i].m_dev = this;
+    tx_buf += m_sock[i].m_tx_size;
+    rx_buf += m_sock[i].m_rx_size;
   }
 
   // Check for default network address
@@ -95,12 +127,21 @@ W5200::begin(uint8_t ip[4], uint8_t subnet[4], uint16_t timeout)
   write(M_CREG(MR), MR_RST);
   write(M_CREG(SHAR), mac, sizeof(m_creg->SHAR));
   write(M_CREG(RTR), &timeout, sizeof(m_creg->RTR));
+  for (uint8_t i = 0; i < SOCK_MAX; i++) {
+    SocketRegister* sreg = m_sock[i].m_sreg;
+    write(uint16_t(&sreg->TXMEM_SIZE), m_sock[i].m_tx_size / 1024);
+    write(uint16_t(&sreg->RXMEM_SIZE), m_sock[i].m_rx_size / 1024);
+  }
 
   // Set source network address, subnet mask and default gateway
   bind(ip, subnet);
 
-  // TODO: Attach interrupt handler
-  // spi.attach(this);
+  // Attach interrupt handler and enable socket interrupts
+  if (m_irq != NULL) {
+    write(M_CREG(IMR2), (1 << SOCK_MAX) - 1);
+    spi.attach(this);
+    m_irq->enable();
+  }
 
   return (true);
 }
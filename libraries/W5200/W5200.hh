@@ -26,6 +26,11 @@
 #if !defined(BOARD_ATTINY)
 #include "Cosa/SPI.hh"
 #include "Cosa/Socket.hh"
+#include "Cosa/Event.hh"
+#include "Cosa/ExternalInterrupt.hh"
+#include "Cosa/Job.hh"
+#include "Cosa/EEPROM.hh"
+#include <DHCP.h>
 
 /**
  * Cosa WIZnet W5200 device driver class. Provides an implementation
@@ -340,11 +345,11 @@ protected:
   static const uint16_t RX_MEMORY_BASE = 0xC000;
   static const uint16_t RX_MEMORY_MAX = 0x4000;
 
-  /** Socket Buffer Size; 2 Kbyte TX/RX per socket. */
+  /** Default Socket Buffer Size; 2 Kbyte TX/RX per socket. */
   static const size_t BUF_MAX = 2048;
   static const uint16_t BUF_MASK = 0x07ff;
 
-  /** TX Message Size; internal buffer size for flush threshold. */
+  /** Default TX Message Size; flush threshold, half buffer size. */
   static const size_t MSG_MAX = BUF_MAX / 2;
 
   /** Maximum number of sockets on device. */
@@ -362,7 +367,27 @@ public:
     friend class W5200;
   public:
     /** Default constructor. */
-    Driver() : Socket() {}
+    Driver() :
+      Socket(),
+      m_handler(NULL),
+      m_ir(0)
+    {}
+
+    /**
+     * Set event handler for socket interrupts. Requires the device
+     * interrupt pin (see IRQPin). The socket interrupts CON, DISCON,
+     * RECV, SEND_OK and TIMEOUT are pushed as CONNECT_TYPE,
+     * DISCONNECT_TYPE, RECEIVE_COMPLETED_TYPE, SEND_COMPLETED_TYPE
+     * and TIMEOUT_TYPE events with the socket as environment. With an
+     * event handler accept() and available() only access the device
+     * when an interrupt has been received. The handler is reset when
+     * the socket is opened.
+     * @param[in] target event handler.
+     */
+    void handler(Event::Handler* target)
+    {
+      m_handler = target;
+    }
 
     /**
      * @override{IOStream::Device}
@@ -521,7 +546,84 @@ public:
     virtual int recv(void* buf, size_t len,
 		     uint8_t src[4], uint16_t& port);
 
+    /**
+     * Read data at given offset in the socket receiver buffer to the
+     * given buffer with the given maximum size. The data is not
+     * consumed; the receiver buffer pointer is not updated. Returns
+     * number of bytes read or negative error code.
+     * @param[in] buf pointer to buffer for data.
+     * @param[in] len maximum number of bytes in buffer.
+     * @param[in] offset in received data (default zero).
+     * @return number of bytes read if successful otherwise negative
+     * error code.
+     */
+    int peek(void* buf, size_t len, size_t offset = 0);
+
+    /**
+     * Consume given number of bytes in the socket receiver buffer.
+     * Returns number of bytes consumed or negative error code.
+     * @param[in] len number of bytes to consume.
+     * @return number of bytes consumed if successful otherwise
+     * negative error code.
+     */
+    int consume(size_t len);
+
+    /** Received datagram descriptor; recv_batch(). */
+    struct datagram_t {
+      uint8_t src[4];		//!< Source address.
+      uint16_t port;		//!< Source port.
+      uint8_t* buf;		//!< Data in the batch buffer.
+      uint16_t len;		//!< Data length (possibly truncated).
+    };
+
+    /**
+     * Receive a batch of datagrams on connectionless socket (UDP)
+     * into the given buffer with the given size. The received size
+     * and receiver buffer pointer are read once, the datagram headers
+     * are walked in the socket receiver buffer and the datagrams are
+     * copied to the buffer in sequence. The descriptor vector is
+     * filled with source address, port and data of each datagram.
+     * The receiver buffer pointer is updated once. A datagram that
+     * does not fit in the remaining buffer is left for the next call
+     * unless it is the first, which is then truncated. Returns number
+     * of datagrams received or negative error code.
+     * @param[in] dgrams datagram descriptor vector.
+     * @param[in] count max number of datagrams.
+     * @param[in] buf buffer for datagram data.
+     * @param[in] size number of bytes in buffer.
+     * @return number of datagrams if successful otherwise negative
+     * error code.
+     */
+    int recv_batch(datagram_t* dgrams, uint8_t count, void* buf, size_t size);
+
+    /**
+     * Reserve given number of bytes (max buffer size) in the socket
+     * transmitter buffer for the current message. Wait for room in
+     * the device buffer. Writes up to the reserved size are streamed
+     * to the device buffer without an intermediate flush (MSG_MAX).
+     * Returns number of bytes reserved or negative error code.
+     * @param[in] len number of bytes to reserve.
+     * @return number of bytes reserved if successful otherwise
+     * negative error code.
+     */
+    int reserve(size_t len);
+
+    /**
+     * Send the data written to the socket transmitter buffer without
+     * waiting for the transmission to complete. The next commit or
+     * flush will wait for the transmission. Returns zero(0) or
+     * negative error code.
+     * @return zero(0) or negative error code.
+     */
+    int commit();
+
   protected:
+    /** Event handler for socket interrupts. */
+    Event::Handler* m_handler;
+
+    /** Socket interrupts received (pending). */
+    uint8_t m_ir;
+
     /** Pointer to socket registers; symbolic address calculation. */
     SocketRegister* m_sreg;
 
@@ -531,15 +633,27 @@ public:
     /** Pointer to socket transmitter buffer. */
     uint16_t m_tx_buf;
 
+    /** Size of socket transmitter buffer (power of 2). */
+    uint16_t m_tx_size;
+
     /** Offset in socket transmitter buffer. */
     uint16_t m_tx_offset;
 
     /** Length of message in socket transmitter buffer. */
     uint16_t m_tx_len;
 
+    /** Maximum length of message; flush threshold. */
+    uint16_t m_tx_max;
+
+    /** Transmission in progress (commit). */
+    bool m_tx_busy;
+
     /** Pointer to socket receiver buffer. */
     uint16_t m_rx_buf;
 
+    /** Size of socket receiver buffer (power of 2). */
+    uint16_t m_rx_size;
+
     /**
      * Read data from the socket receiver buffer to the given buffer
      * with the given maximum size.
@@ -550,6 +664,26 @@ public:
      */
     int dev_read(void* buf, size_t len);
 
+    /**
+     * Read data from the socket receiver buffer to the given null
+     * terminated io buffer vector (scatter read). The receiver buffer
+     * pointer is read and updated once for the whole vector.
+     * @param[in] vec null terminated io buffer vector pointer.
+     * @return number of bytes read if successful otherwise negative
+     * error code.
+     */
+    int dev_read(const iovec_t* vec);
+
+    /**
+     * Copy data at the given receiver buffer pointer to the given
+     * buffer with the given size. Handles buffer wrapping. The
+     * receiver buffer pointer register is not read or updated.
+     * @param[in] ptr receiver buffer pointer.
+     * @param[in] buf buffer pointer.
+     * @param[in] len number of bytes to copy.
+     */
+    void dev_copy(uint16_t ptr, void* buf, size_t len);
+
     /**
      * Write data to the socket transmitter buffer from the given buffer
      * with the given number of bytes.
@@ -573,6 +707,38 @@ public:
      */
     void dev_setup();
 
+    /**
+     * Return socket interrupt register with pending interrupts.
+     * @return interrupt register.
+     */
+    uint8_t dev_ir();
+
+    /**
+     * Clear given socket interrupts.
+     * @param[in] ir interrupts to clear.
+     */
+    void dev_ir_clear(uint8_t ir);
+
+    /**
+     * Read and clear socket interrupt register. Record interrupts as
+     * pending and push events to the socket event handler.
+     */
+    void dev_service();
+
+    /**
+     * Wait for a transmission in progress to complete. Returns
+     * zero(0) or negative error code.
+     * @return zero(0) or negative error code.
+     */
+    int dev_await();
+
+    /**
+     * Update transmitter buffer pointer with the current message and
+     * issue send command. Returns zero(0) or negative error code.
+     * @return zero(0) or negative error code.
+     */
+    int dev_send();
+
     /**
      * @override{Socket}
      * Write data from buffer with given size to device. Boolean flag
@@ -618,6 +784,162 @@ public:
 		     bool progmem);
   };
 
+  /**
+   * Handler for device interrupt pin. Socket interrupts are serviced
+   * in the event handler. Should be set with interrupt() before
+   * begin().
+   * @code
+   * W5200 ethernet;
+   * W5200::IRQPin irq(Board::EXT0, &ethernet);
+   * ...
+   * ethernet.interrupt(&irq);
+   * ethernet.begin_P(PSTR("hostname"));
+   * @endcode
+   */
+  class IRQPin : public ExternalInterrupt, public Event::Handler {
+  public:
+    /**
+     * Construct interrupt pin handler for given device.
+     * @param[in] pin external interrupt pin.
+     * @param[in] dev device driver.
+     */
+    IRQPin(Board::ExternalInterruptPin pin, W5200* dev) :
+      ExternalInterrupt(pin, ExternalInterrupt::ON_FALLING_MODE, true),
+      m_dev(dev),
+      m_pending(false)
+    {}
+
+    /**
+     * @override{Interrupt::Handler}
+     * Enable interrupt handler. The interrupt pin is checked for
+     * interrupts that occurred while the SPI bus was in use.
+     */
+    virtual void enable();
+
+    /**
+     * @override{Interrupt::Handler}
+     * Push event to service the socket interrupts.
+     * @param[in] arg argument from interrupt service routine.
+     */
+    virtual void on_interrupt(uint16_t arg = 0);
+
+    /**
+     * @override{Event::Handler}
+     * Service socket interrupts.
+     * @param[in] type the type of event.
+     * @param[in] value the event value.
+     */
+    virtual void on_event(uint8_t type, uint16_t value);
+
+  private:
+    /** Device driver. */
+    W5200* m_dev;
+
+    /** Service event pushed. */
+    volatile bool m_pending;
+  };
+
+  /**
+   * Set socket transmitter and receiver buffer sizes in Kbyte. Valid
+   * sizes are 0, 1, 2, 4, 8 or 16 Kbyte and the total may not exceed
+   * the device memory (16 Kbyte TX and RX). Sockets without buffer
+   * memory are not allocated. Returns true if successful otherwise
+   * false. Should be called before begin(). Default is 2 Kbyte per
+   * socket.
+   * @code
+   * const uint8_t TX[] = { 8, 2, 2, 2, 1, 1, 0, 0 };
+   * const uint8_t RX[] = { 8, 2, 2, 2, 1, 1, 0, 0 };
+   * ethernet.memory(TX, RX);
+   * @endcode
+   * @param[in] tx transmitter buffer size per socket (Kbyte).
+   * @param[in] rx receiver buffer size per socket (Kbyte).
+   * @return bool.
+   */
+  bool memory(const uint8_t tx[SOCK_MAX], const uint8_t rx[SOCK_MAX]);
+
+  /**
+   * DHCP lease handler with persistent lease and background
+   * renewal. The lease is stored in EEPROM and requested first on
+   * begin() (INIT-REBOOT) with fallback to full discovery. The lease
+   * is renewed at T1 by the job. The scheduler time unit should be
+   * milliseconds (Watchdog::Scheduler).
+   * @code
+   * DHCP::lease_t lease EEMEM;
+   * EEPROM eeprom;
+   * Watchdog::Scheduler scheduler;
+   * W5200 ethernet;
+   * W5200::Lease dhcp(&scheduler, &ethernet, PSTR("hostname"),
+   *			&eeprom, &lease);
+   * ...
+   * dhcp.begin();
+   * @endcode
+   */
+  class Lease : public Job {
+  public:
+    /**
+     * Construct DHCP lease handler for given device and hostname. The
+     * persistent lease is stored in the given EEPROM at the given
+     * address.
+     * @param[in] scheduler for lease renewal.
+     * @param[in] dev device driver.
+     * @param[in] hostname string in program memory.
+     * @param[in] eeprom device (Default NULL).
+     * @param[in] lease address in EEPROM (Default NULL).
+     */
+    Lease(Job::Scheduler* scheduler, W5200* dev, const char* hostname,
+	  EEPROM* eeprom = NULL, DHCP::lease_t* lease = NULL) :
+      Job(scheduler),
+      m_dev(dev),
+      m_dhcp(hostname, dev->m_mac)
+    {
+      m_dhcp.persist(eeprom, lease);
+    }
+
+    /**
+     * Initiate the device driver and obtain network address from the
+     * DHCP server, and start the lease renewal job. Returns true if
+     * successful otherwise false.
+     * @param[in] timeout retry timeout period (Default 500 ms).
+     * @return bool.
+     */
+    bool begin(uint16_t timeout = 500);
+
+  protected:
+    /** Retry period on failed renewal (seconds). */
+    static const uint32_t RETRY_PERIOD = 60;
+
+    /** Max renewal period (seconds); millisecond scheduler range. */
+    static const uint32_t RENEW_MAX = 2000000UL;
+
+    /** Device driver. */
+    W5200* m_dev;
+
+    /** DHCP client. */
+    DHCP m_dhcp;
+
+    /**
+     * @override{Job}
+     * Renew the lease. Request a new lease on failure and reschedule.
+     */
+    virtual void run();
+
+    /**
+     * Schedule lease renewal after the given number of seconds.
+     * @param[in] secs until renewal.
+     */
+    void schedule(uint32_t secs);
+  };
+
+  /**
+   * Use given interrupt pin handler for socket interrupts. Should be
+   * called before begin().
+   * @param[in] irq interrupt pin handler.
+   */
+  void interrupt(IRQPin* irq)
+  {
+    m_irq = irq;
+  }
+
   /** Default hardware network address. */
   static const uint8_t MAC[6] PROGMEM;
 
@@ -696,6 +1018,31 @@ protected:
    * @param[in] cmd command to issue.
    */
   void issue(uint16_t addr, uint8_t cmd);
+
+  /**
+   * Obtain network address from the DHCP server with the given
+   * client. The persistent lease is requested first (INIT-REBOOT)
+   * with fallback to discovery. Returns zero if successful otherwise
+   * negative error code.
+   * @param[in] dhcp client.
+   * @return zero if successful otherwise negative error code.
+   */
+  int configure(DHCP& dhcp);
+
+  /**
+   * Service socket interrupts until the socket interrupt register is
+   * cleared.
+   */
+  void service();
+
+  /**
+   * Validate socket buffer sizes (Kbyte); 0, 1, 2, 4, 8 and 16 Kbyte,
+   * and total within device memory. Returns true if valid otherwise
+   * false.
+   * @param[in] size buffer size per socket (Kbyte).
+   * @return bool.
+   */
+  static bool is_valid(const uint8_t* size);
 };
 
 #endif